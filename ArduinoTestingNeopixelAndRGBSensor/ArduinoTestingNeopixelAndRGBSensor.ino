@@ -4,7 +4,9 @@
   DIN → pin 6 na Arduinu
   VCC → 5V
   GND → GND
-- Všechna GND propojit (Arduino ↔ LED kruh). 
+- Senzor barvy TCS34725 (I2C, Leonardo): SDA → D2, SCL → D3, VIN → 5V, GND → GND,
+  pin LED na modulu propoj s INT (sketch pak umí bílou LED senzoru zhasnout).
+- Všechna GND propojit (Arduino ↔ LED kruh ↔ senzor). 
 - V Serial Monitoru nastav: Rychlost 9600 a Line ending: Newline.
 
 💡 Tipy:
@@ -16,6 +18,11 @@
 - "off" → vypne kroužek (zhasne)
 - "b 0..255" → nastaví jas (např. "b 120")
 - "speed 5..50" → rychlost animace v ms (menší = rychlejší)
+- "capture" → přilož senzor k barevnému předmětu: zapamatuje si jeho barvu
+- "match"   → otoč senzor ke kroužku: kroužek se sám dolaďuje, až senzor
+              naměří zapamatovanou barvu (LED senzoru zhasne)
+- "follow"  → kroužek jen ukazuje, co senzor právě vidí
+- Senzor se čte bez čekání (knihovna MyColorSensor), duha se mezitím dál točí.
 
 📘 Úkoly, pro pochopení kódu:
 1) Jaké nastavení musí mít Serial Monitor, aby příkazy fungovaly?
@@ -23,9 +30,11 @@
 3) Jak změním jas kroužku?
 4) Co udělám, aby místo duhy svítila pořád jen modře?
 5) Proč je výhodné mít animaci „neblokující“ (bez velkých delay)?
+6) Proč po "follow" kroužek barvu trefí jen přibližně, ale po "match" přesně?
 */
 
 #include <Adafruit_NeoPixel.h>
+#include <MyColorSensor.h>   // knihovna MyColorSensor: TCS34725 bez čekání + ColorMatch
 
 #define PIXEL_PIN    6
 #define NUMPIXELS    8
@@ -33,6 +42,15 @@
 
 Adafruit_NeoPixel pixels(NUMPIXELS, PIXEL_PIN, NEO_GRB + NEO_KHZ800);
 
+MyColor::WireBus bus;
+MyColor::Tcs34725<MyColor::WireBus> tcs(bus);
+MyColor::ColorMatch match;
+
+enum Mode : uint8_t { MODE_RAINBOW, MODE_MATCH, MODE_FOLLOW };
+Mode mode = MODE_RAINBOW;
+bool sensorOk = false;
+bool haveSample = false;       // aspoň jedno platné měření (pro "capture")
+
 bool ringOn = true;
 uint8_t brightness = 100;      // 0–255
 uint8_t j = 0;                 // fázový posun duhy
@@ -53,15 +71,32 @@ void setup() {
   pixels.clear();
   pixels.show();
 
-  Serial.println(F("NeoPixel 8 ready. Příkazy: on, off, b <0-255>, speed <5-50>"));
+  sensorOk = tcs.begin(millis());
+  if (!sensorOk) Serial.println(F("TCS34725 nenalezen – capture/match/follow nepujdou."));
+
+  Serial.println(F("NeoPixel 8 ready. Příkazy: on, off, b <0-255>, speed <5-50>, capture, match, follow"));
   Serial.println(F("Nastav v Serial Monitoru 9600 baud a Line ending: Newline."));
 }
 
+void setMode(Mode m) {
+  mode = m;
+  tcs.setInterrupt(m == MODE_MATCH);   // při "match" měří senzor kroužek, ne svou LED
+}
+
 void loop() {
+  // Senzor: poll() se vrátí hned; true jen když je hotové nové měření
+  if (sensorOk && tcs.poll(millis())) {
+    const MyColor::Sample& s = tcs.sample();
+    haveSample = true;
+    if (mode == MODE_MATCH)  match.update(s.chroma);
+    if (mode == MODE_FOLLOW) match.follow(s.chroma);
+  }
+
   // Animace bez blokování – krok každých stepInterval ms
   if (ringOn && millis() - lastStep >= stepInterval) {
     lastStep = millis();
-    rainbowStep();
+    if (mode == MODE_RAINBOW) rainbowStep();
+    else matchStep();
   }
 
   // Příjem a zpracování příkazů
@@ -71,6 +106,7 @@ void loop() {
 
     if (cmd.equalsIgnoreCase("on")) {
       ringOn = true;
+      setMode(MODE_RAINBOW);
       Serial.println(F("LED ring: ON"));
     } 
     else if (cmd.equalsIgnoreCase("off")) {
@@ -93,8 +129,26 @@ void loop() {
       stepInterval = (unsigned long)ms;
       Serial.print(F("Speed (ms/step): ")); Serial.println(stepInterval);
     }
+    else if (cmd.equalsIgnoreCase("capture")) {
+      if (!haveSample) { Serial.println(F("Zatim zadne mereni senzoru.")); return; }
+      const uint8_t* ch = tcs.sample().chroma;
+      match.setTarget(ch);
+      Serial.print(F("Cil R,G,B: "));
+      Serial.print(ch[0]); Serial.print(','); Serial.print(ch[1]); Serial.print(','); Serial.println(ch[2]);
+    }
+    else if (cmd.equalsIgnoreCase("match")) {
+      ringOn = true;
+      match.follow(match.getTarget());     // start z odhadu, regulátor doladí zbytek
+      setMode(MODE_MATCH);
+      Serial.println(F("Match: otoc senzor ke kruzku"));
+    }
+    else if (cmd.equalsIgnoreCase("follow")) {
+      ringOn = true;
+      setMode(MODE_FOLLOW);
+      Serial.println(F("Follow: kruzek ukazuje, co senzor vidi"));
+    }
     else {
-      Serial.println(F("Neznamy prikaz. Pouzij: on, off, b <0-255>, speed <5-50>"));
+      Serial.println(F("Neznamy prikaz. Pouzij: on, off, b <0-255>, speed <5-50>, capture, match, follow"));
     }
   }
 }
@@ -108,6 +162,16 @@ void rainbowStep() {
   j = (j + 1) & 0xFF;
 }
 
+// Jeden krok "match"/"follow": celý kroužek plynule dojíždí k barvě z ColorMatch
+void matchStep() {
+  uint8_t rgb[3];
+  match.step(rgb);
+  for (uint16_t i = 0; i < pixels.numPixels(); i++) {
+    pixels.setPixelColor(i, rgb[0], rgb[1], rgb[2]);
+  }
+  pixels.show();
+}
+
 // Převod čísla 0..255 na barvu (duhové kolečko)
 uint32_t Wheel(byte p) {
   p = 255 - p;
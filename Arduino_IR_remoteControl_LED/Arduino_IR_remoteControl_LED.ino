@@ -70,31 +70,9 @@ float    breathePhase = 0; // 0..2π
 int      meteorHeadL = 0, meteorHeadR = NUM_LEDS-1;
 
 // ====== Pomocné funkce ======
-const char* buttonName(unsigned long code) {
-  if (code == ONE)        return "ONE";
-  if (code == TWO)        return "TWO";
-  if (code == THREE)      return "THREE";
-  if (code == FOUR)       return "FOUR";
-  if (code == FIVE)       return "FIVE";
-  if (code == SIX)        return "SIX";
-  if (code == SEVEN)      return "SEVEN";
-  if (code == EIGHT)      return "EIGHT";
-  if (code == NINE)       return "NINE";
-  if (code == ZERO)       return "ZERO";
-  if (code == STARBTN)    return "STAR";
-  // Směrovky + hash/OK dle vaší hlavičky:
-  if (code == LEFTBTN)    return "LEFT";
-  if (code == RIGHTBTN)   return "RIGHT";
-  if (code == UPBTN)      return "UP";
-  if (code == DOWNBTN)    return "DOWN";
-  if (code == OKBTN)      return "OK";
-  if (code == HASHBTN)    return "HASH";
-  return "UNKNOWN";
-}
-
 void logIR(unsigned long code) {
   Serial.print("IR raw=0x"); Serial.print(code, HEX);
-  Serial.print("  btn="); Serial.println(buttonName(code));
+  Serial.print("  btn="); Serial.println(nameOf(code));
 }
 
 // Bezpečné nastavení jasu
@@ -34,6 +34,7 @@ OVLÁDÁNÍ
 #include <IRremote.hpp>        // IRremote v3+
 #include <MyIRcodes.h>         // Tvoje header-only knihovna s pojmenovanými kódy (ONE, TWO, THREE, ...)
 using namespace MyIR;          // přinese ONE, TWO, THREE přímo do scope
+#include <MyShows.h>           // samotné efekty (duha, theater chase, dýchání, ...) – knihovna MyShows
 // =================== UPRAV PODLE POTŘEBY ===================
 #define LED_PIN         6          // Data pin pro NeoPixel kruh
 #define NUMPIXELS       12         // NeoPixel 12 kruh
@@ -42,88 +43,18 @@ using namespace MyIR;          // přinese ONE, TWO, THREE přímo do scope
 // ===========================================================
 
 Adafruit_NeoPixel strip(NUMPIXELS, LED_PIN, NEO_GRB + NEO_KHZ800);
+MyShows::Engine<NUMPIXELS, MyShows::OrderGRB> shows;   // kreslí rovnou do bufferu pásku
 
-// Stavové proměnné pro výběr show
-uint8_t currentShow = 1;      // 1..3
+// Stavové proměnné pro výběr show (kterou show kreslíme, si pamatuje shows.current())
 unsigned long lastStepMs = 0; // čas posledního kroku animace
 unsigned long stepDelayMs = 30; // defaultní rychlost (mění se podle show)
-uint16_t animStep = 0;        // krok animace (inkrementujeme v čase)
+
+// Rychlost jednotlivých show (index = číslo show, 0 se nepoužívá)
+const unsigned long SHOW_DELAY_MS[4] = { 30, 20, 120, 15 };
 
 // IR – uchování posledního nerepeat kódu pro práci s NEC repeat (0x0)
 unsigned long lastNonRepeat = 0;
 
-// ---------- Pomocné: převod barvy „kolečko“ ----------
-uint32_t wheel(byte pos) {
-  pos = 255 - pos;
-  if (pos < 85) {
-    return strip.Color(255 - pos * 3, 0, pos * 3);
-  } else if (pos < 170) {
-    pos -= 85;
-    return strip.Color(0, pos * 3, 255 - pos * 3);
-  } else {
-    pos -= 170;
-    return strip.Color(pos * 3, 255 - pos * 3, 0);
-  }
-}
-
-// ---------- Show 1: Rainbow cycle (plynulá duha) ----------
-void showRainbowStep() {
-  // rychlost cyklu
-  stepDelayMs = 20;
-  for (uint16_t i = 0; i < NUMPIXELS; i++) {
-    // posuneme kolečko podle animStep
-    strip.setPixelColor(i, wheel((i * 256 / NUMPIXELS + animStep) & 0xFF));
-  }
-  strip.show();
-  animStep++;
-}
-
-// ---------- Show 2: Theater Chase (běžící světla) ----------
-void showTheaterChaseStep() {
-  stepDelayMs = 120;
-  // střídavý vzor – tři fáze (offset 0,1,2)
-  uint8_t offset = animStep % 3;
-  for (uint16_t i = 0; i < NUMPIXELS; i++) {
-    if (i % 3 == offset) {
-      strip.setPixelColor(i, strip.Color(255, 180, 40)); // teplejší bílá/žlutá
-    } else {
-      strip.setPixelColor(i, 0); // vypnuto
-    }
-  }
-  strip.show();
-  animStep++;
-}
-
-// ---------- Show 3: Dýchání (plynulý nádech-výdech jasu jedné barvy) ----------
-void showBreathingStep() {
-  stepDelayMs = 15;
-  // sinusové dýchání – mapa 0..255 -> ~0..1
-  // použijeme „trojúhelníkovou“ aproximaci bez trigonometrie:
-  // 0..255..0 (pilovitě do trojúhelníku)
-  uint8_t phase = animStep & 0xFF;
-  uint8_t tri = phase < 128 ? phase * 2 : (255 - phase) * 2; // 0..255..0
-  // zvol barvu – např. azurová
-  uint8_t r = 0;
-  uint8_t g = (uint16_t)tri * 2 / 3;   // tlumenější zelená
-  uint8_t b = tri;                      // modrá
-  for (uint16_t i = 0; i < NUMPIXELS; i++) {
-    strip.setPixelColor(i, strip.Color(r, g, b));
-  }
-  strip.show();
-  animStep++;
-}
-
-// ---------- Zobraz jméno tlačítka pro Serial debug ----------
-const char* buttonName(unsigned long code) {
-  // Porovnáváme proti symbolům z myIRcodes.h (např. ONE, TWO, THREE, ...).
-  // Přidej si sem další case podle své knihovny:
-  if (code == ONE)   return "ONE";
-  if (code == TWO)   return "TWO";
-  if (code == THREE) return "THREE";
-  // doplň si klidně FOUR, FIVE, ... podle své lib.
-  return "UNKNOWN";
-}
-
 // ---------- Zpracování přijatého IR signálu ----------
 void handleIR() {
   if (!IrReceiver.decode()) return;
@@ -135,11 +66,11 @@ void handleIR() {
   Serial.print(raw, HEX);
   if (raw == 0x0 && lastNonRepeat != 0) {
     Serial.print(F(" (REPEAT of "));
-    Serial.print(buttonName(lastNonRepeat));
+    Serial.print(nameOf(lastNonRepeat));
     Serial.print(F(")"));
   } else {
     Serial.print(F(" ("));
-    Serial.print(buttonName(raw));
+    Serial.print(nameOf(raw));
     Serial.print(F(")"));
   }
   Serial.println();
@@ -149,16 +80,13 @@ void handleIR() {
 
   // Přepínání show podle tvých pojmenovaných konstant
   if (signal == ONE) {
-    currentShow = 1;
-    animStep = 0;
+    shows.select(1);
     Serial.println(F(">> SHOW 1: Rainbow"));
   } else if (signal == TWO) {
-    currentShow = 2;
-    animStep = 0;
+    shows.select(2);
     Serial.println(F(">> SHOW 2: Theater chase"));
   } else if (signal == THREE) {
-    currentShow = 3;
-    animStep = 0;
+    shows.select(3);
     Serial.println(F(">> SHOW 3: Breathing"));
   }
 
@@ -178,7 +106,8 @@ void setup() {
 
   // NeoPixel
   strip.begin();
-  strip.setBrightness(LED_BRIGHTNESS);
+  shows.pixels.attach(strip.getPixels());
+  shows.brightness = LED_BRIGHTNESS;   // jas násobí knihovna při kreslení
   strip.show(); // zhasnout
 
   // IRremote
@@ -192,15 +121,12 @@ void loop() {
   // 1) IR obsluha
   handleIR();
 
-  // 2) Ne-blokující animace podle currentShow
+  // 2) Ne-blokující animace podle zvolené show
   unsigned long now = millis();
   if (now - lastStepMs >= stepDelayMs) {
     lastStepMs = now;
-    switch (currentShow) {
-      case 1: showRainbowStep();     break;
-      case 2: showTheaterChaseStep();break;
-      case 3: showBreathingStep();   break;
-      default: currentShow = 1;      break;
-    }
+    stepDelayMs = SHOW_DELAY_MS[shows.current()];
+    shows.render();
+    strip.show();
   }
 }
@@ -1,136 +1,85 @@
+#include <MyMorse.h>   // knihovna MyMorse: Morseovka bez delay()
+
 const int LED_PIN = 13;   // vestavěná LED na Arduino Leonardo
+const int KEY_PIN = 2;    // tlačítko proti GND = telegrafní klíč (dekodér)
+
+// Místo tlačítka jde použít fotorezistor (dělič na A0): 1 = světlo, 0 = tlačítko
+#define USE_LIGHT_SENSOR 0
+const int LIGHT_PIN = A0;
+const int LIGHT_THRESHOLD = 500;   // nad touto hodnotou = svítí = "klíč stisknutý"
 
-// Časování Morseovky
-const int DOT_DURATION = 200;          // tečka
-const int DASH_DURATION = DOT_DURATION * 3;   // čárka
-const int SYMBOL_GAP = DOT_DURATION;          // mezera mezi tečkou a čárkou v rámci jednoho písmene
-const int LETTER_GAP = DOT_DURATION * 3;      // mezera mezi písmeny
-const int WORD_GAP = DOT_DURATION * 7;        // mezera mezi slovy
+// Časování Morseovky: rychlost ve slovech za minutu (WPM), tečka = 1200 / WPM ms
+const int WPM = 6;                 // 6 WPM = tečka 200 ms
+const int FARNSWORTH_WPM = 0;      // např. 3: znaky rychlostí WPM, mezery natažené na 3 WPM
 
-String inputMessage = "";
+MyMorse::Sender sender;
+MyMorse::Receiver receiver;
+
+char line[MyMorse::QUEUE + 1];     // rozepsaný řádek ze Serialu
+uint8_t lineLength = 0;
+bool wasBusy = false;
 
 void setup() {
   pinMode(LED_PIN, OUTPUT);
   digitalWrite(LED_PIN, LOW);
+  pinMode(KEY_PIN, INPUT_PULLUP);
 
   Serial.begin(9600);
   while (!Serial) {
     ; // počkej na připojení Serialu (Leonardo to potřebuje)
   }
 
-  Serial.println("Napis zpravu a stiskni Enter.");
+  sender.setSpeed(WPM, FARNSWORTH_WPM);
+  receiver.setSpeed(WPM);
+
+  Serial.println("Napis zpravu a stiskni Enter. Nebo tukej tlacitkem.");
 }
 
 void loop() {
-  if (Serial.available() > 0) {
-    inputMessage = Serial.readStringUntil('\n');
-    inputMessage.trim();
+  // 1) Vysílání: LED podle stavu vysílače, nic se nečeká
+  digitalWrite(LED_PIN, sender.update(millis()));
+  if (wasBusy && !sender.busy()) Serial.println("Hotovo. Napis dalsi zpravu.");
+  wasBusy = sender.busy();
 
-    if (inputMessage.length() > 0) {
-      Serial.print("Blikam: ");
-      Serial.println(inputMessage);
+  // 2) Příjem z klíče a výpis dekódovaných znaků
+  receiver.update(millis(), keyDown());
+  while (receiver.available()) Serial.print(receiver.read());
 
-      blinkMessage(inputMessage);
-
-      Serial.println("Hotovo. Napis dalsi zpravu.");
-    }
-  }
+  // 3) Příkazy ze Serialu
+  readSerial();
 }
 
-// 1) Vezme celou zprávu a pošle ji znak po znaku dál
-void blinkMessage(String message) {
-  for (int i = 0; i < message.length(); i++) {
-    char c = message.charAt(i);
-
-    if (c == ' ') {
-      delay(WORD_GAP);
-    } else {
-      String morse = charToMorse(c);
-
-      if (morse.length() > 0) {
-        blinkMorseSequence(morse);
-
-        // mezera mezi písmeny
-        delay(LETTER_GAP);
-      }
-    }
-  }
+// Stisknuté tlačítko, nebo světlo nad prahem
+bool keyDown() {
+#if USE_LIGHT_SENSOR
+  return analogRead(LIGHT_PIN) > LIGHT_THRESHOLD;
+#else
+  return digitalRead(KEY_PIN) == LOW;
+#endif
 }
 
-// 2) Přeloží jeden znak do Morseovy abecedy
-String charToMorse(char c) {
-  c = toupper(c);
-
-  switch (c) {
-    case 'A': return ".-";
-    case 'B': return "-...";
-    case 'C': return "-.-.";
-    case 'D': return "-..";
-    case 'E': return ".";
-    case 'F': return "..-.";
-    case 'G': return "--.";
-    case 'H': return "....";
-    case 'I': return "..";
-    case 'J': return ".---";
-    case 'K': return "-.-";
-    case 'L': return ".-..";
-    case 'M': return "--";
-    case 'N': return "-.";
-    case 'O': return "---";
-    case 'P': return ".--.";
-    case 'Q': return "--.-";
-    case 'R': return ".-.";
-    case 'S': return "...";
-    case 'T': return "-";
-    case 'U': return "..-";
-    case 'V': return "...-";
-    case 'W': return ".--";
-    case 'X': return "-..-";
-    case 'Y': return "-.--";
-    case 'Z': return "--..";
-
-    case '0': return "-----";
-    case '1': return ".----";
-    case '2': return "..---";
-    case '3': return "...--";
-    case '4': return "....-";
-    case '5': return ".....";
-    case '6': return "-....";
-    case '7': return "--...";
-    case '8': return "---..";
-    case '9': return "----.";
-
-    default: return "";
-  }
-}
-
-// 3) Vezme řetězec typu ".-.." a vybliká ho
-void blinkMorseSequence(String morse) {
-  for (int i = 0; i < morse.length(); i++) {
-    char symbol = morse.charAt(i);
-
-    if (symbol == '.') {
-      blinkDot();
-    } else if (symbol == '-') {
-      blinkDash();
-    }
-
-    // mezera mezi symboly jednoho písmene
-    if (i < morse.length() - 1) {
-      delay(SYMBOL_GAP);
+// Skládá řádek po znacích (bez čekání); po Enteru ho pošle do vysílače
+void readSerial() {
+  while (Serial.available() > 0) {
+    char c = Serial.read();
+    if (c == '\r') continue;
+    if (c != '\n') {
+      if (lineLength < MyMorse::QUEUE) line[lineLength++] = c;
+      continue;
     }
+    line[lineLength] = '\0';
+    if (lineLength > 0) sendLine();
+    lineLength = 0;
   }
 }
 
-// 4) Pomocné funkce pro tečku a čárku
-void blinkDot() {
-  digitalWrite(LED_PIN, HIGH);
-  delay(DOT_DURATION);
-  digitalWrite(LED_PIN, LOW);
+void sendLine() {
+  if (sender.space() < lineLength + 1) {
+    Serial.println("Fronta je plna, pockej az doblikam.");
+    return;
+  }
+  Serial.print("Blikam: ");
+  Serial.println(line);
+  if (sender.busy()) sender.push(' ');   // mezera mezi zprávami jako mezi slovy
+  sender.send(line);
 }
-
-void blinkDash() {
-  digitalWrite(LED_PIN, HIGH);
-  delay(DASH_DURATION);
-  digitalWrite(LED_PIN, LOW);
-}
\ No newline at end of file
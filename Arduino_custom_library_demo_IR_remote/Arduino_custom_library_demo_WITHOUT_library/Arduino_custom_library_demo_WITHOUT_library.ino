@@ -35,6 +35,9 @@ OVLÁDÁNÍ IR OVLADAČEM
 #include <IRremote.hpp>   // IRremote v3+
 
 // ============ Translated hexes ============
+// Záměrně vlastní kopie kódů, ne MyIRcodes.h: tahle verze ukazuje stav PŘED
+// knihovnou (srovnej s Arduino_custom_library_demo_WITH_library). Ostatní
+// IR sketche berou kódy jen z MyIRcodes.h – tady je nesjednocuj.
 // (Nepoužívej „surové“ hex hodnoty v if/switch. Vždy porovnávej proti těmto konstantám.)
 constexpr uint32_t ONE      = 0xBA45FF00;
 constexpr uint32_t TWO      = 0xB946FF00;
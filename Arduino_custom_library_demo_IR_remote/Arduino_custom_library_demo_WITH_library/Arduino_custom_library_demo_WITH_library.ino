@@ -267,24 +267,6 @@ void show9_palettePulse() {
   animStep++;
 }
 
-// ---------- Pomocný výpis názvu tlačítka ----------
-const char* buttonName(unsigned long code) {
-  if (code == ONE)   return "ONE";
-  if (code == TWO)   return "TWO";
-  if (code == THREE) return "THREE";
-  if (code == FOUR)  return "FOUR";
-  if (code == FIVE)  return "FIVE";
-  if (code == SIX)   return "SIX";
-  if (code == SEVEN) return "SEVEN";
-  if (code == EIGHT) return "EIGHT";
-  if (code == NINE)  return "NINE";
-  if (code == LEFTBTN)  return "LEFT";
-  if (code == RIGHTBTN) return "RIGHT";
-  if (code == UPBTN)    return "UP";
-  if (code == DOWNBTN)  return "DOWN";
-  return "UNKNOWN";
-}
-
 // ---------- IR obsluha ----------
 void handleIR() {
   if (!IrReceiver.decode()) return;
@@ -295,9 +277,9 @@ void handleIR() {
   // Debug
   Serial.print(F("IR raw=0x")); Serial.print(raw, HEX);
   if (raw == 0x0 && lastNonRepeat) {
-    Serial.print(F(" (REPEAT of ")); Serial.print(buttonName(lastNonRepeat)); Serial.print(F(")"));
+    Serial.print(F(" (REPEAT of ")); Serial.print(nameOf(lastNonRepeat)); Serial.print(F(")"));
   } else {
-    Serial.print(F(" (")); Serial.print(buttonName(raw)); Serial.print(F(")"));
+    Serial.print(F(" (")); Serial.print(nameOf(raw)); Serial.print(F(")"));
   }
   Serial.println();
 
@@ -0,0 +1,99 @@
+/************************************************************
+MyBoot.h — časová osa startu: kdy se co stihlo od resetu
+
+CO TO JE:
+- Po výpadku napájení (brownout) na pódiu je každá stovka ms tmy vidět.
+  Aby šlo start zrychlit, musí se nejdřív změřit.
+- Timeline si při mark("jméno") zapamatuje čas od startu čipu
+  (micros(), na ESP32 běží už od zavaděče aplikace). Nic se netiskne,
+  mark() trvá pár µs – tiskne se až na konci (nebo kdykoli později).
+- firstFrame() označí chvíli, kdy pásek poprvé svítí. late() řekne,
+  jestli to bylo později než cíl (targetUs, výchozí 100 ms).
+- Jména fází musí být konstanty (řetězce v uvozovkách), ukládá se jen
+  ukazatel – stejně jako %s u MyLog.
+- resetReason() (jen ESP32) řekne, proč čip startoval: „brownout“
+  znamená, že pásek při plném jasu stáhl napájení.
+
+POUŽITÍ:
+  MyBoot::Timeline boot;
+  setup(): boot.mark("serial"); ... boot.firstFrame(); ... boot.mark("wifi");
+  výpis:   for (uint8_t i = 0; i < boot.count(); i++)
+             MYLOG_I("boot %s at %lu us", boot.name(i), boot.at(i));
+  na PC:   boot.mark("x", 1234);   // čas zadaný ručně
+
+Úkoly:
+1) Proč se během startu nic netiskne hned?
+2) Čas 0 není okamžik resetu. Co všechno proběhne před ním?
+3) Přesuň ve sketchi start Wi-Fi před první snímek. O kolik se posune?
+************************************************************/
+
+#ifndef MY_BOOT_H
+#define MY_BOOT_H
+
+#ifdef ARDUINO
+#include <Arduino.h>
+#else
+#include <stdint.h>    // překlad na PC (g++) bez Arduina
+#endif
+
+#if defined(ESP32)
+#include <esp_system.h>
+#endif
+
+namespace MyBoot {
+
+  constexpr uint8_t PHASES = 16;
+
+  class Timeline {
+  public:
+    uint32_t targetUs = 100000;      // první snímek do 100 ms
+
+    void mark(const char* name, uint32_t us) {
+      if (n >= PHASES) return;
+      names[n] = name;
+      times[n] = us;
+      n++;
+    }
+    void firstFrame(uint32_t us) { frameUs = us; mark("first frame", us); }
+#ifdef ARDUINO
+    void mark(const char* name) { mark(name, micros()); }
+    void firstFrame() { firstFrame(micros()); }
+#endif
+
+    uint8_t count() const { return n; }
+    const char* name(uint8_t i) const { return names[i]; }
+    uint32_t at(uint8_t i) const { return times[i]; }
+    // Trvání fáze i = od předchozí značky (u první od startu)
+    uint32_t took(uint8_t i) const { return times[i] - (i ? times[i - 1] : 0); }
+
+    // 0 = první snímek ještě nebyl
+    uint32_t firstFrameUs() const { return frameUs; }
+    bool late() const { return frameUs == 0 || frameUs > targetUs; }
+
+  private:
+    const char* names[PHASES];
+    uint32_t times[PHASES];
+    uint8_t n = 0;
+    uint32_t frameUs = 0;
+  };
+
+#if defined(ESP32)
+  inline const char* resetReason() {
+    switch (esp_reset_reason()) {
+      case ESP_RST_POWERON:  return "power-on";
+      case ESP_RST_EXT:      return "reset pin";
+      case ESP_RST_SW:       return "software";
+      case ESP_RST_PANIC:    return "panic";
+      case ESP_RST_INT_WDT:
+      case ESP_RST_TASK_WDT:
+      case ESP_RST_WDT:      return "watchdog";
+      case ESP_RST_DEEPSLEEP:return "deep sleep";
+      case ESP_RST_BROWNOUT: return "brownout";
+      default:               return "other";
+    }
+  }
+#endif
+
+} // namespace MyBoot
+
+#endif // MY_BOOT_H
@@ -0,0 +1,350 @@
+/************************************************************
+MyColorSensor.h — TCS34725 bez čekání + LED, která se barvou „trefí“
+
+CO TO JE:
+- Adafruit tcs.getRawData() čeká celou integraci (až 614 ms) a sketche
+  k tomu přidávaly delay(500). Celou tu dobu Arduino nic nedělá –
+  ani neanimuje LED. Tady je stavový automat: spustí integraci, vrátí
+  se hned, a až uběhne integrační čas (nebo senzor stáhne pin INT),
+  přečte výsledek a rovnou spustí další měření.
+- Automatický rozsah: 7 stupňů zesílení × integrační čas, každý 4×
+  citlivější. Když je kanál C skoro plný, jde o stupeň dolů; když by se
+  4× víc ještě vešlo, jde nahoru. Přesycené měření se nezveřejní.
+- Výsledek: surová čísla, jas přepočtený na nejcitlivější stupeň (level)
+  a chromatičnost bez IR složky (chroma = podíl R, G, B, součet ~255).
+- ColorMatch: NeoPixel, který se plynule natáčí na barvu. follow() =
+  ukaž, co senzor vidí; update() = uzavřená smyčka – senzor se dívá na
+  LED a regulátor ji dolaďuje, dokud senzor nenaměří cílovou barvu.
+- Sběrnice je parametr šablony: na Arduinu WireBus (Wire.h), na PC
+  libovolná třída se stejnými dvěma funkcemi (simulovaný senzor).
+
+POUŽITÍ:
+  MyColor::WireBus bus;                     // Wire.begin() dělá begin()
+  MyColor::Tcs34725<MyColor::WireBus> tcs(bus);
+  setup(): if (!tcs.begin(millis())) { ... senzor nenalezen ... }
+  loop():  if (tcs.poll(millis())) { const MyColor::Sample& s = tcs.sample(); ... }
+           ... a mezitím klidně animuj LED, poll() nikdy nečeká
+  Pin INT (volitelné): tcs.useIntPin(true); v ISR volej tcs.notify();
+
+Úkoly:
+1) Proč je v Sample zvlášť level, když už tam je c (clear)?
+2) Co se stane s automatickým rozsahem, když senzor zakryješ dlaní?
+3) Proč ColorMatch v update() hlídá jen poměr barev a jas drží na maximu?
+************************************************************/
+
+#ifndef MY_COLOR_SENSOR_H
+#define MY_COLOR_SENSOR_H
+
+#ifdef ARDUINO
+#include <Arduino.h>
+#include <Wire.h>
+#else
+#include <stdint.h>   // překlad na PC (g++) bez Arduina
+#endif
+
+#if defined(__AVR__)
+#include <avr/pgmspace.h>
+#define MYCOLOR_ROM        PROGMEM
+#define MYCOLOR_READ8(p)   pgm_read_byte(p)
+#else
+#define MYCOLOR_ROM
+#define MYCOLOR_READ8(p)   (*(p))
+#endif
+
+namespace MyColor {
+
+  constexpr uint8_t ADDRESS = 0x29;
+
+  // Registry TCS34725 (datasheet ams, kap. „Register Set“)
+  namespace reg {
+    constexpr uint8_t ENABLE  = 0x00;
+    constexpr uint8_t ATIME   = 0x01;
+    constexpr uint8_t PERS    = 0x0C;
+    constexpr uint8_t CONTROL = 0x0F;   // zesílení AGAIN
+    constexpr uint8_t ID      = 0x12;
+    constexpr uint8_t STATUS  = 0x13;
+    constexpr uint8_t CDATAL  = 0x14;   // C, R, G, B po 2 bajtech (little endian)
+  }
+  constexpr uint8_t CMD         = 0x80;   // příkazový bit, adresa registru v dolních 5 bitech
+  constexpr uint8_t CMD_AUTOINC = 0xA0;   // čtení víc bajtů za sebou
+  constexpr uint8_t CMD_CLEAR_INT = 0xE6; // speciální funkce: shodit přerušení (pin INT)
+  constexpr uint8_t ENABLE_PON  = 0x01, ENABLE_AEN = 0x02, ENABLE_AIEN = 0x10;
+  constexpr uint8_t STATUS_AVALID = 0x01;
+
+  constexpr uint8_t  WARMUP_MS   = 3;     // po PON min. 2,4 ms před AEN
+  constexpr uint8_t  RANGE_COUNT = 7;
+
+  namespace detail {
+    // Stupně rozsahu od nejcitlivějšího: { AGAIN kód, ATIME }, citlivost = zesílení × cykly
+    constexpr uint8_t RANGES[RANGE_COUNT][2] MYCOLOR_ROM = {
+      { 3, 0x00 },   // 60× × 256 cyklů (614 ms)  15360
+      { 3, 0xC0 },   // 60× ×  64 cyklů (154 ms)   3840
+      { 2, 0xC0 },   // 16× ×  64                  1024
+      { 1, 0xC0 },   //  4× ×  64                   256
+      { 1, 0xF0 },   //  4× ×  16 cyklů (38 ms)      64
+      { 0, 0xF0 },   //  1× ×  16                    16
+      { 0, 0xFC }    //  1× ×   4 cykly (9,6 ms)      4
+    };
+    constexpr uint8_t GAIN_X[4] MYCOLOR_ROM = { 1, 4, 16, 60 };
+
+    inline uint8_t gainCode(uint8_t range) { return MYCOLOR_READ8(&RANGES[range][0]); }
+    inline uint8_t atime(uint8_t range)    { return MYCOLOR_READ8(&RANGES[range][1]); }
+    inline uint16_t cycles(uint8_t range)  { return 256 - atime(range); }
+    inline uint16_t sensitivity(uint8_t range) { return MYCOLOR_READ8(&GAIN_X[gainCode(range)]) * cycles(range); }
+    // Strop kanálu: 1024 na cyklus, max. 65535
+    inline uint16_t maxCount(uint8_t range) { return cycles(range) >= 64 ? 65535 : cycles(range) * 1024; }
+    // Integrace 2,4 ms na cyklus + 2,4 ms start ADC, zaokrouhleno nahoru
+    inline uint16_t integrationMs(uint8_t range) { return (uint16_t)((cycles(range) + 1) * 12 / 5 + 1); }
+  } // namespace detail
+
+  struct Sample {
+    uint16_t c, r, g, b;      // surová čísla z ADC
+    uint8_t  range;           // stupeň rozsahu 0 (nejcitlivější) .. 6
+    bool     saturated;       // přesycené i na nejméně citlivém stupni (moc světla)
+    uint32_t level;           // c přepočtené na stupeň 0 – srovnatelné napříč rozsahy
+    uint8_t  chroma[3];       // R, G, B bez IR, podíl ze součtu (součet ~255)
+    uint32_t seq;             // pořadové číslo měření
+
+    // Lux a teplota barvy podle ams DN40 (IR se odečte stejně jako u chroma)
+    float lux() const {
+      int32_t ir = infrared();
+      float num = 0.136f * (int32_t)(r - ir) + 1.0f * (int32_t)(g - ir) - 0.444f * (int32_t)(b - ir);
+      float cpl = detail::cycles(range) * 2.4f * MYCOLOR_READ8(&detail::GAIN_X[detail::gainCode(range)]) / 310.0f;
+      return num > 0 ? num / cpl : 0;
+    }
+    uint16_t colorTemperature() const {
+      int32_t ir = infrared(), rr = (int32_t)r - ir, bb = (int32_t)b - ir;
+      if (rr <= 0) return 0;
+      return (uint16_t)(3810L * (bb > 0 ? bb : 0) / rr + 1391);
+    }
+    int32_t infrared() const {
+      int32_t s = (int32_t)r + g + b - c;
+      return s > 0 ? s / 2 : 0;
+    }
+  };
+
+#ifdef ARDUINO
+  // I2C přes Wire: čtení 9 bajtů trvá při 100 kHz asi 1 ms, při 400 kHz 0,25 ms
+  struct WireBus {
+    void begin() { Wire.begin(); }
+    bool write(uint8_t cmd, const uint8_t* data, uint8_t n) {
+      Wire.beginTransmission(ADDRESS);
+      Wire.write(cmd);
+      for (uint8_t i = 0; i < n; i++) Wire.write(data[i]);
+      return Wire.endTransmission() == 0;
+    }
+    bool read(uint8_t cmd, uint8_t* data, uint8_t n) {
+      if (!write(cmd, nullptr, 0)) return false;
+      if (Wire.requestFrom(ADDRESS, n) != n) return false;
+      for (uint8_t i = 0; i < n; i++) data[i] = Wire.read();
+      return true;
+    }
+  };
+#endif
+
+  // BUS: bool write(cmd, data, n), bool read(cmd, data, n), void begin()
+  template<class BUS> class Tcs34725 {
+  public:
+    enum State : uint8_t { NOT_FOUND, WARMUP, INTEGRATING };
+
+    explicit Tcs34725(BUS& b) : bus(b) {}
+
+    // Najde senzor, zapne ho a naplánuje první měření (nečeká)
+    bool begin(uint32_t nowMs) {
+      bus.begin();
+      uint8_t id = 0;
+      if (!bus.read(CMD | reg::ID, &id, 1) || (id != 0x44 && id != 0x4D && id != 0x10)) {
+        st = NOT_FOUND;
+        return false;
+      }
+      writeReg(reg::PERS, 0);                   // přerušení po každém měření (pro pin INT)
+      writeReg(reg::ENABLE, ENABLE_PON);
+      loaded = 0xFF;                            // rozsah ještě není v senzoru
+      t0 = nowMs;
+      st = WARMUP;
+      return true;
+    }
+
+    // Pevný stupeň (0..6); automatický rozsah ho pak dál mění, pokud je zapnutý
+    void setRange(uint8_t r) { range = r < RANGE_COUNT ? r : RANGE_COUNT - 1; }
+    void setAutoRange(bool on) { autoRange = on; }
+    // Konec měření hlásí pin INT (aktivní LOW): v ISR volej notify()
+    void useIntPin(bool on) { intPin = on; }
+    // Na modulech Adafruit je INT propojený s LED: true = LED zhasne (jako tcs.setInterrupt).
+    // S useIntPin dohromady nejde – pin pak drží LED, ne konec měření.
+    void setInterrupt(bool on) { holdInt = on; }
+    void notify() { irq = true; }
+
+    // Volej v každém loop(); true = je nové měření v sample()
+    bool poll(uint32_t nowMs) {
+      switch (st) {
+        case NOT_FOUND:
+          return false;
+        case WARMUP:
+          if (nowMs - t0 >= WARMUP_MS) start(nowMs);
+          return false;
+        case INTEGRATING: {
+          uint32_t elapsed = nowMs - t0;
+          if (!irq && elapsed < waitMs) return false;
+          uint8_t status = 0;
+          if (!bus.read(CMD | reg::STATUS, &status, 1) || !(status & STATUS_AVALID)) {
+            if (elapsed > 2u * waitMs + 10) { errors++; restart(nowMs); }   // senzor se ztratil / byl reset
+            irq = false;
+            return false;
+          }
+          uint8_t d[8];
+          if (!bus.read(CMD_AUTOINC | reg::CDATAL, d, 8)) { errors++; restart(nowMs); return false; }
+          irq = false;
+          bool fresh = take(d);
+          if (intPin && !holdInt) bus.write(CMD_CLEAR_INT, nullptr, 0);
+          if (autoRange) adjust();
+          writeReg(reg::ENABLE, enableBits(false));   // AEN 1→0→1 = nová integrace od nuly
+          start(nowMs);
+          return fresh;
+        }
+      }
+      return false;
+    }
+
+    const Sample& sample() const { return last; }
+    State state() const { return st; }
+    uint8_t currentRange() const { return range; }
+    uint16_t integrationMs() const { return detail::integrationMs(range); }
+    uint16_t errorCount() const { return errors; }
+
+  private:
+    void writeReg(uint8_t r, uint8_t v) { bus.write(CMD | r, &v, 1); }
+
+    uint8_t enableBits(bool aen) const {
+      return ENABLE_PON | (aen ? ENABLE_AEN : 0) | ((intPin || holdInt) ? ENABLE_AIEN : 0);
+    }
+
+    void start(uint32_t nowMs) {
+      if (loaded != range) {                    // jen při změně rozsahu, ne pokaždé
+        writeReg(reg::ATIME, detail::atime(range));
+        writeReg(reg::CONTROL, detail::gainCode(range));
+        loaded = range;
+      }
+      writeReg(reg::ENABLE, enableBits(true));
+      waitMs = detail::integrationMs(range);
+      t0 = nowMs;
+      st = INTEGRATING;
+    }
+
+    void restart(uint32_t nowMs) {
+      writeReg(reg::ENABLE, ENABLE_PON);
+      loaded = 0xFF;
+      t0 = nowMs;
+      st = WARMUP;
+    }
+
+    // 8 bajtů C, R, G, B → Sample; false = přesycené (nezveřejní se, když jde ubrat citlivost)
+    bool take(const uint8_t* d) {
+      uint16_t c = d[0] | (d[1] << 8), r = d[2] | (d[3] << 8), g = d[4] | (d[5] << 8), b = d[6] | (d[7] << 8);
+      lastClear = c;
+      bool sat = c >= detail::maxCount(range) - detail::maxCount(range) / 10;
+      if (sat && range < RANGE_COUNT - 1) return false;
+      last.c = c; last.r = r; last.g = g; last.b = b;
+      last.range = range;
+      last.saturated = sat;
+      last.level = (uint32_t)c * detail::sensitivity(0) / detail::sensitivity(range);
+      int32_t ir = last.infrared();
+      int32_t rr = (int32_t)r - ir, gg = (int32_t)g - ir, bb = (int32_t)b - ir;
+      if (rr < 0) rr = 0;
+      if (gg < 0) gg = 0;
+      if (bb < 0) bb = 0;
+      int32_t sum = rr + gg + bb;
+      if (sum > 0) {
+        last.chroma[0] = (uint8_t)(rr * 255 / sum);
+        last.chroma[1] = (uint8_t)(gg * 255 / sum);
+        last.chroma[2] = (uint8_t)(bb * 255 / sum);
+      } else {
+        last.chroma[0] = last.chroma[1] = last.chroma[2] = 85;
+      }
+      last.seq++;
+      return true;
+    }
+
+    // Skoro plné → méně citlivý stupeň; 4× víc se vejde do 60 % → citlivější
+    void adjust() {
+      uint16_t c = lastClear;
+      if (c >= detail::maxCount(range) - detail::maxCount(range) / 10) {
+        if (range < RANGE_COUNT - 1) range++;
+        return;
+      }
+      if (range == 0) return;
+      uint32_t predicted = (uint32_t)c * detail::sensitivity(range - 1) / detail::sensitivity(range);
+      if (predicted < (uint32_t)detail::maxCount(range - 1) * 6 / 10) range--;
+    }
+
+    BUS&     bus;
+    State    st = NOT_FOUND;
+    uint8_t  range = 3;         // 4× / 154 ms – jako dřívější sketche
+    uint8_t  loaded = 0xFF;
+    bool     autoRange = true;
+    bool     intPin = false, holdInt = false;
+    volatile bool irq = false;
+    uint16_t waitMs = 0;
+    uint32_t t0 = 0;
+    uint16_t lastClear = 0;
+    uint16_t errors = 0;
+    Sample   last = {};
+  };
+
+  // LED, která se plynule natáčí na barvu (chroma ze Sample)
+  class ColorMatch {
+  public:
+    uint8_t gain = 96;          // jak rychle update() opravuje chybu (0..255)
+    uint8_t slew = 3;           // step(): přiblížení o 1/2^slew za snímek
+
+    ColorMatch() { for (uint8_t k = 0; k < 3; k++) { target[k] = 85; drive[k] = out[k] = 255L << 8; } }
+
+    void setTarget(const uint8_t chroma[3]) { for (uint8_t k = 0; k < 3; k++) target[k] = chroma[k]; }
+    const uint8_t* getTarget() const { return target; }
+
+    // Otevřená smyčka: LED ukáže chromatičnost, kterou senzor vidí (nejsilnější kanál = 255)
+    void follow(const uint8_t chroma[3]) {
+      setTarget(chroma);
+      for (uint8_t k = 0; k < 3; k++) drive[k] = (int32_t)chroma[k] << 8;
+      normalize();
+    }
+
+    // Uzavřená smyčka: senzor měří LED; integrační regulátor posune poměr R:G:B tak,
+    // aby naměřená chromatičnost byla cílová (vyrovná rozdíl spekter LED a senzoru)
+    void update(const uint8_t measured[3]) {
+      for (uint8_t k = 0; k < 3; k++) drive[k] += ((int32_t)target[k] - measured[k]) * gain;
+      normalize();
+    }
+
+    // Každý snímek: výstup plynule dojíždí k drive (měření chodí jen každých ~150 ms)
+    void step(uint8_t rgb[3]) {
+      for (uint8_t k = 0; k < 3; k++) {
+        out[k] += (drive[k] - out[k]) >> slew;
+        if (out[k] != drive[k] && ((drive[k] - out[k]) >> slew) == 0) out[k] = drive[k];   // dojet i poslední kousek
+        rgb[k] = (uint8_t)(out[k] >> 8);
+      }
+    }
+
+  private:
+    // Jas nechává na maximu (nejsilnější kanál = 255), regulátor řídí jen poměr barev
+    void normalize() {
+      int32_t mx = 256;
+      for (uint8_t k = 0; k < 3; k++) {
+        if (drive[k] < 0) drive[k] = 0;
+        if (drive[k] > mx) mx = drive[k];
+      }
+      int32_t m8 = mx >> 8;                     // bez 64bit dělení (AVR)
+      for (uint8_t k = 0; k < 3; k++) {
+        drive[k] = drive[k] * 255 / m8;
+        if (drive[k] > (255L << 8)) drive[k] = 255L << 8;
+      }
+    }
+
+    uint8_t target[3];
+    int32_t drive[3];           // požadovaná barva × 256
+    int32_t out[3];             // co LED právě ukazuje × 256
+  };
+
+} // namespace MyColor
+
+#endif // MY_COLOR_SENSOR_H
@@ -0,0 +1,310 @@
+/************************************************************
+IRDecoder.h — dekodér IR signálu z délek pulzů (bez knihovny IRremote)
+
+CO TO DĚLÁ:
+- Dostává proud "značka / mezera + délka v µs" (značka = IR svítí,
+  na výstupu přijímače je LOW) a sám z něj skládá rámce.
+- Protokoly jsou popsané TABULKOU časování (PROTOCOLS[]): NEC (+ NEC repeat),
+  Philips RC5 a Sony SIRC (12/15/20 bitů). Každá hrana projde všemi
+  stavovými automaty najednou – kdo první rámec dokončí, ten vyhrál.
+- Tolerance časování je v tabulce (±procenta, min. ±150 µs).
+- Výstup je MyIR::Button (přes tabulku v MyIRcodes.h) + auto-repeat:
+  při držení tlačítka přijde první opakování po repeatDelayMs a pak
+  každých repeatIntervalMs (0 = neopakovat).
+- Nepotřebuje Arduino.h, takže jde přeložit i na PC a krmit ho
+  nahranými časy ze souboru.
+
+POUŽITÍ:
+  MyIR::IRDecoder ir;
+  ir.feed(true, 9000);  ir.feed(false, 4500); ...   // z přerušení / bufferu
+  ir.endBurst();                                    // po >20 ms ticha
+  MyIR::IREvent e;
+  while (ir.read(e)) { ... e.button, e.repeat ... }
+
+Úkoly:
+1) Proč NEC repeat rámec (9 ms + 2,25 ms + 560 µs) nenese žádný kód?
+2) Jak RC5 pozná, že tlačítko pořád držíš, když nemá repeat rámec? (toggle bit)
+3) Přidej do PROTOCOLS[] další protokol s pulse-distance kódováním.
+************************************************************/
+
+#ifndef MY_IR_DECODER_H
+#define MY_IR_DECODER_H
+
+#include "MyIRcodes.h"
+
+namespace MyIR {
+
+  enum Protocol : uint8_t { PROTO_NONE = 0, PROTO_NEC, PROTO_RC5, PROTO_SIRC };
+
+  enum Coding : uint8_t {
+    PULSE_DISTANCE,   // bit je v délce mezery (NEC)
+    PULSE_WIDTH,      // bit je v délce značky (Sony)
+    BIPHASE           // Manchester, bit = směr hrany uprostřed (RC5)
+  };
+
+  struct Timing {
+    Protocol proto;
+    Coding   coding;
+    uint16_t hdrMark, hdrSpace;   // hlavička, 0 = bez hlavičky
+    uint16_t rptSpace;            // mezera repeat rámce za hlavičkou, 0 = nemá
+    uint16_t unit;                // PD: značka bitu, PW: mezera bitu, BIPHASE: půlbit
+    uint16_t zero, one;           // PD: mezera pro 0/1, PW: značka pro 0/1
+    uint8_t  bits[3];             // povolené délky rámce (0 = nic)
+    uint8_t  tolPct;              // tolerance ±%
+    uint16_t holdMs;              // max. rozestup rámců při držení tlačítka
+  };
+
+  constexpr Timing PROTOCOLS[] = {
+    // proto       coding          hdrM  hdrS  rptS  unit  zero  one   bits          tol hold
+    { PROTO_NEC,  PULSE_DISTANCE, 9000, 4500, 2250,  560,  560, 1690, { 32,  0,  0 }, 25, 150 },
+    { PROTO_RC5,  BIPHASE,           0,    0,    0,  889,    0,    0, { 14,  0,  0 }, 25, 150 },
+    { PROTO_SIRC, PULSE_WIDTH,    2400,  600,    0,  600,  600, 1200, { 12, 15, 20 }, 25, 100 },
+  };
+  constexpr uint8_t PROTOCOL_COUNT = sizeof(PROTOCOLS) / sizeof(PROTOCOLS[0]);
+
+  // Jeden dekódovaný stisk / opakování
+  struct IREvent {
+    Button   button;      // BTN_NONE = neznámý kód (address/command i tak platí)
+    Protocol proto;
+    uint16_t address;
+    uint8_t  command;
+    uint8_t  toggle;      // RC5 toggle bit (mění se s každým novým stiskem), jinak 0
+    bool     repeat;      // auto-repeat při držení
+  };
+
+  class IRDecoder {
+  public:
+    uint16_t repeatDelayMs    = 400;   // první opakování po ...
+    uint16_t repeatIntervalMs = 120;   // ... a pak každých (0 = vypnuto)
+
+    IRDecoder() { reset(); }
+
+    void reset() {
+      for (uint8_t p = 0; p < PROTOCOL_COUNT; p++) m[p] = Machine();
+      head = tail = 0;
+      clockUs = 0;
+      held = false;
+      overflows = 0;
+    }
+
+    // Jedna úplná úroveň: mark = IR svítil, us = jak dlouho
+    void feed(bool mark, uint32_t us) {
+      clockUs += us;
+      for (uint8_t p = 0; p < PROTOCOL_COUNT; p++) step(p, mark, us);
+    }
+
+    // Dlouhé ticho po posledním pulzu: dokonči rámce s proměnnou délkou
+    // (SIRC, RC5 končící nulou). Čas se neposouvá – ten přinese další feed().
+    void endBurst() {
+      for (uint8_t p = 0; p < PROTOCOL_COUNT; p++) step(p, false, GAP_US, true);
+    }
+
+    bool read(IREvent& e) {
+      if (head == tail) return false;
+      e = queue[tail];
+      tail = (uint8_t)((tail + 1) % QUEUE_LEN);
+      return true;
+    }
+
+    // ms přetečou až za 49 dní a rozdíly now - x přes přetečení fungují
+    uint32_t nowMs() const { return (uint32_t)(clockUs / 1000); }
+    uint16_t overflowCount() const { return overflows; }
+
+  private:
+    static constexpr uint32_t GAP_US    = 20000;   // ticho = konec rámce
+    static constexpr uint8_t  QUEUE_LEN = 4;
+
+    enum State : uint8_t { IDLE, HDR_SPACE, BIT_MARK, BIT_SPACE, STOP_MARK, RPT_MARK };
+
+    struct Machine {
+      State    state = IDLE;
+      uint8_t  count = 0;      // přijaté bity
+      uint8_t  half  = 0;      // BIPHASE: 0 = nic, 1 = čeká 1. půlka space, 2 = mark
+      uint32_t bits  = 0;
+    };
+
+    static bool near(uint32_t d, uint16_t nominal, uint8_t tolPct) {
+      uint32_t slack = (uint32_t)nominal * tolPct / 100;
+      if (slack < 150) slack = 150;
+      return d + slack >= nominal && d <= nominal + slack;
+    }
+
+    static bool lengthOk(const Timing& t, uint8_t n) {
+      return n && (n == t.bits[0] || n == t.bits[1] || n == t.bits[2]);
+    }
+
+    static uint8_t maxBits(const Timing& t) {
+      uint8_t n = t.bits[0];
+      if (t.bits[1] > n) n = t.bits[1];
+      if (t.bits[2] > n) n = t.bits[2];
+      return n;
+    }
+
+    void step(uint8_t p, bool mark, uint32_t us, bool flush = false) {
+      const Timing& t = PROTOCOLS[p];
+      Machine& s = m[p];
+      if (t.coding == BIPHASE) { stepBiphase(p, mark, us, flush); return; }
+
+      switch (s.state) {
+        case IDLE:
+          if (mark && near(us, t.hdrMark, t.tolPct)) s.state = HDR_SPACE;
+          break;
+
+        case HDR_SPACE:
+          s.bits = 0; s.count = 0;
+          if (!mark && near(us, t.hdrSpace, t.tolPct))                  s.state = BIT_MARK;
+          else if (!mark && t.rptSpace && near(us, t.rptSpace, t.tolPct)) s.state = RPT_MARK;
+          else s.state = IDLE;
+          break;
+
+        case BIT_MARK:
+          if (!mark) { s.state = IDLE; break; }
+          if (t.coding == PULSE_DISTANCE) {
+            s.state = near(us, t.unit, t.tolPct) ? BIT_SPACE : IDLE;
+          } else {                                       // PULSE_WIDTH: bit v značce
+            if      (near(us, t.one,  t.tolPct)) s.bits |= 1UL << s.count;
+            else if (!near(us, t.zero, t.tolPct)) { s.state = IDLE; break; }
+            s.count++;
+            s.state = BIT_SPACE;
+          }
+          break;
+
+        case BIT_SPACE:
+          if (mark) { s.state = IDLE; break; }
+          if (t.coding == PULSE_DISTANCE) {
+            if      (near(us, t.one,  t.tolPct)) s.bits |= 1UL << s.count;
+            else if (!near(us, t.zero, t.tolPct)) { s.state = IDLE; break; }
+            s.count++;
+            s.state = (s.count >= maxBits(t)) ? STOP_MARK : BIT_MARK;
+          } else {
+            bool gap = flush || us > (uint32_t)t.one * 2;
+            if (!gap && near(us, t.unit, t.tolPct) && s.count < maxBits(t)) { s.state = BIT_MARK; break; }
+            if (gap && lengthOk(t, s.count)) frame(p, s.bits, s.count, false);
+            s.state = IDLE;
+          }
+          break;
+
+        case STOP_MARK:
+          if (mark && near(us, t.unit, t.tolPct) && lengthOk(t, s.count)) frame(p, s.bits, s.count, false);
+          s.state = IDLE;
+          break;
+
+        case RPT_MARK:
+          if (mark && near(us, t.unit, t.tolPct)) frame(p, 0, 0, true);
+          s.state = IDLE;
+          break;
+      }
+      // značka, která nic nedokončila, může být začátek nové hlavičky
+      if (s.state == IDLE && mark && t.hdrMark && near(us, t.hdrMark, t.tolPct)) s.state = HDR_SPACE;
+    }
+
+    // RC5: každá délka je 1 nebo 2 půlbity; dvojice (space, mark) = 1, (mark, space) = 0
+    void stepBiphase(uint8_t p, bool mark, uint32_t us, bool flush) {
+      const Timing& t = PROTOCOLS[p];
+      Machine& s = m[p];
+      uint8_t halves = near(us, t.unit, t.tolPct) ? 1 : near(us, 2 * t.unit, t.tolPct) ? 2 : 0;
+
+      if (s.state == IDLE) {
+        if (!mark || !halves) return;
+        s.state = BIT_MARK; s.bits = 0; s.count = 0;
+        s.half = 1;                                  // start bit: neviditelná půlka space
+      } else if (!halves) {
+        // dlouhé ticho: poslední bit mohl být 0 (mark, space...) – dopiš space
+        if (!mark && (flush || us > 4UL * t.unit) && s.half == 2) pushHalf(s, false);
+        if (s.count == maxBits(t) && s.half == 0) frame(p, s.bits, s.count, false);
+        s.state = IDLE;
+        if (mark) stepBiphase(p, mark, us, flush);
+        return;
+      }
+      for (uint8_t h = 0; h < halves; h++) {
+        if (!pushHalf(s, mark)) { s.state = IDLE; return; }
+      }
+      if (s.count == maxBits(t) && s.half == 0) {
+        frame(p, s.bits, s.count, false);
+        s.state = IDLE;
+      }
+    }
+
+    // false = neplatná dvojice půlbitů nebo moc bitů
+    static bool pushHalf(Machine& s, bool mark) {
+      if (s.half == 0) { s.half = mark ? 2 : 1; return true; }
+      bool first = (s.half == 2);
+      s.half = 0;
+      if (first == mark || s.count >= 32) return false;
+      s.bits = (s.bits << 1) | (mark ? 1 : 0);      // RC5 je MSB first
+      s.count++;
+      return true;
+    }
+
+    // Hotový rámec → IREvent (+ rozhodnutí stisk / držení / auto-repeat)
+    void frame(uint8_t p, uint32_t bits, uint8_t n, bool necRepeat) {
+      const Timing& t = PROTOCOLS[p];
+      uint32_t now = nowMs();
+      IREvent e;
+      e.proto = t.proto;
+      e.toggle = 0;
+      e.repeat = false;
+
+      if (necRepeat) {
+        if (!held || heldEv.proto != t.proto || now - lastFrameMs > t.holdMs) return;
+        e = heldEv;
+      } else if (t.proto == PROTO_NEC) {
+        bool extended = (uint8_t)(bits >> 8) != (uint8_t)~bits;                    // 16bit adresa
+        e.address = (uint16_t)(extended ? (bits & 0xFFFF) : (bits & 0xFF));
+        e.command = (uint8_t)(bits >> 16);
+        e.button  = lookup(bits);
+        if (e.button == BTN_NONE && (uint8_t)~(bits >> 24) != e.command) return;   // rušení
+      } else if (t.proto == PROTO_RC5) {
+        if (!(bits & (1UL << 13))) return;                                          // S1 musí být 1
+        e.toggle  = (bits >> 11) & 1;
+        e.address = (uint16_t)((bits >> 6) & 0x1F);
+        e.command = (uint8_t)((bits & 0x3F) | ((bits & (1UL << 12)) ? 0 : 0x40));
+        e.button  = fromRc5(e.command);
+      } else {                                                                     // SIRC
+        e.command = (uint8_t)(bits & 0x7F);
+        e.address = (uint16_t)(bits >> 7);
+        e.button  = fromSirc(e.command);
+        (void)n;
+      }
+
+      // Stejný rámec v krátkém sledu = držení (RC5 i s toggle bitem)
+      bool sameAsHeld = held && !necRepeat && heldEv.proto == e.proto &&
+                        heldEv.address == e.address && heldEv.command == e.command &&
+                        heldEv.toggle == e.toggle &&
+                        now - lastFrameMs <= t.holdMs;
+      if (necRepeat || sameAsHeld) {
+        lastFrameMs = now;
+        if (!repeatIntervalMs || now - pressMs < repeatDelayMs || now - lastEmitMs < repeatIntervalMs) return;
+        e.repeat = true;
+        lastEmitMs = now;
+        push(e);
+        return;
+      }
+
+      held = true;
+      heldEv = e;
+      pressMs = lastFrameMs = lastEmitMs = now;
+      push(e);
+    }
+
+    void push(const IREvent& e) {
+      uint8_t next = (uint8_t)((head + 1) % QUEUE_LEN);
+      if (next == tail) { overflows++; return; }    // plná fronta: nejnovější zahodíme
+      queue[head] = e;
+      head = next;
+    }
+
+    Machine  m[PROTOCOL_COUNT];
+    IREvent  queue[QUEUE_LEN];
+    uint8_t  head, tail;
+    uint64_t clockUs;             // 32 bitů µs by přeteklo po 71 minutách
+    uint16_t overflows;
+
+    bool     held;
+    IREvent  heldEv;
+    uint32_t pressMs, lastFrameMs, lastEmitMs;
+  };
+
+} // namespace MyIR
+
+#endif // MY_IR_DECODER_H
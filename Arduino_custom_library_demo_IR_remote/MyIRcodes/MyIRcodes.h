@@ -1,114 +1,199 @@
-/************************************************************
-ZAPOJENÍ (pro testovací příklad s IRremote v3+):
-- IR přijímač:
-    VCC → 5V
-    GND → GND
-    OUT → D2 (Arduino Leonardo)
-- Tento soubor je pouze "knihovna" s konstantami a pomocnými funkcemi.
-
-Úkoly, pro pochopení kódu:
-1) Jak ti pomáhá mít všechny IR kódy a názvy tlačítek v jedné knihovně?
-2) Co vrátí decode(), když přijde opakovací kód 0x0 (NEC repeat)? Proč potřebuje "last"?
-3) Jak bys přidal nové tlačítko? (doplnit konstantu, enum, case v decode(), label v label())
-
-************************************************************/
-
-#ifndef MY_IRCODES_H
-#define MY_IRCODES_H
-
-#include <Arduino.h>
-
-namespace MyIR {
-
-  // --- Pojmenované konstanty pro tvoje kódy ---
-  constexpr uint32_t ONE      = 0xBA45FF00;
-  constexpr uint32_t TWO      = 0xB946FF00;
-  constexpr uint32_t THREE    = 0xB847FF00;
-  constexpr uint32_t FOUR     = 0xBB44FF00;
-  constexpr uint32_t FIVE     = 0xBF40FF00;
-  constexpr uint32_t SIX      = 0xBC43FF00;
-  constexpr uint32_t SEVEN    = 0xF807FF00;
-  constexpr uint32_t EIGHT    = 0xEA15FF00;
-  constexpr uint32_t NINE     = 0xF609FF00;
-  constexpr uint32_t STARBTN  = 0xE916FF00;
-  constexpr uint32_t ZERO     = 0xE619FF00;
-  constexpr uint32_t HASHBTN  = 0xF20DFF00;
-  constexpr uint32_t UPBTN    = 0xE718FF00;
-  constexpr uint32_t LEFTBTN  = 0xF708FF00;
-  constexpr uint32_t OKBTN    = 0xE31CFF00;
-  constexpr uint32_t RIGHTBTN = 0xA55AFF00;
-  constexpr uint32_t DOWNBTN  = 0xAD52FF00;
-
-  constexpr uint32_t NEC_REPEAT = 0x0;
-
-  // Logická jména tlačítek
-  enum Button : uint8_t {
-    BTN_NONE = 0,
-    BTN_1, BTN_2, BTN_3,
-    BTN_4, BTN_5, BTN_6,
-    BTN_7, BTN_8, BTN_9,
-    BTN_STAR, BTN_0, BTN_HASH,
-    BTN_UP, BTN_LEFT, BTN_OK, BTN_RIGHT, BTN_DOWN
-  };
-
-  // Překlad číselného kódu na Button s ošetřením NEC repeat (0x0).
-  // Parametr 'last' drží poslední skutečný stisk (předávej proměnnou z hlavního kódu).
-  inline Button decode(uint32_t rawCode, Button& last) {
-    if (rawCode == NEC_REPEAT) {
-      return last; // držení tlačítka
-    }
-    Button found = BTN_NONE;
-    switch (rawCode) {
-      case ONE:      found = BTN_1; break;
-      case TWO:      found = BTN_2; break;
-      case THREE:    found = BTN_3; break;
-      case FOUR:     found = BTN_4; break;
-      case FIVE:     found = BTN_5; break;
-      case SIX:      found = BTN_6; break;
-      case SEVEN:    found = BTN_7; break;
-      case EIGHT:    found = BTN_8; break;
-      case NINE:     found = BTN_9; break;
-      case STARBTN:  found = BTN_STAR; break;
-      case ZERO:     found = BTN_0; break;
-      case HASHBTN:  found = BTN_HASH; break;
-      case UPBTN:    found = BTN_UP; break;
-      case LEFTBTN:  found = BTN_LEFT; break;
-      case OKBTN:    found = BTN_OK; break;
-      case RIGHTBTN: found = BTN_RIGHT; break;
-      case DOWNBTN:  found = BTN_DOWN; break;
-      default:       found = BTN_NONE; break;
-    }
-    if (found != BTN_NONE) last = found;
-    return found;
-  }
-
-  // Hezký popisek tlačítka
-  inline const char* label(Button b) {
-    switch (b) {
-      case BTN_1: return "1";
-      case BTN_2: return "2";
-      case BTN_3: return "3";
-      case BTN_4: return "4";
-      case BTN_5: return "5";
-      case BTN_6: return "6";
-      case BTN_7: return "7";
-      case BTN_8: return "8";
-      case BTN_9: return "9";
-      case BTN_0: return "0";
-      case BTN_STAR: return "*";
-      case BTN_HASH: return "#";
-      case BTN_UP: return "UP";
-      case BTN_DOWN: return "DOWN";
-      case BTN_LEFT: return "LEFT";
-      case BTN_RIGHT: return "RIGHT";
-      case BTN_OK: return "OK";
-      default: return "(none)";
-    }
-  }
-
-  // Jednoduchá pomůcka: je to některé z námi známých tlačítek?
-  inline bool isKnown(Button b) { return b != BTN_NONE; }
-
-} // namespace MyIR
-
-#endif // MY_IRCODES_H
+/************************************************************
+ZAPOJENÍ (pro testovací příklad s IRremote v3+):
+- IR přijímač:
+    VCC → 5V
+    GND → GND
+    OUT → D2 (Arduino Leonardo)
+- Tento soubor je pouze "knihovna" s konstantami a pomocnými funkcemi.
+
+JAK TO FUNGUJE:
+- Všechna tlačítka jsou v JEDNÉ tabulce MYIR_BUTTONS (tzv. X-makro).
+  Z ní se při překladu vyrobí: konstanty ONE, TWO, ..., enum Button,
+  NEC command byte, popisky label()/name() i vyhledávací tabulka.
+- NEC kód z IRremote (decodedRawData) = ~cmd | cmd | ~adresa | adresa,
+  např. ONE = 0xBA45FF00 → cmd 0x45, adresa 0x00.
+- lookup() najde tlačítko v O(1): z cmd spočítá "perfektní hash"
+  (slot 0..31 bez kolizí), jeden přístup do tabulky a hotovo.
+- Sloupce RC5/SIRC jsou pro IRDecoder.h, který umí i ovladače Philips a Sony
+  a dekóduje přímo z délek pulzů (bez IRremote).
+
+Úkoly, pro pochopení kódu:
+1) Jak ti pomáhá mít všechny IR kódy a názvy tlačítek v jedné knihovně?
+2) Co vrátí decode(), když přijde opakovací kód 0x0 (NEC repeat)? Proč potřebuje "last"?
+3) Jak bys přidal nové tlačítko? (stačí jeden řádek v MYIR_BUTTONS – a když
+   static_assert nahlásí kolizi, zkus jiné HASH_MUL)
+
+************************************************************/
+
+#ifndef MY_IRCODES_H
+#define MY_IRCODES_H
+
+#ifdef ARDUINO
+#include <Arduino.h>
+#else
+#include <stdint.h>   // překlad na PC (g++) bez Arduina
+#endif
+
+#if defined(__AVR__)
+#include <avr/pgmspace.h>
+#define MYIR_ROM           PROGMEM
+#define MYIR_READ8(p)      pgm_read_byte(p)
+#define MYIR_READSTR(p)    ((const char*)pgm_read_ptr(p))
+#else
+#define MYIR_ROM
+#define MYIR_READ8(p)      (*(p))
+#define MYIR_READSTR(p)    (*(p))
+#endif
+
+// --- Jediná tabulka tlačítek ---
+//   X(konstanta, enum, NEC cmd, RC5 cmd, SIRC cmd, label, name)
+// Pořadí = pořadí v enum Button (neměň, sketche s ním počítají).
+// RC5 (Philips) a SIRC (Sony) = běžný TV ovladač, 0xFF = tlačítko nemá.
+#define MYIR_BUTTONS(X)                                      \
+  X(ONE,      BTN_1,     0x45, 0x01, 0x00, "1",     "ONE")   \
+  X(TWO,      BTN_2,     0x46, 0x02, 0x01, "2",     "TWO")   \
+  X(THREE,    BTN_3,     0x47, 0x03, 0x02, "3",     "THREE") \
+  X(FOUR,     BTN_4,     0x44, 0x04, 0x03, "4",     "FOUR")  \
+  X(FIVE,     BTN_5,     0x40, 0x05, 0x04, "5",     "FIVE")  \
+  X(SIX,      BTN_6,     0x43, 0x06, 0x05, "6",     "SIX")   \
+  X(SEVEN,    BTN_7,     0x07, 0x07, 0x06, "7",     "SEVEN") \
+  X(EIGHT,    BTN_8,     0x15, 0x08, 0x07, "8",     "EIGHT") \
+  X(NINE,     BTN_9,     0x09, 0x09, 0x08, "9",     "NINE")  \
+  X(STARBTN,  BTN_STAR,  0x16, 0xFF, 0xFF, "*",     "STAR")  \
+  X(ZERO,     BTN_0,     0x19, 0x00, 0x09, "0",     "ZERO")  \
+  X(HASHBTN,  BTN_HASH,  0x0D, 0xFF, 0xFF, "#",     "HASH")  \
+  X(UPBTN,    BTN_UP,    0x18, 0x20, 0x10, "UP",    "UP")    \
+  X(LEFTBTN,  BTN_LEFT,  0x08, 0x11, 0x13, "LEFT",  "LEFT")  \
+  X(OKBTN,    BTN_OK,    0x1C, 0x3B, 0x65, "OK",    "OK")    \
+  X(RIGHTBTN, BTN_RIGHT, 0x5A, 0x10, 0x12, "RIGHT", "RIGHT") \
+  X(DOWNBTN,  BTN_DOWN,  0x52, 0x21, 0x11, "DOWN",  "DOWN")
+
+namespace MyIR {
+
+  constexpr uint8_t NEC_ADDRESS = 0x00;   // adresa našeho ovladače
+
+  // 32bit kód tak, jak ho vrací IrReceiver.decodedIRData.decodedRawData
+  constexpr uint32_t necRaw(uint8_t cmd, uint8_t addr = NEC_ADDRESS) {
+    return ((uint32_t)(uint8_t)~cmd << 24) | ((uint32_t)cmd << 16) |
+           ((uint32_t)(uint8_t)~addr << 8) | addr;
+  }
+
+  // --- Pojmenované konstanty pro tvoje kódy (ONE, TWO, ...) ---
+#define MYIR_X_CONST(c, b, cmd, rc5, sirc, l, n) constexpr uint32_t c = necRaw(cmd);
+  MYIR_BUTTONS(MYIR_X_CONST)
+#undef MYIR_X_CONST
+
+  constexpr uint32_t NEC_REPEAT = 0x0;
+
+  // Logická jména tlačítek
+#define MYIR_X_ENUM(c, b, cmd, rc5, sirc, l, n) b,
+  enum Button : uint8_t {
+    BTN_NONE = 0,
+    MYIR_BUTTONS(MYIR_X_ENUM)
+    BUTTON_COUNT
+  };
+#undef MYIR_X_ENUM
+
+  namespace detail {
+    // NEC cmd podle Button (index 0 = BTN_NONE, nepoužito)
+#define MYIR_X_CMD(c, b, cmd, rc5, sirc, l, n) cmd,
+    constexpr uint8_t CMD[BUTTON_COUNT] MYIR_ROM = { 0, MYIR_BUTTONS(MYIR_X_CMD) };
+#define MYIR_X_RC5(c, b, cmd, rc5, sirc, l, n) rc5,
+#define MYIR_X_SIRC(c, b, cmd, rc5, sirc, l, n) sirc,
+    constexpr uint8_t CMD_RC5[BUTTON_COUNT]  MYIR_ROM = { 0xFF, MYIR_BUTTONS(MYIR_X_RC5) };
+    constexpr uint8_t CMD_SIRC[BUTTON_COUNT] MYIR_ROM = { 0xFF, MYIR_BUTTONS(MYIR_X_SIRC) };
+#undef MYIR_X_CMD
+#undef MYIR_X_RC5
+#undef MYIR_X_SIRC
+
+#define MYIR_X_LABEL(c, b, cmd, rc5, sirc, l, n) l,
+#define MYIR_X_NAME(c, b, cmd, rc5, sirc, l, n)  n,
+    constexpr const char* const LABEL[BUTTON_COUNT] MYIR_ROM = { "(none)",  MYIR_BUTTONS(MYIR_X_LABEL) };
+    constexpr const char* const NAME[BUTTON_COUNT]  MYIR_ROM = { "UNKNOWN", MYIR_BUTTONS(MYIR_X_NAME) };
+#undef MYIR_X_LABEL
+#undef MYIR_X_NAME
+
+    // Perfektní hash: slot = (cmd * HASH_MUL mod 256) >> 3  → 0..31
+    constexpr uint8_t HASH_MUL   = 0x65;
+    constexpr uint8_t HASH_SLOTS = 32;
+    constexpr uint8_t slotOf(uint8_t cmd) { return (uint8_t)(cmd * HASH_MUL) >> 3; }
+
+    // Vše níže běží jen při překladu (constexpr rekurze místo cyklu kvůli C++11)
+    constexpr uint8_t buttonInSlot(uint8_t slot, uint8_t b = 1) {
+      return b >= BUTTON_COUNT ? (uint8_t)BTN_NONE
+           : slotOf(CMD[b]) == slot ? b
+           : buttonInSlot(slot, b + 1);
+    }
+    constexpr bool collisionFree(uint8_t a = 1, uint8_t b = 2) {
+      return a + 1 >= BUTTON_COUNT ? true
+           : b >= BUTTON_COUNT ? collisionFree(a + 1, a + 2)
+           : slotOf(CMD[a]) != slotOf(CMD[b]) && collisionFree(a, b + 1);
+    }
+    static_assert(collisionFree(), "MyIRcodes: dvě tlačítka mají stejný hash slot, změň HASH_MUL");
+
+#define MYIR_S4(n) buttonInSlot(n), buttonInSlot(n + 1), buttonInSlot(n + 2), buttonInSlot(n + 3)
+    constexpr uint8_t SLOT[HASH_SLOTS] MYIR_ROM = {
+      MYIR_S4(0),  MYIR_S4(4),  MYIR_S4(8),  MYIR_S4(12),
+      MYIR_S4(16), MYIR_S4(20), MYIR_S4(24), MYIR_S4(28)
+    };
+#undef MYIR_S4
+  } // namespace detail
+
+  // NEC command byte tlačítka (IrReceiver.decodedIRData.command)
+  inline uint8_t command(Button b) {
+    return b < BUTTON_COUNT ? MYIR_READ8(&detail::CMD[b]) : 0;
+  }
+
+  inline uint32_t code(Button b) { return b != BTN_NONE ? necRaw(command(b)) : 0; }
+
+  // NEC command byte → Button, O(1)
+  inline Button fromCommand(uint8_t cmd) {
+    uint8_t b = MYIR_READ8(&detail::SLOT[detail::slotOf(cmd)]);
+    return (b != BTN_NONE && MYIR_READ8(&detail::CMD[b]) == cmd) ? (Button)b : BTN_NONE;
+  }
+
+  // RC5 / SIRC command → Button (jen 17 položek, stačí projít tabulku)
+  inline Button fromRc5(uint8_t cmd) {
+    for (uint8_t b = 1; b < BUTTON_COUNT; b++) if (MYIR_READ8(&detail::CMD_RC5[b]) == cmd) return (Button)b;
+    return BTN_NONE;
+  }
+  inline Button fromSirc(uint8_t cmd) {
+    for (uint8_t b = 1; b < BUTTON_COUNT; b++) if (MYIR_READ8(&detail::CMD_SIRC[b]) == cmd) return (Button)b;
+    return BTN_NONE;
+  }
+
+  // Celý 32bit kód → Button, O(1). Kontroluje adresu i negované bajty.
+  inline Button lookup(uint32_t rawCode) {
+    uint8_t cmd = (uint8_t)(rawCode >> 16);
+    if (rawCode != necRaw(cmd)) return BTN_NONE;
+    return fromCommand(cmd);
+  }
+
+  // Překlad číselného kódu na Button s ošetřením NEC repeat (0x0).
+  // Parametr 'last' drží poslední skutečný stisk (předávej proměnnou z hlavního kódu).
+  inline Button decode(uint32_t rawCode, Button& last) {
+    if (rawCode == NEC_REPEAT) {
+      return last; // držení tlačítka
+    }
+    Button found = lookup(rawCode);
+    if (found != BTN_NONE) last = found;
+    return found;
+  }
+
+  // Hezký popisek tlačítka ("1", "*", "UP", ...)
+  inline const char* label(Button b) {
+    return MYIR_READSTR(&detail::LABEL[b < BUTTON_COUNT ? b : BTN_NONE]);
+  }
+
+  // Jméno pro výpis do Serialu ("ONE", "LEFT", ..., "UNKNOWN")
+  inline const char* name(Button b) {
+    return MYIR_READSTR(&detail::NAME[b < BUTTON_COUNT ? b : BTN_NONE]);
+  }
+  inline const char* nameOf(uint32_t rawCode) { return name(lookup(rawCode)); }
+
+  // Jednoduchá pomůcka: je to některé z námi známých tlačítek?
+  inline bool isKnown(Button b) { return b != BTN_NONE; }
+
+} // namespace MyIR
+
+#endif // MY_IRCODES_H
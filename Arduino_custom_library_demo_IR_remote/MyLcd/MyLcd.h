@@ -0,0 +1,195 @@
+/************************************************************
+MyLcd.h — LCD přes I2C bez zdržování: stínová kopie displeje
+
+CO TO JE:
+- Jeden znak na LCD s převodníkem PCF8574 stojí 6 zápisů po I2C (asi
+  1,3 ms při 100 kHz). lcd.clear() + vypsání celé obrazovky 20×4 je
+  přes 100 ms – celou tu dobu stojí enkodér i animace LED.
+- Shadow je „LCD v paměti“: má stejné setCursor/print/clear jako
+  LiquidCrystal_I2C, ale píše jen do pole znaků. Sketch tedy může klidně
+  překreslit celou obrazovku, nic se neposílá.
+- flush(n) pak porovná pole s tím, co displej opravdu ukazuje, a pošle
+  jen změněné znaky – nejvýš n zápisů najednou (znak = 1, přesun
+  kurzoru = 1). Kurzor se přesouvá jen tam, kde změny nenavazují.
+  Volá se z loop(), takže jedno volání trvá jen pár ms.
+- Po clear() se změní skoro celá obrazovka; když je levnější opravdu
+  smazat LCD a poslat jen nemezerové znaky, flush() to tak udělá.
+- Text za koncem řádku se ořízne (skutečné LCD by ho hodilo na jiný řádek).
+
+POUŽITÍ:
+  LiquidCrystal_I2C lcdHw(0x27, 20, 4);
+  MyLcd::Shadow<LiquidCrystal_I2C, 20, 4> lcd(lcdHw);
+  setup(): lcdHw.init(); lcdHw.backlight(); lcd.begin();
+  kdekoli:  lcd.clear(); lcd.setCursor(0, 1); lcd.print("Ahoj"); lcd.print(42);
+  loop():   lcd.flush(4);          // max. 4 zápisy ≈ 5 ms na jeden průchod
+  před delay(): lcd.flushAll();    // když to na displeji musí být hned
+
+Úkoly:
+1) Proč lcd.clear() na Shadow nic neposílá a stejně displej „smaže“?
+2) Co se stane, když loop() volá flush(1)? A flush(80)?
+3) Kolik zápisů stojí přepsat „Vyber: 3“ na „Vyber: 4“?
+************************************************************/
+
+#ifndef MY_LCD_H
+#define MY_LCD_H
+
+#ifdef ARDUINO
+#include <Arduino.h>   // Print: print(číslo), print(F("..."))...
+#else
+#include <stdint.h>    // překlad na PC (g++) bez Arduina
+#include <stddef.h>
+#endif
+
+namespace MyLcd {
+
+  namespace detail {
+#ifdef ARDUINO
+    typedef Print PrintBase;
+#else
+    struct PrintBase {
+      virtual size_t write(uint8_t c) = 0;
+      size_t print(const char* s) { size_t n = 0; while (*s) n += write((uint8_t)*s++); return n; }
+      virtual ~PrintBase() {}
+    };
+#endif
+  } // namespace detail
+
+  constexpr uint8_t NOWHERE    = 0xFF;   // skutečný kurzor LCD neznámo kde
+  constexpr uint8_t CLEAR_COST = 3;      // lcd.clear() = příkaz + 2 ms čekání ≈ 3 zápisy
+
+  // LCD = cokoli se setCursor(sloupec, řádek) a write(znak), typicky LiquidCrystal_I2C
+  template<class LCD, uint8_t COLS, uint8_t ROWS>
+  class Shadow : public detail::PrintBase {
+    static_assert(ROWS <= 8, "rowDirty má 8 bitů");
+
+  public:
+    explicit Shadow(LCD& lcd) : lcd(lcd) { fill(want, ' '); fill(shown, ' '); }
+
+    // Po lcd.init(): jednou opravdu smaže displej, od teď se ví, co na něm je
+    void begin() {
+      lcd.clear();
+      fill(want, ' ');
+      fill(shown, ' ');
+      rowDirty = 0;
+      cleared = false;
+      row = col = 0;
+      lcdRow = lcdCol = NOWHERE;
+    }
+
+    // --- stejné jako u LiquidCrystal_I2C, jen do paměti ---
+    void clear() {
+      for (uint8_t r = 0; r < ROWS; r++)
+        for (uint8_t c = 0; c < COLS; c++) put(r, c, ' ');
+      row = col = 0;
+      cleared = true;
+    }
+    void home() { row = col = 0; }
+    void setCursor(uint8_t c, uint8_t r) { col = c; row = r; }
+
+    size_t write(uint8_t ch) override {
+      if (row >= ROWS || col >= COLS) return 1;   // mimo displej: oříznout
+      put(row, col++, ch);
+      return 1;
+    }
+#ifdef ARDUINO
+    using Print::write;
+#endif
+
+    // Pošle na LCD nejvýš budget zápisů; vrací, kolik jich použil
+    uint8_t flush(uint8_t budget) {
+      uint8_t spent = 0;
+      if (cleared && rowDirty && budget >= CLEAR_COST && clearIsCheaper()) {
+        lcd.clear();                              // smaže displej a kurzor dá na 0,0
+        fill(shown, ' ');
+        rowDirty = 0;
+        for (uint8_t r = 0; r < ROWS; r++) if (!rowClean(r)) rowDirty |= 1 << r;
+        lcdRow = lcdCol = 0;
+        scanRow = scanCol = 0;
+        spent = CLEAR_COST;
+      }
+      cleared = false;
+      while (rowDirty && spent < budget) {
+        if (!(rowDirty & (1 << scanRow))) { nextRow(); continue; }
+        // další změněný znak v řádku
+        while (scanCol < COLS && want[scanRow][scanCol] == shown[scanRow][scanCol]) scanCol++;
+        if (scanCol >= COLS) {                    // konec řádku: čisté, nebo se mezitím změnilo něco vlevo?
+          if (rowClean(scanRow)) rowDirty &= ~(1 << scanRow);
+          nextRow();
+          continue;
+        }
+
+        if (lcdRow != scanRow || lcdCol != scanCol) {
+          if (budget - spent < 2) break;          // přesun bez znaku by byl zbytečný
+          lcd.setCursor(scanCol, scanRow);
+          lcdRow = scanRow; lcdCol = scanCol;
+          spent++;
+        }
+        uint8_t ch = want[scanRow][scanCol];
+        lcd.write(ch);
+        shown[scanRow][scanCol] = ch;
+        spent++;
+        scanCol++;
+        lcdCol = (scanCol < COLS) ? scanCol : NOWHERE;   // za koncem řádku LCD skáče jinam
+      }
+      return spent;
+    }
+
+    // Všechno hned (např. před delay())
+    void flushAll() { while (rowDirty) flush(255); }
+
+    bool pending() const { return rowDirty != 0; }
+
+    // Co bude na displeji po flush (pro kontrolu / testy)
+    char at(uint8_t c, uint8_t r) const { return (char)want[r][c]; }
+
+  private:
+    void put(uint8_t r, uint8_t c, uint8_t ch) {
+      want[r][c] = ch;
+      if (ch != shown[r][c]) rowDirty |= 1 << r;
+    }
+
+    // Zápisy potřebné pro změny (znaky + přesuny kurzoru) při dané „skutečnosti“
+    uint16_t cost(bool fromBlank) const {
+      uint16_t n = 0;
+      for (uint8_t r = 0; r < ROWS; r++) {
+        bool run = false;
+        for (uint8_t c = 0; c < COLS; c++) {
+          bool diff = want[r][c] != (fromBlank ? ' ' : shown[r][c]);
+          if (diff) n += run ? 1 : 2;
+          run = diff;
+        }
+      }
+      return n;
+    }
+
+    bool clearIsCheaper() const { return CLEAR_COST + cost(true) < cost(false); }
+
+    bool rowClean(uint8_t r) const {
+      for (uint8_t c = 0; c < COLS; c++)
+        if (want[r][c] != shown[r][c]) return false;
+      return true;
+    }
+
+    void nextRow() {
+      scanRow = (scanRow + 1) % ROWS;
+      scanCol = 0;
+    }
+
+    static void fill(uint8_t (&buf)[ROWS][COLS], uint8_t ch) {
+      for (uint8_t r = 0; r < ROWS; r++)
+        for (uint8_t c = 0; c < COLS; c++) buf[r][c] = ch;
+    }
+
+    LCD& lcd;
+    uint8_t want[ROWS][COLS];     // co má být vidět
+    uint8_t shown[ROWS][COLS];    // co LCD opravdu ukazuje
+    uint8_t rowDirty = 0;         // bit r = řádek r má rozdíly
+    bool cleared = false;         // od posledního flush() bylo clear()
+    uint8_t row = 0, col = 0;     // kurzor pro print()
+    uint8_t lcdRow = NOWHERE, lcdCol = NOWHERE;
+    uint8_t scanRow = 0, scanCol = 0;
+  };
+
+} // namespace MyLcd
+
+#endif // MY_LCD_H
@@ -0,0 +1,624 @@
+/************************************************************
+MyLog.h — výpisy, které nezdržují: binární záznam do bufferu, tisk později
+
+CO TO JE:
+- Serial.print() čeká, až se text vejde do bufferu UARTu (115200 Bd je
+  asi 87 µs na znak). Kdo tiskne s drženým mutexem, v HTTP handleru nebo
+  v callbacku ESP-NOW (ten běží v úloze Wi-Fi), zdrží tím i všechny, kdo
+  na něj čekají. A "text" + String(x) k tomu ještě alokuje na haldě.
+- MYLOG_I("SHOW %u: %s", n, jmeno) nic neformátuje. Uloží čas, ukazatel
+  na formátovací řetězec (ten leží ve flash a slouží jako ID formátu)
+  a až 8 argumentů do kruhového bufferu. Trvá to pár set ns, nic nečeká
+  a nic nealokuje.
+- Každé jádro má vlastní buffer, takže se jádra nikdy nečekají na sebe.
+  Na jednom jádře zápis chrání jen krátký zákaz přerušení (žádný mutex),
+  proto jde logovat i z přerušení.
+- Vypisovací úloha s nejnižší prioritou (tskIDLE_PRIORITY) bere záznamy
+  z obou bufferů podle času, formátuje je a posílá do UARTu. Čeká jen ona.
+- Plný buffer: nový záznam se zahodí a započítá, úloha pak vypíše
+  "[log] core 0: 12 events dropped".
+- Úroveň se filtruje už při překladu: s MYLOG_LEVEL=MYLOG_WARN se
+  MYLOG_I/MYLOG_D nepřeloží vůbec (ani se nepočítají jejich argumenty).
+- Režim BINARY posílá místo textu krátké rámce, každý formát jen jednou
+  (slovník). Na PC je zpátky na text převede
+  ESP32_IR_Remote_multithreading/tools/log_decode.cpp.
+
+POUŽITÍ:
+  #include <MyLog.h>           // úroveň: #define MYLOG_LEVEL MYLOG_DEBUG před include
+  setup():  Serial.begin(115200); MyLog::begin(Serial);    // ESP32: spustí vypisovací úlohu
+            (nebo MyLog::begin(Serial2, MyLog::BINARY))
+  kdekoli:  MYLOG_I("Rychlost %u ms, jas %u", speed, bright);
+            MYLOG_W("Odeslani selhalo: %d", err);
+  %s jen pro texty, které se nemění (konstanty, tabulky jmen) – tiskne se
+  až později! Text z proměnné zabal do MyLog::Text(buf) jako POSLEDNÍ
+  argument, ten se zkopíruje (max. 250 znaků; co se nevejde do záznamu, zabere
+  další záznamy v bufferu – 32 znaků na jeden).
+  Bez FreeRTOS (AVR): v loop() volej MyLog::drain(Serial).
+
+Úkoly:
+1) Co by vypsalo MYLOG_I("%s", String(x).c_str())? Proč?
+2) Nastav MYLOG_RING na 8 a pošli 20 záznamů hned za sebou. Co uvidíš?
+3) Proč stačí zakázat přerušení jen na svém jádře a není potřeba mutex?
+************************************************************/
+
+#ifndef MY_LOG_H
+#define MY_LOG_H
+
+#ifdef ARDUINO
+#include <Arduino.h>
+#else
+#include <stdint.h>   // překlad na PC (g++) bez Arduina
+#include <stddef.h>
+#include <chrono>
+#endif
+#include <stdio.h>
+#include <string.h>
+
+#define MYLOG_ERROR 1
+#define MYLOG_WARN  2
+#define MYLOG_INFO  3
+#define MYLOG_DEBUG 4
+
+#ifndef MYLOG_LEVEL
+#define MYLOG_LEVEL MYLOG_INFO
+#endif
+#ifndef MYLOG_RING
+#if defined(__AVR__)
+#define MYLOG_RING 8             // AVR: 48 B na záznam, RAM je málo
+#else
+#define MYLOG_RING 64            // záznamů na jádro (mocnina 2)
+#endif
+#endif
+
+#if MYLOG_LEVEL >= MYLOG_ERROR
+#define MYLOG_E(...) ::MyLog::log(MYLOG_ERROR, __VA_ARGS__)
+#else
+#define MYLOG_E(...) do {} while (0)
+#endif
+#if MYLOG_LEVEL >= MYLOG_WARN
+#define MYLOG_W(...) ::MyLog::log(MYLOG_WARN, __VA_ARGS__)
+#else
+#define MYLOG_W(...) do {} while (0)
+#endif
+#if MYLOG_LEVEL >= MYLOG_INFO
+#define MYLOG_I(...) ::MyLog::log(MYLOG_INFO, __VA_ARGS__)
+#else
+#define MYLOG_I(...) do {} while (0)
+#endif
+#if MYLOG_LEVEL >= MYLOG_DEBUG
+#define MYLOG_D(...) ::MyLog::log(MYLOG_DEBUG, __VA_ARGS__)
+#else
+#define MYLOG_D(...) do {} while (0)
+#endif
+
+namespace MyLog {
+
+  // Jeden argument: číslo do 32 bitů, float nebo ukazatel (na PC 64bitový)
+#if UINTPTR_MAX > 0xFFFFFFFFu
+  typedef uintptr_t Arg;
+#else
+  typedef uint32_t Arg;
+#endif
+
+  // Indexy bufferu: na AVR jeden bajt, aby se četly naráz
+#if defined(__AVR__)
+  typedef uint8_t Index;
+#else
+  typedef uint32_t Index;
+#endif
+
+  constexpr uint8_t  ARGS     = 8;       // MAC adresa (6) + další hodnoty
+  constexpr uint8_t  NO_TEXT  = 0xFF;
+  constexpr uint16_t RING     = MYLOG_RING;
+#if defined(__AVR__)
+  constexpr uint16_t LINE     = 96;
+  constexpr uint8_t  TEXT_MAX = 64;
+#else
+  constexpr uint16_t LINE     = 320;     // nejdelší vypsaný řádek
+  constexpr uint8_t  TEXT_MAX = 250;     // nejdelší MyLog::Text (= zpráva ESP-NOW) i %s v rámci BINARY
+#endif
+  constexpr uint8_t  DICT     = 32;      // formátů ve slovníku (BINARY)
+  constexpr uint32_t DICT_US  = 10000000UL;   // slovník se posílá znovu po 10 s (dekodér připojený později)
+  static_assert((RING & (RING - 1)) == 0, "MYLOG_RING musí být mocnina 2");
+#if defined(__AVR__)
+  static_assert(RING <= 128, "na AVR max. 128 záznamů");
+#endif
+
+#if defined(ESP32)
+  constexpr uint8_t CORES = portNUM_PROCESSORS;
+#elif defined(ARDUINO)
+  constexpr uint8_t CORES = 1;
+#else
+  constexpr uint8_t CORES = 2;           // PC: „jádro“ si vlákno nastaví přes hostCore()
+#endif
+
+  enum Mode : uint8_t { TEXT, BINARY };
+
+  // Rámec BINARY: SYNC, typ, délka, data, součet
+  constexpr uint8_t SYNC = 0xA5;
+  enum : uint8_t { FRAME_FORMAT = 'F', FRAME_EVENT = 'E', FRAME_LOST = 'L' };
+
+  struct Event {
+    uint32_t    t;                 // µs
+    const char* fmt;
+    uint8_t     level, n;
+    uint8_t     text, textLen;     // zkopírovaný text: od kterého argumentu, kolik znaků
+    uint8_t     more;              // kolik dalších záznamů v bufferu jsou jen pokračování textu
+    Arg         a[ARGS];
+  };
+  constexpr uint8_t CHUNK = sizeof(Arg) * ARGS;   // znaků textu v pokračovacím záznamu
+
+  struct Ring {
+    Event ev[RING];
+    Index head, tail;              // head píše jen jádro, tail jen vypisovací úloha
+    Index dropped;
+  };
+
+  // Text z proměnné: zkopíruje se do záznamu (musí být poslední argument).
+  // Co se nevejde za ostatní argumenty, zabere další záznamy v bufferu.
+  struct Text {
+    const char* s;
+    size_t len;
+    explicit Text(const char* s) : s(s), len(s ? strlen(s) : 0) {}
+    Text(const char* s, size_t len) : s(s), len(len) {}
+  };
+
+  namespace detail {
+
+    template<int I = 0> struct Global {
+      static Ring  rings[CORES];
+      static Mode  mode;
+      static Index reported[CORES];          // kolik ztrát už bylo vypsáno
+      static const char* dict[DICT];
+      static uint8_t  dictCount;
+      static uint32_t dictSince;
+#if defined(ESP32)
+      static Print* out;
+#endif
+    };
+    template<int I> Ring  Global<I>::rings[CORES];
+    template<int I> Mode  Global<I>::mode = TEXT;
+    template<int I> Index Global<I>::reported[CORES];
+    template<int I> const char* Global<I>::dict[DICT];
+    template<int I> uint8_t  Global<I>::dictCount = 0;
+    template<int I> uint32_t Global<I>::dictSince = 0;
+#if defined(ESP32)
+    template<int I> Print* Global<I>::out = nullptr;
+#endif
+    typedef Global<> G;
+
+    template<class T> inline T loadAcquire(const T& v) { return __atomic_load_n(&v, __ATOMIC_ACQUIRE); }
+    template<class T> inline void storeRelease(T& v, T x) { __atomic_store_n(&v, x, __ATOMIC_RELEASE); }
+
+#if !defined(ARDUINO)
+    inline uint8_t& hostCore() { static thread_local uint8_t c = 0; return c; }
+#endif
+
+    // Zápis na jednom jádře: zakázat přerušení jen tady (jiné jádro má svůj buffer)
+#if defined(ESP32)
+    struct Lock {
+      uint32_t s = portSET_INTERRUPT_MASK_FROM_ISR();   // jde i z přerušení
+      ~Lock() { portCLEAR_INTERRUPT_MASK_FROM_ISR(s); }
+    };
+    inline uint8_t core() { return (uint8_t)xPortGetCoreID(); }
+    inline uint32_t now() { return (uint32_t)micros(); }
+#elif defined(__AVR__)
+    struct Lock {
+      uint8_t s = SREG;
+      Lock() { cli(); }
+      ~Lock() { SREG = s; }
+    };
+    inline uint8_t core() { return 0; }
+    inline uint32_t now() { return micros(); }
+#elif defined(ARDUINO)
+    struct Lock {                                       // jiné desky: ne z přerušení
+      Lock() { noInterrupts(); }
+      ~Lock() { interrupts(); }
+    };
+    inline uint8_t core() { return 0; }
+    inline uint32_t now() { return micros(); }
+#else
+    struct Lock {};                                     // PC: jedno vlákno na „jádro“
+    inline uint8_t core() { return hostCore(); }
+    inline uint32_t now() {
+      using namespace std::chrono;
+      return (uint32_t)duration_cast<microseconds>(steady_clock::now().time_since_epoch()).count();
+    }
+#endif
+
+    // Argumenty → 32 bitů (se znaménkem se rozšíří zpátky při výpisu)
+    inline Arg pack(bool v)               { return v; }
+    inline Arg pack(char v)               { return (uint8_t)v; }
+    inline Arg pack(signed char v)        { return (uint32_t)(int32_t)v; }
+    inline Arg pack(unsigned char v)      { return v; }
+    inline Arg pack(short v)              { return (uint32_t)(int32_t)v; }
+    inline Arg pack(unsigned short v)     { return v; }
+    inline Arg pack(int v)                { return (uint32_t)(int32_t)v; }
+    inline Arg pack(unsigned v)           { return (uint32_t)v; }
+    inline Arg pack(long v)               { return (uint32_t)(int32_t)v; }
+    inline Arg pack(unsigned long v)      { return (uint32_t)v; }
+    inline Arg pack(long long v)          { return (uint32_t)(int32_t)v; }
+    inline Arg pack(unsigned long long v) { return (uint32_t)v; }
+    inline Arg pack(double v)             { float f = (float)v; uint32_t u; memcpy(&u, &f, 4); return u; }
+    inline Arg pack(const void* p)        { return (Arg)(uintptr_t)p; }
+
+    inline uint8_t firstChunk(const Event& e) { return (uint8_t)((ARGS - e.text) * sizeof(Arg)); }
+
+    // rest = část textu pro pokračovací záznamy
+    inline void put(Event&, const char*&) {}
+    template<class... R> inline void put(Event& e, const char*& rest, const Text& t, const R&...);
+    template<class T, class... R> inline void put(Event& e, const char*& rest, const T& v, const R&... more) {
+      if (e.n < ARGS) e.a[e.n++] = pack(v);
+      put(e, rest, more...);
+    }
+    template<class... R> inline void put(Event& e, const char*& rest, const Text& t, const R&...) {
+      if (e.n >= ARGS) return;
+      e.text = e.n++;
+      e.textLen = (uint8_t)(t.len < TEXT_MAX ? t.len : TEXT_MAX);
+      uint8_t first = firstChunk(e) < e.textLen ? firstChunk(e) : e.textLen;
+      if (first) memcpy(&e.a[e.text], t.s, first);
+      rest = t.s + first;
+      e.more = (uint8_t)((e.textLen - first + CHUNK - 1) / CHUNK);
+    }
+
+    inline void push(Event& e, const char* rest) {
+      Lock lock;
+      (void)lock;
+      Ring& r = G::rings[core()];
+      Index h = r.head;
+      if ((Index)(h - loadAcquire(r.tail)) + 1u + e.more > RING) { r.dropped++; return; }
+      e.t = now();
+      r.ev[h & (RING - 1)] = e;
+      uint8_t left = e.more ? e.textLen - firstChunk(e) : 0;
+      for (uint8_t k = 1; k <= e.more; k++, left -= CHUNK, rest += CHUNK)
+        memcpy(r.ev[(Index)(h + k) & (RING - 1)].a, rest, left < CHUNK ? left : CHUNK);
+      storeRelease(r.head, (Index)(h + 1 + e.more));
+    }
+
+    // Další konverze ve formátu: text před ní zkopíruje do out, do spec dá "%-08.3l" + znak.
+    // Vrací znak konverze, '%' pro "%%", 0 na konci.
+    inline char nextSpec(const char*& f, char* out, size_t size, size_t& len, char* spec) {
+      while (*f && *f != '%') {
+        if (out && len + 1 < size) out[len++] = *f;
+        f++;
+      }
+      if (!*f) return 0;
+      f++;
+      if (*f == '%') { f++; if (out && len + 1 < size) out[len++] = '%'; return '%'; }
+      uint8_t k = 0;
+      spec[k++] = '%';
+      while (*f && strchr("-+ #0123456789.", *f)) { if (k < 10) spec[k++] = *f; f++; }
+      while (*f && strchr("hlLjzt", *f)) f++;          // délku určuje MyLog
+      char c = *f;
+      if (!c) return 0;
+      f++;
+      if (strchr("diuoxX", c)) spec[k++] = 'l';
+      spec[k++] = c;
+      spec[k] = '\0';
+      return c;
+    }
+
+    // Které argumenty jsou %s (bit i)
+    inline uint8_t stringArgs(const char* f) {
+      uint8_t mask = 0, i = 0;
+      char spec[16];
+      size_t len = 0;
+      for (char c; (c = nextSpec(f, nullptr, 0, len, spec)) != 0;) {
+        if (c == '%') continue;
+        if (c == 's' && i < 8) mask |= 1 << i;
+        i++;
+      }
+      return mask;
+    }
+
+  } // namespace detail
+
+  // Záznam jako printf; str[i] = text pro %s v argumentu i
+  inline size_t format(char* out, size_t size, const char* f, const Arg* a, const char* const* str, uint8_t n) {
+    size_t len = 0;
+    uint8_t i = 0;
+    char spec[16];
+    for (char c; (c = detail::nextSpec(f, out, size, len, spec)) != 0;) {
+      if (c == '%') continue;
+      char* p = out + len;
+      size_t room = size - len;
+      int w;
+      if (i >= n) w = snprintf(p, room, "?");
+      else switch (c) {
+        case 'd': case 'i':          w = snprintf(p, room, spec, (long)(int32_t)(uint32_t)a[i]); break;
+        case 'u': case 'o':
+        case 'x': case 'X':          w = snprintf(p, room, spec, (unsigned long)(uint32_t)a[i]); break;
+        case 'c':                    w = snprintf(p, room, spec, (int)(uint8_t)a[i]); break;
+        case 's':                    w = snprintf(p, room, spec, str[i] ? str[i] : "(null)"); break;
+        case 'f': case 'e': case 'g': {
+          uint32_t u = (uint32_t)a[i];
+          float v;
+          memcpy(&v, &u, 4);
+          w = snprintf(p, room, spec, (double)v);
+          break;
+        }
+        default:                     w = snprintf(p, room, "0x%lx", (unsigned long)a[i]); break;
+      }
+      i++;
+      if (w > 0) len += ((size_t)w < room) ? (size_t)w : room - 1;
+    }
+    if (size) out[len < size ? len : size - 1] = '\0';
+    return len;
+  }
+
+  // Celý řádek: "[  12.345 0] W: text\r\n"
+  inline size_t render(char* out, size_t size, uint32_t t, uint8_t core, uint8_t level,
+                       const char* f, const Arg* a, const char* const* str, uint8_t n) {
+    static const char* const TAG[] = { "", "E: ", "W: ", "", "D: " };
+    int k = snprintf(out, size, "[%4lu.%03lu %u] %s", (unsigned long)(t / 1000000UL),
+                     (unsigned long)(t / 1000 % 1000), core, TAG[level <= MYLOG_DEBUG ? level : 0]);
+    size_t len = (k > 0 && (size_t)k < size) ? (size_t)k : 0;
+    len += format(out + len, size - len - 2, f, a, str, n);
+    out[len++] = '\r';
+    out[len++] = '\n';
+    return len;
+  }
+
+  // Zaznamenat (volají to makra MYLOG_E/W/I/D)
+  template<class... A>
+  inline void log(uint8_t level, const char* fmt, const A&... args) {
+    Event e;
+    e.fmt = fmt;
+    e.level = level;
+    e.n = 0;
+    e.text = NO_TEXT;
+    e.textLen = 0;
+    e.more = 0;
+    const char* rest = nullptr;
+    detail::put(e, rest, args...);
+    detail::push(e, rest);
+  }
+
+  inline void setMode(Mode m) { detail::G::mode = m; }
+
+  // Kolik záznamů se na jádře zahodilo (plný buffer)
+  inline Index dropped(uint8_t core) { return __atomic_load_n(&detail::G::rings[core].dropped, __ATOMIC_RELAXED); }
+
+  namespace detail {
+
+    template<class OUT> struct Frame {
+      OUT& out;
+      uint8_t buf[3 + 255 + 1];
+      uint16_t len = 3;
+      Frame(OUT& out, uint8_t type) : out(out) { buf[0] = SYNC; buf[1] = type; }
+      void u8(uint8_t v) { if (len < 3 + 255) buf[len++] = v; }
+      uint8_t room() const { return (uint8_t)(3 + 255 - len); }
+      void u32(uint32_t v) { for (uint8_t i = 0; i < 4; i++) u8(v >> (8 * i)); }
+      void bytes(const char* s, size_t n) { while (n--) u8((uint8_t)*s++); }
+      ~Frame() {
+        buf[2] = (uint8_t)(len - 3);
+        uint8_t sum = 0;
+        for (uint16_t i = 1; i < len; i++) sum += buf[i];
+        buf[len++] = (uint8_t)~sum;
+        out.write(buf, len);
+      }
+    };
+
+    // ID formátu ve slovníku; nový formát nejdřív pošle rámcem F
+    template<class OUT> uint8_t dictId(OUT& out, const char* fmt, uint32_t t) {
+      if (t - G::dictSince > DICT_US) {                 // starý: začít znovu (i u známých formátů)
+        G::dictCount = 0;
+        G::dictSince = t;
+      }
+      for (uint8_t i = 0; i < G::dictCount; i++)
+        if (G::dict[i] == fmt) return i;
+      if (G::dictCount == DICT) {                       // plný: začít znovu
+        G::dictCount = 0;
+        G::dictSince = t;
+      }
+      uint8_t id = G::dictCount++;
+      G::dict[id] = fmt;
+      Frame<OUT> f(out, FRAME_FORMAT);
+      f.u8(id);
+      size_t n = strlen(fmt);
+      f.bytes(fmt, n < 250 ? n : 250);
+      return id;
+    }
+
+    // text = poskládaný MyLog::Text záznamu (nebo nullptr)
+    template<class OUT> void emit(OUT& out, const Event& e, uint8_t core, const char* text) {
+      const char* str[ARGS];
+      for (uint8_t i = 0; i < e.n; i++)
+        str[i] = (i == e.text) ? text : (const char*)(uintptr_t)e.a[i];
+      if (G::mode == TEXT) {
+        char line[LINE];
+        size_t len = render(line, sizeof(line), e.t, core, e.level, e.fmt, e.a, str, e.n);
+        out.write((const uint8_t*)line, len);
+        return;
+      }
+      uint8_t id = dictId(out, e.fmt, e.t);
+      uint8_t strings = stringArgs(e.fmt);
+      Frame<OUT> f(out, FRAME_EVENT);
+      f.u8(id);
+      f.u8((e.level << 4) | core);
+      f.u8(e.n);
+      f.u32(e.t);
+      for (uint8_t i = 0; i < e.n; i++) {
+        if (strings & (1 << i)) {
+          const char* s = str[i] ? str[i] : "(null)";
+          size_t n = strlen(s);
+          uint8_t reserve = 1;                                // délka + místo pro další argumenty
+          for (uint8_t j = i + 1; j < e.n; j++) reserve += (strings & (1 << j)) ? 1 : 4;
+          uint8_t fits = f.room() > reserve ? f.room() - reserve : 0;
+          if (n > TEXT_MAX) n = TEXT_MAX;
+          if (n > fits) n = fits;
+          f.u8((uint8_t)n);
+          f.bytes(s, n);
+        } else {
+          f.u32((uint32_t)e.a[i]);
+        }
+      }
+    }
+
+    template<class OUT> void reportDropped(OUT& out) {
+      for (uint8_t c = 0; c < CORES; c++) {
+        Index d = dropped(c);
+        Index lost = d - G::reported[c];
+        if (!lost) continue;
+        G::reported[c] = d;
+        if (G::mode == BINARY) {
+          Frame<OUT> f(out, FRAME_LOST);
+          f.u8(c);
+          f.u32(lost);
+        } else {
+          char line[48];
+          int n = snprintf(line, sizeof(line), "[log] core %u: %lu events dropped\r\n", c, (unsigned long)lost);
+          if (n > 0) out.write((const uint8_t*)line, (size_t)n);
+        }
+      }
+    }
+
+  } // namespace detail
+
+  // Vypíše nejvýš max záznamů (nejstarší první); vrací kolik. Volá jen jedna úloha.
+  // OUT = cokoli s write(const uint8_t*, size_t), typicky Serial
+  template<class OUT> uint16_t drain(OUT& out, uint16_t max = 0xFFFF) {
+    using namespace detail;
+    reportDropped(out);
+    uint16_t done = 0;
+    while (done < max) {
+      int8_t best = -1;
+      uint32_t bestT = 0;
+      for (uint8_t c = 0; c < CORES; c++) {
+        Ring& r = G::rings[c];
+        if (loadAcquire(r.head) == r.tail) continue;
+        uint32_t t = r.ev[r.tail & (RING - 1)].t;
+        if (best < 0 || (int32_t)(t - bestT) < 0) { best = c; bestT = t; }
+      }
+      if (best < 0) break;
+      Ring& r = G::rings[best];
+      Index tail = r.tail;
+      Event e = r.ev[tail & (RING - 1)];
+      char text[TEXT_MAX + 1];
+      if (e.text != NO_TEXT) {                       // text: začátek v záznamu, zbytek v pokračováních
+        uint8_t len = firstChunk(e) < e.textLen ? firstChunk(e) : e.textLen;
+        memcpy(text, &e.a[e.text], len);
+        for (uint8_t k = 1; k <= e.more; k++) {
+          uint8_t n = (e.textLen - len < CHUNK) ? e.textLen - len : CHUNK;
+          memcpy(text + len, r.ev[(Index)(tail + k) & (RING - 1)].a, n);
+          len += n;
+        }
+        text[len] = '\0';
+      }
+      storeRelease(r.tail, (Index)(tail + 1 + e.more));
+      emit(out, e, (uint8_t)best, text);
+      done++;
+    }
+    return done;
+  }
+
+#if defined(ESP32)
+  namespace detail {
+    inline void task(void*) {
+      for (;;) {
+        if (!drain(*G::out, 16)) vTaskDelay(pdMS_TO_TICKS(10));
+      }
+    }
+  } // namespace detail
+
+  // Spustí vypisovací úlohu (bez přiřazení k jádru, nejnižší priorita); znovu = jiný výstup/režim
+  inline void begin(Print& out, Mode mode = TEXT, UBaseType_t priority = tskIDLE_PRIORITY) {
+    bool running = detail::G::out != nullptr;
+    detail::G::out = &out;
+    detail::G::mode = mode;
+    if (!running) xTaskCreate(detail::task, "log", 4096, nullptr, priority, nullptr);
+  }
+#endif
+
+  // Převod rámců BINARY zpátky na text (tools/log_decode.cpp). Bajty mimo rámce
+  // (obyčejné Serial.print) projdou beze změny.
+  class Decoder {
+  public:
+    uint32_t badFrames = 0;
+
+    // OUT = cokoli s write(const uint8_t*, size_t)
+    template<class OUT> void feed(uint8_t b, OUT& out) {
+      if (pos == 0) {
+        if (b == SYNC) buf[pos++] = b;
+        else out.write(&b, 1);
+        return;
+      }
+      buf[pos++] = b;
+      if (pos == 2 && b != FRAME_FORMAT && b != FRAME_EVENT && b != FRAME_LOST) { reject(out, false); return; }
+      if (pos < 3 || pos < 3 + buf[2] + 1) return;
+      uint8_t sum = 0;
+      for (uint16_t i = 1; i < pos - 1; i++) sum += buf[i];
+      if ((uint8_t)~sum != buf[pos - 1]) { reject(out, true); return; }
+      handle(out, buf[1], buf + 3, buf[2]);
+      pos = 0;
+    }
+
+  private:
+    // Nebyl to rámec (jen bajt 0xA5 v textu) nebo byl poškozený: poslat dál jako text
+    template<class OUT> void reject(OUT& out, bool damaged) {
+      if (damaged) badFrames++;
+      out.write(buf, pos);
+      pos = 0;
+    }
+
+    static uint32_t le32(const uint8_t* p) { return p[0] | (p[1] << 8) | (p[2] << 16) | ((uint32_t)p[3] << 24); }
+
+    template<class OUT> void handle(OUT& out, uint8_t type, const uint8_t* p, uint8_t n) {
+      char line[LINE];
+      if (type == FRAME_FORMAT) {
+        if (n < 1 || p[0] >= DICT) return;
+        uint8_t len = (n - 1 < 250) ? n - 1 : 250;
+        memcpy(fmts[p[0]], p + 1, len);
+        fmts[p[0]][len] = '\0';
+        known[p[0]] = true;
+        return;
+      }
+      if (type == FRAME_LOST) {
+        if (n < 5) return;
+        int k = snprintf(line, sizeof(line), "[log] core %u: %lu events dropped\r\n", p[0], (unsigned long)le32(p + 1));
+        if (k > 0) out.write((const uint8_t*)line, (size_t)k);
+        return;
+      }
+      if (n < 7) return;
+      uint8_t id = p[0], level = p[1] >> 4, core = p[1] & 15, count = p[2];
+      uint32_t t = le32(p + 3);
+      if (id >= DICT || !known[id]) {
+        int k = snprintf(line, sizeof(line), "[%4lu.%03lu %u] (format #%u not received yet)\r\n",
+                         (unsigned long)(t / 1000000UL), (unsigned long)(t / 1000 % 1000), core, id);
+        if (k > 0) out.write((const uint8_t*)line, (size_t)k);
+        return;
+      }
+      Arg a[ARGS] = {};
+      const char* str[ARGS] = {};
+      char text[ARGS][TEXT_MAX + 1];
+      uint8_t strings = detail::stringArgs(fmts[id]);
+      uint16_t at = 7;
+      if (count > ARGS) count = ARGS;
+      for (uint8_t i = 0; i < count; i++) {
+        if (strings & (1 << i)) {
+          if (at >= n) return;
+          uint8_t len = p[at++];
+          if (at + len > n) return;
+          memcpy(text[i], p + at, len);
+          text[i][len] = '\0';
+          str[i] = text[i];
+          at += len;
+        } else {
+          if (at + 4 > n) return;
+          a[i] = le32(p + at);
+          at += 4;
+        }
+      }
+      size_t len = render(line, sizeof(line), t, core, level, fmts[id], a, str, count);
+      out.write((const uint8_t*)line, len);
+    }
+
+    uint8_t  buf[3 + 255 + 1];
+    uint16_t pos = 0;
+    char     fmts[DICT][251];
+    bool     known[DICT] = {};
+  };
+
+} // namespace MyLog
+
+#endif // MY_LOG_H
@@ -0,0 +1,321 @@
+/************************************************************
+MyMorse.h — Morseovka bez delay(): vysílač s frontou a dekodér klíče
+
+CO TO JE:
+- Každý znak je v tabulce jako jeden bajt: zleva úvodní 1 (zarážka),
+  za ní tečka = 0, čárka = 1. Např. A ".-" = 0b101. Tabulku z čitelných
+  řetězců spočítá překladač (constexpr), na AVR leží ve flash.
+- Sender: text jde do fronty (64 znaků), update(millis()) jen řekne,
+  jestli má LED svítit. Časy běží od plánovaných okamžiků, ne od
+  volání update(), takže se chyby nesčítají.
+- Rychlost ve WPM (slovo PARIS = 50 teček): tečka = 1200 / WPM ms.
+  Farnsworth: znaky rychle (třeba 20 WPM), mezery mezi znaky a slovy
+  natažené tak, aby celkem vyšlo pomalejší tempo (třeba 10 WPM).
+- Receiver: update(millis(), stisknuto) z tlačítka nebo světelného
+  čidla. Odfiltruje zákmity, pozná tečku/čárku a mezery a sám si
+  dolaďuje délku tečky (pozná i rychlejšího nebo pomalejšího vysílače)
+  i délku mezer (Farnsworth).
+
+POUŽITÍ:
+  MyMorse::Sender tx;     tx.setSpeed(20);        // nebo setSpeed(20, 10) = Farnsworth
+  tx.send("SOS");         digitalWrite(LED_PIN, tx.update(millis()));   // v každém loop()
+  MyMorse::Receiver rx;   rx.setSpeed(20);        // jen první odhad, pak se přizpůsobí
+  rx.update(millis(), digitalRead(KEY_PIN) == LOW);
+  while (rx.available()) Serial.print(rx.read());
+
+Úkoly:
+1) Jak by v tabulce vypadal bajt pro písmeno K (-.-)?
+2) Proč má Sender frontu a nevysílá rovnou z řetězce?
+3) Vyťukej tlačítkem pomalu a pak rychle. Jak se změní rx.wpm()?
+************************************************************/
+
+#ifndef MY_MORSE_H
+#define MY_MORSE_H
+
+#ifdef ARDUINO
+#include <Arduino.h>
+#else
+#include <stdint.h>   // překlad na PC (g++) bez Arduina
+#endif
+
+#if defined(__AVR__)
+#include <avr/pgmspace.h>
+#define MYMORSE_ROM        PROGMEM
+#define MYMORSE_READ8(p)   pgm_read_byte(p)
+#else
+#define MYMORSE_ROM
+#define MYMORSE_READ8(p)   (*(p))
+#endif
+
+namespace MyMorse {
+
+  constexpr char    FIRST     = ' ';      // tabulka pokrývá ASCII ' ' .. 'Z'
+  constexpr char    LAST      = 'Z';
+  constexpr uint8_t MAX_MARKS = 7;        // nejdelší znak ($) má 7 značek
+  constexpr uint8_t QUEUE     = 64;       // fronta vysílače i dekodéru
+  constexpr char    UNKNOWN   = '#';      // dekodér: značky, které nejsou znak (# nemá kód)
+
+  namespace detail {
+    // ".-" → 0b101 při překladu
+    constexpr uint8_t pack(const char* s, uint8_t acc = 1) {
+      return *s ? pack(s + 1, (uint8_t)((acc << 1) | (*s == '-'))) : acc;
+    }
+
+    constexpr uint8_t CODES[LAST - FIRST + 1] MYMORSE_ROM = {
+      0,              pack("-.-.--"), pack(".-..-."), 0,              // ' ' ! " #
+      pack("...-..-"), 0,             pack(".-..."),  pack(".----."), // $ % & '
+      pack("-.--."),  pack("-.--.-"), 0,              pack(".-.-."),  // ( ) * +
+      pack("--..--"), pack("-....-"), pack(".-.-.-"), pack("-..-."),  // , - . /
+      pack("-----"),  pack(".----"),  pack("..---"),  pack("...--"),  // 0 1 2 3
+      pack("....-"),  pack("....."),  pack("-...."),  pack("--..."),  // 4 5 6 7
+      pack("---.."),  pack("----."),  pack("---..."), pack("-.-.-."), // 8 9 : ;
+      0,              pack("-...-"),  0,              pack("..--.."), // < = > ?
+      pack(".--.-."), pack(".-"),     pack("-..."),   pack("-.-."),   // @ A B C
+      pack("-.."),    pack("."),      pack("..-."),   pack("--."),    // D E F G
+      pack("...."),   pack(".."),     pack(".---"),   pack("-.-"),    // H I J K
+      pack(".-.."),   pack("--"),     pack("-."),     pack("---"),    // L M N O
+      pack(".--."),   pack("--.-"),   pack(".-."),    pack("..."),    // P Q R S
+      pack("-"),      pack("..-"),    pack("...-"),   pack(".--"),    // T U V W
+      pack("-..-"),   pack("-.--"),   pack("--..")                    // X Y Z
+    };
+
+    // Počet značek = pozice zarážky
+    inline uint8_t length(uint8_t code) {
+      uint8_t n = 0;
+      while (code > 1) { code >>= 1; n++; }
+      return n;
+    }
+
+    // Posledních 8 délek (značek nebo mezer). Bývají mezi nimi dva druhy
+    // (tečka/čárka, mezera znaku/slova) – práh pak leží v půlce mezi nejkratší
+    // a nejdelší. Vrací 0, když jsou všechny podobné (poměr pod ratio4 / 4).
+    struct Recent {
+      uint16_t v[8] = {};
+      uint8_t at = 0, count = 0;
+      void push(uint32_t d) {
+        v[at] = d > 0xFFFF ? 0xFFFF : (uint16_t)d;
+        at = (at + 1) % 8;
+        if (count < 8) count++;
+      }
+      uint32_t split(uint8_t ratio4) const {
+        uint16_t mn = 0xFFFF, mx = 0;
+        for (uint8_t i = 0; i < count; i++) {
+          if (v[i] < mn) mn = v[i];
+          if (v[i] > mx) mx = v[i];
+        }
+        return (count > 1 && 4UL * mx >= (uint32_t)ratio4 * mn) ? ((uint32_t)mn + mx) / 2 : 0;
+      }
+    };
+
+    // Jednoduchá kruhová fronta znaků
+    struct CharQueue {
+      char buf[QUEUE];
+      uint8_t head = 0, count = 0;
+      bool push(char c) {
+        if (count >= QUEUE) return false;
+        buf[(head + count) % QUEUE] = c;
+        count++;
+        return true;
+      }
+      char pop() {
+        char c = buf[head];
+        head = (head + 1) % QUEUE;
+        count--;
+        return c;
+      }
+    };
+  } // namespace detail
+
+  // Kód znaku (0 = Morseovka ho nemá); malá písmena jako velká
+  inline uint8_t encode(char c) {
+    if (c >= 'a' && c <= 'z') c -= 'a' - 'A';
+    if (c < FIRST || c > LAST) return 0;
+    return MYMORSE_READ8(&detail::CODES[c - FIRST]);
+  }
+
+  // Znak podle kódu (UNKNOWN, když takový není)
+  inline char decode(uint8_t code) {
+    for (char c = FIRST + 1; c <= LAST; c++)
+      if (MYMORSE_READ8(&detail::CODES[c - FIRST]) == code) return c;
+    return UNKNOWN;
+  }
+
+  // Délky v ms
+  struct Timing { uint16_t dot, dash, symbolGap, letterGap, wordGap; };
+
+  // wpm = rychlost znaků; effWpm < wpm = Farnsworth (delší mezery mezi znaky a slovy)
+  inline Timing timing(uint8_t wpm, uint8_t effWpm = 0) {
+    if (wpm < 1) wpm = 1;
+    uint16_t dot = 1200 / wpm;
+    Timing t = { dot, (uint16_t)(3 * dot), dot, (uint16_t)(3 * dot), (uint16_t)(7 * dot) };
+    if (effWpm > 0 && effWpm < wpm) {
+      // ARRL: 19 jednotek mezer ve slově PARIS dostane celkem ta ms
+      uint32_t ta = (60000UL * wpm - 37200UL * effWpm) / ((uint32_t)effWpm * wpm);
+      t.letterGap = (uint16_t)(3 * ta / 19);
+      t.wordGap   = (uint16_t)(7 * ta / 19);
+    }
+    return t;
+  }
+
+  class Sender {
+  public:
+    Sender() { setSpeed(20); }
+
+    void setSpeed(uint8_t wpm, uint8_t effWpm = 0) { t = timing(wpm, effWpm); }
+    const Timing& getTiming() const { return t; }
+
+    // Do fronty; false = plná (zkus to v dalším loop())
+    bool push(char c) { return queue.push(c); }
+    // Kolik znaků se vešlo
+    uint8_t send(const char* s) {
+      uint8_t n = 0;
+      while (*s && push(*s++)) n++;
+      return n;
+    }
+    uint8_t space() const { return QUEUE - queue.count; }
+    bool busy() const { return state != IDLE || queue.count > 0; }
+    void clear() { queue.count = 0; state = IDLE; key = false; }
+
+    // Každý loop(): true = klíč stisknutý (LED svítí)
+    bool update(uint32_t nowMs) {
+      if (state == IDLE) {
+        if (queue.count == 0) return false;
+        nextAt = nowMs;              // začni teď, dál se jede podle plánu
+        state = GAP;
+      }
+      while (state != IDLE && (int32_t)(nowMs - nextAt) >= 0) advance();
+      return key;
+    }
+
+  private:
+    enum : uint8_t { IDLE, MARK, SYMBOL_GAP, GAP };
+
+    // Jeden krok automatu v okamžiku nextAt
+    void advance() {
+      switch (state) {
+        case MARK:                   // konec tečky/čárky
+          key = false;
+          if (left > 0) { nextAt += t.symbolGap; state = SYMBOL_GAP; }
+          else          { nextAt += t.letterGap; state = GAP; }
+          break;
+        case SYMBOL_GAP:
+          startMark();
+          break;
+        default:                     // GAP: mezera mezi znaky doběhla, vezmi další
+          while (queue.count > 0) {
+            char c = queue.pop();
+            if (c == ' ' || c == '\n') { nextAt += t.wordGap - t.letterGap; return; }
+            uint8_t code = encode(c);
+            if (code > 1) { pattern = code; left = detail::length(code); startMark(); return; }
+          }
+          state = IDLE;
+          break;
+      }
+    }
+
+    void startMark() {
+      left--;
+      bool dash = (pattern >> left) & 1;
+      key = true;
+      nextAt += dash ? t.dash : t.dot;
+      state = MARK;
+    }
+
+    Timing t;
+    detail::CharQueue queue;
+    uint8_t state = IDLE, pattern = 0, left = 0;
+    bool key = false;
+    uint32_t nextAt = 0;
+  };
+
+  class Receiver {
+  public:
+    Receiver() { setSpeed(20); }
+
+    // Jen počáteční odhad, dál se délka tečky dolaďuje sama
+    void setSpeed(uint8_t wpm) { unit = 1200 / (wpm ? wpm : 1); letterGap = 3 * unit; }
+    uint16_t unitMs() const { return unit; }
+    uint8_t  wpm() const { return (uint8_t)(1200 / unit); }
+
+    // Každý loop(): okamžitý stav klíče (tlačítko stisknuté / světlo svítí)
+    void update(uint32_t nowMs, bool down) {
+      if (down != level) {
+        // Změna platí, až vydrží glitch ms; hrana se pak počítá od první změny
+        if (!pending) { pending = true; pendingAt = nowMs; }
+        else if (nowMs - pendingAt >= glitchMs()) {
+          edge(pendingAt - lastEdge);
+          level = down;
+          lastEdge = pendingAt;
+          pending = false;
+        }
+      } else {
+        pending = false;
+      }
+      if (!level) checkGap(nowMs - lastEdge);
+    }
+
+    uint8_t available() const { return out.count; }
+    char read() { return out.count ? out.pop() : 0; }
+
+  private:
+    uint16_t glitchMs() const { return unit / 4 > 2 ? unit / 4 : 2; }
+
+    // Konec úseku: level říká, co právě skončilo (true = značka)
+    void edge(uint32_t dur) {
+      if (!level) {                                   // skončila mezera
+        if (dur < 2UL * unit) { if (marks > 0) learn(dur); return; }   // uvnitř znaku = 1 tečka
+        // Mezi znaky nebo slovy; Farnsworth má obě delší než 3 a 7 teček
+        bool isWord = dur >= wordGapMs();
+        gaps.push(dur);
+        uint32_t g = isWord ? dur * 3 / 7 : dur;
+        if (g > 20UL * unit) g = 20UL * unit;
+        letterGap = (uint16_t)((3UL * letterGap + g + 2) / 4);
+        return;
+      }
+      // Tečka nebo čárka; když jsou poslední značky stejné, podle odhadu tečky
+      markLens.push(dur);
+      uint32_t threshold = markLens.split(8);
+      bool dash = dur >= (threshold ? threshold : 2UL * unit);
+      learn(dash ? dur / 3 : dur);
+      if (marks < MAX_MARKS) pattern = (uint8_t)((pattern << 1) | dash);
+      else overflow = true;
+      marks++;
+      word = false;
+    }
+
+    // Mezera slova je 7/3 mezery znaku; bez obou druhů v historii práh 5/3 mezery znaku
+    uint32_t wordGapMs() const {
+      uint32_t threshold = gaps.split(6);
+      if (threshold) return threshold;
+      uint32_t g = letterGap < 3 * unit ? 3 * unit : letterGap;
+      return g * 5 / 3;
+    }
+
+    // Klíč je puštěný dur ms: konec znaku po 2 tečkách, konec slova podle wordGapMs()
+    void checkGap(uint32_t dur) {
+      if (marks > 0 && dur >= 2UL * unit) {
+        out.push(overflow ? UNKNOWN : decode(pattern));
+        pattern = 1; marks = 0; overflow = false;
+        word = true;
+      }
+      if (word && dur >= wordGapMs()) { out.push(' '); word = false; }
+    }
+
+    void learn(uint32_t dotMs) {
+      if (dotMs > 2000) dotMs = 2000;
+      unit = (uint16_t)((3UL * unit + dotMs + 2) / 4);
+      if (unit < 4) unit = 4;
+    }
+
+    uint16_t unit = 60;
+    uint16_t letterGap = 180;   // naměřená mezera mezi znaky (ms)
+    bool level = false, pending = false, word = false, overflow = false;
+    uint32_t pendingAt = 0, lastEdge = 0;
+    uint8_t pattern = 1, marks = 0;
+    detail::Recent markLens, gaps;
+    detail::CharQueue out;
+  };
+
+} // namespace MyMorse
+
+#endif // MY_MORSE_H
@@ -0,0 +1,316 @@
+/************************************************************
+MyPower.h — úspora energie, když se na pásku nic neděje
+
+CO TO JE:
+- Pásek LED svítí pořád stejně (vypnutá show, jedna barva, ticho u VU
+  metru), a procesor ho přesto 100× za sekundu počítá a posílá znovu.
+  Odeslání 60 LED trvá ~2 ms a procesor běží na 240 MHz.
+- Policy pozná, že se výstup nemění: každý snímek dostane otisk
+  (digest, FNV-1a přes bajty pixelů). Stejný otisk = snímek se neposílá.
+  Po staticFrames stejných snímcích za sebou přejde do stavu STATIC.
+- Stavy:
+    ACTIVE – show se hýbe: počítá se každý krok, plný takt
+    STATIC – výstup stojí: snímek se jen občas „zkusí“ (staticProbeMs),
+             jestli se nezačal měnit; nižší takt procesoru
+    SLEEP  – stojí a sleepAfterMs nikdo nic nezmáčkl: zkouší se ještě
+             méně (sleepProbeMs) a ESP32 mezitím může spát (lehký spánek)
+- Každý vstup (tlačítko, IR, HTTP požadavek) volá activity() = hned ACTIVE.
+  Změněný snímek = hned ACTIVE.
+- Policy je čistá logika bez hardwaru: jde přeložit a vyzkoušet na PC.
+- Governor (jen ESP32) podle stavu mění takt (240/80 MHz) a umí lehký
+  spánek s probuzením hranou na pinech (IR přijímač, enkodér) nebo časem.
+  80 MHz je nejníž, kde běží Wi-Fi a nemění se takt periferií (UART, RMT).
+- CurrentLimit hlídá proud pásku: 60 LED bíle naplno je ~3,6 A a slabší
+  zdroj (nebo USB) při tom stáhne napětí – ESP32 se resetuje (brownout).
+  Odhad = klidový proud LED + součet bajtů kanálů × mA kanálu naplno;
+  součty sečte výstupní průchod (MyShows/MyOutput.h), tady je jen pár
+  násobení na snímek. Když snímek přesáhne rozpočet (budgetMa), jas se
+  hned sníží a snímek se přepočítá – ven nejde nikdy víc než rozpočet.
+  Pod tím omezovač plynule míří na softPercent rozpočtu: dolů rychle
+  (attackMs), zpátky pomalu (releaseMs), aby jas „nepumpoval“.
+
+POUŽITÍ:
+  MyPower::Policy power;
+  MyPower::Governor governor;             // jen ESP32
+  setup():  power.begin(millis()); governor.wakeOn(IR_PIN);
+  vstup:    power.activity(millis());
+  krok:     if (millis() - last >= power.frameInterval(stepMs)) {
+              ... spočítat snímek do pásku ...
+              if (power.frame(MyPower::digest(strip.getPixels(), 3 * N), millis()))
+                strip.show();             // jen když se změnil
+            }
+  potom:    MyPower::State s = power.update(millis());
+            governor.apply(s);
+            if (s == MyPower::SLEEP && governor.lightSleep(ms)) power.activity(millis());
+  výpis:    power.ms(MyPower::STATIC, millis()) = čas strávený ve stavu
+
+  Když pásek přepíše něco jiného (clear + show mimo krok), zavolej
+  power.resend() – další snímek se pošle, i kdyby měl stejný otisk.
+
+  Proud (s MyShows::Output):
+    MyPower::CurrentLimit current;       // current.budgetMa = 2000;
+    output.write(frame, strip.getPixels(), N);
+    while (!current.check(output.sum(), N, millis())) {   // přes rozpočet
+      output.limit(current.limit());
+      output.write(frame, strip.getPixels(), N);
+    }
+    output.limit(current.limit());       // pro další snímek
+    výpis: current.lastMa(), current.events(), current.headroomMa()
+
+Úkoly:
+1) Proč se porovnává otisk a ne celé pole pixelů? Kolik by stála kopie?
+2) Show „Dýchání“ má nahoře pár stejných snímků za sebou. Co by se
+   stalo se staticFrames = 3?
+3) Proč první stisk IR ovladače po lehkém spánku většinou „propadne“?
+4) Změř proud pásku multimetrem při bílé a při červené a uprav channelMa.
+   O kolik se liší od odhadu v /status?
+************************************************************/
+
+#ifndef MY_POWER_H
+#define MY_POWER_H
+
+#ifdef ARDUINO
+#include <Arduino.h>
+#else
+#include <stdint.h>    // překlad na PC (g++) bez Arduina
+#include <stddef.h>
+#endif
+
+#if defined(ESP32)
+#include <esp_sleep.h>
+#include <driver/gpio.h>
+#endif
+
+namespace MyPower {
+
+  enum State : uint8_t { ACTIVE, STATIC, SLEEP, STATE_COUNT };
+
+  inline const char* name(State s) {
+    static const char* const NAMES[STATE_COUNT] = { "active", "static", "sleep" };
+    return s < STATE_COUNT ? NAMES[s] : "?";
+  }
+
+  // FNV-1a: otisk snímku, ~1 cyklus/bajt (180 B pro 60 LED)
+  inline uint32_t digest(const uint8_t* p, size_t n) {
+    uint32_t h = 2166136261UL;
+    while (n--) { h ^= *p++; h *= 16777619UL; }
+    return h;
+  }
+
+  class Policy {
+  public:
+    uint8_t  staticFrames  = 25;     // tolik stejných snímků za sebou = výstup stojí
+    uint32_t sleepAfterMs  = 5000;   // STATIC bez vstupu tak dlouho = SLEEP
+    uint16_t staticProbeMs = 250;    // ve STATIC se snímek počítá jednou za...
+    uint16_t sleepProbeMs  = 1000;   // ...a ve SLEEP
+    bool outputOff = false;          // nic se nekreslí (show vypnutá): rovnou STATIC
+    bool keepAwake = false;          // něco musí běžet (zvuk přes DMA): nejvýš STATIC
+
+    void begin(uint32_t now) {
+      st = ACTIVE;
+      since = now;
+      for (uint8_t i = 0; i < STATE_COUNT; i++) total[i] = 0;
+      same = 0;
+      sent = false;
+    }
+
+    // Nový snímek s otiskem d; true = změnil se, poslat na pásek
+    bool frame(uint32_t d, uint32_t now) {
+      if (!sent || d != last) {
+        sent = true;
+        last = d;
+        same = 0;
+        if (st != ACTIVE) enter(ACTIVE, now);
+        return true;
+      }
+      if (same < 255) same++;
+      if (st == ACTIVE && same >= staticFrames) enter(STATIC, now);
+      return false;
+    }
+
+    // Vstup od uživatele: plná rychlost, odpočet do spánku znovu
+    void activity(uint32_t now) {
+      same = 0;
+      if (st != ACTIVE) enter(ACTIVE, now);
+      else sinceInput = now;
+    }
+
+    // Pásek přepsal někdo jiný: další snímek poslat vždy
+    void resend() { sent = false; }
+
+    // Přechody podle času; volat po každém kroku
+    State update(uint32_t now) {
+      if (st == ACTIVE && outputOff) enter(STATIC, now);
+      if (st == STATIC && !keepAwake && now - sinceInput >= sleepAfterMs) enter(SLEEP, now);
+      if (st == SLEEP && keepAwake) enter(STATIC, now);
+      return st;
+    }
+
+    State state() const { return st; }
+
+    // Za jak dlouho spočítat další snímek, když show chce krok stepMs
+    uint32_t frameInterval(uint32_t stepMs) const {
+      uint32_t probe = (st == ACTIVE) ? 0 : (st == STATIC) ? staticProbeMs : sleepProbeMs;
+      return stepMs > probe ? stepMs : probe;
+    }
+
+    // Milisekundy strávené ve stavu s (včetně právě běžícího)
+    uint32_t ms(State s, uint32_t now) const {
+      return total[s] + (s == st ? now - since : 0);
+    }
+
+  private:
+    void enter(State s, uint32_t now) {
+      total[st] += now - since;
+      st = s;
+      since = sinceInput = now;
+    }
+
+    State st = ACTIVE;
+    uint32_t since = 0;          // kdy začal současný stav
+    uint32_t sinceInput = 0;     // kdy začal, nebo přišel poslední vstup
+    uint32_t total[STATE_COUNT] = { 0, 0, 0 };
+    uint32_t last = 0;           // otisk posledního odeslaného snímku
+    uint8_t same = 0;            // kolik snímků za sebou se mu rovnalo
+    bool sent = false;           // last platí (pásek ho opravdu ukazuje)
+  };
+
+  // Odhad proudu pásku ze součtů kanálů a omezení jasu na rozpočet zdroje
+  class CurrentLimit {
+  public:
+    uint16_t budgetMa    = 0;              // zdroj pro pásek; 0 = jen měřit
+    uint8_t  softPercent = 90;             // plynulé omezení míří sem, budgetMa je tvrdá hranice
+    uint16_t channelMa[3] = { 20, 20, 20 }; // 1 LED, kanál R, G, B naplno (WS2812B: 12–20 mA)
+    uint16_t idleUa      = 1000;           // 1 zhasnutá LED v µA (WS2812B ~0,6–1 mA)
+    uint16_t attackMs    = 60;             // omezení z 255 na 0 nejvýš za tolik ms
+    uint16_t releaseMs   = 2000;           // a zpátky na 255
+
+    // Proud v mA pro součty bajtů R, G, B n LED (po jasu a gamě)
+    uint32_t estimate(const uint32_t* sum, uint16_t n) const {
+      uint64_t ua = (uint64_t)n * idleUa;
+      for (uint8_t c = 0; c < 3; c++) ua += (uint64_t)sum[c] * channelMa[c] * 1000 / 255;
+      return (uint32_t)(ua / 1000);
+    }
+
+    // Po každém výstupním průchodu. false = snímek by přesáhl rozpočet:
+    // limit() je nižší, přepočítej snímek a zavolej znovu (skončí nejpozději
+    // u limitu 0). true = snímek může ven; limit() platí pro další snímek.
+    bool check(const uint32_t* sum, uint16_t n, uint32_t now) {
+      uint32_t ma = estimate(sum, n);
+      uint32_t idle = (uint32_t)n * idleUa / 1000;
+      if (budgetMa && ma > budgetMa && lim > 0) {
+        uint8_t l = fit(ma, idle, budgetMa);
+        if (l >= lim) l = lim - 1;            // odhad po zaokrouhlení nesedí přesně: aspoň o krok
+        if (lim == 255) eventCount++;
+        lim = l;
+        if ((gain >> 8) > lim) gain = (uint16_t)lim << 8;
+        clampCount++;
+        return false;
+      }
+
+      last = ma;
+      if (budgetMa) {
+        int32_t room = (int32_t)budgetMa - (int32_t)ma;
+        if (room < minRoom) minRoom = room;
+      }
+      uint32_t dt = started ? now - lastMs : 0;
+      if (dt > 0xFFFF) dt = 0xFFFF;           // 0xFFFF * dt se musí vejít do 32 bitů
+      started = true;
+      lastMs = now;
+      if (!budgetMa) { lim = 255; gain = 0xFF00; return true; }
+
+      // Kam míří plynulé omezení: snímek při limitu 255 by měl mít softPercent rozpočtu
+      uint32_t soft = (uint32_t)budgetMa * softPercent / 100;
+      uint16_t target = (uint16_t)fit(ma, idle, soft) << 8;
+      if (target < gain) {
+        uint32_t d = attackMs ? (uint32_t)0xFFFF * dt / attackMs : 0xFFFF;
+        gain = ((uint32_t)(gain - target) > d) ? gain - d : target;
+      } else if (target > gain) {
+        uint32_t d = releaseMs ? (uint32_t)0xFFFF * dt / releaseMs : 0xFFFF;
+        gain = ((uint32_t)(target - gain) > d) ? gain + d : target;
+      }
+      uint8_t hard = fit(ma, idle, budgetMa);   // další snímek stejný: pořád pod rozpočtem
+      uint8_t l = (gain >> 8) < hard ? (gain >> 8) : hard;
+      if (lim == 255 && l < 255) eventCount++;
+      lim = l;
+      return true;
+    }
+
+    uint8_t  limit() const { return lim; }          // pro Output::limit()
+    uint32_t lastMa() const { return last; }         // odhad posledního odeslaného snímku
+    int32_t  headroomMa() const { return budgetMa ? (int32_t)budgetMa - (int32_t)last : 0; }
+    int32_t  minHeadroomMa() const { return minRoom; }   // nejmenší rezerva od resetStats()
+    uint32_t events() const { return eventCount; }   // kolikrát omezení začalo
+    uint32_t clamps() const { return clampCount; }   // snímky přepočítané kvůli rozpočtu
+    void resetStats() { minRoom = INT32_MAX; eventCount = clampCount = 0; }
+
+  private:
+    // Limit, při kterém by snímek (odhad ma při limitu lim) měl nejvýš cap mA.
+    // Proud nad klidovým je úměrný (limit + 1) – tabulky výstupu počítají se scale8.
+    uint8_t fit(uint32_t ma, uint32_t idle, uint32_t cap) const {
+      if (cap <= idle) return 0;
+      uint32_t dyn = ma - idle;
+      uint32_t full = dyn * 256 / (lim + 1u);         // dynamický proud při limitu 255
+      if (full <= cap - idle) return 255;
+      uint32_t l = (cap - idle) * 256 / full;
+      return l ? (uint8_t)(l - 1) : 0;
+    }
+
+    uint8_t  lim = 255;
+    uint16_t gain = 0xFF00;      // plynulé omezení, 8.8 bitů (255.0)
+    uint32_t last = 0;
+    int32_t  minRoom = INT32_MAX;
+    uint32_t eventCount = 0, clampCount = 0;
+    uint32_t lastMs = 0;
+    bool     started = false;
+  };
+
+#if defined(ESP32)
+  // Takt procesoru a lehký spánek podle stavu Policy
+  class Governor {
+  public:
+    static constexpr uint8_t MAX_PINS = 4;
+    uint16_t activeMhz = 240;
+    uint16_t idleMhz   = 80;     // nejníž s Wi-Fi; APB zůstává 80 MHz
+
+    // Pin, jehož hrana probudí z lehkého spánku (má attachInterrupt(..., CHANGE))
+    void wakeOn(uint8_t pin) { if (pins < MAX_PINS) wakePin[pins++] = pin; }
+
+    void apply(State s) {
+      uint16_t mhz = (s == ACTIVE) ? activeMhz : idleMhz;
+      if (mhz == currentMhz) return;
+      setCpuFrequencyMhz(mhz);
+      currentMhz = mhz;
+    }
+
+    // Lehký spánek nejvýš ms: RAM i piny (data pro LED) drží, oba procesory
+    // stojí. Volat z úlohy, když ostatní na něco čekají, a bez zámků.
+    // Vrací true, když probudil pin (= vstup), false po uplynutí času.
+    bool lightSleep(uint32_t ms) {
+      // GPIO probouzí úrovní, ne hranou: čeká se na opak toho, co je na pinu teď.
+      // gpio_wakeup_enable přepíše typ přerušení pinu, po probuzení se vrací CHANGE.
+      for (uint8_t i = 0; i < pins; i++)
+        gpio_wakeup_enable((gpio_num_t)wakePin[i],
+                           digitalRead(wakePin[i]) ? GPIO_INTR_LOW_LEVEL : GPIO_INTR_HIGH_LEVEL);
+      if (pins) esp_sleep_enable_gpio_wakeup();
+      esp_sleep_enable_timer_wakeup((uint64_t)ms * 1000);
+      esp_light_sleep_start();
+      bool byPin = esp_sleep_get_wakeup_cause() == ESP_SLEEP_WAKEUP_GPIO;
+      for (uint8_t i = 0; i < pins; i++) {
+        gpio_wakeup_disable((gpio_num_t)wakePin[i]);
+        gpio_set_intr_type((gpio_num_t)wakePin[i], GPIO_INTR_ANYEDGE);
+      }
+      esp_sleep_disable_wakeup_source(ESP_SLEEP_WAKEUP_ALL);
+      return byPin;
+    }
+
+  private:
+    uint8_t wakePin[MAX_PINS];
+    uint8_t pins = 0;
+    uint16_t currentMhz = 0;
+  };
+#endif
+
+} // namespace MyPower
+
+#endif // MY_POWER_H
@@ -0,0 +1,247 @@
+/************************************************************
+MyFrameCache.h — paměť snímků pro show, které se opakují (MyShows)
+
+CO TO JE:
+- Duha se opakuje po 256 krocích a color wipe po 6·N – a přesto se
+  každý snímek počítá znovu, pixel po pixelu. Tady se první cyklus
+  cestou uloží (zkomprimovaný) a další cykly se jen rozbalí do bufferu.
+- Co jde uložit, říká show sama: Engine::period() (po kolika krocích se
+  opakuje, 0 = nejde), phase() (kde v cyklu je) a inputs() (otisk jasu,
+  obsahu palety, N...). Jiný otisk nebo jiná perioda = paměť se smaže
+  a plní znovu, sketch nic nehlídá.
+- Komprese jako u klipů webové show: snímek = změny proti předchozímu
+  (přeskoč / nové pixely / několik stejných), každý KEY_EVERY. celý.
+  Color wipe má pár bajtů na snímek, duha skoro celý snímek.
+- Skok (seek, MySync) rozbalí nejvýš KEY_EVERY záznamů od klíčového snímku.
+- Nevejde se cyklus (duha na dlouhém pásku do malé paměti)? Show se
+  kreslí normálně, dokud se nezmění show nebo parametry.
+- Rozbaluje se do vlastní kopie posledního snímku a ta se zkopíruje do
+  pixelů – nevadí, když sketch mezitím do bufferu kreslí něco jiného.
+
+POUŽITÍ (ESP32 nebo PC):
+  MyShows::FrameCache<decltype(shows)> cache;
+  setup():  cache.begin((uint8_t*)malloc(48000), 48000);  // s PSRAM: ps_malloc()
+  snímek:   if (!cache.replay(shows)) { shows.render(); cache.record(shows); }
+  statistika: cache.hitPercent(), cache.bytesUsed(), cache.cachedFrames()
+
+Úkoly:
+1) Scanner se taky opakuje. Proč ho period() neuvádí? (Zkus to a změř.)
+2) Kolik bajtů zabere color wipe na 300 LED (bytesUsed)? Proč tak málo?
+3) Co se stane s pamětí, když držíš tlačítko jasu? Proč to nevadí?
+************************************************************/
+
+#ifndef MY_FRAME_CACHE_H
+#define MY_FRAME_CACHE_H
+
+#include "MyShows.h"
+
+namespace MyShows {
+
+  template<class ENGINE>
+  class FrameCache {
+  public:
+    static constexpr uint16_t N = ENGINE::COUNT;
+    static constexpr uint8_t  KEY_EVERY = 16;
+    static constexpr uint8_t  RUN_MAX   = 64;     // nové pixely / stejné pixely v jednom kroku
+    static constexpr uint8_t  SKIP_MIN  = 4;      // kratší mezera / opakování se uloží jako nové pixely
+    static constexpr uint8_t  FILL_MIN  = 4;
+
+    enum State : uint8_t {
+      EMPTY,        // žádná periodická show zatím nebyla
+      RECORDING,    // plní se první cyklus
+      COMPLETE,     // celý cyklus je uložený: snímky jdou z paměti
+      FULL          // cyklus se nevešel: kreslí se normálně
+    };
+
+    // Paměť pro tabulku, poslední snímek a data (sketch ji alokuje, i v PSRAM)
+    void begin(uint8_t* mem, uint32_t bytes) {
+      buf = mem;
+      cap = mem ? bytes : 0;
+      st = EMPTY;
+      per = 0;
+    }
+
+    // Snímek z paměti do pixelů a posun čítačů show; false = kresli sám
+    // (render()) a pak zavolej record()
+    bool replay(ENGINE& e) {
+      pending = false;
+      uint32_t p = e.period();
+      if (!p || !cap) { misses++; return false; }
+      uint32_t key = e.inputs();
+      if (st == EMPTY || key != curKey || p != per) reset(key, p);
+      uint32_t ph = e.phase();
+      if (st == COMPLETE) {
+        decodeTo(ph);
+        memcpy(e.pixels.data(), last, N * 3);
+        e.skipFrame();
+        hits++;
+        return true;
+      }
+      misses++;
+      if (st == RECORDING) { pending = true; pendingPhase = ph; }
+      return false;
+    }
+
+    // Po render(): uloží snímek, který replay() v paměti nenašel
+    void record(ENGINE& e) {
+      if (!pending) return;
+      pending = false;
+      append(pendingPhase, e.pixels.data());
+    }
+
+    // Smaže obsah (příště se plní znovu), statistiku nechá
+    void invalidate() { if (st != EMPTY) { st = EMPTY; invalidations++; } }
+
+    State state() const { return st; }
+    uint32_t period() const { return per; }
+    uint32_t cachedFrames() const { return recorded; }
+    uint32_t bytesUsed() const { return (st == EMPTY) ? 0 : dataStart + used; }
+    uint32_t capacity() const { return cap; }
+    uint8_t hitPercent() const { uint32_t all = hits + misses; return all ? (uint8_t)((uint64_t)hits * 100 / all) : 0; }
+    void resetStats() { hits = misses = invalidations = 0; }
+
+    uint32_t hits = 0;           // snímky z paměti
+    uint32_t misses = 0;         // snímky kreslené show (plnění, neperiodické, plno)
+    uint32_t invalidations = 0;  // smazání po změně show nebo parametrů
+
+  private:
+    static constexpr uint32_t KEY = 0x80000000UL;               // v off[]: záznam je celý snímek
+    static constexpr uint32_t MAX_RECORD = N * 3u + (N + RUN_MAX - 1) / RUN_MAX;
+    static_assert(MAX_RECORD <= 0xFFFF, "MyFrameCache: záznam snímku se nevejde do uint16_t");
+
+    // Rozvržení paměti: off[per] (u32), len[per] (u16), last[N*3], data
+    void reset(uint32_t key, uint32_t p) {
+      if (st != EMPTY) invalidations++;
+      curKey = key;
+      per = p;
+      recorded = 0;
+      used = 0;
+      pending = false;
+      off = (uint32_t*)buf;
+      len = (uint16_t*)(buf + p * 4);
+      last = buf + p * 6;
+      dataStart = p * 6 + N * 3;
+      data = buf + dataStart;
+      st = (dataStart + MAX_RECORD <= cap) ? RECORDING : FULL;
+    }
+
+    uint32_t before(uint32_t ph) const { return ph ? ph - 1 : per - 1; }
+
+    void append(uint32_t ph, const uint8_t* px) {
+      if (recorded && ph != (lastPhase + 1) % per) {   // skok při plnění: znovu od tohoto snímku
+        recorded = 0;
+        used = 0;
+      }
+      if (used + MAX_RECORD > cap - dataStart) { st = FULL; return; }
+      bool key = recorded % KEY_EVERY == 0;
+      uint32_t n = encode(data + used, px, key ? nullptr : last);
+      off[ph] = used | (key ? KEY : 0);
+      len[ph] = (uint16_t)n;
+      used += n;
+      memcpy(last, px, N * 3);
+      lastPhase = ph;
+      if (++recorded == per) st = COMPLETE;
+    }
+
+    // Snímek ph do last: další v pořadí = jeden záznam, jinak od klíčového
+    void decodeTo(uint32_t ph) {
+      if (ph == lastPhase) return;
+      uint32_t from = ph;
+      while (!(off[from] & KEY) && before(from) != lastPhase) from = before(from);
+      for (;;) {
+        apply(from);
+        if (from == ph) break;
+        from = (from + 1 == per) ? 0 : from + 1;
+      }
+      lastPhase = ph;
+    }
+
+    // Změny proti ref (nullptr = celý snímek proti černé):
+    //   0x00..0x7F přeskoč t+1, 0x80..0xBF t−0x7F nových, 0xC0..0xFF t−0xBF stejných
+    // Krátké mezery a opakování zůstanou v nových pixelech: každý krok navíc
+    // stojí při přehrávání víc než pár bajtů.
+    static uint32_t encode(uint8_t* out, const uint8_t* px, const uint8_t* ref) {
+      uint32_t n = 0;
+      uint16_t i = 0;
+      while (i < N) {
+        uint16_t run = unchanged(px, ref, i, 128);
+        if (i + run == N) break;                  // zbytek beze změny
+        if (run >= SKIP_MIN) {
+          out[n++] = (uint8_t)(run - 1);
+          i += run;
+          continue;
+        }
+        run = repeats(px, i, RUN_MAX);
+        if (run >= FILL_MIN) {
+          out[n++] = (uint8_t)(0xBF + run);
+          memcpy(out + n, px + i * 3, 3);
+          n += 3;
+          i += run;
+          continue;
+        }
+        run = 1;
+        while (i + run < N && run < RUN_MAX && unchanged(px, ref, i + run, SKIP_MIN) < SKIP_MIN &&
+               repeats(px, i + run, FILL_MIN) < FILL_MIN) run++;
+        out[n++] = (uint8_t)(0x7F + run);
+        memcpy(out + n, px + i * 3, run * 3);
+        n += run * 3;
+        i += run;
+      }
+      return n;
+    }
+
+    // Kolik pixelů od i se nezměnilo proti ref / je stejných jako pixel i (nejvýš max)
+    static uint16_t unchanged(const uint8_t* px, const uint8_t* ref, uint16_t i, uint16_t max) {
+      static const uint8_t ZERO[3] = { 0, 0, 0 };
+      uint16_t run = 0;
+      while (i + run < N && run < max && same(px + (i + run) * 3, ref ? ref + (i + run) * 3 : ZERO)) run++;
+      return run;
+    }
+
+    static uint16_t repeats(const uint8_t* px, uint16_t i, uint16_t max) {
+      uint16_t run = 1;
+      while (i + run < N && run < max && same(px + (i + run) * 3, px + i * 3)) run++;
+      return run;
+    }
+
+    void apply(uint32_t ph) {
+      const uint8_t* p = data + (off[ph] & ~KEY);
+      const uint8_t* end = p + len[ph];
+      uint8_t* px = last;
+      if (off[ph] & KEY) memset(last, 0, N * 3);
+      while (p < end) {
+        uint8_t t = *p++;
+        if (t < 0x80) { px += (t + 1) * 3; continue; }
+        if (t < 0xC0) {
+          uint16_t n = (t - 0x7F) * 3;
+          memcpy(px, p, n);
+          px += n; p += n;
+          continue;
+        }
+        for (uint8_t k = t - 0xBF; k; k--, px += 3) { px[0] = p[0]; px[1] = p[1]; px[2] = p[2]; }
+        p += 3;
+      }
+    }
+
+    static bool same(const uint8_t* a, const uint8_t* b) { return a[0] == b[0] && a[1] == b[1] && a[2] == b[2]; }
+
+    uint8_t*  buf = nullptr;
+    uint32_t  cap = 0;
+    State     st = EMPTY;
+    uint32_t  curKey = 0;
+    uint32_t  per = 0;
+    uint32_t* off = nullptr;
+    uint16_t* len = nullptr;
+    uint8_t*  last = nullptr;      // poslední snímek (plnění i přehrávání)
+    uint8_t*  data = nullptr;
+    uint32_t  dataStart = 0;
+    uint32_t  used = 0;
+    uint32_t  recorded = 0;
+    uint32_t  lastPhase = 0;       // fáze snímku v last
+    uint32_t  pendingPhase = 0;
+    bool      pending = false;
+  };
+
+} // namespace MyShows
+
+#endif // MY_FRAME_CACHE_H
@@ -0,0 +1,216 @@
+/************************************************************
+MyLayout.h — kde která LED visí: matice, kruh, libovolné body
+
+CO TO JE:
+- Show počítají s páskem 0..N-1. Panel 16×16 je ale zapojený „hadem“
+  (každý druhý řádek pozpátku), kruh má LED po úhlech a dekorace
+  můžou mít LED kdekoli. Layout to jednou při startu přepočítá do tabulek:
+    at(x, y)   – mřížka W×H → číslo LED (NO_LED = tam nic není)
+    info(i)    – LED → x, y, úhel (0..255 = celý kruh, 0 = nahoře,
+                 po směru hodinek) a vzdálenost od středu (0..255)
+    rows(f)    – 2D show: f(x, y, i) pro všechny LED po řádcích
+                 (jen existující LED, po sobě v paměti)
+    remap()    – 1D show: Engine kreslí do logického pásku a ten se
+                 jedním průchodem rozloží po zvolené cestě (path)
+- Cesty pro 1D show: PATH_WIRING (jak je to zapojené), PATH_ROWS
+  (řádky zleva doprava), PATH_SNAKE (řádky tam a zpět), PATH_COLUMNS,
+  PATH_ANGLE (dokola jako ručička), PATH_RADIUS (od středu ven).
+- Přepočet při startu používá float a atan2 – jednou, ne v každém snímku.
+- RAM: 2·W·H + 10·N bajtů (16×16 panel ≈ 3 kB). Na Leonardu jen malé
+  věci (kruh 12 LED s mřížkou 8×8 = 248 B).
+
+POUŽITÍ:
+  MyShows::Layout<256, 16, 16> layout;
+  setup():  MyShows::Matrix m = { 16, 16, true };   // 16×16, had
+            layout.matrix(m);
+            layout.path(MyShows::PATH_SNAKE);
+  1D show:  MyShows::Engine<256, MyShows::OrderGRB, MyShows::OwnPixels<256> > shows;
+            shows.render(); layout.remap(shows.pixels.data(), strip.getPixels()); strip.show();
+            s výstupem (MyOutput.h): layout.remap(shows.pixels.data(), strip.getPixels(), output);
+  2D show:  layout.rows([&](uint8_t x, uint8_t y, uint16_t i) { ...barva podle x, y... });
+  kruh:     layout.ring();                    // N LED po kružnici, LED 0 nahoře
+  body:     static const MyShows::Point P[N] = { {0, 3}, {2, 1}, ... };  layout.points(P);
+
+Úkoly:
+1) Matice 8×8 „hadem“: na které LED je bod (0, 1)? A po rotate = 2?
+2) Proč remap() kopíruje do fyzického bufferu, a ne Engine kreslí rovnou
+   přes tabulku? (Najdi v MyShows.h „pixels.data() + from * 3“.)
+3) Nakresli kruh 12 LED s PATH_ROWS: kudy poběží kometa?
+************************************************************/
+
+#ifndef MY_LAYOUT_H
+#define MY_LAYOUT_H
+
+#include "MyShows.h"
+#include <math.h>
+
+namespace MyShows {
+
+  constexpr uint16_t NO_LED = 0xFFFF;
+
+  enum Path : uint8_t { PATH_WIRING, PATH_ROWS, PATH_SNAKE, PATH_COLUMNS, PATH_ANGLE, PATH_RADIUS };
+
+  // Jak je panel zapojený (LED 0 = levý horní roh, než se otočí)
+  struct Matrix {
+    uint8_t w, h;
+    bool serpentine;     // každý druhý řádek pozpátku (většina panelů)
+    bool columns;        // zapojené po sloupcích místo po řádcích
+    uint8_t rotate;      // 0..3 = otočení o 0°, 90°, 180°, 270° po směru hodinek
+    bool mirror;         // zrcadlo zleva doprava (panel zezadu)
+  };
+
+  struct Point { uint8_t x, y; };   // souřadnice v mřížce W×H
+
+  template<uint16_t N, uint8_t W, uint8_t H>
+  class Layout {
+    static_assert((uint32_t)W * H < NO_LED, "MyLayout: mřížka je moc velká");
+
+  public:
+    struct Info { uint8_t x, y, angle, radius; };
+
+    Layout() { wiring(); }
+
+    // Panel w×h (po otočení se musí vejít do W×H); false = nesedí počet LED
+    bool matrix(const Matrix& m) {
+      if ((uint32_t)m.w * m.h != N) return false;
+      bool turned = m.rotate & 1;
+      if ((turned ? m.h : m.w) > W || (turned ? m.w : m.h) > H) return false;
+      for (uint16_t i = 0; i < N; i++) {
+        uint8_t x, y;
+        if (!m.columns) { y = i / m.w; x = i % m.w; if (m.serpentine && (y & 1)) x = m.w - 1 - x; }
+        else            { x = i / m.h; y = i % m.h; if (m.serpentine && (x & 1)) y = m.h - 1 - y; }
+        if (m.mirror) x = m.w - 1 - x;
+        uint8_t w = m.w, h = m.h;
+        for (uint8_t r = 0; r < (m.rotate & 3); r++) {   // o 90° po směru: (x, y) → (h-1-y, x)
+          uint8_t t = x;
+          x = h - 1 - y;
+          y = t;
+          t = w; w = h; h = t;
+        }
+        inf[i].x = x;
+        inf[i].y = y;
+      }
+      finish(false);
+      return true;
+    }
+
+    // N LED po kružnici vepsané do mřížky; start = úhel LED 0 (0 = nahoře)
+    void ring(uint8_t start = 0, bool clockwise = true) {
+      float cx = (W - 1) / 2.0f, cy = (H - 1) / 2.0f;
+      float r = (W < H ? W - 1 : H - 1) / 2.0f;
+      for (uint16_t i = 0; i < N; i++) {
+        uint16_t step = (uint16_t)((uint32_t)i * 256 / N);
+        uint8_t a = (uint8_t)(clockwise ? start + step : start - step);
+        float rad = a * (6.2831853f / 256);
+        inf[i].x = (uint8_t)lroundf(cx + r * sinf(rad));
+        inf[i].y = (uint8_t)lroundf(cy - r * cosf(rad));
+        inf[i].angle = a;                               // přesně, ne z zaokrouhlených x, y
+        inf[i].radius = 255;
+      }
+      finish(true);
+    }
+
+    // Libovolné rozmístění: p[i] = souřadnice LED i; false = bod mimo mřížku
+    bool points(const Point* p) {
+      for (uint16_t i = 0; i < N; i++) {
+        if (p[i].x >= W || p[i].y >= H) return false;
+        inf[i].x = p[i].x;
+        inf[i].y = p[i].y;
+      }
+      finish(false);
+      return true;
+    }
+
+    // Pořadí, ve kterém 1D show projde LED (remap, pathIndex);
+    // volat až po matrix() / ring() / points() – ty cestu vrátí na PATH_WIRING
+    void path(Path p) {
+      for (uint16_t k = 0; k < N; k++) order[k] = k;
+      switch (p) {
+        case PATH_ROWS:    for (uint16_t k = 0; k < N; k++) order[k] = scan[k].i; return;
+        case PATH_SNAKE:   sortBy(order, [this](uint16_t i) {   // liché řádky zprava doleva
+                             const Info& a = inf[i];
+                             return (uint16_t)(a.y << 8 | ((a.y & 1) ? 255 - a.x : a.x));
+                           }); return;
+        case PATH_COLUMNS: sortBy(order, [this](uint16_t i) { return (uint16_t)(inf[i].x << 8 | inf[i].y); }); return;
+        case PATH_ANGLE:   sortBy(order, [this](uint16_t i) { return (uint16_t)(inf[i].angle << 8 | inf[i].radius); }); return;
+        case PATH_RADIUS:  sortBy(order, [this](uint16_t i) { return (uint16_t)(inf[i].radius << 8 | inf[i].angle); }); return;
+        default: return;                                // PATH_WIRING: jak je zapojeno
+      }
+    }
+
+    // --- dotazy (za běhu jen čtení z tabulek) ---
+    uint16_t at(uint8_t x, uint8_t y) const { return (x < W && y < H) ? grid[y * W + x] : NO_LED; }
+    const Info& info(uint16_t i) const { return inf[i]; }
+    uint16_t pathIndex(uint16_t k) const { return order[k]; }   // k-tá LED na cestě
+
+    // 2D show: po řádcích shora, v řádku zleva; jen LED, které existují
+    template<class F> void rows(F f) const {
+      for (const Cell* c = scan; c != scan + N; c++) f(c->x, c->y, c->i);
+    }
+
+    // Logický pásek (N×3 B, pořadí cesty) → buffer pásku
+    void remap(const uint8_t* logical, uint8_t* physical) const {
+      for (uint16_t k = 0; k < N; k++, logical += 3) {
+        uint8_t* p = physical + order[k] * 3;
+        p[0] = logical[0]; p[1] = logical[1]; p[2] = logical[2];
+      }
+    }
+
+    // Totéž a zároveň výstup (MyOutput.h: jas, gama, bílá, pořadí) – pořád jeden průchod
+    template<class OUT> void remap(const uint8_t* logical, uint8_t* physical, OUT& out) const {
+      out.prepare();
+      for (uint16_t k = 0; k < N; k++, logical += 3) out.pixel(logical, physical + order[k] * 3);
+    }
+
+  private:
+    // Výchozí stav: pásek ve vodorovné řadě (řádek 0), cesta = zapojení
+    void wiring() {
+      for (uint16_t i = 0; i < N; i++) { inf[i].x = (i < W) ? i : W - 1; inf[i].y = 0; }
+      finish(false);
+    }
+
+    // Z x, y dopočítá mřížku, pořadí po řádcích a (když nejsou dané) úhel a vzdálenost
+    void finish(bool polarGiven) {
+      for (uint16_t c = 0; c < (uint16_t)W * H; c++) grid[c] = NO_LED;
+      for (uint16_t i = N; i-- > 0;) grid[inf[i].y * W + inf[i].x] = i;   // víc LED na políčku: nižší číslo
+      if (!polarGiven) {
+        float cx = 0, cy = 0, far = 0;
+        for (uint16_t i = 0; i < N; i++) { cx += inf[i].x; cy += inf[i].y; }
+        cx /= N; cy /= N;                               // střed = těžiště LED
+        for (uint16_t i = 0; i < N; i++) {
+          float d = hypotf(inf[i].x - cx, inf[i].y - cy);
+          if (d > far) far = d;
+        }
+        for (uint16_t i = 0; i < N; i++) {
+          float dx = inf[i].x - cx, dy = inf[i].y - cy;
+          float a = atan2f(dx, -dy) * (256 / 6.2831853f);   // 0 = nahoře, po směru hodinek
+          inf[i].angle = (uint8_t)((int16_t)lroundf(a < 0 ? a + 256 : a) & 0xFF);
+          inf[i].radius = far > 0 ? (uint8_t)lroundf(hypotf(dx, dy) * 255 / far) : 0;
+        }
+      }
+      for (uint16_t k = 0; k < N; k++) order[k] = k;
+      sortBy(order, [this](uint16_t i) { return (uint16_t)(inf[i].y << 8 | inf[i].x); });
+      for (uint16_t k = 0; k < N; k++) scan[k] = { inf[order[k]].x, inf[order[k]].y, order[k] };
+      path(PATH_WIRING);
+    }
+
+    // Stabilní řazení vkládáním podle klíče (jen při startu; N ≤ pár set)
+    template<class KEY> static void sortBy(uint16_t* a, KEY key) {
+      for (uint16_t k = 1; k < N; k++) {
+        uint16_t v = a[k], kv = key(v);
+        uint16_t j = k;
+        while (j > 0 && key(a[j - 1]) > kv) { a[j] = a[j - 1]; j--; }
+        a[j] = v;
+      }
+    }
+
+    uint16_t grid[(uint16_t)W * H];   // (x, y) → LED
+    Info inf[N];                      // LED → x, y, úhel, vzdálenost
+    struct Cell { uint8_t x, y; uint16_t i; };
+    Cell scan[N];                     // LED po řádcích i se souřadnicemi (rows, PATH_ROWS)
+    uint16_t order[N];                // cesta pro 1D show (remap)
+  };
+
+} // namespace MyShows
+
+#endif // MY_LAYOUT_H
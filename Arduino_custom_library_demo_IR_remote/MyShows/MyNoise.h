@@ -0,0 +1,282 @@
+/************************************************************
+MyNoise.h — plynulý „šum“ (gradient noise) jen v celých číslech
+
+CO TO JE:
+- random() dává každé LED a v každém snímku úplně jiné číslo, proto oheň
+  a jiskření „zrní“. Gradientní šum (Perlin) je náhodný, ale plynulý:
+  blízké souřadnice = podobné hodnoty. Plamen pak vlní celý jazyk,
+  hvězda se pomalu rozsvítí a zase zhasne.
+- Souřadnice jsou uint16_t ve formátu 8.8: horní bajt = políčko mřížky,
+  dolní bajt = poloha uvnitř políčka (256 = jedno políčko). Šum se
+  opakuje po 256 políčkách, takže přetečení uint16_t nevadí.
+- Šum nepotřebuje float ani dělení: dvě tabulky po 256 B (permutace a křivka
+  prolnutí) leží v ROM, zbytek je násobení a posuny. Stejný vstup =
+  stejný výstup na AVR, ESP32 i PC.
+- noiseRow() kreslí celou řadu pixelů naráz: sousední pixely leží ve
+  stejném políčku, takže hashe a gradienty se počítají jen jednou za
+  políčko, ne za pixel (výsledek je bit po bitu stejný jako noise8()).
+
+POUŽITÍ:
+  uint8_t v = MyShows::noise8(i * 40, t * 8);        // 0..255, střed 128
+  MyShows::noiseRow(buf, N, 0, 40, t * 8);           // totéž pro celý pásek
+  MyShows::fbmRow(buf, N, 0, 30, t * 4, 2);          // 2 oktávy = jemnější detail (plasma)
+  uint8_t star = MyShows::sparkle8(t * 8, i);        // jas hvězdy 0..255 (většinou 0)
+  MyShows::NoiseFire<N> fire;  fire.step();  ... palette.rgb(fire.heat[i])
+
+Úkoly:
+1) Co se stane s ohněm, když zvětšíš COOL_DX? A když COOL_SPEED?
+2) Proč noise8() pro celé souřadnice (dolní bajt 0) vrací vždy přesně 128?
+3) Proč sparkle8() nepotřebuje pamatovat si jas hvězd z minulého snímku?
+************************************************************/
+
+// Před strážcem: MyShows.h tenhle soubor vkládá sám (jiskření v Engine),
+// takže ať se vloží první kterýkoli z nich, šum je hotový dřív než Engine.
+#include "MyShows.h"
+
+#ifndef MY_NOISE_H
+#define MY_NOISE_H
+
+namespace MyShows {
+
+  namespace detail {
+    // Zamíchaná čísla 0..255 (každé jednou) – hash políčka mřížky
+    constexpr uint8_t NOISE_PERM[256] MYSHOWS_ROM = {
+      230,  81, 218,  46, 197, 204,  61, 249, 212, 209, 195, 239, 137, 227,  65,  95,
+      247,  34,  86, 115,  78,  89, 118, 139, 112,  62,   6, 234, 208, 251, 211, 140,
+      135, 103, 223,  83,  47, 254, 122, 198, 160, 188, 154, 153,  63, 150,  94, 109,
+      183, 243, 152,  15, 181, 162, 217, 240, 199, 189,  72,  21,  99,  91,  27, 250,
+       28, 182,  41, 125,  16,  12, 164,  43,   3, 232, 228,  44, 113, 205,  33,  49,
+        1,  53, 225, 253,  14, 206, 238,  82,  24, 100,   8, 106, 179,  48, 132, 216,
+      108, 180,  45, 172, 114, 163, 169, 105, 155, 175, 202, 233,  42, 221,  93,  40,
+      176, 161,   4, 224, 128, 196, 138, 255,  31,  32, 167, 246, 123, 186, 215, 170,
+      116, 237, 174,  68,  90, 134, 136, 146, 121,  57, 141, 241, 107, 151, 131, 229,
+       59, 200, 190, 104, 220,  51, 117, 242,   7,  11, 185, 192, 219,  37,  87,  36,
+      156,   9,  69,  17, 129, 245,  30, 210, 158,  84, 226, 149, 126, 165,  79,   5,
+       26,  70, 111,  85, 248,  76, 159,  50, 157,  97,  77, 201,  88, 222, 147, 252,
+       71, 119, 214,  25,  55, 168,   0,  29, 178,  56,  38, 142,  35,  74,  39,  92,
+      184, 124,  75,  98, 213,  20,  66, 133,  22, 143,  80, 231, 148,  10,  19, 236,
+       64, 177, 101, 166, 171, 110, 235, 144,  23,  52, 120, 207, 145,  96,  58, 244,
+      173,  13, 193,   2, 194, 203,  67, 191,  54,  60, 187,  73,  18, 130, 102, 127
+    };
+    // Křivka prolnutí 6t^5 - 15t^4 + 10t^3 (t = 0..255/256) × 256
+    constexpr uint8_t NOISE_FADE[256] MYSHOWS_ROM = {
+        0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+        1,   1,   1,   1,   1,   1,   1,   2,   2,   2,   2,   3,   3,   3,   3,   4,
+        4,   4,   5,   5,   6,   6,   7,   7,   8,   8,   9,   9,  10,  10,  11,  12,
+       12,  13,  14,  15,  15,  16,  17,  18,  19,  20,  21,  22,  22,  23,  24,  25,
+       26,  28,  29,  30,  31,  32,  33,  34,  36,  37,  38,  39,  41,  42,  43,  45,
+       46,  47,  49,  50,  52,  53,  55,  56,  58,  59,  61,  62,  64,  66,  67,  69,
+       70,  72,  74,  75,  77,  79,  81,  82,  84,  86,  88,  89,  91,  93,  95,  96,
+       98, 100, 102, 104, 106, 107, 109, 111, 113, 115, 117, 119, 121, 122, 124, 126,
+      128, 130, 132, 134, 135, 137, 139, 141, 143, 145, 147, 149, 150, 152, 154, 156,
+      158, 160, 161, 163, 165, 167, 168, 170, 172, 174, 175, 177, 179, 181, 182, 184,
+      186, 187, 189, 190, 192, 194, 195, 197, 198, 200, 201, 203, 204, 206, 207, 209,
+      210, 211, 213, 214, 215, 217, 218, 219, 220, 222, 223, 224, 225, 226, 227, 228,
+      230, 231, 232, 233, 234, 234, 235, 236, 237, 238, 239, 240, 241, 241, 242, 243,
+      244, 244, 245, 246, 246, 247, 247, 248, 248, 249, 249, 250, 250, 251, 251, 252,
+      252, 252, 253, 253, 253, 253, 254, 254, 254, 254, 255, 255, 255, 255, 255, 255,
+      255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255
+    };
+    // 8 směrů gradientu ve 2D, délky skoro stejné (2,83 a 3)
+    constexpr int8_t NOISE_GRAD2[8][2] MYSHOWS_ROM = {
+      { 2, 2 }, { -2, 2 }, { 2, -2 }, { -2, -2 }, { 3, 0 }, { -3, 0 }, { 0, 3 }, { 0, -3 }
+    };
+
+    // Zesílení surového šumu (×/256), změřené na PC: ±127 jen u ~0,1 % hodnot
+    constexpr uint16_t NOISE_MUL1 = 36, NOISE_MUL2 = 72, NOISE_MUL3 = 160;
+
+    inline uint8_t perm(uint8_t k) { return MYSHOWS_READ8(&NOISE_PERM[k]); }
+    inline uint8_t fade(uint8_t f) { return MYSHOWS_READ8(&NOISE_FADE[f]); }
+    inline int8_t gradX(uint8_t h) { return (int8_t)MYSHOWS_READ8((const uint8_t*)&NOISE_GRAD2[h & 7][0]); }
+    inline int8_t gradY(uint8_t h) { return (int8_t)MYSHOWS_READ8((const uint8_t*)&NOISE_GRAD2[h & 7][1]); }
+
+    // a → b podle u (0..255)
+    inline int16_t lerp(int16_t a, int16_t b, uint8_t u) { return a + (int16_t)(((int32_t)(b - a) * u) >> 8); }
+
+    // Surový šum → -127..127 (mul/256 zesílení, aby se rozsah využil celý)
+    inline int8_t clampNoise(int16_t v, uint16_t mul) {
+      int32_t s = ((int32_t)v * mul) >> 8;
+      return (int8_t)(s > 127 ? 127 : (s < -127 ? -127 : s));
+    }
+
+    // 1D šum na řádku mřížky row (různé řádky = nezávislé průběhy)
+    inline int8_t snoise1(uint16_t x, uint8_t row) {
+      uint8_t X = x >> 8, f = (uint8_t)x;
+      uint8_t h0 = perm((uint8_t)(perm(X) + row)), h1 = perm((uint8_t)(perm((uint8_t)(X + 1)) + row));
+      // sklon 1..8, znaménko z bitu 3
+      int16_t g0 = (int16_t)((h0 & 7) + 1) * f, g1 = (int16_t)((h1 & 7) + 1) * (f - 256);
+      if (h0 & 8) g0 = -g0;
+      if (h1 & 8) g1 = -g1;
+      return clampNoise(lerp(g0, g1, fade(f)), NOISE_MUL1);
+    }
+
+    inline int8_t snoise2(uint16_t x, uint16_t y) {
+      uint8_t X = x >> 8, Y = y >> 8, fx = (uint8_t)x, fy = (uint8_t)y;
+      uint8_t a = perm(X) + Y, b = perm((uint8_t)(X + 1)) + Y;
+      uint8_t h00 = perm(a), h01 = perm((uint8_t)(a + 1)), h10 = perm(b), h11 = perm((uint8_t)(b + 1));
+      int16_t dx1 = fx - 256, dy1 = fy - 256;
+      int16_t d00 = gradY(h00) * fy  + gradX(h00) * fx;
+      int16_t d10 = gradY(h10) * fy  + gradX(h10) * dx1;
+      int16_t d01 = gradY(h01) * dy1 + gradX(h01) * fx;
+      int16_t d11 = gradY(h11) * dy1 + gradX(h11) * dx1;
+      uint8_t u = fade(fx);
+      return clampNoise(lerp(lerp(d00, d10, u), lerp(d01, d11, u), fade(fy)), NOISE_MUL2);
+    }
+
+    // 3D: 12 hran krychle jako u Perlina (h & 15, 4 se opakují)
+    inline int16_t grad3(uint8_t h, int16_t x, int16_t y, int16_t z) {
+      h &= 15;
+      int16_t u = h < 8 ? x : y;
+      int16_t v = h < 4 ? y : ((h == 12 || h == 14) ? x : z);
+      return ((h & 1) ? -u : u) + ((h & 2) ? -v : v);
+    }
+
+    inline int8_t snoise3(uint16_t x, uint16_t y, uint16_t z) {
+      uint8_t X = x >> 8, Y = y >> 8, Z = z >> 8;
+      int16_t fx = (uint8_t)x, fy = (uint8_t)y, fz = (uint8_t)z;
+      uint8_t a = perm(X) + Y, aa = perm(a) + Z, ab = perm((uint8_t)(a + 1)) + Z;
+      uint8_t b = perm((uint8_t)(X + 1)) + Y, ba = perm(b) + Z, bb = perm((uint8_t)(b + 1)) + Z;
+      uint8_t u = fade(fx), v = fade(fy), w = fade(fz);
+      int16_t x1 = fx - 256, y1 = fy - 256, z1 = fz - 256;
+      int16_t near = lerp(lerp(grad3(perm(aa), fx, fy, fz), grad3(perm(ba), x1, fy, fz), u),
+                          lerp(grad3(perm(ab), fx, y1, fz), grad3(perm(bb), x1, y1, fz), u), v);
+      int16_t far  = lerp(lerp(grad3(perm((uint8_t)(aa + 1)), fx, fy, z1), grad3(perm((uint8_t)(ba + 1)), x1, fy, z1), u),
+                          lerp(grad3(perm((uint8_t)(ab + 1)), fx, y1, z1), grad3(perm((uint8_t)(bb + 1)), x1, y1, z1), u), v);
+      return clampNoise(lerp(near, far, w), NOISE_MUL3);
+    }
+
+    // Oktáva k fbm: dvojnásobná frekvence, poloviční síla, posun proti opakování
+    constexpr uint16_t FBM_SHIFT = 0x3B17;
+    // 256 / sqrt(1 + 1/4 + 1/16 ...) – součet oktáv má pak podobný rozptyl jako jedna
+    constexpr uint8_t FBM_NORM[3] MYSHOWS_ROM = { 229, 223, 222 };   // 2, 3, 4 oktávy
+    inline uint16_t fbmNorm(uint8_t octaves) { return octaves == 1 ? 256 : MYSHOWS_READ8(&FBM_NORM[octaves - 2]); }
+    inline uint8_t add8s(uint8_t a, int16_t d) { int16_t s = a + d; return s < 0 ? 0 : (s > 255 ? 255 : (uint8_t)s); }
+
+    // Řada pixelů x, x+dx, ... na řádku y: oktáva k (síla norm/256 >> k) se přičte k out,
+    // k == 0 začíná od 128. Stejná aritmetika jako snoise2 → stejné výsledky.
+    inline void noiseRowOctave(uint8_t* out, uint16_t n, uint16_t x, uint16_t dx, uint16_t y, uint16_t norm, uint8_t k) {
+      uint8_t Y = y >> 8, fy = (uint8_t)y, v = fade(fy);
+      int16_t dy1 = fy - 256;
+      int8_t gx00 = 0, gx10 = 0, gx01 = 0, gx11 = 0;
+      int16_t c00 = 0, c10 = 0, c01 = 0, c11 = 0;
+      uint16_t cell = 0xFFFF;                     // žádné políčko ještě spočítané
+      for (uint16_t i = 0; i < n; i++, x += dx) {
+        uint8_t X = x >> 8, fx = (uint8_t)x;
+        if (X != cell) {                          // nové políčko: 4 hashe, 4 gradienty
+          cell = X;
+          uint8_t a = perm(X) + Y, b = perm((uint8_t)(X + 1)) + Y;
+          uint8_t h00 = perm(a), h01 = perm((uint8_t)(a + 1)), h10 = perm(b), h11 = perm((uint8_t)(b + 1));
+          gx00 = gradX(h00); gx10 = gradX(h10); gx01 = gradX(h01); gx11 = gradX(h11);
+          c00 = gradY(h00) * fy; c10 = gradY(h10) * fy; c01 = gradY(h01) * dy1; c11 = gradY(h11) * dy1;
+        }
+        int16_t dx1 = fx - 256;
+        uint8_t u = fade(fx);
+        int8_t s = clampNoise(lerp(lerp(c00 + gx00 * fx, c10 + gx10 * dx1, u),
+                                   lerp(c01 + gx01 * fx, c11 + gx11 * dx1, u), v), NOISE_MUL2);
+        out[i] = add8s(k ? out[i] : 128, ((int16_t)s * norm >> 8) >> k);
+      }
+    }
+  } // namespace detail
+
+  // Šum 0..255, střed 128; souřadnice 8.8 (256 = jedno políčko)
+  inline uint8_t noise8(uint16_t x)                         { return 128 + detail::snoise1(x, 0); }
+  inline uint8_t noise8(uint16_t x, uint16_t y)             { return 128 + detail::snoise2(x, y); }
+  inline uint8_t noise8(uint16_t x, uint16_t y, uint16_t z) { return 128 + detail::snoise3(x, y, z); }
+
+  // Víc oktáv (1..4) přes sebe – hrubé vlny + jemný detail
+  inline uint8_t fbm8(uint16_t x, uint16_t y, uint8_t octaves) {
+    if (octaves < 1) octaves = 1;
+    if (octaves > 4) octaves = 4;
+    uint16_t norm = detail::fbmNorm(octaves);
+    uint8_t v = 128;
+    for (uint8_t k = 0; k < octaves; k++) {
+      v = detail::add8s(v, ((int16_t)detail::snoise2(x, y) * norm >> 8) >> k);
+      x = (uint16_t)(x * 2 + detail::FBM_SHIFT); y = (uint16_t)(y * 2 + detail::FBM_SHIFT);
+    }
+    return v;
+  }
+
+  // out[i] = noise8(x + i * dx, y) pro celou řadu (pásek = x, čas = y)
+  inline void noiseRow(uint8_t* out, uint16_t n, uint16_t x, uint16_t dx, uint16_t y) {
+    detail::noiseRowOctave(out, n, x, dx, y, 256, 0);
+  }
+
+  // out[i] = fbm8(x + i * dx, y, octaves)
+  inline void fbmRow(uint8_t* out, uint16_t n, uint16_t x, uint16_t dx, uint16_t y, uint8_t octaves) {
+    if (octaves < 1) octaves = 1;
+    if (octaves > 4) octaves = 4;
+    uint16_t norm = detail::fbmNorm(octaves);
+    for (uint8_t k = 0; k < octaves; k++) {
+      detail::noiseRowOctave(out, n, x, dx, y, norm, k);
+      x = (uint16_t)(x * 2 + detail::FBM_SHIFT); dx = (uint16_t)(dx * 2); y = (uint16_t)(y * 2 + detail::FBM_SHIFT);
+    }
+  }
+
+  // Jas hvězdičky pixelu i v čase t (8.8): jen vrcholky šumu nad prahem, jinak 0.
+  // Každý pixel má vlastní řádek mřížky a posunutou fázi, takže nebliknou všechny naráz.
+  constexpr int8_t  SPARKLE_FROM = 40;   // práh: výš = méně hvězd
+  inline uint8_t sparkle8(uint16_t t, uint16_t i) {
+    int8_t s = detail::snoise1((uint16_t)(t + i * 0x9E37U), (uint8_t)i);
+    if (s <= SPARKLE_FROM) return 0;
+    uint8_t v = (uint8_t)(((uint16_t)(s - SPARKLE_FROM) * (255 * 256U / (127 - SPARKLE_FROM))) >> 8);
+    return scale8(v, v);                        // na druhou: krátký ostrý záblesk místo mdlé vlny
+  }
+
+  // Oheň (Fire2012) s ochlazováním a jiskrami ze šumu místo random():
+  // 1) každá buňka chladne, 2) teplo stoupá a rozmazává se, 3) dole vzplane jiskra.
+  // heat[0] je spodek plamene; barvu dá paleta (PAL_HEAT): palette.at(heat[i]).
+  template<uint16_t N> class NoiseFire {
+    static_assert(N >= 4, "NoiseFire: potřebuje aspoň 4 LED");
+
+  public:
+    static constexpr uint8_t  SPARK_CELLS = 3;      // jiskry jen ve spodních buňkách
+    static constexpr uint16_t COOL_DX     = 0x60;   // krok šumu mezi sousedními LED
+    static constexpr uint16_t COOL_SPEED  = 0x30;   // jak rychle se mění ochlazování
+    static constexpr uint16_t SPARK_SPEED = 0x40;   // jak rychle se střídají jiskry
+
+    uint8_t heat[N];
+    uint8_t cooling  = 55;    // víc = kratší plameny
+    uint8_t sparking = 120;   // víc = víc a silnějších jisker
+
+    NoiseFire() { seed(1); }
+
+    // Stejný seed = stejný plamen (snímek po snímku)
+    void seed(uint32_t s) {
+      memset(heat, 0, sizeof(heat));
+      ox = (uint16_t)s; oy = (uint16_t)(s >> 16); t = 0;
+    }
+
+    // Jeden snímek; n = kolik LED pásek opravdu má (počet nastavitelný za běhu, max. N)
+    void step(uint16_t n = N) {
+      if (n > N) n = N;
+      if (n == 0) return;
+      noiseRow(cool, n, ox, COOL_DX, (uint16_t)(oy + t * COOL_SPEED));
+      uint8_t maxCool = (uint8_t)((uint16_t)cooling * 10 / n + 2);
+      for (uint16_t i = 0; i < n; i++) {
+        uint8_t c = scale8(cool[i], maxCool);
+        heat[i] = heat[i] > c ? heat[i] - c : 0;
+      }
+      for (uint16_t k = n - 1; k >= 2; k--)       // ≈ (h[k-1] + 2 h[k-2]) / 3
+        heat[k] = (uint8_t)(((uint16_t)heat[k - 1] + 2 * heat[k - 2]) * 85 >> 8);
+      int8_t from = (int8_t)(96 - (sparking >> 1));   // práh šumu pro jiskru
+      for (uint8_t j = 0; j < SPARK_CELLS && j < n; j++) {
+        int8_t s = detail::snoise1((uint16_t)(ox + t * SPARK_SPEED + j * 0x9E37U), (uint8_t)(oy + j));
+        if (s <= from) continue;
+        uint16_t h = heat[j] + 160 + (uint16_t)(s - from) * 95 / (127 - from);
+        heat[j] = h > 255 ? 255 : (uint8_t)h;
+      }
+      t++;
+    }
+
+    // Skok na snímek k (šum jako po k× step() od seed()); teplo z dřívějška
+    // se dorovná během ~N snímků – tak dožene show jiný kontrolér (MySync)
+    void seek(uint16_t k) { t = k; }
+
+  private:
+    uint8_t  cool[N];
+    uint16_t ox, oy, t;
+  };
+
+} // namespace MyShows
+
+#endif // MY_NOISE_H
@@ -0,0 +1,163 @@
+/************************************************************
+MyOutput.h — výstup na pásek: jas, gama, bílá a pořadí barev najednou
+
+CO TO JE:
+- strip.setBrightness() přepíše buffer pásku: každý pixel vynásobí jasem
+  a původní barva je pryč. Show, které si čtou minulý snímek zpátky
+  (getPixelColor – déšť, jiskry), pak pracují s ořezanými hodnotami
+  a po pár změnách jasu nahoru a dolů zůstanou barvy tmavší a „schodovité“.
+- Tady show kreslí do logického bufferu v plné přesnosti (R, G, B,
+  0..255, bez jasu) a až write() ho jedním průchodem přepíše do bufferu
+  pásku: jas, gama, bílý bod (teplota barvy) a pořadí bajtů (GRB...).
+- Všechno je složené do tří tabulek po 256 bajtech (jedna na kanál):
+  na pixel jsou to 3 čtení z tabulky a 3 zápisy, žádné násobení.
+  Tabulky se přepočítají až v dalším write() po změně (768 kroků,
+  pár µs) – změna jasu sama nestojí nic a nikdy nezmění stav show.
+- Gama 1.0 = bez křivky: pak je výstup bajt po bajtu stejný jako
+  scale8(barva, jas) v Engine (MyShows.h).
+- Cestou sčítá bajty každého kanálu (sum) – z nich MyPower::CurrentLimit
+  odhadne proud pásku bez dalšího průchodu. limit() je druhý jas navíc
+  (pro omezovač proudu), uživatelův jas zůstane, jak ho nastavil.
+- RAM: 1,3 kB (tabulky + gama křivka) – na ESP32. Na Leonardu (2,5 kB)
+  zůstává jas v Engine (shows.brightness).
+
+POUŽITÍ:
+  uint8_t frame[N * 3];                            // logický buffer, R G B
+  MyShows::Output<MyShows::OrderGRB> output;       // pořadí jako NEO_GRB
+  setup():  output.gamma(2.2f); output.temperature(4000);   // volitelně
+  jas:      output.brightness(120);                // jen zapamatuje
+  snímek:   ...show kreslí do frame...
+            output.write(frame, strip.getPixels(), N); strip.show();
+  s MyLayout.h:  layout.remap(frame, strip.getPixels(), output);
+  (strip.setBrightness() NEPOUŽÍVEJ – jas řeší output)
+
+Úkoly:
+1) Proč se tabulky nepřepočítají hned v brightness()?
+2) S gamou 2.2 a jasem 20 zhasne barva 40 úplně. Proč? Kolik vyjde bez gamy?
+3) Při 2700 K má modrý kanál jen ~35 %. Jak se to projeví na show Rainbow?
+************************************************************/
+
+#ifndef MY_OUTPUT_H
+#define MY_OUTPUT_H
+
+#include "MyShows.h"
+#include <math.h>
+
+namespace MyShows {
+
+  template<class ORDER = OrderGRB>
+  class Output {
+  public:
+    Output() { gamma(1.0f); }
+
+    // Jas 0..255; projeví se v dalším write()
+    void brightness(uint8_t b) { if (b != bright) { bright = b; dirty = true; } }
+    uint8_t brightness() const { return bright; }
+
+    // Omezení navíc k jasu (255 = žádné) – nastavuje omezovač proudu
+    void limit(uint8_t l) { if (l != lim) { lim = l; dirty = true; } }
+    uint8_t limit() const { return lim; }
+
+    // Gama křivka (1.0 = vypnuto, LED obvykle 2.2–2.8); powf jen tady, 256×
+    void gamma(float g) {
+      if (g < 0.1f) g = 0.1f;
+      gam = g;
+      for (uint16_t v = 0; v < 256; v++)   // 8.8 bitů: tmavé barvy se neztratí dřív než po jasu
+        curve[v] = (g == 1.0f) ? (uint16_t)(v << 8) : (uint16_t)lroundf(powf(v / 255.0f, g) * 65280.0f);
+      dirty = true;
+    }
+    float gamma() const { return gam; }
+
+    // Bílý bod: na kolik se zeslabí každý kanál (255 = beze změny)
+    void whitePoint(const Rgb& w) {
+      white = w;
+      kelvin = 0;
+      dirty = true;
+    }
+    const Rgb& whitePoint() const { return white; }
+
+    // Teplota barvy v kelvinech (1000..40000; 0 nebo ~6600 = beze změny).
+    // Aproximace barvy černého tělesa (T. Helland); float jen tady.
+    void temperature(uint16_t k) {
+      if (k == 0) { whitePoint({ 255, 255, 255 }); return; }
+      if (k < 1000) k = 1000;
+      if (k > 40000) k = 40000;
+      float t = k / 100.0f;
+      float r = (t <= 66) ? 255 : 329.698727446f * powf(t - 60, -0.1332047592f);
+      float g = (t <= 66) ? 99.4708025861f * logf(t) - 161.1195681661f
+                          : 288.1221695283f * powf(t - 60, -0.0755148492f);
+      float b = (t >= 66) ? 255 : (t <= 19) ? 0 : 138.5177312231f * logf(t - 10) - 305.0447927307f;
+      whitePoint({ clamp(r), clamp(g), clamp(b) });
+      kelvin = k;
+    }
+    uint16_t temperature() const { return kelvin; }
+
+    // Začátek snímku: tabulky podle posledních změn, součty od nuly
+    // (write() a remap() to volají samy)
+    void prepare() {
+      if (dirty) rebuild();
+      sums[0] = sums[1] = sums[2] = 0;
+    }
+
+    // Logický buffer (R G B, n pixelů) → buffer pásku v pořadí ORDER
+    void write(const uint8_t* rgb, uint8_t* out, uint16_t n) {
+      prepare();
+      const uint8_t* lr = lut[0];
+      const uint8_t* lg = lut[1];
+      const uint8_t* lb = lut[2];
+      uint32_t sr = 0, sg = 0, sb = 0;
+      for (; n; n--, rgb += 3, out += 3) {
+        uint8_t r = lr[rgb[0]];
+        out[ORDER::r] = r;
+        sr += r;
+        uint8_t g = lg[rgb[1]];
+        out[ORDER::g] = g;
+        sg += g;
+        uint8_t b = lb[rgb[2]];
+        out[ORDER::b] = b;
+        sb += b;
+      }
+      sums[0] = sr; sums[1] = sg; sums[2] = sb;
+    }
+
+    // Jeden pixel (po prepare()), např. pro layout.remap()
+    void pixel(const uint8_t* rgb, uint8_t* out) {
+      uint8_t r = lut[0][rgb[0]], g = lut[1][rgb[1]], b = lut[2][rgb[2]];
+      sums[0] += r; sums[1] += g; sums[2] += b;
+      out[ORDER::r] = r;
+      out[ORDER::g] = g;
+      out[ORDER::b] = b;
+    }
+
+    // Součet výstupních bajtů R, G, B posledního snímku (pro odhad proudu)
+    const uint32_t* sum() const { return sums; }
+
+  private:
+    // lut[c][v] = křivka(v) · jas · omezení · bílá[c];
+    // se gamou 1 a bez omezení přesně scale8(v, scale8(bílá, jas))
+    void rebuild() {
+      const uint8_t w[3] = { white.r, white.g, white.b };
+      uint8_t b = scale8(bright, lim);
+      for (uint8_t c = 0; c < 3; c++) {
+        uint32_t s = (uint32_t)scale8(w[c], b) + 1;
+        for (uint16_t v = 0; v < 256; v++) lut[c][v] = (uint8_t)((curve[v] * s) >> 16);
+      }
+      dirty = false;
+    }
+
+    static uint8_t clamp(float x) { return x <= 0 ? 0 : x >= 255 ? 255 : (uint8_t)lroundf(x); }
+
+    uint8_t  lut[3][256];        // R, G, B: vstup → bajt pro pásek
+    uint16_t curve[256];         // gama, 8.8 bitů (255.0 = 65280)
+    Rgb      white = { 255, 255, 255 };
+    uint8_t  bright = 255;
+    uint8_t  lim = 255;
+    uint32_t sums[3] = { 0, 0, 0 };
+    float    gam = 1.0f;
+    uint16_t kelvin = 0;
+    bool     dirty = true;
+  };
+
+} // namespace MyShows
+
+#endif // MY_OUTPUT_H
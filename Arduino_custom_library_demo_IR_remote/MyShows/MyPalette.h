@@ -0,0 +1,151 @@
+/************************************************************
+MyPalette.h — barevné palety jako tabulka 256 barev (LUT)
+
+CO TO JE:
+- Paleta = pár "zastávek" (pozice 0..255 + barva), mezi nimi plynulý
+  přechod. compile() je jednou rozpočítá do tabulky 256 barev; show pak
+  na barvu potřebuje jen jedno čtení z tabulky (žádné if jako ve wheel()).
+- Paleta se přepočítá jen při změně (jiná paleta, režim míchání, barva),
+  ne v každém snímku.
+- Míchání s další barvou (tint): LERP (prolnutí), ADD (sečtení),
+  MULTIPLY (násobení = ztmavení), SCREEN (zesvětlení).
+- PAL_RAINBOW dává přesně stejné barvy jako wheel(), PAL_HEAT stejnou
+  rampu černá → červená → žlutá → bílá jako oheň ve web lightshow.
+- Tabulka má 768 B RAM – na ESP32 v pohodě, na Leonardu (2,5 kB) raději ne.
+
+POUŽITÍ:
+  MyShows::Palette pal;
+  pal.load(MyShows::PAL_OCEAN);
+  pal.tint({255, 120, 0}, MyShows::BLEND_SCREEN, 128);   // volitelné
+  shows.palette = pal.table(); // Engine: duha, color wipe a palette pulse berou barvy odsud
+  Rgb c = pal.at(200);         // nebo kdekoli jinde
+
+Úkoly:
+1) Proč je compile() pomalé a přesto to nevadí?
+2) Přidej vlastní paletu do PRESETS (stačí pole zastávek a jeden řádek).
+3) Co udělá MULTIPLY s bílou barvou a co SCREEN s černou?
+************************************************************/
+
+#ifndef MY_PALETTE_H
+#define MY_PALETTE_H
+
+#include "MyShows.h"
+
+namespace MyShows {
+
+  // Zastávka přechodu; pozice rostou od 0 do 255, stejná pozice dvakrát = ostrý skok
+  struct Stop { uint8_t pos, r, g, b; };
+
+  enum Blend : uint8_t { BLEND_LERP, BLEND_ADD, BLEND_MULTIPLY, BLEND_SCREEN, BLEND_COUNT };
+
+  enum PaletteId : uint8_t {
+    PAL_RAINBOW, PAL_HEAT, PAL_OCEAN, PAL_FOREST, PAL_PARTY, PAL_BASIC, PAL_PASTEL, PALETTE_COUNT
+  };
+
+  // a smíchané s b; amount 0 = jen a, 255 = plný účinek
+  inline uint8_t blend8(uint8_t a, uint8_t b, Blend mode, uint8_t amount) {
+    uint8_t full;
+    switch (mode) {
+      case BLEND_ADD:      full = (a + b > 255) ? 255 : a + b; break;
+      case BLEND_MULTIPLY: full = div255((uint16_t)a * b); break;
+      case BLEND_SCREEN:   full = 255 - div255((uint16_t)(255 - a) * (255 - b)); break;
+      default:             full = b; break;
+    }
+    return (full >= a) ? a + div255((uint16_t)(full - a) * amount)
+                       : a - div255((uint16_t)(a - full) * amount);
+  }
+
+  inline Rgb blend(Rgb a, Rgb b, Blend mode, uint8_t amount) {
+    return { blend8(a.r, b.r, mode, amount), blend8(a.g, b.g, mode, amount), blend8(a.b, b.b, mode, amount) };
+  }
+
+  namespace detail {
+    constexpr Stop STOPS_RAINBOW[] MYSHOWS_ROM = {
+      { 0, 255, 0, 0 }, { 85, 0, 255, 0 }, { 170, 0, 0, 255 }, { 255, 255, 0, 0 } };
+    constexpr Stop STOPS_HEAT[] MYSHOWS_ROM = {
+      { 0, 0, 0, 0 }, { 85, 255, 0, 0 }, { 170, 255, 255, 0 }, { 255, 255, 255, 255 } };
+    constexpr Stop STOPS_OCEAN[] MYSHOWS_ROM = {
+      { 0, 0, 0, 40 }, { 90, 0, 60, 180 }, { 170, 0, 200, 220 }, { 255, 200, 255, 255 } };
+    constexpr Stop STOPS_FOREST[] MYSHOWS_ROM = {
+      { 0, 0, 40, 0 }, { 100, 20, 140, 10 }, { 190, 120, 200, 0 }, { 255, 40, 90, 0 } };
+    constexpr Stop STOPS_PARTY[] MYSHOWS_ROM = {
+      { 0, 90, 0, 255 }, { 64, 255, 0, 120 }, { 128, 255, 120, 0 }, { 192, 255, 0, 90 }, { 255, 90, 0, 255 } };
+    // 6 barev color wipe (BASIC) s ostrými přechody
+    constexpr Stop STOPS_BASIC[] MYSHOWS_ROM = {
+      { 0, 255, 0, 0 },   { 42, 255, 0, 0 },   { 43, 0, 255, 0 },   { 85, 0, 255, 0 },
+      { 86, 0, 0, 255 },  { 127, 0, 0, 255 },  { 128, 255, 255, 0 }, { 170, 255, 255, 0 },
+      { 171, 255, 0, 255 }, { 212, 255, 0, 255 }, { 213, 0, 255, 255 }, { 255, 0, 255, 255 } };
+    // 5 barev palette pulse (PALETTE9), plynule dokola
+    constexpr Stop STOPS_PASTEL[] MYSHOWS_ROM = {
+      { 0, 0xFF, 0x55, 0x00 }, { 51, 0x00, 0xFF, 0x88 }, { 102, 0x33, 0x55, 0xFF },
+      { 153, 0xFF, 0x00, 0xAA }, { 204, 0xFF, 0xFF, 0x22 }, { 255, 0xFF, 0x55, 0x00 } };
+
+    struct Preset { const Stop* stops; uint8_t count; const char* name; };
+#define MYSHOWS_PRESET(s, n) { s, sizeof(s) / sizeof(Stop), n }
+    static const Preset PRESETS[PALETTE_COUNT] = {
+      MYSHOWS_PRESET(STOPS_RAINBOW, "Rainbow"), MYSHOWS_PRESET(STOPS_HEAT, "Heat"),
+      MYSHOWS_PRESET(STOPS_OCEAN, "Ocean"),     MYSHOWS_PRESET(STOPS_FOREST, "Forest"),
+      MYSHOWS_PRESET(STOPS_PARTY, "Party"),     MYSHOWS_PRESET(STOPS_BASIC, "Basic"),
+      MYSHOWS_PRESET(STOPS_PASTEL, "Pastel")
+    };
+#undef MYSHOWS_PRESET
+
+    inline Stop readStop(const Stop* s) {
+      const uint8_t* p = (const uint8_t*)s;
+      return { MYSHOWS_READ8(p), MYSHOWS_READ8(p + 1), MYSHOWS_READ8(p + 2), MYSHOWS_READ8(p + 3) };
+    }
+
+    // a + (b - a) * d / span, zaokrouhleno dolů jako ve wheel()
+    inline uint8_t lerpStep(uint8_t a, uint8_t b, uint8_t d, uint8_t span) {
+      return (b >= a) ? a + (uint16_t)(b - a) * d / span : a - ((uint16_t)(a - b) * d + span - 1) / span;
+    }
+  } // namespace detail
+
+  class Palette {
+  public:
+    static const char* name(uint8_t id) { return id < PALETTE_COUNT ? detail::PRESETS[id].name : "?"; }
+
+    // Přechod ze zastávek (RAM nebo ROM podle inRom) → 256 barev
+    void compile(const Stop* stops, uint8_t count, bool inRom = false) {
+      Stop a = inRom ? detail::readStop(stops) : stops[0];
+      for (uint16_t k = 0; k <= a.pos; k++) put(k, a.r, a.g, a.b);     // před první zastávkou
+      for (uint8_t s = 1; s < count; s++) {
+        Stop b = inRom ? detail::readStop(stops + s) : stops[s];
+        uint8_t span = b.pos - a.pos;
+        for (uint16_t k = a.pos + 1; k <= b.pos; k++) {
+          uint8_t d = k - a.pos;
+          put(k, detail::lerpStep(a.r, b.r, d, span), detail::lerpStep(a.g, b.g, d, span), detail::lerpStep(a.b, b.b, d, span));
+        }
+        a = b;
+      }
+      for (uint16_t k = a.pos + 1; k < 256; k++) put(k, a.r, a.g, a.b); // za poslední zastávkou
+    }
+
+    void load(uint8_t id) {
+      const detail::Preset& p = detail::PRESETS[id < PALETTE_COUNT ? id : 0];
+      compile(p.stops, p.count, true);
+    }
+
+    // Smíchá celou tabulku s barvou c (jednou, při změně)
+    void tint(Rgb c, Blend mode, uint8_t amount) {
+      if (amount == 0) return;
+      for (uint16_t k = 0; k < 256; k++) {
+        lut[k][0] = blend8(lut[k][0], c.r, mode, amount);
+        lut[k][1] = blend8(lut[k][1], c.g, mode, amount);
+        lut[k][2] = blend8(lut[k][2], c.b, mode, amount);
+      }
+    }
+
+    Rgb at(uint8_t k) const { return { lut[k][0], lut[k][1], lut[k][2] }; }
+    const uint8_t* rgb(uint8_t k) const { return lut[k]; }
+    const PaletteLut* table() const { return &lut; }
+
+  private:
+    void put(uint16_t k, uint8_t r, uint8_t g, uint8_t b) { lut[k][0] = r; lut[k][1] = g; lut[k][2] = b; }
+
+    PaletteLut lut;
+  };
+
+} // namespace MyShows
+
+#endif // MY_PALETTE_H
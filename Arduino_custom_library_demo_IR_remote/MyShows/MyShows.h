@@ -0,0 +1,562 @@
+/************************************************************
+MyShows.h — 9 světelných show pro NeoPixel pásky v jedné knihovně
+
+CO TO JE:
+- Stejných 9 efektů (duha, theater chase, dýchání, kometa, color wipe,
+  jiskření, scanner, déšť, palette pulse) bylo zkopírováno v několika
+  sketchích a každá kopie se trochu lišila. Teď jsou jen tady.
+- Engine je šablona: Engine<počet LED, pořadí barev, úložiště>.
+  Počet LED zná překladač, takže dělení a modulo počtem LED zmizí
+  (tabulka odstínů duhy se spočítá při překladu, zbytek jsou čítače).
+- Píše rovnou do bufferu pásku (strip.getPixels()) ve správném pořadí
+  bajtů (GRB, RGB, ...) a sám násobí jasem – žádné strip.Color() za běhu.
+- Nepotřebuje Arduino.h: jde přeložit i na PC a porovnat výstup / rychlost.
+
+POUŽITÍ (Adafruit_NeoPixel):
+  Adafruit_NeoPixel strip(NUMPIXELS, LED_PIN, NEO_GRB + NEO_KHZ800);
+  MyShows::Engine<NUMPIXELS, MyShows::OrderGRB> shows;
+  setup():  strip.begin(); shows.pixels.attach(strip.getPixels());
+  loop():   shows.select(3);  shows.brightness = 120;  shows.render();  strip.show();
+  (strip.setBrightness() NEPOUŽÍVEJ – jas řeší shows.brightness)
+  Paleta (MyPalette.h): shows.palette = pal.table();
+  Zvuk: shows.audio = &levels; (MyShows::AudioLevels, plní sketch před každým render())
+  Matice, kruh, vlastní rozmístění (MyLayout.h): render() do logického
+  pásku (OwnPixels) a layout.remap() do bufferu pásku
+  Jas, gama a teplota bílé (MyOutput.h, ESP32): Engine<N, OrderRGB> s jasem
+  255 kreslí do logického bufferu a output.write() ho převede do pásku
+  Dvě jádra (ESP32): beginFrame(); renderRange(0, půlka) na jednom a
+  renderRange(půlka, N) na druhém jádře; až jsou obě hotová, endFrame().
+
+Úkoly:
+1) Proč je počet LED parametr šablony a ne obyčejná proměnná?
+2) Najdi, kde se i * 256 / N počítá při překladu. Kolik to stojí RAM na AVR?
+3) Jiskření (show 6) si nepamatuje jas z minulého snímku – jak to, že hvězdy
+   přesto plynule rozsvítí a zhasnou? (MyNoise.h, sparkle8)
+4) Proč hlava komety patří do endFrame() a ne do renderRange()?
+************************************************************/
+
+#ifndef MY_SHOWS_H
+#define MY_SHOWS_H
+
+#ifdef ARDUINO
+#include <Arduino.h>
+#else
+#include <stdint.h>   // překlad na PC (g++) bez Arduina
+#endif
+#include <string.h>
+
+#if defined(__AVR__)
+#include <avr/pgmspace.h>
+#define MYSHOWS_ROM        PROGMEM
+#define MYSHOWS_READ8(p)   pgm_read_byte(p)
+#else
+#define MYSHOWS_ROM
+#define MYSHOWS_READ8(p)   (*(p))
+#endif
+
+namespace MyShows {
+
+  struct Rgb { uint8_t r, g, b; };
+
+  // 256 barev (R, G, B) – plní ji Palette z MyPalette.h
+  typedef uint8_t PaletteLut[256][3];
+
+  // Zvuk pro audio varianty show; sketch ho plní před každým snímkem (mikrofon, FFT...)
+  struct AudioLevels {
+    uint8_t level;              // celková hlasitost 0..255
+    uint8_t bass, mid, treble;  // pásma 0..255
+    bool    beat;               // od minulého snímku přišel úder
+  };
+
+  // Pořadí bajtů v pásku: kde v trojici leží R, G a B
+  template<uint8_t R, uint8_t G, uint8_t B> struct Order {
+    enum : uint8_t { r = R, g = G, b = B };
+  };
+  typedef Order<0, 1, 2> OrderRGB;
+  typedef Order<1, 0, 2> OrderGRB;   // WS2812B (NEO_GRB)
+  typedef Order<1, 2, 0> OrderBRG;
+  typedef Order<2, 1, 0> OrderBGR;
+  typedef Order<0, 2, 1> OrderRBG;
+  typedef Order<2, 0, 1> OrderGBR;
+
+  // Úložiště pixelů: vlastní pole (PC, jiný ovladač) nebo cizí buffer (Adafruit)
+  template<uint16_t N> struct OwnPixels {
+    uint8_t bytes[N * 3];
+    OwnPixels() { memset(bytes, 0, sizeof(bytes)); }
+    uint8_t* data() { return bytes; }
+  };
+  struct ExternalPixels {
+    uint8_t* ptr = nullptr;
+    void attach(uint8_t* p) { ptr = p; }
+    uint8_t* data() { return ptr; }
+  };
+
+  // --- Rychlá 8bit aritmetika (bez dělení) ---
+  inline uint8_t scale8(uint8_t c, uint8_t s) { return (uint8_t)(((uint16_t)c * (s + 1)) >> 8); }
+  inline uint8_t div255(uint16_t x)           { return (uint8_t)((x + 1 + (x >> 8)) >> 8); }   // přesně x/255
+  inline uint8_t twoThirds(uint8_t x)         { return (uint8_t)(((uint16_t)x * 171) >> 8); }            // přesně x*2/3
+  inline uint8_t triangle(uint8_t phase)      { return (phase < 128) ? phase * 2 : (255 - phase) * 2; }   // 0..255..0
+
+  // Barevné kolo jako ve sketchích: 0..255 → R→G→B→R
+  inline Rgb wheel(uint8_t pos) {
+    pos = 255 - pos;
+    if (pos < 85)  return { (uint8_t)(255 - pos * 3), 0, (uint8_t)(pos * 3) };
+    if (pos < 170) { pos -= 85; return { 0, (uint8_t)(pos * 3), (uint8_t)(255 - pos * 3) }; }
+    pos -= 170;    return { (uint8_t)(pos * 3), (uint8_t)(255 - pos * 3), 0 };
+  }
+
+  namespace detail {
+    // Posloupnost 0..N-1 pro rozbalení tabulky při překladu (hloubka log N, bez STL)
+    template<uint16_t... I> struct Seq {};
+    template<class A, class B> struct Cat;
+    template<uint16_t... A, uint16_t... B> struct Cat<Seq<A...>, Seq<B...> > {
+      typedef Seq<A..., (uint16_t)(sizeof...(A) + B)...> type;
+    };
+    template<uint16_t N> struct MakeSeq {
+      typedef typename Cat<typename MakeSeq<N / 2>::type, typename MakeSeq<N - N / 2>::type>::type type;
+    };
+    template<> struct MakeSeq<0> { typedef Seq<> type; };
+    template<> struct MakeSeq<1> { typedef Seq<0> type; };
+
+    // Odstín pixelu v duze: i * 256 / N
+    template<uint16_t N, class S = typename MakeSeq<N>::type> struct HueTable;
+    template<uint16_t N, uint16_t... I> struct HueTable<N, Seq<I...> > {
+      static const uint8_t value[N];
+    };
+    template<uint16_t N, uint16_t... I>
+    const uint8_t HueTable<N, Seq<I...> >::value[N] MYSHOWS_ROM = { (uint8_t)((uint32_t)I * 256 / N)... };
+
+    constexpr uint8_t BASIC[6][3] MYSHOWS_ROM = {
+      { 255, 0, 0 }, { 0, 255, 0 }, { 0, 0, 255 }, { 255, 255, 0 }, { 255, 0, 255 }, { 0, 255, 255 }
+    };
+    constexpr uint8_t BLACK[3] = { 0, 0, 0 };
+    constexpr uint8_t PAL_SIZE = 5;
+    constexpr uint8_t PALETTE9[PAL_SIZE][3] MYSHOWS_ROM = {
+      { 0xFF, 0x55, 0x00 },   // oranž
+      { 0x00, 0xFF, 0x88 },   // zelenomodrá
+      { 0x33, 0x55, 0xFF },   // modrá
+      { 0xFF, 0x00, 0xAA },   // magenta
+      { 0xFF, 0xFF, 0x22 }    // žlutá
+    };
+  } // namespace detail
+
+} // namespace MyShows
+
+#include "MyNoise.h"   // plynulý šum pro jiskření (potřebuje scale8 a MYSHOWS_ROM výše)
+
+namespace MyShows {
+
+  // Jak jde show rozdělit mezi jádra (viz beginFrame / renderRange / endFrame)
+  enum Split : uint8_t {
+    SPLIT_PIXELS,   // každý pixel zvlášť, libovolné úseky paralelně
+    SPLIT_TAIL      // pixely paralelně + krátký sériový krok po bariéře (hlava komety, kapky deště)
+  };
+
+  template<uint16_t N, class ORDER = OrderGRB, class PIXELS = ExternalPixels>
+  class Engine {
+    static_assert(N >= 2, "MyShows: potřebuje aspoň 2 LED");
+    static_assert(N <= 0x5554, "MyShows: N * 3 se nevejde do uint16_t");
+
+  public:
+    static constexpr uint16_t COUNT         = N;
+    static constexpr uint8_t  SHOW_COUNT    = 9;
+    static constexpr uint8_t  MAX_DROPS     = 6;
+    static constexpr uint8_t  DROP_CYCLE    = 77;   // kapka: pauza 0..7 + život 30..69 snímků
+    static constexpr uint16_t TWINKLE_SPEED = 4;    // jiskra: 1/64 políčka šumu za snímek (~30 snímků na hvězdu)
+
+    PIXELS  pixels;
+    uint8_t brightness   = 255;
+    // Barvy, které si sketche upravovaly po svém
+    Rgb     cometColor   = { 255, 170, 0 };    // hlava komety (ocas = stejná barva slábnoucí)
+    Rgb     cometGlow    = { 0, 0, 10 };       // podklad pod kometou
+    Rgb     twinkleColor = { 170, 170, 255 };  // studená bílá jiskra
+    // Paleta (MyPalette.h): když není nullptr, duha, color wipe a palette pulse berou barvy z ní
+    const PaletteLut* palette = nullptr;
+    // Zvuk: když není nullptr, duha je VU metr, kometa zrychluje s basy a palette pulse pulzuje do rytmu
+    const AudioLevels* audio = nullptr;
+
+    Engine() { seed(1); select(1); }
+
+    void seed(uint32_t s) { rng = s ? s : 1; seedValue = rng; frameNo = 0; }
+
+    // Volba show 1..9 + vynulování jejího stavu
+    void select(uint8_t s) {
+      show = (s >= 1 && s <= SHOW_COUNT) ? s : 1;
+      step = 0;
+      memset(level, 0, sizeof(level));
+      cometPos = 0;
+      wipeIndex = 0; wipeColor = 0; wipeFirst = true;
+      scanPos = 0; scanDir = 1;
+      for (uint8_t i = 0; i < MAX_DROPS; i++) drops[i].life = 0;
+      theater = 0;
+      palIdx = 0; palTick = 0;
+      hueShift = 0; flash = 0;
+    }
+
+    uint8_t current() const { return show; }
+    uint16_t animStep() const { return step; }
+
+    // Skok: počítadla jako po seed() + select() a k× render() (bez zvuku).
+    // Dosvit komety a útlum deště se dorovnají během dalších ~100 render()
+    // – tak se k běžící show připojí další kontrolér (MySync).
+    void seek(uint32_t k) {
+      select(show);
+      step = (uint16_t)k;
+      frameNo = k;
+      theater = k % 3;
+      cometPos = k % N;
+      wipeIndex = k % N;
+      wipeColor = (k / N) % 6;
+      wipeFirst = k < N;
+      uint32_t p = (N > 1) ? k % (2 * (N - 1)) : 0;   // scanner: tam a zpět
+      scanPos = (uint16_t)(p <= N - 1 ? p : 2 * (N - 1) - p);
+      scanDir = (p < N - 1) ? 1 : -1;
+      palTick = k % 180;
+      palIdx = ((k + 179) / 180) % detail::PAL_SIZE;
+    }
+
+    // Pro paměť snímků (MyFrameCache.h):
+    // period() – po kolika krocích se snímky opakují; 0 = neopakují (kometa,
+    //            jiskření, déšť, palette pulse, se zvukem, color wipe v 1. kole)
+    //            nebo se nevyplatí je ukládat: theater chase, dýchání a scanner
+    //            se nakreslí rychleji, než by se snímek rozbalil a zkopíroval
+    // phase()  – kde v tom cyklu je příští snímek
+    // inputs() – otisk všeho ostatního, na čem snímek závisí: show, jas, N,
+    //            pořadí barev a obsah palety (ne ukazatel – tabulka se přepisuje)
+    uint32_t period() const {
+      if (audio) return 0;
+      switch (show) {
+        case 1: return 256;
+        case 5: return wipeFirst ? 0 : 6 * (uint32_t)N;
+        default: return 0;
+      }
+    }
+
+    uint32_t phase() const {
+      switch (show) {
+        case 1: return (uint8_t)step;
+        case 5: return (uint32_t)wipeColor * N + wipeIndex;
+        default: return 0;
+      }
+    }
+
+    uint32_t inputs() const {
+      uint32_t h = 2166136261UL;                  // FNV-1a
+      const uint8_t in[] = { show, brightness, (uint8_t)N, (uint8_t)(N >> 8), ORDER::r, ORDER::g, ORDER::b };
+      for (uint8_t i = 0; i < sizeof(in); i++) h = (h ^ in[i]) * 16777619UL;
+      if (palette && (show == 1 || show == 5)) {  // 768 B po 4 bajtech, ~1 µs na ESP32
+        const uint8_t* p = &(*palette)[0][0];
+        uint32_t w;
+        for (uint16_t i = 0; i < sizeof(PaletteLut); i += 4) {
+          memcpy(&w, p + i, 4);
+          h = (h ^ w) * 16777619UL;
+        }
+      }
+      return h;
+    }
+
+    // Snímek přišel z paměti, pixely už jsou v bufferu: jen posunout čítače
+    void skipFrame() { endFrame(); }
+
+    static Split split(uint8_t s) { return (s == 4 || s == 8) ? SPLIT_TAIL : SPLIT_PIXELS; }
+
+    // Jeden krok animace aktuální show do bufferu (strip.show() volá sketch)
+    void render() {
+      beginFrame();
+      renderRange(0, N);
+      endFrame();
+    }
+
+    // Snímek po částech (pro více jader):
+    //   beginFrame()           – jednou, sériově (společné barvy, nové kapky)
+    //   renderRange(from, to)  – úseky [from, to) se nesmí překrývat, můžou běžet souběžně
+    //   endFrame()             – jednou, až jsou všechny úseky hotové
+    // Výsledek je stejný jako render(), ať je úseků kolik chce.
+    void beginFrame() {
+      if (audio) takeAudio();
+      switch (show) {
+        case 2: solid(0, scale8(255, brightness), scale8(180, brightness), scale8(40, brightness)); break;
+        case 3: { uint8_t tri = triangle((uint8_t)step); solid(0, 0, scale8(twoThirds(tri), brightness), scale8(tri, brightness)); break; }
+        case 4:
+          glow = cometGlow;
+          if (audio) glow = { add8(glow.r, scale8(cometColor.r, flash >> 2)), add8(glow.g, scale8(cometColor.g, flash >> 2)),
+                              add8(glow.b, scale8(cometColor.b, flash >> 2)) };   // záblesk na úder
+          solid(0, scale8(glow.r, brightness), scale8(glow.g, brightness), scale8(glow.b, brightness));
+          break;
+        case 8: spawnDrops(); break;
+        case 9: paletteColors(); break;
+      }
+    }
+
+    void renderRange(uint16_t from, uint16_t to) {
+      if (to > N) to = N;
+      if (from >= to) return;
+      switch (show) {
+        case 1: rainbow(from, to);      break;
+        case 2: theaterChase(from, to); break;
+        case 3: fillRange(from, to, frameColor[0]); break;
+        case 4: comet(from, to);        break;
+        case 5: colorWipe(from, to);    break;
+        case 6: twinkle(from, to);      break;
+        case 7: scanner(from, to);      break;
+        case 8: rainFade(from, to);     break;
+        case 9: palettePulse(from, to); break;
+      }
+    }
+
+    void endFrame() {
+      switch (show) {
+        case 2: theater = (theater == 2) ? 0 : theater + 1; break;
+        case 4: {
+          uint8_t moves = audio ? 1 + (au.bass >> 6) : 1;   // se zvukem 1..4 LED za snímek
+          while (moves--) {
+            level[cometPos] = 255;                  // hlava se ukáže v dalším kroku
+            cometPos = (cometPos + 1 == N) ? 0 : cometPos + 1;
+          }
+          break;
+        }
+        case 5:
+          if (++wipeIndex >= N) {
+            wipeIndex = 0;
+            wipeColor = (wipeColor == 5) ? 0 : wipeColor + 1;
+            wipeFirst = false;
+          }
+          break;
+        case 7:
+          scanPos += scanDir;
+          if (scanPos == 0 || scanPos >= N - 1) scanDir = -scanDir;
+          break;
+        case 8: rainDrops(); break;
+        case 9:
+          if (audio) {                              // další barva na každý úder
+            if (au.beat) palIdx = (palIdx + 1 == detail::PAL_SIZE) ? 0 : palIdx + 1;
+            break;
+          }
+          if (palTick == 0) palIdx = (palIdx + 1 == detail::PAL_SIZE) ? 0 : palIdx + 1;   // každých 180 kroků
+          palTick = (palTick == 179) ? 0 : palTick + 1;
+          break;
+      }
+      if (audio) hueShift += 1 + (au.bass >> 5);   // duha se zvukem: basy ji roztáčí
+      step++;
+      frameNo++;
+    }
+
+    void clear() { memset(pixels.data(), 0, N * 3); }
+
+    // Zápis jednoho pixelu s jasem a pořadím bajtů
+    void set(uint16_t i, uint8_t r, uint8_t g, uint8_t b) {
+      uint8_t* p = pixels.data() + i * 3;
+      p[ORDER::r] = scale8(r, brightness);
+      p[ORDER::g] = scale8(g, brightness);
+      p[ORDER::b] = scale8(b, brightness);
+    }
+    void set(uint16_t i, const Rgb& c) { set(i, c.r, c.g, c.b); }
+
+  private:
+    // ---------- Show 1: Rainbow Cycle ----------
+    void rainbow(uint16_t from, uint16_t to) {
+      const uint8_t* hue = detail::HueTable<N>::value;
+      uint8_t shift = (uint8_t)step;
+      if (audio) {                                // VU metr: svítí jen prvních litCount LED
+        shift = hueShift;
+        uint16_t lit = (litCount < from) ? from : (litCount > to ? to : litCount);
+        fillRange(lit, to, detail::BLACK);
+        to = lit;
+      }
+      if (palette) {                              // jedno čtení z tabulky místo wheel()
+        const PaletteLut& lut = *palette;
+        for (uint16_t i = from; i < to; i++) {
+          const uint8_t* c = lut[(uint8_t)(MYSHOWS_READ8(&hue[i]) + shift)];
+          set(i, c[0], c[1], c[2]);
+        }
+        return;
+      }
+      for (uint16_t i = from; i < to; i++) set(i, wheel((uint8_t)(MYSHOWS_READ8(&hue[i]) + shift)));
+    }
+
+    // ---------- Show 2: Theater Chase (každá 3. LED) ----------
+    void theaterChase(uint16_t from, uint16_t to) {
+      uint8_t k = (uint8_t)((from + 3 - theater) % 3);   // jedno dělení na úsek, ne na pixel
+      const uint8_t* on = frameColor[0];
+      uint8_t* p = pixels.data() + from * 3;
+      for (uint16_t i = from; i < to; i++, p += 3) {
+        if (k == 0) { p[0] = on[0]; p[1] = on[1]; p[2] = on[2]; }
+        else        { p[0] = 0; p[1] = 0; p[2] = 0; }
+        k = (k == 2) ? 0 : k + 1;
+      }
+    }
+
+    // ---------- Show 3: Breathing (azurová) – barva je spočítaná v beginFrame ----------
+
+    // ---------- Show 4: Comet (SPLIT_TAIL: hlava v endFrame) ----------
+    void comet(uint16_t from, uint16_t to) {
+      const uint8_t* bg = frameColor[0];          // většina pásku je jen podklad
+      uint8_t* p = pixels.data() + from * 3;
+      for (uint16_t i = from; i < to; i++, p += 3) {
+        uint8_t v = level[i] = (level[i] > 5) ? level[i] - 5 : 0;
+        if (v == 0) { p[0] = bg[0]; p[1] = bg[1]; p[2] = bg[2]; continue; }
+        set(i, add8(glow.r, scale8(cometColor.r, v)),
+               add8(glow.g, scale8(cometColor.g, v)),
+               add8(glow.b, scale8(cometColor.b, v)));
+      }
+    }
+
+    // ---------- Show 5: Color Wipe (6 barev dokola) ----------
+    void colorWipe(uint16_t from, uint16_t to) {
+      uint8_t prev = (wipeColor == 0) ? 5 : wipeColor - 1;
+      Rgb now = wipeRgb(wipeColor), old = wipeRgb(prev);
+      for (uint16_t i = from; i < to; i++) {
+        if (i <= wipeIndex)  set(i, now);
+        else if (wipeFirst)  set(i, 0, 0, 0);
+        else                 set(i, old);
+      }
+    }
+
+    // ---------- Show 6: Twinkle ----------
+    // Jas hvězdy = vrcholek plynulého šumu v čase (MyNoise.h), žádný random() ani
+    // paměť: pixel závisí jen na (seed, snímek, i), takže nezáleží na počtu jader / úseků.
+    void twinkle(uint16_t from, uint16_t to) {
+      uint16_t t = (uint16_t)(frameNo * TWINKLE_SPEED + seedValue);
+      uint16_t row = (uint16_t)(seedValue >> 16);   // jiný seed = jiné hvězdy
+      for (uint16_t i = from; i < to; i++) {
+        uint8_t v = sparkle8(t, (uint16_t)(i + row));
+        set(i, scale8(twinkleColor.r, v), scale8(twinkleColor.g, v), scale8(twinkleColor.b, v));
+      }
+    }
+
+    // ---------- Show 7: Larson Scanner ----------
+    void scanner(uint16_t from, uint16_t to) {
+      memset(pixels.data() + from * 3, 0, (to - from) * 3);
+      if (scanPos >= from && scanPos < to) set(scanPos, 255, 30, 30);
+      if (scanPos > 0 && scanPos - 1 >= from && scanPos - 1 < to) set(scanPos - 1, 120, 10, 10);
+      if (scanPos + 1 < N && scanPos + 1 >= from && scanPos + 1 < to) set(scanPos + 1, 120, 10, 10);
+    }
+
+    // ---------- Show 8: Rain (SPLIT_TAIL: kapky v endFrame) ----------
+    // Kapka d má vlastní cykly po DROP_CYCLE snímcích (navzájem posunuté);
+    // začátek, místo a délka v cyklu jsou náhoda z (seed, d, cyklus). Kapky jsou
+    // tak jen funkce čísla snímku: po seek() a na jiném kontroléru stejné.
+    void spawnDrops() {
+      for (uint8_t d = 0; d < MAX_DROPS; d++) {
+        uint32_t t = frameNo + (uint32_t)d * DROP_CYCLE / MAX_DROPS;
+        uint32_t cycle = t / DROP_CYCLE;
+        uint8_t at = (uint8_t)(t % DROP_CYCLE);
+        rng = (seedValue ^ (cycle * 2654435761UL) ^ ((uint32_t)d << 27)) | 1;
+        next();
+        uint8_t start = rand8() & 7;
+        uint8_t life = 30 + randBelow(40);
+        uint16_t pos = randBelow(N);
+        if (at < start || at >= start + life) { drops[d].life = 0; continue; }
+        drops[d].pos = (uint16_t)((pos + at - start) % N);
+        drops[d].life = start + life - at;
+      }
+    }
+
+    void rainFade(uint16_t from, uint16_t to) {
+      // buffer už je vynásobený jasem, tak i útlum násobíme jasem
+      uint8_t f = scale8(5, brightness);
+      if (f == 0) f = 1;
+      uint8_t* p = pixels.data();
+      for (uint16_t i = from * 3; i < to * 3; i++) p[i] = (p[i] > f) ? p[i] - f : 0;
+    }
+
+    void rainDrops() {
+      for (uint8_t d = 0; d < MAX_DROPS; d++) {
+        if (!drops[d].life) continue;
+        set(drops[d].pos, 40, 0, 200);
+        drops[d].pos = (drops[d].pos + 1 == N) ? 0 : drops[d].pos + 1;
+        drops[d].life--;
+      }
+    }
+
+    // ---------- Show 9: Palette Pulse ----------
+    // Jas pixelu závisí jen na i % 8, takže stačí spočítat 8 barev za snímek.
+    void paletteColors() {
+      uint8_t br = audio ? au.bass : triangle((uint8_t)step);
+      uint8_t r, g, b;
+      if (palette) {                              // 5 barev rovnoměrně po paletě: 0, 51, ..., 204
+        const uint8_t* c = (*palette)[palIdx * 51];
+        r = c[0]; g = c[1]; b = c[2];
+      } else {
+        const uint8_t* base = detail::PALETTE9[palIdx];
+        r = MYSHOWS_READ8(&base[0]); g = MYSHOWS_READ8(&base[1]); b = MYSHOWS_READ8(&base[2]);
+      }
+      for (uint8_t k = 0; k < 8; k++) {
+        uint8_t local = div255((uint16_t)br * (uint8_t)(k * 8 + 192));
+        solid(k, scale8(div255((uint16_t)r * local), brightness),
+                 scale8(div255((uint16_t)g * local), brightness),
+                 scale8(div255((uint16_t)b * local), brightness));
+      }
+    }
+
+    void palettePulse(uint16_t from, uint16_t to) {
+      uint8_t* p = pixels.data() + from * 3;
+      for (uint16_t i = from; i < to; i++, p += 3) {
+        const uint8_t* x = frameColor[i & 7];
+        p[0] = x[0]; p[1] = x[1]; p[2] = x[2];
+      }
+    }
+
+    // ---------- pomocné ----------
+    // Barva pro celý snímek, už v pořadí bajtů pásku a s jasem
+    void solid(uint8_t slot, uint8_t r, uint8_t g, uint8_t b) {
+      frameColor[slot][ORDER::r] = r; frameColor[slot][ORDER::g] = g; frameColor[slot][ORDER::b] = b;
+    }
+
+    void fillRange(uint16_t from, uint16_t to, const uint8_t* px) {
+      uint8_t* p = pixels.data() + from * 3;
+      for (uint16_t i = from; i < to; i++, p += 3) { p[0] = px[0]; p[1] = px[1]; p[2] = px[2]; }
+    }
+
+    // Zvuk jednou za snímek: všechny úseky (jádra) pak kreslí se stejnými hodnotami
+    void takeAudio() {
+      au = *audio;
+      litCount = (uint16_t)(((uint32_t)N * au.level + 254) / 255);   // 255 = celý pásek
+      flash = au.beat ? 255 : (flash > 32 ? flash - 32 : 0);
+    }
+
+    static uint8_t add8(uint8_t a, uint8_t b) { uint16_t s = a + b; return s > 255 ? 255 : (uint8_t)s; }
+
+    static Rgb basic(uint8_t idx) {
+      return { MYSHOWS_READ8(&detail::BASIC[idx][0]), MYSHOWS_READ8(&detail::BASIC[idx][1]), MYSHOWS_READ8(&detail::BASIC[idx][2]) };
+    }
+
+    // 6 barev color wipe: BASIC, nebo 6 míst palety (0, 43, ..., 215)
+    Rgb wipeRgb(uint8_t idx) const {
+      if (!palette) return basic(idx);
+      const uint8_t* c = (*palette)[idx * 43];
+      return { c[0], c[1], c[2] };
+    }
+
+    // xorshift32: rychlejší než random() a stejný průběh při stejném seed()
+    uint8_t rand8() { return (uint8_t)(next() >> 24); }
+    uint16_t randBelow(uint16_t n) { return (uint16_t)(((next() >> 16) * (uint32_t)n) >> 16); }
+    uint32_t next() { rng ^= rng << 13; rng ^= rng >> 17; rng ^= rng << 5; return rng; }
+
+    uint8_t  show;
+    uint16_t step;
+    uint32_t rng;
+    uint32_t seedValue;
+    uint32_t frameNo;           // nenuluje se při select(), jen při seed()
+    uint8_t  frameColor[8][3];  // barvy spočítané v beginFrame (pořadí pásku, s jasem)
+    uint8_t  level[N];          // dosvit komety
+    uint16_t cometPos;
+    uint16_t wipeIndex;
+    uint8_t  wipeColor;
+    bool     wipeFirst;         // první kolo: zbytek pásku je zhasnutý
+    uint16_t scanPos;
+    int8_t   scanDir;
+    struct Drop { uint16_t pos; uint8_t life; };
+    Drop     drops[MAX_DROPS];
+    uint8_t  theater;
+    uint8_t  palIdx, palTick;
+    Rgb      glow;              // podklad komety v tomto snímku (se zábleskem)
+    AudioLevels au;             // zvuk převzatý v beginFrame
+    uint16_t litCount;          // duha se zvukem: kolik LED svítí
+    uint8_t  hueShift;          // duha se zvukem: posun odstínu
+    uint8_t  flash;             // kometa se zvukem: záblesk po úderu, slábne
+  };
+
+} // namespace MyShows
+
+#endif // MY_SHOWS_H
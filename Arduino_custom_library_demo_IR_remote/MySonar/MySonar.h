@@ -0,0 +1,237 @@
+/************************************************************
+MySonar.h — víc ultrazvukových senzorů (HC-SR04) bez pulseIn()
+
+CO TO JE:
+- pulseIn() čeká na ozvěnu až 30 ms a sketch k tomu přidával delay(200):
+  jeden senzor, asi 4 měření za sekundu a Arduino mezitím stojí.
+- Tady senzory pípají jeden po druhém (round robin) v pevných slotech.
+  Délku ozvěny měří přerušení na hranách pinu ECHO (pin change), loop()
+  jen jednou za slot zavolá poll() – ten převezme výsledek a odpálí
+  další senzor. Nic nečeká.
+- Slot (16 ms) je delší než cesta zvuku tam a zpět na maxMm (2,5 m =
+  14,6 ms), takže senzor neslyší cizí pípnutí (crosstalk). 4 senzory ×
+  16 ms = 64 ms → každý senzor 15,6× za sekundu.
+- Filtr: medián z posledních 5 měření. Hodnota, která od mediánu uletí
+  o víc než jumpMm, se zahodí; když přijde 3× za sebou, předmět se
+  opravdu pohnul a filtr začne znovu. 3 výpadky za sebou = „bez ozvěny“.
+- Rychlost zvuku podle teploty: 331,3 + 0,606 × T m/s (při 0 °C a 30 °C
+  je rozdíl 5 %, tedy 5 cm na metr).
+- Piny jsou parametr šablony: na Arduinu PinIO, na PC libovolná třída se
+  stejnými třemi funkcemi (simulované ozvěny).
+
+POUŽITÍ:
+  const uint8_t TRIG[] = { 9, 5 }, ECHO[] = { 10, 11 };
+  MySonar::PinIO io(TRIG, ECHO, 2);
+  MySonar::Ranger<MySonar::PinIO, 2> sonar(io);
+  ISR(PCINT0_vect) { sonar.onEdge(micros()); }          // AVR: ECHO na 8–13 (Uno), 8–11 (Leonardo)
+  // ESP32: attachInterrupt(ECHO[i], isr, CHANGE) a v isr totéž
+  setup(): sonar.begin(micros());
+  loop():  if (sonar.poll(micros())) { ... sonar.distanceMm(i), sonar.valid(i) ... }
+           ... poll() volej aspoň jednou za slot (16 ms), jinak jen klesne počet měření
+
+Úkoly:
+1) Proč se další senzor nespustí hned, jak přijde ozvěna toho předchozího?
+2) Změř vzdálenost v zimě na chodbě a v teple. Co udělá setTemperature()?
+3) Proč je na uletěné hodnoty lepší medián než průměr?
+************************************************************/
+
+#ifndef MY_SONAR_H
+#define MY_SONAR_H
+
+#ifdef ARDUINO
+#include <Arduino.h>
+#else
+#include <stdint.h>   // překlad na PC (g++) bez Arduina
+#endif
+
+namespace MySonar {
+
+  constexpr uint8_t  WINDOW       = 5;      // medián z kolika měření
+  constexpr uint8_t  OUTLIER_RUN  = 3;      // tolikrát „uletěná“ hodnota za sebou = opravdový pohyb
+  constexpr uint8_t  MISS_LIMIT   = 3;      // tolik výpadků za sebou = bez ozvěny
+  constexpr uint32_t TRIGGER_US   = 10;     // délka pulzu TRIG (HC-SR04)
+
+  // mm na µs ozvěny × 65536 (zvuk jde tam a zpět, proto / 2); teplota v desetinách °C
+  inline uint32_t mmPerUsQ16(int16_t deciC) {
+    int32_t speed = 331300L + 606L * deciC / 10;            // mm/s
+    return (uint32_t)((speed * 4096L + 62500L) / 125000L);   // speed × 65536 / 2 000 000
+  }
+
+  // Medián s odmítáním odlehlých hodnot pro jeden senzor
+  class MedianFilter {
+  public:
+    uint16_t jumpMm = 300;      // větší skok od mediánu = podezřelé měření
+
+    // Nové měření; false = zahozeno jako odlehlé
+    bool push(uint16_t mm) {
+      misses = 0;
+      if (count > 0 && diff(mm, median) > jumpMm) {
+        if (++outliers < OUTLIER_RUN) return false;
+        count = 0;                                       // předmět se pohnul – začni znovu
+      }
+      outliers = 0;
+      window[head] = mm;
+      head = (head + 1) % WINDOW;
+      if (count < WINDOW) count++;
+      median = computeMedian();
+      return true;
+    }
+
+    // Ozvěna nepřišla (nebo byla dál než maxMm)
+    void miss() {
+      if (misses < 255) misses++;
+      if (misses >= MISS_LIMIT) { count = 0; outliers = 0; }
+    }
+
+    bool     valid() const { return count > 0; }
+    uint16_t value() const { return valid() ? median : 0; }
+    uint8_t  missRun() const { return misses; }
+
+  private:
+    static uint16_t diff(uint16_t a, uint16_t b) { return a > b ? a - b : b - a; }
+
+    // Poslední count hodnot seřadit (max. 5 → vkládání stačí)
+    uint16_t computeMedian() const {
+      uint16_t s[WINDOW];
+      for (uint8_t i = 0; i < count; i++) {
+        uint16_t v = window[(head + WINDOW - 1 - i) % WINDOW];
+        uint8_t k = i;
+        for (; k > 0 && s[k - 1] > v; k--) s[k] = s[k - 1];
+        s[k] = v;
+      }
+      return s[count / 2];
+    }
+
+    uint16_t window[WINDOW] = {};
+    uint8_t  head = 0, count = 0, outliers = 0, misses = 0;
+    uint16_t median = 0;
+  };
+
+#ifdef ARDUINO
+  // Piny na Arduinu. ECHO se čte přímo z registru portu – v přerušení je to rychlejší než digitalRead()
+  class PinIO {
+  public:
+    PinIO(const uint8_t* trigPins, const uint8_t* echoPins, uint8_t n) : trig(trigPins), echoPin(echoPins), count(n) {}
+
+    void begin() {
+      for (uint8_t i = 0; i < count; i++) {
+        pinMode(trig[i], OUTPUT);
+        digitalWrite(trig[i], LOW);
+        pinMode(echoPin[i], INPUT);
+#if defined(__AVR__)
+        // Pin change přerušení pro ECHO (ISR si napíše sketch, viz POUŽITÍ)
+        uint8_t p = echoPin[i];
+        if (digitalPinToPCICR(p)) {
+          *digitalPinToPCICR(p) |= _BV(digitalPinToPCICRbit(p));
+          *digitalPinToPCMSK(p) |= _BV(digitalPinToPCMSKbit(p));
+        }
+#endif
+      }
+    }
+
+    void trigger(uint8_t i) {
+      digitalWrite(trig[i], HIGH);
+      delayMicroseconds(TRIGGER_US);
+      digitalWrite(trig[i], LOW);
+    }
+
+    bool echo(uint8_t i) const {
+#if defined(__AVR__)
+      uint8_t p = echoPin[i];
+      return *portInputRegister(digitalPinToPort(p)) & digitalPinToBitMask(p);
+#else
+      return digitalRead(echoPin[i]) == HIGH;
+#endif
+    }
+
+  private:
+    const uint8_t* trig;
+    const uint8_t* echoPin;
+    uint8_t count;
+  };
+#endif
+
+  // Plánovač: N senzorů po sobě v pevných slotech, délka ozvěny z přerušení
+  template<class IO, uint8_t N>
+  class Ranger {
+  public:
+    uint32_t slotUs = 16000;    // rozestup pípnutí; N × slotUs = perioda jednoho senzoru
+    uint16_t maxMm  = 2500;     // delší ozvěna = výpadek (musí se vejít do slotUs)
+
+    explicit Ranger(IO& io) : io(io) { setTemperature(200); }
+
+    // Teplota vzduchu v desetinách °C (200 = 20,0 °C)
+    void setTemperature(int16_t deciC) { k = mmPerUsQ16(deciC); }
+
+    // Nejdelší ozvěna, která se ještě počítá (maxMm při dané teplotě)
+    uint32_t maxEchoUs() const { return ((uint32_t)maxMm << 16) / k; }
+
+    void begin(uint32_t nowUs) {
+      io.begin();
+      cur = N - 1;                   // první poll() spustí senzor 0
+      phase = IDLE;
+      slotStart = nowUs - slotUs;
+    }
+
+    // Z loop(). Na konci slotu převezme výsledek, odpálí další senzor a vrátí true –
+    // pak je celý slot volno (třeba na zápis na LCD).
+    bool poll(uint32_t nowUs) {
+      if (nowUs - slotStart < slotUs) return false;
+      finish();
+      cur = (cur + 1) % N;           // ISR teď ignoruje (phase == IDLE)
+      slotStart = nowUs;
+      if (io.echo(cur)) {            // ECHO ještě drží z minula – tohle měření nepůjde
+        phase = STUCK;
+      } else {
+        phase = WAIT_RISE;
+        io.trigger(cur);
+      }
+      return true;
+    }
+
+    // Z přerušení při změně kteréhokoli pinu ECHO
+    void onEdge(uint32_t nowUs) {
+      uint8_t ph = phase;
+      if (ph != WAIT_RISE && ph != WAIT_FALL) return;
+      bool high = io.echo(cur);
+      if (ph == WAIT_RISE && high)      { rise = nowUs; phase = WAIT_FALL; }
+      else if (ph == WAIT_FALL && !high) { fall = nowUs; phase = DONE; }
+    }
+
+    bool     valid(uint8_t i) const      { return filters[i].valid(); }
+    uint16_t distanceMm(uint8_t i) const { return filters[i].value(); }
+    uint16_t rawMm(uint8_t i) const      { return raw[i]; }         // poslední měření bez filtru (0 = výpadek)
+    uint32_t count(uint8_t i) const      { return seq[i]; }         // kolikrát byl senzor změřen
+    uint8_t  lastSensor() const          { return last; }           // čí výsledek převzal poslední poll()
+    MedianFilter& filter(uint8_t i)      { return filters[i]; }
+
+  private:
+    enum : uint8_t { IDLE, WAIT_RISE, WAIT_FALL, DONE, STUCK };
+
+    void finish() {
+      uint8_t ph = phase;
+      phase = IDLE;
+      if (ph == IDLE) return;
+      last = cur;
+      seq[cur]++;
+      uint32_t us = (ph == DONE) ? fall - rise : 0;              // fall a rise se po DONE už nemění
+      uint16_t mm = (us <= maxEchoUs()) ? (uint16_t)((us * k + 32768) >> 16) : 0;
+      raw[cur] = mm;
+      if (mm == 0) filters[cur].miss();
+      else filters[cur].push(mm);
+    }
+
+    IO& io;
+    uint32_t k = 0;
+    uint32_t slotStart = 0;
+    volatile uint8_t cur = 0, phase = IDLE;
+    volatile uint32_t rise = 0, fall = 0;
+    uint8_t  last = 0;
+    uint16_t raw[N] = {};
+    uint32_t seq[N] = {};
+    MedianFilter filters[N];
+  };
+
+} // namespace MySonar
+
+#endif // MY_SONAR_H
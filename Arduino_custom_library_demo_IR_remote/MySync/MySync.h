@@ -0,0 +1,406 @@
+/************************************************************
+MySync.h — víc kontrolérů podél pódia, jeden takt (ESP-NOW)
+
+CO TO JE:
+- Každý kontrolér počítá kroky show ze svého millis(). Krystaly se liší
+  o desítky ppm (30 ppm = 108 ms za hodinu), takže stejné show na dvou
+  páscích se za pár minut viditelně rozejdou.
+- Master (jeden ve skupině) posílá každých 100 ms beacon: svůj čas v µs
+  a stav show. Followeři z beaconů odhadují, o kolik a jak rychle se
+  jejich hodiny liší (Clock), a počítají „sdílený čas“ = čas mastera.
+- Krok show se pak nepočítá, ale odvodí:
+    krok = (sdílený čas − epoch) / stepMs     (stepAt)
+  epoch = sdílený čas, kdy show začala. Stejný krok + stejný seed =
+  stejný snímek na všech páscích ve stejnou chvíli.
+- Clock: rádio beacon zpozdí (0,3 až desítky ms – fronta, opakování),
+  nikdy ale nepřijde dřív. Z každého okna (window = 5 beaconů) se proto
+  bere ten nejméně zpožděný a přímka přes posledních 16 takových bodů
+  dá posun i rozdíl rychlosti hodin (drift v ppb). Mezi beacony a když
+  nějaké chybí, jede se podle přímky.
+- State = show, jas, rychlost, barva, 3 parametry, epoch, seed a verze.
+  Změnit ho může kdokoli (IR, web): publish() zvýší verzi a rozešle stav
+  všem (COMMAND, 3× po 20 ms). Platí vyšší verze, při shodě vyšší id.
+  Master posílá stav v každém beaconu – kdo ztratil příkaz, dorovná se,
+  a kdo má novější stav než beacon (master ho neslyšel), pošle ho znovu.
+- Zpráva (Packet) má 48 bajtů; kontroluje se magic, verze protokolu,
+  délka a skupina (víc pódií vedle sebe). Pořadí bajtů little endian
+  (ESP32 i PC).
+- Node nepotřebuje rádio ani Arduino: jde přeložit na PC a vyzkoušet
+  se ztrátami a zpožděním. Radio (jen ESP32) je esp_now s broadcastem
+  na FF:FF:FF:FF:FF:FF; callback jen označí čas příjmu a uloží zprávu
+  do fronty, zpracuje ji až loop() / úloha.
+
+POUŽITÍ:
+  MySync::Node sync;
+  MySync::Radio radio;
+  setup():  WiFi.mode(WIFI_STA);        // kanál stejný na všech kontrolérech
+            sync.begin(MySync::FOLLOWER, 1, radio.begin(WIFI_IF_STA));
+  loop():   uint64_t t = esp_timer_get_time();
+            MySync::Packet p; uint64_t at;
+            while (radio.read(p, at)) if (sync.receive(p, at)) { ...převezmi sync.state()... }
+            while (sync.poll(t, p)) radio.send(p);
+            if (sync.ready()) krok = MySync::stepAt(sync.state(), sync.now(t));
+  změna:    MySync::State s = sync.state();
+            s.show = 3; s.epochUs = sync.now(t); s.seed = esp_random();
+            sync.publish(s, t);
+
+Úkoly:
+1) Proč se z okna beaconů bere ten s NEJVĚTŠÍM rozdílem (čas mastera −
+   místní čas), a ne průměr?
+2) Master se restartuje (jeho čas začne od nuly). Co udělá Clock
+   followera a jak se opraví epoch show?
+3) Dva kontroléry změní show ve stejnou chvíli. Která změna vyhraje
+   a uvidí ji všichni?
+************************************************************/
+
+#ifndef MY_SYNC_H
+#define MY_SYNC_H
+
+#ifdef ARDUINO
+#include <Arduino.h>
+#else
+#include <stdint.h>    // překlad na PC (g++) bez Arduina
+#include <string.h>
+#endif
+
+#if defined(ESP32)
+#include <esp_now.h>
+#include <esp_wifi.h>
+#include <esp_timer.h>
+#include <esp_arduino_version.h>
+#endif
+
+namespace MySync {
+
+  constexpr uint8_t MAGIC = 0x53;      // 'S'
+  constexpr uint8_t PROTO = 1;         // verze formátu zprávy
+
+  enum Role : uint8_t { OFF, MASTER, FOLLOWER };
+  enum Kind : uint8_t { BEACON = 1, COMMAND = 2 };
+
+  // Co mají všechny pásky ukazovat
+  struct __attribute__((packed)) State {
+    uint32_t version;      // roste s každou změnou
+    uint32_t origin;       // id kontroléru, který změnu udělal
+    uint64_t epochUs;      // sdílený čas kroku 0
+    uint32_t seed;         // náhoda show (oheň, jiskry) – všude stejná
+    uint16_t stepMs;       // délka kroku
+    uint8_t  show;
+    uint8_t  brightness;
+    uint8_t  rgb[3];       // základní barva
+    uint8_t  param[3];     // podle projektu (paleta, míchání, ...)
+  };
+
+  struct __attribute__((packed)) Packet {
+    uint8_t  magic, proto, kind, group;
+    uint32_t from;         // id odesílatele
+    uint16_t seq;          // číslo zprávy (ztráty beaconů)
+    uint64_t timeUs;       // BEACON: čas mastera při odeslání
+    State    state;
+  };
+
+  // Je a novější než b? (vyšší verze, při shodě vyšší id)
+  inline bool newer(const State& a, const State& b) {
+    return a.version != b.version ? a.version > b.version : a.origin > b.origin;
+  }
+
+  // Krok show ve sdíleném čase (před epoch = 0)
+  inline uint32_t stepAt(const State& s, uint64_t sharedUs) {
+    if (sharedUs <= s.epochUs || s.stepMs == 0) return 0;
+    return (uint32_t)((sharedUs - s.epochUs) / (s.stepMs * 1000ULL));
+  }
+
+  // Sdílený čas začátku kroku k
+  inline uint64_t stepStart(const State& s, uint32_t k) {
+    return s.epochUs + (uint64_t)k * s.stepMs * 1000ULL;
+  }
+
+  // Jiná rychlost bez skoku: krok, na kterém show právě je, začne teď
+  inline void rebase(State& s, uint16_t stepMs, uint64_t sharedUs) {
+    if (stepMs == 0) stepMs = 1;
+    uint64_t k = stepAt(s, sharedUs);
+    uint64_t back = k * stepMs * 1000ULL;
+    s.stepMs = stepMs;
+    s.epochUs = sharedUs >= back ? sharedUs - back : sharedUs % (stepMs * 1000ULL);
+  }
+
+  // Bajty z rádia → zpráva; false = cizí nebo poškozená
+  inline bool decode(const uint8_t* data, int len, Packet& p) {
+    if (len != (int)sizeof(Packet)) return false;
+    memcpy(&p, data, sizeof(p));
+    return p.magic == MAGIC && p.proto == PROTO && (p.kind == BEACON || p.kind == COMMAND);
+  }
+
+  // Odhad času mastera z beaconů: posun + drift (přímka)
+  class Clock {
+  public:
+    uint8_t  window = 10;         // beaconů na jeden bod (vyhrává nejméně zpožděný)
+    uint32_t resetUs = 50000;     // bod dál od přímky = master startoval znovu
+    int32_t  delayUs = 0;         // pevné zpoždění rádia, když je změřené
+    uint32_t rejectUs = 300;      // bod víc pod přímkou se nepočítá (zpožděné okno)
+
+    // Beacon: čas mastera při odeslání, místní čas při příjmu
+    void sample(uint64_t masterUs, uint64_t localUs) {
+      int64_t off = (int64_t)(masterUs + delayUs) - (int64_t)localUs;   // posun − zpoždění
+      if (inWin == 0 || off > bestOff) { bestOff = off; bestL = localUs; }
+      if (++inWin < window) return;
+      inWin = 0;
+      if (n) {
+        int64_t err = bestOff - (int64_t)(now(bestL) - bestL);
+        if (err > (int64_t)resetUs || err < -(int64_t)resetUs) { restarts++; n = 0; }
+        else lastErr = (int32_t)err;
+      }
+      if (n == 0) lastErr = 0;
+      head = (uint8_t)((head + 1) % POINTS);
+      ptL[head] = bestL;
+      ptOff[head] = bestOff;
+      if (n < POINTS) n++;
+      fit();
+    }
+
+    bool synced() const { return n >= 2; }
+    // Čas mastera v místní chvíli localUs (bez synchronizace = localUs)
+    uint64_t now(uint64_t localUs) const {
+      if (n == 0) return localUs;
+      int64_t dl = (int64_t)(localUs - refL);
+      return localUs + a + dl * drift / 1000000000LL;
+    }
+    int32_t driftPpb() const { return (int32_t)drift; }   // + = master běží rychleji
+    int32_t lastErrorUs() const { return lastErr; }        // bod proti předchozí přímce
+    uint32_t restartCount() const { return restarts; }
+    void reset() { n = 0; inWin = 0; lastErr = 0; drift = 0; }
+
+  private:
+    static constexpr uint8_t POINTS = 32;
+
+    // Nejmenší čtverce přes body (double jen tady, jednou za okno). Druhý
+    // průchod vynechá body hluboko pod přímkou: celé okno přišlo pozdě.
+    void fit() {
+      const uint8_t last = head;
+      refL = ptL[last];
+      a = ptOff[last];
+      if (n < 2) { drift = 0; return; }
+      double alpha = 0, b = 0;
+      for (uint8_t pass = 0; pass < 2; pass++) {
+        double sx = 0, sy = 0, sxx = 0, sxy = 0, m = 0;
+        for (uint8_t k = 0; k < n; k++) {
+          uint8_t i = (uint8_t)((last + POINTS - k) % POINTS);
+          double x = (double)(int64_t)(ptL[i] - refL);
+          double y = (double)(ptOff[i] - ptOff[last]);
+          if (pass && y - (alpha + b * x) < -(double)rejectUs) continue;
+          sx += x; sy += y; sxx += x * x; sxy += x * y; m++;
+        }
+        double d = m * sxx - sx * sx;
+        b = d > 0 ? (m * sxy - sx * sy) / d : 0;
+        if (b > 0.0005) b = 0.0005;               // krystaly se neliší o víc než 500 ppm
+        if (b < -0.0005) b = -0.0005;
+        alpha = m > 0 ? (sy - b * sx) / m : 0;
+      }
+      a = ptOff[last] + (int64_t)alpha;           // přímka v refL
+      drift = (int64_t)(b * 1e9);
+    }
+
+    uint64_t ptL[POINTS];
+    int64_t  ptOff[POINTS];
+    uint8_t  head = 0, n = 0;
+    uint8_t  inWin = 0;
+    int64_t  bestOff = 0;
+    uint64_t bestL = 0;
+    uint64_t refL = 0;
+    int64_t  a = 0;               // posun v refL (µs)
+    int64_t  drift = 0;           // ppb
+    int32_t  lastErr = 0;
+    uint32_t restarts = 0;
+  };
+
+  // Jeden kontrolér: role, sdílený stav, co poslat a kdy
+  class Node {
+  public:
+    uint16_t beaconMs = 100;      // master: perioda beaconů
+    uint8_t  repeats = 3;         // COMMAND se pošle 3×
+    uint16_t repeatMs = 20;
+    Clock clock;
+
+    void begin(Role r, uint8_t group, uint32_t id) {
+      rl = r;
+      grp = group;
+      self = id;
+      pending = 0;
+      repairDue = false;
+      clock.reset();
+    }
+
+    Role role() const { return rl; }
+    uint32_t id() const { return self; }
+    const State& state() const { return st; }
+    // Stav z uložených nastavení (po begin()): masterův platí pro skupinu (verze 1),
+    // follower ho má jen do prvního beaconu (verze 0)
+    void restore(const State& s) { st = s; st.version = (rl == MASTER) ? 1 : 0; st.origin = self; }
+
+    // Sdílený čas (master: vlastní hodiny)
+    uint64_t now(uint64_t localUs) const { return rl == FOLLOWER ? clock.now(localUs) : localUs; }
+    bool ready() const { return rl == MASTER || (rl == FOLLOWER && clock.synced()); }
+
+    // Přijatá zpráva (a kdy přišla); true = platí nový stav, převezmi state()
+    bool receive(const Packet& p, uint64_t localUs) {
+      if (rl == OFF || p.group != grp || p.from == self) return false;
+      if (p.kind == BEACON) {
+        if (rl == MASTER) { conflicts++; return false; }   // dva mastery ve skupině
+        uint16_t gap = p.seq - lastSeq;
+        if (beacons && gap > 1 && gap < 1000) missed += gap - 1;   // větší skok = jiný / restartovaný master
+        lastSeq = p.seq;
+        beacons++;
+        lastBeaconUs = localUs;
+        clock.sample(p.timeUs, localUs);
+      } else {
+        commands++;
+      }
+      if (newer(p.state, st)) {
+        st = p.state;
+        // Po restartu mastera jsou staré epochy daleko v jeho budoucnosti: show znovu od teď
+        if (rl == MASTER && st.epochUs > localUs + 1000000ULL) {
+          st.epochUs = localUs;
+          st.version++;
+          st.origin = self;
+        }
+        return true;
+      }
+      if (p.kind == BEACON && newer(st, p.state)) repairDue = true;   // master o změně neví
+      return false;
+    }
+
+    // Vlastní změna: verze +1, rozeslat (při dalších poll())
+    void publish(State s, uint64_t localUs) {
+      s.version = st.version + 1;
+      s.origin = self;
+      st = s;
+      if (rl == OFF) return;
+      pending = repeats;
+      nextCmdUs = localUs;
+    }
+
+    // Volat často; true = pošli out a zavolej znovu
+    bool poll(uint64_t localUs, Packet& out) {
+      if (rl == OFF) return false;
+      if (pending && localUs >= nextCmdUs) {
+        pending--;
+        nextCmdUs = localUs + repeatMs * 1000ULL;
+        fill(out, COMMAND, 0);
+        return true;
+      }
+      if (repairDue) {
+        repairDue = false;
+        repairs++;
+        fill(out, COMMAND, 0);
+        return true;
+      }
+      if (rl == MASTER && localUs >= nextBeaconUs) {
+        nextBeaconUs += beaconMs * 1000ULL;
+        if (nextBeaconUs <= localUs) nextBeaconUs = localUs + beaconMs * 1000ULL;   // dlouho nevolané
+        fill(out, BEACON, localUs);
+        return true;
+      }
+      return false;
+    }
+
+    // Statistika
+    uint32_t beaconCount() const { return beacons; }
+    uint32_t missedBeacons() const { return missed; }     // podle seq
+    uint32_t commandCount() const { return commands; }
+    uint32_t repairCount() const { return repairs; }
+    uint32_t conflictCount() const { return conflicts; }
+    // Jak dlouho nepřišel beacon (0 = ještě žádný)
+    uint32_t beaconAgeMs(uint64_t localUs) const { return beacons ? (uint32_t)((localUs - lastBeaconUs) / 1000) : 0; }
+
+  private:
+    void fill(Packet& p, Kind k, uint64_t timeUs) {
+      p.magic = MAGIC;
+      p.proto = PROTO;
+      p.kind = k;
+      p.group = grp;
+      p.from = self;
+      p.seq = ++seq;
+      p.timeUs = timeUs;
+      p.state = st;
+    }
+
+    Role rl = OFF;
+    uint8_t grp = 0;
+    uint32_t self = 0;
+    State st = {};
+    uint16_t seq = 0, lastSeq = 0;
+    uint8_t pending = 0;
+    bool repairDue = false;
+    uint64_t nextCmdUs = 0, nextBeaconUs = 0, lastBeaconUs = 0;
+    uint32_t beacons = 0, missed = 0, commands = 0, repairs = 0, conflicts = 0;
+  };
+
+#if defined(ESP32)
+  // ESP-NOW: broadcast všem ve dosahu, příjem do fronty (callback běží v úloze Wi-Fi)
+  class Radio {
+  public:
+    // Wi-Fi už musí běžet (WiFi.mode()); vrací id = konec MAC, 0 = chyba
+    uint32_t begin(wifi_interface_t ifx = WIFI_IF_STA) {
+      if (esp_now_init() != ESP_OK) return 0;
+      esp_now_peer_info_t peer = {};
+      memset(peer.peer_addr, 0xFF, 6);
+      peer.channel = 0;                 // kanál, na kterém Wi-Fi právě je
+      peer.ifidx = ifx;
+      peer.encrypt = false;
+      if (!esp_now_is_peer_exist(peer.peer_addr) && esp_now_add_peer(&peer) != ESP_OK) return 0;
+      instance() = this;
+      esp_now_register_recv_cb(onRecv);
+      uint8_t mac[6];
+      if (esp_wifi_get_mac(ifx, mac) != ESP_OK) return 0;
+      return (uint32_t)mac[2] << 24 | (uint32_t)mac[3] << 16 | (uint32_t)mac[4] << 8 | mac[5];
+    }
+
+    bool send(const Packet& p) {
+      static const uint8_t all[6] = { 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF };
+      return esp_now_send(all, (const uint8_t*)&p, sizeof(p)) == ESP_OK;
+    }
+
+    // Další přijatá zpráva a místní čas příjmu (esp_timer, µs)
+    bool read(Packet& p, uint64_t& atUs) {
+      if (tail == head) return false;
+      p = q[tail].p;
+      atUs = q[tail].at;
+      tail = (tail + 1) & (QUEUE - 1);
+      return true;
+    }
+
+    uint32_t dropped() const { return drops; }   // plná fronta
+
+  private:
+    static constexpr uint8_t QUEUE = 8;           // mocnina dvou
+    struct Item { Packet p; uint64_t at; };
+
+    static Radio*& instance() { static Radio* r = nullptr; return r; }
+
+#if ESP_ARDUINO_VERSION_MAJOR >= 3
+    static void onRecv(const esp_now_recv_info_t*, const uint8_t* data, int len) {
+#else
+    static void onRecv(const uint8_t*, const uint8_t* data, int len) {
+#endif
+      uint64_t at = esp_timer_get_time();        // co nejdřív: zpoždění se počítá do odhadu
+      Radio* r = instance();
+      if (r) r->push(data, len, at);
+    }
+
+    void push(const uint8_t* data, int len, uint64_t at) {
+      uint8_t next = (head + 1) & (QUEUE - 1);
+      if (next == tail) { drops++; return; }
+      if (!decode(data, len, q[head].p)) return;
+      q[head].at = at;
+      head = next;
+    }
+
+    Item q[QUEUE];
+    volatile uint8_t head = 0, tail = 0;
+    volatile uint32_t drops = 0;
+  };
+#endif
+
+} // namespace MySync
+
+#endif // MY_SYNC_H
@@ -17,6 +17,9 @@ Poznámky:
 - Některé moduly mají LED napevno zapnutou propojkou. Pokud chcete LED řídit,
   je potřeba tu propojku rozpojit (podle dokumentace modulu).
 - Rychlost sériové linky: 115200. Do Serial Monitoru pište: on / off.
+- Senzor se čte bez čekání (knihovna MyColorSensor): měření běží v senzoru,
+  loop() mezitím pořád obsluhuje příkazy. Zesílení a integrační čas se
+  nastavují samy podle světla (9,6 ms na slunci až 614 ms ve tmě).
 
 ========================================
 Úkoly, pro pochopení kódu (pro děti)
@@ -24,18 +27,15 @@ Poznámky:
 1) Co dělá funkce setLed(true/false)? Zkus "on" a "off" v Serial Monitoru.
 2) Co znamenají čísla RAW R, G, B, C? Kdy se mění nejvíc?
 3) Přikryj senzor rukou. Jak se změní „Lux“ a „CT(K)“?
-4) Změň v kódu zesílení (GAIN_1X, 4X, 16X, 60X). Co se stane?
-5) Proč dáváme delší integrační čas (600 ms)? Co to dělá s kvalitou měření?
+4) Sleduj ve výpisu „rozsah“. Kdy senzor sám přepne zesílení a čas?
+5) Proč je delší integrační čas (614 ms) ve tmě lepší? A proč ne na slunci?
+6) V loop() není žádné delay(). Jak to, že výpis chodí pravidelně?
 */
 
-#include <Wire.h>
-#include "Adafruit_TCS34725.h"
+#include <MyColorSensor.h>   // knihovna MyColorSensor: TCS34725 bez čekání
 
-// --- Nastavení senzoru (PRAVIDLO: používej 600 ms, ne 700 ms) ---
-Adafruit_TCS34725 tcs(
-  TCS34725_INTEGRATIONTIME_600MS,
-  TCS34725_GAIN_4X
-);
+MyColor::WireBus bus;
+MyColor::Tcs34725<MyColor::WireBus> tcs(bus);
 
 // ===== Volitelný pin pro přímé řízení LED na breakout modulu =====
 // Pokud nepoužíváte, dejte -1
@@ -71,7 +71,7 @@ void rawToRGB255(uint16_t r, uint16_t g, uint16_t b, uint16_t c,
 void setLed(bool on) {
   ledOn = on;
 
-  // U většiny modulů: setInterrupt(false) = LED ON, true = LED OFF
+  // U většiny modulů: setInterrupt(false) = LED ON, true = LED OFF (od dalšího měření)
   tcs.setInterrupt(!on);
 
 #if (LED_CTRL_PIN >= 0)
@@ -115,7 +115,7 @@ void setup() {
   delay(100);
   Serial.println("TCS34725 RGB (napiš 'on' / 'off' do Serial Monitoru)");
 
-  if (!tcs.begin()) {
+  if (!tcs.begin(millis())) {
     Serial.println("ERROR: TCS34725 nenalezen. Zkontroluj zapojení.");
     while (1) delay(1000);
   }
@@ -124,30 +124,30 @@ void setup() {
   setLed(true);
 }
 
+unsigned long lastPrint = 0;
+
 void loop() {
-  handleSerial();
+  handleSerial();                          // běží pořád, i během měření
 
-  uint16_t r, g, b, c;
-  tcs.getRawData(&r, &g, &b, &c);
+  if (!tcs.poll(millis())) return;         // senzor ještě měří
+  if (millis() - lastPrint < 500) return;  // vypisuj 2× za sekundu
+  lastPrint = millis();
 
+  const MyColor::Sample& s = tcs.sample();
   uint8_t R, G, B;
-  rawToRGB255(r, g, b, c, R, G, B);
-
-  uint16_t ct  = tcs.calculateColorTemperature(r, g, b);
-  uint16_t lux = tcs.calculateLux(r, g, b);
+  rawToRGB255(s.r, s.g, s.b, s.c, R, G, B);
 
-  Serial.print("RAW R:"); Serial.print(r);
-  Serial.print(" G:");    Serial.print(g);
-  Serial.print(" B:");    Serial.print(b);
-  Serial.print(" C:");    Serial.print(c);
+  Serial.print("RAW R:"); Serial.print(s.r);
+  Serial.print(" G:");    Serial.print(s.g);
+  Serial.print(" B:");    Serial.print(s.b);
+  Serial.print(" C:");    Serial.print(s.c);
   Serial.print(" | RGB: ");
   Serial.print((int)R); Serial.print(",");
   Serial.print((int)G); Serial.print(",");
   Serial.print((int)B);
-  Serial.print(" | CT(K): "); Serial.print(ct);
-  Serial.print(" Lux: ");     Serial.print(lux);
+  Serial.print(" | CT(K): "); Serial.print(s.colorTemperature());
+  Serial.print(" Lux: ");     Serial.print((long)s.lux());
+  Serial.print(" | rozsah: "); Serial.print(s.range);
+  Serial.print(" ("); Serial.print(tcs.integrationMs()); Serial.print(" ms)");
   Serial.print(" | LED: ");   Serial.println(ledOn ? "ON" : "OFF");
-
-  // ~10× za sekundu kontroluj příchozí příkazy
-  for (int i=0;i<10;i++){ handleSerial(); delay(50); }
 }
@@ -109,26 +109,8 @@ HODNOCENÍ:
 
 #include <Adafruit_NeoPixel.h>
 #include <IRremote.hpp>   // IRremote v3+
-#if !defined(ONE)
-// IR button codes (formerly from MyIRcodes.h)
-constexpr uint32_t ONE      = 0xBA45FF00;
-constexpr uint32_t TWO      = 0xB946FF00;
-constexpr uint32_t THREE    = 0xB847FF00;
-constexpr uint32_t FOUR     = 0xBB44FF00;
-constexpr uint32_t FIVE     = 0xBF40FF00;
-constexpr uint32_t SIX      = 0xBC43FF00;
-constexpr uint32_t SEVEN    = 0xF807FF00;
-constexpr uint32_t EIGHT    = 0xEA15FF00;
-constexpr uint32_t NINE     = 0xF609FF00;
-constexpr uint32_t STARBTN  = 0xE916FF00;
-constexpr uint32_t ZERO     = 0xE619FF00;
-constexpr uint32_t HASHBTN  = 0xF20DFF00;
-constexpr uint32_t UPBTN    = 0xE718FF00;
-constexpr uint32_t LEFTBTN  = 0xF708FF00;
-constexpr uint32_t OKBTN    = 0xE31CFF00;
-constexpr uint32_t RIGHTBTN = 0xA55AFF00;
-constexpr uint32_t DOWNBTN  = 0xAD52FF00;
-#endif
+#include <MyIRcodes.h>   // jediná tabulka IR kódů: ONE, TWO, ..., nameOf() (knihovna MyIRcodes)
+using namespace MyIR;
 
 // =================== UPRAV PODLE POTŘEBY ===================
 #define LED_PIN         6
@@ -384,24 +366,6 @@ void show9_palettePulse() {
   animStep++;
 }
 
-// ---------- Pomocný výpis názvu tlačítka (pro debug) ----------
-const char* buttonName(unsigned long code) {
-  if (code == ONE)   return "ONE";
-  if (code == TWO)   return "TWO";
-  if (code == THREE) return "THREE";
-  if (code == FOUR)  return "FOUR";
-  if (code == FIVE)  return "FIVE";
-  if (code == SIX)   return "SIX";
-  if (code == SEVEN) return "SEVEN";
-  if (code == EIGHT) return "EIGHT";
-  if (code == NINE)  return "NINE";
-  if (code == LEFTBTN)  return "LEFT";
-  if (code == RIGHTBTN) return "RIGHT";
-  if (code == UPBTN)    return "UP";
-  if (code == DOWNBTN)  return "DOWN";
-  return "UNKNOWN";
-}
-
 // ---------- IR obsluha ----------
 void handleIR() {
   if (!IrReceiver.decode()) return;
@@ -412,9 +376,9 @@ void handleIR() {
   // Debug
   Serial.print(F("IR raw=0x")); Serial.print(raw, HEX);
   if (raw == 0x0 && lastNonRepeat) {
-    Serial.print(F(" (REPEAT of ")); Serial.print(buttonName(lastNonRepeat)); Serial.print(F(")"));
+    Serial.print(F(" (REPEAT of ")); Serial.print(nameOf(lastNonRepeat)); Serial.print(F(")"));
   } else {
-    Serial.print(F(" (")); Serial.print(buttonName(raw)); Serial.print(F(")"));
+    Serial.print(F(" (")); Serial.print(nameOf(raw)); Serial.print(F(")"));
   }
   Serial.println();
 
@@ -7,38 +7,60 @@ ESP32 3V3  → VIN (or VCC) on TCS34725
 ESP32 GND  → GND
 ESP32 GPIO 21 (SDA) → SDA
 ESP32 GPIO 22 (SCL) → SCL
+ESP32 GPIO 4 (optional) → INT (open drain, active LOW; set INT_PIN -1 if not wired)
+
+The sensor is read without waiting: MyColorSensor starts an integration,
+loop() keeps running, and the result is collected when the integration
+time is over (or INT goes LOW). Gain and integration time follow the
+light level automatically (9.6 ms in sunlight up to 614 ms in the dark).
 */
 
-#include <Wire.h>
-#include "Adafruit_TCS34725.h"
+#include <MyColorSensor.h>   // library MyColorSensor (Arduino_custom_library_demo_IR_remote)
+
+#define INT_PIN 4            // -1 = no INT wire, use the integration deadline only
+
+MyColor::WireBus bus;
+MyColor::Tcs34725<MyColor::WireBus> tcs(bus);
 
-// Use integration time and gain supported by the official library
-Adafruit_TCS34725 tcs = Adafruit_TCS34725(
-  TCS34725_INTEGRATIONTIME_614MS, 
-  TCS34725_GAIN_1X
-);
+#if (INT_PIN >= 0)
+void IRAM_ATTR onSensorInt() { tcs.notify(); }
+#endif
 
 void setup(void) {
   Serial.begin(115200);
   delay(200);
   Serial.println("TCS34725 test start...");
 
-  if (tcs.begin()) {
+  if (tcs.begin(millis())) {
     Serial.println("Sensor found!");
   } else {
     Serial.println("No TCS34725 found. Check wiring!");
     while (1) delay(100);
   }
+
+#if (INT_PIN >= 0)
+  pinMode(INT_PIN, INPUT_PULLUP);
+  attachInterrupt(digitalPinToInterrupt(INT_PIN), onSensorInt, FALLING);
+  tcs.useIntPin(true);
+#endif
 }
 
 void loop(void) {
-  uint16_t r, g, b, c;
-  tcs.getRawData(&r, &g, &b, &c);
-
-  Serial.print("R: "); Serial.print(r);
-  Serial.print("  G: "); Serial.print(g);
-  Serial.print("  B: "); Serial.print(b);
-  Serial.print("  Clear: "); Serial.println(c);
+  static uint32_t lastPrint = 0;
+  if (!tcs.poll(millis())) return;     // nothing new yet – free for other work
+  if (millis() - lastPrint < 500) return;   // print twice a second, even with 9.6 ms samples
+  lastPrint = millis();
 
-  delay(500); // half a second
+  const MyColor::Sample& s = tcs.sample();
+  Serial.print("R: "); Serial.print(s.r);
+  Serial.print("  G: "); Serial.print(s.g);
+  Serial.print("  B: "); Serial.print(s.b);
+  Serial.print("  Clear: "); Serial.print(s.c);
+  Serial.print("  | range "); Serial.print(s.range);
+  Serial.print(" ("); Serial.print(tcs.integrationMs()); Serial.print(" ms)");
+  Serial.print("  level "); Serial.print(s.level);
+  Serial.print("  chroma "); Serial.print(s.chroma[0]); Serial.print(",");
+  Serial.print(s.chroma[1]); Serial.print(","); Serial.print(s.chroma[2]);
+  Serial.print("  lux "); Serial.print(s.lux(), 0);
+  Serial.print("  CCT "); Serial.println(s.colorTemperature());
 }
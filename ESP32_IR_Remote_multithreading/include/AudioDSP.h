@@ -0,0 +1,281 @@
+/*
+AudioDSP.h — microphone analysis for the audio-reactive shows
+- No Arduino dependencies: the same code runs on the ESP32 (AudioTask) and on
+  a PC against WAV files (tools/audio_wav.cpp) for regression and timing.
+- Integer only (Q15 samples, Q8 log2 levels); the sin table is filled once.
+
+Pipeline, every HOP samples (50 % overlap, 125 analyses/s at 16 kHz):
+  DC removal -> Hann window -> 256-point real FFT (128-point complex FFT,
+  1/2 scaling per stage, then the real split) -> power per bin
+  -> 8 log-spaced bands, log2 in Q8 (1.0 = 3 dB)
+  -> auto gain: the loudest band sets a peak that jumps up at once and
+     falls slowly; bands map the window [peak - RANGE, peak] to 0..255
+  -> onset: spectral flux over all bands above its running mean
+  -> beat:  flux of the two bass bands, only near their own recent peak
+     (a hi-hat leaks some noise into the bass, 20 dB under a kick) and with
+     a refractory time; the beat interval is smoothed into a BPM estimate
+  Onsets and beats fire once per crossing of their threshold.
+
+Results go out as a Snapshot through a Seqlock: the writer never waits and
+a reader on the other core either gets a consistent copy or keeps the old one.
+beats/onsets are counters, so a 30 fps reader does not miss a 125/s event.
+*/
+
+#ifndef AUDIO_DSP_H
+#define AUDIO_DSP_H
+
+#include <stdint.h>
+#include <string.h>
+#include <math.h>
+#include <atomic>
+
+namespace Audio {
+
+  constexpr uint32_t SAMPLE_RATE = 16000;
+  constexpr uint16_t FFT_N = 256;                 // real input samples per analysis
+  constexpr uint16_t HOP = FFT_N / 2;             // new samples per analysis
+  constexpr uint16_t HOPS_PER_S = SAMPLE_RATE / HOP;
+  constexpr uint8_t  BANDS = 8;
+
+  // Band edges in FFT bins (62.5 Hz each): 62, 125, 187, 312, 500, 1k, 2k, 4k, 8k Hz
+  constexpr uint8_t BAND_EDGE[BANDS + 1] = { 1, 2, 3, 5, 8, 16, 32, 64, 128 };
+  constexpr uint8_t BASS_BANDS = 2;               // bands 0..1 (kick drum) drive the beat
+  constexpr uint8_t TREBLE_FROM = 6;              // bands 6..7, mid = 2..5
+
+  struct Snapshot {
+    uint32_t frame;                 // analysis counter
+    uint8_t  band[BANDS];           // 0..255 after auto gain, with a short fall-off
+    uint8_t  level;                 // whole spectrum
+    uint8_t  bass, mid, treble;
+    uint8_t  beats;                 // +1 per detected beat
+    uint8_t  onsets;                // +1 per detected onset
+    uint8_t  bpm;                   // 0 until two beats were seen
+    int16_t  peakQ8;                // auto-gain peak, log2 power in Q8
+  };
+
+  // log2(x) in Q8, for x >= 1 (linear mantissa, error < 0.09)
+  inline int16_t log2q8(uint64_t x) {
+    if (x == 0) return 0;
+    uint8_t msb = 63 - __builtin_clzll(x);
+    uint32_t frac = (msb >= 8) ? (uint32_t)(x >> (msb - 8)) & 0xFF : (uint32_t)(x << (8 - msb)) & 0xFF;
+    return (int16_t)((msb << 8) | frac);
+  }
+
+  // ---------- Lock-free single-writer snapshot ----------
+  template<class T> class Seqlock {
+  public:
+    void write(const T& v) {
+      uint32_t s = seq.load(std::memory_order_relaxed);
+      seq.store(s + 1, std::memory_order_relaxed);          // odd: write in progress
+      std::atomic_thread_fence(std::memory_order_release);
+      data = v;
+      seq.store(s + 2, std::memory_order_release);
+    }
+
+    // False if the writer kept interrupting; 'out' is then left as it was
+    bool read(T& out, uint8_t tries = 4) const {
+      while (tries--) {
+        uint32_t s1 = seq.load(std::memory_order_acquire);
+        if (s1 & 1) continue;
+        T copy = data;
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (seq.load(std::memory_order_relaxed) == s1) { out = copy; return true; }
+      }
+      return false;
+    }
+
+  private:
+    std::atomic<uint32_t> seq{ 0 };
+    T data{};
+  };
+
+  // ---------- Analyzer ----------
+  class Analyzer {
+  public:
+    // Tunables (Q8 log2 units: 256 = 3 dB)
+    int16_t rangeQ8   = 16 * 256;       // 48 dB shown between silence and peak
+    int16_t releaseQ8 = 4;              // peak falls ~6 dB/s
+    int16_t gateQ8    = 18 * 256;       // peak never goes below this (room noise stays dark)
+    uint8_t fallPerHop = 8;             // band display fall-off (255 -> 0 in ~0.25 s)
+
+    Analyzer() { begin(); }
+
+    void begin() {
+      for (uint16_t k = 0; k < FFT_N; k++) sinQ15[k] = (int16_t)lrintf(32767.0f * sinf(6.2831853f * k / FFT_N));
+      for (uint8_t b = 0; b < BANDS; b++) widthQ8[b] = log2q8(BAND_EDGE[b + 1] - BAND_EDGE[b]);
+      memset(history, 0, sizeof(history));
+      memset(&snap, 0, sizeof(snap));
+      memset(prevLog, 0, sizeof(prevLog));
+      filled = 0; dc = 0;
+      peak = gateQ8; bassPeak = 0; fluxMean = 0; bassMean = 0;
+      inOnset = false; inBeat = false;
+      lastBeatHop = 0; lastOnsetHop = 0; intervalQ4 = 0; hopNo = 0;
+    }
+
+    // Feeds samples; runs one analysis per HOP new samples. Returns true if
+    // result() changed (more than one analysis may have run).
+    bool push(const int16_t* s, uint16_t n) {
+      bool updated = false;
+      while (n) {
+        uint16_t take = HOP - filled;
+        if (take > n) take = n;
+        for (uint16_t i = 0; i < take; i++) {
+          int32_t x = (int32_t)s[i] << 8;                     // DC tracker in Q8
+          dc += (x - dc) >> 7;                                // ~20 Hz high-pass
+          int32_t y = (x - dc) >> 8;
+          history[HOP + filled + i] = (int16_t)(y > 32767 ? 32767 : (y < -32768 ? -32768 : y));
+        }
+        filled += take; s += take; n -= take;
+        if (filled == HOP) {
+          analyse();
+          memcpy(history, history + HOP, HOP * sizeof(int16_t));
+          filled = 0;
+          updated = true;
+        }
+      }
+      return updated;
+    }
+
+    const Snapshot& result() const { return snap; }
+
+  private:
+    // In-place radix-2 DIT FFT of M = FFT_N / 2 complex points, output / M
+    void fft(int16_t* re, int16_t* im) {
+      const uint16_t M = FFT_N / 2;
+      for (uint16_t i = 1, j = 0; i < M; i++) {             // bit reversal
+        uint16_t bit = M >> 1;
+        for (; j & bit; bit >>= 1) j ^= bit;
+        j |= bit;
+        if (i < j) { int16_t t = re[i]; re[i] = re[j]; re[j] = t; t = im[i]; im[i] = im[j]; im[j] = t; }
+      }
+      for (uint16_t len = 2; len <= M; len <<= 1) {
+        uint16_t half = len >> 1, stride = FFT_N / len;     // W_len^k = table[k * stride]
+        for (uint16_t k = 0; k < half; k++) {
+          int32_t c = cosQ15(k * stride), sn = -sinQ15[k * stride];
+          for (uint16_t i = k; i < M; i += len) {
+            uint16_t j = i + half;
+            int32_t tr = (c * re[j] - sn * im[j] + 0x4000) >> 15;   // rounded, not truncated:
+            int32_t ti = (c * im[j] + sn * re[j] + 0x4000) >> 15;   // 7 stages would add up the bias
+            re[j] = (int16_t)((re[i] - tr + 1) >> 1); im[j] = (int16_t)((im[i] - ti + 1) >> 1);
+            re[i] = (int16_t)((re[i] + tr + 1) >> 1); im[i] = (int16_t)((im[i] + ti + 1) >> 1);
+          }
+        }
+      }
+    }
+
+    int32_t cosQ15(uint16_t k) const { return sinQ15[(k + FFT_N / 4) & (FFT_N - 1)]; }
+
+    void analyse() {
+      const uint16_t M = FFT_N / 2;
+      // Hann window (from the sin table) while packing x[2n] + i*x[2n+1]
+      for (uint16_t n = 0; n < M; n++) {
+        int32_t w0 = (32767 - cosQ15(2 * n)) >> 1, w1 = (32767 - cosQ15(2 * n + 1)) >> 1;
+        re[n] = (int16_t)((history[2 * n] * w0) >> 15);
+        im[n] = (int16_t)((history[2 * n + 1] * w1) >> 15);
+      }
+      fft(re, im);
+
+      // Split: X[k] = (Z[k] + conj Z[M-k]) / 2 + W_N^k (Z[k] - conj Z[M-k]) / 2i
+      uint64_t bandSum[BANDS] = { 0 };
+      uint8_t b = 0;
+      for (uint16_t k = BAND_EDGE[0]; k < BAND_EDGE[BANDS]; k++) {
+        if (k >= BAND_EDGE[b + 1]) b++;
+        int32_t ar = re[k], ai = im[k], br = re[M - k], bi = im[M - k];
+        int32_t er = (ar + br) >> 1, ei = (ai - bi) >> 1;
+        int32_t or_ = (ai + bi) >> 1, oi = (br - ar) >> 1;
+        int32_t c = cosQ15(k), sn = sinQ15[k];
+        int32_t xr = er + ((c * or_ + sn * oi) >> 15);
+        int32_t xi = ei + ((c * oi - sn * or_) >> 15);
+        bandSum[b] += (uint64_t)((int64_t)xr * xr + (int64_t)xi * xi);
+      }
+
+      // Bands in log2 Q8 (mean power per bin), auto gain, flux
+      int16_t logs[BANDS], loudest = 0;
+      uint64_t total = 0;
+      for (b = 0; b < BANDS; b++) {
+        total += bandSum[b];
+        logs[b] = log2q8(bandSum[b] + 1) - widthQ8[b];
+        if (logs[b] > loudest) loudest = logs[b];
+      }
+      peak = (loudest > peak) ? loudest : peak - releaseQ8;
+      if (peak < gateQ8) peak = gateQ8;
+      int16_t floorQ8 = peak - rangeQ8;
+
+      int32_t flux = 0, bassFlux = 0;
+      for (b = 0; b < BANDS; b++) {
+        int16_t rise = logs[b] - prevLog[b];
+        if (rise > 0) {
+          if (b < BASS_BANDS) bassFlux += rise;
+          if (logs[b] > peak - rangeQ8 / 2) flux += rise;   // quiet bands only flicker
+        }
+        prevLog[b] = logs[b];
+        uint8_t v = toLevel(logs[b], floorQ8);
+        snap.band[b] = (v >= snap.band[b]) ? v : (snap.band[b] > fallPerHop ? snap.band[b] - fallPerHop : 0);
+      }
+      int16_t bassLog = log2q8(bandSum[0] + bandSum[1] + 1) - log2q8(BAND_EDGE[BASS_BANDS] - BAND_EDGE[0]);
+      bassPeak = (bassLog > bassPeak) ? bassLog : bassPeak - releaseQ8;
+      uint8_t lv = toLevel(log2q8(total + 1) - log2q8(BAND_EDGE[BANDS] - BAND_EDGE[0]), floorQ8);
+      snap.level  = (lv >= snap.level) ? lv : (snap.level > fallPerHop ? snap.level - fallPerHop : 0);
+      snap.bass   = average(0, BASS_BANDS);
+      snap.mid    = average(BASS_BANDS, TREBLE_FROM);
+      snap.treble = average(TREBLE_FROM, BANDS);
+
+      hopNo++;
+      // Onset: flux clearly above its running mean (mean in Q4, 1/16 per hop)
+      bool onset = flux * 16 > fluxMean * 3 / 2 + 384 * 16;
+      if (onset && !inOnset && hopNo - lastOnsetHop >= HOPS_PER_S / 10) {
+        snap.onsets++;
+        lastOnsetHop = hopNo;
+      }
+      inOnset = onset;
+      fluxMean += flux - (fluxMean >> 4);
+      // Beat: bass flux at twice its mean, bass within 9 dB of its peak and
+      // within 12 dB of the loudest band, at most one per 240 ms (250 BPM)
+      bool beat = bassFlux * 16 > bassMean * 2 + 384 * 16 &&
+                  bassLog + 3 * 256 >= bassPeak && bassLog + 4 * 256 > peak;
+      if (beat && !inBeat && hopNo - lastBeatHop >= HOPS_PER_S * 6 / 25) {
+        uint32_t gap = hopNo - lastBeatHop;
+        if (lastBeatHop && gap >= HOPS_PER_S * 3 / 10 && gap <= HOPS_PER_S * 3 / 2) {   // 40..200 BPM
+          intervalQ4 = intervalQ4 ? intervalQ4 + (int32_t)(gap * 16 - intervalQ4) / 4 : gap * 16;
+          snap.bpm = (uint8_t)((60UL * HOPS_PER_S * 16 + intervalQ4 / 2) / intervalQ4);
+        }
+        snap.beats++;
+        lastBeatHop = hopNo;
+      }
+      inBeat = beat;
+      bassMean += bassFlux - (bassMean >> 4);
+
+      snap.peakQ8 = peak;
+      snap.frame++;
+    }
+
+    uint8_t toLevel(int16_t v, int16_t floorQ8) const {
+      if (v <= floorQ8) return 0;
+      int32_t x = (int32_t)(v - floorQ8) * 255 / rangeQ8;
+      return (uint8_t)(x > 255 ? 255 : x);
+    }
+
+    uint8_t average(uint8_t from, uint8_t to) const {
+      uint16_t sum = 0;
+      for (uint8_t b = from; b < to; b++) sum += snap.band[b];
+      return (uint8_t)(sum / (to - from));
+    }
+
+    int16_t  history[FFT_N];        // [0, HOP) previous hop, [HOP, FFT_N) current
+    int16_t  re[FFT_N / 2], im[FFT_N / 2];
+    int16_t  sinQ15[FFT_N];
+    int16_t  widthQ8[BANDS];
+    int16_t  prevLog[BANDS];
+    uint16_t filled;
+    int32_t  dc;
+    int16_t  peak, bassPeak;
+    bool     inOnset, inBeat;
+    int32_t  fluxMean, bassMean;    // Q4 running means
+    uint32_t hopNo, lastBeatHop, lastOnsetHop;
+    int32_t  intervalQ4;            // smoothed beat interval in hops, Q4
+    Snapshot snap;
+  };
+
+} // namespace Audio
+
+#endif // AUDIO_DSP_H
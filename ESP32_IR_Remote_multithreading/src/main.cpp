@@ -14,15 +14,52 @@ IR Receiver (VS1838B/TSOP38238):
 - VCC         -> ESP32 5V pin (NOT 3.3V!)
 - GND         -> GND
 
+Microphone (optional, see AUDIO_INPUT):
+- Analog (MAX4466/MAX9814): OUT -> GPIO 34, VCC -> 3.3V, GND -> GND
+- I2S (INMP441): SCK -> GPIO 26, WS -> GPIO 25, SD -> GPIO 33, L/R -> GND, VDD -> 3.3V
+
 ARCHITECTURE:
 - Core 0: IR handling (non-blocking)
 - Core 1: LED animations (smooth, uninterrupted)
+- Long strips: each frame is split in two, core 0 renders the upper half
+- Core 0, idle priority: microphone via I2S DMA + FFT (include/AudioDSP.h)
 - Thread-safe communication via FreeRTOS primitives
+- Serial2 output: tasks only record log events (MyLog, a few hundred ns);
+  an idle-priority task formats and prints them, never under dataMutex
+- Power (MyPower): tasks block until an IR edge or the next frame instead of
+  polling; unchanged frames are not sent, a static strip drops the CPU to
+  80 MHz and after 5 s without input the chip light-sleeps until an IR edge
+- Output (MyShows/MyOutput.h): the shows render at full precision into
+  logicalPixels; brightness, gamma, white point and the GRB byte order are
+  applied in one table-driven pass on the way to the strip buffer, so a
+  brightness change never touches show state (the Rain fade stays exact)
+- Current (MyPower::CurrentLimit): the output pass also sums each channel;
+  from that every frame gets a supply current estimate. Above
+  CURRENT_BUDGET_MA the frame is redone dimmer before it is sent, and the
+  limit eases toward 90 % of the budget (fast down, slow back up).
+  Limit events and a minute summary go to Serial2
+- Boot: the show, palette, brightness and speed from before the reset are
+  on the strip first (target < 100 ms); IR, tasks and audio start after it.
+  The boot timeline (MyBoot) is logged once setup() is done
+- Sync (MySync, off by default, see SYNC_ROLE): several controllers along a
+  stage show the same step at the same time. The master broadcasts its clock
+  over ESP-NOW, followers fit offset and drift and derive the step from the
+  shared time; a button on any controller changes the show on all of them
+- Frame cache (MyShows/MyFrameCache.h): Rainbow and Color Wipe repeat, so
+  their first cycle is stored compressed (PSRAM if the board has it) and
+  later cycles are unpacked instead of rendered. A new show, palette or
+  palette blend empties it; brightness does not (it is applied in the
+  output pass). Hit rate and bytes used are logged every minute
 
 IR REMOTE CONTROL:
 - Numbers 1-9: Select show (9 different effects)
 - LEFT/RIGHT: Slow down/speed up animation
-- UP/DOWN: Decrease/increase brightness
+- UP/DOWN: Increase/decrease brightness
+- 0: Next color palette for Rainbow, Color Wipe and Palette Pulse (first = built-in colors)
+- *: Next blend mode of the palette with the tint color (off, lerp, add, multiply, screen)
+- #: Audio on/off: Rainbow becomes a VU meter, Comet speeds up with the bass,
+     Palette Pulse pulses with the bass and changes color on every beat
+- Holding LEFT/RIGHT/UP/DOWN auto-repeats (NEC, RC5 and Sony remotes)
 ******************************************************/
 
 #include <Arduino.h>
@@ -30,6 +67,22 @@ IR REMOTE CONTROL:
 #include <freertos/FreeRTOS.h>
 #include <freertos/task.h>
 #include <freertos/semphr.h>
+#include <driver/i2s.h>
+#include <MyIRcodes.h>   // single IR code table (lib_extra_dirs in platformio.ini)
+#include <MyShows.h>     // the 9 shows, shared with the other NeoPixel sketches
+#include <MyFrameCache.h> // first cycle of a repeating show stored, later ones unpacked
+#include <MyPalette.h>   // gradient palettes compiled to 256-entry tables
+#include <MyLayout.h>    // matrix / ring / free layouts, precomputed index tables
+#include <MyOutput.h>    // brightness, gamma, white point and byte order in one pass
+#include <IRDecoder.h>   // NEC / RC5 / Sony decoder fed with edge timings
+#include <MyLog.h>       // binary log ring, printed by an idle-priority task (tools/log_decode.cpp)
+#include <MyPower.h>     // static-frame detection, CPU clock and light sleep
+#include <MyBoot.h>      // boot phase timestamps
+#include <MySync.h>      // several controllers: shared clock and show state over ESP-NOW
+#include <WiFi.h>        // only the radio for ESP-NOW (SYNC_ROLE), no network
+#include <Preferences.h> // show and settings survive a reset (NVS)
+#include "AudioDSP.h"    // FFT, bands, beat detection (also runs on a PC: tools/audio_wav.cpp)
+using namespace MyIR;
 
 // ESP32 Serial2 support - bypass problematic HardwareSerial.cpp
 // We use Serial2 directly, avoiding the framework's Serial issues
@@ -39,40 +92,80 @@ IR REMOTE CONTROL:
 #define NUMPIXELS       60
 #define IR_RECEIVE_PIN  23
 
+// How the LEDs hang (MyShows/MyLayout.h). With anything but LAYOUT_STRIP the
+// shows render into a logical strip that is laid out along LAYOUT_PATH.
+#define LAYOUT_STRIP    0                   // wiring order, no remap
+#define LAYOUT_RING     1                   // NUMPIXELS in a circle, LED 0 at the top
+#define LAYOUT_MATRIX   2                   // MATRIX_W x MATRIX_H panel (= NUMPIXELS)
+#define LED_LAYOUT      LAYOUT_STRIP
+#define LAYOUT_PATH     MyShows::PATH_SNAKE // PATH_ROWS, PATH_ANGLE, PATH_RADIUS, ...
+#define MATRIX_W        16                  // panel size, also the grid for LAYOUT_RING
+#define MATRIX_H        16
+#define MATRIX_SERPENTINE true              // every other row runs backwards
+#define MATRIX_ROTATE   0                   // 0..3 = 0, 90, 180, 270 degrees clockwise
+#define MATRIX_MIRROR   false               // panel seen from the back
+
+// Split rendering across both cores from this strip length on. The handoff
+// costs two task notifications (~10-20 us); below a few hundred pixels a whole
+// frame renders faster than that, so short strips stay on core 1 alone.
+#define PARALLEL_MIN_PIXELS  300
+#define RENDER_SPLIT         (NUMPIXELS / 2)   // core 1: [0, split), core 0: [split, NUMPIXELS)
+
+// Frame cache (0 = off). Rainbow needs about 800 B per LED, Color Wipe about
+// 90; a cycle that does not fit is simply rendered every time
+#define FRAME_CACHE_BYTES    65536
+
+// Microphone for the audio shows
+#define AUDIO_NONE      0
+#define AUDIO_ADC       1                   // analog mic on ADC1 via the I2S ADC DMA
+#define AUDIO_I2S       2                   // I2S MEMS mic (INMP441)
+#define AUDIO_INPUT     AUDIO_ADC
+#define AUDIO_ADC_CHANNEL  ADC1_CHANNEL_6   // GPIO 34
+#define I2S_MIC_SCK     26
+#define I2S_MIC_WS      25
+#define I2S_MIC_SD      33
+
 // Brightness limits
 #define BRIGHT_MIN      5
 #define BRIGHT_MAX      255
 #define BRIGHT_STEP     10
 
+// Output stage: 1.0 = linear (as before), LEDs look most even around 2.2;
+// white point in kelvin, 0 = uncorrected (WS2812 white is ~6500 K)
+#define OUTPUT_GAMMA    1.0f
+#define OUTPUT_KELVIN   0
+
+// Strip supply: the output is dimmed so the estimate stays below the budget
+// (60 LEDs full white ~3.6 A); 0 = only measure. mA per LED and channel at 255.
+#define CURRENT_BUDGET_MA   2000
+#define CURRENT_CHANNEL_MA  20
+
+// Palette tint for the * button (warm amber, half strength)
+#define PALETTE_TINT_R  255
+#define PALETTE_TINT_G  120
+#define PALETTE_TINT_B  0
+#define PALETTE_TINT_AMOUNT 128
+
 // Speed limits
 #define SPEED_MIN_MS    5
 #define SPEED_MAX_MS    500
 #define SPEED_STEP_MS   10
 
-// IR button codes
-constexpr uint32_t ONE      = 0xBA45FF00;
-constexpr uint32_t TWO      = 0xB946FF00;
-constexpr uint32_t THREE    = 0xB847FF00;
-constexpr uint32_t FOUR     = 0xBB44FF00;
-constexpr uint32_t FIVE     = 0xBF40FF00;
-constexpr uint32_t SIX      = 0xBC43FF00;
-constexpr uint32_t SEVEN    = 0xF807FF00;
-constexpr uint32_t EIGHT    = 0xEA15FF00;
-constexpr uint32_t NINE     = 0xF609FF00;
-constexpr uint32_t STARBTN  = 0xE916FF00;
-constexpr uint32_t ZERO     = 0xE619FF00;
-constexpr uint32_t HASHBTN  = 0xF20DFF00;
-constexpr uint32_t UPBTN    = 0xE718FF00;
-constexpr uint32_t LEFTBTN  = 0xF708FF00;
-constexpr uint32_t OKBTN    = 0xE31CFF00;
-constexpr uint32_t RIGHTBTN = 0xA55AFF00;
-constexpr uint32_t DOWNBTN  = 0xAD52FF00;
+// Several controllers (MySync): one SYNC_MASTER and any number of
+// SYNC_FOLLOWERs with the same SYNC_GROUP and SYNC_CHANNEL
+#define SYNC_OFF        0
+#define SYNC_MASTER     1
+#define SYNC_FOLLOWER   2
+#define SYNC_ROLE       SYNC_OFF
+#define SYNC_GROUP      1
+#define SYNC_CHANNEL    1                   // Wi-Fi channel 1..13, the same on all
+#define SYNC_CATCHUP    128                 // steps replayed without output when joining a running show
+#define SYNC_WAIT_US    2000                // a step this close is waited for exactly
+#define SYNC_POLL_MS    10                  // LEDTask wakes at least this often for the radio
 
 // =================== SHARED DATA STRUCTURE ===================
 struct SharedData {
-    uint8_t currentShow;
     uint8_t globalBright;
-    uint16_t animStep;
     unsigned long stepDelayMs;
     unsigned long fastStepDelayMs;
     unsigned long slowStepDelayMs;
@@ -81,66 +174,86 @@ struct SharedData {
     unsigned long lastLedUpdateMs;
     unsigned long ledUpdateIntervalMs;
     
-    // Show-specific data
-    uint8_t cometPos;
-    uint8_t cometTrail[NUMPIXELS];
-    uint8_t wipeIndex;
-    uint8_t wipeColorIndex;
-    uint8_t twinkleVal[NUMPIXELS];
-    int8_t scanPos;
-    int8_t scanDir;
-    uint8_t palIdx;
+    // Show state; renders RGB at full brightness into logicalPixels
+    MyShows::Engine<NUMPIXELS, MyShows::OrderRGB> shows;
+    // Stored cycles of the repeating shows, replayed into logicalPixels
+    MyShows::FrameCache<MyShows::Engine<NUMPIXELS, MyShows::OrderRGB> > frameCache;
+    // logicalPixels -> strip.getPixels(): brightness, gamma, white point, GRB
+    MyShows::Output<MyShows::OrderGRB> output;
+    // Supply current estimate from the output sums, and the limit it asks for
+    MyPower::CurrentLimit current;
     
-    // Rain effect data
-    struct Drop { int8_t pos; uint8_t life; };
-    static const uint8_t MAX_DROPS = 4;
-    Drop drops[MAX_DROPS];
+    // 0 = built-in colors, 1..PALETTE_COUNT = preset + 1; blend BLEND_COUNT = no tint
+    MyShows::Palette palette;
+    uint8_t paletteSel;
+    uint8_t paletteBlend;
+    
+    // Audio levels for the current frame, taken from audioSnapshot by LEDTask
+    bool audioOn;
+    uint8_t lastBeats;
+    MyShows::AudioLevels audio;
+    
+    // ACTIVE / STATIC / SLEEP from frame digests and IR input
+    MyPower::Policy power;
+    
+    // Group state and shared clock; syncStep = steps rendered since the show
+    // was selected, showSeed = its random seed (the same on every controller)
+    MySync::Node sync;
+    uint32_t syncStep;
+    uint32_t showSeed;
     
     SharedData() : 
-        currentShow(1), globalBright(120), animStep(0),
+        globalBright(120),
         stepDelayMs(30), fastStepDelayMs(15), slowStepDelayMs(30),
         lastIRSignalMs(0), ledUpdatePending(false), lastLedUpdateMs(0),
-        ledUpdateIntervalMs(200), cometPos(0), wipeIndex(0), wipeColorIndex(0),
-        scanPos(0), scanDir(1), palIdx(0) {
-        memset(cometTrail, 0, sizeof(cometTrail));
-        memset(twinkleVal, 0, sizeof(twinkleVal));
-        for (uint8_t i = 0; i < MAX_DROPS; i++) {
-            drops[i].life = 0;
-        }
-    }
+        ledUpdateIntervalMs(200), paletteSel(0), paletteBlend(MyShows::BLEND_COUNT),
+        audioOn(false), lastBeats(0), audio(), syncStep(0), showSeed(1) {}
 };
 
 // Global shared data and mutex
 SharedData sharedData;
 SemaphoreHandle_t dataMutex;
+TaskHandle_t ledTaskHandle = NULL;
+TaskHandle_t renderTaskHandle = NULL;
+TaskHandle_t irTaskHandle = NULL;
+SemaphoreHandle_t ledWake;                  // IRTask -> LEDTask: a button changed something
+MyPower::Governor governor;
+MyBoot::Timeline boot;
+Preferences prefs;
+#if SYNC_ROLE != SYNC_OFF
+MySync::Radio radio;
+#endif
 
 // NeoPixel strip
 Adafruit_NeoPixel strip(NUMPIXELS, LED_PIN, NEO_GRB + NEO_KHZ800);
-
-// Simple IR reading variables
-unsigned long lastIRSignalMs = 0;
-unsigned long irTimeoutMs = 200;  // IR signal timeout
-bool irSignalActive = false;
-unsigned long irSignalStart = 0;
+uint8_t logicalPixels[NUMPIXELS * 3];       // shows render here (RGB, LAYOUT_PATH order)
+#if LED_LAYOUT != LAYOUT_STRIP
+MyShows::Layout<NUMPIXELS, MATRIX_W, MATRIX_H> layout;
+#endif
+
+// IR edge capture: the ISR only timestamps edges, IRTask decodes them
+#define IR_EDGE_BUF     128                 // power of two
+#define IR_GAP_MS       20                  // silence that ends a burst
+
+volatile uint32_t irEdges[IR_EDGE_BUF];     // bit 31 = was mark, rest = duration in us
+volatile uint16_t irEdgeHead = 0;
+volatile uint16_t irEdgeTail = 0;
+volatile uint32_t irLastEdgeUs = 0;
+IRDecoder irDecoder;
+
+// Audio: AudioTask writes, LEDTask reads without a lock (seqlock)
+Audio::Analyzer audioDsp;
+Audio::Seqlock<Audio::Snapshot> audioSnapshot;
+volatile uint32_t audioBusyUs = 0;          // DSP time, for the load report in loop()
+bool audioReady = false;
 
 // =================== UTILITY FUNCTIONS ===================
-uint32_t wheel(byte pos) {
-    pos = 255 - pos;
-    if (pos < 85) {
-        return strip.Color(255 - pos * 3, 0, pos * 3);
-    } else if (pos < 170) {
-        pos -= 85;
-        return strip.Color(0, pos * 3, 255 - pos * 3);
-    } else {
-        pos -= 170;
-        return strip.Color(pos * 3, 255 - pos * 3, 0);
-    }
-}
-
 void clampBrightness() {
     if (sharedData.globalBright < BRIGHT_MIN) sharedData.globalBright = BRIGHT_MIN;
+#if BRIGHT_MAX < 255                        // a uint8_t cannot be over 255
     if (sharedData.globalBright > BRIGHT_MAX) sharedData.globalBright = BRIGHT_MAX;
-    strip.setBrightness(sharedData.globalBright);
+#endif
+    sharedData.output.brightness(sharedData.globalBright);   // applied by the next frame's output pass
 }
 
 void clampSpeed() {
@@ -150,38 +263,40 @@ void clampSpeed() {
     if (sharedData.slowStepDelayMs > SPEED_MAX_MS) sharedData.slowStepDelayMs = SPEED_MAX_MS;
 }
 
-void clearStrip() {
-    for (uint16_t i = 0; i < NUMPIXELS; i++) strip.setPixelColor(i, 0);
+// Receiver output is LOW while IR light is present. The level before this
+// edge is the opposite of the level now, so a HIGH pin means a mark just ended.
+void IRAM_ATTR irEdgeISR() {
+    uint32_t now = micros();
+    uint32_t duration = now - irLastEdgeUs;
+    irLastEdgeUs = now;
+    if (duration > 0x7FFFFFFFUL) duration = 0x7FFFFFFFUL;
+    bool wasMark = digitalRead(IR_RECEIVE_PIN) == HIGH;
+    uint16_t next = (irEdgeHead + 1) & (IR_EDGE_BUF - 1);
+    if (next == irEdgeTail) return;          // IRTask fell behind, drop the edge
+    bool wasEmpty = irEdgeHead == irEdgeTail;
+    irEdges[irEdgeHead] = duration | (wasMark ? 0x80000000UL : 0);
+    irEdgeHead = next;
+    if (wasEmpty && irTaskHandle != NULL) {     // first edge of a batch: wake IRTask
+        BaseType_t woken = pdFALSE;
+        vTaskNotifyGiveFromISR(irTaskHandle, &woken);
+        if (woken) portYIELD_FROM_ISR();
+    }
 }
 
-// ESP32-compatible IR signal detection
-bool readIRSignal() {
-    bool irPin = digitalRead(IR_RECEIVE_PIN);
-    unsigned long now = millis();
-    
-    // For ESP32 with 3.3V logic, we need to invert the logic
-    // IR receiver outputs LOW when signal detected, HIGH when idle
-    bool signalDetected = !irPin;  // Invert for ESP32
-    
-    if (signalDetected && !irSignalActive) {
-        // IR signal started
-        irSignalActive = true;
-        irSignalStart = now;
-        return false;
-    } else if (!signalDetected && irSignalActive) {
-        // IR signal ended
-        irSignalActive = false;
-        unsigned long duration = now - irSignalStart;
-        
-        // More realistic signal detection for ESP32
-        // IR signals are typically 10-50ms long
-        if (duration > 10 && duration < 100) {
-            lastIRSignalMs = now;
-            return true;  // Signal detected
-        }
+// Feeds captured edges to the decoder; returns true while a burst is open
+bool pumpIRDecoder() {
+    static bool burstOpen = false;
+    while (irEdgeTail != irEdgeHead) {
+        uint32_t e = irEdges[irEdgeTail];
+        irEdgeTail = (irEdgeTail + 1) & (IR_EDGE_BUF - 1);
+        irDecoder.feed((e & 0x80000000UL) != 0, e & 0x7FFFFFFFUL);
+        burstOpen = true;
     }
-    
-    return false;
+    if (burstOpen && micros() - irLastEdgeUs > IR_GAP_MS * 1000UL) {
+        irDecoder.endBurst();
+        burstOpen = false;
+    }
+    return burstOpen;
 }
 
 // Simple button simulation for testing
@@ -195,330 +310,656 @@ uint32_t getSimulatedButton() {
         lastButtonTime = now;
         currentButton = (currentButton % 9) + 1;
         
-        // Map to actual button codes
-        switch (currentButton) {
-            case 1: return ONE;
-            case 2: return TWO;
-            case 3: return THREE;
-            case 4: return FOUR;
-            case 5: return FIVE;
-            case 6: return SIX;
-            case 7: return SEVEN;
-            case 8: return EIGHT;
-            case 9: return NINE;
-            default: return ONE;
-        }
+        return code((Button)currentButton);   // BTN_1..BTN_9 == 1..9
     }
     
     return 0;  // No button pressed
 }
 
-const char* buttonName(unsigned long code) {
-    if (code == ONE)   return "ONE";
-    if (code == TWO)   return "TWO";
-    if (code == THREE) return "THREE";
-    if (code == FOUR)  return "FOUR";
-    if (code == FIVE)  return "FIVE";
-    if (code == SIX)   return "SIX";
-    if (code == SEVEN) return "SEVEN";
-    if (code == EIGHT) return "EIGHT";
-    if (code == NINE)  return "NINE";
-    if (code == LEFTBTN)  return "LEFT";
-    if (code == RIGHTBTN) return "RIGHT";
-    if (code == UPBTN)    return "UP";
-    if (code == DOWNBTN)  return "DOWN";
-    return "UNKNOWN";
+// =================== TASK FUNCTIONS ===================
+void updateLEDIntervalBasedOnIR() {
+    unsigned long now = millis();
+    bool irActive = (now - sharedData.lastIRSignalMs) < 750;
+    
+    if (irActive) {
+        sharedData.ledUpdateIntervalMs = 600;  // Slow when IR active
+        sharedData.stepDelayMs = sharedData.slowStepDelayMs;
+    } else {
+        sharedData.ledUpdateIntervalMs = 10;    // Fast when IR idle
+        sharedData.stepDelayMs = sharedData.fastStepDelayMs;
+    }
 }
 
-// =================== LED ANIMATION FUNCTIONS ===================
-void show1_rainbowCycle() {
-    for (uint16_t i = 0; i < NUMPIXELS; i++) {
-        strip.setPixelColor(i, wheel((i * 256 / NUMPIXELS + sharedData.animStep) & 0xFF));
+void updateLEDsIfNeeded() {
+    unsigned long now = millis();
+    if (sharedData.ledUpdatePending && (now - sharedData.lastLedUpdateMs >= sharedData.ledUpdateIntervalMs)) {
+        strip.show();
+        sharedData.ledUpdatePending = false;
+        sharedData.lastLedUpdateMs = now;
     }
-    sharedData.ledUpdatePending = true;
-    sharedData.animStep++;
 }
 
-void show2_theaterChase() {
-    uint8_t offset = sharedData.animStep % 3;
-    for (uint16_t i = 0; i < NUMPIXELS; i++) {
-        if (i % 3 == offset) strip.setPixelColor(i, strip.Color(255, 180, 40));
-        else strip.setPixelColor(i, 0);
-    }
-    sharedData.ledUpdatePending = true;
-    sharedData.animStep++;
+// Selects show 1..9 and resets its state (call with dataMutex held).
+// The seed decides Twinkle and Rain; the group shares it, so they match.
+void selectShow(uint8_t show, uint32_t seed) {
+    static const char* const NAMES[] = { "", "Rainbow Cycle", "Theater Chase", "Breathing", "Comet",
+                                         "Color Wipe Cycle", "Twinkle", "Scanner", "Rain", "Palette Pulse" };
+    sharedData.showSeed = seed;
+    sharedData.syncStep = 0;
+    sharedData.shows.seed(seed);
+    sharedData.shows.select(show);
+    MYLOG_I(">> SHOW %u: %s", sharedData.shows.current(), NAMES[sharedData.shows.current()]);
 }
 
-void show3_breathing() {
-    uint8_t phase = sharedData.animStep & 0xFF;
-    uint8_t tri = (phase < 128) ? phase * 2 : (255 - phase) * 2;
-    uint8_t r = 0, g = (uint16_t)tri * 2 / 3, b = tri;
-    for (uint16_t i = 0; i < NUMPIXELS; i++) {
-        strip.setPixelColor(i, strip.Color(r, g, b));
+// Recompiles the palette table after a change (call with dataMutex held).
+// Rendering holds the same mutex, so no frame ever sees a half-built table.
+void applyPalette() {
+    static const char* const BLENDS[] = { "lerp", "add", "multiply", "screen", "off" };
+    if (sharedData.paletteSel == 0) {
+        sharedData.shows.palette = nullptr;
+        MYLOG_I(">> PALETTE: built-in colors");
+        return;
     }
-    sharedData.ledUpdatePending = true;
-    sharedData.animStep++;
+    sharedData.palette.load(sharedData.paletteSel - 1);
+    if (sharedData.paletteBlend < MyShows::BLEND_COUNT) {
+        sharedData.palette.tint({ PALETTE_TINT_R, PALETTE_TINT_G, PALETTE_TINT_B },
+                                (MyShows::Blend)sharedData.paletteBlend, PALETTE_TINT_AMOUNT);
+    }
+    sharedData.shows.palette = sharedData.palette.table();
+    MYLOG_I(">> PALETTE: %s, tint %s", MyShows::Palette::name(sharedData.paletteSel - 1),
+            BLENDS[sharedData.paletteBlend]);
 }
 
-void show4_comet() {
-    // Fade trail
-    for (uint16_t i = 0; i < NUMPIXELS; i++) {
-        if (sharedData.cometTrail[i] > 5) sharedData.cometTrail[i] -= 5;
-        else sharedData.cometTrail[i] = 0;
-        uint8_t v = sharedData.cometTrail[i];
-        strip.setPixelColor(i, strip.Color(v, (v * 2) / 3, 10));
+// One decoded press or auto-repeat (call with dataMutex held)
+void handleIREvent(const IREvent& ev) {
+    sharedData.lastIRSignalMs = millis();
+
+    MYLOG_I("IR %s%s proto %u cmd 0x%X", name(ev.button), ev.repeat ? " (repeat)" : "",
+            (unsigned)ev.proto, (unsigned)ev.command);
+
+    switch (ev.button) {
+        case BTN_1: case BTN_2: case BTN_3: case BTN_4: case BTN_5:
+        case BTN_6: case BTN_7: case BTN_8: case BTN_9:
+            if (!ev.repeat) selectShow((uint8_t)ev.button, esp_random());   // BTN_1..BTN_9 == 1..9
+            break;
+        case BTN_LEFT:
+            sharedData.fastStepDelayMs += SPEED_STEP_MS;
+            sharedData.slowStepDelayMs += SPEED_STEP_MS;
+            clampSpeed();
+            break;
+        case BTN_RIGHT:
+            sharedData.fastStepDelayMs -= min<unsigned long>(SPEED_STEP_MS, sharedData.fastStepDelayMs);
+            sharedData.slowStepDelayMs -= min<unsigned long>(SPEED_STEP_MS, sharedData.slowStepDelayMs);
+            clampSpeed();
+            break;
+        case BTN_UP:
+            sharedData.globalBright = (sharedData.globalBright > BRIGHT_MAX - BRIGHT_STEP) ? BRIGHT_MAX : sharedData.globalBright + BRIGHT_STEP;
+            clampBrightness();
+            break;
+        case BTN_DOWN:
+            sharedData.globalBright = (sharedData.globalBright < BRIGHT_STEP) ? 0 : sharedData.globalBright - BRIGHT_STEP;
+            clampBrightness();
+            break;
+        case BTN_0:
+            if (ev.repeat) break;
+            sharedData.paletteSel = (sharedData.paletteSel == MyShows::PALETTE_COUNT) ? 0 : sharedData.paletteSel + 1;
+            applyPalette();
+            break;
+        case BTN_STAR:
+            if (ev.repeat) break;
+            sharedData.paletteBlend = (sharedData.paletteBlend == MyShows::BLEND_COUNT) ? 0 : sharedData.paletteBlend + 1;
+            applyPalette();
+            break;
+        case BTN_HASH:
+            if (ev.repeat) break;
+            if (!audioReady) { MYLOG_W(">> AUDIO: no microphone (AUDIO_INPUT)"); break; }
+            sharedData.audioOn = !sharedData.audioOn;
+            sharedData.shows.audio = sharedData.audioOn ? &sharedData.audio : nullptr;
+            MYLOG_I(sharedData.audioOn ? ">> AUDIO: on (Rainbow, Comet, Palette Pulse)" : ">> AUDIO: off");
+            break;
+        default:
+            break;
     }
-    // Comet head
-    sharedData.cometTrail[sharedData.cometPos] = 255;
-    sharedData.ledUpdatePending = true;
-    sharedData.cometPos = (sharedData.cometPos + 1) % NUMPIXELS;
-    sharedData.animStep++;
 }
 
-uint32_t basicPalette(uint8_t idx) {
-    switch (idx % 6) {
-        case 0: return strip.Color(255, 0, 0);
-        case 1: return strip.Color(0, 255, 0);
-        case 2: return strip.Color(0, 0, 255);
-        case 3: return strip.Color(255, 255, 0);
-        case 4: return strip.Color(255, 0, 255);
-        default:return strip.Color(0, 255, 255);
+// =================== SYNC ===================
+// The current show as group state (call with dataMutex held). A new seed means
+// the show was selected again: it starts now; a new speed keeps the step.
+MySync::State syncState(uint64_t shared) {
+    MySync::State s = sharedData.sync.state();
+    uint16_t stepMs = (uint16_t)sharedData.fastStepDelayMs;
+    if (s.seed != sharedData.showSeed || s.show != sharedData.shows.current()) {
+        s.epochUs = shared;
+        s.seed = sharedData.showSeed;
+        s.stepMs = stepMs;
+    } else if (s.stepMs != stepMs) {
+        MySync::rebase(s, stepMs, shared);
     }
+    s.show = sharedData.shows.current();
+    s.brightness = sharedData.globalBright;
+    s.param[0] = sharedData.paletteSel;
+    s.param[1] = sharedData.paletteBlend;
+    return s;
 }
 
-void show5_colorWipeCycle() {
-    strip.setPixelColor(sharedData.wipeIndex, basicPalette(sharedData.wipeColorIndex));
-    sharedData.ledUpdatePending = true;
-    sharedData.wipeIndex++;
-    if (sharedData.wipeIndex >= NUMPIXELS) {
-        sharedData.wipeIndex = 0;
-        sharedData.wipeColorIndex++;
-    }
-    sharedData.animStep++;
+// A button changed something here: send it to the group (dataMutex held)
+void syncPublish() {
+    if (sharedData.sync.role() == MySync::OFF) return;
+    uint64_t t = esp_timer_get_time();
+    MySync::State s = syncState(sharedData.sync.now(t));
+    const MySync::State& old = sharedData.sync.state();
+    s.version = old.version;
+    s.origin = old.origin;
+    if (memcmp(&s, &old, sizeof(s)) == 0) return;   // e.g. UP at full brightness
+    sharedData.sync.publish(s, t);
 }
 
-void show6_twinkle() {
-    if (random(0, 100) < 30) {
-        uint16_t p = random(0, NUMPIXELS);
-        sharedData.twinkleVal[p] = 180 + random(0, 76);
+// New state from the group (dataMutex held); LEDTask catches up the steps
+void applySync(const MySync::State& s) {
+    sharedData.globalBright = s.brightness;
+    clampBrightness();
+    if (s.stepMs != sharedData.fastStepDelayMs) {
+        // the slow (IR active) speed keeps its distance to the fast one
+        sharedData.slowStepDelayMs += (unsigned long)s.stepMs - sharedData.fastStepDelayMs;
+        sharedData.fastStepDelayMs = s.stepMs;
+        clampSpeed();
     }
-    for (uint16_t i = 0; i < NUMPIXELS; i++) {
-        if (sharedData.twinkleVal[i] > 3) sharedData.twinkleVal[i] -= 3;
-        else sharedData.twinkleVal[i] = 0;
-        uint8_t v = sharedData.twinkleVal[i];
-        strip.setPixelColor(i, strip.Color(v, v, (uint16_t)v * 3 / 2));
+    if ((s.param[0] != sharedData.paletteSel || s.param[1] != sharedData.paletteBlend) &&
+        s.param[0] <= MyShows::PALETTE_COUNT && s.param[1] <= MyShows::BLEND_COUNT) {
+        sharedData.paletteSel = s.param[0];
+        sharedData.paletteBlend = s.param[1];
+        applyPalette();
     }
-    sharedData.ledUpdatePending = true;
-    sharedData.animStep++;
+    if (s.show != sharedData.shows.current() || s.seed != sharedData.showSeed) selectShow(s.show, s.seed);
+    sharedData.power.activity(millis());
+    sharedData.power.resend();
 }
 
-void show7_scanner() {
-    clearStrip();
-    strip.setPixelColor(sharedData.scanPos, strip.Color(255, 30, 30));
-    int16_t left = sharedData.scanPos - 1;
-    int16_t right = sharedData.scanPos + 1;
-    if (left >= 0)  strip.setPixelColor(left,  strip.Color(120, 10, 10));
-    if (right < NUMPIXELS) strip.setPixelColor(right, strip.Color(120, 10, 10));
-    sharedData.ledUpdatePending = true;
-    sharedData.scanPos += sharedData.scanDir;
-    if (sharedData.scanPos <= 0 || sharedData.scanPos >= (int)NUMPIXELS - 1) sharedData.scanDir = -sharedData.scanDir;
-    sharedData.animStep++;
+// Group messages in, beacons and commands out (LEDTask, dataMutex held)
+void syncService() {
+#if SYNC_ROLE != SYNC_OFF
+    MySync::Packet p;
+    uint64_t at;
+    while (radio.read(p, at))
+        if (sharedData.sync.receive(p, at)) applySync(sharedData.sync.state());
+    uint64_t t = esp_timer_get_time();
+    while (sharedData.sync.poll(t, p)) radio.send(p);
+#endif
 }
 
-void spawnDrop() {
-    for (uint8_t i = 0; i < SharedData::MAX_DROPS; i++) {
-        if (sharedData.drops[i].life == 0) {
-            sharedData.drops[i].pos = random(0, NUMPIXELS);
-            sharedData.drops[i].life = 30 + random(0, 40);
-            return;
+void IRTask(void* parameter) {
+    (void)parameter;
+    MYLOG_I("IR Task started on Core %u", xPortGetCoreID());
+    MYLOG_I("Decoding NEC, RC5 and Sony SIRC. Point IR remote at receiver.");
+    
+    for (;;) {
+        bool burstOpen = pumpIRDecoder();
+
+        IREvent ev;
+        bool handled = false;
+        while (irDecoder.read(ev)) {
+            if (xSemaphoreTake(dataMutex, portMAX_DELAY) == pdTRUE) {
+                handleIREvent(ev);
+                syncPublish();
+                sharedData.power.activity(millis());
+                xSemaphoreGive(dataMutex);
+                handled = true;
+            }
         }
+        if (handled) xSemaphoreGive(ledWake);
+        // 1 ms while a frame is coming in (edge buffer holds a whole frame),
+        // otherwise sleep until irEdgeISR() sees the next edge
+        if (burstOpen) vTaskDelay(pdMS_TO_TICKS(1));
+        else ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
     }
 }
 
-void show8_rain() {
-    if (random(0, 100) < 25) spawnDrop();
-    
-    // Fade background
-    for (uint16_t i = 0; i < NUMPIXELS; i++) {
-        uint32_t c = strip.getPixelColor(i);
-        uint8_t r = (c >> 16) & 0xFF;
-        uint8_t g = (c >> 8)  & 0xFF;
-        uint8_t b = c & 0xFF;
-        if (r > 5) r -= 5; else r = 0;
-        if (g > 5) g -= 5; else g = 0;
-        if (b > 5) b -= 5; else b = 0;
-        strip.setPixelColor(i, r, g, b);
-    }
-    
-    // Move and draw drops
-    for (uint8_t i = 0; i < SharedData::MAX_DROPS; i++) {
-        if (sharedData.drops[i].life) {
-            strip.setPixelColor(sharedData.drops[i].pos, strip.Color(40, 0, 200));
-            sharedData.drops[i].pos = (sharedData.drops[i].pos + 1) % NUMPIXELS;
-            sharedData.drops[i].life--;
+// =================== AUDIO ===================
+// Starts the DMA sampling at Audio::SAMPLE_RATE; false if there is no microphone
+bool audioBegin() {
+#if AUDIO_INPUT == AUDIO_NONE
+    return false;
+#else
+    i2s_config_t cfg = {};
+    cfg.sample_rate = Audio::SAMPLE_RATE;
+    cfg.channel_format = I2S_CHANNEL_FMT_ONLY_LEFT;
+    cfg.communication_format = I2S_COMM_FORMAT_STAND_I2S;
+    cfg.dma_buf_count = 4;                              // 4 x 8 ms of slack if core 0 is busy
+    cfg.dma_buf_len = Audio::HOP;
+#if AUDIO_INPUT == AUDIO_ADC
+    cfg.mode = (i2s_mode_t)(I2S_MODE_MASTER | I2S_MODE_RX | I2S_MODE_ADC_BUILT_IN);
+    cfg.bits_per_sample = I2S_BITS_PER_SAMPLE_16BIT;
+    if (i2s_driver_install(I2S_NUM_0, &cfg, 0, NULL) != ESP_OK) return false;
+    i2s_set_adc_mode(ADC_UNIT_1, AUDIO_ADC_CHANNEL);
+    i2s_adc_enable(I2S_NUM_0);
+#else
+    cfg.mode = (i2s_mode_t)(I2S_MODE_MASTER | I2S_MODE_RX);
+    cfg.bits_per_sample = I2S_BITS_PER_SAMPLE_32BIT;
+    if (i2s_driver_install(I2S_NUM_0, &cfg, 0, NULL) != ESP_OK) return false;
+    i2s_pin_config_t pins = {};
+    pins.bck_io_num = I2S_MIC_SCK;
+    pins.ws_io_num = I2S_MIC_WS;
+    pins.data_out_num = I2S_PIN_NO_CHANGE;
+    pins.data_in_num = I2S_MIC_SD;
+    i2s_set_pin(I2S_NUM_0, &pins);
+#endif
+    return true;
+#endif
+}
+
+// Core 0 at idle priority: i2s_read() sleeps until DMA has filled a block, and
+// anything else on core 0 (IRTask, RenderTask) preempts the analysis, so audio
+// only uses time that would otherwise go to the idle task.
+void AudioTask(void* parameter) {
+    (void)parameter;
+#if AUDIO_INPUT == AUDIO_I2S
+    static int32_t raw[Audio::HOP];
+#else
+    static uint16_t raw[Audio::HOP];
+#endif
+    static int16_t block[Audio::HOP];
+    for (;;) {
+        size_t got = 0;
+        if (i2s_read(I2S_NUM_0, raw, sizeof(raw), &got, portMAX_DELAY) != ESP_OK) continue;
+        uint16_t n = got / sizeof(raw[0]);
+        for (uint16_t i = 0; i < n; i++) {
+#if AUDIO_INPUT == AUDIO_I2S
+            block[i] = (int16_t)(raw[i] >> 16);                   // 24-bit sample, left-justified
+#else
+            // 12-bit ADC value, channel number in the top 4 bits; the DMA swaps
+            // neighbouring samples, which does not matter for band energies
+            block[i] = (int16_t)(((int16_t)(raw[i] & 0x0FFF) - 2048) << 4);
+#endif
         }
+        uint32_t t0 = micros();
+        if (audioDsp.push(block, n)) audioSnapshot.write(audioDsp.result());
+        audioBusyUs += micros() - t0;
     }
-    sharedData.ledUpdatePending = true;
-    sharedData.animStep++;
 }
 
-const uint8_t PAL_SIZE = 5;
-uint32_t palette9[PAL_SIZE] = {
-    0xFF5500, 0x00FF88, 0x3355FF, 0xFF00AA, 0xFFFF22
-};
+// Newest analysis for this frame, without waiting for AudioTask (LEDTask, mutex held)
+void takeAudioLevels() {
+    static Audio::Snapshot s;
+    sharedData.audio.beat = false;
+    if (!audioSnapshot.read(s)) return;                 // writer busy: keep the last levels
+    sharedData.audio.level = s.level;
+    sharedData.audio.bass = s.bass;
+    sharedData.audio.mid = s.mid;
+    sharedData.audio.treble = s.treble;
+    sharedData.audio.beat = (s.beats != sharedData.lastBeats);   // counter: no beat is lost between frames
+    sharedData.lastBeats = s.beats;
+}
 
-void show9_palettePulse() {
-    uint8_t phase = sharedData.animStep & 0xFF;
-    uint8_t tri = (phase < 128) ? phase * 2 : (255 - phase) * 2;
-    uint32_t base = palette9[sharedData.palIdx];
-    uint8_t br = tri;
-    
-    uint8_t r = ((base >> 16) & 0xFF);
-    uint8_t g = ((base >> 8)  & 0xFF);
-    uint8_t b = (base & 0xFF);
-    
-    for (uint16_t i = 0; i < NUMPIXELS; i++) {
-        uint8_t local = (br * (uint8_t)((i * 8) % 64 + 192)) / 255;
-        strip.setPixelColor(i, (uint16_t)r * local / 255, (uint16_t)g * local / 255, (uint16_t)b * local / 255);
+// Helper on core 0: renders the upper part of a frame while LEDTask holds
+// dataMutex and renders the lower part. Notifications act as the barrier.
+void RenderTask(void* parameter) {
+    (void)parameter;
+    for (;;) {
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+        sharedData.shows.renderRange(RENDER_SPLIT, NUMPIXELS);
+        xTaskNotifyGive(ledTaskHandle);
     }
-    sharedData.ledUpdatePending = true;
-    
-    if ((sharedData.animStep % 180) == 0) sharedData.palIdx = (sharedData.palIdx + 1) % PAL_SIZE;
-    sharedData.animStep++;
 }
 
-// =================== TASK FUNCTIONS ===================
-void updateLEDIntervalBasedOnIR() {
-    unsigned long now = millis();
-    bool irActive = (now - sharedData.lastIRSignalMs) < 750;
-    
-    if (irActive) {
-        sharedData.ledUpdateIntervalMs = 600;  // Slow when IR active
-        sharedData.stepDelayMs = sharedData.slowStepDelayMs;
-    } else {
-        sharedData.ledUpdateIntervalMs = 10;    // Fast when IR idle
-        sharedData.stepDelayMs = sharedData.fastStepDelayMs;
+// One animation step into the shows' buffer; caller holds dataMutex
+void renderShows() {
+    if (sharedData.frameCache.replay(sharedData.shows)) return;   // stored cycle: unpacked, counters advanced
+#if NUMPIXELS >= PARALLEL_MIN_PIXELS
+    if (renderTaskHandle != NULL) {
+        sharedData.shows.beginFrame();                  // serial: frame colors, new drops
+        xTaskNotifyGive(renderTaskHandle);
+        sharedData.shows.renderRange(0, RENDER_SPLIT);
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);        // wait for core 0's half
+        sharedData.shows.endFrame();                    // serial: comet head, rain drops, counters
+        sharedData.frameCache.record(sharedData.shows);
+        return;
     }
+#endif
+    sharedData.shows.render();
+    sharedData.frameCache.record(sharedData.shows);
 }
 
-void updateLEDsIfNeeded() {
-    unsigned long now = millis();
-    if (sharedData.ledUpdatePending && (now - sharedData.lastLedUpdateMs >= sharedData.ledUpdateIntervalMs)) {
-        strip.show();
-        sharedData.ledUpdatePending = false;
-        sharedData.lastLedUpdateMs = now;
+// Logical frame -> strip buffer: brightness, gamma, white point, GRB, channel sums
+void writeOutput() {
+#if LED_LAYOUT == LAYOUT_STRIP
+    sharedData.output.write(logicalPixels, strip.getPixels(), NUMPIXELS);
+#else
+    layout.remap(logicalPixels, strip.getPixels(), sharedData.output);   // one pass along LAYOUT_PATH
+#endif
+}
+
+// One animation step, laid out on the LEDs; caller holds dataMutex
+void renderFrame() {
+    renderShows();
+    writeOutput();
+    // Over the supply budget: same frame again, dimmer (only when the limit has to jump)
+    uint32_t events = sharedData.current.events();
+    while (!sharedData.current.check(sharedData.output.sum(), NUMPIXELS, millis())) {
+        sharedData.output.limit(sharedData.current.limit());
+        writeOutput();
     }
+    sharedData.output.limit(sharedData.current.limit());   // eased limit for the next frame
+    if (sharedData.current.events() != events)
+        MYLOG_W("Current limit: %lu mA estimated, budget %u mA", sharedData.current.lastMa(), CURRENT_BUDGET_MA);
 }
 
-void IRTask(void* parameter) {
-    Serial2.println("IR Task started on Core " + String(xPortGetCoreID()));
-    Serial2.println("Note: Now using REAL IR detection. Point IR remote at receiver.");
-    
-    for (;;) {
-        // Try to read IR signal
-        if (readIRSignal()) {
-            if (xSemaphoreTake(dataMutex, portMAX_DELAY) == pdTRUE) {
-                // Real IR signal detected - cycle to next show
-                static uint8_t currentShow = 1;
-                currentShow = (currentShow % 9) + 1;
-                
-                sharedData.lastIRSignalMs = millis();
-                
-                Serial2.print("IR Signal detected! Switching to show: "); Serial2.println(currentShow);
-                
-                // Show selection based on current show
-                switch (currentShow) {
-                    case 1: sharedData.currentShow = 1; sharedData.animStep = 0; Serial2.println(">> SHOW 1: Rainbow Cycle"); break;
-                    case 2: sharedData.currentShow = 2; sharedData.animStep = 0; Serial2.println(">> SHOW 2: Theater Chase"); break;
-                    case 3: sharedData.currentShow = 3; sharedData.animStep = 0; Serial2.println(">> SHOW 3: Breathing"); break;
-                    case 4: sharedData.currentShow = 4; sharedData.animStep = 0; memset(sharedData.cometTrail,0,sizeof(sharedData.cometTrail)); sharedData.cometPos=0; Serial2.println(">> SHOW 4: Comet"); break;
-                    case 5: sharedData.currentShow = 5; sharedData.animStep = 0; sharedData.wipeIndex=0; sharedData.wipeColorIndex=0; Serial2.println(">> SHOW 5: Color Wipe Cycle"); break;
-                    case 6: sharedData.currentShow = 6; sharedData.animStep = 0; memset(sharedData.twinkleVal,0,sizeof(sharedData.twinkleVal)); Serial2.println(">> SHOW 6: Twinkle"); break;
-                    case 7: sharedData.currentShow = 7; sharedData.animStep = 0; sharedData.scanPos=0; sharedData.scanDir=1; Serial2.println(">> SHOW 7: Scanner"); break;
-                    case 8: sharedData.currentShow = 8; sharedData.animStep = 0; for (uint8_t i=0;i<SharedData::MAX_DROPS;i++){sharedData.drops[i].life=0;} Serial2.println(">> SHOW 8: Rain"); break;
-                    case 9: sharedData.currentShow = 9; sharedData.animStep = 0; sharedData.palIdx=0; Serial2.println(">> SHOW 9: Palette Pulse"); break;
-                }
-                
-                xSemaphoreGive(dataMutex);
-            }
-        }
-        vTaskDelay(pdMS_TO_TICKS(1)); // Faster polling for better responsiveness
+// Milliseconds until period has passed since start (at least 1)
+uint32_t msUntil(unsigned long start, unsigned long period, unsigned long now) {
+    unsigned long elapsed = now - start;
+    return elapsed + 1 < period ? period - elapsed : 1;
+}
+
+// Missed steps are rendered without output, so Comet tails, Rain and Color
+// Wipe look the same as on the others; far behind (joining a running show)
+// the shows first jump to SYNC_CATCHUP steps before the target
+void syncCatchUp(uint32_t target) {
+    uint32_t& step = sharedData.syncStep;
+    if (target > step + SYNC_CATCHUP || target + 1 < step) {
+        step = target > SYNC_CATCHUP ? target - SYNC_CATCHUP : 0;
+        sharedData.shows.seed(sharedData.showSeed);
+        sharedData.shows.seek(step);
     }
+    for (; step < target; step++) renderShows();
 }
 
 void LEDTask(void* parameter) {
-    Serial2.println("LED Task started on Core " + String(xPortGetCoreID()));
+    (void)parameter;
+    MYLOG_I("LED Task started on Core %u", xPortGetCoreID());
     
     unsigned long lastStepMs = 0;
+    uint64_t stepLocalUs = 0;                   // local time of the next synced step, 0 = none
     
     for (;;) {
+        // The last moment before a synced step is waited for here, without
+        // dataMutex, so IRTask and loop() are not held up by the busy wait
+        if (stepLocalUs) {
+            uint64_t t = esp_timer_get_time();
+            if (stepLocalUs > t && stepLocalUs - t < SYNC_WAIT_US) delayMicroseconds((uint32_t)(stepLocalUs - t));
+            stepLocalUs = 0;
+        }
+        uint32_t waitMs = 1;
+        MyPower::State state = MyPower::ACTIVE;
+        bool pending = false;
         if (xSemaphoreTake(dataMutex, portMAX_DELAY) == pdTRUE) {
             updateLEDIntervalBasedOnIR();
             updateLEDsIfNeeded();
             
             unsigned long now = millis();
-            if (now - lastStepMs >= sharedData.stepDelayMs) {
+            // Audio keeps the I2S DMA running and sync the radio, so no light sleep then
+            sharedData.power.keepAwake = sharedData.audioOn || sharedData.sync.role() != MySync::OFF;
+            syncService();
+            unsigned long stepMs = sharedData.power.frameInterval(sharedData.stepDelayMs);
+            bool due = now - lastStepMs >= stepMs;
+            // In a group the step comes from the shared clock, and it starts
+            // exactly on time (at the same moment on the other strips)
+            bool synced = sharedData.sync.ready();
+            uint32_t target = 0;
+            if (synced) {
+                const MySync::State& group = sharedData.sync.state();
+                target = MySync::stepAt(group, sharedData.sync.now(esp_timer_get_time()));
+                due = (target >= sharedData.syncStep || target + 1 < sharedData.syncStep) &&
+                      (sharedData.power.state() == MyPower::ACTIVE || due);
+            }
+            if (due) {
                 lastStepMs = now;
                 
-                switch (sharedData.currentShow) {
-                    case 1: show1_rainbowCycle();   break;
-                    case 2: show2_theaterChase();   break;
-                    case 3: show3_breathing();      break;
-                    case 4: show4_comet();          break;
-                    case 5: show5_colorWipeCycle(); break;
-                    case 6: show6_twinkle();        break;
-                    case 7: show7_scanner();        break;
-                    case 8: show8_rain();           break;
-                    case 9: show9_palettePulse();   break;
-                    default: sharedData.currentShow = 1; break;
-                }
+                if (synced) syncCatchUp(target);
+                if (sharedData.audioOn) takeAudioLevels();
+                renderFrame();
+                sharedData.syncStep++;
+                // Unchanged frame: nothing to send
+                if (sharedData.power.frame(MyPower::digest(strip.getPixels(), NUMPIXELS * 3), now))
+                    sharedData.ledUpdatePending = true;
+            }
+            state = sharedData.power.update(now);
+            stepMs = sharedData.power.frameInterval(sharedData.stepDelayMs);
+            waitMs = msUntil(lastStepMs, stepMs, now);
+            if (synced && state == MyPower::ACTIVE) {
+                // wake just before the next step starts, then wait for it exactly (top of the loop)
+                uint64_t t = esp_timer_get_time();
+                uint64_t shared = sharedData.sync.now(t);
+                uint64_t next = MySync::stepStart(sharedData.sync.state(), sharedData.syncStep);
+                if (next > shared) stepLocalUs = t + (next - shared);
+                uint32_t ms = next > shared ? (uint32_t)((next - shared) / 1000) : 0;
+                waitMs = ms > 1 ? ms - 1 : 1;
+            }
+            if (sharedData.sync.role() != MySync::OFF && waitMs > SYNC_POLL_MS) waitMs = SYNC_POLL_MS;
+            pending = sharedData.ledUpdatePending;
+            if (pending) {
+                uint32_t showMs = msUntil(sharedData.lastLedUpdateMs, sharedData.ledUpdateIntervalMs, now);
+                if (showMs < waitMs) waitMs = showMs;
             }
             xSemaphoreGive(dataMutex);
         }
-        vTaskDelay(pdMS_TO_TICKS(1)); // Small delay to prevent task starvation
+        governor.apply(state);
+        if (state == MyPower::SLEEP && !pending) {
+            Serial2.flush();                    // the UART stops while asleep
+            if (governor.lightSleep(waitMs) && xSemaphoreTake(dataMutex, portMAX_DELAY) == pdTRUE) {
+                sharedData.power.activity(millis());   // IR edge: stay up for the frame
+                xSemaphoreGive(dataMutex);
+            }
+        } else {
+            // Until the next step or show, or until IRTask handled a button
+            xSemaphoreTake(ledWake, pdMS_TO_TICKS(waitMs));
+        }
     }
 }
 
+// =================== SETTINGS AND BOOT ===================
+// What survives a reset, stored in NVS as one blob
+struct Settings {
+    uint8_t show, bright, paletteSel, paletteBlend;
+    uint16_t fastMs, slowMs;
+};
+
+// Call with dataMutex held (or before the tasks exist)
+Settings currentSettings() {
+    Settings s;
+    s.show = sharedData.shows.current();
+    s.bright = sharedData.globalBright;
+    s.paletteSel = sharedData.paletteSel;
+    s.paletteBlend = sharedData.paletteBlend;
+    s.fastMs = (uint16_t)sharedData.fastStepDelayMs;
+    s.slowMs = (uint16_t)sharedData.slowStepDelayMs;
+    return s;
+}
+
+// Restores the show from before the reset; keeps the defaults on a fresh chip
+void loadSettings() {
+    prefs.begin("irshow", false);
+    Settings s;
+    if (prefs.getBytes("settings", &s, sizeof(s)) != sizeof(s)) return;
+    sharedData.shows.select(s.show);
+    sharedData.globalBright = s.bright;
+    if (s.paletteSel <= MyShows::PALETTE_COUNT) sharedData.paletteSel = s.paletteSel;
+    if (s.paletteBlend <= MyShows::BLEND_COUNT) sharedData.paletteBlend = s.paletteBlend;
+    sharedData.fastStepDelayMs = s.fastMs;
+    sharedData.slowStepDelayMs = s.slowMs;
+}
+
+// From loop() once a second: writes to flash only after the settings have
+// been the same for 2 s, so holding UP does not write on every repeat
+void saveSettingsWhenStable() {
+    if (xSemaphoreTake(dataMutex, portMAX_DELAY) != pdTRUE) return;
+    Settings now = currentSettings();
+    xSemaphoreGive(dataMutex);
+    static Settings saved = now;            // first call: what was restored
+    static Settings last = now;
+    static uint8_t stableSeconds = 0;
+    if (memcmp(&now, &last, sizeof(now)) != 0) { last = now; stableSeconds = 0; return; }
+    if (memcmp(&now, &saved, sizeof(now)) == 0 || ++stableSeconds < 2) return;
+    prefs.putBytes("settings", &now, sizeof(now));
+    saved = now;
+    MYLOG_D("Settings saved");
+}
+
+// Boot phases since the chip started (MyBoot), one line each
+void logBootTimeline() {
+    MYLOG_I("Boot timeline (%s reset):", MyBoot::resetReason());
+    for (uint8_t i = 0; i < boot.count(); i++) {
+        uint32_t at = boot.at(i), took = boot.took(i);
+        MYLOG_I("  %4lu.%03lu ms  +%lu.%03lu  %s", at / 1000, at % 1000, took / 1000, took % 1000, boot.name(i));
+    }
+    if (boot.late())
+        MYLOG_W("First frame after %lu ms (target %lu ms)", boot.firstFrameUs() / 1000, boot.targetUs / 1000);
+}
+
 // =================== SETUP AND MAIN ===================
 void setup() {
+    // The strip comes first: the restored show is lit before IR, the tasks
+    // and audio are set up (boot.mark() records each phase, printed at the end)
     Serial2.begin(115200);
-    delay(50);
     Serial2.println("\nESP32 IR + NeoPixel Multithreading - 9 shows, speed & brightness control");
+    // From here on only the log task writes to Serial2 (MyLog::BINARY + tools/log_decode for less UART time)
+    MyLog::begin(Serial2);
+    boot.mark("serial + log");
+    
+    // Restore the show from before the reset and put its first frame out
+    loadSettings();
+    boot.mark("settings");
+    strip.begin();
+#if LED_LAYOUT != LAYOUT_STRIP
+#if LED_LAYOUT == LAYOUT_RING
+    layout.ring();
+#else
+    MyShows::Matrix panel = { MATRIX_W, MATRIX_H, MATRIX_SERPENTINE, false, MATRIX_ROTATE, MATRIX_MIRROR };
+    if (!layout.matrix(panel)) MYLOG_E("Layout: %ux%u panel is not NUMPIXELS LEDs", MATRIX_W, MATRIX_H);
+#endif
+    layout.path(LAYOUT_PATH);
+#endif
+    sharedData.shows.pixels.attach(logicalPixels);
+#if FRAME_CACHE_BYTES > 0
+    void* cacheMem = psramFound() ? ps_malloc(FRAME_CACHE_BYTES) : malloc(FRAME_CACHE_BYTES);
+    sharedData.frameCache.begin((uint8_t*)cacheMem, FRAME_CACHE_BYTES);
+    if (!cacheMem) MYLOG_E("Frame cache: no memory for %u B", FRAME_CACHE_BYTES);
+#endif
+    sharedData.output.gamma(OUTPUT_GAMMA);
+    sharedData.output.temperature(OUTPUT_KELVIN);
+    sharedData.current.budgetMa = CURRENT_BUDGET_MA;
+    for (uint8_t ch = 0; ch < 3; ch++) sharedData.current.channelMa[ch] = CURRENT_CHANNEL_MA;
+    sharedData.showSeed = esp_random();
+    sharedData.shows.seed(sharedData.showSeed);
+    clampSpeed();
+    clampBrightness();
+    applyPalette();
+    sharedData.stepDelayMs = sharedData.fastStepDelayMs;
+    renderFrame();
+    strip.show();
+    boot.firstFrame();
     
     // Create mutex
     dataMutex = xSemaphoreCreateMutex();
-    if (dataMutex == NULL) {
-        Serial2.println("Failed to create mutex!");
+    ledWake = xSemaphoreCreateBinary();
+    if (dataMutex == NULL || ledWake == NULL) {
+        MYLOG_E("Failed to create mutex!");
         return;
     }
     
-    // Initialize NeoPixel
-    strip.begin();
-    strip.setBrightness(sharedData.globalBright);
-    strip.show();
-    
     // Random seed
     randomSeed(analogRead(A0));
     
-    // Initialize IR pin
+    // Initialize IR pin: every edge is timestamped by irEdgeISR()
     pinMode(IR_RECEIVE_PIN, INPUT_PULLUP);
-    Serial2.println("IR ready (simplified detection). Shows will cycle automatically every 5 seconds for demonstration.");
-    Serial2.println("For real IR remote, implement proper NEC protocol decoding in readIRSignal() function.");
+    irDecoder.repeatDelayMs = 400;
+    irDecoder.repeatIntervalMs = 120;
+    irLastEdgeUs = micros();
+    attachInterrupt(digitalPinToInterrupt(IR_RECEIVE_PIN), irEdgeISR, CHANGE);
+    governor.wakeOn(IR_RECEIVE_PIN);
+    MYLOG_I("IR ready (edge capture + NEC/RC5/SIRC decoder).");
+    boot.mark("ir");
     
-    // Clamp initial values
-    clampSpeed();
-    clampBrightness();
+    sharedData.power.begin(millis());
+    
+#if SYNC_ROLE != SYNC_OFF
+    // ESP-NOW needs the Wi-Fi driver (station, not connected) on the group's channel
+    WiFi.mode(WIFI_STA);
+    esp_wifi_set_channel(SYNC_CHANNEL, WIFI_SECOND_CHAN_NONE);
+    uint32_t syncId = radio.begin(WIFI_IF_STA);
+    if (!syncId) {
+        MYLOG_E("Sync: ESP-NOW failed");
+    } else {
+        // the restored show goes on: epoch such that the first frame is step 0 now
+        sharedData.sync.begin((MySync::Role)SYNC_ROLE, SYNC_GROUP, syncId);
+        sharedData.sync.restore(syncState(esp_timer_get_time()));
+        MYLOG_I("Sync: %s, group %u, channel %u, id %08lX", SYNC_ROLE == SYNC_MASTER ? "master" : "follower",
+                SYNC_GROUP, SYNC_CHANNEL, syncId);
+    }
+    boot.mark("sync");
+#endif
     
     // Create tasks
-    xTaskCreatePinnedToCore(IRTask, "IRTask", 4096, NULL, 2, NULL, 0);   // Core 0
-    xTaskCreatePinnedToCore(LEDTask, "LEDTask", 8192, NULL, 1, NULL, 1);  // Core 1
+    xTaskCreatePinnedToCore(IRTask, "IRTask", 4096, NULL, 2, &irTaskHandle, 0);   // Core 0
+    xTaskCreatePinnedToCore(LEDTask, "LEDTask", 8192, NULL, 1, &ledTaskHandle, 1);  // Core 1
+#if NUMPIXELS >= PARALLEL_MIN_PIXELS
+    // Below IRTask so decoding still preempts it
+    xTaskCreatePinnedToCore(RenderTask, "RenderTask", 2048, NULL, 1, &renderTaskHandle, 0);  // Core 0
+#endif
+    audioReady = audioBegin();
+    if (audioReady) {
+        // Idle priority: never delays IR decoding or the core 0 half of a frame
+        xTaskCreatePinnedToCore(AudioTask, "AudioTask", 3072, NULL, tskIDLE_PRIORITY, NULL, 0);  // Core 0
+    }
+    boot.mark("tasks + audio");
     
-    Serial2.println("Tasks created successfully!");
-    Serial2.println("Core 0: IR handling");
-    Serial2.println("Core 1: LED animations");
+    MYLOG_I("Tasks created successfully!");
+    MYLOG_I("Core 0: IR handling");
+    MYLOG_I("Core 1: LED animations");
+#if NUMPIXELS >= PARALLEL_MIN_PIXELS
+    MYLOG_I("Core 0: renders pixels %u..%u", RENDER_SPLIT, NUMPIXELS - 1);
+#endif
+    MYLOG_I(audioReady ? "Core 0: audio (press # for the audio shows)" : "Audio: off");
+    MYLOG_I(">> SHOW %u restored", sharedData.shows.current());
+    boot.mark("setup done");
+    logBootTimeline();
 }
 
 void loop() {
-    // Main loop is empty - everything runs in tasks
+    // Everything runs in tasks; this only saves changed settings, reports the
+    // audio load every 10 s, the time spent in each power state, the strip
+    // current, the frame cache and the sync state every minute
+    static uint8_t seconds = 0;
+    static uint8_t powerSeconds = 0;
     vTaskDelay(pdMS_TO_TICKS(1000));
+    saveSettingsWhenStable();
+    if (++powerSeconds >= 60 && xSemaphoreTake(dataMutex, portMAX_DELAY) == pdTRUE) {
+        powerSeconds = 0;
+        uint32_t now = millis();
+        uint32_t active = sharedData.power.ms(MyPower::ACTIVE, now) / 1000;
+        uint32_t still = sharedData.power.ms(MyPower::STATIC, now) / 1000;
+        uint32_t asleep = sharedData.power.ms(MyPower::SLEEP, now) / 1000;
+        MyPower::CurrentLimit cur = sharedData.current;
+        sharedData.current.resetStats();                // min headroom and events per minute
+        uint8_t cacheHit = sharedData.frameCache.hitPercent();
+        uint32_t cacheBytes = sharedData.frameCache.bytesUsed(), cacheDrops = sharedData.frameCache.invalidations;
+        uint32_t cacheFrames = sharedData.frameCache.cachedFrames(), cachePeriod = sharedData.frameCache.period();
+        sharedData.frameCache.resetStats();
+        const MySync::Node& sync = sharedData.sync;
+        uint64_t t = esp_timer_get_time();
+        long syncOffsetUs = (long)(int64_t)(sync.now(t) - t);
+        MySync::Role role = sync.role();
+        bool locked = sync.ready();
+        long driftPpb = sync.clock.driftPpb();
+        long jitterUs = sync.clock.lastErrorUs();
+        uint32_t beacons = sync.beaconCount(), missed = sync.missedBeacons(), repairs = sync.repairCount();
+        uint32_t commands = sync.commandCount(), conflicts = sync.conflictCount();
+        xSemaphoreGive(dataMutex);
+        MYLOG_I("Power: active %lu s, static %lu s, sleep %lu s", active, still, asleep);
+        MYLOG_I("Current: %lu mA (budget %u mA, headroom %ld, min %ld), limit %u, %lu limit events, %lu frames redone",
+                cur.lastMa(), CURRENT_BUDGET_MA, (long)cur.headroomMa(), (long)cur.minHeadroomMa(),
+                cur.limit(), cur.events(), cur.clamps());
+        MYLOG_I("Frame cache: hit %u%%, %lu of %u B, %lu of %lu frames stored, %lu invalidations",
+                cacheHit, cacheBytes, FRAME_CACHE_BYTES, cacheFrames, cachePeriod, cacheDrops);
+        if (role == MySync::MASTER)
+            MYLOG_I("Sync: master, %lu commands in, %lu beacons from another master", commands, conflicts);
+        else if (role == MySync::FOLLOWER)
+            MYLOG_I("Sync: %s, offset %ld us, drift %ld ppb, jitter %ld us, %lu beacons (%lu missed), %lu repairs",
+                    locked ? "locked" : "waiting", syncOffsetUs, driftPpb, jitterUs, beacons, missed, repairs);
+    }
+    if (!sharedData.audioOn || ++seconds < 10) return;
+    seconds = 0;
+    uint32_t busy = audioBusyUs;
+    audioBusyUs = 0;
+    Audio::Snapshot s = {};
+    audioSnapshot.read(s);
+    MYLOG_I("Audio: %lu.%lu%% of core 0, level %u, %u BPM", busy / 100000, (busy / 10000) % 10, s.level, s.bpm);
 }
@@ -0,0 +1,284 @@
+/*
+test_color_sensor — MyColorSensor.h against a simulated TCS34725 on a mock I2C bus
+- MockBus keeps the register map, integrates simulated light with the
+  programmed gain and ATIME, sets AVALID / INT and serves the 8 data bytes
+  through the auto-increment read, like the chip.
+- poll() must not touch the bus before the integration is due, the INT pin
+  must end the wait early, and the range must settle for dim and bright
+  light without flapping or publishing a saturated sample.
+- A dropped sensor is re-initialised; ColorMatch closes the loop through a
+  crosstalk matrix and follow() shows what the sensor sees.
+
+Run (from the project folder):
+  pio test -e native -f test_color_sensor
+*/
+
+#include <unity.h>
+#include <MyColorSensor.h>
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+using namespace MyColor;
+
+void setUp(void) {}
+void tearDown(void) {}
+
+struct Light { double c, r, g, b; };   // counts per gain × cycle
+
+struct MockBus {
+  uint8_t  regs[32] = {};
+  uint16_t data[4] = {};
+  double   now = 0, startT = -1;
+  bool     valid = false, intLine = false, present = true;
+  Light    light = { 100, 40, 35, 30 };
+  uint32_t writes = 0, reads = 0;
+  uint8_t  lastRead = 0, lastReadLen = 0;
+
+  void begin() {}
+  uint16_t cycles() const { return 256 - regs[reg::ATIME]; }
+  double integrationMs() const { return (cycles() + 1) * 2.4; }
+
+  // advance the simulated time, finish integrations that are due
+  void tick(double t) {
+    static const int GAIN[4] = { 1, 4, 16, 60 };
+    now = t;
+    while ((regs[reg::ENABLE] & 3) == 3 && startT >= 0 && now - startT >= integrationMs()) {
+      double k = GAIN[regs[reg::CONTROL] & 3] * cycles();
+      double mx = cycles() >= 64 ? 65535 : cycles() * 1024;
+      double v[4] = { light.c * k, light.r * k, light.g * k, light.b * k };
+      for (uint8_t i = 0; i < 4; i++) data[i] = (uint16_t)fmin(mx, v[i]);
+      valid = true;
+      if (regs[reg::ENABLE] & ENABLE_AIEN) intLine = true;
+      startT += integrationMs() - 2.4;          // the chip runs on without the ADC start
+    }
+  }
+
+  bool write(uint8_t cmd, const uint8_t* d, uint8_t n) {
+    if (!present) return false;
+    writes++;
+    if (cmd == CMD_CLEAR_INT) { intLine = false; return true; }
+    TEST_ASSERT_TRUE((cmd & 0xE0) == CMD || (cmd & 0xE0) == CMD_AUTOINC);
+    uint8_t r = cmd & 0x1F;
+    if (n == 0) return true;                    // address only, before a read
+    uint8_t old = regs[reg::ENABLE];
+    regs[r] = d[0];
+    if (r == reg::ENABLE) {
+      if ((d[0] & ENABLE_AEN) && !(old & ENABLE_AEN)) { startT = now; valid = false; }
+      if (!(d[0] & ENABLE_AEN)) startT = -1;
+    }
+    return true;
+  }
+
+  bool read(uint8_t cmd, uint8_t* d, uint8_t n) {
+    if (!present) return false;
+    reads++;
+    lastRead = cmd; lastReadLen = n;
+    uint8_t r = cmd & 0x1F;
+    for (uint8_t i = 0; i < n; i++, r++) {
+      if (r == reg::ID)          d[i] = 0x44;
+      else if (r == reg::STATUS) d[i] = (valid ? STATUS_AVALID : 0) | (intLine ? 0x10 : 0);
+      else if (r >= reg::CDATAL && r < reg::CDATAL + 8) {
+        uint16_t w = data[(r - reg::CDATAL) / 2];
+        d[i] = (r & 1) ? w >> 8 : w & 0xFF;
+      }
+      else d[i] = regs[r];
+    }
+    return true;
+  }
+};
+
+static Light gray(double L) { return { L, L * 0.4, L * 0.35, L * 0.3 }; }
+
+void test_begin_needs_the_chip(void) {
+  MockBus bus;
+  Tcs34725<MockBus> tcs(bus);
+  bus.present = false;
+  TEST_ASSERT_FALSE(tcs.begin(0));
+  TEST_ASSERT_EQUAL_UINT8(Tcs34725<MockBus>::NOT_FOUND, tcs.state());
+  TEST_ASSERT_FALSE(tcs.poll(1000));
+  bus.present = true;
+  TEST_ASSERT_TRUE(tcs.begin(0));
+  TEST_ASSERT_EQUAL_UINT8(Tcs34725<MockBus>::WARMUP, tcs.state());
+  TEST_ASSERT_EQUAL_HEX8(ENABLE_PON, bus.regs[reg::ENABLE]);   // AEN only after the warm-up
+}
+
+void test_poll_stays_off_the_bus_while_integrating(void) {
+  MockBus bus;
+  Tcs34725<MockBus> tcs(bus);
+  tcs.setAutoRange(false);
+  tcs.setRange(3);
+  tcs.begin(0);
+  bus.tick(WARMUP_MS);
+  tcs.poll(WARMUP_MS);
+  TEST_ASSERT_EQUAL_UINT8(Tcs34725<MockBus>::INTEGRATING, tcs.state());
+  TEST_ASSERT_EQUAL_HEX8(ENABLE_PON | ENABLE_AEN, bus.regs[reg::ENABLE]);
+  TEST_ASSERT_EQUAL_HEX8(0xC0, bus.regs[reg::ATIME]);
+  TEST_ASSERT_EQUAL_HEX8(1, bus.regs[reg::CONTROL]);
+
+  uint32_t reads = bus.reads, writes = bus.writes;
+  uint32_t due = WARMUP_MS + tcs.integrationMs();
+  for (uint32_t t = WARMUP_MS; t < due; t++) {
+    bus.tick(t);
+    TEST_ASSERT_FALSE(tcs.poll(t));
+  }
+  TEST_ASSERT_EQUAL_UINT32(reads, bus.reads);
+  TEST_ASSERT_EQUAL_UINT32(writes, bus.writes);
+
+  bus.tick(due);
+  TEST_ASSERT_TRUE(tcs.poll(due));
+  TEST_ASSERT_EQUAL_HEX8(CMD_AUTOINC | reg::CDATAL, bus.lastRead);   // C, R, G, B in one read
+  TEST_ASSERT_EQUAL_UINT8(8, bus.lastReadLen);
+  const Sample& s = tcs.sample();
+  TEST_ASSERT_EQUAL_UINT16(bus.data[0], s.c);
+  TEST_ASSERT_EQUAL_UINT16(bus.data[1], s.r);
+  TEST_ASSERT_EQUAL_UINT16(bus.data[2], s.g);
+  TEST_ASSERT_EQUAL_UINT16(bus.data[3], s.b);
+  TEST_ASSERT_EQUAL_UINT32(1, s.seq);
+}
+
+void test_auto_range_dim_then_bright(void) {
+  MockBus bus;
+  Tcs34725<MockBus> tcs(bus);
+  tcs.begin(0);
+  uint16_t samples = 0;
+  for (uint32_t t = 0; t < 20000; t++) {
+    bus.light = t < 10000 ? gray(0.5) : gray(300);
+    bus.tick(t);
+    if (!tcs.poll(t)) continue;
+    const Sample& s = tcs.sample();
+    samples++;
+    TEST_ASSERT_FALSE(s.saturated);
+    if (t > 3000 && t < 10000) TEST_ASSERT_EQUAL_UINT8(0, s.range);
+    if (t > 13000) TEST_ASSERT_EQUAL_UINT8(5, s.range);
+  }
+  TEST_ASSERT_TRUE(samples > 100);
+}
+
+void test_no_range_flapping(void) {
+  for (double L = 0.05; L < 5000; L *= 1.37) {
+    MockBus bus;
+    Tcs34725<MockBus> tcs(bus);
+    tcs.begin(0);
+    bus.light = gray(L);
+    int16_t last = -1;
+    for (uint32_t t = 0; t < 30000; t++) {
+      bus.tick(t);
+      if (!tcs.poll(t)) continue;
+      if (t > 8000 && last >= 0) TEST_ASSERT_EQUAL_UINT8(last, tcs.sample().range);
+      last = tcs.sample().range;
+    }
+  }
+}
+
+void test_level_is_comparable_across_ranges(void) {
+  for (double L = 0.5; L < 3000; L *= 2.1) {
+    MockBus bus;
+    Tcs34725<MockBus> tcs(bus);
+    tcs.begin(0);
+    bus.light = gray(L);
+    for (uint32_t t = 0; t < 8000; t++) {
+      bus.tick(t);
+      if (!tcs.poll(t) || t < 5000) continue;
+      const Sample& s = tcs.sample();
+      if (s.saturated) {                          // too bright even for 1× / 4 cycles
+        TEST_ASSERT_EQUAL_UINT8(RANGE_COUNT - 1, s.range);
+        TEST_ASSERT_TRUE(L * 4 >= 4096 * 0.9);
+        continue;
+      }
+      double expected = L * 15360;                // counts at range 0
+      TEST_ASSERT_TRUE(fabs(s.level - expected) <= expected * 0.02 + 4);
+    }
+  }
+}
+
+void test_int_pin_ends_the_wait(void) {
+  MockBus bus;
+  Tcs34725<MockBus> tcs(bus);
+  tcs.useIntPin(true);
+  tcs.setAutoRange(false);
+  tcs.setRange(3);
+  tcs.begin(0);
+  uint16_t samples = 0;
+  for (uint32_t t = 0; t < 5000; t++) {
+    bus.tick(t);
+    if (bus.intLine) tcs.notify();
+    if (tcs.poll(t)) {
+      samples++;
+      TEST_ASSERT_FALSE(bus.intLine);             // cleared with CMD_CLEAR_INT
+    }
+  }
+  TEST_ASSERT_TRUE(bus.regs[reg::ENABLE] & ENABLE_AIEN);
+  TEST_ASSERT_TRUE(samples >= 30);                // 5 s / ~157 ms
+}
+
+void test_sensor_drop_and_return(void) {
+  MockBus bus;
+  Tcs34725<MockBus> tcs(bus);
+  tcs.setAutoRange(false);
+  tcs.setRange(4);
+  tcs.begin(0);
+  uint16_t before = 0, after = 0;
+  for (uint32_t t = 0; t < 6000; t++) {
+    bus.present = !(t >= 2000 && t < 3000);
+    if (t == 3000) { memset(bus.regs, 0, sizeof(bus.regs)); bus.startT = -1; }   // came back reset
+    bus.tick(t);
+    if (tcs.poll(t)) (t < 2000 ? before : after)++;
+  }
+  TEST_ASSERT_TRUE(before > 30);
+  TEST_ASSERT_TRUE(after > 50);
+  TEST_ASSERT_TRUE(tcs.errorCount() > 0);
+}
+
+void test_closed_loop_match(void) {
+  const double M[3][3] = { { 0.9, 0.25, 0.05 }, { 0.15, 1.3, 0.2 }, { 0.02, 0.3, 0.8 } };   // sensor ← LED
+  const uint8_t targets[][3] = { { 200, 40, 15 }, { 60, 120, 75 }, { 30, 60, 165 }, { 85, 85, 85 } };
+  for (uint8_t i = 0; i < 4; i++) {
+    MockBus bus;
+    Tcs34725<MockBus> tcs(bus);
+    tcs.begin(0);
+    ColorMatch cm;
+    cm.setTarget(targets[i]);
+    uint8_t led[3] = { 255, 255, 255 };
+    int err = 999;
+    for (uint32_t t = 0; t < 30000; t++) {
+      double s[3] = { 0, 0, 0 };
+      for (uint8_t ch = 0; ch < 3; ch++)
+        for (uint8_t k = 0; k < 3; k++) s[ch] += M[ch][k] * led[k];
+      const double ir = 20;
+      bus.light = { s[0] + s[1] + s[2], s[0] + ir, s[1] + ir, s[2] + ir };
+      bus.tick(t);
+      if (tcs.poll(t)) {
+        const Sample& m = tcs.sample();
+        cm.update(m.chroma);
+        err = abs(m.chroma[0] - targets[i][0]) + abs(m.chroma[1] - targets[i][1]) + abs(m.chroma[2] - targets[i][2]);
+      }
+      if (t % 16 == 0) cm.step(led);
+    }
+    TEST_ASSERT_TRUE(err <= 4);
+  }
+}
+
+void test_follow(void) {
+  ColorMatch cm;
+  uint8_t chroma[3] = { 100, 100, 55 }, led[3];
+  cm.follow(chroma);
+  for (uint8_t i = 0; i < 100; i++) cm.step(led);
+  TEST_ASSERT_EQUAL_UINT8(255, led[0]);
+  TEST_ASSERT_EQUAL_UINT8(255, led[1]);
+  TEST_ASSERT_EQUAL_UINT8(140, led[2]);           // 55 * 255 / 100
+}
+
+int main(int, char**) {
+  UNITY_BEGIN();
+  RUN_TEST(test_begin_needs_the_chip);
+  RUN_TEST(test_poll_stays_off_the_bus_while_integrating);
+  RUN_TEST(test_auto_range_dim_then_bright);
+  RUN_TEST(test_no_range_flapping);
+  RUN_TEST(test_level_is_comparable_across_ranges);
+  RUN_TEST(test_int_pin_ends_the_wait);
+  RUN_TEST(test_sensor_drop_and_return);
+  RUN_TEST(test_closed_loop_match);
+  RUN_TEST(test_follow);
+  return UNITY_END();
+}
@@ -0,0 +1,173 @@
+/*
+test_current_limit — MyPower::CurrentLimit together with MyShows::Output
+- writeFrame() below is the loop from both sketches:
+    while (!current.check(output.sum(), N, now)) { output.limit(current.limit()); output.write(...); }
+- The loop always ends (at worst at limit 0, within 256 passes), also when
+  the budget is below what the dark strip draws, and the frame that goes
+  out is never estimated over budgetMa.
+- The smooth limit follows attackMs / releaseMs, a frame that fits leaves
+  the limit alone, budget 0 only measures, and the statistics count
+  events and clamps.
+
+Run (from the project folder):
+  pio test -e native -f test_current_limit
+*/
+
+#include <unity.h>
+#include <MyShows.h>
+#include <MyOutput.h>
+#include <MyPower.h>
+#include <string.h>
+
+using namespace MyShows;
+
+void setUp(void) {}
+void tearDown(void) {}
+
+static const uint16_t N = 60;
+
+struct Rig {
+  MyPower::CurrentLimit current;
+  Output<OrderGRB>      output;
+  uint8_t  frame[N * 3];
+  uint8_t  strip[N * 3];
+  uint32_t now = 0;
+  uint16_t passes = 0;       // output passes in the last writeFrame()
+
+  Rig() { memset(frame, 0, sizeof(frame)); }
+
+  void writeFrame() {
+    output.write(frame, strip, N);
+    passes = 1;
+    while (!current.check(output.sum(), N, now)) {
+      output.limit(current.limit());
+      output.write(frame, strip, N);
+      TEST_ASSERT_TRUE_MESSAGE(++passes <= 257, "check() loop does not end");
+    }
+    output.limit(current.limit());
+  }
+
+  uint32_t sentMa() const { return current.estimate(output.sum(), N); }
+  uint32_t idleMa() const { return (uint32_t)N * current.idleUa / 1000; }
+};
+
+static void fill(uint8_t* frame, uint8_t r, uint8_t g, uint8_t b) {
+  for (uint16_t i = 0; i < N; i++) { frame[i * 3] = r; frame[i * 3 + 1] = g; frame[i * 3 + 2] = b; }
+}
+
+void test_estimate(void) {
+  MyPower::CurrentLimit c;
+  uint32_t dark[3] = { 0, 0, 0 };
+  TEST_ASSERT_EQUAL_UINT32(60, c.estimate(dark, 60));                // 1 mA per dark LED
+  uint32_t white[3] = { 255UL * 60, 255UL * 60, 255UL * 60 };
+  TEST_ASSERT_EQUAL_UINT32(60 + 3 * 20 * 60, c.estimate(white, 60));
+}
+
+void test_full_white_ends_under_budget(void) {
+  const uint16_t budgets[] = { 3660, 2000, 500, 100, 61, 60, 59, 1 };
+  for (uint8_t i = 0; i < sizeof(budgets) / sizeof(budgets[0]); i++) {
+    Rig r;
+    r.current.budgetMa = budgets[i];
+    fill(r.frame, 255, 255, 255);
+    r.writeFrame();
+    uint32_t cap = budgets[i] > r.idleMa() ? budgets[i] : r.idleMa();   // LEDs off still draw idle
+    TEST_ASSERT_TRUE(r.sentMa() <= cap);
+    TEST_ASSERT_EQUAL_UINT32(r.sentMa(), r.current.lastMa());
+    if (budgets[i] <= r.idleMa()) TEST_ASSERT_EQUAL_UINT8(0, r.current.limit());
+  }
+}
+
+void test_limit_zero_terminates(void) {
+  Rig r;
+  r.current.budgetMa = 1;                                // less than the dark strip
+  fill(r.frame, 255, 255, 255);
+  r.writeFrame();
+  TEST_ASSERT_EQUAL_UINT8(0, r.current.limit());
+  TEST_ASSERT_EQUAL_UINT32(r.idleMa(), r.sentMa());
+  for (uint8_t k = 0; k < 10; k++) {                     // and stays there without spinning
+    r.now += 20;
+    r.writeFrame();
+    TEST_ASSERT_EQUAL_UINT16(1, r.passes);
+    TEST_ASSERT_EQUAL_UINT8(0, r.current.limit());
+  }
+}
+
+void test_random_frames_and_settings(void) {
+  Rig r;
+  uint32_t rng = 2463534242u;
+  for (uint16_t step = 0; step < 3000; step++) {
+    rng ^= rng << 13; rng ^= rng >> 17; rng ^= rng << 5;
+    if (step % 50 == 0) {
+      r.current.budgetMa = (uint16_t)(rng % 3800);
+      r.output.brightness((uint8_t)(rng >> 12));
+      r.output.gamma((rng >> 20) & 1 ? 2.2f : 1.0f);
+    }
+    uint8_t level = (uint8_t)(rng >> 8);
+    for (uint16_t k = 0; k < N * 3; k++) r.frame[k] = (k * 13 + step) % 7 ? level : 255;
+    r.now += 1 + (rng >> 24) % 40;
+    r.writeFrame();
+    uint32_t cap = r.current.budgetMa > r.idleMa() ? r.current.budgetMa : r.idleMa();
+    if (r.current.budgetMa) TEST_ASSERT_TRUE(r.sentMa() <= cap);
+    TEST_ASSERT_TRUE(r.passes <= 257);
+  }
+}
+
+void test_fitting_frames_pass_first_time(void) {
+  Rig r;
+  r.current.budgetMa = 2000;
+  fill(r.frame, 40, 40, 40);                             // ~620 mA
+  for (uint8_t k = 0; k < 20; k++) {
+    r.now += 20;
+    r.writeFrame();
+    TEST_ASSERT_EQUAL_UINT16(1, r.passes);
+  }
+  TEST_ASSERT_EQUAL_UINT8(255, r.current.limit());
+  TEST_ASSERT_EQUAL_UINT32(0, r.current.events());
+  TEST_ASSERT_EQUAL_UINT32(0, r.current.clamps());
+  TEST_ASSERT_EQUAL_INT32(2000 - (int32_t)r.sentMa(), r.current.headroomMa());
+}
+
+void test_attack_and_release(void) {
+  Rig r;
+  r.current.budgetMa = 1500;
+  fill(r.frame, 255, 255, 255);
+  r.writeFrame();                                        // hard clamp right away
+  TEST_ASSERT_TRUE(r.current.clamps() > 0);
+  TEST_ASSERT_EQUAL_UINT32(1, r.current.events());
+  uint8_t clamped = r.current.limit();
+  for (uint8_t k = 0; k < 10; k++) { r.now += 20; r.writeFrame(); }
+  TEST_ASSERT_TRUE(r.sentMa() <= r.current.budgetMa * r.current.softPercent / 100u + 5);   // settled on the soft target
+  TEST_ASSERT_TRUE(r.current.limit() <= clamped);
+
+  uint8_t from = r.current.limit();
+  fill(r.frame, 0, 0, 0);                                // show went dark: 0 → 255 would take releaseMs
+  r.now += 20; r.writeFrame();
+  uint8_t after20 = r.current.limit();
+  TEST_ASSERT_TRUE(after20 < 255);
+  uint32_t t = 20;
+  while (r.current.limit() < 255) { r.now += 20; t += 20; r.writeFrame(); }
+  TEST_ASSERT_UINT32_WITHIN(60, (uint32_t)r.current.releaseMs * (255 - from) / 255, t);
+  TEST_ASSERT_EQUAL_UINT32(1, r.current.events());
+}
+
+void test_budget_zero_only_measures(void) {
+  Rig r;
+  fill(r.frame, 255, 255, 255);
+  r.writeFrame();
+  TEST_ASSERT_EQUAL_UINT16(1, r.passes);
+  TEST_ASSERT_EQUAL_UINT8(255, r.current.limit());
+  TEST_ASSERT_EQUAL_UINT32(60 + 3 * 20 * 60, r.current.lastMa());
+  TEST_ASSERT_EQUAL_INT32(0, r.current.headroomMa());
+}
+
+int main(int, char**) {
+  UNITY_BEGIN();
+  RUN_TEST(test_estimate);
+  RUN_TEST(test_full_white_ends_under_budget);
+  RUN_TEST(test_limit_zero_terminates);
+  RUN_TEST(test_random_frames_and_settings);
+  RUN_TEST(test_fitting_frames_pass_first_time);
+  RUN_TEST(test_attack_and_release);
+  RUN_TEST(test_budget_zero_only_measures);
+  return UNITY_END();
+}
@@ -0,0 +1,184 @@
+/*
+test_frame_cache — MyFrameCache.h against plain render()
+- Two engines with the same seed and show: one always renders, the other
+  goes through cache.replay() / render() + record() like renderShows().
+  Every frame must be byte-identical, whether it was drawn or unpacked.
+- One full Rainbow period (256) and one full Color Wipe period (6·N) are
+  recorded, then every phase is replayed in order and after random seek()s
+  (those unpack up to KEY_EVERY records from a key frame).
+- A cycle that does not fit ends in FULL, either right away or part way
+  through recording; a seek() while recording starts the recording again
+  from that frame.
+
+Run (from the project folder):
+  pio test -e native -f test_frame_cache
+*/
+
+#include <unity.h>
+#include <MyShows.h>
+#include <MyPalette.h>
+#include <MyFrameCache.h>
+#include <stdio.h>
+
+using namespace MyShows;
+
+void setUp(void) {}
+void tearDown(void) {}
+
+static const uint16_t N = 60;
+static const uint32_t SEED = 0xC0FFEEu;
+
+typedef Engine<N, OrderGRB, OwnPixels<N> > Shows;
+typedef FrameCache<Shows> Cache;
+
+static uint8_t mem[64000];
+static uint32_t rng = 2463534242u;
+static uint32_t next() { rng ^= rng << 13; rng ^= rng >> 17; rng ^= rng << 5; return rng; }
+
+struct Pair {
+  Shows plain, cached;
+  Cache cache;
+  uint32_t frame = 0;
+
+  void start(uint8_t show, uint32_t bytes) {
+    plain.seed(SEED);  plain.select(show);  plain.clear();
+    cached.seed(SEED); cached.select(show); cached.clear();
+    cache.begin(mem, bytes);
+    cache.resetStats();
+    frame = 0;
+  }
+
+  // one frame on both, compared byte for byte
+  void step() {
+    plain.render();
+    if (!cache.replay(cached)) { cached.render(); cache.record(cached); }
+    char msg[64];
+    snprintf(msg, sizeof(msg), "show %u frame %lu state %u", plain.current(), (unsigned long)frame, cache.state());
+    TEST_ASSERT_EQUAL_UINT16_MESSAGE(plain.animStep(), cached.animStep(), msg);
+    TEST_ASSERT_EQUAL_UINT8_ARRAY_MESSAGE(plain.pixels.data(), cached.pixels.data(), N * 3, msg);
+    frame++;
+  }
+
+  void seek(uint32_t k) { plain.seek(k); cached.seek(k); }
+};
+
+static Pair p;
+
+void test_rainbow_period(void) {
+  p.start(1, sizeof(mem));
+  for (uint16_t f = 0; f < 256; f++) p.step();
+  TEST_ASSERT_EQUAL_UINT8(Cache::COMPLETE, p.cache.state());
+  TEST_ASSERT_EQUAL_UINT32(256, p.cache.period());
+  TEST_ASSERT_EQUAL_UINT32(256, p.cache.cachedFrames());
+  TEST_ASSERT_EQUAL_UINT32(0, p.cache.hits);
+  for (uint16_t f = 0; f < 2 * 256; f++) p.step();     // every phase in order, twice
+  TEST_ASSERT_EQUAL_UINT32(512, p.cache.hits);
+  for (uint8_t s = 0; s < 50; s++) {                    // random jumps (MySync joining)
+    p.seek(next() % 100000);
+    for (uint8_t f = 0; f < 20; f++) p.step();
+  }
+  TEST_ASSERT_EQUAL_UINT32(256, p.cache.cachedFrames());
+  TEST_ASSERT_EQUAL_UINT32(0, p.cache.invalidations);
+}
+
+void test_rainbow_with_palette(void) {
+  static Palette pal;
+  pal.load(PAL_OCEAN);
+  p.plain.palette = pal.table();
+  p.cached.palette = pal.table();
+  p.start(1, sizeof(mem));
+  for (uint16_t f = 0; f < 3 * 256; f++) p.step();
+  TEST_ASSERT_EQUAL_UINT8(Cache::COMPLETE, p.cache.state());
+  pal.load(PAL_HEAT);                                   // the same table, new content
+  for (uint16_t f = 0; f < 2 * 256; f++) p.step();
+  TEST_ASSERT_EQUAL_UINT32(1, p.cache.invalidations);
+  TEST_ASSERT_EQUAL_UINT8(Cache::COMPLETE, p.cache.state());
+  p.plain.palette = nullptr;
+  p.cached.palette = nullptr;
+}
+
+void test_color_wipe_period(void) {
+  p.start(5, sizeof(mem));
+  for (uint16_t f = 0; f < N; f++) p.step();           // the first pass over black is not periodic
+  TEST_ASSERT_EQUAL_UINT8(Cache::EMPTY, p.cache.state());
+  for (uint16_t f = 0; f < 6 * N; f++) p.step();
+  TEST_ASSERT_EQUAL_UINT8(Cache::COMPLETE, p.cache.state());
+  TEST_ASSERT_EQUAL_UINT32(6 * N, p.cache.cachedFrames());
+  TEST_ASSERT_TRUE(p.cache.bytesUsed() < 6 * N * 16);  // a few bytes per frame
+  uint32_t hits = p.cache.hits;
+  for (uint16_t f = 0; f < 2 * 6 * N; f++) p.step();
+  TEST_ASSERT_EQUAL_UINT32(hits + 2 * 6 * N, p.cache.hits);
+  for (uint8_t s = 0; s < 50; s++) {
+    p.seek(N + next() % 100000);
+    for (uint8_t f = 0; f < 20; f++) p.step();
+  }
+  TEST_ASSERT_EQUAL_UINT32(0, p.cache.invalidations);
+}
+
+void test_full_right_away(void) {
+  // tables (6 B per phase) + the last frame + one record is the minimum
+  const uint32_t minimum = 256 * 6 + N * 3 + N * 3 + 1;
+  p.start(1, minimum - 1);
+  for (uint16_t f = 0; f < 600; f++) p.step();
+  TEST_ASSERT_EQUAL_UINT8(Cache::FULL, p.cache.state());
+  TEST_ASSERT_EQUAL_UINT32(0, p.cache.hits);
+  p.start(1, minimum);                                  // just enough to start recording
+  p.step();
+  TEST_ASSERT_EQUAL_UINT8(Cache::RECORDING, p.cache.state());
+}
+
+void test_full_while_recording(void) {
+  p.start(1, 256 * 6 + N * 3 + 5000);                  // ~25 rainbow frames of data
+  for (uint16_t f = 0; f < 10; f++) p.step();
+  TEST_ASSERT_EQUAL_UINT8(Cache::RECORDING, p.cache.state());
+  for (uint16_t f = 0; f < 3 * 256; f++) p.step();
+  TEST_ASSERT_EQUAL_UINT8(Cache::FULL, p.cache.state());
+  TEST_ASSERT_EQUAL_UINT32(0, p.cache.hits);
+  TEST_ASSERT_TRUE(p.cache.cachedFrames() > 10 && p.cache.cachedFrames() < 256);
+  p.plain.select(5);                                    // a show that fits starts over
+  p.cached.select(5);
+  for (uint16_t f = 0; f < N + 2 * 6 * N; f++) p.step();
+  TEST_ASSERT_EQUAL_UINT8(Cache::COMPLETE, p.cache.state());
+  TEST_ASSERT_TRUE(p.cache.hits >= 6 * N);
+}
+
+void test_jump_while_recording(void) {
+  p.start(1, sizeof(mem));
+  for (uint16_t f = 0; f < 100; f++) p.step();
+  TEST_ASSERT_EQUAL_UINT32(100, p.cache.cachedFrames());
+  p.seek(200);                                          // phase 200 does not follow phase 99
+  p.step();
+  TEST_ASSERT_EQUAL_UINT8(Cache::RECORDING, p.cache.state());
+  TEST_ASSERT_EQUAL_UINT32(1, p.cache.cachedFrames());  // recorded = 0, then this frame
+  for (uint16_t f = 1; f < 256; f++) p.step();
+  TEST_ASSERT_EQUAL_UINT8(Cache::COMPLETE, p.cache.state());
+  TEST_ASSERT_EQUAL_UINT32(0, p.cache.hits);
+  for (uint16_t f = 0; f < 256; f++) p.step();         // phases 200..255, 0..199 all unpacked
+  TEST_ASSERT_EQUAL_UINT32(256, p.cache.hits);
+  for (uint8_t s = 0; s < 30; s++) {
+    p.seek(next() % 70000);
+    for (uint8_t f = 0; f < 5; f++) p.step();
+  }
+}
+
+void test_not_periodic_is_not_cached(void) {
+  const uint8_t shows[] = { 2, 3, 4, 6, 7, 8, 9 };
+  for (uint8_t i = 0; i < sizeof(shows); i++) {
+    p.start(shows[i], sizeof(mem));
+    for (uint16_t f = 0; f < 300; f++) p.step();
+    TEST_ASSERT_EQUAL_UINT32(0, p.cache.hits);
+    TEST_ASSERT_EQUAL_UINT32(0, p.cache.bytesUsed());
+  }
+}
+
+int main(int, char**) {
+  UNITY_BEGIN();
+  RUN_TEST(test_rainbow_period);
+  RUN_TEST(test_rainbow_with_palette);
+  RUN_TEST(test_color_wipe_period);
+  RUN_TEST(test_full_right_away);
+  RUN_TEST(test_full_while_recording);
+  RUN_TEST(test_jump_while_recording);
+  RUN_TEST(test_not_periodic_is_not_cached);
+  return UNITY_END();
+}
@@ -0,0 +1,134 @@
+/*
+test_ircodes — MyIRcodes.h: the generated constants and the O(1) lookup
+- Every code must come back as its own button through the hash slot, its
+  name and its label; anything else must map to BTN_NONE.
+- The constants are compared with the values the sketches used before the
+  table was generated, so a typo in MYIR_BUTTONS cannot slip through.
+
+Run (from the project folder):
+  pio test -e native -f test_ircodes
+*/
+
+#include <unity.h>
+#include <MyIRcodes.h>
+
+using namespace MyIR;
+
+void setUp(void) {}
+void tearDown(void) {}
+
+struct Known { uint32_t code; Button btn; const char* name; const char* label; };
+
+// Captured from the remote with IRremote (decodedRawData), before MYIR_BUTTONS
+static const Known KNOWN[] = {
+  { 0xBA45FF00, BTN_1,     "ONE",   "1" },
+  { 0xB946FF00, BTN_2,     "TWO",   "2" },
+  { 0xB847FF00, BTN_3,     "THREE", "3" },
+  { 0xBB44FF00, BTN_4,     "FOUR",  "4" },
+  { 0xBF40FF00, BTN_5,     "FIVE",  "5" },
+  { 0xBC43FF00, BTN_6,     "SIX",   "6" },
+  { 0xF807FF00, BTN_7,     "SEVEN", "7" },
+  { 0xEA15FF00, BTN_8,     "EIGHT", "8" },
+  { 0xF609FF00, BTN_9,     "NINE",  "9" },
+  { 0xE916FF00, BTN_STAR,  "STAR",  "*" },
+  { 0xE619FF00, BTN_0,     "ZERO",  "0" },
+  { 0xF20DFF00, BTN_HASH,  "HASH",  "#" },
+  { 0xE718FF00, BTN_UP,    "UP",    "UP" },
+  { 0xF708FF00, BTN_LEFT,  "LEFT",  "LEFT" },
+  { 0xE31CFF00, BTN_OK,    "OK",    "OK" },
+  { 0xA55AFF00, BTN_RIGHT, "RIGHT", "RIGHT" },
+  { 0xAD52FF00, BTN_DOWN,  "DOWN",  "DOWN" },
+};
+static const uint8_t KNOWN_COUNT = sizeof(KNOWN) / sizeof(KNOWN[0]);
+
+void test_constants_match_baseline(void) {
+  TEST_ASSERT_EQUAL_HEX32(0xBA45FF00, ONE);
+  TEST_ASSERT_EQUAL_HEX32(0xB946FF00, TWO);
+  TEST_ASSERT_EQUAL_HEX32(0xB847FF00, THREE);
+  TEST_ASSERT_EQUAL_HEX32(0xBB44FF00, FOUR);
+  TEST_ASSERT_EQUAL_HEX32(0xBF40FF00, FIVE);
+  TEST_ASSERT_EQUAL_HEX32(0xBC43FF00, SIX);
+  TEST_ASSERT_EQUAL_HEX32(0xF807FF00, SEVEN);
+  TEST_ASSERT_EQUAL_HEX32(0xEA15FF00, EIGHT);
+  TEST_ASSERT_EQUAL_HEX32(0xF609FF00, NINE);
+  TEST_ASSERT_EQUAL_HEX32(0xE916FF00, STARBTN);
+  TEST_ASSERT_EQUAL_HEX32(0xE619FF00, ZERO);
+  TEST_ASSERT_EQUAL_HEX32(0xF20DFF00, HASHBTN);
+  TEST_ASSERT_EQUAL_HEX32(0xE718FF00, UPBTN);
+  TEST_ASSERT_EQUAL_HEX32(0xF708FF00, LEFTBTN);
+  TEST_ASSERT_EQUAL_HEX32(0xE31CFF00, OKBTN);
+  TEST_ASSERT_EQUAL_HEX32(0xA55AFF00, RIGHTBTN);
+  TEST_ASSERT_EQUAL_HEX32(0xAD52FF00, DOWNBTN);
+  TEST_ASSERT_EQUAL_HEX32(0x0, NEC_REPEAT);
+}
+
+void test_all_buttons_in_table(void) {
+  TEST_ASSERT_EQUAL_UINT8(KNOWN_COUNT + 1, BUTTON_COUNT);
+  for (uint8_t i = 0; i < KNOWN_COUNT; i++) TEST_ASSERT_EQUAL_UINT8(i + 1, KNOWN[i].btn);   // enum order is API
+}
+
+void test_codes_round_trip(void) {
+  for (uint8_t i = 0; i < KNOWN_COUNT; i++) {
+    const Known& k = KNOWN[i];
+    uint8_t cmd = (uint8_t)(k.code >> 16);
+    TEST_ASSERT_EQUAL_UINT8(cmd, command(k.btn));
+    TEST_ASSERT_EQUAL_HEX32(k.code, code(k.btn));
+    TEST_ASSERT_EQUAL_UINT8(k.btn, detail::SLOT[detail::slotOf(cmd)]);
+    TEST_ASSERT_EQUAL_UINT8(k.btn, fromCommand(cmd));
+    TEST_ASSERT_EQUAL_UINT8(k.btn, lookup(k.code));
+    TEST_ASSERT_EQUAL_STRING(k.name, nameOf(k.code));
+    TEST_ASSERT_EQUAL_STRING(k.name, name(k.btn));
+    TEST_ASSERT_EQUAL_STRING(k.label, label(k.btn));
+  }
+}
+
+void test_slots_are_distinct(void) {
+  bool used[detail::HASH_SLOTS] = {};
+  for (uint8_t i = 0; i < KNOWN_COUNT; i++) {
+    uint8_t s = detail::slotOf((uint8_t)(KNOWN[i].code >> 16));
+    TEST_ASSERT_TRUE(s < detail::HASH_SLOTS);
+    TEST_ASSERT_FALSE(used[s]);
+    used[s] = true;
+  }
+}
+
+void test_unknown_codes_map_to_nothing(void) {
+  TEST_ASSERT_EQUAL_UINT8(BTN_NONE, lookup(0xFFFFFFFF));
+  TEST_ASSERT_EQUAL_UINT8(BTN_NONE, lookup(0x12345678));
+  TEST_ASSERT_EQUAL_UINT8(BTN_NONE, lookup(NEC_REPEAT));
+  TEST_ASSERT_EQUAL_UINT8(BTN_NONE, lookup(0xBA45FF01));   // ONE from another address
+  TEST_ASSERT_EQUAL_UINT8(BTN_NONE, lookup(0xBB45FF00));   // ONE with a broken inverted byte
+  TEST_ASSERT_EQUAL_STRING("UNKNOWN", nameOf(0x12345678));
+  TEST_ASSERT_EQUAL_STRING("UNKNOWN", name((Button)200));
+  TEST_ASSERT_EQUAL_STRING("(none)", label(BTN_NONE));
+
+  // every well-formed NEC code of our address that is not in the table
+  uint16_t hits = 0;
+  for (uint16_t cmd = 0; cmd < 256; cmd++) {
+    Button b = lookup(necRaw((uint8_t)cmd));
+    if (b == BTN_NONE) continue;
+    TEST_ASSERT_EQUAL_UINT8(cmd, command(b));
+    hits++;
+  }
+  TEST_ASSERT_EQUAL_UINT16(KNOWN_COUNT, hits);
+}
+
+void test_decode_keeps_last_for_repeat(void) {
+  Button last = BTN_NONE;
+  TEST_ASSERT_EQUAL_UINT8(BTN_NONE, decode(NEC_REPEAT, last));   // repeat before any press
+  TEST_ASSERT_EQUAL_UINT8(BTN_UP, decode(UPBTN, last));
+  TEST_ASSERT_EQUAL_UINT8(BTN_UP, decode(NEC_REPEAT, last));
+  TEST_ASSERT_EQUAL_UINT8(BTN_NONE, decode(0x12345678, last));   // noise does not clear it
+  TEST_ASSERT_EQUAL_UINT8(BTN_UP, decode(NEC_REPEAT, last));
+}
+
+int main(int, char**) {
+  UNITY_BEGIN();
+  RUN_TEST(test_constants_match_baseline);
+  RUN_TEST(test_all_buttons_in_table);
+  RUN_TEST(test_codes_round_trip);
+  RUN_TEST(test_slots_are_distinct);
+  RUN_TEST(test_unknown_codes_map_to_nothing);
+  RUN_TEST(test_decode_keeps_last_for_repeat);
+  return UNITY_END();
+}
@@ -0,0 +1,375 @@
+/*
+test_irdecoder — IRDecoder.h fed with edge timings, as pumpIRDecoder() does
+- Frames are arrays of levels in µs (+ = mark, - = space) shaped like the
+  output of a VS1838B/TSOP receiver: marks ~55 µs longer and spaces ~55 µs
+  shorter than nominal, ±25 µs of jitter.
+- Tolerance edges (±25 %, at least ±150 µs), NEC repeat frames and the
+  auto-repeat while held, the RC5 toggle bit, frames that only end with the
+  silence (endBurst()), and the clock running past 2^32 µs and 2^32 ms.
+
+Run (from the project folder):
+  pio test -e native -f test_irdecoder
+*/
+
+#include <unity.h>
+#include <IRDecoder.h>
+#include <vector>
+
+using namespace MyIR;
+
+void setUp(void) {}
+void tearDown(void) {}
+
+// NEC, button ONE (0xBA45FF00)
+static const int16_t NEC_ONE[] = {
+    9052,  -4429,    617,   -521,    595,   -484,    626,   -486,    615,   -517,    595,   -512,
+     605,   -482,    597,   -507,    618,   -484,    607,  -1615,    627,  -1637,    595,  -1646,
+     599,  -1624,    632,  -1650,    629,  -1613,    628,  -1647,    617,  -1613,    606,  -1612,
+     627,   -488,    610,  -1636,    601,   -514,    599,   -516,    611,   -515,    635,  -1621,
+     598,   -517,    628,   -520,    604,  -1633,    598,   -515,    637,  -1614,    628,  -1613,
+     631,  -1623,    623,   -523,    626,  -1637,    612,
+};
+
+// NEC repeat: 9 ms, 2.25 ms, 560 µs
+static const int16_t NEC_REPEAT_FRAME[] = {
+    9061,  -2207,    621,
+};
+
+// RC5 address 0, command 2 (TWO), toggle 0: the last bit is 0, so its
+// second half (a space) only shows as the silence after the frame
+static const int16_t RC5_2_T0[] = {
+     944,   -828,   1825,   -820,    965,   -824,    926,   -845,    940,   -842,    952,   -830,
+     967,   -837,    939,   -847,    925,   -816,    953,   -835,    931,  -1746,   1831,
+};
+
+// RC5 address 0, command 1 (ONE), toggle 1: ends on the mark of its last bit
+static const int16_t RC5_1_T1[] = {
+     930,   -840,    947,   -811,   1852,   -813,    969,   -844,    957,   -829,    942,   -853,
+     943,   -847,    952,   -846,    950,   -813,    926,   -826,    951,   -853,    963,  -1702,
+     924,
+};
+
+// The same button pressed again: toggle 0
+static const int16_t RC5_1_T0[] = {
+     935,   -851,   1824,   -809,    952,   -846,    932,   -825,    939,   -809,    930,   -835,
+     955,   -832,    960,   -845,    941,   -817,    965,   -841,    960,   -850,    964,  -1745,
+     924,
+};
+
+// SIRC-12, address 1 (TV), command 0 (ONE): ends on a mark, the length of
+// the frame is only known from the silence after it
+static const int16_t SIRC_ONE[] = {
+    2479,   -535,    657,   -545,    663,   -525,    642,   -548,    657,   -555,    649,   -528,
+     659,   -555,    649,   -565,   1258,   -542,    675,   -544,    646,   -529,    637,   -531,
+     641,
+};
+
+#define LEN(a) (sizeof(a) / sizeof(a[0]))
+
+static uint32_t replay(IRDecoder& d, const int16_t* lv, size_t n) {
+  uint32_t us = 0;
+  for (size_t i = 0; i < n; i++) {
+    bool mark = lv[i] > 0;
+    uint32_t len = (uint32_t)(mark ? lv[i] : -lv[i]);
+    d.feed(mark, len);
+    us += len;
+  }
+  return us;
+}
+
+// Nominal NEC frame with one level replaced (index into the levels, -1 = none)
+static std::vector<int16_t> necFrame(uint32_t raw, int index = -1, int16_t level = 0) {
+  std::vector<int16_t> v;
+  v.push_back(9000); v.push_back(-4500);
+  for (uint8_t i = 0; i < 32; i++) { v.push_back(560); v.push_back((raw >> i) & 1 ? -1690 : -560); }
+  v.push_back(560);
+  if (index >= 0) v[index] = level;
+  return v;
+}
+
+static uint8_t drain(IRDecoder& d, IREvent* last = nullptr) {
+  uint8_t n = 0;
+  IREvent e;
+  while (d.read(e)) { n++; if (last) *last = e; }
+  return n;
+}
+
+static uint8_t decodeNec(int index, int16_t level) {
+  IRDecoder d;
+  std::vector<int16_t> f = necFrame(ONE, index, level);
+  replay(d, f.data(), f.size());
+  d.feed(false, 40000);
+  d.endBurst();
+  IREvent e;
+  uint8_t n = drain(d, &e);
+  return (n == 1 && e.button == BTN_1) ? 1 : 0;
+}
+
+// --- NEC ---
+
+void test_nec_captured_frame(void) {
+  IRDecoder d;
+  replay(d, NEC_ONE, LEN(NEC_ONE));
+  IREvent e;
+  TEST_ASSERT_TRUE(d.read(e));
+  TEST_ASSERT_EQUAL_UINT8(BTN_1, e.button);
+  TEST_ASSERT_EQUAL_UINT8(PROTO_NEC, e.proto);
+  TEST_ASSERT_EQUAL_UINT16(0x00, e.address);
+  TEST_ASSERT_EQUAL_UINT8(0x45, e.command);
+  TEST_ASSERT_FALSE(e.repeat);
+  TEST_ASSERT_FALSE(d.read(e));
+  TEST_ASSERT_EQUAL_UINT16(0, d.overflowCount());
+}
+
+void test_nec_tolerance_limits(void) {
+  TEST_ASSERT_EQUAL_UINT8(1, decodeNec(-1, 0));
+  // header mark 9000: ±25 % = ±2250
+  TEST_ASSERT_EQUAL_UINT8(1, decodeNec(0, 11250));
+  TEST_ASSERT_EQUAL_UINT8(0, decodeNec(0, 11251));
+  TEST_ASSERT_EQUAL_UINT8(1, decodeNec(0, 6750));
+  TEST_ASSERT_EQUAL_UINT8(0, decodeNec(0, 6749));
+  // header space 4500: ±1125
+  TEST_ASSERT_EQUAL_UINT8(1, decodeNec(1, -5625));
+  TEST_ASSERT_EQUAL_UINT8(0, decodeNec(1, -5626));
+  TEST_ASSERT_EQUAL_UINT8(1, decodeNec(1, -3375));
+  TEST_ASSERT_EQUAL_UINT8(0, decodeNec(1, -3374));
+  // bit mark 560: 25 % is 140, so the ±150 µs floor applies
+  TEST_ASSERT_EQUAL_UINT8(1, decodeNec(2, 710));
+  TEST_ASSERT_EQUAL_UINT8(0, decodeNec(2, 711));
+  TEST_ASSERT_EQUAL_UINT8(1, decodeNec(2, 410));
+  TEST_ASSERT_EQUAL_UINT8(0, decodeNec(2, 409));
+  // "0" space 560 (±150) and "1" space 1690 (±422): the bit of ONE at
+  // index 3 is 0, the one at 35 (bit 16) is 1
+  TEST_ASSERT_EQUAL_UINT8(1, decodeNec(3, -710));
+  TEST_ASSERT_EQUAL_UINT8(0, decodeNec(3, -711));
+  TEST_ASSERT_EQUAL_UINT8(1, decodeNec(35, -2112));
+  TEST_ASSERT_EQUAL_UINT8(0, decodeNec(35, -2113));
+  TEST_ASSERT_EQUAL_UINT8(1, decodeNec(35, -1268));
+  TEST_ASSERT_EQUAL_UINT8(0, decodeNec(35, -1267));
+  // stop mark
+  TEST_ASSERT_EQUAL_UINT8(1, decodeNec(66, 710));
+  TEST_ASSERT_EQUAL_UINT8(0, decodeNec(66, 711));
+}
+
+void test_nec_corrupted_frame_is_dropped(void) {
+  IRDecoder d;
+  // bit 24 (first bit of ~command) flipped: neither a known button nor a valid NEC code
+  std::vector<int16_t> f = necFrame(ONE ^ (1UL << 24));
+  replay(d, f.data(), f.size());
+  TEST_ASSERT_EQUAL_UINT8(0, drain(d));
+  // an unknown but well-formed code still comes out, without a button
+  f = necFrame(necRaw(0x99, 0x04));
+  replay(d, f.data(), f.size());
+  IREvent e;
+  TEST_ASSERT_TRUE(d.read(e));
+  TEST_ASSERT_EQUAL_UINT8(BTN_NONE, e.button);
+  TEST_ASSERT_EQUAL_UINT8(0x99, e.command);
+  TEST_ASSERT_EQUAL_UINT16(0x04, e.address);
+}
+
+struct Emit { uint32_t ms; bool repeat; Button button; };
+
+// NEC frame + repeat frames every 108 ms for holdMs, then silence
+static std::vector<Emit> holdNec(IRDecoder& d, uint32_t holdMs) {
+  std::vector<Emit> out;
+  IREvent e;
+  uint32_t start = d.nowMs();
+  uint32_t us = replay(d, NEC_ONE, LEN(NEC_ONE));
+  while (d.read(e)) out.push_back(Emit{ d.nowMs() - start, e.repeat, e.button });
+  for (uint32_t t = 108; t <= holdMs; t += 108) {
+    d.feed(false, 108000 - us);
+    us = replay(d, NEC_REPEAT_FRAME, LEN(NEC_REPEAT_FRAME));
+    while (d.read(e)) out.push_back(Emit{ d.nowMs() - start, e.repeat, e.button });
+  }
+  d.feed(false, 108000 - us);
+  return out;
+}
+
+static void checkHold(const std::vector<Emit>& ev, const IRDecoder& d, uint32_t holdMs) {
+  TEST_ASSERT_TRUE(ev.size() >= 2);
+  TEST_ASSERT_FALSE(ev[0].repeat);
+  uint32_t press = ev[0].ms;
+  for (size_t i = 0; i < ev.size(); i++) TEST_ASSERT_EQUAL_UINT8(BTN_1, ev[i].button);
+  TEST_ASSERT_TRUE(ev[1].repeat);
+  TEST_ASSERT_GREATER_OR_EQUAL_UINT32(d.repeatDelayMs, ev[1].ms - press);
+  TEST_ASSERT_LESS_THAN_UINT32(d.repeatDelayMs + 108, ev[1].ms - press);       // the next repeat frame after the delay
+  for (size_t i = 2; i < ev.size(); i++) {
+    TEST_ASSERT_TRUE(ev[i].repeat);
+    TEST_ASSERT_GREATER_OR_EQUAL_UINT32(d.repeatIntervalMs, ev[i].ms - ev[i - 1].ms);
+    TEST_ASSERT_LESS_THAN_UINT32(d.repeatIntervalMs + 108, ev[i].ms - ev[i - 1].ms);
+  }
+  TEST_ASSERT_GREATER_THAN_UINT32(holdMs - 108 - d.repeatIntervalMs, ev.back().ms);   // kept repeating to the end
+}
+
+void test_nec_repeat_and_hold(void) {
+  IRDecoder d;
+  std::vector<Emit> ev = holdNec(d, 1500);
+  checkHold(ev, d, 1500);
+  // the 108 ms frame period against the 120 ms interval: every second frame
+  TEST_ASSERT_EQUAL_UINT32(ev[2].ms - ev[1].ms, 216);
+}
+
+void test_nec_repeat_without_press_is_ignored(void) {
+  IRDecoder d;
+  replay(d, NEC_REPEAT_FRAME, LEN(NEC_REPEAT_FRAME));      // nothing held yet
+  TEST_ASSERT_EQUAL_UINT8(0, drain(d));
+  holdNec(d, 300);
+  drain(d);
+  d.feed(false, 200000);                                    // released: longer than holdMs (150)
+  replay(d, NEC_REPEAT_FRAME, LEN(NEC_REPEAT_FRAME));
+  TEST_ASSERT_EQUAL_UINT8(0, drain(d));
+}
+
+void test_nec_auto_repeat_off(void) {
+  IRDecoder d;
+  d.repeatIntervalMs = 0;
+  std::vector<Emit> ev = holdNec(d, 1500);
+  TEST_ASSERT_EQUAL_UINT32(1, ev.size());
+}
+
+// --- RC5 ---
+
+void test_rc5_toggle(void) {
+  IRDecoder d;
+  IREvent e;
+  uint32_t us = replay(d, RC5_1_T1, LEN(RC5_1_T1));
+  TEST_ASSERT_TRUE(d.read(e));
+  TEST_ASSERT_EQUAL_UINT8(BTN_1, e.button);
+  TEST_ASSERT_EQUAL_UINT8(PROTO_RC5, e.proto);
+  TEST_ASSERT_EQUAL_UINT8(1, e.toggle);
+  TEST_ASSERT_EQUAL_UINT8(1, e.command);
+  TEST_ASSERT_FALSE(e.repeat);
+
+  // held: the remote resends the same frame (same toggle) every 114 ms
+  uint8_t repeats = 0;
+  for (uint8_t k = 0; k < 8; k++) {
+    d.feed(false, 114000 - us);
+    us = replay(d, RC5_1_T1, LEN(RC5_1_T1));
+    while (d.read(e)) { TEST_ASSERT_TRUE(e.repeat); TEST_ASSERT_EQUAL_UINT8(BTN_1, e.button); repeats++; }
+  }
+  TEST_ASSERT_TRUE(repeats >= 2);
+
+  // pressed again within the hold window: only the toggle bit tells
+  d.feed(false, 114000 - us);
+  replay(d, RC5_1_T0, LEN(RC5_1_T0));
+  TEST_ASSERT_TRUE(d.read(e));
+  TEST_ASSERT_EQUAL_UINT8(BTN_1, e.button);
+  TEST_ASSERT_EQUAL_UINT8(0, e.toggle);
+  TEST_ASSERT_FALSE(e.repeat);
+}
+
+void test_rc5_same_toggle_after_pause_is_a_new_press(void) {
+  IRDecoder d;
+  replay(d, RC5_1_T0, LEN(RC5_1_T0));
+  TEST_ASSERT_EQUAL_UINT8(1, drain(d));
+  d.feed(false, 300000);
+  IREvent e;
+  replay(d, RC5_1_T0, LEN(RC5_1_T0));
+  TEST_ASSERT_TRUE(d.read(e));
+  TEST_ASSERT_FALSE(e.repeat);
+}
+
+// --- frames that end with the silence ---
+
+void test_end_burst_completes_rc5_ending_in_zero(void) {
+  IRDecoder d;
+  replay(d, RC5_2_T0, LEN(RC5_2_T0));
+  TEST_ASSERT_EQUAL_UINT8(0, drain(d));                 // last half-bit not seen yet
+  d.endBurst();                                         // >20 ms of silence
+  IREvent e;
+  TEST_ASSERT_TRUE(d.read(e));
+  TEST_ASSERT_EQUAL_UINT8(BTN_2, e.button);
+  TEST_ASSERT_EQUAL_UINT8(0, e.toggle);
+  d.feed(false, 25000);                                 // the silence itself adds nothing
+  TEST_ASSERT_EQUAL_UINT8(0, drain(d));
+}
+
+void test_end_burst_completes_sirc(void) {
+  IRDecoder d;
+  replay(d, SIRC_ONE, LEN(SIRC_ONE));
+  TEST_ASSERT_EQUAL_UINT8(0, drain(d));                 // 12, 15 or 20 bits?
+  d.endBurst();
+  IREvent e;
+  TEST_ASSERT_TRUE(d.read(e));
+  TEST_ASSERT_EQUAL_UINT8(BTN_1, e.button);
+  TEST_ASSERT_EQUAL_UINT8(PROTO_SIRC, e.proto);
+  TEST_ASSERT_EQUAL_UINT16(1, e.address);
+  TEST_ASSERT_EQUAL_UINT8(0, e.command);
+  TEST_ASSERT_FALSE(d.read(e));
+}
+
+void test_silence_completes_sirc_without_end_burst(void) {
+  IRDecoder d;
+  replay(d, SIRC_ONE, LEN(SIRC_ONE));
+  d.feed(false, 25000);                                 // the space after the last mark
+  IREvent e;
+  TEST_ASSERT_TRUE(d.read(e));
+  TEST_ASSERT_EQUAL_UINT8(BTN_1, e.button);
+  d.endBurst();
+  TEST_ASSERT_FALSE(d.read(e));                         // not twice
+}
+
+void test_mixed_protocols_in_one_stream(void) {
+  IRDecoder d;
+  IREvent e;
+  replay(d, NEC_ONE, LEN(NEC_ONE));
+  d.feed(false, 50000);
+  replay(d, RC5_2_T0, LEN(RC5_2_T0));
+  d.feed(false, 50000);
+  replay(d, SIRC_ONE, LEN(SIRC_ONE));
+  d.feed(false, 50000);
+  TEST_ASSERT_TRUE(d.read(e)); TEST_ASSERT_EQUAL_UINT8(PROTO_NEC, e.proto);  TEST_ASSERT_EQUAL_UINT8(BTN_1, e.button);
+  TEST_ASSERT_TRUE(d.read(e)); TEST_ASSERT_EQUAL_UINT8(PROTO_RC5, e.proto);  TEST_ASSERT_EQUAL_UINT8(BTN_2, e.button);
+  TEST_ASSERT_TRUE(d.read(e)); TEST_ASSERT_EQUAL_UINT8(PROTO_SIRC, e.proto); TEST_ASSERT_EQUAL_UINT8(BTN_1, e.button);
+  TEST_ASSERT_FALSE(d.read(e));
+}
+
+// --- clock ---
+
+static void compareHolds(IRDecoder& late) {
+  IRDecoder fresh;
+  std::vector<Emit> a = holdNec(fresh, 1500), b = holdNec(late, 1500);
+  checkHold(b, late, 1500);
+  TEST_ASSERT_EQUAL_UINT32(a.size(), b.size());
+  for (size_t i = 0; i < a.size(); i++) {
+    TEST_ASSERT_EQUAL_UINT32(a[i].ms, b[i].ms);
+    TEST_ASSERT_EQUAL(a[i].repeat, b[i].repeat);
+  }
+}
+
+void test_hold_across_2_32_us(void) {
+  IRDecoder d;
+  d.feed(false, 4294000000UL);                // 71.6 min of silence, the hold spans 2^32 µs
+  compareHolds(d);
+}
+
+void test_hold_across_2_32_ms(void) {
+  IRDecoder d;
+  uint64_t target = 4294967296ULL * 1000 - 700000;   // 49.7 days, the hold spans 2^32 ms
+  for (uint64_t t = 0; t < target;) {
+    uint32_t step = (target - t > 4000000000ULL) ? 4000000000UL : (uint32_t)(target - t);
+    d.feed(false, step);
+    t += step;
+  }
+  TEST_ASSERT_GREATER_THAN_UINT32(4294960000UL, d.nowMs());
+  compareHolds(d);
+}
+
+int main(int, char**) {
+  UNITY_BEGIN();
+  RUN_TEST(test_nec_captured_frame);
+  RUN_TEST(test_nec_tolerance_limits);
+  RUN_TEST(test_nec_corrupted_frame_is_dropped);
+  RUN_TEST(test_nec_repeat_and_hold);
+  RUN_TEST(test_nec_repeat_without_press_is_ignored);
+  RUN_TEST(test_nec_auto_repeat_off);
+  RUN_TEST(test_rc5_toggle);
+  RUN_TEST(test_rc5_same_toggle_after_pause_is_a_new_press);
+  RUN_TEST(test_end_burst_completes_rc5_ending_in_zero);
+  RUN_TEST(test_end_burst_completes_sirc);
+  RUN_TEST(test_silence_completes_sirc_without_end_burst);
+  RUN_TEST(test_mixed_protocols_in_one_stream);
+  RUN_TEST(test_hold_across_2_32_us);
+  RUN_TEST(test_hold_across_2_32_ms);
+  return UNITY_END();
+}
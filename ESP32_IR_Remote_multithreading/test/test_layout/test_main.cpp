@@ -0,0 +1,174 @@
+/*
+test_layout — MyLayout.h: matrix, ring and point layouts
+- A 16×16 serpentine panel matches the hand-written index formula, and
+  at(info(i)) == i for every rotation × mirror × serpentine × columns
+  combination (32 of them) on a non-square panel.
+- Every path() is a permutation of 0..N-1; PATH_ROWS, PATH_ANGLE and
+  PATH_RADIUS visit the LEDs in their sort order.
+- Ring angles are exact, rows() visits row-major, remap() puts logical
+  pixel k onto pathIndex(k) and nothing else.
+
+Run (from the project folder):
+  pio test -e native -f test_layout
+*/
+
+#include <unity.h>
+#include <MyShows.h>
+#include <MyLayout.h>
+#include <string.h>
+
+using namespace MyShows;
+
+void setUp(void) {}
+void tearDown(void) {}
+
+template<uint16_t N, uint8_t W, uint8_t H>
+static void assertPermutation(const Layout<N, W, H>& l) {
+  static bool seen[N];
+  memset(seen, 0, sizeof(seen));
+  for (uint16_t k = 0; k < N; k++) {
+    uint16_t i = l.pathIndex(k);
+    TEST_ASSERT_TRUE(i < N);
+    TEST_ASSERT_FALSE(seen[i]);
+    seen[i] = true;
+  }
+}
+
+void test_serpentine_matches_formula(void) {
+  static Layout<256, 16, 16> l;
+  Matrix m = { 16, 16, true, false, 0, false };
+  TEST_ASSERT_TRUE(l.matrix(m));
+  for (uint8_t y = 0; y < 16; y++)
+    for (uint8_t x = 0; x < 16; x++) {
+      uint16_t expect = (y & 1) ? y * 16 + 15 - x : y * 16 + x;
+      TEST_ASSERT_EQUAL_UINT16(expect, l.at(x, y));
+    }
+  TEST_ASSERT_EQUAL_UINT16(NO_LED, l.at(16, 0));
+  TEST_ASSERT_EQUAL_UINT16(NO_LED, l.at(0, 16));
+}
+
+void test_rotation_of_a_small_panel(void) {
+  static Layout<64, 8, 8> l;
+  Matrix m = { 8, 8, true, false, 0, false };
+  l.matrix(m);
+  TEST_ASSERT_EQUAL_UINT16(15, l.at(0, 1));              // row 1 runs backwards
+  m.rotate = 2;                                          // 180°: LED 0 bottom right
+  l.matrix(m);
+  TEST_ASSERT_EQUAL_UINT16(0, l.at(7, 7));
+  TEST_ASSERT_EQUAL_UINT16(55, l.at(0, 1));              // was (7, 6), an even row
+}
+
+void test_every_orientation_round_trips(void) {
+  static Layout<24, 6, 6> l;                             // 6×4 panel, 4×6 when turned
+  for (uint8_t combo = 0; combo < 32; combo++) {
+    Matrix m = { 6, 4, (bool)(combo & 1), (bool)(combo & 2), (uint8_t)((combo >> 2) & 3), (bool)(combo & 16) };
+    TEST_ASSERT_TRUE(l.matrix(m));
+    uint8_t used = 0;
+    for (uint16_t i = 0; i < 24; i++) {
+      const auto& in = l.info(i);
+      TEST_ASSERT_EQUAL_UINT16(i, l.at(in.x, in.y));
+      TEST_ASSERT_TRUE((m.rotate & 1) ? (in.x < 4 && in.y < 6) : (in.x < 6 && in.y < 4));
+    }
+    for (uint8_t y = 0; y < 6; y++)
+      for (uint8_t x = 0; x < 6; x++) used += l.at(x, y) != NO_LED;
+    TEST_ASSERT_EQUAL_UINT8(24, used);
+  }
+  Matrix wrong = { 5, 5, true, false, 0, false };         // 25 ≠ N
+  TEST_ASSERT_FALSE(l.matrix(wrong));
+  Matrix big = { 8, 3, true, false, 0, false };           // 8 columns do not fit W = 6
+  TEST_ASSERT_FALSE(l.matrix(big));
+}
+
+void test_paths_are_sorted_permutations(void) {
+  static Layout<256, 16, 16> l;
+  Matrix m = { 16, 16, true, false, 1, true };
+  l.matrix(m);
+  for (uint8_t p = PATH_WIRING; p <= PATH_RADIUS; p++) {
+    l.path((Path)p);
+    assertPermutation(l);
+  }
+  l.path(PATH_WIRING);
+  for (uint16_t k = 0; k < 256; k++) TEST_ASSERT_EQUAL_UINT16(k, l.pathIndex(k));
+  l.path(PATH_ROWS);
+  for (uint16_t k = 1; k < 256; k++) {
+    const auto& a = l.info(l.pathIndex(k - 1));
+    const auto& b = l.info(l.pathIndex(k));
+    TEST_ASSERT_TRUE((a.y << 8 | a.x) < (b.y << 8 | b.x));
+  }
+  l.path(PATH_SNAKE);                                    // row 1 right to left
+  TEST_ASSERT_EQUAL_UINT16(l.at(15, 1), l.pathIndex(16));
+  TEST_ASSERT_EQUAL_UINT16(l.at(0, 1), l.pathIndex(31));
+  l.path(PATH_COLUMNS);
+  TEST_ASSERT_EQUAL_UINT16(l.at(0, 1), l.pathIndex(1));
+  l.path(PATH_ANGLE);
+  for (uint16_t k = 1; k < 256; k++)
+    TEST_ASSERT_TRUE(l.info(l.pathIndex(k - 1)).angle <= l.info(l.pathIndex(k)).angle);
+  l.path(PATH_RADIUS);
+  for (uint16_t k = 1; k < 256; k++)
+    TEST_ASSERT_TRUE(l.info(l.pathIndex(k - 1)).radius <= l.info(l.pathIndex(k)).radius);
+  TEST_ASSERT_EQUAL_UINT8(255, l.info(l.pathIndex(255)).radius);   // a corner is the farthest
+}
+
+void test_ring_angles(void) {
+  static Layout<12, 9, 9> l;
+  l.ring();
+  for (uint16_t i = 0; i < 12; i++) {
+    TEST_ASSERT_EQUAL_UINT8((uint8_t)(i * 256 / 12), l.info(i).angle);
+    TEST_ASSERT_EQUAL_UINT8(255, l.info(i).radius);
+  }
+  TEST_ASSERT_EQUAL_UINT8(4, l.info(0).x);               // LED 0 at the top
+  TEST_ASSERT_EQUAL_UINT8(0, l.info(0).y);
+  TEST_ASSERT_EQUAL_UINT8(8, l.info(3).x);               // a quarter turn clockwise: right
+  TEST_ASSERT_EQUAL_UINT8(4, l.info(3).y);
+  l.ring(64, false);                                     // start on the right, counter-clockwise
+  TEST_ASSERT_EQUAL_UINT8(64, l.info(0).angle);
+  TEST_ASSERT_EQUAL_UINT8(0, l.info(3).angle);
+  l.path(PATH_ANGLE);
+  assertPermutation(l);
+  TEST_ASSERT_EQUAL_UINT16(3, l.pathIndex(0));
+}
+
+void test_points_and_rows(void) {
+  static Layout<5, 4, 3> l;
+  static const Point P[5] = { {3, 2}, {0, 0}, {2, 0}, {1, 1}, {0, 2} };
+  TEST_ASSERT_TRUE(l.points(P));
+  const uint16_t expect[5] = { 1, 2, 3, 4, 0 };           // row-major order of the points
+  uint8_t n = 0;
+  l.rows([&](uint8_t x, uint8_t y, uint16_t i) {
+    TEST_ASSERT_EQUAL_UINT16(expect[n], i);
+    TEST_ASSERT_EQUAL_UINT8(P[i].x, x);
+    TEST_ASSERT_EQUAL_UINT8(P[i].y, y);
+    n++;
+  });
+  TEST_ASSERT_EQUAL_UINT8(5, n);
+  TEST_ASSERT_EQUAL_UINT16(NO_LED, l.at(1, 0));
+  static const Point OUT[5] = { {0, 0}, {4, 0}, {0, 1}, {1, 1}, {2, 2} };
+  TEST_ASSERT_FALSE(l.points(OUT));
+}
+
+void test_remap_round_trip(void) {
+  static Layout<256, 16, 16> l;
+  Matrix m = { 16, 16, true, true, 3, false };
+  l.matrix(m);
+  static uint8_t logical[256 * 3], physical[256 * 3];
+  for (uint16_t k = 0; k < 256 * 3; k++) logical[k] = (uint8_t)(k * 7 + 1);
+  for (uint8_t p = PATH_WIRING; p <= PATH_RADIUS; p++) {
+    l.path((Path)p);
+    memset(physical, 0, sizeof(physical));
+    l.remap(logical, physical);
+    for (uint16_t k = 0; k < 256; k++)
+      TEST_ASSERT_EQUAL_UINT8_ARRAY(logical + k * 3, physical + l.pathIndex(k) * 3, 3);
+  }
+}
+
+int main(int, char**) {
+  UNITY_BEGIN();
+  RUN_TEST(test_serpentine_matches_formula);
+  RUN_TEST(test_rotation_of_a_small_panel);
+  RUN_TEST(test_every_orientation_round_trips);
+  RUN_TEST(test_paths_are_sorted_permutations);
+  RUN_TEST(test_ring_angles);
+  RUN_TEST(test_points_and_rows);
+  RUN_TEST(test_remap_round_trip);
+  return UNITY_END();
+}
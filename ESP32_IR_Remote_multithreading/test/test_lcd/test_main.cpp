@@ -0,0 +1,219 @@
+/*
+test_lcd — MyLcd.h: the shadow buffer and how many I2C bytes flush() sends
+- MockLcd is a 20×4 HD44780 behind a PCF8574, like LiquidCrystal_I2C:
+  every command or character is two nibbles × (data, EN high, EN low)
+  = 6 one-byte transfers = 12 bytes with the address. DDRAM addresses and
+  the row 0 → row 2 wrap are emulated, so a stray write shows on screen.
+- One changed digit costs 24 bytes (cursor + character), neighbouring
+  changes share one cursor move, an unchanged redraw costs nothing, and
+  clear() plus a short text uses a real clear when that is cheaper.
+- flush(n) never spends more than n writes; random edits always end with
+  the LCD showing exactly the buffer.
+
+Run (from the project folder):
+  pio test -e native -f test_lcd
+*/
+
+#include <unity.h>
+#include <MyLcd.h>
+#include <string.h>
+
+void setUp(void) {}
+void tearDown(void) {}
+
+static const uint8_t COLS = 20, ROWS = 4;
+static const uint32_t BYTES_PER_SEND = 12;
+
+struct MockLcd {
+  uint8_t  ddram[128];
+  uint8_t  addr = 0;
+  uint32_t bytes = 0, clears = 0, moves = 0, chars = 0;
+
+  MockLcd() { memset(ddram, ' ', sizeof(ddram)); }
+
+  static uint8_t offset(uint8_t r) { static const uint8_t OFF[4] = { 0x00, 0x40, 0x14, 0x54 }; return OFF[r]; }
+
+  void clear()                         { bytes += BYTES_PER_SEND; clears++; memset(ddram, ' ', sizeof(ddram)); addr = 0; }
+  void setCursor(uint8_t c, uint8_t r) { bytes += BYTES_PER_SEND; moves++; addr = offset(r) + c; }
+  size_t write(uint8_t ch) {
+    bytes += BYTES_PER_SEND;
+    chars++;
+    ddram[addr] = ch;
+    addr++;
+    if (addr == 0x28) addr = 0x40;      // line 1 of DDRAM ends at 0x27
+    else if (addr == 0x68) addr = 0x00;
+    return 1;
+  }
+  char at(uint8_t c, uint8_t r) const { return (char)ddram[offset(r) + c]; }
+};
+
+typedef MyLcd::Shadow<MockLcd, COLS, ROWS> Lcd;
+
+static void assertShows(const MockLcd& hw, const Lcd& lcd) {
+  for (uint8_t r = 0; r < ROWS; r++)
+    for (uint8_t c = 0; c < COLS; c++) TEST_ASSERT_EQUAL_INT8(lcd.at(c, r), hw.at(c, r));
+}
+
+static void menu(Lcd& lcd, uint8_t choice) {
+  lcd.clear();
+  lcd.setCursor(0, 0); lcd.print("Svetelne show");
+  lcd.setCursor(0, 1); lcd.print("Vyber: ");
+  char d[2] = { (char)('0' + choice), 0 };
+  lcd.print(d);
+  lcd.setCursor(0, 3); lcd.print("Jas 120  Rezim 3");
+}
+
+void test_begin_clears_once(void) {
+  MockLcd hw;
+  Lcd lcd(hw);
+  lcd.begin();
+  TEST_ASSERT_EQUAL_UINT32(1, hw.clears);
+  TEST_ASSERT_EQUAL_UINT32(BYTES_PER_SEND, hw.bytes);
+  TEST_ASSERT_FALSE(lcd.pending());
+}
+
+void test_print_sends_nothing_until_flush(void) {
+  MockLcd hw;
+  Lcd lcd(hw);
+  lcd.begin();
+  hw.bytes = 0;
+  menu(lcd, 3);
+  TEST_ASSERT_EQUAL_UINT32(0, hw.bytes);
+  TEST_ASSERT_TRUE(lcd.pending());
+  lcd.flushAll();
+  assertShows(hw, lcd);
+  TEST_ASSERT_FALSE(lcd.pending());
+}
+
+void test_one_digit_costs_24_bytes(void) {
+  MockLcd hw;
+  Lcd lcd(hw);
+  lcd.begin();
+  menu(lcd, 3);
+  lcd.flushAll();
+  hw.bytes = 0;
+  menu(lcd, 4);                          // the whole menu redrawn, one character differs
+  lcd.flushAll();
+  TEST_ASSERT_EQUAL_UINT32(2 * BYTES_PER_SEND, hw.bytes);
+  TEST_ASSERT_EQUAL_UINT32(1, hw.clears);              // only the one from begin()
+  assertShows(hw, lcd);
+}
+
+void test_unchanged_redraw_is_free(void) {
+  MockLcd hw;
+  Lcd lcd(hw);
+  lcd.begin();
+  menu(lcd, 7);
+  lcd.flushAll();
+  hw.bytes = 0;
+  menu(lcd, 7);                          // clear() marks the rows, the text puts them back
+  TEST_ASSERT_EQUAL_UINT8(0, lcd.flush(255));
+  TEST_ASSERT_EQUAL_UINT32(0, hw.bytes);
+  TEST_ASSERT_FALSE(lcd.pending());
+}
+
+void test_adjacent_changes_share_a_cursor_move(void) {
+  MockLcd hw;
+  Lcd lcd(hw);
+  lcd.begin();
+  lcd.setCursor(5, 2);
+  lcd.print("12345");
+  hw.bytes = hw.moves = 0;
+  TEST_ASSERT_EQUAL_UINT8(6, lcd.flush(255));
+  TEST_ASSERT_EQUAL_UINT32(1, hw.moves);
+  TEST_ASSERT_EQUAL_UINT32(6 * BYTES_PER_SEND, hw.bytes);
+
+  lcd.setCursor(0, 0); lcd.print("A");  // two separate spots: two moves
+  lcd.setCursor(9, 0); lcd.print("B");
+  hw.bytes = hw.moves = 0;
+  TEST_ASSERT_EQUAL_UINT8(4, lcd.flush(255));
+  TEST_ASSERT_EQUAL_UINT32(2, hw.moves);
+  assertShows(hw, lcd);
+}
+
+void test_clear_is_used_when_cheaper(void) {
+  MockLcd hw;
+  Lcd lcd(hw);
+  lcd.begin();
+  for (uint8_t r = 0; r < ROWS; r++) {   // a full screen of text
+    lcd.setCursor(0, r);
+    lcd.print("ABCDEFGHIJKLMNOPQRST");
+  }
+  lcd.flushAll();
+  hw.bytes = hw.clears = 0;
+  lcd.clear();
+  lcd.print("Hi");
+  lcd.flushAll();
+  TEST_ASSERT_EQUAL_UINT32(1, hw.clears);
+  TEST_ASSERT_EQUAL_UINT32(3 * BYTES_PER_SEND, hw.bytes);   // clear + "Hi", the cursor is already at 0,0
+  assertShows(hw, lcd);
+
+  hw.clears = 0;                         // mostly the same text again: overwrite, no clear
+  lcd.clear();
+  lcd.print("Ho");
+  lcd.flushAll();
+  TEST_ASSERT_EQUAL_UINT32(0, hw.clears);
+  assertShows(hw, lcd);
+}
+
+void test_text_past_the_row_is_clipped(void) {
+  MockLcd hw;
+  Lcd lcd(hw);
+  lcd.begin();
+  lcd.setCursor(16, 0);
+  lcd.print("Detail)");                  // 7 characters from column 16
+  lcd.setCursor(0, 5);
+  lcd.print("nowhere");
+  lcd.flushAll();
+  TEST_ASSERT_EQUAL_INT8('D', hw.at(16, 0));
+  TEST_ASSERT_EQUAL_INT8('a', hw.at(19, 0));
+  for (uint8_t c = 0; c < COLS; c++) TEST_ASSERT_EQUAL_INT8(' ', hw.at(c, 2));   // HD44780 would wrap here
+  assertShows(hw, lcd);
+}
+
+void test_budget_and_random_edits(void) {
+  MockLcd hw;
+  Lcd lcd(hw);
+  lcd.begin();
+  uint32_t rng = 2463534242u;
+  for (uint16_t step = 0; step < 20000; step++) {
+    rng ^= rng << 13; rng ^= rng >> 17; rng ^= rng << 5;
+    switch (rng % 8) {
+      case 0: lcd.clear(); break;
+      case 1: case 2: case 3: {
+        lcd.setCursor((uint8_t)(rng >> 8) % (COLS + 2), (uint8_t)(rng >> 16) % ROWS);
+        char s[6];
+        uint8_t n = 1 + (rng >> 20) % 5;
+        for (uint8_t i = 0; i < n; i++) s[i] = (char)('A' + (rng >> (i * 3)) % 4);
+        s[n] = 0;
+        lcd.print(s);
+        break;
+      }
+      default: {
+        uint8_t budget = (uint8_t)(1 + (rng >> 8) % 8);
+        uint32_t before = hw.bytes;
+        uint8_t spent = lcd.flush(budget);
+        TEST_ASSERT_TRUE(spent <= budget);
+        TEST_ASSERT_TRUE(hw.bytes - before <= (uint32_t)budget * BYTES_PER_SEND);
+        break;
+      }
+    }
+    if (step % 100 == 99) {
+      lcd.flushAll();
+      assertShows(hw, lcd);
+    }
+  }
+}
+
+int main(int, char**) {
+  UNITY_BEGIN();
+  RUN_TEST(test_begin_clears_once);
+  RUN_TEST(test_print_sends_nothing_until_flush);
+  RUN_TEST(test_one_digit_costs_24_bytes);
+  RUN_TEST(test_unchanged_redraw_is_free);
+  RUN_TEST(test_adjacent_changes_share_a_cursor_move);
+  RUN_TEST(test_clear_is_used_when_cheaper);
+  RUN_TEST(test_text_past_the_row_is_clipped);
+  RUN_TEST(test_budget_and_random_edits);
+  return UNITY_END();
+}
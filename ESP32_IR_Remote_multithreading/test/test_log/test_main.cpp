@@ -0,0 +1,184 @@
+/*
+test_log — MyLog.h: BINARY format dictionary and the Decoder
+- Events get a made-up time (µs) and go through detail::emit(), so the
+  10 s dictionary refresh is checked without waiting: a format is sent
+  once (frame F), then again with the first event after DICT_US, also
+  when it is already known. A decoder attached late decodes from there.
+- A full dictionary starts over; micros() wrapping is not "old".
+- Round trip: the same events drained in TEXT and in BINARY and run
+  through Decoder give the same bytes, including a MyLog::Text that spans
+  continuation records; plain text between frames passes through and a
+  damaged frame is counted and passed on as text.
+
+Run (from the project folder):
+  pio test -e native -f test_log
+*/
+
+#include <unity.h>
+#include <MyLog.h>
+#include <string.h>
+#include <string>
+
+using namespace MyLog;
+
+struct Sink {
+  std::string s;
+  void write(const uint8_t* p, size_t n) { s.append((const char*)p, n); }
+};
+
+static const uint32_t S = 1000000UL;   // µs
+
+void setUp(void) {
+  detail::G::dictCount = 0;
+  detail::G::dictSince = 0;
+  setMode(BINARY);
+}
+void tearDown(void) {}
+
+// Like MyLog::log(), but with a given time and straight to emit()
+template<class... A> static void event(Sink& out, uint32_t t, const char* fmt, const A&... args) {
+  Event e;
+  e.fmt = fmt; e.level = MYLOG_INFO; e.n = 0;
+  e.text = NO_TEXT; e.textLen = 0; e.more = 0;
+  const char* rest = nullptr;
+  detail::put(e, rest, args...);
+  e.t = t;
+  detail::emit(out, e, 0, nullptr);
+}
+
+// Frames of a type in a BINARY stream (nothing else in it)
+static int frames(const std::string& s, uint8_t type) {
+  int n = 0;
+  for (size_t p = 0; p + 3 < s.size(); p += 3 + (uint8_t)s[p + 2] + 1) {
+    TEST_ASSERT_EQUAL_HEX8(SYNC, (uint8_t)s[p]);
+    if ((uint8_t)s[p + 1] == type) n++;
+  }
+  return n;
+}
+
+static std::string decode(const std::string& s, Decoder& d) {
+  Sink out;
+  for (char c : s) d.feed((uint8_t)c, out);
+  return out.s;
+}
+
+static const char* const FMT_A = "Rychlost %u ms";
+static const char* const FMT_B = "Jas %d";
+
+void test_format_sent_once(void) {
+  Sink out;
+  event(out, 1 * S, FMT_A, 80u);
+  event(out, 2 * S, FMT_A, 90u);
+  event(out, 3 * S, FMT_B, -5);
+  event(out, 4 * S, FMT_A, 100u);
+  TEST_ASSERT_EQUAL(2, frames(out.s, FRAME_FORMAT));
+  TEST_ASSERT_EQUAL(4, frames(out.s, FRAME_EVENT));
+}
+
+void test_dictionary_resent_after_10_s(void) {
+  Sink out;
+  event(out, 1 * S, FMT_A, 1u);
+  event(out, 9 * S, FMT_A, 2u);
+  TEST_ASSERT_EQUAL(1, frames(out.s, FRAME_FORMAT));
+  event(out, DICT_US + 1, FMT_A, 3u);                 // known, but the dictionary is old
+  TEST_ASSERT_EQUAL(2, frames(out.s, FRAME_FORMAT));
+  event(out, 12 * S, FMT_A, 4u);
+  event(out, 13 * S, FMT_B, 5);
+  TEST_ASSERT_EQUAL(3, frames(out.s, FRAME_FORMAT));
+  event(out, 2 * DICT_US + 2, FMT_B, 6);
+  event(out, 2 * DICT_US + 3, FMT_A, 7u);             // both again after the next 10 s
+  TEST_ASSERT_EQUAL(5, frames(out.s, FRAME_FORMAT));
+  TEST_ASSERT_EQUAL(7, frames(out.s, FRAME_EVENT));
+}
+
+void test_late_decoder_picks_up_after_resend(void) {
+  Sink early, late;
+  event(early, 1 * S, FMT_A, 1u);
+  event(late, 5 * S, FMT_A, 2u);                      // capture starts here
+  event(late, 11 * S, FMT_A, 3u);
+  Decoder d;
+  std::string text = decode(late.s, d);
+  TEST_ASSERT_EQUAL_STRING("[   5.000 0] (format #0 not received yet)\r\n"
+                           "[  11.000 0] Rychlost 3 ms\r\n", text.c_str());
+  TEST_ASSERT_EQUAL_UINT32(0, d.badFrames);
+}
+
+void test_full_dictionary_starts_over(void) {
+  static char fmts[DICT + 1][8];
+  Sink out;
+  for (uint8_t k = 0; k <= DICT; k++) {
+    snprintf(fmts[k], sizeof(fmts[k]), "f%u %%u", k);
+    event(out, 1 * S + k, fmts[k], k);
+  }
+  TEST_ASSERT_EQUAL(DICT + 1, frames(out.s, FRAME_FORMAT));
+  TEST_ASSERT_EQUAL_UINT8(1, detail::G::dictCount);
+  event(out, 2 * S, fmts[0], 0u);                     // dropped with the rest: sent again
+  TEST_ASSERT_EQUAL(DICT + 2, frames(out.s, FRAME_FORMAT));
+  Decoder d;
+  std::string text = decode(out.s, d);
+  TEST_ASSERT_NOT_NULL(strstr(text.c_str(), "] f32 32\r\n"));
+  TEST_ASSERT_NOT_NULL(strstr(text.c_str(), "[   2.000 0] f0 0\r\n"));
+}
+
+void test_micros_wrap_is_not_old(void) {
+  detail::G::dictSince = 0xFFFFFFFFUL - 2 * S;
+  Sink out;
+  event(out, 0xFFFFFFFFUL - 1 * S, FMT_A, 1u);
+  event(out, 3 * S, FMT_A, 2u);                       // 4 s later, across the wrap
+  TEST_ASSERT_EQUAL(1, frames(out.s, FRAME_FORMAT));
+  event(out, 9 * S, FMT_A, 3u);                       // 10 s after dictSince
+  TEST_ASSERT_EQUAL(2, frames(out.s, FRAME_FORMAT));
+}
+
+void test_round_trip_matches_text(void) {
+  static const char* const NAMES[] = { "RAINBOW", "FIRE" };
+  char mac[200];
+  for (uint8_t k = 0; k < sizeof(mac) - 1; k++) mac[k] = (char)('a' + k % 26);
+  mac[sizeof(mac) - 1] = '\0';
+
+  MYLOG_I("SHOW %u: %s", 3u, NAMES[1]);
+  MYLOG_W("Odeslani selhalo: %d (%x, %c) 100%%", -12, 0xBEEFu, 'k');
+  MYLOG_E("Teplota %.1f C, napeti %5.2f", 23.45, -0.5);
+  MYLOG_I("%s od %02X: %s", NAMES[0], 0xABu, MyLog::Text(mac));   // spans continuation records
+  MYLOG_I("Bez argumentu");
+  MYLOG_I("Chybi %u a %u", 1u);
+
+  Ring saved = detail::G::rings[0];
+  Sink text, binary;
+  setMode(TEXT);
+  TEST_ASSERT_EQUAL_UINT16(6, drain(text));
+  detail::G::rings[0] = saved;
+  setMode(BINARY);
+  binary.s = "boot\r\n";                              // plain Serial.print before the frames
+  TEST_ASSERT_EQUAL_UINT16(6, drain(binary));
+
+  Decoder d;
+  TEST_ASSERT_EQUAL_STRING(("boot\r\n" + text.s).c_str(), decode(binary.s, d).c_str());
+  TEST_ASSERT_EQUAL_UINT32(0, d.badFrames);
+  TEST_ASSERT_NOT_NULL(strstr(text.s.c_str(), mac));
+}
+
+void test_damaged_frame_passes_through(void) {
+  Sink out;
+  event(out, 1 * S, FMT_A, 80u);
+  size_t f = out.s.size();
+  event(out, 2 * S, FMT_A, 90u);
+  out.s[out.s.size() - 1] ^= 0x55;                    // checksum of the second event
+  Decoder d;
+  std::string text = decode(out.s, d);
+  TEST_ASSERT_EQUAL_UINT32(1, d.badFrames);
+  TEST_ASSERT_EQUAL_STRING("[   1.000 0] Rychlost 80 ms\r\n", text.substr(0, 29).c_str());
+  TEST_ASSERT_EQUAL(29 + out.s.size() - f, text.size());
+}
+
+int main(int, char**) {
+  UNITY_BEGIN();
+  RUN_TEST(test_format_sent_once);
+  RUN_TEST(test_dictionary_resent_after_10_s);
+  RUN_TEST(test_late_decoder_picks_up_after_resend);
+  RUN_TEST(test_full_dictionary_starts_over);
+  RUN_TEST(test_micros_wrap_is_not_old);
+  RUN_TEST(test_round_trip_matches_text);
+  RUN_TEST(test_damaged_frame_passes_through);
+  return UNITY_END();
+}
@@ -0,0 +1,210 @@
+/*
+test_morse — MyMorse.h: the packed code table, Sender timing, Receiver decoding
+- Every letter and digit is compared with its readable pattern, and
+  decode(encode(c)) must give c back for every character in the table.
+- Sender: "PARIS " is exactly 50 dots at any speed, Farnsworth stretches it
+  to the effective speed, and calling update() late does not shift the
+  schedule.
+- Receiver: Sender → Receiver loopback at several speeds starting from a
+  wrong guess, with key bounce, plus the word gap and unknown patterns.
+  With Farnsworth the first word comes out letter by letter (its gaps look
+  like word gaps) until the receiver has heard both kinds of gap.
+
+Run (from the project folder):
+  pio test -e native -f test_morse
+*/
+
+#include <unity.h>
+#include <MyMorse.h>
+#include <string.h>
+
+using namespace MyMorse;
+
+void setUp(void) {}
+void tearDown(void) {}
+
+static uint8_t packed(const char* s) {
+  uint8_t acc = 1;
+  for (; *s; s++) acc = (uint8_t)((acc << 1) | (*s == '-'));
+  return acc;
+}
+
+void test_table_letters_and_digits(void) {
+  static const char* const ALPHA[26] = {
+    ".-", "-...", "-.-.", "-..", ".", "..-.", "--.", "....", "..", ".---", "-.-", ".-..", "--",
+    "-.", "---", ".--.", "--.-", ".-.", "...", "-", "..-", "...-", ".--", "-..-", "-.--", "--.."
+  };
+  static const char* const DIGIT[10] = {
+    "-----", ".----", "..---", "...--", "....-", ".....", "-....", "--...", "---..", "----."
+  };
+  for (uint8_t i = 0; i < 26; i++) {
+    TEST_ASSERT_EQUAL_HEX8(packed(ALPHA[i]), encode((char)('A' + i)));
+    TEST_ASSERT_EQUAL_HEX8(packed(ALPHA[i]), encode((char)('a' + i)));
+    TEST_ASSERT_EQUAL_UINT8(strlen(ALPHA[i]), detail::length(encode((char)('A' + i))));
+  }
+  for (uint8_t i = 0; i < 10; i++) TEST_ASSERT_EQUAL_HEX8(packed(DIGIT[i]), encode((char)('0' + i)));
+  TEST_ASSERT_EQUAL_HEX8(0b101, encode('A'));
+}
+
+void test_table_round_trip(void) {
+  uint8_t withCode = 0;
+  for (char c = FIRST + 1; c <= LAST; c++) {
+    uint8_t code = encode(c);
+    if (!code) continue;
+    withCode++;
+    TEST_ASSERT_TRUE(detail::length(code) <= MAX_MARKS);
+    TEST_ASSERT_EQUAL_INT8(c, decode(code));              // no two characters share a code
+  }
+  TEST_ASSERT_TRUE(withCode >= 26 + 10 + 15);
+  TEST_ASSERT_EQUAL_UINT8(0, encode(' '));
+  TEST_ASSERT_EQUAL_UINT8(0, encode('#'));
+  TEST_ASSERT_EQUAL_UINT8(0, encode('~'));
+  TEST_ASSERT_EQUAL_INT8(UNKNOWN, decode(packed("........")));
+}
+
+// how long the key is down / the whole text takes when update() runs every ms
+static uint32_t keyedMs(Sender& tx, const char* text, uint32_t& downMs) {
+  tx.send(text);
+  uint32_t t = 0;
+  downMs = 0;
+  while (tx.busy()) {
+    if (tx.update(t)) downMs++;
+    t++;
+  }
+  return t;
+}
+
+void test_paris_is_fifty_dots(void) {
+  const uint8_t speeds[] = { 5, 12, 20, 30 };
+  for (uint8_t i = 0; i < 4; i++) {
+    Sender tx;
+    tx.setSpeed(speeds[i]);
+    uint16_t dot = 1200 / speeds[i];
+    uint32_t down;
+    uint32_t total = keyedMs(tx, "PARIS ", down);
+    TEST_ASSERT_UINT32_WITHIN(1, 50UL * dot, total);     // 31 units of gaps incl. the word gap
+    TEST_ASSERT_EQUAL_UINT32(22UL * dot, down);          // P .--. A .- R .-. I .. S ...
+  }
+}
+
+void test_farnsworth(void) {
+  Timing t = timing(20, 10);
+  TEST_ASSERT_EQUAL_UINT16(60, t.dot);
+  TEST_ASSERT_EQUAL_UINT16(180, t.dash);
+  TEST_ASSERT_TRUE(t.letterGap > 3 * t.dot);
+  TEST_ASSERT_UINT16_WITHIN(3, t.letterGap * 7 / 3, t.wordGap);
+
+  Sender tx;
+  tx.setSpeed(20, 10);
+  uint32_t down;
+  uint32_t total = keyedMs(tx, "PARIS ", down);
+  TEST_ASSERT_UINT32_WITHIN(15, 6000, total);            // one PARIS at 10 WPM
+  TEST_ASSERT_EQUAL_UINT32(22UL * 60, down);             // marks still at 20 WPM
+
+  Timing same = timing(20, 25);                          // faster "effective" = plain timing
+  TEST_ASSERT_EQUAL_UINT16(180, same.letterGap);
+}
+
+void test_late_updates_keep_the_schedule(void) {
+  Sender a, b;
+  a.send("SOS SOS");
+  b.send("SOS SOS");
+  uint32_t lastEdgeA = 0, lastEdgeB = 0;
+  bool ka = false, kb = false;
+  uint32_t jitter = 1;
+  for (uint32_t t = 0; a.busy(); t++) {
+    bool k = a.update(t);
+    if (k != ka) { ka = k; lastEdgeA = t; }
+  }
+  for (uint32_t t = 0; b.busy(); t += 1 + (jitter = jitter * 7 % 13) % 9) {   // 1..9 ms late
+    bool k = b.update(t);
+    if (k != kb) { kb = k; lastEdgeB = t; }
+  }
+  TEST_ASSERT_UINT32_WITHIN(9, lastEdgeA, lastEdgeB);    // off by the lateness, not accumulated
+}
+
+void test_queue(void) {
+  Sender tx;
+  char text[QUEUE + 11];
+  memset(text, 'E', sizeof(text) - 1);
+  text[sizeof(text) - 1] = 0;
+  TEST_ASSERT_EQUAL_UINT8(QUEUE, tx.send(text));
+  TEST_ASSERT_EQUAL_UINT8(0, tx.space());
+  TEST_ASSERT_FALSE(tx.push('E'));
+  tx.clear();
+  TEST_ASSERT_FALSE(tx.busy());
+  TEST_ASSERT_FALSE(tx.update(0));
+  TEST_ASSERT_EQUAL_UINT8(QUEUE, tx.space());
+}
+
+// send text, feed the key into a receiver, return what it decoded
+static void loopback(uint8_t wpm, uint8_t effWpm, uint8_t guessWpm, bool bounce, const char* text, char* got, uint8_t cap) {
+  Sender tx;
+  Receiver rx;
+  tx.setSpeed(wpm, effWpm);
+  rx.setSpeed(guessWpm);
+  tx.send(text);
+  uint8_t n = 0;
+  bool prev = false;
+  uint32_t changedAt = 0;
+  for (uint32_t t = 0; t < 600000; t++) {
+    bool key = tx.update(t);
+    if (key != prev) { prev = key; changedAt = t; }
+    bool seen = key;
+    if (bounce && t - changedAt < 4 && (t & 1)) seen = !key;   // contact bounce after each edge
+    rx.update(t, seen);
+    while (rx.available() && n + 1 < cap) got[n++] = rx.read();
+    if (!tx.busy() && t - changedAt > 20UL * 1200 / wpm) break;
+  }
+  got[n] = 0;
+}
+
+void test_loopback_adapts_to_the_sender(void) {
+  const char* text = "CQ CQ DE OK1ABC PSE K ";
+  char got[64];
+  const uint8_t speeds[] = { 8, 12, 20, 30 };
+  for (uint8_t i = 0; i < 4; i++) {
+    loopback(speeds[i], 0, 20, false, text, got, sizeof(got));
+    // the first character may be lost while the dot length is learned
+    const char* tail = strstr(got, "CQ DE OK1ABC PSE K");
+    TEST_ASSERT_NOT_NULL(tail);
+  }
+}
+
+void test_loopback_farnsworth_and_bounce(void) {
+  char got[64];
+  // the stretched letter gaps read as word gaps until the receiver has seen both kinds
+  loopback(20, 10, 20, true, "HELLO WORLD 73 HELLO WORLD 73 ", got, sizeof(got));
+  const char* tail = strstr(got, "WORLD 73 HELLO WORLD 73 ");
+  TEST_ASSERT_NOT_NULL(tail);
+  TEST_ASSERT_EQUAL_STRING("WORLD 73 HELLO WORLD 73 ", tail);
+}
+
+void test_receiver_unknown_pattern(void) {
+  Receiver rx;
+  rx.setSpeed(20);
+  uint32_t t = 0;
+  for (uint8_t i = 0; i < 9; i++) {                      // 9 dots: longer than any character
+    for (uint8_t k = 0; k < 60; k++) rx.update(t++, true);
+    for (uint8_t k = 0; k < 60; k++) rx.update(t++, false);
+  }
+  for (uint16_t k = 0; k < 600; k++) rx.update(t++, false);
+  TEST_ASSERT_EQUAL_UINT8(2, rx.available());
+  TEST_ASSERT_EQUAL_INT8(UNKNOWN, rx.read());
+  TEST_ASSERT_EQUAL_INT8(' ', rx.read());
+  TEST_ASSERT_EQUAL_INT8(0, rx.read());
+}
+
+int main(int, char**) {
+  UNITY_BEGIN();
+  RUN_TEST(test_table_letters_and_digits);
+  RUN_TEST(test_table_round_trip);
+  RUN_TEST(test_paris_is_fifty_dots);
+  RUN_TEST(test_farnsworth);
+  RUN_TEST(test_late_updates_keep_the_schedule);
+  RUN_TEST(test_queue);
+  RUN_TEST(test_loopback_adapts_to_the_sender);
+  RUN_TEST(test_loopback_farnsworth_and_bounce);
+  RUN_TEST(test_receiver_unknown_pattern);
+  return UNITY_END();
+}
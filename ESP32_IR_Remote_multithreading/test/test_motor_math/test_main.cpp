@@ -0,0 +1,117 @@
+/*
+test_motor_math — duty and ramp math of the CAM car (ESP_old_CAM_CAR_V1/MotorMath.h)
+- The car is an Arduino IDE sketch without its own PlatformIO project, so
+  its Arduino-free header is tested here.
+
+Run (from the project folder):
+  pio test -e native -f test_motor_math
+*/
+
+#include <unity.h>
+#include "../../../ESP_old_CAM_CAR_V1/MotorMath.h"
+
+using namespace MotorMath;
+
+void setUp(void) {}
+void tearDown(void) {}
+
+void test_duty_at_zero(void) {
+  TEST_ASSERT_EQUAL_INT16(0, speedFromThrottle(0.0f));
+  TEST_ASSERT_EQUAL_INT16(0, speedFromThrottle(-0.0f));
+  TEST_ASSERT_EQUAL_UINT8(0, dutyOf(0));
+  TEST_ASSERT_EQUAL_UINT32(0, ledcDuty(0, 8));
+  TEST_ASSERT_EQUAL_UINT32(0, ledcDuty(0, 10));
+  TEST_ASSERT_EQUAL_UINT16(0, onTimeUs(0, 833));
+}
+
+void test_duty_at_full_scale(void) {
+  TEST_ASSERT_EQUAL_INT16(255, speedFromThrottle(1.0f));
+  TEST_ASSERT_EQUAL_INT16(255, speedFromThrottle(7.0f));      // clamped
+  TEST_ASSERT_EQUAL_INT16(255, clampSpeed(100000));
+  TEST_ASSERT_EQUAL_UINT8(255, dutyOf(255));
+  // 255 is "always on" for LEDC, not one count short of it
+  TEST_ASSERT_EQUAL_UINT32(1u << 8, ledcDuty(255, 8));
+  TEST_ASSERT_EQUAL_UINT32(1u << 10, ledcDuty(255, 10));
+  TEST_ASSERT_EQUAL_UINT32(254u << 2, ledcDuty(254, 10));
+  TEST_ASSERT_EQUAL_UINT16(833, onTimeUs(255, 833));
+  TEST_ASSERT_EQUAL_UINT16(418, onTimeUs(128, 833));   // 418.1
+}
+
+void test_duty_of_negative_speed(void) {
+  TEST_ASSERT_EQUAL_INT16(-255, speedFromThrottle(-1.0f));
+  TEST_ASSERT_EQUAL_INT16(-255, speedFromThrottle(-3.0f));    // clamped
+  TEST_ASSERT_EQUAL_INT16(-255, clampSpeed(-100000));
+  TEST_ASSERT_EQUAL_INT16(-128, speedFromThrottle(-0.5f));    // rounds away from 0
+  TEST_ASSERT_EQUAL_INT16(128, speedFromThrottle(0.5f));
+  TEST_ASSERT_EQUAL_UINT8(255, dutyOf(-255));                 // direction is on the pins
+  TEST_ASSERT_EQUAL_UINT8(100, dutyOf(-100));
+  TEST_ASSERT_EQUAL_UINT8(1, dutyOf(-1));
+}
+
+void test_nan_throttle_stops(void) {
+  float nan = 0.0f / 0.0f;
+  TEST_ASSERT_EQUAL_INT16(0, speedFromThrottle(nan));
+}
+
+void test_ramp_carries_remainder(void) {
+  Ramp r;
+  r.ratePerSec = 100;                          // one step per 10 ms
+  r.target = 50;
+  TEST_ASSERT_FALSE(r.step(4));                // 0.4 step
+  TEST_ASSERT_EQUAL_INT16(0, r.value);
+  TEST_ASSERT_EQUAL_UINT32(400, r.carry);
+  TEST_ASSERT_FALSE(r.step(5));                // 0.9 step
+  TEST_ASSERT_TRUE(r.step(1));                 // 1.0 step: the remainder was kept
+  TEST_ASSERT_EQUAL_INT16(1, r.value);
+  TEST_ASSERT_EQUAL_UINT32(0, r.carry);
+  TEST_ASSERT_TRUE(r.step(25));                // 2.5 steps
+  TEST_ASSERT_EQUAL_INT16(3, r.value);
+  TEST_ASSERT_EQUAL_UINT32(500, r.carry);
+}
+
+void test_ramp_slope_does_not_depend_on_call_interval(void) {
+  Ramp even, uneven;
+  even.ratePerSec = uneven.ratePerSec = 1020;  // 0..255 in 250 ms
+  even.target = uneven.target = 255;
+  static const uint8_t gaps[] = { 1, 3, 7, 2, 13, 1, 1, 5 };   // 33 ms
+  uint32_t t = 0;
+  for (uint8_t k = 0; k < 6; k++) {
+    for (uint8_t g = 0; g < sizeof(gaps); g++) { uneven.step(gaps[g]); t += gaps[g]; }
+    for (uint8_t m = 0; m < 33; m++) even.step(1);
+    TEST_ASSERT_EQUAL_INT16(even.value, uneven.value);
+    TEST_ASSERT_EQUAL_INT16((int16_t)(t * 1020 / 1000), uneven.value);
+  }
+}
+
+void test_ramp_reverse_and_arrival(void) {
+  Ramp r;
+  r.ratePerSec = 1000;                         // one step per ms
+  r.jump(10);
+  r.target = -10;
+  TEST_ASSERT_TRUE(r.step(15));
+  TEST_ASSERT_EQUAL_INT16(-5, r.value);
+  TEST_ASSERT_TRUE(r.step(100));               // does not overshoot
+  TEST_ASSERT_EQUAL_INT16(-10, r.value);
+  TEST_ASSERT_EQUAL_UINT32(0, r.carry);        // no head start for the next target
+  TEST_ASSERT_FALSE(r.step(100));
+}
+
+void test_ramp_rate_zero_jumps(void) {
+  Ramp r;
+  r.target = -200;
+  TEST_ASSERT_TRUE(r.step(0));
+  TEST_ASSERT_EQUAL_INT16(-200, r.value);
+}
+
+int main(int, char**) {
+  UNITY_BEGIN();
+  RUN_TEST(test_duty_at_zero);
+  RUN_TEST(test_duty_at_full_scale);
+  RUN_TEST(test_duty_of_negative_speed);
+  RUN_TEST(test_nan_throttle_stops);
+  RUN_TEST(test_ramp_carries_remainder);
+  RUN_TEST(test_ramp_slope_does_not_depend_on_call_interval);
+  RUN_TEST(test_ramp_reverse_and_arrival);
+  RUN_TEST(test_ramp_rate_zero_jumps);
+  return UNITY_END();
+}
@@ -0,0 +1,128 @@
+/*
+test_noise — MyNoise.h: integer gradient noise, the row forms, sparkle and fire
+- noiseRow()/fbmRow() must equal noise8()/fbm8() pixel by pixel (they share
+  cell hashes between pixels, nothing else may differ).
+- Integer coordinates give exactly 128, neighbours one step (1/256 of a
+  cell) apart differ by a few counts only, the range is used and centered.
+- sparkle8() lights a minority of the pixels; NoiseFire is the same flame
+  for the same seed, another one for another seed, and step(n) leaves the
+  cells past n alone.
+
+Run (from the project folder):
+  pio test -e native -f test_noise
+*/
+
+#include <unity.h>
+#include <MyShows.h>
+
+using namespace MyShows;
+
+void setUp(void) {}
+void tearDown(void) {}
+
+static uint32_t rng = 2463534242u;
+static uint32_t rnd() { rng ^= rng << 13; rng ^= rng >> 17; rng ^= rng << 5; return rng; }
+
+void test_row_equals_pointwise(void) {
+  uint8_t row[200];
+  for (uint16_t r = 0; r < 2000; r++) {
+    uint16_t n = 1 + rnd() % 200, x = (uint16_t)rnd(), dx = (uint16_t)(rnd() % 700), y = (uint16_t)rnd();
+    noiseRow(row, n, x, dx, y);
+    for (uint16_t i = 0; i < n; i++) TEST_ASSERT_EQUAL_UINT8(noise8((uint16_t)(x + i * dx), y), row[i]);
+  }
+}
+
+void test_fbm_row_equals_pointwise(void) {
+  uint8_t row[200];
+  for (uint16_t r = 0; r < 2000; r++) {
+    uint16_t n = 1 + rnd() % 200, x = (uint16_t)rnd(), dx = (uint16_t)(rnd() % 700), y = (uint16_t)rnd();
+    uint8_t octaves = (uint8_t)(rnd() % 6);             // 0 and 5 are clamped to 1 and 4
+    fbmRow(row, n, x, dx, y, octaves);
+    for (uint16_t i = 0; i < n; i++) TEST_ASSERT_EQUAL_UINT8(fbm8((uint16_t)(x + i * dx), y, octaves), row[i]);
+  }
+}
+
+void test_lattice_points_are_mid(void) {
+  for (uint16_t X = 0; X < 256; X++)
+    for (uint16_t Y = 0; Y < 256; Y += 3) {
+      TEST_ASSERT_EQUAL_UINT8(128, noise8((uint16_t)(X << 8)));
+      TEST_ASSERT_EQUAL_UINT8(128, noise8((uint16_t)(X << 8), (uint16_t)(Y << 8)));
+      TEST_ASSERT_EQUAL_UINT8(128, noise8((uint16_t)(X << 8), (uint16_t)(Y << 8), (uint16_t)((X ^ Y) << 8)));
+    }
+}
+
+void test_smooth_and_centered(void) {
+  uint32_t sum = 0, count = 0;
+  uint8_t lo = 255, hi = 0;
+  for (uint32_t y = 0; y < 65536; y += 251)
+    for (uint32_t x = 0; x < 65535; x += 37) {
+      uint8_t a = noise8((uint16_t)x, (uint16_t)y);
+      TEST_ASSERT_UINT8_WITHIN(3, a, noise8((uint16_t)(x + 1), (uint16_t)y));
+      TEST_ASSERT_UINT8_WITHIN(2, noise8((uint16_t)x), noise8((uint16_t)(x + 1)));
+      TEST_ASSERT_UINT8_WITHIN(3, noise8((uint16_t)x, (uint16_t)y, (uint16_t)(x ^ y)),
+                               noise8((uint16_t)(x + 1), (uint16_t)y, (uint16_t)(x ^ y)));
+      sum += a; count++;
+      if (a < lo) lo = a;
+      if (a > hi) hi = a;
+    }
+  TEST_ASSERT_UINT32_WITHIN(3, 128, sum / count);
+  TEST_ASSERT_TRUE(lo < 20);
+  TEST_ASSERT_TRUE(hi > 235);
+}
+
+void test_sparkle_lights_a_minority(void) {
+  uint32_t lit = 0, total = 0;
+  for (uint32_t t = 0; t < 5000; t++)
+    for (uint16_t i = 0; i < 60; i++, total++) lit += sparkle8((uint16_t)(t * Engine<60>::TWINKLE_SPEED), i) > 0;
+  TEST_ASSERT_TRUE(lit * 100 > total * 5);     // ~14 %
+  TEST_ASSERT_TRUE(lit * 100 < total * 25);
+}
+
+void test_fire_is_seeded(void) {
+  static NoiseFire<60> a, b, c;
+  a.seed(1234); b.seed(1234); c.seed(99);
+  bool differs = false;
+  for (uint16_t f = 0; f < 3000; f++) {
+    a.step(); b.step(); c.step();
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(a.heat, b.heat, 60);
+    if (memcmp(a.heat, c.heat, 60)) differs = true;
+  }
+  TEST_ASSERT_TRUE(differs);
+}
+
+void test_fire_short_strip(void) {
+  static NoiseFire<60> f;
+  f.seed(7);
+  for (uint16_t s = 0; s < 500; s++) {
+    f.step(20);
+    for (uint16_t i = 20; i < 60; i++) TEST_ASSERT_EQUAL_UINT8(0, f.heat[i]);
+  }
+  f.step(0);                                      // nothing to draw, must not crash
+  f.step(1000);                                   // clamped to N
+}
+
+void test_fire_burns(void) {
+  static NoiseFire<60> f;
+  f.seed(5);
+  uint32_t bottom = 0, top = 0;
+  for (uint16_t s = 0; s < 2000; s++) {
+    f.step();
+    bottom += f.heat[1];
+    top += f.heat[59];
+  }
+  TEST_ASSERT_TRUE(bottom > top);                 // hot at the base, cooler at the tip
+  TEST_ASSERT_TRUE(bottom / 2000 > 60);
+}
+
+int main(int, char**) {
+  UNITY_BEGIN();
+  RUN_TEST(test_row_equals_pointwise);
+  RUN_TEST(test_fbm_row_equals_pointwise);
+  RUN_TEST(test_lattice_points_are_mid);
+  RUN_TEST(test_smooth_and_centered);
+  RUN_TEST(test_sparkle_lights_a_minority);
+  RUN_TEST(test_fire_is_seeded);
+  RUN_TEST(test_fire_short_strip);
+  RUN_TEST(test_fire_burns);
+  return UNITY_END();
+}
@@ -0,0 +1,186 @@
+/*
+test_output — MyOutput.h: brightness, gamma, white point and byte order in one pass
+- At gamma 1.0 and a full white point write() gives scale8(value, brightness)
+  for all 256 values × all 256 brightness levels, on every channel.
+- sum() equals the per-channel sums of the bytes written, for write() and
+  for layout.remap(..., output).
+- limit() stacks on top of brightness, gamma and white point only ever
+  dim, ORDER puts the bytes where the strip expects them, and the logical
+  frame is never touched, so brightness changes do not lose precision.
+
+Run (from the project folder):
+  pio test -e native -f test_output
+*/
+
+#include <unity.h>
+#include <MyShows.h>
+#include <MyOutput.h>
+#include <MyLayout.h>
+#include <stdio.h>
+#include <string.h>
+
+using namespace MyShows;
+
+void setUp(void) {}
+void tearDown(void) {}
+
+static const uint16_t N = 60;
+
+static void randomFrame(uint8_t* rgb, uint16_t n, uint32_t& rng) {
+  for (uint16_t k = 0; k < n * 3; k++) {
+    rng ^= rng << 13; rng ^= rng >> 17; rng ^= rng << 5;
+    rgb[k] = (uint8_t)rng;
+  }
+}
+
+static void assertSums(const Output<OrderGRB>& out, const uint8_t* strip, uint16_t n) {
+  uint32_t s[3] = { 0, 0, 0 };
+  for (uint16_t i = 0; i < n; i++) {
+    s[0] += strip[i * 3 + OrderGRB::r];
+    s[1] += strip[i * 3 + OrderGRB::g];
+    s[2] += strip[i * 3 + OrderGRB::b];
+  }
+  TEST_ASSERT_EQUAL_UINT32(s[0], out.sum()[0]);
+  TEST_ASSERT_EQUAL_UINT32(s[1], out.sum()[1]);
+  TEST_ASSERT_EQUAL_UINT32(s[2], out.sum()[2]);
+}
+
+void test_gamma_one_is_scale8(void) {
+  Output<OrderRGB> out;
+  static uint8_t rgb[256 * 3], strip[256 * 3];
+  for (uint16_t v = 0; v < 256; v++) {                   // every value once per channel
+    rgb[v * 3] = (uint8_t)v;
+    rgb[v * 3 + 1] = (uint8_t)(255 - v);
+    rgb[v * 3 + 2] = (uint8_t)(v * 37);
+  }
+  for (uint16_t b = 0; b < 256; b++) {
+    out.brightness((uint8_t)b);
+    out.write(rgb, strip, 256);
+    for (uint16_t k = 0; k < 256 * 3; k++) {
+      if (strip[k] != scale8(rgb[k], (uint8_t)b)) {
+        char msg[48];
+        snprintf(msg, sizeof(msg), "brightness %u, byte %u", b, k);
+        TEST_FAIL_MESSAGE(msg);
+      }
+    }
+  }
+  TEST_ASSERT_EQUAL_UINT8(255, out.brightness());
+}
+
+void test_sum_matches_the_output(void) {
+  Output<OrderGRB> out;
+  static uint8_t rgb[N * 3], strip[N * 3];
+  uint32_t rng = 2463534242u;
+  const uint8_t levels[] = { 255, 120, 7, 0 };
+  for (uint8_t i = 0; i < 4; i++) {
+    randomFrame(rgb, N, rng);
+    out.brightness(levels[i]);
+    out.gamma(i & 1 ? 2.2f : 1.0f);
+    out.temperature(i & 2 ? 3000 : 0);
+    out.write(rgb, strip, N);
+    assertSums(out, strip, N);
+  }
+  memset(rgb, 255, sizeof(rgb));                         // full white at full brightness
+  out.brightness(255); out.gamma(1.0f); out.temperature(0);
+  out.write(rgb, strip, N);
+  TEST_ASSERT_EQUAL_UINT32(255UL * N, out.sum()[0]);
+  out.write(rgb, strip, 0);                              // an empty frame resets the sums
+  TEST_ASSERT_EQUAL_UINT32(0, out.sum()[1]);
+}
+
+void test_remap_with_output(void) {
+  static Layout<N, 12, 5> layout;
+  Matrix m = { 12, 5, true, false, 0, false };
+  TEST_ASSERT_TRUE(layout.matrix(m));
+  layout.path(PATH_ROWS);
+  Output<OrderGRB> out;
+  out.brightness(90);
+  out.gamma(2.4f);
+  out.temperature(4000);
+  static uint8_t rgb[N * 3], plain[N * 3], direct[N * 3], fused[N * 3];
+  uint32_t rng = 12345u;
+  randomFrame(rgb, N, rng);
+  out.write(rgb, direct, N);                             // output alone, wiring order
+  layout.remap(rgb, fused, out);
+  assertSums(out, fused, N);
+  Output<OrderRGB> none;                                 // plain remap == remap through a neutral output
+  layout.remap(rgb, plain);
+  static uint8_t neutral[N * 3];
+  layout.remap(rgb, neutral, none);
+  TEST_ASSERT_EQUAL_UINT8_ARRAY(plain, neutral, N * 3);
+  for (uint16_t k = 0; k < N; k++)                       // same bytes, only moved
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(direct + k * 3, fused + layout.pathIndex(k) * 3, 3);
+}
+
+void test_byte_order(void) {
+  const uint8_t rgb[3] = { 10, 20, 30 };
+  uint8_t s[3];
+  Output<OrderGRB> grb;  grb.write(rgb, s, 1);
+  TEST_ASSERT_EQUAL_UINT8(20, s[0]); TEST_ASSERT_EQUAL_UINT8(10, s[1]); TEST_ASSERT_EQUAL_UINT8(30, s[2]);
+  Output<OrderBRG> brg;  brg.write(rgb, s, 1);
+  TEST_ASSERT_EQUAL_UINT8(30, s[0]); TEST_ASSERT_EQUAL_UINT8(10, s[1]); TEST_ASSERT_EQUAL_UINT8(20, s[2]);
+  Output<OrderBGR> bgr;  bgr.write(rgb, s, 1);
+  TEST_ASSERT_EQUAL_UINT8(30, s[0]); TEST_ASSERT_EQUAL_UINT8(20, s[1]); TEST_ASSERT_EQUAL_UINT8(10, s[2]);
+}
+
+void test_limit_stacks_on_brightness(void) {
+  Output<OrderRGB> out;
+  uint8_t rgb[3] = { 200, 200, 200 }, s[3];
+  out.brightness(200);
+  out.limit(128);
+  out.write(rgb, s, 1);
+  TEST_ASSERT_EQUAL_UINT8(scale8(200, scale8(200, 128)), s[0]);
+  TEST_ASSERT_EQUAL_UINT8(200, out.brightness());        // the user's setting stays
+  out.limit(255);
+  out.write(rgb, s, 1);
+  TEST_ASSERT_EQUAL_UINT8(scale8(200, 200), s[0]);
+  out.limit(0);
+  out.write(rgb, s, 1);
+  TEST_ASSERT_EQUAL_UINT8(0, s[0]);
+}
+
+void test_gamma_and_white_point_only_dim(void) {
+  Output<OrderRGB> out;
+  static uint8_t rgb[256 * 3], strip[256 * 3];
+  for (uint16_t v = 0; v < 256; v++) rgb[v * 3] = rgb[v * 3 + 1] = rgb[v * 3 + 2] = (uint8_t)v;
+  out.gamma(2.2f);
+  out.temperature(2700);
+  out.write(rgb, strip, 256);
+  for (uint16_t v = 1; v < 256; v++)
+    for (uint8_t c = 0; c < 3; c++) {
+      TEST_ASSERT_TRUE(strip[v * 3 + c] <= v);
+      TEST_ASSERT_TRUE(strip[v * 3 + c] >= strip[(v - 1) * 3 + c]);   // still monotonic
+    }
+  TEST_ASSERT_EQUAL_UINT8(255, strip[255 * 3]);          // red untouched at 2700 K
+  TEST_ASSERT_TRUE(strip[255 * 3 + 2] < 120);            // blue ~35 %
+  TEST_ASSERT_EQUAL_UINT16(2700, out.temperature());
+  out.whitePoint({ 255, 255, 255 });
+  TEST_ASSERT_EQUAL_UINT16(0, out.temperature());
+}
+
+void test_logical_frame_keeps_precision(void) {
+  Output<OrderGRB> out;
+  static uint8_t rgb[N * 3], copy[N * 3], strip[N * 3], first[N * 3];
+  uint32_t rng = 777u;
+  randomFrame(rgb, N, rng);
+  memcpy(copy, rgb, sizeof(rgb));
+  out.write(rgb, first, N);
+  for (uint8_t cycle = 0; cycle < 3; cycle++) {          // 255 → 5 → 255 like the IR remote buttons
+    out.brightness(5);   out.write(rgb, strip, N);
+    out.brightness(255); out.write(rgb, strip, N);
+  }
+  TEST_ASSERT_EQUAL_UINT8_ARRAY(copy, rgb, N * 3);
+  TEST_ASSERT_EQUAL_UINT8_ARRAY(first, strip, N * 3);
+}
+
+int main(int, char**) {
+  UNITY_BEGIN();
+  RUN_TEST(test_gamma_one_is_scale8);
+  RUN_TEST(test_sum_matches_the_output);
+  RUN_TEST(test_remap_with_output);
+  RUN_TEST(test_byte_order);
+  RUN_TEST(test_limit_stacks_on_brightness);
+  RUN_TEST(test_gamma_and_white_point_only_dim);
+  RUN_TEST(test_logical_frame_keeps_precision);
+  return UNITY_END();
+}
@@ -0,0 +1,150 @@
+/*
+test_palette — MyPalette.h: gradient stops compiled to 256 colors, blend modes
+- The presets that stand in for built-in colors must give exactly those
+  colors: Rainbow = wheel(), Heat = the web lightshow's fire ramp, Basic and
+  Pastel = color wipe and palette pulse without a palette.
+- Stops land exactly, equal positions make a sharp step, ends are held.
+- blend8(): amount 0 changes nothing, the identities of each mode, and the
+  result always lies between a and the full effect.
+
+Run (from the project folder):
+  pio test -e native -f test_palette
+*/
+
+#include <unity.h>
+#include <MyPalette.h>
+
+using namespace MyShows;
+
+void setUp(void) {}
+void tearDown(void) {}
+
+static void assertRgb(uint8_t r, uint8_t g, uint8_t b, Rgb c, const char* msg) {
+  TEST_ASSERT_EQUAL_UINT8_MESSAGE(r, c.r, msg);
+  TEST_ASSERT_EQUAL_UINT8_MESSAGE(g, c.g, msg);
+  TEST_ASSERT_EQUAL_UINT8_MESSAGE(b, c.b, msg);
+}
+
+void test_rainbow_is_wheel(void) {
+  Palette p;
+  p.load(PAL_RAINBOW);
+  char msg[16];
+  for (uint16_t k = 0; k < 256; k++) {
+    Rgb w = wheel((uint8_t)k);
+    snprintf(msg, sizeof(msg), "k=%u", k);
+    assertRgb(w.r, w.g, w.b, p.at((uint8_t)k), msg);
+  }
+}
+
+void test_heat_is_fire_ramp(void) {
+  Palette p;
+  p.load(PAL_HEAT);
+  char msg[16];
+  for (uint16_t h = 0; h < 256; h++) {   // advanceFire() in ESP32_web_lightshow before palettes
+    uint8_t r, g, b;
+    if (h < 85)       { r = h * 3; g = 0; b = 0; }
+    else if (h < 170) { r = 255; g = (h - 85) * 3; b = 0; }
+    else              { r = 255; g = 255; b = (h - 170) * 3; }
+    snprintf(msg, sizeof(msg), "h=%u", h);
+    assertRgb(r, g, b, p.at((uint8_t)h), msg);
+  }
+}
+
+// the same show with the preset and without a palette, frame by frame
+static void assertSameAsBuiltIn(uint8_t show, uint8_t preset, uint16_t frames) {
+  static Engine<60, OrderGRB, OwnPixels<60> > plain, withPal;
+  static Palette pal;
+  pal.load(preset);
+  plain.palette = nullptr;
+  withPal.palette = pal.table();
+  Engine<60, OrderGRB, OwnPixels<60> >* both[] = { &plain, &withPal };
+  for (uint8_t i = 0; i < 2; i++) { both[i]->seed(7); both[i]->select(show); both[i]->brightness = 180; }
+  char msg[40];
+  for (uint16_t f = 0; f < frames; f++) {
+    plain.render(); withPal.render();
+    snprintf(msg, sizeof(msg), "show %u frame %u", show, f);
+    TEST_ASSERT_EQUAL_UINT8_ARRAY_MESSAGE(plain.pixels.data(), withPal.pixels.data(), 60 * 3, msg);
+  }
+}
+
+void test_presets_match_built_in_colors(void) {
+  assertSameAsBuiltIn(1, PAL_RAINBOW, 300);
+  assertSameAsBuiltIn(5, PAL_BASIC, 6 * 60 + 60);
+  assertSameAsBuiltIn(9, PAL_PASTEL, 5 * 180 + 10);
+}
+
+void test_compile_stops(void) {
+  const Stop stops[] = { { 10, 100, 0, 255 }, { 20, 200, 50, 0 }, { 20, 0, 0, 0 }, { 200, 90, 90, 90 } };
+  Palette p;
+  p.compile(stops, 4);
+  assertRgb(100, 0, 255, p.at(0), "held before the first stop");
+  assertRgb(100, 0, 255, p.at(10), "first stop");
+  assertRgb(150, 25, 127, p.at(15), "half way");    // 255 - ceil(255 * 5 / 10)
+  assertRgb(200, 50, 0, p.at(20), "sharp step: the earlier stop keeps its slot");
+  assertRgb(0, 0, 0, p.at(21), "the later one starts right after it");
+  assertRgb(90, 90, 90, p.at(200), "last stop");
+  assertRgb(90, 90, 90, p.at(255), "held after the last stop");
+
+  for (uint16_t k = 21; k < 200; k++) {              // rising ramp never goes back
+    TEST_ASSERT_TRUE(p.at((uint8_t)k).r <= p.at((uint8_t)(k + 1)).r);
+  }
+}
+
+void test_every_preset_has_a_name(void) {
+  for (uint8_t id = 0; id < PALETTE_COUNT; id++) TEST_ASSERT_TRUE(Palette::name(id)[0] != '?');
+  TEST_ASSERT_EQUAL_STRING("?", Palette::name(PALETTE_COUNT));
+}
+
+void test_blend_identities(void) {
+  for (uint16_t a = 0; a < 256; a++) {
+    TEST_ASSERT_EQUAL_UINT8(a, blend8((uint8_t)a, 255, BLEND_MULTIPLY, 255));   // x * white = x
+    TEST_ASSERT_EQUAL_UINT8(0, blend8((uint8_t)a, 0, BLEND_MULTIPLY, 255));
+    TEST_ASSERT_EQUAL_UINT8(a, blend8((uint8_t)a, 0, BLEND_SCREEN, 255));       // screen with black = x
+    TEST_ASSERT_EQUAL_UINT8(255, blend8((uint8_t)a, 255, BLEND_SCREEN, 255));
+    TEST_ASSERT_EQUAL_UINT8(a, blend8((uint8_t)a, 0, BLEND_ADD, 255));
+    TEST_ASSERT_EQUAL_UINT8(a + 100 > 255 ? 255 : a + 100, blend8((uint8_t)a, 100, BLEND_ADD, 255));
+    TEST_ASSERT_EQUAL_UINT8(77, blend8((uint8_t)a, 77, BLEND_LERP, 255));
+  }
+  TEST_ASSERT_EQUAL_UINT8(128, blend8(0, 255, BLEND_LERP, 128));
+}
+
+void test_blend_amount_stays_between(void) {
+  for (uint8_t mode = 0; mode < BLEND_COUNT; mode++)
+    for (uint16_t a = 0; a < 256; a += 5)
+      for (uint16_t b = 0; b < 256; b += 15) {
+        uint8_t full = blend8((uint8_t)a, (uint8_t)b, (Blend)mode, 255);
+        uint8_t lo = a < full ? a : full, hi = a < full ? full : a;
+        TEST_ASSERT_EQUAL_UINT8(a, blend8((uint8_t)a, (uint8_t)b, (Blend)mode, 0));
+        for (uint16_t amount = 0; amount < 256; amount += 17) {
+          uint8_t x = blend8((uint8_t)a, (uint8_t)b, (Blend)mode, (uint8_t)amount);
+          TEST_ASSERT_TRUE(x >= lo && x <= hi);
+        }
+      }
+}
+
+void test_tint_whole_table(void) {
+  Palette p, q;
+  p.load(PAL_OCEAN);
+  q.load(PAL_OCEAN);
+  q.tint({ 255, 120, 0 }, BLEND_SCREEN, 0);            // amount 0: table untouched
+  TEST_ASSERT_EQUAL_UINT8_ARRAY(p.table(), q.table(), sizeof(PaletteLut));
+  q.tint({ 255, 120, 0 }, BLEND_SCREEN, 128);
+  for (uint16_t k = 0; k < 256; k++) {
+    Rgb x = p.at((uint8_t)k);
+    Rgb y = blend(x, { 255, 120, 0 }, BLEND_SCREEN, 128);
+    assertRgb(y.r, y.g, y.b, q.at((uint8_t)k), "tint = blend() per entry");
+  }
+}
+
+int main(int, char**) {
+  UNITY_BEGIN();
+  RUN_TEST(test_rainbow_is_wheel);
+  RUN_TEST(test_heat_is_fire_ramp);
+  RUN_TEST(test_presets_match_built_in_colors);
+  RUN_TEST(test_compile_stops);
+  RUN_TEST(test_every_preset_has_a_name);
+  RUN_TEST(test_blend_identities);
+  RUN_TEST(test_blend_amount_stays_between);
+  RUN_TEST(test_tint_whole_table);
+  return UNITY_END();
+}
@@ -0,0 +1,196 @@
+/*
+test_power_policy — MyPower::Policy with a fake millisecond clock
+- Frames are real pixel buffers run through digest() (FNV-1a), the way
+  LEDTask feeds them; time only moves when the test says so.
+- ACTIVE → STATIC after staticFrames identical digests, STATIC → SLEEP after
+  sleepAfterMs without input; a changed pixel, activity() or a resend()
+  followed by a frame bring it back to ACTIVE.
+- frameInterval() and the per-state time accounting follow the states;
+  outputOff and keepAwake override them.
+
+Run (from the project folder):
+  pio test -e native -f test_power_policy
+*/
+
+#include <unity.h>
+#include <MyPower.h>
+#include <string.h>
+
+using namespace MyPower;
+
+void setUp(void) {}
+void tearDown(void) {}
+
+static const uint16_t N = 60;
+static const uint32_t STEP_MS = 20;
+
+struct Rig {
+  Policy   power;
+  uint8_t  pixels[N * 3];
+  uint32_t now = 1000;      // not 0: time stamps must not depend on starting at zero
+  uint32_t shown = 0;       // frames that would go to the strip
+
+  Rig() { memset(pixels, 0, sizeof(pixels)); power.begin(now); }
+
+  // one LEDTask step: wait frameInterval(), hash the frame, maybe show it
+  bool step() {
+    now += power.frameInterval(STEP_MS);
+    bool changed = power.frame(digest(pixels, sizeof(pixels)), now);
+    if (changed) shown++;
+    power.update(now);
+    return changed;
+  }
+};
+
+void test_digest_is_fnv1a(void) {
+  TEST_ASSERT_EQUAL_HEX32(2166136261UL, digest((const uint8_t*)"", 0));
+  TEST_ASSERT_EQUAL_HEX32(0xE40C292CUL, digest((const uint8_t*)"a", 1));
+  TEST_ASSERT_EQUAL_HEX32(0xBF9CF968UL, digest((const uint8_t*)"foobar", 6));
+  uint8_t a[N * 3] = {}, b[N * 3] = {};
+  b[N * 3 - 1] = 1;                     // the last byte counts too
+  TEST_ASSERT_NOT_EQUAL(digest(a, sizeof(a)), digest(b, sizeof(b)));
+}
+
+void test_static_after_identical_frames(void) {
+  Rig r;
+  TEST_ASSERT_TRUE(r.step());           // the first frame always goes out
+  for (uint8_t i = 1; i < r.power.staticFrames; i++) {
+    TEST_ASSERT_FALSE(r.step());
+    TEST_ASSERT_EQUAL_UINT8(ACTIVE, r.power.state());
+  }
+  TEST_ASSERT_FALSE(r.step());
+  TEST_ASSERT_EQUAL_UINT8(STATIC, r.power.state());
+  TEST_ASSERT_EQUAL_UINT32(1, r.shown);
+  TEST_ASSERT_EQUAL_UINT32(r.power.staticProbeMs, r.power.frameInterval(STEP_MS));
+  TEST_ASSERT_EQUAL_UINT32(400, r.power.frameInterval(400));   // a slow show keeps its own step
+}
+
+void test_sleep_after_no_input(void) {
+  Rig r;
+  for (uint8_t i = 0; i <= r.power.staticFrames; i++) r.step();
+  TEST_ASSERT_EQUAL_UINT8(STATIC, r.power.state());
+  uint32_t staticAt = r.now;
+  while (r.power.state() == STATIC) {
+    r.step();
+    TEST_ASSERT_TRUE(r.now - staticAt < r.power.sleepAfterMs + r.power.staticProbeMs + 1);
+  }
+  TEST_ASSERT_EQUAL_UINT8(SLEEP, r.power.state());
+  TEST_ASSERT_TRUE(r.now - staticAt >= r.power.sleepAfterMs);
+  TEST_ASSERT_EQUAL_UINT32(r.power.sleepProbeMs, r.power.frameInterval(STEP_MS));
+  for (uint8_t i = 0; i < 10; i++) TEST_ASSERT_FALSE(r.step());   // still nothing to send
+  TEST_ASSERT_EQUAL_UINT8(SLEEP, r.power.state());
+  TEST_ASSERT_EQUAL_UINT32(1, r.shown);
+}
+
+void test_changed_pixel_wakes(void) {
+  Rig r;
+  for (uint8_t i = 0; i <= r.power.staticFrames; i++) r.step();
+  r.now += r.power.sleepAfterMs;
+  r.power.update(r.now);
+  TEST_ASSERT_EQUAL_UINT8(SLEEP, r.power.state());
+  r.pixels[77] = 5;                     // the show started moving again
+  TEST_ASSERT_TRUE(r.step());
+  TEST_ASSERT_EQUAL_UINT8(ACTIVE, r.power.state());
+  TEST_ASSERT_EQUAL_UINT32(STEP_MS, r.power.frameInterval(STEP_MS));
+}
+
+void test_activity_wakes_and_restarts_the_countdown(void) {
+  Rig r;
+  for (uint8_t i = 0; i <= r.power.staticFrames; i++) r.step();
+  r.now += r.power.sleepAfterMs;
+  r.power.update(r.now);
+  TEST_ASSERT_EQUAL_UINT8(SLEEP, r.power.state());
+
+  r.power.activity(r.now);              // IR press, HTTP request...
+  TEST_ASSERT_EQUAL_UINT8(ACTIVE, r.power.state());
+  TEST_ASSERT_FALSE(r.step());          // same picture: nothing resent
+  for (uint8_t i = 0; i < r.power.staticFrames; i++) r.step();
+  TEST_ASSERT_EQUAL_UINT8(STATIC, r.power.state());
+
+  // input while STATIC pushes SLEEP back by a full sleepAfterMs
+  uint32_t t = r.now;
+  r.power.update(t + r.power.sleepAfterMs - 100);
+  r.power.activity(t + r.power.sleepAfterMs - 100);
+  TEST_ASSERT_EQUAL_UINT8(ACTIVE, r.power.state());
+}
+
+void test_activity_while_active_delays_static_counting(void) {
+  Rig r;
+  r.step();
+  for (uint8_t i = 0; i < 100; i++) {
+    r.power.activity(r.now);            // encoder turning: stay at full rate
+    r.step();
+    TEST_ASSERT_EQUAL_UINT8(ACTIVE, r.power.state());
+  }
+}
+
+void test_resend_forces_the_next_frame(void) {
+  Rig r;
+  for (uint8_t i = 0; i <= r.power.staticFrames; i++) r.step();
+  r.now += r.power.sleepAfterMs;
+  r.power.update(r.now);
+  TEST_ASSERT_EQUAL_UINT8(SLEEP, r.power.state());
+  r.power.resend();                     // someone cleared the strip outside the step
+  TEST_ASSERT_TRUE(r.step());           // same digest, sent anyway
+  TEST_ASSERT_EQUAL_UINT8(ACTIVE, r.power.state());
+  TEST_ASSERT_FALSE(r.step());
+  TEST_ASSERT_EQUAL_UINT32(2, r.shown);
+}
+
+void test_time_accounting(void) {
+  Rig r;
+  uint32_t start = r.now;
+  for (uint8_t i = 0; i <= r.power.staticFrames; i++) r.step();
+  uint32_t activeMs = r.now - start;
+  r.now += r.power.sleepAfterMs;
+  r.power.update(r.now);
+  r.now += 3000;
+  TEST_ASSERT_EQUAL_UINT32(activeMs, r.power.ms(ACTIVE, r.now));
+  TEST_ASSERT_EQUAL_UINT32(r.power.sleepAfterMs, r.power.ms(STATIC, r.now));
+  TEST_ASSERT_EQUAL_UINT32(3000, r.power.ms(SLEEP, r.now));
+  TEST_ASSERT_EQUAL_UINT32(r.now - start,
+                           r.power.ms(ACTIVE, r.now) + r.power.ms(STATIC, r.now) + r.power.ms(SLEEP, r.now));
+}
+
+void test_output_off_and_keep_awake(void) {
+  Rig r;
+  r.step();
+  r.power.outputOff = true;             // show switched off: no need to count frames
+  r.power.update(r.now);
+  TEST_ASSERT_EQUAL_UINT8(STATIC, r.power.state());
+
+  r.power.keepAwake = true;             // audio DMA running: never SLEEP
+  r.now += 10 * r.power.sleepAfterMs;
+  TEST_ASSERT_EQUAL_UINT8(STATIC, r.power.update(r.now));
+  r.power.keepAwake = false;
+  TEST_ASSERT_EQUAL_UINT8(SLEEP, r.power.update(r.now));
+  r.power.keepAwake = true;
+  TEST_ASSERT_EQUAL_UINT8(STATIC, r.power.update(r.now));
+}
+
+void test_clock_wrap(void) {
+  Rig r;
+  r.now = 0xFFFFFF00UL;                 // millis() wraps after 49.7 days
+  r.power.begin(r.now);
+  for (uint8_t i = 0; i <= r.power.staticFrames; i++) r.step();
+  TEST_ASSERT_EQUAL_UINT8(STATIC, r.power.state());
+  r.now += r.power.sleepAfterMs - 1;
+  TEST_ASSERT_EQUAL_UINT8(STATIC, r.power.update(r.now));
+  r.now += 1;
+  TEST_ASSERT_EQUAL_UINT8(SLEEP, r.power.update(r.now));
+}
+
+int main(int, char**) {
+  UNITY_BEGIN();
+  RUN_TEST(test_digest_is_fnv1a);
+  RUN_TEST(test_static_after_identical_frames);
+  RUN_TEST(test_sleep_after_no_input);
+  RUN_TEST(test_changed_pixel_wakes);
+  RUN_TEST(test_activity_wakes_and_restarts_the_countdown);
+  RUN_TEST(test_activity_while_active_delays_static_counting);
+  RUN_TEST(test_resend_forces_the_next_frame);
+  RUN_TEST(test_time_accounting);
+  RUN_TEST(test_output_off_and_keep_awake);
+  RUN_TEST(test_clock_wrap);
+  return UNITY_END();
+}
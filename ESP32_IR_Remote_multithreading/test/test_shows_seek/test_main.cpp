@@ -0,0 +1,97 @@
+/*
+test_shows_seek — MyShows::Engine::seek(k) against k× render()
+- After seek(k) the next frames must be byte-identical to a strip that was
+  stepped k times from seed() + select(); MySync relies on it when a
+  controller joins a running show.
+- palIdx (palette pulse), scanPos (scanner) and theater (theater chase) are
+  checked right around their turning points; rainbow, breathing, color wipe
+  and twinkle over the same range of k.
+- Comet and rain keep afterglow from older frames, so for them it is seek()
+  plus ~100 render() of catch-up that has to match.
+
+Run (from the project folder):
+  pio test -e native -f test_shows_seek
+*/
+
+#include <unity.h>
+#include <MyShows.h>
+
+using namespace MyShows;
+
+void setUp(void) {}
+void tearDown(void) {}
+
+static const uint32_t SEED = 0xDEADBEEF;
+static const uint8_t  FOLLOW = 8;   // frames compared after the seek (direction, next tick...)
+
+// a: k× render(), b: seek(k - catchUp) + catchUp× render(); then FOLLOW frames side by side
+template<uint16_t N>
+static void checkSeek(uint8_t show, uint32_t k, uint32_t catchUp = 0) {
+  static Engine<N, OrderRGB, OwnPixels<N> > a, b;
+  a.seed(SEED); a.select(show); a.clear();
+  for (uint32_t i = 0; i < k; i++) a.render();
+
+  uint32_t from = k > catchUp ? k - catchUp : 0;
+  b.seed(SEED); b.select(show); b.clear();
+  b.seek(from);
+  for (uint32_t i = from; i < k; i++) b.render();
+
+  char msg[64];
+  for (uint8_t f = 0; f < FOLLOW; f++) {
+    a.render(); b.render();
+    snprintf(msg, sizeof(msg), "N=%u show %u k=%lu frame +%u", N, show, (unsigned long)k, f);
+    TEST_ASSERT_EQUAL_UINT16_MESSAGE(a.animStep(), b.animStep(), msg);
+    TEST_ASSERT_EQUAL_UINT8_ARRAY_MESSAGE(a.pixels.data(), b.pixels.data(), N * 3, msg);
+  }
+}
+
+template<uint16_t N>
+static void scannerAround() {
+  const uint32_t bounce = 2 * (N - 1);   // there and back
+  const uint32_t ks[] = { 0, 1, N - 2, N - 1, N, bounce - 1, bounce, bounce + 1, 5 * bounce + N / 2, 70001 };
+  for (uint8_t i = 0; i < sizeof(ks) / sizeof(ks[0]); i++) checkSeek<N>(7, ks[i]);
+}
+
+void test_theater_phase(void) {
+  for (uint32_t k = 0; k < 12; k++) checkSeek<60>(2, k);
+  checkSeek<60>(2, 65535);               // step wraps, theater must not
+  checkSeek<60>(2, 65536);
+  checkSeek<61>(2, 1000);                // N not divisible by 3
+  checkSeek<61>(2, 1001);
+}
+
+void test_scanner_position(void) {
+  scannerAround<60>();
+  scannerAround<7>();
+  scannerAround<2>();
+}
+
+void test_palette_index(void) {
+  const uint32_t ks[] = { 0, 1, 2, 179, 180, 181, 359, 360, 361, 5 * 180, 5 * 180 + 1, 65535, 65536, 100000 };
+  for (uint8_t i = 0; i < sizeof(ks) / sizeof(ks[0]); i++) checkSeek<60>(9, ks[i]);
+}
+
+void test_other_exact_shows(void) {
+  const uint8_t shows[] = { 1, 3, 5, 6 };
+  const uint32_t ks[] = { 0, 1, 59, 60, 61, 255, 256, 359, 360, 361, 4321, 65536, 70000 };
+  for (uint8_t s = 0; s < sizeof(shows); s++)
+    for (uint8_t i = 0; i < sizeof(ks) / sizeof(ks[0]); i++) checkSeek<60>(shows[s], ks[i]);
+}
+
+void test_comet_and_rain_catch_up(void) {
+  const uint32_t ks[] = { 0, 5, 130, 1000, 4321, 70000 };
+  for (uint8_t i = 0; i < sizeof(ks) / sizeof(ks[0]); i++) {
+    checkSeek<60>(4, ks[i], 128);
+    checkSeek<60>(8, ks[i], 128);
+  }
+}
+
+int main(int, char**) {
+  UNITY_BEGIN();
+  RUN_TEST(test_theater_phase);
+  RUN_TEST(test_scanner_position);
+  RUN_TEST(test_palette_index);
+  RUN_TEST(test_other_exact_shows);
+  RUN_TEST(test_comet_and_rain_catch_up);
+  return UNITY_END();
+}
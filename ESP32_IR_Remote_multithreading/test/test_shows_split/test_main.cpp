@@ -0,0 +1,101 @@
+/*
+test_shows_split — MyShows::Engine split over two threads against render()
+- beginFrame(), then renderRange(0, s) here and renderRange(s, N) on a
+  std::thread at the same time, join, endFrame() – the same steps LEDTask
+  and the core-0 helper do. Every frame must be byte-identical to a second
+  engine that calls render().
+- All 9 shows, several split points (empty halves, odd ones, RENDER_SPLIT),
+  with a palette and with audio that changes every frame.
+
+Run (from the project folder):
+  pio test -e native -f test_shows_split
+*/
+
+#include <unity.h>
+#include <MyShows.h>
+#include <thread>
+
+using namespace MyShows;
+
+void setUp(void) {}
+void tearDown(void) {}
+
+static const uint16_t N = 60;
+static const uint16_t FRAMES = 300;   // > 256 so rainbow wraps and the wipe finishes its first round
+
+typedef Engine<N, OrderGRB, OwnPixels<N> > Shows;
+
+static PaletteLut lut;
+
+static void fillPalette() {
+  for (uint16_t i = 0; i < 256; i++) {
+    lut[i][0] = (uint8_t)i;
+    lut[i][1] = (uint8_t)(255 - i);
+    lut[i][2] = (uint8_t)(i * 7);
+  }
+}
+
+// levels that change every frame, with a beat now and then
+static AudioLevels audioFor(uint16_t f) {
+  uint32_t x = (f + 1) * 2654435761UL;
+  AudioLevels a = { (uint8_t)(x >> 24), (uint8_t)(x >> 16), (uint8_t)(x >> 8), (uint8_t)x, (f % 7) == 0 };
+  return a;
+}
+
+static void splitFrame(Shows& e, uint16_t s) {
+  e.beginFrame();
+  std::thread other([&e, s] { e.renderRange(s, N); });
+  e.renderRange(0, s);
+  other.join();
+  e.endFrame();
+}
+
+static void compare(uint8_t show, uint16_t s, bool withPalette, bool withAudio) {
+  static Shows one, two;
+  AudioLevels level;
+  Shows* both[] = { &one, &two };
+  for (uint8_t i = 0; i < 2; i++) {
+    both[i]->seed(42);
+    both[i]->select(show);
+    both[i]->clear();
+    both[i]->brightness = 200;
+    both[i]->palette = withPalette ? &lut : nullptr;
+    both[i]->audio = withAudio ? &level : nullptr;
+  }
+
+  char msg[80];
+  for (uint16_t f = 0; f < FRAMES; f++) {
+    level = audioFor(f);
+    one.render();
+    splitFrame(two, s);
+    snprintf(msg, sizeof(msg), "show %u split %u palette %d audio %d frame %u", show, s, withPalette, withAudio, f);
+    TEST_ASSERT_EQUAL_UINT8_ARRAY_MESSAGE(one.pixels.data(), two.pixels.data(), N * 3, msg);
+  }
+}
+
+static const uint16_t SPLITS[] = { 0, 1, 29, N / 2, 31, N - 1, N };
+
+static void allSplits(bool withPalette, bool withAudio) {
+  for (uint8_t show = 1; show <= Shows::SHOW_COUNT; show++)
+    for (uint8_t i = 0; i < sizeof(SPLITS) / sizeof(SPLITS[0]); i++) compare(show, SPLITS[i], withPalette, withAudio);
+}
+
+void test_split_plain(void)         { allSplits(false, false); }
+void test_split_with_palette(void)  { allSplits(true, false); }
+void test_split_with_audio(void)    { allSplits(false, true); }
+
+void test_split_kinds(void) {
+  // comet and rain draw in endFrame(); everything else is per pixel
+  for (uint8_t show = 1; show <= Shows::SHOW_COUNT; show++)
+    TEST_ASSERT_EQUAL_UINT8(show == 4 || show == 8 ? SPLIT_TAIL : SPLIT_PIXELS, Shows::split(show));
+}
+
+int main(int, char**) {
+  fillPalette();
+  UNITY_BEGIN();
+  RUN_TEST(test_split_plain);
+  RUN_TEST(test_split_with_palette);
+  RUN_TEST(test_split_with_audio);
+  RUN_TEST(test_split_kinds);
+  return UNITY_END();
+}
@@ -0,0 +1,216 @@
+/*
+test_sonar — MySonar.h: round-robin HC-SR04 ranging from ECHO edges
+- SimIO is four simulated sensors: trigger() schedules the echo (450 µs
+  later, high for the time of flight at the simulated air temperature),
+  step() advances 4 µs like AVR micros() and calls onEdge() on every change.
+- Distances within a few mm, ≥ 15 measurements per sensor per second, no
+  trigger while the previous ping can still be heard, no echo past maxMm.
+- Temperature compensation, outliers and dropouts, a moving object, a loop
+  that polls late and an ECHO pin stuck high.
+
+Run (from the project folder):
+  pio test -e native -f test_sonar
+*/
+
+#include <unity.h>
+#include <MySonar.h>
+#include <stdlib.h>
+
+using namespace MySonar;
+
+void setUp(void) {}
+void tearDown(void) {}
+
+static uint32_t rng = 2463534242u;
+static double chance() { rng ^= rng << 13; rng ^= rng >> 17; rng ^= rng << 5; return rng / 4294967296.0; }
+
+struct SimIO {
+  static const uint8_t N = 4;
+  double   distMm[N] = { 300, 1200, 2000, 3500 };
+  double   tempC = 20;
+  double   outlierP = 0, missP = 0;   // chance of a wrong echo / no echo
+  uint32_t now = 0;
+  uint32_t riseAt[N] = {}, fallAt[N] = {};
+  bool     level[N] = {};
+  uint32_t triggers[N] = {};
+  int16_t  lastTrig = -1;
+  uint32_t lastTrigAt = 0, overlaps = 0;
+
+  void begin() {}
+  void trigger(uint8_t i) {
+    triggers[i]++;
+    if (lastTrig >= 0 && now - lastTrigAt < 14600) overlaps++;   // 2.5 m there and back
+    lastTrig = i; lastTrigAt = now;
+    double c = 331.3 + 0.606 * tempC;                             // m/s
+    double d = distMm[i];
+    if (chance() < outlierP) d = 100 + chance() * 3000;
+    double tof = 2 * d / 1000.0 / c * 1e6;
+    if (tof > 38000 || chance() < missP) tof = 38000;             // HC-SR04 timeout
+    riseAt[i] = now + 450;
+    fallAt[i] = now + 450 + (uint32_t)tof;
+  }
+  bool echo(uint8_t i) const { return level[i]; }
+};
+
+typedef Ranger<SimIO, 4> Sonar;
+
+static void step(SimIO& io, Sonar& r) {
+  io.now += 4;
+  for (uint8_t i = 0; i < SimIO::N; i++) {
+    bool l = io.riseAt[i] && io.now >= io.riseAt[i] && io.now < io.fallAt[i];
+    if (l != io.level[i]) { io.level[i] = l; r.onEdge(io.now); }
+  }
+}
+
+// run until `until` µs, poll() every `every` µs
+static void run(SimIO& io, Sonar& r, uint32_t until, uint32_t every = 200) {
+  while (io.now < until) {
+    step(io, r);
+    if (io.now % every == 0) r.poll(io.now);
+  }
+}
+
+void test_speed_of_sound(void) {
+  TEST_ASSERT_EQUAL_UINT32(11253, mmPerUsQ16(200));   // 343.42 m/s × 65536 / 2e6
+  TEST_ASSERT_EQUAL_UINT32(10856, mmPerUsQ16(0));
+  TEST_ASSERT_EQUAL_UINT32(10657, mmPerUsQ16(-100));
+}
+
+void test_round_robin_distances(void) {
+  SimIO io;
+  Sonar r(io);
+  r.begin(0);
+  run(io, r, 5000000);
+  for (uint8_t i = 0; i < 4; i++) TEST_ASSERT_TRUE(r.count(i) >= 5 * 15);
+  TEST_ASSERT_TRUE(r.valid(0));
+  TEST_ASSERT_UINT16_WITHIN(2, 300, r.distanceMm(0));
+  TEST_ASSERT_UINT16_WITHIN(2, 1200, r.distanceMm(1));
+  TEST_ASSERT_UINT16_WITHIN(3, 2000, r.distanceMm(2));
+  TEST_ASSERT_FALSE(r.valid(3));                          // 3.5 m is past maxMm
+  TEST_ASSERT_EQUAL_UINT16(0, r.rawMm(3));
+  TEST_ASSERT_EQUAL_UINT32(0, io.overlaps);               // no crosstalk between slots
+}
+
+void test_poll_reports_each_slot_once(void) {
+  SimIO io;
+  Sonar r(io);
+  r.begin(0);
+  uint32_t polls = 0;
+  uint8_t expect = 0;
+  while (io.now < 1000000) {
+    step(io, r);
+    if (r.poll(io.now)) {
+      polls++;
+      if (polls > 1) {                                    // the first poll only fires sensor 0
+        TEST_ASSERT_EQUAL_UINT8(expect, r.lastSensor());
+        expect = (expect + 1) % 4;
+      }
+    }
+  }
+  TEST_ASSERT_UINT32_WITHIN(1, 1000000 / r.slotUs, polls);
+}
+
+void test_temperature_compensation(void) {
+  for (uint8_t comp = 0; comp < 2; comp++) {
+    SimIO io;
+    io.tempC = 0;
+    Sonar r(io);
+    if (comp) r.setTemperature(0);
+    r.begin(0);
+    run(io, r, 2000000, 100);
+    if (comp) TEST_ASSERT_UINT16_WITHIN(3, 2000, r.distanceMm(2));
+    else      TEST_ASSERT_TRUE(r.distanceMm(2) > 2050);   // 20 °C assumed, air at 0 °C: ~3.7 % long
+  }
+}
+
+void test_outliers_and_dropouts(void) {
+  SimIO io;
+  io.outlierP = 0.15;
+  io.missP = 0.1;
+  Sonar r(io);
+  r.begin(0);
+  uint32_t bad = 0, n = 0;
+  while (io.now < 20000000) {
+    step(io, r);
+    if (io.now % 100 == 0 && r.poll(io.now) && r.lastSensor() == 1 && r.count(1) > 10) {
+      n++;
+      if (!r.valid(1) || abs((int)r.distanceMm(1) - 1200) > 3) bad++;
+    }
+  }
+  TEST_ASSERT_TRUE(n > 250);                              // 20 s / 64 ms
+  TEST_ASSERT_TRUE(bad * 100 < n * 2);
+}
+
+void test_follows_a_moving_object(void) {
+  SimIO io;
+  Sonar r(io);
+  r.begin(0);
+  run(io, r, 1000000, 100);
+  io.distMm[1] = 600;
+  uint32_t c0 = r.count(1);
+  while (io.now < 2000000 && abs((int)r.distanceMm(1) - 600) > 2) {
+    step(io, r);
+    if (io.now % 100 == 0) r.poll(io.now);
+  }
+  TEST_ASSERT_UINT16_WITHIN(2, 600, r.distanceMm(1));
+  TEST_ASSERT_TRUE(r.count(1) - c0 <= 4);                 // OUTLIER_RUN samples + the one that started it
+}
+
+void test_late_polls_stay_accurate(void) {
+  SimIO io;
+  Sonar r(io);
+  r.begin(0);
+  uint32_t busyUntil = 0;
+  while (io.now < 5000000) {                              // loop() blocked 40 ms of every 100 ms
+    step(io, r);
+    if (io.now % 100000 == 0) busyUntil = io.now + 40000;
+    if (io.now > busyUntil && io.now % 100 == 0) r.poll(io.now);
+  }
+  TEST_ASSERT_UINT16_WITHIN(2, 300, r.distanceMm(0));
+  TEST_ASSERT_UINT16_WITHIN(3, 2000, r.distanceMm(2));
+  TEST_ASSERT_EQUAL_UINT32(0, io.overlaps);
+}
+
+void test_stuck_echo(void) {
+  SimIO io;
+  Sonar r(io);
+  r.begin(0);
+  io.level[2] = true;                                     // sensor 2 unplugged, ECHO floats high
+  io.riseAt[2] = 1;
+  io.fallAt[2] = 0xFFFFFFF0u;
+  run(io, r, 2000000, 100);
+  TEST_ASSERT_FALSE(r.valid(2));
+  TEST_ASSERT_TRUE(r.valid(0));
+  TEST_ASSERT_TRUE(r.valid(1));
+  TEST_ASSERT_UINT16_WITHIN(2, 300, r.distanceMm(0));
+}
+
+void test_median_filter(void) {
+  MedianFilter f;
+  const uint16_t seq[] = { 100, 102, 5000, 101, 99, 103 };
+  TEST_ASSERT_TRUE(f.push(seq[0]));
+  TEST_ASSERT_TRUE(f.push(seq[1]));
+  TEST_ASSERT_FALSE(f.push(seq[2]));                      // outlier dropped
+  for (uint8_t i = 3; i < 6; i++) TEST_ASSERT_TRUE(f.push(seq[i]));
+  TEST_ASSERT_EQUAL_UINT16(101, f.value());
+
+  for (uint8_t i = 0; i < MISS_LIMIT - 1; i++) f.miss();
+  TEST_ASSERT_TRUE(f.valid());
+  f.miss();
+  TEST_ASSERT_FALSE(f.valid());
+  TEST_ASSERT_EQUAL_UINT16(0, f.value());
+}
+
+int main(int, char**) {
+  UNITY_BEGIN();
+  RUN_TEST(test_speed_of_sound);
+  RUN_TEST(test_round_robin_distances);
+  RUN_TEST(test_poll_reports_each_slot_once);
+  RUN_TEST(test_temperature_compensation);
+  RUN_TEST(test_outliers_and_dropouts);
+  RUN_TEST(test_follows_a_moving_object);
+  RUN_TEST(test_late_polls_stay_accurate);
+  RUN_TEST(test_stuck_echo);
+  RUN_TEST(test_median_filter);
+  return UNITY_END();
+}
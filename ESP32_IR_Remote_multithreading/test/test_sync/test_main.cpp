@@ -0,0 +1,183 @@
+/*
+test_sync — MySync.h: the follower's Clock and the shared step arithmetic
+- A simulated master sends a beacon every 100 ms of its own time; its
+  crystal runs off by a fixed offset and up to ±500 ppm, every beacon is
+  delayed by 0.3–3 ms and now and then a whole window arrives 20 ms late.
+- Clock::now() converges on the master's time and keeps it between and
+  after the beacons; driftPpb() finds the crystal difference.
+- A master restart (its time starts from 0 again) is counted once it is
+  more than resetUs off the line, a smaller jump is not.
+- stepAt() / stepStart() and rebase(): a speed change keeps the step the
+  show is on at the moment of the rebase.
+
+Run (from the project folder):
+  pio test -e native -f test_sync
+*/
+
+#include <unity.h>
+#include <MySync.h>
+#include <math.h>
+
+using namespace MySync;
+
+void setUp(void) {}
+void tearDown(void) {}
+
+static uint32_t rng = 2463534242u;
+static uint32_t next() { rng ^= rng << 13; rng ^= rng >> 17; rng ^= rng << 5; return rng; }
+
+struct Master {
+  double   offsetUs;        // master time at local 0
+  double   ppm;             // + = master runs faster
+  double   lateP = 0;       // chance that a whole window is late
+  uint32_t lateUs = 20000;
+  uint8_t  window = 10;     // matches Clock::window, to delay whole windows
+  uint32_t sent = 0;
+  bool     late = false;
+
+  uint64_t at(uint64_t localUs) const { return (uint64_t)llround(offsetUs + localUs * (1 + ppm * 1e-6)); }
+
+  // beacons from localUs until untilUs, 100 ms of master time apart
+  void run(Clock& c, uint64_t& localUs, uint64_t untilUs) {
+    const double period = 100000 / (1 + ppm * 1e-6);    // 100 ms master = this many local µs
+    for (; localUs < untilUs; localUs = (uint64_t)llround(localUs + period)) {
+      if (sent++ % window == 0) late = (next() % 1000) < lateP * 1000;
+      uint32_t delay = 300 + next() % 2700;
+      if (late) delay += lateUs;
+      c.sample(at(localUs), localUs + delay);
+    }
+  }
+};
+
+// The best beacon of a window is still ~0.25 ms late on average, so the line
+// is that far off and its slope a few ppm; 200 random runs stay under half of this
+static const int32_t TOL_US = 1000;
+static const int32_t TOL_PPB = 20000;
+
+static int64_t errorUs(const Clock& c, const Master& m, uint64_t localUs) {
+  return (int64_t)(c.now(localUs) - m.at(localUs));
+}
+
+void test_fixed_offset(void) {
+  Clock c;
+  c.delayUs = 300;                                       // the radio's minimum, measured
+  Master m = { 5e6, 0 };
+  uint64_t t = 1000000;
+  TEST_ASSERT_EQUAL_UINT64(t, c.now(t));                 // no beacon yet: local time
+  m.run(c, t, 2000000);
+  TEST_ASSERT_FALSE(c.synced());                         // one window is one point
+  m.run(c, t, 30000000);
+  TEST_ASSERT_TRUE(c.synced());
+  for (uint32_t d = 0; d < 100000; d += 7919)
+    TEST_ASSERT_INT64_WITHIN(TOL_US, 0, errorUs(c, m, t + d));
+  TEST_ASSERT_INT32_WITHIN(TOL_PPB, 0, c.driftPpb());
+  TEST_ASSERT_EQUAL_UINT32(0, c.restartCount());
+}
+
+void test_drift_up_to_500_ppm(void) {
+  const double ppm[] = { -500, -120, -30, 0, 30, 120, 500 };
+  for (uint8_t i = 0; i < 7; i++) {
+    Clock c;
+    c.delayUs = 300;
+    Master m = { -2.5e6 + i * 1e6, ppm[i] };
+    uint64_t t = 0;
+    m.run(c, t, 60000000);                               // a minute of beacons
+    TEST_ASSERT_INT32_WITHIN(TOL_PPB, (int32_t)(ppm[i] * 1000), c.driftPpb());
+    TEST_ASSERT_INT64_WITHIN(TOL_US, 0, errorUs(c, m, t));
+    TEST_ASSERT_INT64_WITHIN(TOL_US, 0, errorUs(c, m, t + 3000000));   // 3 s without beacons
+    TEST_ASSERT_EQUAL_UINT32(0, c.restartCount());
+  }
+}
+
+void test_delayed_windows(void) {
+  Clock c;
+  c.delayUs = 300;
+  Master m = { 1e6, 80 };
+  m.lateP = 0.2;                                         // every fifth window 20 ms late
+  uint64_t t = 0;
+  int64_t worst = 0;
+  m.run(c, t, 20000000);
+  for (uint8_t s = 0; s < 60; s++) {                     // check after every second
+    m.run(c, t, t + 1000000);
+    int64_t e = errorUs(c, m, t);
+    if (e < 0) e = -e;
+    if (e > worst) worst = e;
+  }
+  TEST_ASSERT_TRUE(worst < TOL_US);                      // a late window would be 20000
+  TEST_ASSERT_INT32_WITHIN(TOL_PPB, 80000, c.driftPpb());
+  TEST_ASSERT_EQUAL_UINT32(0, c.restartCount());         // 20 ms < resetUs
+}
+
+void test_master_restart(void) {
+  Clock c;
+  c.delayUs = 300;
+  Master m = { 7e6, -40 };
+  uint64_t t = 0;
+  m.run(c, t, 30000000);
+  TEST_ASSERT_INT64_WITHIN(TOL_US, 0, errorUs(c, m, t));
+
+  m.offsetUs = 7e6 + 30000;                              // 30 ms jump: noise, not a restart
+  m.run(c, t, t + 3000000);
+  TEST_ASSERT_EQUAL_UINT32(0, c.restartCount());
+
+  m.offsetUs = -(double)t;                               // master rebooted: its time is 0 now
+  m.run(c, t, t + 1000000);                              // one window
+  TEST_ASSERT_EQUAL_UINT32(1, c.restartCount());
+  TEST_ASSERT_FALSE(c.synced());
+  m.run(c, t, t + 30000000);
+  TEST_ASSERT_TRUE(c.synced());
+  TEST_ASSERT_EQUAL_UINT32(1, c.restartCount());
+  TEST_ASSERT_INT64_WITHIN(TOL_US, 0, errorUs(c, m, t));
+}
+
+void test_step_arithmetic(void) {
+  State s = {};
+  s.epochUs = 5000000;
+  s.stepMs = 20;
+  TEST_ASSERT_EQUAL_UINT32(0, stepAt(s, 0));             // before the show started
+  TEST_ASSERT_EQUAL_UINT32(0, stepAt(s, 5019999));
+  TEST_ASSERT_EQUAL_UINT32(1, stepAt(s, 5020000));
+  TEST_ASSERT_EQUAL_UINT64(5000000 + 7 * 20000, stepStart(s, 7));
+  for (uint32_t k = 0; k < 100000; k += 977) {
+    TEST_ASSERT_EQUAL_UINT32(k, stepAt(s, stepStart(s, k)));
+    TEST_ASSERT_EQUAL_UINT32(k, stepAt(s, stepStart(s, k + 1) - 1));
+  }
+  s.stepMs = 0;
+  TEST_ASSERT_EQUAL_UINT32(0, stepAt(s, 99000000));
+}
+
+void test_rebase_keeps_the_step(void) {
+  for (uint16_t i = 0; i < 5000; i++) {
+    State s = {};
+    s.stepMs = (uint16_t)(5 + next() % 496);
+    s.epochUs = next() % 100000000;
+    uint64_t shared = s.epochUs + (uint64_t)next() % 3600000000ULL;
+    uint16_t stepMs = (uint16_t)(5 + next() % 496);
+    uint32_t k = stepAt(s, shared);
+    rebase(s, stepMs, shared);
+    TEST_ASSERT_EQUAL_UINT16(stepMs, s.stepMs);
+    if ((uint64_t)k * stepMs * 1000 > shared) {
+      // step k cannot be reached with an epoch ≥ 0: the highest one that can
+      TEST_ASSERT_EQUAL_UINT32(shared / (stepMs * 1000ULL), stepAt(s, shared));
+      continue;
+    }
+    TEST_ASSERT_EQUAL_UINT32(k, stepAt(s, shared));
+    TEST_ASSERT_EQUAL_UINT64(shared, stepStart(s, k));   // the step starts again now
+    TEST_ASSERT_EQUAL_UINT32(k + 1, stepAt(s, shared + stepMs * 1000ULL));
+  }
+  State s = {};                                          // stepMs 0 would divide by zero
+  s.stepMs = 10;
+  rebase(s, 0, 1000000);
+  TEST_ASSERT_EQUAL_UINT16(1, s.stepMs);
+}
+
+int main(int, char**) {
+  UNITY_BEGIN();
+  RUN_TEST(test_fixed_offset);
+  RUN_TEST(test_drift_up_to_500_ppm);
+  RUN_TEST(test_delayed_windows);
+  RUN_TEST(test_master_restart);
+  RUN_TEST(test_step_arithmetic);
+  RUN_TEST(test_rebase_keeps_the_step);
+  return UNITY_END();
+}
@@ -0,0 +1,104 @@
+/*
+audio_wav.cpp — runs include/AudioDSP.h on a WAV file on the PC
+- Same analysis as AudioTask on the ESP32, so a recording of the room can be
+  checked (beats, BPM, band levels) and timed without flashing anything.
+- Reads 16-bit PCM (mono or stereo, any rate; resampled to 16 kHz linearly).
+
+Build and run (from this folder):
+  g++ -O2 -std=c++11 -I../include audio_wav.cpp -o audio_wav
+  ./audio_wav music.wav          summary: beats, onsets, BPM, us per analysis
+  ./audio_wav music.wav --csv    one line per analysis (diff two runs for regressions)
+*/
+
+#include "AudioDSP.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <vector>
+
+static uint32_t le32(const uint8_t* p) { return p[0] | (p[1] << 8) | (p[2] << 16) | ((uint32_t)p[3] << 24); }
+static uint16_t le16(const uint8_t* p) { return p[0] | (p[1] << 8); }
+
+// Mono samples at Audio::SAMPLE_RATE, or false with a message
+static bool loadWav(const char* path, std::vector<int16_t>& out) {
+  FILE* f = fopen(path, "rb");
+  if (!f) { fprintf(stderr, "%s: cannot open\n", path); return false; }
+  std::vector<uint8_t> d;
+  uint8_t buf[4096];
+  size_t n;
+  while ((n = fread(buf, 1, sizeof(buf), f)) > 0) d.insert(d.end(), buf, buf + n);
+  fclose(f);
+  if (d.size() < 12 || memcmp(&d[0], "RIFF", 4) || memcmp(&d[8], "WAVE", 4)) { fprintf(stderr, "%s: not a WAV file\n", path); return false; }
+
+  uint16_t channels = 0, bits = 0;
+  uint32_t rate = 0;
+  const uint8_t* pcm = NULL;
+  uint32_t pcmLen = 0;
+  for (size_t p = 12; p + 8 <= d.size();) {
+    uint32_t len = le32(&d[p + 4]);
+    if (len > d.size() - p - 8) len = (uint32_t)(d.size() - p - 8);
+    if (!memcmp(&d[p], "fmt ", 4) && len >= 16) {
+      if (le16(&d[p + 8]) != 1) { fprintf(stderr, "%s: only PCM is supported\n", path); return false; }
+      channels = le16(&d[p + 10]); rate = le32(&d[p + 12]); bits = le16(&d[p + 22]);
+    } else if (!memcmp(&d[p], "data", 4)) {
+      pcm = &d[p + 8]; pcmLen = len;
+    }
+    p += 8 + len + (len & 1);
+  }
+  if (!pcm || bits != 16 || channels == 0 || rate == 0) { fprintf(stderr, "%s: need 16-bit PCM\n", path); return false; }
+
+  uint32_t frames = pcmLen / (2 * channels);
+  std::vector<int32_t> mono(frames);
+  for (uint32_t i = 0; i < frames; i++) {
+    int32_t sum = 0;
+    for (uint16_t c = 0; c < channels; c++) sum += (int16_t)le16(pcm + (i * channels + c) * 2);
+    mono[i] = sum / channels;
+  }
+  uint64_t outLen = (uint64_t)frames * Audio::SAMPLE_RATE / rate;
+  out.resize(outLen);
+  for (uint64_t i = 0; i < outLen; i++) {
+    uint64_t pos = i * rate * 256 / Audio::SAMPLE_RATE;     // source position in 1/256 samples
+    uint32_t k = (uint32_t)(pos >> 8), frac = (uint32_t)(pos & 0xFF);
+    int32_t a = mono[k], b = (k + 1 < frames) ? mono[k + 1] : a;
+    out[i] = (int16_t)(a + (b - a) * (int32_t)frac / 256);
+  }
+  return true;
+}
+
+int main(int argc, char** argv) {
+  if (argc < 2) { fprintf(stderr, "usage: %s file.wav [--csv]\n", argv[0]); return 2; }
+  bool csv = argc > 2 && !strcmp(argv[2], "--csv");
+  std::vector<int16_t> samples;
+  if (!loadWav(argv[1], samples)) return 1;
+
+  static Audio::Analyzer dsp;
+  Audio::Snapshot last = dsp.result();
+  if (csv) {
+    printf("t_ms,level,bass,mid,treble,beat,onset,bpm,peak_q8");
+    for (uint8_t b = 0; b < Audio::BANDS; b++) printf(",b%u", b);
+    printf("\n");
+  }
+  uint32_t beats = 0, onsets = 0;
+  clock_t t0 = clock();
+  for (size_t i = 0; i + Audio::HOP <= samples.size(); i += Audio::HOP) {
+    if (!dsp.push(&samples[i], Audio::HOP)) continue;
+    const Audio::Snapshot& s = dsp.result();
+    uint8_t beat = s.beats - last.beats, onset = s.onsets - last.onsets;
+    beats += beat; onsets += onset;
+    last = s;
+    if (!csv) continue;
+    printf("%lu,%u,%u,%u,%u,%u,%u,%u,%d", (unsigned long)(i + Audio::HOP) * 1000 / Audio::SAMPLE_RATE,
+           s.level, s.bass, s.mid, s.treble, beat, onset, s.bpm, s.peakQ8);
+    for (uint8_t b = 0; b < Audio::BANDS; b++) printf(",%u", s.band[b]);
+    printf("\n");
+  }
+  double secs = (double)(clock() - t0) / CLOCKS_PER_SEC;
+  const Audio::Snapshot& s = dsp.result();
+  if (!csv) {
+    printf("%s: %.1f s audio, %lu analyses\n", argv[1], (double)samples.size() / Audio::SAMPLE_RATE, (unsigned long)s.frame);
+    printf("beats %lu, onsets %lu, BPM %u\n", (unsigned long)beats, (unsigned long)onsets, s.bpm);
+    printf("%.2f us per analysis on this PC\n", s.frame ? secs * 1e6 / s.frame : 0.0);
+  }
+  return 0;
+}
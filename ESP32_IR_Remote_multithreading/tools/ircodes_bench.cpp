@@ -0,0 +1,136 @@
+/*
+ircodes_bench.cpp — how long MyIRcodes' lookup() takes on the PC, against what it replaced
+- lookup()     perfect-hash slot + one compare (MyIRcodes.h now)
+- switch       the 17-case switch the old decode() had
+- table scan   the {code, button} array walked by Arduino_IR_remote_print_button
+- if chain     the buttonName() if-chains the sketches carried
+- Codes are a fixed pseudo-random mix: 80 % our buttons, 20 % other NEC
+  codes / noise, so the misses (which walk the whole scan and chain) count too.
+  The ESP32 takes longer per lookup; the ratios are what this is for.
+
+Build and run (from this folder):
+  g++ -O2 -std=c++11 -I../../Arduino_custom_library_demo_IR_remote/MyIRcodes ircodes_bench.cpp -o ircodes_bench
+  ./ircodes_bench
+*/
+
+#include "MyIRcodes.h"
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include <vector>
+
+using namespace MyIR;
+
+static volatile uint32_t sink;   // keeps the results alive for the optimizer
+
+static double nowNs() {
+  timespec t;
+  clock_gettime(CLOCK_MONOTONIC, &t);
+  return t.tv_sec * 1e9 + t.tv_nsec;
+}
+
+// ---- the old ways (copied from the sketches before MYIR_BUTTONS) ----
+
+static Button bySwitch(uint32_t c) {
+  switch (c) {
+    case 0xBA45FF00: return BTN_1;
+    case 0xB946FF00: return BTN_2;
+    case 0xB847FF00: return BTN_3;
+    case 0xBB44FF00: return BTN_4;
+    case 0xBF40FF00: return BTN_5;
+    case 0xBC43FF00: return BTN_6;
+    case 0xF807FF00: return BTN_7;
+    case 0xEA15FF00: return BTN_8;
+    case 0xF609FF00: return BTN_9;
+    case 0xE916FF00: return BTN_STAR;
+    case 0xE619FF00: return BTN_0;
+    case 0xF20DFF00: return BTN_HASH;
+    case 0xE718FF00: return BTN_UP;
+    case 0xF708FF00: return BTN_LEFT;
+    case 0xE31CFF00: return BTN_OK;
+    case 0xA55AFF00: return BTN_RIGHT;
+    case 0xAD52FF00: return BTN_DOWN;
+    default:         return BTN_NONE;
+  }
+}
+
+struct ButtonMap { uint32_t code; Button btn; };
+static const ButtonMap TABLE[] = {
+  { 0xBA45FF00, BTN_1 }, { 0xB946FF00, BTN_2 }, { 0xB847FF00, BTN_3 },
+  { 0xBB44FF00, BTN_4 }, { 0xBF40FF00, BTN_5 }, { 0xBC43FF00, BTN_6 },
+  { 0xF807FF00, BTN_7 }, { 0xEA15FF00, BTN_8 }, { 0xF609FF00, BTN_9 },
+  { 0xE916FF00, BTN_STAR }, { 0xE619FF00, BTN_0 }, { 0xF20DFF00, BTN_HASH },
+  { 0xE718FF00, BTN_UP }, { 0xF708FF00, BTN_LEFT }, { 0xE31CFF00, BTN_OK },
+  { 0xA55AFF00, BTN_RIGHT }, { 0xAD52FF00, BTN_DOWN },
+};
+
+static Button byScan(uint32_t c) {
+  for (size_t i = 0; i < sizeof(TABLE) / sizeof(TABLE[0]); i++) if (TABLE[i].code == c) return TABLE[i].btn;
+  return BTN_NONE;
+}
+
+static const char* byChain(uint32_t c) {
+  if (c == ONE)      return "ONE";
+  if (c == TWO)      return "TWO";
+  if (c == THREE)    return "THREE";
+  if (c == FOUR)     return "FOUR";
+  if (c == FIVE)     return "FIVE";
+  if (c == SIX)      return "SIX";
+  if (c == SEVEN)    return "SEVEN";
+  if (c == EIGHT)    return "EIGHT";
+  if (c == NINE)     return "NINE";
+  if (c == STARBTN)  return "STAR";
+  if (c == ZERO)     return "ZERO";
+  if (c == HASHBTN)  return "HASH";
+  if (c == UPBTN)    return "UP";
+  if (c == LEFTBTN)  return "LEFT";
+  if (c == OKBTN)    return "OK";
+  if (c == RIGHTBTN) return "RIGHT";
+  if (c == DOWNBTN)  return "DOWN";
+  return "UNKNOWN";
+}
+
+// ---- timing ----
+
+template<class F>
+static void run(const char* what, const std::vector<uint32_t>& codes, F fn) {
+  const int ROUNDS = 20;
+  double best = 1e18;
+  for (int r = 0; r < ROUNDS; r++) {
+    double t0 = nowNs();
+    uint32_t acc = 0;
+    for (size_t i = 0; i < codes.size(); i++) acc += fn(codes[i]);
+    double t = nowNs() - t0;
+    sink = acc;
+    if (t < best) best = t;
+  }
+  printf("%-12s %6.2f ns per code\n", what, best / codes.size());
+}
+
+int main() {
+  std::vector<uint32_t> codes(1 << 20);
+  uint32_t x = 2463534242u;   // xorshift32: the same mix every run
+  for (size_t i = 0; i < codes.size(); i++) {
+    x ^= x << 13; x ^= x >> 17; x ^= x << 5;
+    uint8_t pick = x % 10;
+    if (pick < 8)       codes[i] = TABLE[(x >> 8) % 17].code;
+    else if (pick == 8) codes[i] = necRaw((uint8_t)(x >> 8));     // another button of a NEC remote
+    else                codes[i] = x;                             // noise
+  }
+
+  // all four must agree before their times mean anything
+  for (size_t i = 0; i < 4096; i++) {
+    Button a = lookup(codes[i]);
+    if (a != bySwitch(codes[i]) || a != byScan(codes[i]) || strcmp(byChain(codes[i]), name(a)) != 0) {
+      fprintf(stderr, "mismatch at 0x%08X\n", (unsigned)codes[i]);
+      return 1;
+    }
+  }
+
+  printf("%zu codes, best of 20 runs\n", codes.size());
+  run("lookup()",   codes, [](uint32_t c) { return (uint32_t)lookup(c); });
+  run("switch",     codes, [](uint32_t c) { return (uint32_t)bySwitch(c); });
+  run("table scan", codes, [](uint32_t c) { return (uint32_t)byScan(c); });
+  run("if chain",   codes, [](uint32_t c) { return (uint32_t)(uintptr_t)byChain(c); });
+  return 0;
+}
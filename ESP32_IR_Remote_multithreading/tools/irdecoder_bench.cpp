@@ -0,0 +1,148 @@
+/*
+irdecoder_bench.cpp — edges per second through MyIRcodes' IRDecoder on the PC
+- Without arguments it builds a mixed stream: NEC presses with repeat
+  frames, RC5 and SIRC presses, ±60 µs jitter and a few noise glitches
+  between frames, about like a room with several remotes.
+- With a file it replays a capture: one level per number in µs, positive =
+  mark, negative = space (IRremote's raw dump with signs), '#' starts a
+  comment. A silence > 20 ms calls endBurst(), as pumpIRDecoder() does.
+- Prints edges/s, ns per edge and what was decoded. An IR burst has ~70
+  edges per 108 ms, so anything in the millions is plenty; the number is
+  for comparing changes to the decoder.
+
+Build and run (from this folder):
+  g++ -O2 -std=c++11 -I../../Arduino_custom_library_demo_IR_remote/MyIRcodes irdecoder_bench.cpp -o irdecoder_bench
+  ./irdecoder_bench               built-in mixed stream
+  ./irdecoder_bench capture.txt   a capture
+*/
+
+#include "IRDecoder.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <vector>
+
+using namespace MyIR;
+
+static uint32_t rng = 2463534242u;
+static uint32_t rnd(uint32_t n) { rng ^= rng << 13; rng ^= rng >> 17; rng ^= rng << 5; return rng % n; }
+
+static void level(std::vector<int32_t>& v, bool mark, int32_t us) {
+  us += (int32_t)rnd(121) - 60;
+  v.push_back(mark ? us : -us);
+}
+
+static void nec(std::vector<int32_t>& v, uint32_t raw) {
+  level(v, true, 9000); level(v, false, 4500);
+  for (uint8_t i = 0; i < 32; i++) { level(v, true, 560); level(v, false, (raw >> i) & 1 ? 1690 : 560); }
+  level(v, true, 560);
+}
+
+static void necRepeat(std::vector<int32_t>& v) {
+  level(v, true, 9000); level(v, false, 2250); level(v, true, 560);
+}
+
+static void rc5(std::vector<int32_t>& v, uint8_t toggle, uint8_t addr, uint8_t cmd) {
+  uint16_t bits = (uint16_t)(1 << 13 | (cmd & 0x40 ? 0 : 1 << 12) | toggle << 11 | (addr & 0x1F) << 6 | (cmd & 0x3F));
+  std::vector<bool> halves;
+  for (int8_t b = 13; b >= 0; b--) { bool one = (bits >> b) & 1; halves.push_back(!one); halves.push_back(one); }
+  int32_t run = 0;
+  bool cur = true;
+  for (size_t i = 1; i < halves.size(); i++) {          // the first half (space) is invisible
+    if (run && halves[i] != cur) { level(v, cur, run); run = 0; }
+    cur = halves[i];
+    run += 889;
+  }
+  if (cur) level(v, true, run);                           // a trailing space is the silence
+}
+
+static void sirc(std::vector<int32_t>& v, uint8_t cmd, uint8_t addr) {
+  uint16_t bits = (uint16_t)(cmd | addr << 7);
+  level(v, true, 2400);
+  for (uint8_t i = 0; i < 12; i++) { level(v, false, 600); level(v, true, (bits >> i) & 1 ? 1200 : 600); }
+}
+
+static void mixedStream(std::vector<int32_t>& v) {
+  static const uint32_t NEC_CODES[] = { ONE, TWO, OKBTN, UPBTN, DOWNBTN, 0x12ED7F80 };
+  while (v.size() < 2000000) {
+    switch (rnd(4)) {
+      case 0:
+      case 1:
+        nec(v, NEC_CODES[rnd(6)]);
+        for (uint32_t r = rnd(6); r; r--) { v.push_back(-40000); necRepeat(v); }
+        break;
+      case 2:
+        rc5(v, (uint8_t)rnd(2), 0, (uint8_t)rnd(12));
+        break;
+      default: {                                          // Sony remotes send every frame 3x
+        uint8_t cmd = (uint8_t)rnd(10);
+        for (uint32_t r = 3; r; r--) { sirc(v, cmd, 1); v.push_back(-25000); }
+        break;
+      }
+    }
+    v.push_back(-(int32_t)(30000 + rnd(100000)));
+    if (rnd(4) == 0) { v.push_back((int32_t)(50 + rnd(400))); v.push_back(-(int32_t)(30000 + rnd(10000))); }   // glitch
+  }
+}
+
+static bool loadCapture(const char* path, std::vector<int32_t>& v) {
+  FILE* f = fopen(path, "r");
+  if (!f) { fprintf(stderr, "%s: cannot open\n", path); return false; }
+  int c;
+  while ((c = fgetc(f)) != EOF) {
+    if (c == '#') { while (c != EOF && c != '\n') c = fgetc(f); continue; }
+    if (c == '-' || c == '+' || (c >= '0' && c <= '9')) {
+      ungetc(c, f);
+      long x;
+      if (fscanf(f, "%ld", &x) == 1 && x) v.push_back((int32_t)x);
+    }
+  }
+  fclose(f);
+  if (v.empty()) fprintf(stderr, "%s: no levels\n", path);
+  return !v.empty();
+}
+
+static double nowNs() {
+  timespec t;
+  clock_gettime(CLOCK_MONOTONIC, &t);
+  return t.tv_sec * 1e9 + t.tv_nsec;
+}
+
+int main(int argc, char** argv) {
+  std::vector<int32_t> levels;
+  if (argc > 1) { if (!loadCapture(argv[1], levels)) return 1; }
+  else mixedStream(levels);
+
+  const int ROUNDS = 10;
+  double best = 1e18;
+  uint32_t presses = 0, repeats = 0, unknown = 0, perProto[4] = {};
+  uint16_t overflows = 0;
+  for (int r = 0; r < ROUNDS; r++) {
+    IRDecoder d;
+    IREvent e;
+    presses = repeats = unknown = 0;
+    perProto[0] = perProto[1] = perProto[2] = perProto[3] = 0;
+    double t0 = nowNs();
+    for (size_t i = 0; i < levels.size(); i++) {
+      int32_t x = levels[i];
+      bool mark = x > 0;
+      uint32_t us = (uint32_t)(mark ? x : -x);
+      d.feed(mark, us);
+      if (!mark && us > 20000) d.endBurst();
+      while (d.read(e)) {
+        if (e.repeat) repeats++; else presses++;
+        if (e.button == BTN_NONE) unknown++;
+        perProto[e.proto & 3]++;
+      }
+    }
+    double t = nowNs() - t0;
+    if (t < best) best = t;
+    overflows = d.overflowCount();
+  }
+
+  printf("%zu edges, best of %d runs\n", levels.size(), ROUNDS);
+  printf("%.1f M edges/s, %.1f ns per edge\n", levels.size() / best * 1e3, best / levels.size());
+  printf("decoded: %u presses, %u auto-repeats (%u without a button), NEC %u, RC5 %u, SIRC %u, queue overflows %u\n",
+         presses, repeats, unknown, perProto[PROTO_NEC], perProto[PROTO_RC5], perProto[PROTO_SIRC], overflows);
+  return 0;
+}
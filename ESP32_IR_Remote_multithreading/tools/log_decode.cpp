@@ -0,0 +1,37 @@
+/*
+log_decode.cpp — turns a MyLog BINARY capture back into text on the PC
+- With MyLog::begin(Serial2, MyLog::BINARY) the ESP32 sends short frames
+  (format ID + arguments, each format string only once) instead of text.
+  This prints them exactly as text mode would, with the same timestamps.
+- Bytes outside frames (plain Serial2.print) are passed through unchanged.
+- Formats are re-sent every 10 s, so a capture started late decodes from
+  that point on; earlier events show as "format #n not received yet".
+
+Build and run (from this folder):
+  g++ -O2 -std=c++11 -I../../Arduino_custom_library_demo_IR_remote/MyLog log_decode.cpp -o log_decode
+  ./log_decode capture.bin                      decode a saved capture
+  stty -F /dev/ttyUSB0 115200 raw && ./log_decode /dev/ttyUSB0    live (Linux)
+*/
+
+#include "MyLog.h"
+#include <stdio.h>
+
+struct Stdout {
+  void write(const uint8_t* p, size_t n) { fwrite(p, 1, n, stdout); }
+};
+
+int main(int argc, char** argv) {
+  FILE* f = (argc > 1) ? fopen(argv[1], "rb") : stdin;
+  if (!f) { fprintf(stderr, "%s: cannot open\n", argv[1]); return 1; }
+  bool live = (argc > 1) && strncmp(argv[1], "/dev/", 5) == 0;
+
+  static MyLog::Decoder decoder;   // ~8 kB of format dictionary
+  Stdout out;
+  int c;
+  while ((c = fgetc(f)) != EOF) {
+    decoder.feed((uint8_t)c, out);
+    if (live && c == '\n') fflush(stdout);
+  }
+  if (decoder.badFrames) fprintf(stderr, "%lu damaged frames\n", (unsigned long)decoder.badFrames);
+  return 0;
+}
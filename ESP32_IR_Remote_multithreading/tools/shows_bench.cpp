@@ -0,0 +1,342 @@
+/*
+shows_bench.cpp — MyShows::Engine::render() on the PC, against the per-sketch shows it replaced
+- engine   Engine<N, OrderGRB>::render() (MyShows.h), brightness 120
+- sketch   show1_rainbowCycle() .. show9_palettePulse() as they were in
+           Arduino_IR_remote_neopixel12_V3 (the other copies differed only
+           in colors), drawing through strip.setPixelColor() / strip.Color()
+           with strip.setBrightness(120)
+- Strip below is Adafruit_NeoPixel's pixel path (scale in setPixelColor,
+  unscale in getPixelColor, GRB); show() and the IR code are left out.
+- Shows 1, 2, 3 and 9 must give the same bytes in both before any time is
+  printed. Comet, twinkle and rain changed on purpose (MyShows.h), and the
+  old color wipe set one LED per step while the engine redraws the strip,
+  so those rows compare work per frame, not identical output.
+- N goes up to 255: the old sketches kept positions in uint8_t / int8_t.
+  The ESP32 and the Leonardo are slower per frame; the ratios are what this is for.
+
+Build and run (from this folder):
+  g++ -O2 -std=c++11 -I../../Arduino_custom_library_demo_IR_remote/MyShows shows_bench.cpp -o shows_bench
+  ./shows_bench
+*/
+
+#include "MyShows.h"
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+typedef uint8_t byte;
+
+static volatile uint32_t sink;   // keeps the frames alive for the optimizer
+
+static double nowNs() {
+  timespec t;
+  clock_gettime(CLOCK_MONOTONIC, &t);
+  return t.tv_sec * 1e9 + t.tv_nsec;
+}
+
+// Arduino's random(), from an xorshift so every run draws the same
+static uint32_t rngState = 2463534242u;
+static long random(long howBig) {
+  rngState ^= rngState << 13; rngState ^= rngState >> 17; rngState ^= rngState << 5;
+  return howBig ? (long)(rngState % (uint32_t)howBig) : 0;
+}
+static long random(long howSmall, long howBig) { return howSmall >= howBig ? howSmall : random(howBig - howSmall) + howSmall; }
+
+// Adafruit_NeoPixel, NEO_GRB: the per-pixel work the sketches paid for
+struct Strip {
+  uint16_t numLEDs;
+  uint8_t  brightness = 0;     // setBrightness(b) stores b + 1, 0 = full
+  uint8_t  pixels[255 * 3];
+
+  explicit Strip(uint16_t n) : numLEDs(n) { memset(pixels, 0, sizeof(pixels)); }
+
+  static uint32_t Color(uint8_t r, uint8_t g, uint8_t b) { return ((uint32_t)r << 16) | ((uint32_t)g << 8) | b; }
+  void setBrightness(uint8_t b) { brightness = b + 1; }
+  void setPixelColor(uint16_t n, uint8_t r, uint8_t g, uint8_t b) {
+    if (n >= numLEDs) return;
+    if (brightness) { r = (r * brightness) >> 8; g = (g * brightness) >> 8; b = (b * brightness) >> 8; }
+    uint8_t* p = &pixels[n * 3];
+    p[0] = g; p[1] = r; p[2] = b;
+  }
+  void setPixelColor(uint16_t n, uint32_t c) { setPixelColor(n, (uint8_t)(c >> 16), (uint8_t)(c >> 8), (uint8_t)c); }
+  uint32_t getPixelColor(uint16_t n) const {
+    if (n >= numLEDs) return 0;
+    const uint8_t* p = &pixels[n * 3];
+    if (!brightness) return Color(p[1], p[0], p[2]);
+    return Color((uint8_t)((p[1] << 8) / brightness), (uint8_t)((p[0] << 8) / brightness), (uint8_t)((p[2] << 8) / brightness));
+  }
+};
+
+// ---- the old shows (copied from V3, globals moved into a struct per N) ----
+
+template<uint16_t NUMPIXELS>
+struct Sketch {
+  Strip strip{NUMPIXELS};
+  uint16_t animStep = 0;
+  bool ledUpdatePending = false;
+
+  void markLEDsForUpdate() { ledUpdatePending = true; }
+  void clearStrip() { for (uint16_t i = 0; i < NUMPIXELS; i++) strip.setPixelColor(i, 0); }
+
+  uint32_t wheel(byte pos) {
+    pos = 255 - pos;
+    if (pos < 85) {
+      return strip.Color(255 - pos * 3, 0, pos * 3);
+    } else if (pos < 170) {
+      pos -= 85;
+      return strip.Color(0, pos * 3, 255 - pos * 3);
+    } else {
+      pos -= 170;
+      return strip.Color(pos * 3, 255 - pos * 3, 0);
+    }
+  }
+
+  void show1_rainbowCycle() {
+    for (uint16_t i = 0; i < NUMPIXELS; i++) {
+      strip.setPixelColor(i, wheel((i * 256 / NUMPIXELS + animStep) & 0xFF));
+    }
+    markLEDsForUpdate();
+    animStep++;
+  }
+
+  void show2_theaterChase() {
+    uint8_t offset = animStep % 3;
+    for (uint16_t i = 0; i < NUMPIXELS; i++) {
+      if (i % 3 == offset) strip.setPixelColor(i, strip.Color(255, 180, 40));
+      else strip.setPixelColor(i, 0);
+    }
+    markLEDsForUpdate();
+    animStep++;
+  }
+
+  void show3_breathing() {
+    uint8_t phase = animStep & 0xFF;
+    uint8_t tri = (phase < 128) ? phase * 2 : (255 - phase) * 2;
+    uint8_t r = 0, g = (uint16_t)tri * 2 / 3, b = tri;
+    for (uint16_t i = 0; i < NUMPIXELS; i++) {
+      strip.setPixelColor(i, strip.Color(r, g, b));
+    }
+    markLEDsForUpdate();
+    animStep++;
+  }
+
+  uint8_t cometPos = 0;
+  uint8_t cometTrail[NUMPIXELS] = {};
+
+  void show4_comet() {
+    for (uint16_t i = 0; i < NUMPIXELS; i++) {
+      if (cometTrail[i] > 5) cometTrail[i] -= 5;
+      else cometTrail[i] = 0;
+      uint8_t v = cometTrail[i];
+      strip.setPixelColor(i, strip.Color(v, (v * 2) / 3, 10));
+    }
+    cometTrail[cometPos] = 255;
+    markLEDsForUpdate();
+    cometPos = (cometPos + 1) % NUMPIXELS;
+    animStep++;
+  }
+
+  uint8_t wipeIndex = 0;
+  uint8_t wipeColorIndex = 0;
+
+  uint32_t basicPalette(uint8_t idx) {
+    switch (idx % 6) {
+      case 0: return strip.Color(255, 0, 0);
+      case 1: return strip.Color(0, 255, 0);
+      case 2: return strip.Color(0, 0, 255);
+      case 3: return strip.Color(255, 255, 0);
+      case 4: return strip.Color(255, 0, 255);
+      default:return strip.Color(0, 255, 255);
+    }
+  }
+
+  void show5_colorWipeCycle() {
+    strip.setPixelColor(wipeIndex, basicPalette(wipeColorIndex));
+    markLEDsForUpdate();
+    wipeIndex++;
+    if (wipeIndex >= NUMPIXELS) {
+      wipeIndex = 0;
+      wipeColorIndex++;
+    }
+    animStep++;
+  }
+
+  uint8_t twinkleVal[NUMPIXELS] = {};
+
+  void show6_twinkle() {
+    if (random(0, 100) < 30) {
+      uint16_t p = random(0, NUMPIXELS);
+      twinkleVal[p] = 180 + random(0, 76);
+    }
+    for (uint16_t i = 0; i < NUMPIXELS; i++) {
+      if (twinkleVal[i] > 3) twinkleVal[i] -= 3;
+      else twinkleVal[i] = 0;
+      uint8_t v = twinkleVal[i];
+      strip.setPixelColor(i, strip.Color(v, v, (uint16_t)v * 3 / 2));
+    }
+    markLEDsForUpdate();
+    animStep++;
+  }
+
+  int8_t scanPos = 0;
+  int8_t scanDir = 1;
+
+  void show7_scanner() {
+    clearStrip();
+    strip.setPixelColor(scanPos, strip.Color(255, 30, 30));
+    int16_t left = scanPos - 1;
+    int16_t right = scanPos + 1;
+    if (left >= 0)  strip.setPixelColor(left,  strip.Color(120, 10, 10));
+    if (right < NUMPIXELS) strip.setPixelColor(right, strip.Color(120, 10, 10));
+    markLEDsForUpdate();
+    scanPos += scanDir;
+    if (scanPos <= 0 || scanPos >= (int)NUMPIXELS - 1) scanDir = -scanDir;
+    animStep++;
+  }
+
+  struct Drop { int8_t pos; uint8_t life; };
+  static const uint8_t MAX_DROPS = 4;
+  Drop drops[MAX_DROPS] = {};
+
+  void spawnDrop() {
+    for (uint8_t i = 0; i < MAX_DROPS; i++) {
+      if (drops[i].life == 0) {
+        drops[i].pos = random(0, NUMPIXELS);
+        drops[i].life = 30 + random(0, 40);
+        return;
+      }
+    }
+  }
+
+  void show8_rain() {
+    if (random(0, 100) < 25) spawnDrop();
+    for (uint16_t i = 0; i < NUMPIXELS; i++) {
+      uint32_t c = strip.getPixelColor(i);
+      uint8_t r = (c >> 16) & 0xFF;
+      uint8_t g = (c >> 8)  & 0xFF;
+      uint8_t b = c & 0xFF;
+      if (r > 5) r -= 5; else r = 0;
+      if (g > 5) g -= 5; else g = 0;
+      if (b > 5) b -= 5; else b = 0;
+      strip.setPixelColor(i, r, g, b);
+    }
+    for (uint8_t i = 0; i < MAX_DROPS; i++) {
+      if (drops[i].life) {
+        strip.setPixelColor(drops[i].pos, strip.Color(40, 0, 200));
+        drops[i].pos = (drops[i].pos + 1) % NUMPIXELS;
+        drops[i].life--;
+      }
+    }
+    markLEDsForUpdate();
+    animStep++;
+  }
+
+  static const uint8_t PAL_SIZE = 5;
+  uint32_t palette9[PAL_SIZE] = { 0xFF5500, 0x00FF88, 0x3355FF, 0xFF00AA, 0xFFFF22 };
+  uint8_t palIdx = 0;
+
+  void show9_palettePulse() {
+    uint8_t phase = animStep & 0xFF;
+    uint8_t tri = (phase < 128) ? phase * 2 : (255 - phase) * 2;
+    uint32_t base = palette9[palIdx];
+    uint8_t br = tri;
+    uint8_t r = ((base >> 16) & 0xFF);
+    uint8_t g = ((base >> 8)  & 0xFF);
+    uint8_t b = (base & 0xFF);
+    for (uint16_t i = 0; i < NUMPIXELS; i++) {
+      uint8_t local = (br * (uint8_t)((i * 8) % 64 + 192)) / 255;
+      strip.setPixelColor(i, (uint16_t)r * local / 255, (uint16_t)g * local / 255, (uint16_t)b * local / 255);
+    }
+    markLEDsForUpdate();
+    if ((animStep % 180) == 0) palIdx = (palIdx + 1) % PAL_SIZE;
+    animStep++;
+  }
+
+  void render(uint8_t show) {
+    switch (show) {
+      case 1: show1_rainbowCycle();   break;
+      case 2: show2_theaterChase();   break;
+      case 3: show3_breathing();      break;
+      case 4: show4_comet();          break;
+      case 5: show5_colorWipeCycle(); break;
+      case 6: show6_twinkle();        break;
+      case 7: show7_scanner();        break;
+      case 8: show8_rain();           break;
+      case 9: show9_palettePulse();   break;
+    }
+  }
+};
+
+// ---- timing ----
+
+static const uint8_t BRIGHT = 120;
+static const char* const NAMES[] = { "", "rainbow", "theater", "breathing", "comet", "color wipe",
+                                     "twinkle", "scanner", "rain", "palette pulse" };
+
+template<uint16_t N>
+static bool sameOutput(uint8_t show) {
+  static MyShows::Engine<N, MyShows::OrderGRB, MyShows::OwnPixels<N> > e;
+  static Sketch<N> s;
+  e = MyShows::Engine<N, MyShows::OrderGRB, MyShows::OwnPixels<N> >();
+  e.brightness = BRIGHT;
+  e.select(show);
+  e.clear();
+  s = Sketch<N>();
+  s.strip.setBrightness(BRIGHT);
+  for (uint16_t f = 0; f < 1000; f++) {
+    e.render();
+    s.render(show);
+    if (memcmp(e.pixels.data(), s.strip.pixels, N * 3) != 0) {
+      fprintf(stderr, "N=%u %s: frame %u differs\n", N, NAMES[show], f);
+      return false;
+    }
+  }
+  return true;
+}
+
+// best of ROUNDS, each `frames` render() calls
+template<uint16_t N, class F>
+static double best(uint32_t frames, F fn) {
+  const int ROUNDS = 7;
+  double b = 1e18;
+  for (int r = 0; r < ROUNDS; r++) {
+    double t0 = nowNs();
+    for (uint32_t f = 0; f < frames; f++) fn();
+    double t = (nowNs() - t0) / frames;
+    if (t < b) b = t;
+  }
+  return b;
+}
+
+template<uint16_t N>
+static void bench() {
+  static MyShows::Engine<N, MyShows::OrderGRB, MyShows::OwnPixels<N> > e;
+  static Sketch<N> s;
+  const uint32_t frames = 4000000 / N + 1;
+  printf("\nN = %u LEDs, %u frames, best of 7\n", N, (unsigned)frames);
+  printf("%-14s %12s %12s %8s\n", "show", "engine ns", "sketch ns", "ratio");
+  for (uint8_t show = 1; show <= 9; show++) {
+    e = MyShows::Engine<N, MyShows::OrderGRB, MyShows::OwnPixels<N> >();
+    e.brightness = BRIGHT;
+    e.select(show);
+    e.clear();
+    s = Sketch<N>();
+    s.strip.setBrightness(BRIGHT);
+    double te = best<N>(frames, [&]() { e.render(); sink += e.pixels.data()[0]; });
+    double ts = best<N>(frames, [&]() { s.render(show); sink += s.strip.pixels[0]; });
+    printf("%-14s %12.1f %12.1f %7.2fx\n", NAMES[show], te, ts, ts / te);
+  }
+}
+
+int main() {
+  const uint8_t same[] = { 1, 2, 3, 9 };
+  for (uint8_t i = 0; i < sizeof(same); i++) {
+    if (!sameOutput<12>(same[i]) || !sameOutput<60>(same[i]) || !sameOutput<255>(same[i])) return 1;
+  }
+  printf("shows 1, 2, 3, 9: same bytes as the sketch at 12, 60 and 255 LEDs\n");
+  printf("ns per frame (one render() / one showN_...() call), ratio = sketch / engine\n");
+  bench<12>();
+  bench<60>();
+  bench<255>();
+  return 0;
+}
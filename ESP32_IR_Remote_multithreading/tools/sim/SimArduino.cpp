@@ -0,0 +1,265 @@
+// SimArduino.cpp — Arduino core and ESP-IDF calls of src/main.cpp on the virtual ESP32 (SimKernel.h)
+
+#include "SimKernel.h"
+#include <Arduino.h>
+#include <Adafruit_NeoPixel.h>
+#include <Preferences.h>
+#include <WiFi.h>
+#include <esp_now.h>
+#include <esp_sleep.h>
+#include <driver/i2s.h>
+#include <stdarg.h>
+
+HardwareSerial Serial(0);
+HardwareSerial Serial2(2);
+WiFiClass WiFi;
+
+namespace {
+  uint32_t rng = 0x2545F491;
+  uint32_t audioRng = 0x9E3779B9;
+  Sim::AudioSource audioSrc = Sim::AUDIO_SILENT;
+  float audioBpm = 120;
+  FILE* serialLog = nullptr;
+
+  uint32_t next(uint32_t& s) {
+    s ^= s << 13; s ^= s >> 17; s ^= s << 5;
+    return s;
+  }
+
+  // Microphone signal at sample n (16 kHz), -1..1: noise, or a kick drum on every beat over quiet noise
+  float audioSample(uint64_t n) {
+    float noise = ((int32_t)next(audioRng) / 2147483648.0f);
+    if (audioSrc == Sim::AUDIO_NOISE) return 0.3f * noise;
+    if (audioSrc != Sim::AUDIO_BEAT) return 0.002f * noise;
+    uint64_t beat = (uint64_t)(16000 * 60 / audioBpm);
+    float t = (float)(n % beat) / 16000;                  // s since the beat
+    float kick = expf(-t * 18) * sinf(6.2832f * 60 * t);
+    return 0.7f * kick + 0.05f * noise;
+  }
+
+  // I2S RX: blocks of dma_buf_len samples, complete at start + (k + 1) * block
+  struct I2S {
+    bool on = false, adc = false;
+    uint32_t rate = 16000, blockLen = 256, blocks = 4, bytes = 2;
+    Sim::Time start = 0;
+    uint64_t read = 0;                  // blocks handed out (incl. the ones lost to overruns)
+    uint32_t offset = 0;                // samples taken from the current block
+    Sim::Time slept = 0;                // Sim::stats.sleepUs at the last read
+  } i2s;
+
+  Sim::Time blockDone(uint64_t k) { return i2s.start + (k + 1) * (uint64_t)i2s.blockLen * 1000000 / i2s.rate; }
+
+  uint64_t lightSleepUs = 0;
+  bool wokeByPin = false;
+} // namespace
+
+namespace Sim {
+  void setAudio(AudioSource src, float bpm) { audioSrc = src; audioBpm = bpm > 20 ? bpm : 20; }
+  void setSerialLog(FILE* f) { serialLog = f; }
+  void seedRandom(uint32_t seed) { rng = seed ? seed : 1; audioRng = rng ^ 0x9E3779B9; }
+}
+
+// ================= time and pins =================
+unsigned long millis() { return (uint32_t)(Sim::now() / 1000); }
+unsigned long micros() { return (uint32_t)Sim::now(); }
+int64_t esp_timer_get_time() { return (int64_t)Sim::now(); }
+void delay(uint32_t ms) { vTaskDelay(pdMS_TO_TICKS(ms)); }
+void delayMicroseconds(uint32_t us) { Sim::busy(us, false, "delayMicroseconds"); }
+void yield() { Sim::yield(); }
+
+void pinMode(uint8_t, uint8_t) {}
+int digitalRead(uint8_t pin) { return Sim::pinLevel(pin); }
+void digitalWrite(uint8_t, uint8_t) {}
+uint16_t analogRead(uint8_t) { Sim::busy(10, false, "analogRead"); return (uint16_t)(1800 + next(rng) % 400); }
+void attachInterrupt(uint8_t pin, void (*isr)(), int mode) { Sim::attachInterrupt(pin, isr, mode); }
+void detachInterrupt(uint8_t pin) { Sim::detachInterrupt(pin); }
+
+long random(long max) { return max > 0 ? (long)(next(rng) % (uint32_t)max) : 0; }
+long random(long min, long max) { return min < max ? min + random(max - min) : min; }
+void randomSeed(unsigned long seed) { if (seed) rng = (uint32_t)seed; }
+uint32_t esp_random() { return next(rng); }
+
+bool setCpuFrequencyMhz(uint32_t mhz) { Sim::setCpuMhz(mhz); return true; }
+uint32_t getCpuFrequencyMhz() { return Sim::cpuMhz(); }
+bool psramFound() { return false; }                     // esp32dev has none
+void* ps_malloc(size_t n) { return malloc(n); }
+
+// ================= UART =================
+size_t Print::write(const uint8_t* buf, size_t n) {
+  for (size_t i = 0; i < n; i++) write(buf[i]);
+  return n;
+}
+
+size_t Print::print(long v, int base) {
+  char b[24];
+  snprintf(b, sizeof(b), base == HEX ? "%lX" : "%ld", v);
+  return print(b);
+}
+
+size_t Print::printf(const char* f, ...) {
+  char b[256];
+  va_list a;
+  va_start(a, f);
+  int n = vsnprintf(b, sizeof(b), f, a);
+  va_end(a);
+  if (n <= 0) return 0;
+  return write((const uint8_t*)b, (size_t)n < sizeof(b) ? (size_t)n : sizeof(b) - 1);
+}
+
+// Bytes leave at the baud rate; with 128 queued the writer waits (the core is free)
+size_t HardwareSerial::write(const uint8_t* buf, size_t n) {
+  const uint64_t FIFO = 128;
+  for (size_t i = 0; i < n; i++) {
+    uint64_t nowNs = Sim::now() * 1000;
+    if (freeAtNs > nowNs + FIFO * byteNs && Sim::self()) {
+      Sim::Time wake = (freeAtNs - FIFO * byteNs + 999) / 1000;
+      Sim::stats.uartBlockedUs += wake - Sim::now();
+      Sim::sleepUntil(wake);
+      nowNs = Sim::now() * 1000;
+    }
+    freeAtNs = (freeAtNs > nowNs ? freeAtNs : nowNs) + byteNs;
+    if (serialLog) fputc(buf[i], serialLog);
+    if (buf[i] == '\n' || lineLen == sizeof(line) - 1) {
+      while (lineLen && line[lineLen - 1] == '\r') lineLen--;
+      line[lineLen] = '\0';
+      Sim::stats.uartLines++;
+      if (Sim::hooks.serial) Sim::hooks.serial(port, freeAtNs / 1000, line);
+      lineLen = 0;
+    } else {
+      line[lineLen++] = (char)buf[i];
+    }
+  }
+  return n;
+}
+
+void HardwareSerial::flush() { Sim::sleepUntil((freeAtNs + 999) / 1000); }
+
+// ================= NeoPixel =================
+bool Adafruit_NeoPixel::canShow() const { return Sim::now() >= endUs + Sim::config.latchUs; }
+
+void Adafruit_NeoPixel::show() {
+  if (!canShow()) Sim::busy(endUs + Sim::config.latchUs - Sim::now(), false, "strip latch");
+  Sim::Time start = Sim::now();
+  Sim::Time us = (Sim::Time)numPixels() * Sim::config.ledNs / 1000;
+  if (Sim::config.blackout) Sim::busy(us, true, "strip.show");
+  else Sim::sleepUntil(start + us);                      // RMT sends, the task waits
+  endUs = Sim::now();
+  Sim::stats.shows++;
+  Sim::stats.showUs += endUs - start;
+  if (Sim::hooks.show) Sim::hooks.show(start, endUs, px.data(), numPixels());
+}
+
+// ================= NVS =================
+std::map<std::string, std::vector<uint8_t> >& Preferences::store() {
+  static std::map<std::string, std::vector<uint8_t> > m;
+  return m;
+}
+
+size_t Preferences::getBytesLength(const char* key) {
+  auto it = store().find(ns + "/" + key);
+  return it == store().end() ? 0 : it->second.size();
+}
+
+size_t Preferences::getBytes(const char* key, void* buf, size_t len) {
+  auto it = store().find(ns + "/" + key);
+  if (it == store().end() || it->second.size() > len) return 0;
+  memcpy(buf, it->second.data(), it->second.size());
+  return it->second.size();
+}
+
+size_t Preferences::putBytes(const char* key, const void* buf, size_t len) {
+  Sim::busy(Sim::config.flashUs, false, "nvs write");
+  store()[ns + "/" + key].assign((const uint8_t*)buf, (const uint8_t*)buf + len);
+  Sim::stats.nvsWrites++;
+  return len;
+}
+
+// ================= light sleep =================
+esp_err_t esp_sleep_enable_gpio_wakeup() { Sim::enableWakeOnPin(true); return ESP_OK; }
+esp_err_t esp_sleep_enable_timer_wakeup(uint64_t us) { lightSleepUs = us; return ESP_OK; }
+
+esp_err_t esp_sleep_disable_wakeup_source(esp_sleep_source_t) {
+  Sim::enableWakeOnPin(false);
+  lightSleepUs = 0;
+  return ESP_OK;
+}
+
+esp_err_t esp_light_sleep_start() {
+  wokeByPin = Sim::lightSleep(lightSleepUs ? lightSleepUs : Sim::NEVER / 2);
+  return ESP_OK;
+}
+
+esp_sleep_wakeup_cause_t esp_sleep_get_wakeup_cause() { return wokeByPin ? ESP_SLEEP_WAKEUP_GPIO : ESP_SLEEP_WAKEUP_TIMER; }
+
+// ================= I2S microphone =================
+esp_err_t i2s_driver_install(i2s_port_t, const i2s_config_t* cfg, int, void*) {
+  i2s.on = true;
+  i2s.adc = (cfg->mode & I2S_MODE_ADC_BUILT_IN) != 0;
+  i2s.rate = cfg->sample_rate ? cfg->sample_rate : 16000;
+  i2s.blockLen = cfg->dma_buf_len > 0 ? cfg->dma_buf_len : 256;
+  i2s.blocks = cfg->dma_buf_count > 1 ? cfg->dma_buf_count : 2;
+  i2s.bytes = cfg->bits_per_sample / 8;
+  i2s.start = Sim::now();
+  return ESP_OK;
+}
+
+esp_err_t i2s_set_pin(i2s_port_t, const i2s_pin_config_t*) { return ESP_OK; }
+esp_err_t i2s_set_adc_mode(adc_unit_t, adc1_channel_t) { return ESP_OK; }
+esp_err_t i2s_adc_enable(i2s_port_t) { return ESP_OK; }
+
+// Oldest complete block first; more than dma_buf_count waiting = the oldest were overwritten
+esp_err_t i2s_read(i2s_port_t, void* dest, size_t size, size_t* bytesRead, TickType_t ticks) {
+  *bytesRead = 0;
+  if (!i2s.on) return ESP_FAIL;
+  Sim::Time deadline = ticks == portMAX_DELAY ? Sim::NEVER : Sim::now() + ticks * 1000ULL;
+  uint8_t* out = (uint8_t*)dest;
+  while (*bytesRead + i2s.bytes <= size) {
+    if (blockDone(i2s.read) > Sim::now()) {
+      if (*bytesRead || blockDone(i2s.read) > deadline) break;
+      Sim::sleepUntil(blockDone(i2s.read));             // DMA interrupt wakes the reader
+    }
+    uint64_t done = (Sim::now() - i2s.start) * i2s.rate / 1000000 / i2s.blockLen;
+    if (done - i2s.read > i2s.blocks) {
+      // asleep the DMA stood still: that backlog is not an overrun
+      if (Sim::stats.sleepUs == i2s.slept) Sim::stats.i2sOverruns += done - i2s.read - i2s.blocks;
+      i2s.read = done - i2s.blocks;
+      i2s.offset = 0;
+    }
+    i2s.slept = Sim::stats.sleepUs;
+    for (; i2s.offset < i2s.blockLen && *bytesRead + i2s.bytes <= size; i2s.offset++) {
+      float v = audioSample(i2s.read * i2s.blockLen + i2s.offset);
+      if (v > 1) v = 1;
+      if (v < -1) v = -1;
+      if (i2s.bytes == 4) {                             // I2S mic: 24 bits, left-justified
+        int32_t s = (int32_t)(v * 8388607) << 8;
+        memcpy(out + *bytesRead, &s, 4);
+      } else {                                          // ADC: 12 bits + channel 6 on top
+        uint16_t s = (uint16_t)(0x6000 | (uint16_t)(2048 + v * 2047));
+        if (!i2s.adc) s = (uint16_t)(int16_t)(v * 32767);
+        memcpy(out + *bytesRead, &s, 2);
+      }
+      *bytesRead += i2s.bytes;
+    }
+    if (i2s.offset == i2s.blockLen) { i2s.read++; i2s.offset = 0; }
+  }
+  return ESP_OK;
+}
+
+// ================= radio =================
+esp_err_t esp_wifi_get_mac(wifi_interface_t, uint8_t mac[6]) {
+  static const uint8_t MAC[6] = { 0x24, 0x6F, 0x28, 0x51, 0x4D, 0x01 };
+  memcpy(mac, MAC, 6);
+  return ESP_OK;
+}
+esp_err_t esp_wifi_set_channel(uint8_t, wifi_second_chan_t) { return ESP_OK; }
+esp_err_t esp_wifi_set_ps(wifi_ps_type_t) { return ESP_OK; }
+esp_err_t esp_now_init() { return ESP_OK; }
+esp_err_t esp_now_register_recv_cb(esp_now_recv_cb_t) { return ESP_OK; }
+bool esp_now_is_peer_exist(const uint8_t*) { return true; }
+esp_err_t esp_now_add_peer(const esp_now_peer_info_t*) { return ESP_OK; }
+
+esp_err_t esp_now_send(const uint8_t*, const uint8_t*, size_t len) {
+  Sim::busy(60 + (Sim::Time)len * 8, false, "esp_now_send");   // 1 Mbit/s on air, the task waits for the driver
+  Sim::stats.espNowSends++;
+  return ESP_OK;
+}
@@ -0,0 +1,707 @@
+// SimKernel.cpp — scheduler, FreeRTOS API and pin interrupts of the virtual ESP32 (see SimKernel.h)
+
+#include "SimKernel.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/semphr.h"
+#include <chrono>
+#include <deque>
+#include <queue>
+#include <stdlib.h>
+
+namespace Sim {
+
+  Config config;
+  Hooks hooks;
+  Trace trace;
+  Stats stats;
+
+  namespace {
+    struct Event {
+      Time t;
+      uint64_t seq;
+      std::function<void()> fn;
+      bool operator>(const Event& o) const { return t != o.t ? t > o.t : seq > o.seq; }
+    };
+
+    struct Pin {
+      int level = 1;                        // pulled up
+      void (*isr)() = nullptr;
+      int core = 0;
+      bool pending = false;
+      Time pendingSince = 0;
+    };
+
+    const size_t STACK = 256 * 1024;        // PC code needs more than the ESP32 sizes
+    const uint32_t LIVELOCK = 1000000;      // resumes at one instant before giving up
+
+    Time clock = 0;
+    std::vector<Task*> all;
+    std::vector<Semaphore*> sems;
+    Task* running[CORES] = {};
+    Task* current = nullptr;
+    int isrCore = -1;
+    ucontext_t schedCtx;
+    std::deque<Task*> resumeQ;
+    std::priority_queue<Event, std::vector<Event>, std::greater<Event> > events;
+    uint64_t seq = 0;
+    Pin pins[PINS];
+    Time sliceAt[CORES] = {};               // start of the busy slice on the core track
+    Time stretch[CORES] = {};
+
+    bool asleep = false, wakeOnPin = false, wokenByPin = false;
+    Time sleepStart = 0, sleepEnd = 0;
+    Task* sleeper = nullptr;
+    uint32_t mhz = 240;
+
+    void (*loopSetup)() = nullptr;
+    void (*loopFn)() = nullptr;
+
+    uint64_t hostNs() {
+      using namespace std::chrono;
+      return (uint64_t)duration_cast<nanoseconds>(steady_clock::now().time_since_epoch()).count();
+    }
+
+    // --- trace marks: one open slice per task track ---
+    const char RUN[] = "run";
+    const char WAIT[] = "wait";
+
+    // Closes the open slice (a run slice even when it took no time) and opens what
+    void mark(Task* t, const char* what, Semaphore* sem = nullptr) {
+      if (t->mark && (clock > t->markAt || t->mark == RUN) && trace.covers(t->markAt, clock)) {
+        std::string name = t->markSem ? std::string(WAIT) + " " + t->markSem->name : std::string(t->mark);
+        trace.slice(TRACK_TASK + t->id, name.c_str(), t->markAt, clock - t->markAt);
+      }
+      t->mark = what;
+      t->markSem = sem;
+      t->markAt = clock;
+    }
+
+    void openSlice(int c) { sliceAt[c] = clock; }
+
+    void closeSlice(int c) {
+      Task* t = running[c];
+      if (!t || clock <= sliceAt[c] || !trace.covers(sliceAt[c], clock)) return;
+      char args[96];
+      snprintf(args, sizeof(args), "{\"what\":\"%s\"%s}", t->busyWhat, t->masked ? ",\"interrupts\":\"off\"" : "");
+      trace.slice(TRACK_CORE + c, t->name.c_str(), sliceAt[c], clock - sliceAt[c], args);
+    }
+
+    // --- ready list and cores ---
+    void makeReady(Task* t) {
+      t->state = Task::READY;
+      t->readyAt = clock;
+      t->readySeq = ++seq;
+      mark(t, "ready");
+    }
+
+    Task* best(int c) {
+      Task* b = nullptr;
+      for (Task* t : all) {
+        if (t->state != Task::READY || (t->affinity != ANY_CORE && t->affinity != c)) continue;
+        if (!b || t->prio > b->prio || (t->prio == b->prio && t->readySeq < b->readySeq)) b = t;
+      }
+      return b;
+    }
+
+    void push(Task* t) {
+      if (t->queued) return;
+      t->queued = true;
+      resumeQ.push_back(t);
+    }
+
+    void startOn(Task* t, int c) {
+      t->state = Task::RUNNING;
+      t->core = c;
+      stats.switches++;
+      t->lastCore = c;
+      running[c] = t;
+      t->runs++;
+      t->ready.add(clock - t->readyAt);
+      mark(t, RUN);
+      if (t->busyLeft) openSlice(c);
+      else push(t);
+    }
+
+    // Off the core, back to ready (keeps what is left of its busy time)
+    void preempt(Task* t) {
+      int c = t->core;
+      if (t->busyLeft) closeSlice(c);
+      running[c] = nullptr;
+      t->core = -1;
+      t->preemptions++;
+      makeReady(t);
+    }
+
+    void leaveCore(Task* t) {
+      if (t->core >= 0) running[t->core] = nullptr;
+      t->core = -1;
+    }
+
+    void dispatch() {
+      if (asleep) return;
+      for (int c = 0; c < CORES; c++) {
+        Task* cur = running[c];
+        if (cur && cur->masked && cur->busyLeft) continue;   // interrupts off: no switch
+        Task* b = best(c);
+        if (!b || (cur && b->prio <= cur->prio)) continue;
+        if (cur) preempt(cur);
+        startOn(b, c);
+      }
+    }
+
+    // Equal priorities share a busy core: on a tick the next one gets it
+    bool sliceDue(int c) {
+      Task* cur = running[c];
+      if (!cur || !cur->busyLeft || cur->masked) return false;
+      Task* b = best(c);
+      return b && b->prio == cur->prio;
+    }
+
+    // --- coroutines ---
+    void entry() {
+      Task* t = current;
+      t->fn(t->arg);
+      t->state = Task::DONE;            // returned: as vTaskDelete(NULL)
+      mark(t, nullptr);
+      leaveCore(t);
+    }
+
+    void resume(Task* t) {
+      current = t;
+      t->sliceStartNs = hostNs();
+      swapcontext(&schedCtx, &t->ctx);
+      current = nullptr;
+    }
+
+    void switchOut(Task* t) {
+      swapcontext(&t->ctx, &schedCtx);
+      t->sliceStartNs = hostNs();
+    }
+
+    void spend(Task* t, Time us, bool masked, const char* what) {
+      t->busyLeft = us;
+      t->masked = masked;
+      t->busyWhat = what;
+      openSlice(t->core);
+      switchOut(t);
+    }
+
+    // PC time of the task code since it was resumed, as device time (-cpu)
+    void payDebt(Task* t) {
+      if (config.cpuScale <= 0) return;
+      uint64_t ns = hostNs();
+      t->debtNs += (uint64_t)((ns - t->sliceStartNs) * config.cpuScale * 240 / mhz);
+      t->sliceStartNs = ns;
+      if (t->debtNs < 1000) return;
+      Time us = t->debtNs / 1000;
+      t->debtNs %= 1000;
+      spend(t, us, false, "cpu");
+    }
+
+    void block(Task* t, Time deadline) {
+      payDebt(t);
+      t->state = Task::BLOCKED;
+      t->wakeAt = deadline;
+      t->timedOut = false;
+      leaveCore(t);
+      if (t->sem && t->sem->mutex) mark(t, WAIT, t->sem);
+      else mark(t, nullptr);
+      switchOut(t);
+    }
+
+    void wake(Task* t) {
+      if (t->state != Task::BLOCKED) return;
+      t->sem = nullptr;
+      t->waitNotify = false;
+      t->wakeAt = NEVER;
+      makeReady(t);
+    }
+
+    // A task just made a higher one ready on its own core: switch now, as FreeRTOS does
+    void yieldIfPreempted() {
+      Task* t = current;
+      if (!t || isrCore >= 0 || asleep) return;
+      Task* b = best(t->core);
+      if (!b || b->prio <= t->prio) return;
+      payDebt(t);
+      preempt(t);
+      switchOut(t);
+    }
+
+    void runIsr(Pin& p) {
+      int c = p.core;
+      isrCore = c;
+      p.isr();
+      isrCore = -1;
+      stats.interrupts++;
+      if (running[c] && running[c]->busyLeft) running[c]->busyLeft += config.isrUs;
+    }
+
+    void deliverPending(int c) {
+      for (uint8_t i = 0; i < PINS; i++) {
+        Pin& p = pins[i];
+        if (!p.pending || p.core != c) continue;
+        p.pending = false;
+        Time late = clock - p.pendingSince;
+        stats.lateInterrupts++;
+        if (late > stats.maxInterruptDelay) stats.maxInterruptDelay = late;
+        if (trace.covers(p.pendingSince, clock)) {
+          char args[48];
+          snprintf(args, sizeof(args), "{\"pin\":%u}", i);
+          trace.slice(TRACK_CORE + c, "interrupt pending", p.pendingSince, late, args);
+        }
+        runIsr(p);
+      }
+    }
+
+    void advance(Time next) {
+      Time dt = next - clock;
+      if (!dt) return;
+      if (!asleep) stats.mhzTime[mhz >= 240 ? 0 : mhz >= 160 ? 1 : 2] += dt;
+      clock = next;
+      for (int c = 0; c < CORES; c++) {
+        Task* t = running[c];
+        if (!t || !t->busyLeft) { stretch[c] = 0; continue; }
+        t->busyLeft -= dt;
+        t->cpu[c] += dt;
+        stats.coreBusy[c] += dt;
+        stretch[c] += dt;
+        if (stretch[c] > stats.maxBusyStretch[c]) stats.maxBusyStretch[c] = stretch[c];
+        if (t->busyLeft) continue;
+        closeSlice(c);
+        bool wasMasked = t->masked;
+        t->masked = false;
+        if (asleep) preempt(t);             // the cores stop until the wakeup
+        else push(t);
+        if (wasMasked) deliverPending(c);
+      }
+    }
+
+    void endSleep() {
+      asleep = false;
+      stats.sleepUs += clock - sleepStart;
+      if (trace.covers(sleepStart, clock))
+        for (int c = 0; c < CORES; c++) trace.slice(TRACK_CORE + c, "light sleep", sleepStart, clock - sleepStart);
+      Task* t = sleeper;
+      sleeper = nullptr;
+      if (t) wake(t);
+    }
+
+    void loopTask(void*) {
+      loopSetup();
+      for (;;) {
+        loopFn();
+        yieldIfPreempted();
+      }
+    }
+  } // namespace
+
+  WaitStats& Semaphore::waitsOf(Task* t) {
+    for (auto& w : waits) if (w.first == t) return w.second;
+    waits.push_back(std::make_pair(t, WaitStats()));
+    return waits.back().second;
+  }
+
+  // ================= Trace =================
+  bool Trace::open(const char* path, Time start, Time len) {
+    f = fopen(path, "w");
+    if (!f) return false;
+    from = start;
+    to = start + len;
+    first = true;
+    fputs("{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n", f);
+    event("{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,\"args\":{\"name\":\"ESP32 (virtual time)\"}}");
+    return true;
+  }
+
+  void Trace::close() {
+    if (!f) return;
+    fputs("\n]}\n", f);
+    fclose(f);
+    f = nullptr;
+  }
+
+  void Trace::event(const char* json) {
+    fputs(first ? "" : ",\n", f);
+    fputs(json, f);
+    first = false;
+  }
+
+  void Trace::thread(int tid, const char* name, int order) {
+    if (!f) return;
+    char b[256];
+    snprintf(b, sizeof(b), "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%d,\"args\":{\"name\":\"%s\"}}", tid, name);
+    event(b);
+    snprintf(b, sizeof(b), "{\"name\":\"thread_sort_index\",\"ph\":\"M\",\"pid\":1,\"tid\":%d,\"args\":{\"sort_index\":%d}}", tid, order);
+    event(b);
+  }
+
+  void Trace::slice(int tid, const char* name, Time start, Time dur, const char* args) {
+    if (!covers(start, start + dur)) return;
+    char b[512];
+    snprintf(b, sizeof(b), "{\"name\":\"%s\",\"ph\":\"X\",\"pid\":1,\"tid\":%d,\"ts\":%llu,\"dur\":%llu%s%s}", name, tid,
+             (unsigned long long)start, (unsigned long long)dur, args ? ",\"args\":" : "", args ? args : "");
+    event(b);
+  }
+
+  void Trace::instant(int tid, const char* name, Time t, const char* args) {
+    if (!covers(t, t)) return;
+    char b[512];
+    snprintf(b, sizeof(b), "{\"name\":\"%s\",\"ph\":\"i\",\"s\":\"t\",\"pid\":1,\"tid\":%d,\"ts\":%llu%s%s}", name, tid,
+             (unsigned long long)t, args ? ",\"args\":" : "", args ? args : "");
+    event(b);
+  }
+
+  void Trace::counter(const char* name, Time t, double value) {
+    if (!covers(t, t)) return;
+    char b[256];
+    snprintf(b, sizeof(b), "{\"name\":\"%s\",\"ph\":\"C\",\"pid\":1,\"ts\":%llu,\"args\":{\"value\":%g}}", name,
+             (unsigned long long)t, value);
+    event(b);
+  }
+
+  // ================= for the shims =================
+  Time now() { return clock; }
+  Task* self() { return isrCore >= 0 ? nullptr : current; }
+  int core() { return isrCore >= 0 ? isrCore : (current && current->core >= 0) ? current->core : 0; }
+  bool inIsr() { return isrCore >= 0; }
+
+  void busy(Time us, bool masked, const char* what) {
+    Task* t = self();
+    if (!t) return;                         // interrupts: config.isrUs covers them
+    payDebt(t);
+    if (us) spend(t, us, masked, what);
+  }
+
+  void yield() {
+    Task* t = self();
+    if (!t) return;
+    payDebt(t);
+    Task* b = best(t->core);
+    if (b && b->prio >= t->prio) preempt(t);
+    switchOut(t);                           // still running: after the others at this instant
+  }
+
+  Time tickDeadline(uint32_t ticks) {
+    if (ticks == portMAX_DELAY) return NEVER;
+    return (clock / 1000 + ticks) * 1000;
+  }
+
+  void sleepUntil(Time t) {
+    Task* me = self();
+    if (!me || t <= clock) return;
+    block(me, t);
+  }
+
+  bool delayTicks(uint32_t ticks) {
+    if (!ticks) { yield(); return true; }
+    sleepUntil(tickDeadline(ticks));
+    return true;
+  }
+
+  Task* createTask(void (*fn)(void*), const char* name, void* arg, uint8_t prio, int core) {
+    Task* t = new Task();
+    t->name = name;
+    t->id = (uint16_t)all.size();
+    t->prio = t->basePrio = prio;
+    t->affinity = (core >= 0 && core < CORES) ? core : ANY_CORE;
+    t->fn = fn;
+    t->arg = arg;
+    t->stack.resize(STACK);
+    getcontext(&t->ctx);
+    t->ctx.uc_stack.ss_sp = t->stack.data();
+    t->ctx.uc_stack.ss_size = t->stack.size();
+    t->ctx.uc_link = &schedCtx;
+    makecontext(&t->ctx, entry, 0);
+    all.push_back(t);
+    trace.thread(TRACK_TASK + t->id, name, TRACK_TASK + t->id);
+    makeReady(t);
+    yieldIfPreempted();
+    return t;
+  }
+
+  void deleteTask(Task* t) {
+    if (!t) t = self();
+    if (!t) return;
+    t->state = Task::DONE;
+    mark(t, nullptr);
+    leaveCore(t);
+    if (t == current) switchOut(t);         // never resumed
+  }
+
+  Semaphore* createSemaphore(bool mutex, uint32_t max, uint32_t initial) {
+    Semaphore* s = new Semaphore();
+    s->mutex = mutex;
+    s->max = max;
+    s->count = initial;
+    char name[32];
+    snprintf(name, sizeof(name), "%s %u", mutex ? "mutex" : "semaphore", (unsigned)sems.size() + 1);
+    s->name = name;
+    sems.push_back(s);
+    return s;
+  }
+
+  bool take(Semaphore* s, Time deadline) {
+    Task* t = self();
+    Time since = clock;
+    bool waited = false;
+    for (;;) {
+      if (s->count) {
+        s->count--;
+        s->takes++;
+        if (s->mutex) s->holder = t;
+        if (waited) s->waitsOf(t).add(clock - since);
+        if (hooks.take && t) hooks.take(s, t);
+        return true;
+      }
+      if (!t || deadline <= clock) return false;
+      if (!waited) s->contended++;
+      waited = true;
+      if (s->mutex && s->holder && s->holder->prio < t->prio) s->holder->prio = t->prio;   // inheritance
+      s->waiters.push_back(t);
+      t->sem = s;
+      block(t, deadline);
+      if (t->timedOut) {
+        for (size_t i = 0; i < s->waiters.size(); i++)
+          if (s->waiters[i] == t) { s->waiters.erase(s->waiters.begin() + i); break; }
+        s->waitsOf(t).add(clock - since);
+        return false;
+      }
+    }
+  }
+
+  bool give(Semaphore* s) {
+    Task* t = self();
+    if (s->mutex) {
+      if (s->holder != t) return false;
+      s->holder = nullptr;
+      t->prio = t->basePrio;
+    }
+    if (s->count >= s->max) return false;
+    s->count++;
+    if (hooks.give && t) hooks.give(s, t);
+    if (!s->waiters.empty()) {                  // highest priority first, FIFO among equals
+      size_t w = 0;
+      for (size_t i = 1; i < s->waiters.size(); i++)
+        if (s->waiters[i]->prio > s->waiters[w]->prio) w = i;
+      Task* next = s->waiters[w];
+      s->waiters.erase(s->waiters.begin() + w);
+      wake(next);
+    }
+    yieldIfPreempted();
+    return true;
+  }
+
+  uint32_t notifyTake(bool clear, Time deadline) {
+    Task* t = self();
+    if (!t) return 0;
+    if (!t->notify && deadline > clock) {
+      t->waitNotify = true;
+      block(t, deadline);
+    }
+    uint32_t v = t->notify;
+    if (v) t->notify = clear ? 0 : v - 1;
+    return v;
+  }
+
+  void notifyGive(Task* t) {
+    if (!t) return;
+    t->notify++;
+    if (t->state == Task::BLOCKED && t->waitNotify) wake(t);
+    yieldIfPreempted();
+  }
+
+  void attachInterrupt(uint8_t pin, void (*isr)(), int) {
+    if (pin >= PINS) return;
+    pins[pin].isr = isr;
+    pins[pin].core = core();                // the GPIO interrupt is allocated on the calling core
+  }
+
+  void detachInterrupt(uint8_t pin) { if (pin < PINS) pins[pin].isr = nullptr; }
+  int pinLevel(uint8_t pin) { return pin < PINS ? pins[pin].level : 0; }
+
+  int interruptPin() {
+    for (uint8_t i = 0; i < PINS; i++) if (pins[i].isr) return i;
+    return -1;
+  }
+
+  void setCpuMhz(uint32_t m) {
+    mhz = m ? m : 240;
+    trace.counter("CPU MHz", clock, mhz);
+  }
+  uint32_t cpuMhz() { return mhz; }
+  void enableWakeOnPin(bool on) { wakeOnPin = on; }
+
+  // Both cores stop: nothing is dispatched until a pin edge (+ config.wakeUs) or maxUs
+  bool lightSleep(Time maxUs) {
+    Task* t = self();
+    if (!t) return false;
+    payDebt(t);
+    stats.sleeps++;
+    asleep = true;
+    wokenByPin = false;
+    sleepStart = clock;
+    sleepEnd = clock + maxUs;
+    for (int c = 0; c < CORES; c++)
+      if (running[c] && running[c] != t && !running[c]->busyLeft) preempt(running[c]);
+    sleeper = t;
+    block(t, NEVER);
+    return wokenByPin;
+  }
+
+  // ================= for the harness =================
+  void at(Time t, std::function<void()> fn) {
+    Event e;
+    e.t = t < clock ? clock : t;
+    e.seq = ++seq;
+    e.fn = fn;
+    events.push(e);
+  }
+
+  void setPin(uint8_t pin, int level) {
+    if (pin >= PINS) return;
+    Pin& p = pins[pin];
+    if (p.level == level) return;
+    p.level = level;
+    if (!p.isr) return;
+    if (asleep) {                               // GPIO wakeup is by level; the edge itself is gone
+      stats.edgesAsleep++;
+      if (wakeOnPin && !wokenByPin) {
+        wokenByPin = true;
+        stats.pinWakes++;
+        if (clock + config.wakeUs < sleepEnd) sleepEnd = clock + config.wakeUs;
+      }
+      return;
+    }
+    Task* cur = running[p.core];
+    if (cur && cur->masked && cur->busyLeft) {  // interrupts off: one pending bit per pin
+      if (p.pending) stats.mergedEdges++;
+      else { p.pending = true; p.pendingSince = clock; }
+      return;
+    }
+    runIsr(p);
+  }
+
+  void start(void (*setup)(), void (*loop)()) {
+    loopSetup = setup;
+    loopFn = loop;
+    static const char* const NAMES[CORES] = { "core 0", "core 1" };
+    for (int c = 0; c < CORES; c++) trace.thread(TRACK_CORE + c, NAMES[c], c);
+    trace.counter("CPU MHz", 0, mhz);
+    createTask(loopTask, "loopTask", nullptr, 1, 1);
+  }
+
+  void run(Time until) {
+    uint32_t spins = 0;
+    Time spinAt = NEVER;
+    for (;;) {
+      dispatch();
+      while (!resumeQ.empty()) {
+        Task* t = resumeQ.front();
+        resumeQ.pop_front();
+        t->queued = false;
+        if (t->state != Task::RUNNING || t->busyLeft) continue;
+        if (spinAt != clock) { spinAt = clock; spins = 0; }
+        if (++spins > LIVELOCK) {
+          fprintf(stderr, "livelock at %.6f s: %s keeps running without blocking\n", clock / 1e6, t->name.c_str());
+          exit(3);
+        }
+        resume(t);
+        dispatch();
+        if (t->state == Task::RUNNING && !t->busyLeft) push(t);   // yielded
+      }
+      if (clock >= until) break;
+
+      Time next = until;
+      for (int c = 0; c < CORES; c++)
+        if (running[c] && running[c]->busyLeft && clock + running[c]->busyLeft < next) next = clock + running[c]->busyLeft;
+      for (Task* t : all)
+        if (t->state == Task::BLOCKED && t->wakeAt < next) next = t->wakeAt;
+      if (!events.empty() && events.top().t < next) next = events.top().t;
+      if (asleep && sleepEnd < next) next = sleepEnd;
+      bool slicing = false;
+      for (int c = 0; c < CORES; c++) slicing = slicing || sliceDue(c);
+      if (slicing && (clock / 1000 + 1) * 1000 < next) next = (clock / 1000 + 1) * 1000;
+
+      advance(next);
+      if (asleep && clock >= sleepEnd) endSleep();
+      while (!events.empty() && events.top().t <= clock) {
+        Event e = events.top();
+        events.pop();
+        e.fn();
+      }
+      for (Task* t : all) {
+        if (t->state != Task::BLOCKED || t->wakeAt > clock) continue;
+        t->timedOut = true;
+        wake(t);
+      }
+      if (slicing && clock % 1000 == 0) {
+        for (int c = 0; c < CORES; c++) {
+          if (!sliceDue(c)) continue;
+          Task* b = best(c);
+          preempt(running[c]);
+          startOn(b, c);
+        }
+      }
+    }
+    for (Task* t : all) mark(t, t->mark, t->markSem);   // flush open slices into the trace
+  }
+
+  const std::vector<Task*>& tasks() { return all; }
+  const std::vector<Semaphore*>& semaphores() { return sems; }
+
+} // namespace Sim
+
+// ================= FreeRTOS API =================
+using Sim::Task;
+
+BaseType_t xTaskCreatePinnedToCore(TaskFunction_t fn, const char* name, uint32_t, void* arg, UBaseType_t prio,
+                                   TaskHandle_t* handle, BaseType_t core) {
+  Task* t = Sim::createTask(fn, name, arg, (uint8_t)prio, core == tskNO_AFFINITY ? Sim::ANY_CORE : (int)core);
+  if (handle) *handle = t;
+  return pdPASS;
+}
+
+BaseType_t xTaskCreate(TaskFunction_t fn, const char* name, uint32_t stack, void* arg, UBaseType_t prio, TaskHandle_t* handle) {
+  return xTaskCreatePinnedToCore(fn, name, stack, arg, prio, handle, tskNO_AFFINITY);
+}
+
+void vTaskDelete(TaskHandle_t t) { Sim::deleteTask(t); }
+void vTaskDelay(TickType_t ticks) { Sim::delayTicks(ticks); }
+TickType_t xTaskGetTickCount() { return (TickType_t)(Sim::now() / 1000); }
+BaseType_t xPortGetCoreID() { return Sim::core(); }
+
+uint32_t ulTaskNotifyTake(BaseType_t clear, TickType_t ticks) {
+  return Sim::notifyTake(clear != pdFALSE, ticks ? Sim::tickDeadline(ticks) : Sim::now());
+}
+
+BaseType_t xTaskNotifyGive(TaskHandle_t t) { Sim::notifyGive(t); return pdPASS; }
+
+void vTaskNotifyGiveFromISR(TaskHandle_t t, BaseType_t* woken) {
+  Sim::notifyGive(t);
+  if (woken) *woken = pdTRUE;
+}
+
+SemaphoreHandle_t xSemaphoreCreateMutex() { return Sim::createSemaphore(true, 1, 1); }
+SemaphoreHandle_t xSemaphoreCreateBinary() { return Sim::createSemaphore(false, 1, 0); }
+SemaphoreHandle_t xSemaphoreCreateCounting(UBaseType_t max, UBaseType_t initial) {
+  return Sim::createSemaphore(false, max, initial);
+}
+
+BaseType_t xSemaphoreTake(SemaphoreHandle_t s, TickType_t ticks) {
+  if (!s) return pdFALSE;
+  return Sim::take(s, ticks ? Sim::tickDeadline(ticks) : Sim::now()) ? pdTRUE : pdFALSE;
+}
+
+BaseType_t xSemaphoreGive(SemaphoreHandle_t s) { return s && Sim::give(s) ? pdTRUE : pdFALSE; }
+
+BaseType_t xSemaphoreGiveFromISR(SemaphoreHandle_t s, BaseType_t* woken) {
+  if (woken) *woken = pdTRUE;
+  return xSemaphoreGive(s);
+}
+
+// Task code takes no time, so a masked section never overlaps an edge;
+// only busy(.., true) (strip.show()) holds interrupts off
+uint32_t portSET_INTERRUPT_MASK_FROM_ISR() { return 0; }
+void portCLEAR_INTERRUPT_MASK_FROM_ISR(uint32_t) {}
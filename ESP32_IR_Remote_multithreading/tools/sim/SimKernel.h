@@ -0,0 +1,201 @@
+/*
+SimKernel.h — a virtual-time ESP32 (two cores, FreeRTOS scheduler) for ir_sim
+- Every FreeRTOS task of src/main.cpp is a coroutine (ucontext) on one PC
+  thread. Task code itself takes no device time; time only passes where the
+  shims in include/ say so (strip.show(), delayMicroseconds(), the UART, the
+  I2S DMA, flash writes, light sleep) or, with Config::cpuScale, as measured
+  PC time scaled to the ESP32.
+- Scheduling as on the ESP32: per core the highest-priority ready task runs,
+  a higher one preempts it (not while that core has interrupts off), equal
+  priorities share a busy core per 1 ms tick, delays and timeouts end on
+  ticks, a mutex lends its holder the priority of the highest waiter.
+- A pin interrupt runs on the core that attached it. While that core has
+  interrupts off, further edges on the pin collapse into one pending
+  interrupt, as in the GPIO status register.
+- Nothing here knows main.cpp; ir_sim.cpp schedules the inputs (at()),
+  listens through Hooks and calls run().
+*/
+
+#ifndef SIM_KERNEL_H
+#define SIM_KERNEL_H
+
+#include <stdint.h>
+#include <stdio.h>
+#include <ucontext.h>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace Sim {
+
+  typedef uint64_t Time;                    // us since power-on
+  const Time NEVER = ~(Time)0;
+  const uint8_t CORES = 2;
+  const int ANY_CORE = -1;
+  const uint8_t PINS = 40;
+
+  // Device model; ir_sim.cpp sets it from the command line
+  struct Config {
+    uint32_t ledNs    = 30000;   // WS2812 at 800 kHz: 24 bits x 1.25 us per LED
+    uint32_t latchUs  = 300;     // Adafruit_NeoPixel: gap after the previous show()
+    bool     blackout = false;   // false: RMT sends, the task waits; true: bit-banged, interrupts off
+    uint32_t isrUs    = 2;       // GPIO interrupt entry + handler, taken from the task
+    uint32_t wakeUs   = 500;     // light sleep: pin edge until the cores run again
+    uint32_t flashUs  = 4000;    // one NVS write (erase + program)
+    double   cpuScale = 0;       // > 0: PC time of task code x this = ESP32 time at 240 MHz
+  };
+  extern Config config;
+
+  struct Task;
+  struct Semaphore;
+
+  // What the kernel tells the harness
+  struct Hooks {
+    void (*show)(Time start, Time end, const uint8_t* pixels, uint16_t leds) = nullptr;  // strip.show() sent
+    void (*serial)(uint8_t port, Time t, const char* line) = nullptr;    // one line left the UART buffer
+    void (*take)(Semaphore* s, Task* t) = nullptr;                      // t got s
+    void (*give)(Semaphore* s, Task* t) = nullptr;                      // t gave s back
+  };
+  extern Hooks hooks;
+
+  struct WaitStats {
+    uint64_t count = 0;
+    Time total = 0, max = 0;
+    void add(Time us) { count++; total += us; if (us > max) max = us; }
+  };
+
+  struct Task {
+    enum State : uint8_t { READY, RUNNING, BLOCKED, DONE };
+    std::string name;
+    uint16_t id = 0;
+    uint8_t  prio = 0, basePrio = 0;
+    int      affinity = ANY_CORE;
+    int      core = -1;            // where it runs now, -1 = not running
+    int      lastCore = -1;
+    State    state = READY;
+    Semaphore* sem = nullptr;      // blocked on it
+    bool     waitNotify = false;
+    Time     wakeAt = NEVER;       // delay end / timeout
+    bool     timedOut = false;
+    uint32_t notify = 0;
+    Time     busyLeft = 0;         // device time still to spend on the core
+    bool     masked = false;       // ... with interrupts off
+    const char* busyWhat = "";
+    uint64_t readySeq = 0;
+    bool     queued = false;
+
+    // statistics
+    Time      cpu[CORES] = {};     // busy time per core
+    uint64_t  runs = 0, preemptions = 0;
+    WaitStats ready;               // ready, waiting for a core
+    Time      readyAt = 0;
+
+    // coroutine
+    void (*fn)(void*) = nullptr;
+    void* arg = nullptr;
+    ucontext_t ctx;
+    std::vector<char> stack;
+    uint64_t sliceStartNs = 0, debtNs = 0;
+    const char* mark = nullptr;    // open slice on the task's trace track
+    Semaphore* markSem = nullptr;  // ... waiting for this mutex
+    Time markAt = 0;
+  };
+
+  struct Semaphore {
+    std::string name;
+    bool     mutex = false;
+    uint32_t count = 0, max = 1;
+    Task*    holder = nullptr;
+    std::vector<Task*> waiters;
+    uint64_t takes = 0, contended = 0;
+    std::vector<std::pair<Task*, WaitStats> > waits;   // per task that had to wait
+    WaitStats& waitsOf(Task* t);
+  };
+
+  // Chrome trace event format (chrome://tracing, ui.perfetto.dev): only what
+  // overlaps [from, to) is written, so hours can run with a short window
+  class Trace {
+  public:
+    bool open(const char* path, Time from, Time len);
+    void close();
+    bool active() const { return f != nullptr; }
+    bool covers(Time start, Time end) const { return f && end >= from && start < to; }
+    void thread(int tid, const char* name, int order);
+    void slice(int tid, const char* name, Time start, Time dur, const char* args = nullptr);
+    void instant(int tid, const char* name, Time t, const char* args = nullptr);
+    void counter(const char* name, Time t, double value);
+  private:
+    void event(const char* json);
+    FILE* f = nullptr;
+    Time from = 0, to = 0;
+    bool first = true;
+  };
+  extern Trace trace;
+
+  // Track ids in the trace
+  const int TRACK_CORE = 0;                 // + core
+  const int TRACK_INPUT = 10;               // IR frames and decoded buttons
+  const int TRACK_TASK = 100;               // + task id
+
+  // --- for the shims (task context unless noted) ---
+  Time now();                               // also from an interrupt
+  Task* self();                             // nullptr in an interrupt
+  int core();                               // of the running task or interrupt
+  bool inIsr();
+  void busy(Time us, bool masked = false, const char* what = "cpu");   // spend CPU time
+  void yield();
+  Time tickDeadline(uint32_t ticks);        // end of a delay of that many 1 ms ticks
+  void sleepUntil(Time t);                  // block (core free for others)
+  bool delayTicks(uint32_t ticks);
+
+  Task* createTask(void (*fn)(void*), const char* name, void* arg, uint8_t prio, int core);
+  void deleteTask(Task* t);
+
+  Semaphore* createSemaphore(bool mutex, uint32_t max, uint32_t initial);
+  bool take(Semaphore* s, Time deadline);   // deadline: now() = do not wait, NEVER = forever
+  bool give(Semaphore* s);                  // also from an interrupt
+  uint32_t notifyTake(bool clear, Time deadline);
+  void notifyGive(Task* t);                 // also from an interrupt
+
+  void attachInterrupt(uint8_t pin, void (*isr)(), int mode);
+  void detachInterrupt(uint8_t pin);
+  int pinLevel(uint8_t pin);
+  int interruptPin();                       // first pin with an interrupt, -1 = none
+
+  void setCpuMhz(uint32_t mhz);
+  uint32_t cpuMhz();
+  void enableWakeOnPin(bool on);
+  bool lightSleep(Time maxUs);              // true = woken by a pin
+
+  // --- for the harness ---
+  void at(Time t, std::function<void()> fn);   // runs in scheduler context at t
+  void setPin(uint8_t pin, int level);         // an edge: runs (or pends) the pin's interrupt
+  void start(void (*setup)(), void (*loop)());  // Arduino loopTask: core 1, priority 1
+  void run(Time until);
+  const std::vector<Task*>& tasks();
+  const std::vector<Semaphore*>& semaphores();
+
+  struct Stats {
+    Time coreBusy[CORES] = {};
+    Time maxBusyStretch[CORES] = {};        // core never idle this long (task watchdog: 5 s)
+    Time sleepUs = 0;
+    uint64_t sleeps = 0, pinWakes = 0;
+    uint64_t interrupts = 0, lateInterrupts = 0, mergedEdges = 0, edgesAsleep = 0;
+    Time maxInterruptDelay = 0;
+    Time mhzTime[3] = {};                   // at 240 / 160 / 80 MHz and below
+    uint64_t switches = 0;
+    // SimArduino.cpp
+    uint64_t shows = 0, nvsWrites = 0, uartLines = 0, i2sOverruns = 0, espNowSends = 0;
+    Time showUs = 0, uartBlockedUs = 0;
+  };
+  extern Stats stats;
+
+  // --- device inputs and outputs (SimArduino.cpp) ---
+  enum AudioSource : uint8_t { AUDIO_SILENT, AUDIO_NOISE, AUDIO_BEAT };
+  void setAudio(AudioSource src, float bpm = 120);   // what the microphone hears from now on
+  void setSerialLog(FILE* f);                        // UART bytes as sent, nullptr = none
+  void seedRandom(uint32_t seed);                    // esp_random(), analogRead() noise
+
+} // namespace Sim
+
+#endif // SIM_KERNEL_H
@@ -0,0 +1,38 @@
+// Adafruit_NeoPixel.h for ir_sim: show() returns after the strip's transmit
+// time; the task waits (RMT) or the core spins with interrupts off (-blackout)
+#ifndef SIM_ADAFRUIT_NEOPIXEL_H
+#define SIM_ADAFRUIT_NEOPIXEL_H
+
+#include "Arduino.h"
+#include <vector>
+
+#define NEO_RGB    0x06
+#define NEO_GRB    0x52
+#define NEO_KHZ800 0x0000
+#define NEO_KHZ400 0x0100
+
+class Adafruit_NeoPixel {
+public:
+  Adafruit_NeoPixel(uint16_t n, int16_t pin = 6, uint16_t type = NEO_GRB + NEO_KHZ800) : px(n * 3), pin(pin) { (void)type; }
+  void begin() {}
+  void show();
+  bool canShow() const;
+  void clear() { std::fill(px.begin(), px.end(), 0); }
+  void setPixelColor(uint16_t i, uint8_t r, uint8_t g, uint8_t b) {
+    if (i * 3 >= px.size()) return;
+    px[i * 3] = g; px[i * 3 + 1] = r; px[i * 3 + 2] = b;
+  }
+  void setPixelColor(uint16_t i, uint32_t c) { setPixelColor(i, (uint8_t)(c >> 16), (uint8_t)(c >> 8), (uint8_t)c); }
+  void setBrightness(uint8_t b) { bright = b; }
+  uint8_t getBrightness() const { return bright; }
+  uint8_t* getPixels() { return px.data(); }
+  uint16_t numPixels() const { return (uint16_t)(px.size() / 3); }
+  static uint32_t Color(uint8_t r, uint8_t g, uint8_t b) { return (uint32_t)r << 16 | (uint32_t)g << 8 | b; }
+private:
+  std::vector<uint8_t> px;
+  int16_t pin;
+  uint8_t bright = 0;
+  uint64_t endUs = 0;                   // end of the last transmission
+};
+
+#endif // SIM_ADAFRUIT_NEOPIXEL_H
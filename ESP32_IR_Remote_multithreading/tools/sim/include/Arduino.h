@@ -0,0 +1,100 @@
+// Arduino.h for ir_sim: what src/main.cpp and the shared libraries use of
+// the ESP32 Arduino core, on virtual time (SimArduino.cpp)
+#ifndef SIM_ARDUINO_H
+#define SIM_ARDUINO_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+#include <math.h>
+#include <algorithm>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/semphr.h"
+#include "esp_system.h"
+#include "esp_timer.h"
+
+using std::min;
+using std::max;
+
+typedef uint8_t byte;
+
+#define HIGH            1
+#define LOW             0
+#define INPUT           1
+#define OUTPUT          3
+#define INPUT_PULLUP    5
+#define RISING          1
+#define FALLING         2
+#define CHANGE          3
+#define A0              36
+#define HEX             16
+#define DEC             10
+#define IRAM_ATTR
+#define F(s)            (s)
+#define digitalPinToInterrupt(p) (p)
+
+// millis() and micros() are 32 bits as on the ESP32 (micros() wraps after
+// 71.6 min); unsigned long is 64 bits on the PC, so sums do not wrap
+unsigned long millis();
+unsigned long micros();
+void delay(uint32_t ms);
+void delayMicroseconds(uint32_t us);
+void yield();
+
+void pinMode(uint8_t pin, uint8_t mode);
+int digitalRead(uint8_t pin);
+void digitalWrite(uint8_t pin, uint8_t level);
+uint16_t analogRead(uint8_t pin);
+void attachInterrupt(uint8_t pin, void (*isr)(), int mode);
+void detachInterrupt(uint8_t pin);
+
+long random(long max);
+long random(long min, long max);
+void randomSeed(unsigned long seed);
+uint32_t esp_random();
+
+bool setCpuFrequencyMhz(uint32_t mhz);
+uint32_t getCpuFrequencyMhz();
+bool psramFound();
+void* ps_malloc(size_t n);
+
+class Print {
+public:
+  virtual ~Print() {}
+  virtual size_t write(uint8_t b) = 0;
+  virtual size_t write(const uint8_t* buf, size_t n);
+  size_t print(const char* s) { return write((const uint8_t*)s, strlen(s)); }
+  size_t print(long v, int base = DEC);
+  size_t println(const char* s) { return print(s) + println(); }
+  size_t println(long v, int base = DEC) { return print(v, base) + println(); }
+  size_t println() { return print("\r\n"); }
+  size_t printf(const char* f, ...) __attribute__((format(printf, 2, 3)));
+};
+
+// UART with the 128-byte hardware FIFO: write() waits while it is full
+class HardwareSerial : public Print {
+public:
+  explicit HardwareSerial(uint8_t port) : port(port) {}
+  void begin(unsigned long baud) { byteNs = 10000000000ULL / baud; }
+  size_t write(uint8_t b) override { return write(&b, 1); }
+  size_t write(const uint8_t* buf, size_t n) override;
+  void flush();                         // until the last byte has left
+  int available() { return 0; }
+  int read() { return -1; }
+  using Print::print;
+  using Print::println;
+private:
+  uint8_t port;
+  uint64_t byteNs = 86806;              // 115200 Bd, 10 bits per byte
+  uint64_t freeAtNs = 0;                // the FIFO is empty from then on
+  char line[256];
+  size_t lineLen = 0;
+};
+
+extern HardwareSerial Serial;
+extern HardwareSerial Serial2;
+
+#endif // SIM_ARDUINO_H
@@ -0,0 +1,27 @@
+// Preferences.h for ir_sim: NVS in memory, a write costs Config::flashUs
+#ifndef SIM_PREFERENCES_H
+#define SIM_PREFERENCES_H
+
+#include "Arduino.h"
+#include <map>
+#include <string>
+#include <vector>
+
+class Preferences {
+public:
+  bool begin(const char* name, bool readOnly = false) { ns = name; (void)readOnly; return true; }
+  void end() {}
+  size_t getBytesLength(const char* key);
+  size_t getBytes(const char* key, void* buf, size_t len);
+  size_t putBytes(const char* key, const void* buf, size_t len);
+  uint8_t getUChar(const char* key, uint8_t def = 0) { uint8_t v = def; getBytes(key, &v, 1); return v; }
+  size_t putUChar(const char* key, uint8_t v) { return putBytes(key, &v, 1); }
+  uint16_t getUShort(const char* key, uint16_t def = 0) { uint16_t v = def; getBytes(key, &v, 2); return v; }
+  size_t putUShort(const char* key, uint16_t v) { return putBytes(key, &v, 2); }
+  bool remove(const char* key) { return store().erase(ns + "/" + key) > 0; }
+private:
+  static std::map<std::string, std::vector<uint8_t> >& store();   // all namespaces, survives end()
+  std::string ns;
+};
+
+#endif // SIM_PREFERENCES_H
@@ -0,0 +1,22 @@
+// WiFi.h for ir_sim: only the mode switch MySync needs before ESP-NOW
+#ifndef SIM_WIFI_H
+#define SIM_WIFI_H
+
+#include "Arduino.h"
+#include "esp_wifi.h"
+
+#define WIFI_OFF    0
+#define WIFI_STA    1
+#define WIFI_AP     2
+
+class WiFiClass {
+public:
+  bool mode(int m) { current = m; return true; }
+  int getMode() const { return current; }
+private:
+  int current = WIFI_OFF;
+};
+
+extern WiFiClass WiFi;
+
+#endif // SIM_WIFI_H
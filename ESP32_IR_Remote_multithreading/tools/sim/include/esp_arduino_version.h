@@ -0,0 +1,9 @@
+// esp_arduino_version.h for ir_sim: the 3.x core API (esp_now receive callback)
+#ifndef SIM_ESP_ARDUINO_VERSION_H
+#define SIM_ESP_ARDUINO_VERSION_H
+
+#define ESP_ARDUINO_VERSION_MAJOR 3
+#define ESP_ARDUINO_VERSION_MINOR 0
+#define ESP_ARDUINO_VERSION_PATCH 0
+
+#endif // SIM_ESP_ARDUINO_VERSION_H
@@ -0,0 +1,34 @@
+// esp_now.h for ir_sim: one controller, so sends are only counted and
+// nothing is ever received
+#ifndef SIM_ESP_NOW_H
+#define SIM_ESP_NOW_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include "esp_wifi.h"
+
+typedef enum { ESP_NOW_SEND_SUCCESS = 0, ESP_NOW_SEND_FAIL } esp_now_send_status_t;
+
+typedef struct {
+  uint8_t* src_addr;
+  uint8_t* des_addr;
+} esp_now_recv_info_t;
+
+typedef struct {
+  uint8_t peer_addr[6];
+  uint8_t lmk[16];
+  uint8_t channel;
+  wifi_interface_t ifidx;
+  bool encrypt;
+  void* priv;
+} esp_now_peer_info_t;
+
+typedef void (*esp_now_recv_cb_t)(const esp_now_recv_info_t* info, const uint8_t* data, int len);
+
+esp_err_t esp_now_init();
+esp_err_t esp_now_register_recv_cb(esp_now_recv_cb_t cb);
+bool esp_now_is_peer_exist(const uint8_t* mac);
+esp_err_t esp_now_add_peer(const esp_now_peer_info_t* peer);
+esp_err_t esp_now_send(const uint8_t* mac, const uint8_t* data, size_t len);
+
+#endif // SIM_ESP_NOW_H
@@ -0,0 +1,9 @@
+// esp_timer.h for ir_sim: us since power-on, in virtual time
+#ifndef SIM_ESP_TIMER_H
+#define SIM_ESP_TIMER_H
+
+#include <stdint.h>
+
+int64_t esp_timer_get_time();
+
+#endif // SIM_ESP_TIMER_H
@@ -0,0 +1,34 @@
+// freertos/FreeRTOS.h for ir_sim: types and macros; the kernel is SimKernel.cpp
+#ifndef SIM_FREERTOS_H
+#define SIM_FREERTOS_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+namespace Sim { struct Task; struct Semaphore; }
+
+typedef uint32_t TickType_t;
+typedef int BaseType_t;
+typedef unsigned UBaseType_t;
+typedef Sim::Task* TaskHandle_t;
+typedef Sim::Semaphore* SemaphoreHandle_t;
+typedef void (*TaskFunction_t)(void*);
+
+#define pdTRUE              1
+#define pdFALSE             0
+#define pdPASS              1
+#define pdFAIL              0
+#define portMAX_DELAY       ((TickType_t)0xFFFFFFFFUL)
+#define portTICK_PERIOD_MS  1
+#define pdMS_TO_TICKS(ms)   ((TickType_t)(ms))
+#define portNUM_PROCESSORS  2
+#define tskIDLE_PRIORITY    0
+#define tskNO_AFFINITY      0x7FFFFFFF
+#define configMAX_PRIORITIES 25
+#define portYIELD_FROM_ISR()  do {} while (0)   // the switch happens when the interrupt returns
+
+BaseType_t xPortGetCoreID();
+uint32_t portSET_INTERRUPT_MASK_FROM_ISR();
+void portCLEAR_INTERRUPT_MASK_FROM_ISR(uint32_t state);
+
+#endif // SIM_FREERTOS_H
@@ -0,0 +1,510 @@
+/*
+ir_sim.cpp — runs src/main.cpp unchanged on a virtual-time ESP32 (SimKernel.h)
+- Both cores, the FreeRTOS priorities and mutexes, strip.show() (RMT as
+  Adafruit_NeoPixel does on the ESP32, or -blackout: bit-banged with
+  interrupts off on its core), the UART FIFO, the I2S DMA and light sleep
+  are modelled; the sketch's own code takes no device time unless -cpu is
+  given. An hour of device time runs in seconds.
+- IR input is a script of button presses (NEC, RC5 or Sony timings from
+  MyIRcodes/IRDecoder.h, held buttons repeat as the remote does) or, without
+  a script, a random soak: a press every -soak ms on average, some held.
+- Every press is followed through the sketch: when IRTask takes dataMutex for
+  it (press -> handled, from the end of its first frame), and the end of the
+  first strip.show() after LEDTask's next pass under the mutex (press ->
+  photon). Not handled before the next press = lost; the "IR <button>" log
+  line is checked against what was pressed.
+- Prints CPU per task and core, ready and mutex waits, latency percentiles,
+  frame intervals, late and merged IR interrupts, the longest time a core was
+  never idle; -trace writes a window as Chrome trace JSON (ui.perfetto.dev).
+- -max-latency / -max-photon: exit 2 when a press is lost or the p99 is over
+  the limit, for a regression check after changing the sketch.
+- The numbers are a model, not measurements on a board: README.md says which
+  ones carry over (counts) and which are assumed (durations, light sleep).
+
+Build and run (from this folder):
+  L=../../../Arduino_custom_library_demo_IR_remote
+  g++ -O2 -std=gnu++11 -Wall -Wextra -DARDUINO=100 -DESP32 -Iinclude -I. -I../../include -I$L/MyIRcodes -I$L/MyShows \
+      -I$L/MyLog -I$L/MyPower -I$L/MyBoot -I$L/MySync ../../src/main.cpp SimKernel.cpp SimArduino.cpp ir_sim.cpp -o ir_sim
+  ./ir_sim -t 3600                          an hour of random presses, summary
+  ./ir_sim presses.txt -trace t.json        a script, first 10 s as a trace
+  ./ir_sim -t 600 -max-latency 50           fail on a slow or lost press (CI)
+  ./ir_sim s.txt -blackout                  show() bit-banged with interrupts off instead of RMT
+Script lines (times in ms of device time, # = comment):
+  1500 UP                  NEC press (also: ONE..NINE, ZERO, STAR, HASH, LEFT, RIGHT, OK, DOWN or 1, *, #)
+  3000 UP nec hold 2000    held 2 s (rc5 / sirc for the other remotes)
+  8000 raw 9000 4500 560   edge durations from a mark, e.g. noise or a foreign remote
+  9000 audio beat 128      microphone: off | noise | beat <bpm>
+*/
+
+#include "SimKernel.h"
+#include <Arduino.h>
+#include <MyIRcodes.h>
+#include <IRDecoder.h>
+#include <algorithm>
+#include <chrono>
+#include <memory>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <vector>
+
+void setup();
+void loop();
+extern TaskHandle_t irTaskHandle, ledTaskHandle;
+extern SemaphoreHandle_t dataMutex, ledWake;
+
+using Sim::Time;
+
+// One button press: the frames it sends and what became of it
+struct Press {
+  Time at = 0;
+  MyIR::Button button = MyIR::BTN_NONE;
+  MyIR::Protocol proto = MyIR::PROTO_NEC;
+  uint32_t holdMs = 0;
+  std::vector<uint32_t> raw;            // "raw": one frame of these durations, nothing tracked
+  Time firstFrameEnd = Sim::NEVER;
+  Time handledAt = Sim::NEVER;
+  uint32_t repeats = 0;
+};
+
+struct Options {
+  double seconds = 60;
+  uint32_t seed = 1;
+  uint32_t soakMs = 0;
+  const char* script = nullptr;
+  const char* tracePath = nullptr;
+  double traceFrom = 0, traceLen = 10;
+  const char* logPath = nullptr;
+  uint32_t jitterUs = 0;
+  bool csv = false;
+  double maxLatencyMs = 0, maxPhotonMs = 0;
+} opt;
+
+static std::vector<Press*> presses;
+static Press* current = nullptr;         // last press whose first frame started
+static Press* photonFor = nullptr;       // handled, waiting for LEDTask's pass and a show
+static bool photonArmed = false;
+static std::vector<uint32_t> handledUs, photonUs, showGapUs;
+static std::vector<std::string> expected; // button names of handled presses, for the log lines
+static uint64_t lost = 0, wrong = 0, spurious = 0, unseen = 0, logDropped = 0, logErrors = 0, logWarnings = 0;
+static Time lastShowStart = Sim::NEVER;
+static uint32_t rng = 1;
+static const Time PHOTON_MAX = 2000000;  // a later show is not the press's
+static uint8_t rc5Toggle = 0;
+
+static uint32_t rnd() { rng ^= rng << 13; rng ^= rng >> 17; rng ^= rng << 5; return rng; }
+static uint32_t rnd(uint32_t lo, uint32_t hi) { return lo + rnd() % (hi - lo + 1); }
+
+// ================= IR frames =================
+static uint8_t cmdFor(MyIR::Button b, MyIR::Protocol p) {
+  if (p == MyIR::PROTO_RC5) return MYIR_READ8(&MyIR::detail::CMD_RC5[b]);
+  if (p == MyIR::PROTO_SIRC) return MYIR_READ8(&MyIR::detail::CMD_SIRC[b]);
+  return MyIR::command(b);
+}
+
+static const MyIR::Timing& timing(MyIR::Protocol p) {
+  for (uint8_t i = 0; i < MyIR::PROTOCOL_COUNT; i++) if (MyIR::PROTOCOLS[i].proto == p) return MyIR::PROTOCOLS[i];
+  return MyIR::PROTOCOLS[0];
+}
+
+// Mark and space durations of one frame, starting with a mark
+static std::vector<uint32_t> frame(const Press& p, bool repeat) {
+  const MyIR::Timing& t = timing(p.proto);
+  std::vector<uint32_t> d;
+  uint8_t cmd = cmdFor(p.button, p.proto);
+  if (p.proto == MyIR::PROTO_NEC) {
+    d.push_back(t.hdrMark);
+    if (repeat) {                                         // 9 ms, 2.25 ms, stop mark: "still held"
+      d.push_back(t.rptSpace);
+      d.push_back(t.unit);
+      return d;
+    }
+    d.push_back(t.hdrSpace);
+    uint32_t bits = MyIR::necRaw(cmd);
+    for (uint8_t i = 0; i < 32; i++) {
+      d.push_back(t.unit);
+      d.push_back((bits >> i) & 1 ? t.one : t.zero);
+    }
+    d.push_back(t.unit);
+  } else if (p.proto == MyIR::PROTO_SIRC) {               // 7 command bits, 5 address bits (TV = 1), LSB first
+    uint32_t bits = (cmd & 0x7F) | (1u << 7);
+    d.push_back(t.hdrMark);
+    for (uint8_t i = 0; i < 12; i++) {
+      d.push_back(t.hdrSpace);
+      d.push_back((bits >> i) & 1 ? t.one : t.zero);
+    }
+  } else {                                                // RC5: S1, S2, toggle, 5 address, 6 command, MSB first
+    uint32_t bits = (1u << 13) | ((cmd & 0x40) ? 0 : 1u << 12) | ((uint32_t)rc5Toggle << 11) | (cmd & 0x3F);
+    std::vector<bool> halves;                             // 1 = (space, mark), 0 = (mark, space)
+    for (int8_t i = 13; i >= 0; i--) {
+      bool one = (bits >> i) & 1;
+      halves.push_back(!one);
+      halves.push_back(one);
+    }
+    size_t i = 1;                                         // the start bit's space is idle
+    while (i < halves.size()) {
+      size_t j = i;
+      while (j < halves.size() && halves[j] == halves[i]) j++;
+      if (j == halves.size() && !halves[i]) break;        // trailing space = idle
+      d.push_back((uint32_t)(j - i) * t.unit);
+      i = j;
+    }
+  }
+  return d;
+}
+
+// Frame period while held and the number of frames of a short tap
+static void cadence(MyIR::Protocol p, uint32_t& periodMs, uint8_t& minFrames) {
+  periodMs = p == MyIR::PROTO_NEC ? 108 : p == MyIR::PROTO_RC5 ? 114 : 45;
+  minFrames = p == MyIR::PROTO_SIRC ? 3 : 1;
+}
+
+// Edges of a frame one after the other on the receiver pin (LOW = IR light)
+struct Edges {
+  std::vector<uint32_t> d;
+  size_t i = 0;
+  int pin = -1;
+};
+
+static void edge(std::shared_ptr<Edges> e) {
+  Sim::setPin((uint8_t)e->pin, (e->i % 2) ? HIGH : LOW);
+  if (e->i == e->d.size()) return;
+  int32_t us = (int32_t)e->d[e->i++];
+  if (opt.jitterUs) us += (int32_t)rnd(0, 2 * opt.jitterUs) - (int32_t)opt.jitterUs;
+  Sim::at(Sim::now() + (us > 1 ? us : 1), [e] { edge(e); });
+}
+
+// Returns the end of the frame
+static Time sendFrame(const std::vector<uint32_t>& d, const char* name, uint32_t index) {
+  int pin = Sim::interruptPin();
+  Time start = Sim::now(), end = start;
+  for (uint32_t us : d) end += us;
+  if (pin < 0 || d.empty()) return end;
+  std::shared_ptr<Edges> e(new Edges());
+  e->d = d;
+  e->pin = pin;
+  edge(e);
+  if (Sim::trace.covers(start, end)) {
+    char args[32];
+    snprintf(args, sizeof(args), "{\"press\":%u}", index);
+    Sim::trace.slice(Sim::TRACK_INPUT, name, start, end - start, args);
+  }
+  return end;
+}
+
+static void frameOf(Press* p, uint32_t n) {
+  uint32_t periodMs;
+  uint8_t minFrames;
+  cadence(p->proto, periodMs, minFrames);
+  bool necRepeat = p->proto == MyIR::PROTO_NEC && n > 0;
+  char name[40];
+  snprintf(name, sizeof(name), "%s %s%s", MyIR::name(p->button),
+           p->proto == MyIR::PROTO_NEC ? "nec" : p->proto == MyIR::PROTO_RC5 ? "rc5" : "sirc", necRepeat ? " repeat" : "");
+  Time end = sendFrame(frame(*p, necRepeat), name, (uint32_t)(std::find(presses.begin(), presses.end(), p) - presses.begin()));
+  if (n == 0) p->firstFrameEnd = end;
+  Time next = p->at + (Time)(n + 1) * periodMs * 1000;
+  if (n + 1 < minFrames || next < p->at + (Time)p->holdMs * 1000)
+    Sim::at(next, [p, n] { frameOf(p, n + 1); });
+}
+
+static void startPress(Press* p) {
+  if (!p->raw.empty()) {                                  // not followed: sent and forgotten
+    sendFrame(p->raw, "raw", 0);
+    delete p;
+    return;
+  }
+  if (current && current->handledAt == Sim::NEVER) lost++;
+  current = p;
+  if (p->proto == MyIR::PROTO_RC5) rc5Toggle ^= 1;
+  frameOf(p, 0);
+}
+
+// ================= soak =================
+static const MyIR::Protocol PROTOS[] = { MyIR::PROTO_NEC, MyIR::PROTO_NEC, MyIR::PROTO_NEC, MyIR::PROTO_RC5, MyIR::PROTO_SIRC };
+
+// Next random press after the previous one has been released
+static void soakPress() {
+  Press* p = new Press();
+  p->at = Sim::now();
+  do {
+    p->proto = PROTOS[rnd() % 5];
+    p->button = (MyIR::Button)rnd(1, MyIR::BUTTON_COUNT - 1);
+  } while (cmdFor(p->button, p->proto) == 0xFF);
+  bool arrow = p->button == MyIR::BTN_UP || p->button == MyIR::BTN_DOWN ||
+               p->button == MyIR::BTN_LEFT || p->button == MyIR::BTN_RIGHT;
+  if (rnd() % 100 < (arrow ? 50u : 10u)) p->holdMs = rnd(500, 3000);
+  presses.push_back(p);
+  startPress(p);
+  Time after = p->at + (Time)p->holdMs * 1000 + (Time)rnd(opt.soakMs / 2, opt.soakMs * 3 / 2) * 1000;
+  Sim::at(after, soakPress);
+}
+
+// ================= script =================
+static MyIR::Button buttonNamed(const char* s) {
+  for (uint8_t b = 1; b < MyIR::BUTTON_COUNT; b++)
+    if (!strcasecmp(s, MyIR::name((MyIR::Button)b)) || !strcasecmp(s, MyIR::label((MyIR::Button)b))) return (MyIR::Button)b;
+  return MyIR::BTN_NONE;
+}
+
+static bool loadScript(const char* path) {
+  FILE* f = fopen(path, "r");
+  if (!f) { fprintf(stderr, "%s: cannot open\n", path); return false; }
+  char line[1024];
+  for (uint32_t no = 1; fgets(line, sizeof(line), f); no++) {
+    char* hash = strchr(line, '#');
+    if (hash) *hash = '\0';
+    std::vector<const char*> w;
+    for (char* t = strtok(line, " \t\r\n"); t; t = strtok(nullptr, " \t\r\n")) w.push_back(t);
+    if (w.empty()) continue;
+    Time at = (Time)(atof(w[0]) * 1000);
+    bool ok = w.size() >= 2;
+    if (ok && !strcmp(w[1], "audio")) {
+      Sim::AudioSource src = Sim::AUDIO_SILENT;
+      float bpm = w.size() > 3 ? (float)atof(w[3]) : 120;
+      if (w.size() > 2 && !strcmp(w[2], "noise")) src = Sim::AUDIO_NOISE;
+      else if (w.size() > 2 && !strcmp(w[2], "beat")) src = Sim::AUDIO_BEAT;
+      else ok = w.size() > 2 && !strcmp(w[2], "off");
+      if (ok) Sim::at(at, [src, bpm] { Sim::setAudio(src, bpm); });
+    } else if (ok && !strcmp(w[1], "raw")) {
+      Press* p = new Press();
+      p->at = at;
+      for (size_t i = 2; i < w.size(); i++) p->raw.push_back((uint32_t)atoi(w[i]));
+      ok = p->raw.size() % 2 == 1;                          // mark ... mark
+      if (ok) Sim::at(at, [p] { startPress(p); });
+      else delete p;
+    } else if (ok) {
+      Press* p = new Press();
+      p->at = at;
+      p->button = buttonNamed(w[1]);
+      ok = p->button != MyIR::BTN_NONE;
+      for (size_t i = 2; ok && i < w.size(); i++) {
+        if (!strcasecmp(w[i], "nec")) p->proto = MyIR::PROTO_NEC;
+        else if (!strcasecmp(w[i], "rc5")) p->proto = MyIR::PROTO_RC5;
+        else if (!strcasecmp(w[i], "sirc")) p->proto = MyIR::PROTO_SIRC;
+        else if (!strcasecmp(w[i], "hold") && i + 1 < w.size()) p->holdMs = (uint32_t)atoi(w[++i]);
+        else ok = false;
+      }
+      ok = ok && cmdFor(p->button, p->proto) != 0xFF;
+      if (ok) {
+        presses.push_back(p);
+        Sim::at(at, [p] { startPress(p); });
+      } else {
+        delete p;
+      }
+    }
+    if (!ok) { fprintf(stderr, "%s:%u: cannot read this line\n", path, no); fclose(f); return false; }
+  }
+  fclose(f);
+  return true;
+}
+
+// ================= what the sketch does =================
+static bool named = false;
+
+static void nameSemaphores() {
+  if (named || !dataMutex || !ledWake) return;
+  dataMutex->name = "dataMutex";
+  ledWake->name = "ledWake";
+  named = true;
+}
+
+static void onTake(Sim::Semaphore* s, Sim::Task* t) {
+  nameSemaphores();
+  if (s != dataMutex || t != irTaskHandle || !current) return;
+  Press* p = current;
+  if (p->handledAt != Sim::NEVER) { p->repeats++; return; }
+  p->handledAt = Sim::now();
+  handledUs.push_back((uint32_t)(p->handledAt - std::min(p->firstFrameEnd, p->handledAt)));
+  expected.push_back(MyIR::name(p->button));
+  photonFor = p;
+  photonArmed = false;
+  char args[48];
+  snprintf(args, sizeof(args), "{\"us\":%u}", handledUs.back());
+  Sim::trace.instant(Sim::TRACK_INPUT, "handled", Sim::now(), args);
+}
+
+static void onGive(Sim::Semaphore* s, Sim::Task* t) {
+  if (s != dataMutex || !photonFor) return;
+  // LEDTask's pass after IRTask's: the frame it rendered carries the change
+  if (t == ledTaskHandle && photonFor->handledAt < Sim::now()) photonArmed = true;
+}
+
+static void onShow(Time start, Time end, const uint8_t*, uint16_t) {
+  if (lastShowStart != Sim::NEVER) showGapUs.push_back((uint32_t)(start - lastShowStart));
+  lastShowStart = start;
+  Sim::trace.slice(Sim::TRACK_INPUT + 1, "strip.show", start, end - start);
+  if (!photonFor || !photonArmed) return;
+  if (end - photonFor->handledAt > PHOTON_MAX) {          // e.g. UP at full brightness: nothing to see
+    unseen++;
+    photonFor = nullptr;
+    return;
+  }
+  photonUs.push_back((uint32_t)(end - std::min(photonFor->firstFrameEnd, end)));
+  char args[48];
+  snprintf(args, sizeof(args), "{\"us\":%u}", photonUs.back());
+  Sim::trace.instant(Sim::TRACK_INPUT + 1, "photon", end, args);
+  photonFor = nullptr;
+}
+
+// "[  12.345 0] IR UP proto 1 cmd 0x18", "[log] core 0: 3 events dropped", "... E: ..."
+static void onSerial(uint8_t, Time, const char* line) {
+  const char* text = strstr(line, "] ");
+  if (!strncmp(line, "[log] core", 10)) {
+    const char* n = strstr(line, ": ");
+    if (n) logDropped += strtoul(n + 2, nullptr, 10);
+    return;
+  }
+  if (!text) return;
+  text += 2;
+  if (!strncmp(text, "E: ", 3)) { logErrors++; if (logErrors <= 3) fprintf(stderr, "device: %s\n", line); }
+  if (!strncmp(text, "W: ", 3)) logWarnings++;
+  if (strncmp(text, "IR ", 3) || strstr(text, "(repeat)") || !strstr(text, " proto ")) return;
+  char name[16] = {};
+  sscanf(text + 3, "%15s", name);
+  if (expected.empty()) { spurious++; return; }
+  if (expected.front() != name) wrong++;
+  expected.erase(expected.begin());
+}
+
+// ================= summary =================
+static uint32_t pct(std::vector<uint32_t>& v, double p) {
+  if (v.empty()) return 0;
+  std::sort(v.begin(), v.end());
+  size_t i = (size_t)(p / 100 * (v.size() - 1) + 0.5);
+  return v[i];
+}
+
+static double ms(uint32_t us) { return us / 1000.0; }
+
+static void latencyLine(const char* what, std::vector<uint32_t>& v) {
+  printf("  %-18s n %-6u p50 %7.1f  p95 %7.1f  p99 %7.1f  max %7.1f ms\n", what, (unsigned)v.size(),
+         ms(pct(v, 50)), ms(pct(v, 95)), ms(pct(v, 99)), ms(pct(v, 100)));
+}
+
+static void summary(Time device, double hostS) {
+  double d = device / 1e6;
+  printf("Device time %.1f s in %.2f s on this PC (%.0fx)\n", d, hostS, d / (hostS > 0 ? hostS : 1e-9));
+  printf("\nTasks                cpu core 0  cpu core 1      runs  preempted  ready max  ready mean\n");
+  for (Sim::Task* t : Sim::tasks()) {
+    printf("  %-16s %9.2f%% %10.2f%% %9llu %10llu %8.2f ms %8.3f ms\n", t->name.c_str(),
+           100.0 * t->cpu[0] / device, 100.0 * t->cpu[1] / device, (unsigned long long)t->runs,
+           (unsigned long long)t->preemptions, ms((uint32_t)t->ready.max),
+           t->ready.count ? t->ready.total / 1000.0 / t->ready.count : 0.0);
+  }
+  printf("\nSemaphores: takes, had to wait, per waiting task count / mean / max\n");
+  for (Sim::Semaphore* s : Sim::semaphores()) {
+    printf("  %-16s %9llu %8llu", s->name.c_str(), (unsigned long long)s->takes, (unsigned long long)s->contended);
+    for (auto& w : s->waits)
+      printf("   %s %llu / %.2f / %.2f ms", w.first->name.c_str(), (unsigned long long)w.second.count,
+             w.second.count ? w.second.total / 1000.0 / w.second.count : 0.0, ms((uint32_t)w.second.max));
+    printf("\n");
+  }
+  uint64_t tracked = presses.size();
+  printf("\nIR: %llu presses, %llu lost, %llu wrong button, %llu decoded without a press, %llu repeats\n",
+         (unsigned long long)tracked, (unsigned long long)lost, (unsigned long long)wrong,
+         (unsigned long long)spurious, (unsigned long long)[] { uint64_t r = 0; for (Press* p : presses) r += p->repeats; return r; }());
+  latencyLine("press -> handled", handledUs);
+  latencyLine("press -> photon", photonUs);
+  printf("  %llu handled presses changed nothing on the strip within 2 s\n", (unsigned long long)unseen);
+  const Sim::Stats& s = Sim::stats;
+  printf("\nLED: %llu shows (%.1f/s), interval p50 %.1f  p99 %.1f  max %.1f ms, strip busy %.2f%%%s\n",
+         (unsigned long long)s.shows, s.shows / d, ms(pct(showGapUs, 50)), ms(pct(showGapUs, 99)), ms(pct(showGapUs, 100)),
+         100.0 * s.showUs / device, Sim::config.blackout ? " (interrupts off)" : " (RMT)");
+  printf("Interrupts: %llu, %llu late (max %.1f us), %llu edges merged while masked, %llu edges lost asleep\n",
+         (unsigned long long)s.interrupts, (unsigned long long)s.lateInterrupts, (double)s.maxInterruptDelay,
+         (unsigned long long)s.mergedEdges, (unsigned long long)s.edgesAsleep);
+  printf("Cores: busy %.2f%% / %.2f%%, longest without idle %.1f / %.1f ms%s\n",
+         100.0 * s.coreBusy[0] / device, 100.0 * s.coreBusy[1] / device,
+         ms((uint32_t)s.maxBusyStretch[0]), ms((uint32_t)s.maxBusyStretch[1]),
+         std::max(s.maxBusyStretch[0], s.maxBusyStretch[1]) >= 5000000 ? "  TASK WATCHDOG (5 s)" : "");
+  printf("Power: light sleep %.1f%% (%llu sleeps, %llu woken by IR), 240/160/80 MHz %.1f / %.1f / %.1f%%\n",
+         100.0 * s.sleepUs / device, (unsigned long long)s.sleeps, (unsigned long long)s.pinWakes,
+         100.0 * s.mhzTime[0] / device, 100.0 * s.mhzTime[1] / device, 100.0 * s.mhzTime[2] / device);
+  printf("UART: %llu lines, writers waited %.1f ms, %llu log events dropped, %llu errors, %llu warnings\n",
+         (unsigned long long)s.uartLines, s.uartBlockedUs / 1000.0, (unsigned long long)logDropped,
+         (unsigned long long)logErrors, (unsigned long long)logWarnings);
+  printf("Other: %llu NVS writes, %llu I2S overruns, %llu context switches\n",
+         (unsigned long long)s.nvsWrites, (unsigned long long)s.i2sOverruns, (unsigned long long)s.switches);
+}
+
+static void csv(Time device, double hostS) {
+  const Sim::Stats& s = Sim::stats;
+  printf("device_s,host_s,presses,lost,wrong,handled_p50_ms,handled_p99_ms,handled_max_ms,photon_p50_ms,photon_p99_ms,"
+         "photon_max_ms,fps,show_gap_p99_ms,late_irq,merged_edges,max_irq_delay_us,core0_busy_pct,core1_busy_pct,sleep_pct\n");
+  printf("%.1f,%.2f,%u,%llu,%llu,%.2f,%.2f,%.2f,%.2f,%.2f,%.2f,%.2f,%.2f,%llu,%llu,%llu,%.3f,%.3f,%.2f\n", device / 1e6, hostS,
+         (unsigned)presses.size(), (unsigned long long)lost, (unsigned long long)wrong, ms(pct(handledUs, 50)),
+         ms(pct(handledUs, 99)), ms(pct(handledUs, 100)), ms(pct(photonUs, 50)), ms(pct(photonUs, 99)),
+         ms(pct(photonUs, 100)), s.shows / (device / 1e6), ms(pct(showGapUs, 99)), (unsigned long long)s.lateInterrupts,
+         (unsigned long long)s.mergedEdges, (unsigned long long)s.maxInterruptDelay, 100.0 * s.coreBusy[0] / device,
+         100.0 * s.coreBusy[1] / device, 100.0 * s.sleepUs / device);
+}
+
+static void usage() {
+  fprintf(stderr, "usage: ir_sim [script] [-t seconds] [-seed n] [-soak ms] [-trace out.json [-from s] [-len s]]\n"
+                  "              [-log file|-] [-blackout] [-cpu x] [-jitter us] [-csv] [-max-latency ms] [-max-photon ms]\n");
+}
+
+int main(int argc, char** argv) {
+  for (int a = 1; a < argc; a++) {
+    const char* arg = argv[a];
+    bool hasValue = a + 1 < argc;
+    if (!strcmp(arg, "-t") && hasValue) opt.seconds = atof(argv[++a]);
+    else if (!strcmp(arg, "-seed") && hasValue) opt.seed = (uint32_t)strtoul(argv[++a], nullptr, 10);
+    else if (!strcmp(arg, "-soak") && hasValue) opt.soakMs = (uint32_t)atoi(argv[++a]);
+    else if (!strcmp(arg, "-trace") && hasValue) opt.tracePath = argv[++a];
+    else if (!strcmp(arg, "-from") && hasValue) opt.traceFrom = atof(argv[++a]);
+    else if (!strcmp(arg, "-len") && hasValue) opt.traceLen = atof(argv[++a]);
+    else if (!strcmp(arg, "-log") && hasValue) opt.logPath = argv[++a];
+    else if (!strcmp(arg, "-blackout")) Sim::config.blackout = true;
+    else if (!strcmp(arg, "-cpu") && hasValue) Sim::config.cpuScale = atof(argv[++a]);
+    else if (!strcmp(arg, "-jitter") && hasValue) opt.jitterUs = (uint32_t)atoi(argv[++a]);
+    else if (!strcmp(arg, "-csv")) opt.csv = true;
+    else if (!strcmp(arg, "-max-latency") && hasValue) opt.maxLatencyMs = atof(argv[++a]);
+    else if (!strcmp(arg, "-max-photon") && hasValue) opt.maxPhotonMs = atof(argv[++a]);
+    else if (arg[0] != '-' && !opt.script) opt.script = arg;
+    else { usage(); return 1; }
+  }
+  rng = opt.seed ? opt.seed : 1;
+  Sim::seedRandom(opt.seed * 2654435761u);
+  if (opt.tracePath) {
+    if (!Sim::trace.open(opt.tracePath, (Time)(opt.traceFrom * 1e6), (Time)(opt.traceLen * 1e6))) {
+      fprintf(stderr, "%s: cannot write\n", opt.tracePath);
+      return 1;
+    }
+    Sim::trace.thread(Sim::TRACK_INPUT, "IR receiver", Sim::TRACK_INPUT);
+    Sim::trace.thread(Sim::TRACK_INPUT + 1, "strip", Sim::TRACK_INPUT + 1);
+  }
+  FILE* log = nullptr;
+  if (opt.logPath) {
+    log = strcmp(opt.logPath, "-") ? fopen(opt.logPath, "w") : stdout;
+    if (!log) { fprintf(stderr, "%s: cannot write\n", opt.logPath); return 1; }
+    Sim::setSerialLog(log);
+  }
+  Sim::hooks.show = onShow;
+  Sim::hooks.serial = onSerial;
+  Sim::hooks.take = onTake;
+  Sim::hooks.give = onGive;
+  if (opt.script) {
+    if (!loadScript(opt.script)) return 1;
+  } else {
+    if (!opt.soakMs) opt.soakMs = 3000;
+    Sim::at(2000000, soakPress);                // after the boot
+  }
+
+  Time device = (Time)(opt.seconds * 1e6);
+  auto t0 = std::chrono::steady_clock::now();
+  Sim::start(setup, loop);
+  Sim::run(device);
+  double hostS = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+  if (current && current->handledAt == Sim::NEVER && current->at + (Time)current->holdMs * 1000 + 1000000 < device) lost++;
+  Sim::trace.close();
+  if (log && log != stdout) fclose(log);
+
+  if (opt.csv) csv(device, hostS);
+  else summary(device, hostS);
+  bool fail = (opt.maxLatencyMs > 0 && (lost || ms(pct(handledUs, 99)) > opt.maxLatencyMs)) ||
+              (opt.maxPhotonMs > 0 && (lost || ms(pct(photonUs, 99)) > opt.maxPhotonMs));
+  if (fail) fprintf(stderr, "latency limit exceeded or press lost\n");
+  for (Press* p : presses) delete p;
+  return fail ? 2 : 0;
+}
@@ -23,7 +23,7 @@ Poznámky:
 ==========================================================
 SERIÁLOVÝ PROTOKOL (115200 b/s) – STEJNÝ JAKO DŘÍV:
 Příkazy z webu → ESP32:
-- "MODE X"   ... X = 0..3
+- "MODE X"   ... X = 0..10 (10 = Plasma)
 - "BRI N"    ... N = 0..255
 
 Události z ESP32 → web:
@@ -33,6 +33,8 @@ Události z ESP32 → web:
 
 #include <Adafruit_NeoPixel.h>
 #include <Bounce2.h>
+#include <MyPalette.h>   // knihovna MyShows: palety (oheň, plasma)
+#include <MyNoise.h>     // knihovna MyShows: plynulý šum místo random() na každou LED
 
 #define LED_PIN    18
 #define LED_COUNT  60
@@ -81,7 +83,8 @@ void IRAM_ATTR updateEncoder() {
 }
 
 // ---------- STAV EFEKTŮ ----------
-uint8_t currentMode = 0;     // 0..9
+const uint8_t MODE_COUNT = 11;
+uint8_t currentMode = 0;     // 0..MODE_COUNT-1
 uint8_t brightness  = DEFAULT_BRIGHTNESS;
 uint8_t speedPercent = 50;   // 1..100 (vyšší = rychlejší)
 unsigned long tNow;
@@ -91,11 +94,15 @@ struct TheaterState { uint8_t offset = 0; } theater;
 struct BounceState  { int pos = 0; int dir = 1; } bounce;
 struct SparkleState { } sparkle;
 struct WipeState    { uint16_t idx = 0; uint32_t color = 0; uint8_t phase = 0; bool clearing = true; } wipe;
-struct TwinkleState { } twinkle;
+struct TwinkleState { uint16_t t = 0; } twinkle;
 struct CometState   { int pos = 0; int dir = 1; } comet;
-struct FireState    { } fireFx;
+struct FireState    { MyShows::NoiseFire<LED_COUNT> flame; } fireFx;
 struct BreatheState { uint16_t t = 0; } breathe;
 struct ScannerState { int pos = 0; int dir = 1; } scanner;
+struct PlasmaState  { uint16_t t = 0; } plasma;
+
+MyShows::Palette pal;        // paleta pro oheň (Heat) a plasmu (Party), nahraje ji applyMode()
+uint8_t noiseBuf[LED_COUNT]; // jedna řada šumu (plasma)
 
 // ---------- HELPERY ----------
 uint32_t wheel(byte pos) {
@@ -181,15 +188,15 @@ void stepWipe() {
   }
 }
 
-// 5) Twinkle (náhodné jiskření s pomalým zhasínáním)
+// 5) Twinkle (hvězdy se plynule rozsvítí a zhasnou – vrcholky šumu, žádný random())
 void stepTwinkle() {
   static unsigned long last=0; if (tNow - last < computeIntervalMs(40)) return; last = tNow;
-  dimAll(25);
-  for (uint8_t k=0; k<2; k++) {
-    uint16_t i = random(strip.numPixels());
-    strip.setPixelColor(i, strip.Color(255, 255, 180));
+  for (uint16_t i=0; i<strip.numPixels(); i++) {
+    uint8_t v = MyShows::sparkle8(twinkle.t, i);
+    strip.setPixelColor(i, strip.Color(v, v, (uint8_t)((uint16_t)v * 180 >> 8)));
   }
   strip.show();
+  twinkle.t += 6;
 }
 
 // 6) Comet (kometa s ohonem)
@@ -202,15 +209,13 @@ void stepComet() {
   if (comet.pos<=0 || comet.pos>=strip.numPixels()-1) comet.dir = -comet.dir;
 }
 
-// 7) Fire (teplé mihotání)
+// 7) Fire (teplo stoupá od LED 0, chladnutí a jiskry řídí šum – viz MyNoise.h)
 void stepFire() {
   static unsigned long last=0; if (tNow - last < computeIntervalMs(35)) return; last = tNow;
+  fireFx.flame.step();
   for (uint16_t i=0; i<strip.numPixels(); i++) {
-    uint8_t heat = random(140, 255);
-    uint8_t r = heat;
-    uint8_t g = (uint8_t)(heat * 0.36f);
-    uint8_t b = (uint8_t)(heat * 0.05f);
-    strip.setPixelColor(i, strip.Color(r, g, b));
+    const uint8_t* c = pal.rgb(fireFx.flame.heat[i]);
+    strip.setPixelColor(i, strip.Color(c[0], c[1], c[2]));
   }
   strip.show();
 }
@@ -244,11 +249,23 @@ void stepScanner() {
   if (scanner.pos<=0 || scanner.pos>=strip.numPixels()-1) scanner.dir = -scanner.dir;
 }
 
+// 10) Plasma (dvě oktávy šumu přes paletu, pomalu se přelévá)
+void stepPlasma() {
+  static unsigned long last=0; if (tNow - last < computeIntervalMs(30)) return; last = tNow;
+  MyShows::fbmRow(noiseBuf, LED_COUNT, plasma.t >> 1, 28, plasma.t, 2);   // vlny se pomalu posouvají
+  for (uint16_t i=0; i<strip.numPixels(); i++) {
+    const uint8_t* c = pal.rgb(noiseBuf[i]);
+    strip.setPixelColor(i, strip.Color(c[0], c[1], c[2]));
+  }
+  strip.show();
+  plasma.t += 5;
+}
+
 // ---------- PŘÍKAZY ZE STRÁNKY ----------
 String rx;
 
 void applyMode(uint8_t m) {
-  currentMode = m % 10;
+  currentMode = m % MODE_COUNT;
   rainbow = RainbowState{};
   theater = TheaterState{};
   bounce  = BounceState{};
@@ -259,6 +276,10 @@ void applyMode(uint8_t m) {
   fireFx  = FireState{};
   breathe = BreatheState{};
   scanner = ScannerState{};
+  plasma  = PlasmaState{};
+  fireFx.flame.seed(esp_random());            // pokaždé jiný plamen
+  if (currentMode == 7)  pal.load(MyShows::PAL_HEAT);
+  if (currentMode == 10) pal.load(MyShows::PAL_PARTY);
 }
 void applyBrightness(uint8_t b) {
   brightness = b;
@@ -338,6 +359,7 @@ void loop() {
     case 7: stepFire();    break;
     case 8: stepBreathe(); break;
     case 9: stepScanner(); break;
+    case 10: stepPlasma(); break;
   }
 
   // Události z enkodéru → pošli stránce
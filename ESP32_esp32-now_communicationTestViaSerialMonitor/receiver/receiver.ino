@@ -10,10 +10,12 @@ ZAPOJENÍ (pro děti)
 3) Zkus změnit MSG_MAX a pošli delší větu – co se stane?
 4) Přidej k výpisu čas přijetí pomocí millis().
 5) Co se stane, když vypneš přijímač – co píše odesílač?
+6) Pošli 50 zpráv rychle za sebou. Ztratí se některé? (MyLog vypíše „events dropped“)
 ************************************************************/
 
 #include <WiFi.h>
 #include <esp_now.h>
+#include <MyLog.h>      // knihovna MyLog: výpis z callbacku bez čekání na Serial
 
 static const uint16_t MSG_MAX = 200;
 
@@ -22,19 +24,15 @@ typedef struct {
 } Packet;
 
 // POZOR: v novém jádře má callback jiný podpis:
+// Běží v úloze Wi-Fi – Serial by ji zdržel, takže zprávu jen zaznamenáme (MyLog ji zkopíruje)
 void onDataRecv(const esp_now_recv_info_t *info, const uint8_t *incomingData, int len) {
-  Packet pkt{};
-  int copyLen = min(len, (int)sizeof(pkt));
-  memcpy(&pkt, incomingData, copyLen);
+  int copyLen = min(len, (int)sizeof(Packet));
+  const char *text = (const char *)incomingData;
 
   // MAC odesílatele je v info->src_addr
   const uint8_t *mac = info->src_addr;
-  char macStr[18];
-  snprintf(macStr, sizeof(macStr), "%02X:%02X:%02X:%02X:%02X:%02X",
-           mac[0], mac[1], mac[2], mac[3], mac[4], mac[5]);
-
-  Serial.print("Přijato od "); Serial.print(macStr); Serial.print(": ");
-  Serial.println(pkt.text);
+  MYLOG_I("Přijato od %02X:%02X:%02X:%02X:%02X:%02X: %s", mac[0], mac[1], mac[2], mac[3], mac[4], mac[5],
+          MyLog::Text(text, strnlen(text, copyLen)));
 }
 
 void printMyMAC() {
@@ -59,6 +57,7 @@ void setup() {
 
   Serial.println("Receiver ready. Očekávám zprávy…");
   printMyMAC();
+  MyLog::begin(Serial);   // od teď píše do Serialu jen úloha MyLog
 }
 
 void loop() {
@@ -10,6 +10,7 @@ ZAPOJENÍ (pro děti)
 3) Doplň „echo“ na Receiveru (pošle zpět potvrzení).
 4) Přidej tlačítko: při stisku pošli pevnou zprávu.
 5) Ošetři příliš dlouhé vstupy – vytiskni varování.
+6) Proč onDataSent netiskne rovnou přes Serial? (MyLog.h, CO TO JE)
 
 Poznámka: Kompatibilní s Arduino-ESP32 core 3.x (IDF 5.x).
 ************************************************************/
@@ -17,6 +18,7 @@ Poznámka: Kompatibilní s Arduino-ESP32 core 3.x (IDF 5.x).
 #include <WiFi.h>
 #include <esp_now.h>
 #include <esp_wifi.h>   // pro typ wifi_tx_info_t v novém jádru
+#include <MyLog.h>      // knihovna MyLog: výpis z callbacku bez čekání na Serial
 
 static const uint16_t MSG_MAX = 200;
 struct Packet { char text[MSG_MAX]; };
@@ -35,11 +37,12 @@ static void printMac(const uint8_t mac[6]) {
 }
 
 // Nový podpis v IDF 5.x. Nečteme pole z `info` (v různých verzích se liší názvy).
+// Běží v úloze Wi-Fi: jen zaznamenat, vypíše to úloha MyLog.
 static void onDataSent(const wifi_tx_info_t* info, esp_now_send_status_t status) {
   (void)info;  // neřešíme `peer_addr`/`des_addr` → stabilní napříč verzemi
-  Serial.print("Send → "); printMac(peerMac);
-  Serial.print(" | Stav: ");
-  Serial.println(status == ESP_NOW_SEND_SUCCESS ? "OK" : "NEÚSPĚCH");
+  MYLOG_I(status == ESP_NOW_SEND_SUCCESS ? "Send → %02X:%02X:%02X:%02X:%02X:%02X | Stav: OK"
+                                         : "Send → %02X:%02X:%02X:%02X:%02X:%02X | Stav: NEÚSPĚCH",
+          peerMac[0], peerMac[1], peerMac[2], peerMac[3], peerMac[4], peerMac[5]);
 }
 
 static bool addPeer(const uint8_t mac[6]) {
@@ -78,6 +81,7 @@ void setup() {
 
   Serial.println("Sender ready. Napiš řádek a Enter → odešlu ho.");
   printMyMAC();
+  MyLog::begin(Serial);   // od teď píše do Serialu jen úloha MyLog
 }
 
 void loop() {
@@ -89,14 +93,14 @@ void loop() {
     Packet pkt{};                       // naplníme Packet
     line.toCharArray(pkt.text, sizeof(pkt.text));
     if ((int)line.length() >= (int)sizeof(pkt.text)) {
-      Serial.println("Pozor: zpráva byla oříznuta na 200 znaků.");
+      MYLOG_W("Pozor: zpráva byla oříznuta na 200 znaků.");
     }
 
     esp_err_t ok = esp_now_send(peerMac, (uint8_t*)&pkt, sizeof(pkt));
     if (ok != ESP_OK) {
-      Serial.print("Chyba esp_now_send: "); Serial.println((int)ok);
+      MYLOG_E("Chyba esp_now_send: %d", (int)ok);
     } else {
-      Serial.print("Odesláno: "); Serial.println(pkt.text);
+      MYLOG_I("Odesláno: %s", MyLog::Text(pkt.text));
     }
   }
 }
@@ -1,5 +1,6 @@
 #include <WiFi.h>
 #include <esp_now.h>
+#include <MyLog.h>   // knihovna MyLog: callbacky jen zaznamenají, vypíše to úloha s nejnižší prioritou
 
 // ====== KONFIGURACE PEERŮ ======
 
@@ -29,27 +30,17 @@ const char* MY_NAME = "richard";
 void onDataSent(const wifi_tx_info_t *info, esp_now_send_status_t status) {
   (void)info; // aby nebylo warning "unused parameter"
 
-  Serial.print("Send status: ");
-  Serial.println(status == ESP_NOW_SEND_SUCCESS ? "OK" : "FAIL");
+  if (status == ESP_NOW_SEND_SUCCESS) MYLOG_I("Send status: OK");
+  else MYLOG_W("Send status: FAIL");
 }
 
 // core 3: esp_now_recv_info*, incomingData, len
 void onDataRecv(const esp_now_recv_info *info, const uint8_t *incomingData, int len) {
   (void)info; // info teď nevyužíváme
 
-  const int MAX_LEN = 250;
-  char buffer[MAX_LEN];
-
-  int copyLen = len;
-  if (copyLen > MAX_LEN - 1) {
-    copyLen = MAX_LEN - 1;
-  }
-
-  memcpy(buffer, incomingData, copyLen);
-  buffer[copyLen] = '\0';
-
-  Serial.print("Received message: ");
-  Serial.println(buffer);
+  // Zpráva končí '\0' (posílá se i s ním), ale radši to nepředpokládat
+  const char* text = (const char*)incomingData;
+  MYLOG_I("Received message: %s", MyLog::Text(text, strnlen(text, len)));
 }
 
 // ====== POMOCNÉ FUNKCE ======
@@ -68,18 +59,14 @@ int findPeerIndexByName(const String& name) {
 void sendMessageTo(const String& targetName, const String& message) {
   int idx = findPeerIndexByName(targetName);
   if (idx < 0) {
-    Serial.print("Unknown user: ");
-    Serial.println(targetName);
-    Serial.println("Use format: vasik: hello");
+    MYLOG_W("Unknown user: %s", MyLog::Text(targetName.c_str()));
+    MYLOG_I("Use format: vasik: hello");
     return;
   }
 
   const Peer& p = peers[idx];
 
-  Serial.print("Sending to ");
-  Serial.print(p.name);
-  Serial.print(": ");
-  Serial.println(message);
+  MYLOG_I("Sending to %s: %s", p.name, MyLog::Text(message.c_str()));
 
   esp_err_t result = esp_now_send(
     p.mac,
@@ -88,8 +75,7 @@ void sendMessageTo(const String& targetName, const String& message) {
   );
 
   if (result != ESP_OK) {
-    Serial.print("esp_now_send error, code: ");
-    Serial.println(result);
+    MYLOG_E("esp_now_send error, code: %d", (int)result);
   }
 }
 
@@ -131,6 +117,8 @@ void setup() {
       Serial.println(peers[i].name);
     }
   }
+
+  MyLog::begin(Serial);   // od teď píše do Serialu jen úloha MyLog
 }
 
 void loop() {
@@ -144,7 +132,7 @@ void loop() {
     // Očekávám formát: jmeno: zprava
     int colonIndex = line.indexOf(':');
     if (colonIndex < 0) {
-      Serial.println("Invalid format. Use: vasik: ahoj");
+      MYLOG_W("Invalid format. Use: vasik: ahoj");
       return;
     }
 
@@ -155,7 +143,7 @@ void loop() {
     message.trim();
 
     if (name.length() == 0 || message.length() == 0) {
-      Serial.println("Invalid format. Use: vasik: ahoj");
+      MYLOG_W("Invalid format. Use: vasik: ahoj");
       return;
     }
 
@@ -0,0 +1,280 @@
+/*
+ClipCodec.h — pre-rendered clips (logo reveals, hand-made sequences) played from flash
+- No Arduino dependencies, so it also compiles on a PC (g++):
+  tools/clip_encode.cpp builds the partition image from pictures,
+  tools/clip_bench.cpp times decode on the PC.
+- On the ESP32 the "clips" partition (partitions.csv) is memory-mapped
+  (esp_partition_mmap); Player reads the clip straight from the mapping into
+  the frame buffer, the clip itself is never copied to RAM.
+
+Partition image (little endian):
+  header  "CLIP", u8 VERSION, u8 clip count, u16 0
+  entry   per clip, ENTRY bytes: name[NAME_MAX] (0-terminated), u32 offset
+          (from the image start), u32 size, u16 leds, u16 frames, u16 frameMs, u16 0
+  clip    u32 frame offsets (from the clip start), one per frame, then the frames
+  frame   [0] 'K' keyframe | 'D' delta against the previous frame, then tokens
+          until all LEDs are covered (trailing unchanged LEDs of a delta are omitted)
+  'K':    0x00..0x7F  (t + 1) LEDs of the next RGB
+          0x80..0xFF  (t - 0x7F) LEDs follow, RGB each
+  'D':    0x00..0x7F  skip (t + 1) unchanged LEDs
+          0x80..0xBF  (t - 0x7F) changed LEDs follow, RGB each
+          0xC0..0xFF  (t - 0xBF) LEDs of the next RGB
+  Frame 0 is always a keyframe (a looping clip starts over from it). The
+  encoder puts in another one every keyEvery frames, so jumping to any frame
+  (sync, a new show) decodes at most keyEvery records.
+
+Why decode() has no checks: check() walks a clip once before it is played
+(every offset, token and run must stay inside the clip and the LED count),
+like PixelVM::verify(). A damaged or half-written partition is refused
+instead of writing past the frame buffer.
+*/
+
+#ifndef CLIP_CODEC_H
+#define CLIP_CODEC_H
+
+#include <stdint.h>
+#include <string.h>
+
+namespace Clip {
+
+  constexpr uint8_t  VERSION   = 1;
+  constexpr uint8_t  HEADER    = 8;
+  constexpr uint8_t  NAME_MAX  = 16;
+  constexpr uint8_t  ENTRY     = NAME_MAX + 16;
+  constexpr uint8_t  MAX_CLIPS = 16;
+  constexpr uint8_t  TYPE_KEY   = 'K';
+  constexpr uint8_t  TYPE_DELTA = 'D';
+  constexpr uint8_t  RUN_MAX    = 128;            // 'K' runs, 'D' skips
+  constexpr uint8_t  DELTA_MAX  = 64;             // 'D' literal and fill runs
+
+  inline uint16_t le16(const uint8_t* p) { return (uint16_t)(p[0] | p[1] << 8); }
+  inline uint32_t le32(const uint8_t* p) { return p[0] | (uint32_t)p[1] << 8 | (uint32_t)p[2] << 16 | (uint32_t)p[3] << 24; }
+  inline void put16(uint8_t* p, uint16_t v) { p[0] = (uint8_t)v; p[1] = (uint8_t)(v >> 8); }
+  inline void put32(uint8_t* p, uint32_t v) { put16(p, (uint16_t)v); put16(p + 2, (uint16_t)(v >> 16)); }
+
+  inline bool samePixel(const uint8_t* a, const uint8_t* b) {
+    return a[0] == b[0] && a[1] == b[1] && a[2] == b[2];
+  }
+  inline void fill(uint8_t* out, const uint8_t* rgb, uint16_t n) {
+    for (; n; n--, out += 3) { out[0] = rgb[0]; out[1] = rgb[1]; out[2] = rgb[2]; }
+  }
+
+  // One clip of the image; data points into the mapped flash
+  struct Info {
+    char     name[NAME_MAX];
+    uint16_t leds, frames, frameMs;
+    uint32_t size;
+    const uint8_t* data;
+  };
+
+  // ---------- Encoder (tools/clip_encode.cpp) ----------
+  // Worst case of a frame record: type + one token per LED + RGB each
+  constexpr uint32_t maxFrame(uint16_t leds) { return 1 + leds * 4u; }
+
+  inline uint32_t encodeKey(uint8_t* out, const uint8_t* rgb, uint16_t leds) {
+    uint32_t n = 0;
+    out[n++] = TYPE_KEY;
+    uint16_t i = 0;
+    while (i < leds) {
+      uint16_t run = 1;
+      while (i + run < leds && run < RUN_MAX && samePixel(rgb + (i + run) * 3, rgb + i * 3)) run++;
+      if (run > 1) {
+        out[n++] = (uint8_t)(run - 1);
+        memcpy(out + n, rgb + i * 3, 3);
+        n += 3;
+        i += run;
+        continue;
+      }
+      // literals until two equal neighbours start a run
+      while (i + run < leds && run < RUN_MAX &&
+             !(i + run + 1 < leds && samePixel(rgb + (i + run) * 3, rgb + (i + run + 1) * 3))) run++;
+      out[n++] = (uint8_t)(0x7F + run);
+      memcpy(out + n, rgb + i * 3, run * 3);
+      n += run * 3;
+      i += run;
+    }
+    return n;
+  }
+
+  // Delta of 'rgb' against 'prev' (the encoder keeps a keyframe when that is not larger)
+  inline uint32_t encodeDelta(uint8_t* out, const uint8_t* rgb, const uint8_t* prev, uint16_t leds) {
+    uint32_t n = 0;
+    out[n++] = TYPE_DELTA;
+    uint16_t i = 0;
+    while (i < leds) {
+      uint16_t run = 0;
+      while (i + run < leds && run < RUN_MAX && samePixel(rgb + (i + run) * 3, prev + (i + run) * 3)) run++;
+      if (run) {
+        if (i + run == leds) break;               // rest unchanged: no token needed
+        out[n++] = (uint8_t)(run - 1);
+        i += run;
+        continue;
+      }
+      run = 1;                                    // LEDs of the same color (changed or not)
+      while (i + run < leds && run < DELTA_MAX && samePixel(rgb + (i + run) * 3, rgb + i * 3)) run++;
+      if (run > 1) {
+        out[n++] = (uint8_t)(0xBF + run);
+        memcpy(out + n, rgb + i * 3, 3);
+        n += 3;
+        i += run;
+        continue;
+      }
+      while (i + run < leds && run < DELTA_MAX && !samePixel(rgb + (i + run) * 3, prev + (i + run) * 3) &&
+             !(i + run + 1 < leds && samePixel(rgb + (i + run) * 3, rgb + (i + run + 1) * 3))) run++;
+      out[n++] = (uint8_t)(0x7F + run);
+      memcpy(out + n, rgb + i * 3, run * 3);
+      n += run * 3;
+      i += run;
+    }
+    return n;
+  }
+
+  // ---------- Decoder ----------
+  // One record into 'rgb' (a delta onto the previous frame). No checks: the
+  // clip went through check() first.
+  inline void decode(const uint8_t* p, const uint8_t* end, uint8_t* rgb) {
+    uint8_t type = *p++;
+    if (type == TYPE_KEY) {
+      while (p < end) {
+        uint8_t t = *p++;
+        if (t < 0x80) { fill(rgb, p, t + 1); rgb += (t + 1) * 3; p += 3; continue; }
+        uint16_t n = (t - 0x7F) * 3;
+        memcpy(rgb, p, n);
+        rgb += n; p += n;
+      }
+      return;
+    }
+    while (p < end) {
+      uint8_t t = *p++;
+      if (t < 0x80) { rgb += (t + 1) * 3; continue; }
+      if (t < 0xC0) {
+        uint16_t n = (t - 0x7F) * 3;
+        memcpy(rgb, p, n);
+        rgb += n; p += n;
+        continue;
+      }
+      fill(rgb, p, t - 0xBF);
+      rgb += (t - 0xBF) * 3;
+      p += 3;
+    }
+  }
+
+  // Record i of a clip: [start, end)
+  inline const uint8_t* frameStart(const Info& c, uint16_t i) { return c.data + le32(c.data + i * 4u); }
+  inline const uint8_t* frameEnd(const Info& c, uint16_t i) {
+    return i + 1 < c.frames ? frameStart(c, i + 1) : c.data + c.size;
+  }
+
+  // Every record stays inside the clip and covers at most 'leds' LEDs
+  inline bool check(const Info& c) {
+    if (c.frames == 0 || c.leds == 0 || c.size < c.frames * 4u) return false;
+    uint32_t prev = c.frames * 4u;
+    for (uint16_t f = 0; f < c.frames; f++) {
+      uint32_t at = le32(c.data + f * 4u);
+      uint32_t to = f + 1 < c.frames ? le32(c.data + (f + 1) * 4u) : c.size;
+      if (at != prev || to <= at || to > c.size) return false;
+      prev = to;
+      const uint8_t* p = c.data + at;
+      const uint8_t* end = c.data + to;
+      uint8_t type = *p++;
+      if (type != TYPE_KEY && (type != TYPE_DELTA || f == 0)) return false;
+      uint32_t i = 0;
+      while (p < end) {
+        uint8_t t = *p++;
+        uint32_t run, bytes;
+        if (type == TYPE_KEY) { run = t < 0x80 ? t + 1u : t - 0x7Fu; bytes = t < 0x80 ? 3 : run * 3; }
+        else if (t < 0x80)    { run = t + 1u; bytes = 0; }
+        else if (t < 0xC0)    { run = t - 0x7Fu; bytes = run * 3; }
+        else                  { run = t - 0xBFu; bytes = 3; }
+        if (i + run > c.leds || (uint32_t)(end - p) < bytes) return false;
+        i += run;
+        p += bytes;
+      }
+      if (type == TYPE_KEY && i != c.leds) return false;   // a keyframe sets every LED
+    }
+    return true;
+  }
+
+  // ---------- Directory of a mapped image ----------
+  class Library {
+  public:
+    // false = no image (erased partition) or a broken directory; count() is 0 then
+    bool open(const uint8_t* image, uint32_t size) {
+      n = 0;
+      if (size < HEADER || memcmp(image, "CLIP", 4) != 0 || image[4] != VERSION) return false;
+      uint8_t count = image[5];
+      if (count > MAX_CLIPS || size < HEADER + count * (uint32_t)ENTRY) return false;
+      for (uint8_t i = 0; i < count; i++) {
+        const uint8_t* e = image + HEADER + i * ENTRY;
+        Info& c = clips[i];
+        memcpy(c.name, e, NAME_MAX);
+        c.name[NAME_MAX - 1] = 0;
+        uint32_t offset = le32(e + NAME_MAX);
+        c.size = le32(e + NAME_MAX + 4);
+        c.leds = le16(e + NAME_MAX + 8);
+        c.frames = le16(e + NAME_MAX + 10);
+        c.frameMs = le16(e + NAME_MAX + 12);
+        if (offset > size || c.size > size - offset) return false;
+        c.data = image + offset;
+        state[i] = UNCHECKED;
+      }
+      n = count;
+      return true;
+    }
+
+    uint8_t count() const { return n; }
+    const Info& clip(uint8_t i) const { return clips[i]; }
+
+    // check() once per clip, the first time it is played
+    bool playable(uint8_t i) {
+      if (i >= n) return false;
+      if (state[i] == UNCHECKED) state[i] = check(clips[i]) ? GOOD : BAD;
+      return state[i] == GOOD;
+    }
+
+  private:
+    enum : uint8_t { UNCHECKED, GOOD, BAD };
+    Info clips[MAX_CLIPS];
+    uint8_t state[MAX_CLIPS];
+    uint8_t n = 0;
+  };
+
+  // ---------- Playback ----------
+  // Keeps track of which frame the buffer holds: the next frame is one
+  // record, any other one is decoded from the nearest keyframe before it.
+  class Player {
+  public:
+    static constexpr uint16_t NONE = 0xFFFF;
+
+    void start(const Info* c) { clip = c; current = NONE; }
+    void stop() { clip = nullptr; current = NONE; }
+    void invalidate() { current = NONE; }      // someone else drew into the buffer
+    const Info* playing() const { return clip; }
+    uint16_t frame() const { return current; }
+
+    // Frame (step mod frames) into rgb (room for clip->leds LEDs)
+    void show(uint32_t step, uint8_t* rgb) {
+      if (!clip) return;
+      uint16_t k = (uint16_t)(step % clip->frames);
+      if (k == current) return;
+      uint16_t from = k;
+      while (*frameStart(*clip, from) == TYPE_DELTA && (uint16_t)(from - 1) != current) from--;
+      for (; from <= k; from++) {
+        decode(frameStart(*clip, from), frameEnd(*clip, from), rgb);
+        records++;
+      }
+      current = k;
+      frames++;
+    }
+
+    uint32_t frames = 0;       // frames shown
+    uint32_t records = 0;      // records decoded (more than frames = jumps)
+
+  private:
+    const Info* clip = nullptr;
+    uint16_t current = NONE;
+  };
+
+} // namespace Clip
+
+#endif // CLIP_CODEC_H
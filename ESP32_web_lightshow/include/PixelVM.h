@@ -0,0 +1,224 @@
+/*
+PixelVM.h — tiny stack machine for user-defined per-pixel effects
+- No Arduino dependencies, so it also compiles on a PC (g++) for checking.
+- The page compiles an expression like
+      sin(x + t/64) * 120 + 120, 0, b * 0.9
+  (red, green, blue for one LED) into bytecode, /vm verifies it and keeps
+  it in flash, and show 11 ("Custom") runs it for every LED each step.
+
+Numbers are fixed point Q8 (1.0 = 256) in int32. Inputs:
+  i  LED index        n  LED count       t  step counter
+  x  i / n (0..1)     r g b  previous color of this LED (0..255)
+Ops: + - * / %  < >  c ? a : b  min max abs sin tri rnd
+  sin(v), tri(v): v in turns (1.0 = full circle); sin -1..1, tri 0..1..0
+  rnd(v): hash of v, 0..1 (same v = same number, e.g. rnd(i + t * n))
+Output: three values; each is cut to an integer and clamped to 0..255.
+
+Why it is safe to run anything that passes verify():
+- there are no jumps (c ? a : b evaluates both sides), so a program runs
+  exactly once through its at most PROG_MAX bytes per LED
+- verify() checks every opcode, immediate and the stack depth up front, so
+  run() does no checks at all
+*/
+
+#ifndef PIXEL_VM_H
+#define PIXEL_VM_H
+
+#include <stdint.h>
+
+namespace PixelVM {
+
+  constexpr uint8_t PROG_MAX  = 96;               // bytes of bytecode
+  constexpr uint8_t STACK_MAX = 16;
+  constexpr int32_t ONE       = 256;              // Q8
+
+  enum Op : uint8_t {
+    OP_PUSH16 = 0,    // + int16 LE (Q8 raw)
+    OP_PUSH32,        // + int32 LE (Q8 raw)
+    OP_I, OP_N, OP_T, OP_X, OP_R, OP_G, OP_B,
+    OP_ADD, OP_SUB, OP_MUL, OP_DIV, OP_MOD, OP_MIN, OP_MAX, OP_LT, OP_GT,
+    OP_NEG, OP_ABS, OP_SIN, OP_TRI, OP_RND,
+    OP_SEL,           // c a b -> c ? a : b
+    OP_COUNT
+  };
+
+  enum Error : uint8_t {
+    OK = 0, ERR_EMPTY, ERR_TOO_LONG, ERR_BAD_OP, ERR_TRUNCATED,
+    ERR_UNDERFLOW, ERR_OVERFLOW, ERR_NOT_RGB
+  };
+
+  inline const char* errorText(Error e) {
+    switch (e) {
+      case OK:            return "ok";
+      case ERR_EMPTY:     return "empty program";
+      case ERR_TOO_LONG:  return "program too long";
+      case ERR_BAD_OP:    return "unknown opcode";
+      case ERR_TRUNCATED: return "truncated constant";
+      case ERR_UNDERFLOW: return "stack underflow";
+      case ERR_OVERFLOW:  return "expression too deep";
+      default:            return "must leave exactly 3 values (r, g, b)";
+    }
+  }
+
+  // Stack effect of each opcode: values popped, values pushed
+  inline void stackEffect(uint8_t op, uint8_t& pop, uint8_t& push) {
+    push = 1;
+    if (op <= OP_B)        pop = 0;
+    else if (op <= OP_GT)  pop = 2;
+    else if (op <= OP_RND) pop = 1;
+    else                   pop = 3;               // OP_SEL
+  }
+
+  inline Error verify(const uint8_t* code, uint16_t len) {
+    if (len == 0) return ERR_EMPTY;
+    if (len > PROG_MAX) return ERR_TOO_LONG;
+    uint8_t depth = 0;
+    for (uint16_t pc = 0; pc < len; ) {
+      uint8_t op = code[pc++];
+      if (op >= OP_COUNT) return ERR_BAD_OP;
+      if (op == OP_PUSH16 || op == OP_PUSH32) {
+        uint8_t n = (op == OP_PUSH16) ? 2 : 4;
+        if (pc + n > len) return ERR_TRUNCATED;
+        pc += n;
+      }
+      uint8_t pop, push;
+      stackEffect(op, pop, push);
+      if (depth < pop) return ERR_UNDERFLOW;
+      depth = depth - pop + push;
+      if (depth > STACK_MAX) return ERR_OVERFLOW;
+    }
+    return (depth == 3) ? OK : ERR_NOT_RGB;
+  }
+
+  namespace detail {
+    // sin of a quarter turn in 64 steps, Q8
+    static const uint16_t QSIN[65] = {
+      0, 6, 13, 19, 25, 31, 38, 44, 50, 56, 62, 68, 74, 80, 86, 92,
+      98, 104, 109, 115, 121, 126, 132, 137, 142, 147, 152, 157, 162, 167, 172, 177,
+      181, 185, 190, 194, 198, 202, 206, 209, 213, 216, 220, 223, 226, 229, 231, 234,
+      237, 239, 241, 243, 245, 247, 248, 250, 251, 252, 253, 254, 255, 255, 256, 256,
+      256
+    };
+
+    // v in turns (Q8 -> 256 steps per turn) -> -ONE..ONE
+    inline int32_t sinTurns(int32_t v) {
+      uint8_t a = (uint8_t)v;
+      uint8_t q = a & 63;
+      int32_t s;
+      switch (a >> 6) {
+        case 0:  s =  QSIN[q];      break;
+        case 1:  s =  QSIN[64 - q]; break;
+        case 2:  s = -QSIN[q];      break;
+        default: s = -QSIN[64 - q]; break;
+      }
+      return s;
+    }
+
+    inline int32_t triTurns(int32_t v) {
+      uint8_t a = (uint8_t)v;
+      return (a < 128) ? a * 2 : (256 - a) * 2;
+    }
+
+    inline int32_t rnd(int32_t v) {
+      uint32_t x = (uint32_t)v;
+      x ^= x >> 16; x *= 0x7FEB352DUL; x ^= x >> 15; x *= 0x846CA68BUL; x ^= x >> 16;
+      return (int32_t)(x & 0xFF);
+    }
+
+    inline int32_t read16(const uint8_t* p) { return (int16_t)(p[0] | (p[1] << 8)); }
+    inline int32_t read32(const uint8_t* p) {
+      return (int32_t)((uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24));
+    }
+
+    // Result of a mod is never negative (so i % 3 works for negative i too)
+    inline int32_t mod(int32_t a, int32_t b) {
+      if (b == 0) return 0;
+      int64_t m = (int64_t)a % b;
+      if (m < 0) m += (b < 0) ? -(int64_t)b : b;
+      return (int32_t)m;
+    }
+
+    inline uint8_t channel(int32_t v) {
+      v >>= 8;
+      return (v < 0) ? 0 : (v > 255) ? 255 : (uint8_t)v;
+    }
+  } // namespace detail
+
+  // Inputs of one LED; n and t stay the same for the whole frame
+  struct Pixel {
+    uint16_t i, n;
+    uint32_t t;
+    uint8_t  r, g, b;
+  };
+
+  // Overflow wraps around (two's complement) instead of being undefined
+  inline int32_t wrap(uint32_t v) { return (int32_t)v; }
+
+  // Runs a program that passed verify() (px.n must not be 0). Writes r, g, b.
+  // The top of the stack lives in a register (tos); stack[] holds the rest.
+  inline void run(const uint8_t* code, uint8_t len, const Pixel& px, uint8_t out[3]) {
+    int32_t stack[STACK_MAX + 1];                 // [0] = dummy pushed by the first op
+    int32_t* sp = stack;                          // next free slot
+    int32_t tos = 0;
+    int32_t a;
+    const uint8_t* pc = code;
+    const uint8_t* end = code + len;
+
+#define PIXELVM_PUSH(v)   *sp++ = tos; tos = (v);
+#define PIXELVM_POP()     (*--sp)
+#if defined(__GNUC__) && !defined(PIXELVM_SWITCH_DISPATCH)
+    // Direct-threaded dispatch: one indirect jump per opcode, no bounds check
+    static const void* const LABELS[OP_COUNT] = {
+      &&L_PUSH16, &&L_PUSH32, &&L_I, &&L_N, &&L_T, &&L_X, &&L_R, &&L_G, &&L_B,
+      &&L_ADD, &&L_SUB, &&L_MUL, &&L_DIV, &&L_MOD, &&L_MIN, &&L_MAX, &&L_LT, &&L_GT,
+      &&L_NEG, &&L_ABS, &&L_SIN, &&L_TRI, &&L_RND, &&L_SEL
+    };
+#define PIXELVM_OP(name)  L_##name:
+#define PIXELVM_NEXT      if (pc == end) goto done; goto *LABELS[*pc++];
+    PIXELVM_NEXT
+#else
+#define PIXELVM_OP(name)  case OP_##name:
+#define PIXELVM_NEXT      continue;
+    while (pc != end) switch (*pc++) {
+#endif
+      PIXELVM_OP(PUSH16) PIXELVM_PUSH(detail::read16(pc)); pc += 2; PIXELVM_NEXT
+      PIXELVM_OP(PUSH32) PIXELVM_PUSH(detail::read32(pc)); pc += 4; PIXELVM_NEXT
+      PIXELVM_OP(I)   PIXELVM_PUSH((int32_t)px.i << 8)          PIXELVM_NEXT
+      PIXELVM_OP(N)   PIXELVM_PUSH((int32_t)px.n << 8)          PIXELVM_NEXT
+      PIXELVM_OP(T)   PIXELVM_PUSH((int32_t)(px.t << 8))        PIXELVM_NEXT
+      PIXELVM_OP(X)   PIXELVM_PUSH(((int32_t)px.i << 8) / px.n) PIXELVM_NEXT
+      PIXELVM_OP(R)   PIXELVM_PUSH((int32_t)px.r << 8)          PIXELVM_NEXT
+      PIXELVM_OP(G)   PIXELVM_PUSH((int32_t)px.g << 8)          PIXELVM_NEXT
+      PIXELVM_OP(B)   PIXELVM_PUSH((int32_t)px.b << 8)          PIXELVM_NEXT
+      PIXELVM_OP(ADD) a = PIXELVM_POP(); tos = wrap((uint32_t)a + (uint32_t)tos); PIXELVM_NEXT
+      PIXELVM_OP(SUB) a = PIXELVM_POP(); tos = wrap((uint32_t)a - (uint32_t)tos); PIXELVM_NEXT
+      PIXELVM_OP(MUL) a = PIXELVM_POP(); tos = wrap((uint32_t)(((int64_t)a * tos) >> 8)); PIXELVM_NEXT
+      PIXELVM_OP(DIV) a = PIXELVM_POP(); tos = tos ? wrap((uint32_t)(((int64_t)a * ONE) / tos)) : 0; PIXELVM_NEXT
+      PIXELVM_OP(MOD) a = PIXELVM_POP(); tos = detail::mod(a, tos);   PIXELVM_NEXT
+      PIXELVM_OP(MIN) a = PIXELVM_POP(); if (a < tos) tos = a;        PIXELVM_NEXT
+      PIXELVM_OP(MAX) a = PIXELVM_POP(); if (a > tos) tos = a;        PIXELVM_NEXT
+      PIXELVM_OP(LT)  a = PIXELVM_POP(); tos = (a < tos) ? ONE : 0;   PIXELVM_NEXT
+      PIXELVM_OP(GT)  a = PIXELVM_POP(); tos = (a > tos) ? ONE : 0;   PIXELVM_NEXT
+      PIXELVM_OP(NEG) tos = wrap(0u - (uint32_t)tos);                 PIXELVM_NEXT
+      PIXELVM_OP(ABS) if (tos < 0) tos = wrap(0u - (uint32_t)tos);    PIXELVM_NEXT
+      PIXELVM_OP(SIN) tos = detail::sinTurns(tos);                    PIXELVM_NEXT
+      PIXELVM_OP(TRI) tos = detail::triTurns(tos);                    PIXELVM_NEXT
+      PIXELVM_OP(RND) tos = detail::rnd(tos);                         PIXELVM_NEXT
+      PIXELVM_OP(SEL) a = PIXELVM_POP(); tos = PIXELVM_POP() ? a : tos; PIXELVM_NEXT   // c a tos
+#if defined(__GNUC__) && !defined(PIXELVM_SWITCH_DISPATCH)
+  done:
+#else
+    }
+#endif
+#undef PIXELVM_OP
+#undef PIXELVM_NEXT
+#undef PIXELVM_PUSH
+#undef PIXELVM_POP
+    out[0] = detail::channel(stack[1]);           // verify() guarantees depth 3
+    out[1] = detail::channel(stack[2]);
+    out[2] = detail::channel(tos);
+  }
+
+} // namespace PixelVM
+
+#endif // PIXEL_VM_H
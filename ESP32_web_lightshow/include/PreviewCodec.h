@@ -0,0 +1,147 @@
+/*
+PreviewCodec.h — LED preview stream for the web page (WebSocket, binary)
+- No Arduino dependencies, so it also compiles on a PC (g++) for checking.
+
+Message layout (all frames RGB, 3 bytes per LED):
+  [0] 'K' keyframe | 'D' delta
+  [1] seq (client acks it by sending the same byte back)
+  [2] LED count
+  'K': count * RGB
+  'D': tokens until all LEDs are covered (trailing unchanged LEDs are omitted)
+       0x00..0x7F  skip (t + 1) unchanged LEDs
+       0x80..0xFF  (t - 0x7F) changed LEDs follow, RGB each
+
+Pacing (per client):
+- at most MAX_IN_FLIGHT unacked frames; a client that stops acking is not
+  sent anything, so a slow phone never blocks loop() on a full TCP buffer
+- each time a frame is due but the client is still behind, its interval
+  doubles (up to INTERVAL_MAX_MS); each ack that empties the pipe shrinks
+  it by 1/8 toward INTERVAL_MIN_MS
+*/
+
+#ifndef PREVIEW_CODEC_H
+#define PREVIEW_CODEC_H
+
+#include <stdint.h>
+#include <string.h>
+
+namespace Preview {
+
+  constexpr uint8_t  TYPE_KEY   = 'K';
+  constexpr uint8_t  TYPE_DELTA = 'D';
+  constexpr uint8_t  HEADER = 3;
+  constexpr uint8_t  RUN_MAX = 128;               // skip / literal run per token
+
+  // Worst case is a keyframe: header + 3 bytes per LED
+  constexpr uint16_t maxMessage(uint16_t leds) { return HEADER + leds * 3; }
+
+  inline bool samePixel(const uint8_t* a, const uint8_t* b) {
+    return a[0] == b[0] && a[1] == b[1] && a[2] == b[2];
+  }
+
+  inline uint16_t encodeKey(uint8_t* out, uint8_t seq, const uint8_t* rgb, uint8_t count) {
+    out[0] = TYPE_KEY; out[1] = seq; out[2] = count;
+    memcpy(out + HEADER, rgb, count * 3);
+    return HEADER + count * 3;
+  }
+
+  // Delta of 'rgb' against 'prev' (what the client has now). Falls back to a
+  // keyframe when that is not larger. Returns 0 if nothing changed.
+  inline uint16_t encode(uint8_t* out, uint8_t seq, const uint8_t* rgb, const uint8_t* prev, uint8_t count) {
+    uint16_t n = HEADER;
+    uint16_t keySize = HEADER + count * 3;
+    uint8_t i = 0;
+    while (i < count) {
+      uint8_t run = 0;
+      while (i + run < count && samePixel(rgb + (i + run) * 3, prev + (i + run) * 3)) run++;
+      if (run) {
+        if (i + run == count) break;              // rest unchanged: no token needed
+        while (run) {                             // longer than RUN_MAX: several tokens
+          uint8_t skip = (run > RUN_MAX) ? RUN_MAX : run;
+          if (n + 1 >= keySize) return encodeKey(out, seq, rgb, count);
+          out[n++] = skip - 1;
+          i += skip;
+          run -= skip;
+        }
+        continue;
+      }
+      while (i + run < count && run < RUN_MAX && !samePixel(rgb + (i + run) * 3, prev + (i + run) * 3)) run++;
+      if (n + 1 + run * 3 >= keySize) return encodeKey(out, seq, rgb, count);
+      out[n++] = 0x7F + run;
+      memcpy(out + n, rgb + i * 3, run * 3);
+      n += run * 3;
+      i += run;
+    }
+    if (n == HEADER) return 0;
+    out[0] = TYPE_DELTA; out[1] = seq; out[2] = count;
+    return n;
+  }
+
+  // Applies a message to 'frame' (room for 'capacity' LEDs). 'count' is the
+  // LED count the frame holds now and is updated by keyframes. Returns false
+  // if the message is malformed or does not fit; the frame may then be partial.
+  inline bool decode(uint8_t* frame, uint16_t capacity, uint8_t& count, const uint8_t* msg, uint16_t len) {
+    if (len < HEADER) return false;
+    uint8_t n = msg[2];
+    if (msg[0] == TYPE_KEY) {
+      if (n > capacity || len != HEADER + n * 3) return false;
+      memcpy(frame, msg + HEADER, n * 3);
+      count = n;
+      return true;
+    }
+    if (msg[0] != TYPE_DELTA || n != count) return false;
+    uint16_t p = HEADER, i = 0;
+    while (p < len) {
+      uint8_t t = msg[p++];
+      if (t < 0x80) { i += t + 1; continue; }
+      uint16_t run = t - 0x7F;
+      if (i + run > n || p + run * 3 > len) return false;
+      memcpy(frame + i * 3, msg + p, run * 3);
+      p += run * 3;
+      i += run;
+    }
+    return i <= n;
+  }
+
+  // ---------- Per-client pacing ----------
+  constexpr uint16_t INTERVAL_MIN_MS = 50;        // cap: 20 previews/s
+  constexpr uint16_t INTERVAL_MAX_MS = 2000;
+  constexpr uint8_t  MAX_IN_FLIGHT   = 2;
+
+  struct Pacer {
+    uint16_t intervalMs = INTERVAL_MIN_MS;
+    uint32_t lastSendMs = 0;
+    uint8_t  sentSeq = 0;
+    uint8_t  ackedSeq = 0;
+
+    uint8_t inFlight() const { return (uint8_t)(sentSeq - ackedSeq); }
+
+    void reset(uint32_t now) { *this = Pacer(); lastSendMs = now - INTERVAL_MIN_MS; }
+
+    // True if a frame may go out now; backs off while the client is behind
+    bool ready(uint32_t now) {
+      if (now - lastSendMs < intervalMs) return false;
+      if (inFlight() >= MAX_IN_FLIGHT) {
+        intervalMs = (intervalMs * 2 > INTERVAL_MAX_MS) ? INTERVAL_MAX_MS : intervalMs * 2;
+        lastSendMs = now;                         // look again one (longer) interval later
+        return false;
+      }
+      return true;
+    }
+
+    uint8_t nextSeq() const { return (uint8_t)(sentSeq + 1); }
+    uint8_t sent(uint32_t now) { lastSendMs = now; return ++sentSeq; }
+    void unchanged(uint32_t now) { lastSendMs = now; }   // nothing to send this time
+
+    void acked(uint8_t seq) {
+      if ((uint8_t)(sentSeq - seq) >= inFlight()) return;   // stale or bogus ack
+      ackedSeq = seq;
+      if (inFlight() == 0 && intervalMs > INTERVAL_MIN_MS) {
+        intervalMs -= (intervalMs - INTERVAL_MIN_MS + 7) / 8;
+      }
+    }
+  };
+
+} // namespace Preview
+
+#endif // PREVIEW_CODEC_H
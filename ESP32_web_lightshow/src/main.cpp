@@ -20,6 +20,15 @@ JAK SE PŘIPOJIT Z MOBILU
    Heslo: ardoremy123
 3) Otevři prohlížeč a napiš adresu:  http://192.168.1.100
 4) Ovládej tlačítky "Show 1–5", "OFF", posuvníky pro Brightness a Speed.
+5) Nahoře na stránce je živý náhled pásku (WebSocket na portu 81,
+   posílají se jen změněné LED – viz include/PreviewCodec.h).
+6) Víc kontrolérů podél pódia: na jednom otevři /sync?role=1 (master),
+   na ostatních /sync?role=2 (follower), všude stejné &group=.
+   Ovládat jde kterýkoli z nich, změna se pošle všem (ESP-NOW) a pásky
+   ukazují stejný krok show (MySync.h).
+7) Předem připravené klipy (logo, ručně kreslené sekvence): obrázky
+   převeď nástrojem tools/clip_encode.cpp do clips.bin, nahraj ho do
+   oddílu "clips" (partitions.csv) a pusť tlačítky Clip 1–4 (show 12–15).
 
 ÚKOLY, PRO POCHOPENÍ KÓDU (zkus bez nápovědy)
 ---------------------------------------------------------------
@@ -37,18 +46,61 @@ JAK SE PŘIPOJIT Z MOBILU
 9) Proč nepoužíváme delay()? Kde v kódu je „časování“?
 10) Dokážeš udělat, aby „OFF“ pouze vypnulo zobrazování, ale po zapnutí
     se show rozběhla z místa, kde skončila?
+11) Kolik bajtů za sekundu stojí náhled u Rainbow a kolik u Strobe
+    (/status)? Proč je takový rozdíl?
+12) Napiš vlastní efekt v kartě „Custom Effect“ (show 11) – bez
+    přeflashování. Proč v jazyce není cyklus ani if s odskokem?
+13) Přepni Rainbow na paletu Ocean a zkus Blend „multiply“ s různou
+    základní barvou. Proč se tabulka palety nepočítá v každém kroku?
+14) Dej OFF (nebo Strobe s rychlostí 1000 ms) a po chvíli otevři /status.
+    Kolik času bylo ESP32 ve stavu static a sleep? Proč se v režimu
+    Access Point nedá usnout úplně (MyPower)?
+15) Stiskni reset a podívej se do Serial monitoru na „Boot“ (nebo do
+    /status). Co trvá nejdéle? Proč se Wi-Fi spouští až po prvním snímku?
+16) Zapni Sparkle, stáhni jas na 5 a zase na 255. Proč jiskry nezůstanou
+    tmavší? Pak zkus /set?gamma=22 a /set?kelvin=3000 – co se stane
+    s bílou a s tmavými barvami? (MyOutput.h)
+17) Nastav /set?budget=500 a pusť Strobe v bílé. Co ukáže /status
+    v řádku Current? Proč se jas při návratu na Rainbow zvedá pomalu?
+18) Dva kontroléry: na jednom /sync?role=1, na druhém /sync?role=2
+    (stejné group). Přepni show na kterémkoli z nich. Proč oheň
+    a jiskry vypadají na obou stejně, i když jsou „náhodné“? Co ukáže
+    /status v řádku Sync po vypnutí mastera? (MySync.h)
+19) Nakresli v malování obrázek 60 × 100 pixelů (každý řádek = jeden
+    snímek) a udělej z něj klip: clip_encode clips.bin -sheet obr.ppm.
+    Kolik bajtů má na snímek (výpis nástroje a /status)? Proč je
+    kometa na černém pozadí tak malá a šum skoro stejně velký jako surová data?
 
 **************************************************************/
 
 #include <WiFi.h>
 #include <WebServer.h>
 #include <Adafruit_NeoPixel.h>
+#include <WebSocketsServer.h>   // "WebSockets" by Markus Sattler (links2004)
+#include <Preferences.h>
+#include "PreviewCodec.h"
+#include "PixelVM.h"
+#include "ClipCodec.h"          // klipy z flash: klíčový snímek + změny, čtení bez kopie do RAM
+#include <esp_partition.h>
+#include <esp_arduino_version.h>
+#include <MyPalette.h>      // palety MyShows (lib_extra_dirs v platformio.ini)
+#include <MyNoise.h>        // plynulý šum pro oheň (MyShows)
+#include <MyOutput.h>       // jas, gama, teplota bílé a pořadí GRB jedním průchodem (MyShows)
+#include <MyLog.h>          // výpisy bez čekání na UART a bez String (tiskne je úloha s nejnižší prioritou)
+#include <MyPower.h>        // stojící snímky se neposílají, v klidu nižší takt procesoru
+#include <MyBoot.h>         // časová osa startu (výpis v Serialu a v /status)
+#include <MySync.h>         // víc kontrolérů: sdílený čas a stav show přes ESP-NOW
 
 // ====== UPRAV PODLE SVÉHO HARDWARE ======
 #define LED_PIN     5         // Datový pin do LED (GPIO5 = D5)
 #define MAX_LEDS    60         // Maximum number of LEDs supported
 #define LED_TYPE_GRB NEO_GRB  // Většina pásků je GRB
 #define LED_FREQ     NEO_KHZ800
+#define BOOT_LED_TEST 0       // 1 = po startu krátce R, G, B (až po prvním snímku)
+#define CURRENT_BUDGET_MA 2000 // zdroj pro pásek v mA (/set?budget=, 0 = jen měřit)
+#define CURRENT_CHANNEL_MA 20  // 1 LED, jeden kanál naplno (WS2812B ~20 mA)
+#define SYNC_CATCHUP 128       // follower dožene nejvýš tolik kroků najednou (oheň se srovná za ~100)
+#define SYNC_WAIT_US 2000      // krok začíná do 2 ms: počkej na něj přesně (delayMicroseconds)
 
 // Dynamic LED count (configurable via web)
 uint16_t NUM_LEDS = 12;        // Default LED count
@@ -65,6 +117,47 @@ IPAddress subnet(255, 255, 255, 0);       // Subnet mask
 // ====== NeoPixel objekt ======
 Adafruit_NeoPixel strip(MAX_LEDS, LED_PIN, LED_TYPE_GRB | LED_FREQ);
 
+// ====== Logický snímek ======
+// Show kreslí sem (R, G, B v plné přesnosti, bez jasu) a čtou si odsud
+// minulý snímek. Jas, gama, teplota bílé a pořadí GRB se přidají až cestou
+// do bufferu pásku (showFrame) – strip.setBrightness() se nepoužívá,
+// protože přepisuje barvy v bufferu a každá změna jasu by je ořezala.
+uint8_t frame[MAX_LEDS * 3];
+MyShows::Output<MyShows::OrderGRB> output;   // pořadí jako LED_TYPE_GRB
+MyPower::CurrentLimit current;               // odhad proudu ze součtů výstupu, omezení jasu
+
+void setPixel(uint16_t i, uint8_t r, uint8_t g, uint8_t b) {
+  if (i >= MAX_LEDS) return;
+  uint8_t* p = frame + i * 3;
+  p[0] = r; p[1] = g; p[2] = b;
+}
+
+void setPixel(uint16_t i, uint32_t c) { setPixel(i, c >> 16, c >> 8, c); }
+
+uint32_t getPixel(uint16_t i) {
+  const uint8_t* p = frame + i * 3;
+  return (uint32_t)p[0] << 16 | (uint32_t)p[1] << 8 | p[2];
+}
+
+// Snímek do bufferu pásku (jeden průchod přes tabulky, cestou součty pro odhad proudu).
+// Přes rozpočet zdroje: stejný snímek znovu a tmavší – ven nejde nic nad rozpočet.
+void writeFrame() {
+  output.write(frame, strip.getPixels(), NUM_LEDS);
+  uint32_t events = current.events();
+  while (!current.check(output.sum(), NUM_LEDS, millis())) {
+    output.limit(current.limit());
+    output.write(frame, strip.getPixels(), NUM_LEDS);
+  }
+  output.limit(current.limit());   // plynulé omezení pro další snímek
+  if (current.events() != events)
+    MYLOG_W("Current limit: %lu mA estimated, budget %u mA", current.lastMa(), current.budgetMa);
+}
+
+void showFrame() {
+  writeFrame();
+  strip.show();
+}
+
 // ====== Animace / stav ======
 enum ShowType {
   SHOW_OFF = 0,
@@ -77,7 +170,13 @@ enum ShowType {
   SHOW_7_WAVE,
   SHOW_8_PULSE,
   SHOW_9_CHASE,
-  SHOW_10_STROBE
+  SHOW_10_STROBE,
+  SHOW_11_CUSTOM,     // user program from the page (PixelVM)
+  SHOW_12_CLIP1,      // clips 1..4 from the "clips" flash partition (ClipCodec.h)
+  SHOW_13_CLIP2,
+  SHOW_14_CLIP3,
+  SHOW_15_CLIP4,
+  SHOW_COUNT
 };
 
 volatile ShowType currentShow = SHOW_1_RAINBOW;
@@ -93,9 +192,81 @@ uint8_t baseR = 255, baseG = 60, baseB = 0;  // Starting color for shows
 uint8_t fireR = 255, fireG = 100, fireB = 0; // Fire colors
 uint8_t waveR = 0, waveG = 150, waveB = 255; // Wave colors
 
+// Palety: každá show si vybere paletu indexem (MyShows::PAL_...), tabulka 256 barev
+// se přepočítá jen při změně show / palety / míchání / základní barvy (rebuildPalette)
+#define NO_PALETTE 0xFF
+uint8_t showPalette[SHOW_COUNT] = {
+  NO_PALETTE, MyShows::PAL_RAINBOW, NO_PALETTE, NO_PALETTE, NO_PALETTE, NO_PALETTE,
+  MyShows::PAL_HEAT, NO_PALETTE, NO_PALETTE, NO_PALETTE, NO_PALETTE, NO_PALETTE,
+  NO_PALETTE, NO_PALETTE, NO_PALETTE, NO_PALETTE
+};
+MyShows::Palette palette;                    // paleta aktuální show, smíchaná se základní barvou
+uint8_t paletteBlend = MyShows::BLEND_LERP;
+uint8_t paletteAmount = 0;                   // 0 = čistá paleta, 255 = plně smíchaná s baseR,G,B
+MyShows::NoiseFire<MAX_LEDS> fire;           // teplo buněk ohně (show 6), index 0 = spodek plamene
+
+// Show, jas, rychlost, počet LED a barva: uloží se 2 s po poslední změně
+// (posuvník jasu by jinak zapisoval do flash při každém pohybu)
+Preferences prefs;
+bool settingsDirty = false;
+uint32_t settingsChangedMs = 0;
+MyBoot::Timeline boot;
+
+// Test pásku bez delay(): R, G, B po 50 ms, pak zase show (běží z loop())
+uint8_t ledTestStep = 0;         // 0 = neběží
+uint32_t ledTestMs = 0;
+
+// Custom effect (show 11): verified bytecode, kept in flash (NVS) across reboots
+uint8_t vmCode[PixelVM::PROG_MAX];
+uint8_t vmLen = 0;
+
+// ====== Klipy z flash (show 12–15) ======
+// Oddíl "clips" je namapovaný do adresního prostoru procesoru: přehrávač
+// čte klip přímo z flash do frame, v RAM je jen adresář (~0,5 kB)
+Clip::Library clips;
+Clip::Player clipPlayer;
+uint32_t clipMapKB = 0;              // 0 = oddíl chybí nebo nejde namapovat
+
+// ====== Víc kontrolérů (MySync) ======
+// Master posílá čas a stav show, followeři z něj počítají stepIndex –
+// všechny pásky ve skupině ukazují stejný snímek. ESP-NOW běží na kanálu AP.
+// Role a skupina: /sync?role=0|1|2&group=1..255 (uloží se)
+MySync::Node syncNode;
+MySync::Radio radio;
+uint32_t syncId = 0;                 // konec MAC; 0 = rádio pro sync neběží
+uint32_t showSeed = 1;               // náhoda aktuální show – ve skupině všude stejná
+
+// ====== Úspora energie ======
+// Access Point drží rádio pořád zapnuté, takže lehký spánek nejde:
+// v klidu jen 80 MHz a delší pauza v loop()
+MyPower::Policy power;
+MyPower::Governor governor;
+
 // ====== Web server ======
 WebServer server(80);
 
+// Každý HTTP požadavek = vstup od uživatele (plná rychlost, odpočet do spánku znovu)
+template<void (*HANDLER)()> void withActivity() {
+  power.activity(millis());
+  HANDLER();
+}
+
+// ====== Live preview (WebSocket :81, format in include/PreviewCodec.h) ======
+WebSocketsServer previewWs(81);
+#define PREVIEW_CLIENTS 4                 // = max. klientů v WiFi.softAP()
+
+struct PreviewClient {
+  bool connected;
+  Preview::Pacer pacer;
+  uint8_t count;                          // LED count the client has (0 = needs keyframe)
+  uint8_t last[MAX_LEDS * 3];             // what the client is showing now
+};
+PreviewClient previewClients[PREVIEW_CLIENTS];
+uint8_t previewMsg[Preview::maxMessage(MAX_LEDS)];
+uint32_t previewBytesByShow[SHOW_COUNT];   // for /status: B/s per show
+uint32_t previewMsByShow[SHOW_COUNT];
+uint32_t previewLastMs = 0;
+
 // Jednoduchá HTML stránka – vše v jedné proměnné a bez externích souborů
 const char PAGE_html[] PROGMEM = R"HTML(
 <!DOCTYPE html>
@@ -360,6 +531,24 @@ input[type="range"]::-moz-range-thumb {
   color: white;
 }
 
+.preview {
+  display: block;
+  width: 100%;
+  height: 40px;
+  background: #111;
+  border-radius: 8px;
+}
+
+.vm-src, .vm-preset, .pal-select {
+  width: 100%;
+  font-family: monospace;
+  font-size: 0.95rem;
+  padding: 10px;
+  margin-bottom: 10px;
+  border: 1px solid #dee2e6;
+  border-radius: 8px;
+}
+
 .color-wheel-container {
   display: flex;
   flex-direction: column;
@@ -497,6 +686,12 @@ input[type="range"]::-moz-range-thumb {
   </div>
 
   <div class="content">
+    <div class="card">
+      <div class="card-title">&#128250; Live Preview</div>
+      <canvas id="preview" class="preview" width="760" height="40"></canvas>
+      <div class="help-text" id="pvInfo">Connecting...</div>
+    </div>
+
     <div class="card">
       <div class="card-title">&#127917; Light Shows</div>
       <div class="btns">
@@ -510,6 +705,11 @@ input[type="range"]::-moz-range-thumb {
         <button onclick="send('/cmd?show=8')">&#128165; Pulse</button>
         <button onclick="send('/cmd?show=9')">&#128293; Chase</button>
         <button onclick="send('/cmd?show=10')">&#9889; Strobe</button>
+        <button onclick="send('/cmd?show=11')">&#129513; Custom</button>
+        <button onclick="send('/cmd?show=12')">&#127902;&#65039; Clip 1</button>
+        <button onclick="send('/cmd?show=13')">&#127902;&#65039; Clip 2</button>
+        <button onclick="send('/cmd?show=14')">&#127902;&#65039; Clip 3</button>
+        <button onclick="send('/cmd?show=15')">&#127902;&#65039; Clip 4</button>
         <button onclick="send('/cmd?show=0')" class="off-btn">&#128308; OFF</button>
         <button onclick="send('/test')" class="test-btn">&#128300; Test LEDs</button>
       </div>
@@ -545,6 +745,14 @@ input[type="range"]::-moz-range-thumb {
       <div class="help-text">Number of LEDs in your strip (1-60)</div>
     </div>
 
+    <div class="card">
+      <div class="card-title">&#129513; Custom Effect</div>
+      <select id="vmPreset" class="vm-preset" onchange="vmSrc.value=this.value"></select>
+      <textarea id="vmSrc" class="vm-src" rows="3" spellcheck="false"></textarea>
+      <button onclick="vmUpload()">&#11014;&#65039; Upload &amp; Run</button>
+      <div class="help-text" id="vmMsg">red, green, blue &mdash; inputs: i n t x r g b &middot; + - * / % &lt; &gt; ?: &middot; min max abs sin tri rnd</div>
+    </div>
+
     <div class="card">
       <div class="card-title">&#127912; Color Wheel</div>
       <div class="color-wheel-container">
@@ -557,6 +765,19 @@ input[type="range"]::-moz-range-thumb {
           <small>Affects: Theater, Breath, Chase, Strobe, Pulse</small>
         </div>
       </div>
+      <select id="pal" class="pal-select" onchange="sendPalette()"></select>
+      <select id="blend" class="pal-select" onchange="sendPalette()">
+        <option value="0">Blend: lerp</option><option value="1">Blend: add</option>
+        <option value="2">Blend: multiply</option><option value="3">Blend: screen</option>
+      </select>
+      <div class="control-row">
+        <div class="control-label">&#127752; Mix</div>
+        <div class="slider-container">
+          <input id="amt" type="range" min="0" max="255" value="0" oninput="amtv.textContent=this.value; debouncePalette()">
+        </div>
+        <div class="value-display" id="amtv">0</div>
+      </div>
+      <div class="help-text">Palette of the running show (Rainbow, Fire), mixed with the picked color</div>
     </div>
   </div>
 </div>
@@ -640,6 +861,19 @@ function updateColorOnServer() {
   t2 = setTimeout(()=>send(`/color?r=${currentColor.r}&g=${currentColor.g}&b=${currentColor.b}`), 200);
 }
 
+// Same order as MyShows::PaletteId (MyShows/MyPalette.h)
+const PALETTES = ['Rainbow', 'Heat', 'Ocean', 'Forest', 'Party', 'Basic', 'Pastel'];
+PALETTES.forEach((n, i) => pal.add(new Option('Palette: ' + n, i)));
+
+function sendPalette() {
+  send(`/color?palette=${pal.value}&blend=${blend.value}&amount=${amt.value}`);
+}
+
+function debouncePalette() {
+  if(t3) clearTimeout(t3);
+  t3 = setTimeout(sendPalette, 200);
+}
+
 function send(url){ 
   const statusEl = document.getElementById('status');
   statusEl.textContent = 'Sending...';
@@ -667,81 +901,193 @@ function send(url){
     }); 
 }
 
-let t1=null, t2=null;
+let t1=null, t2=null, t3=null;
 function debounceSet(url){
   if(t1) clearTimeout(t1);
   t1 = setTimeout(()=>send(url), 120);
 }
-</script>
-</html>
-)HTML";
 
-// ---------- Pomocné funkce pro barvy ----------
-uint32_t colorWheel(byte pos) {
-  pos = 255 - pos;
-  if(pos < 85) {
-    return strip.Color(255 - pos * 3, 0, pos * 3);
+// Live preview: 'K' = all LEDs, 'D' = only changed runs (see PreviewCodec.h)
+let pv = new Uint8Array(0), pvBytes = 0, pvAck = -1;
+
+function pvDecode(f, m) {
+  if (m.length < 3) return null;
+  const n = m[2];
+  if (m[0] === 75) return (m.length === 3 + n * 3) ? m.slice(3) : null;   // 'K'
+  if (m[0] !== 68 || f.length !== n * 3) return null;                      // 'D'
+  let p = 3, i = 0;
+  while (p < m.length) {
+    const t = m[p++];
+    if (t < 128) { i += t + 1; continue; }
+    const run = t - 127;
+    if (i + run > n || p + run * 3 > m.length) return null;
+    f.set(m.subarray(p, p + run * 3), i * 3);
+    p += run * 3; i += run;
   }
-  if(pos < 170) {
-    pos -= 85;
-    return strip.Color(0, pos * 3, 255 - pos * 3);
+  return f;
+}
+
+function pvDraw() {
+  const c = document.getElementById('preview'), g = c.getContext('2d'), n = pv.length / 3;
+  g.fillStyle = '#111';
+  g.fillRect(0, 0, c.width, c.height);
+  if (!n) return;
+  const w = c.width / n, r = Math.max(1, Math.min(w, c.height) / 2 - 1);
+  for (let i = 0; i < n; i++) {
+    g.fillStyle = `rgb(${pv[i*3]},${pv[i*3+1]},${pv[i*3+2]})`;
+    g.beginPath();
+    g.arc(w * i + w / 2, c.height / 2, r, 0, 2 * Math.PI);
+    g.fill();
   }
-  pos -= 170;
-  return strip.Color(pos * 3, 255 - pos * 3, 0);
 }
 
-void clearStrip() {
-  for (uint16_t i = 0; i < NUM_LEDS; i++) strip.setPixelColor(i, 0);
+function pvConnect() {
+  const ws = new WebSocket(`ws://${location.hostname}:81/`);
+  ws.binaryType = 'arraybuffer';
+  ws.onmessage = e => {
+    const m = new Uint8Array(e.data), f = pvDecode(pv, m);
+    pvBytes += m.length;
+    if (!f) return;
+    pv = f;
+    // Ack from the next paint: a hidden tab stops acking and the ESP32 backs off
+    if (pvAck < 0) requestAnimationFrame(() => {
+      pvDraw();
+      if (ws.readyState === 1) ws.send(new Uint8Array([pvAck]));
+      pvAck = -1;
+    });
+    pvAck = m[1];
+  };
+  ws.onclose = () => {
+    document.getElementById('pvInfo').textContent = 'Reconnecting...';
+    pvAck = -1;
+    setTimeout(pvConnect, 1000);
+  };
+}
+// Custom effect compiler: "red, green, blue" expressions -> PixelVM bytecode
+// (opcodes and number format in include/PixelVM.h; the ESP32 verifies it again)
+const VM_OP = {i:2, n:3, t:4, x:5, r:6, g:7, b:8, '+':9, '-':10, '*':11, '/':12, '%':13,
+               min:14, max:15, '<':16, '>':17, neg:18, abs:19, sin:20, tri:21, rnd:22, sel:23};
+const VM_FN = {min:2, max:2, abs:1, sin:1, tri:1, rnd:1};
+
+function vmCompile(src) {
+  const tok = src.toLowerCase().match(/\d+\.?\d*|\.\d+|[a-z]+|\S/g) || [];
+  let p = 0;
+  const out = [];
+  const is = (...o) => o.includes(tok[p]);
+  const take = want => {
+    const t = tok[p++];
+    if (want && t !== want) throw `expected '${want}' but found '${t || 'end'}'`;
+    return t;
+  };
+  const num = v => {
+    const q = Math.round(v * 256);                 // Q8
+    if (q >= -32768 && q <= 32767) out.push(0, q & 255, (q >> 8) & 255);
+    else out.push(1, q & 255, (q >> 8) & 255, (q >> 16) & 255, (q >>> 24) & 255);
+  };
+  const primary = () => {
+    const t = take();
+    if (t === undefined) throw 'unexpected end';
+    if (/^[\d.]/.test(t)) return num(parseFloat(t));
+    if (t === '(') { expr(); take(')'); return; }
+    if (t.length === 1 && 'intxrgb'.includes(t)) return out.push(VM_OP[t]);
+    if (!/^[a-z]/.test(t)) throw `unexpected '${t}'`;
+    if (!VM_FN[t]) throw `unknown name '${t}'`;
+    take('('); expr();
+    if (VM_FN[t] === 2) { take(','); expr(); }
+    take(')'); out.push(VM_OP[t]);
+  };
+  const unary = () => { if (is('-')) { take(); unary(); out.push(VM_OP.neg); } else primary(); };
+  const mul = () => { unary(); while (is('*', '/', '%')) { const o = take(); unary(); out.push(VM_OP[o]); } };
+  const add = () => { mul(); while (is('+', '-')) { const o = take(); mul(); out.push(VM_OP[o]); } };
+  const cmp = () => { add(); if (is('<', '>')) { const o = take(); add(); out.push(VM_OP[o]); } };
+  const expr = () => { cmp(); if (is('?')) { take(); expr(); take(':'); expr(); out.push(VM_OP.sel); } };
+  expr(); take(','); expr(); take(','); expr();
+  if (p < tok.length) throw `unexpected '${tok[p]}'`;
+  if (out.length > 96) throw `too long: ${out.length} bytes (max 96)`;
+  return out;
+}
+
+const VM_PRESETS = {
+  'Plasma':  'sin(x + t/64) * 120 + 120, sin(2*x - t/50) * 120 + 120, sin(3*x + t/80) * 120 + 120',
+  'Rainbow': 'sin(x + t/256) * 127 + 128, sin(x + t/256 + 0.333) * 127 + 128, sin(x + t/256 + 0.667) * 127 + 128',
+  'Embers':  'max(r * 0.9, rnd(i + t*n) * 255), g * 0.7, 0',
+  'Sparkle': 'rnd(i + t*n) > 0.97 ? 255 : r * 0.85, rnd(i + t*n) > 0.97 ? 255 : g * 0.85, rnd(i + t*n) > 0.97 ? 255 : b * 0.85',
+  'Theater': '(i + t) % 3 < 1 ? 255 : 0, (i + t) % 3 < 1 ? 120 : 0, 0'
+};
+const vmSrc = document.getElementById('vmSrc'), vmPreset = document.getElementById('vmPreset');
+for (const k in VM_PRESETS) vmPreset.add(new Option(k, VM_PRESETS[k]));
+vmSrc.value = VM_PRESETS.Plasma;
+fetch('/vm').then(r => r.text()).then(t => { if (t) vmSrc.value = t; }).catch(() => {});
+
+function vmUpload() {
+  const msg = document.getElementById('vmMsg');
+  try {
+    const hex = vmCompile(vmSrc.value).map(v => v.toString(16).padStart(2, '0')).join('');
+    msg.textContent = `${hex.length / 2} bytes`;
+    send('/vm?code=' + hex + '&src=' + encodeURIComponent(vmSrc.value));
+  } catch (e) {
+    msg.textContent = 'Error: ' + e;
+  }
 }
 
-// Quick LED test without blocking delays
-void quickLEDTest() {
-  Serial.println("Quick LED test - RED");
-  for (uint16_t i = 0; i < NUM_LEDS; i++) {
-    strip.setPixelColor(i, strip.Color(255, 0, 0));
-  }
-  strip.show();
-  delay(50); // Very short delay
-  
-  Serial.println("Quick LED test - GREEN");
-  for (uint16_t i = 0; i < NUM_LEDS; i++) {
-    strip.setPixelColor(i, strip.Color(0, 255, 0));
-  }
-  strip.show();
-  delay(50);
-  
-  Serial.println("Quick LED test - BLUE");
-  for (uint16_t i = 0; i < NUM_LEDS; i++) {
-    strip.setPixelColor(i, strip.Color(0, 0, 255));
+setInterval(() => {
+  document.getElementById('pvInfo').textContent = `${pv.length / 3} LEDs, ${pvBytes} B/s`;
+  pvBytes = 0;
+}, 1000);
+pvConnect();
+</script>
+</html>
+)HTML";
+
+// ---------- Pomocné funkce pro barvy ----------
+void clearStrip() {
+  for (uint16_t i = 0; i < NUM_LEDS; i++) setPixel(i, 0);
+}
+
+// LED test without blocking delays: starts here, runs from loop()
+void startLEDTest() {
+  MYLOG_I("LED test requested");
+  ledTestStep = 1;
+  ledTestMs = millis() - 50;
+}
+
+// One test step every 50 ms; true while the test owns the strip
+bool serviceLEDTest(uint32_t now) {
+  static const char* const NAMES[] = { "RED", "GREEN", "BLUE" };
+  static const uint32_t COLORS[] = { 0xFF0000, 0x00FF00, 0x0000FF };
+  if (ledTestStep == 0) return false;
+  if (now - ledTestMs < 50) return true;
+  ledTestMs = now;
+  if (ledTestStep <= 3) {
+    MYLOG_I("LED test - %s", NAMES[ledTestStep - 1]);
+    for (uint16_t i = 0; i < NUM_LEDS; i++) setPixel(i, COLORS[ledTestStep - 1]);
+    showFrame();
+    ledTestStep++;
+    return true;
   }
-  strip.show();
-  delay(50);
-  
-  Serial.println("Quick LED test - OFF");
+  ledTestStep = 0;
   clearStrip();
-  strip.show();
-  
-  Serial.println("Quick LED test complete!");
-}
-
-// Non-blocking LED test for web interface
-void testLEDStrip() {
-  Serial.println("Manual LED test requested");
-  quickLEDTest();
+  showFrame();
+  clipPlayer.invalidate(); // a clip starts again from a keyframe
+  power.resend();          // the show continues over a blank strip
+  MYLOG_I("LED test complete!");
+  return false;
 }
 
 // ---------- Animace: jeden "krok" každé volání ----------
 void advanceRainbow() {
+  // barva = jedno čtení z tabulky palety (výchozí Rainbow = stejné barvy jako colorWheel)
   for (uint16_t i = 0; i < NUM_LEDS; i++) {
-    strip.setPixelColor(i, colorWheel((i * 256 / NUM_LEDS + stepIndex) & 255));
+    const uint8_t* c = palette.rgb((i * 256 / NUM_LEDS + stepIndex) & 255);
+    setPixel(i, c[0], c[1], c[2]);
   }
 }
 
 void advanceTheater() {
   // 3 "běžící" tečky v základní barvě
   for (uint16_t i = 0; i < NUM_LEDS; i++) {
-    if ((i + stepIndex) % 3 == 0) strip.setPixelColor(i, strip.Color(baseR, baseG, baseB));
-    else strip.setPixelColor(i, 0);
+    if ((i + stepIndex) % 3 == 0) setPixel(i, strip.Color(baseR, baseG, baseB));
+    else setPixel(i, 0);
   }
 }
 
@@ -749,7 +1095,7 @@ void advanceColorWipe() {
   // postupně plní pásek barvou (kruh)
   uint16_t idx = stepIndex % (NUM_LEDS + 1);
   for (uint16_t i = 0; i < NUM_LEDS; i++) {
-    strip.setPixelColor(i, (i < idx) ? strip.Color(0, 120, 255) : 0);
+    setPixel(i, (i < idx) ? strip.Color(0, 120, 255) : 0);
   }
 }
 
@@ -760,54 +1106,37 @@ void advanceBreath() {
   uint8_t r = (uint8_t)(baseR * breath);
   uint8_t g = (uint8_t)(baseG * breath);
   uint8_t b = (uint8_t)(baseB * breath);
-  for (uint16_t i = 0; i < NUM_LEDS; i++) strip.setPixelColor(i, strip.Color(r, g, b));
+  for (uint16_t i = 0; i < NUM_LEDS; i++) setPixel(i, strip.Color(r, g, b));
 }
 
 void advanceSparkle() {
   // náhodné jiskry na tmavém pozadí
   for (uint16_t i = 0; i < NUM_LEDS; i++) {
     // pomalu zhasínej (fade)
-    uint32_t c = strip.getPixelColor(i);
+    uint32_t c = getPixel(i);
     uint8_t r = (c >> 16) & 0xFF, g = (c >> 8) & 0xFF, b = c & 0xFF;
     r = (r > 8) ? r - 8 : 0; g = (g > 8) ? g - 8 : 0; b = (b > 8) ? b - 8 : 0;
-    strip.setPixelColor(i, strip.Color(r, g, b));
+    setPixel(i, strip.Color(r, g, b));
   }
-  // rozsvitíme pár náhodných pixelů
+  // rozsvitíme pár náhodných pixelů – náhoda z (seed, krok), takže ve skupině
+  // kontrolérů (MySync) jiskří všude stejné LED
+  uint32_t x = (showSeed ^ (stepIndex * 2654435761UL)) | 1;
   for (uint8_t k = 0; k < 2; k++) {
-    uint16_t i = random(NUM_LEDS);
-    strip.setPixelColor(i, strip.Color(255, 255, 255));
+    x ^= x << 13; x ^= x >> 17; x ^= x << 5;   // xorshift32
+    uint16_t i = x % NUM_LEDS;
+    setPixel(i, strip.Color(255, 255, 255));
   }
 }
 
 // ---------- NEW ANIMATIONS ----------
 void advanceFire() {
-  // Fire effect with flickering flames
+  // Oheň: buňky chladnou a dole vzplanou podle plynulého šumu (MyNoise.h),
+  // teplo stoupá nahoru – místo random() blikání na každé LED
+  fire.step(NUM_LEDS);
   for (uint16_t i = 0; i < NUM_LEDS; i++) {
-    // Cooler colors at bottom, hotter at top
-    uint8_t heat = ((i * 255) / NUM_LEDS + stepIndex) % 256;
-    uint8_t r, g, b;
-    
-    if (heat < 85) {
-      r = heat * 3;
-      g = 0;
-      b = 0;
-    } else if (heat < 170) {
-      r = 255;
-      g = (heat - 85) * 3;
-      b = 0;
-    } else {
-      r = 255;
-      g = 255;
-      b = (heat - 170) * 3;
-    }
-    
-    // Add flickering
-    uint8_t flicker = random(0, 50);
-    r = (r > flicker) ? r - flicker : 0;
-    g = (g > flicker) ? g - flicker : 0;
-    b = (b > flicker) ? b - flicker : 0;
-    
-    strip.setPixelColor(i, strip.Color(r, g, b));
+    // výchozí paleta Heat: černá → červená → žlutá → bílá
+    const uint8_t* c = palette.rgb(fire.heat[i]);
+    setPixel(i, c[0], c[1], c[2]);
   }
 }
 
@@ -821,7 +1150,7 @@ void advanceWave() {
     uint8_t g = (uint8_t)(waveG * intensity);
     uint8_t b = (uint8_t)(waveB * intensity);
     
-    strip.setPixelColor(i, strip.Color(r, g, b));
+    setPixel(i, strip.Color(r, g, b));
   }
 }
 
@@ -838,7 +1167,7 @@ void advancePulse() {
     uint8_t g = (uint8_t)(baseG * intensity);
     uint8_t b = (uint8_t)(baseB * intensity);
     
-    strip.setPixelColor(i, strip.Color(r, g, b));
+    setPixel(i, strip.Color(r, g, b));
   }
 }
 
@@ -848,12 +1177,12 @@ void advanceChase() {
   uint16_t spacing = NUM_LEDS / numDots;
   
   for (uint16_t i = 0; i < NUM_LEDS; i++) {
-    strip.setPixelColor(i, 0);
+    setPixel(i, 0);
   }
   
   for (uint8_t d = 0; d < numDots; d++) {
     uint16_t pos = (stepIndex + d * spacing) % NUM_LEDS;
-    strip.setPixelColor(pos, strip.Color(baseR, baseG, baseB));
+    setPixel(pos, strip.Color(baseR, baseG, baseB));
   }
 }
 
@@ -863,47 +1192,312 @@ void advanceStrobe() {
   
   if (strobeOn) {
     for (uint16_t i = 0; i < NUM_LEDS; i++) {
-      strip.setPixelColor(i, strip.Color(baseR, baseG, baseB));
+      setPixel(i, strip.Color(baseR, baseG, baseB));
     }
   } else {
     for (uint16_t i = 0; i < NUM_LEDS; i++) {
-      strip.setPixelColor(i, 0);
+      setPixel(i, 0);
     }
   }
 }
 
+// Show 11: user program (PixelVM) for every LED; the frame holds the exact previous colors
+void advanceCustom() {
+  if (vmLen == 0) { clearStrip(); return; }
+  PixelVM::Pixel px;
+  px.n = NUM_LEDS;
+  px.t = stepIndex;
+  uint8_t* p = frame;
+  for (uint16_t i = 0; i < NUM_LEDS; i++, p += 3) {
+    px.i = i; px.r = p[0]; px.g = p[1]; px.b = p[2];
+    PixelVM::run(vmCode, vmLen, px, p);
+  }
+}
+
+// Show 12–15: klip z flash. Snímek = stepIndex mod počet snímků (ve skupině
+// MySync všude stejný); další snímek je jeden záznam, skok jde od klíčového
+void advanceClip() {
+  if (!clipPlayer.playing()) { clearStrip(); return; }
+  clipPlayer.show(stepIndex, frame);
+}
+
+// Klip k show 12–15 (nullptr = není v oddílu, je poškozený nebo delší než pásek)
+const Clip::Info* clipFor(ShowType s) {
+  if (s < SHOW_12_CLIP1 || s >= SHOW_COUNT) return nullptr;
+  uint8_t i = s - SHOW_12_CLIP1;
+  if (!clips.playable(i) || clips.clip(i).leds > MAX_LEDS) return nullptr;
+  return &clips.clip(i);
+}
+
+// Namapuje oddíl "clips" (jednou při startu; mapování platí až do resetu)
+void mountClips() {
+  const esp_partition_t* part = esp_partition_find_first(ESP_PARTITION_TYPE_DATA, ESP_PARTITION_SUBTYPE_ANY, "clips");
+  if (!part) { MYLOG_W("Clips: no \"clips\" partition (partitions.csv)"); return; }
+  const void* image = nullptr;
+#if ESP_ARDUINO_VERSION_MAJOR >= 3
+  esp_partition_mmap_handle_t map;
+  esp_err_t err = esp_partition_mmap(part, 0, part->size, ESP_PARTITION_MMAP_DATA, &image, &map);
+#else
+  spi_flash_mmap_handle_t map;
+  esp_err_t err = esp_partition_mmap(part, 0, part->size, SPI_FLASH_MMAP_DATA, &image, &map);
+#endif
+  if (err != ESP_OK) { MYLOG_E("Clips: mmap failed (%d)", (int)err); return; }
+  clipMapKB = part->size / 1024;
+  if (!clips.open((const uint8_t*)image, part->size)) { MYLOG_W("Clips: partition empty (tools/clip_encode.cpp)"); return; }
+  for (uint8_t i = 0; i < clips.count(); i++) {
+    const Clip::Info& c = clips.clip(i);
+    MYLOG_I("Clip %u: %s, %u frames, %u LEDs, %u ms, %lu B", i + 1, c.name, c.frames, c.leds, c.frameMs, c.size);
+  }
+}
+
+// Jeden krok aktuální show do frame
+void advanceShow() {
+  switch (currentShow) {
+    case SHOW_1_RAINBOW:   advanceRainbow();   break;
+    case SHOW_2_THEATER:   advanceTheater();   break;
+    case SHOW_3_COLOR_WIPE:advanceColorWipe(); break;
+    case SHOW_4_BREATH:    advanceBreath();    break;
+    case SHOW_5_SPARKLE:   advanceSparkle();   break;
+    case SHOW_6_FIRE:      advanceFire();      break;
+    case SHOW_7_WAVE:      advanceWave();      break;
+    case SHOW_8_PULSE:     advancePulse();     break;
+    case SHOW_9_CHASE:     advanceChase();     break;
+    case SHOW_10_STROBE:   advanceStrobe();    break;
+    case SHOW_11_CUSTOM:   advanceCustom();    break;
+    case SHOW_12_CLIP1: case SHOW_13_CLIP2:
+    case SHOW_14_CLIP3: case SHOW_15_CLIP4:
+                           advanceClip();      break;
+    default: break;
+  }
+}
+
+// ---------- Živý náhled (WebSocket) ----------
+void previewEvent(uint8_t num, WStype_t type, uint8_t* payload, size_t length) {
+  if (num >= PREVIEW_CLIENTS) {
+    if (type == WStype_CONNECTED) previewWs.disconnect(num);
+    return;
+  }
+  PreviewClient& c = previewClients[num];
+  switch (type) {
+    case WStype_CONNECTED:
+      power.activity(millis());
+      c.connected = true;
+      c.count = 0;                        // first frame is a keyframe
+      c.pacer.reset(millis());
+      break;
+    case WStype_DISCONNECTED:
+      c.connected = false;
+      break;
+    case WStype_BIN:
+      if (length == 1) c.pacer.acked(payload[0]);   // ack = seq of the painted frame
+      break;
+    default:
+      break;
+  }
+}
+
+// Sends each client what changed since its last frame, at its own pace.
+// The preview shows the logical frame (colors before brightness and gamma).
+void previewService(uint32_t now) {
+  uint32_t dt = now - previewLastMs;
+  previewLastMs = now;
+
+  const uint8_t* rgb = frame;
+  uint8_t count = (uint8_t)NUM_LEDS;
+  bool anyone = false;
+
+  for (uint8_t n = 0; n < PREVIEW_CLIENTS; n++) {
+    PreviewClient& c = previewClients[n];
+    if (!c.connected) continue;
+    anyone = true;
+    if (!c.pacer.ready(now)) continue;
+
+    uint8_t seq = c.pacer.nextSeq();
+    uint16_t len = (c.count == count) ? Preview::encode(previewMsg, seq, rgb, c.last, count)
+                                      : Preview::encodeKey(previewMsg, seq, rgb, count);
+    if (len == 0) { c.pacer.unchanged(now); continue; }
+    if (!previewWs.sendBIN(n, previewMsg, len)) { c.count = 0; continue; }
+
+    c.pacer.sent(now);
+    memcpy(c.last, rgb, count * 3);
+    c.count = count;
+    previewBytesByShow[currentShow] += len;
+  }
+  if (anyone) previewMsByShow[currentShow] += dt;
+}
+
 // ---------- Aplikační logika ----------
-void setShow(ShowType s) {
+// Tabulka palety pro aktuální show (~5 µs, jen při změně, ne v každém kroku)
+void rebuildPalette() {
+  uint8_t id = showPalette[currentShow];
+  if (id == NO_PALETTE) return;
+  palette.load(id);
+  palette.tint({ baseR, baseG, baseB }, (MyShows::Blend)paletteBlend, paletteAmount);
+}
+
+// seed: náhoda show (oheň, jiskry); ve skupině ho určí ten, kdo show přepnul
+void setShow(ShowType s, uint32_t seed = esp_random()) {
   currentShow = s;
+  showSeed = seed;
+  rebuildPalette();
+  if (s == SHOW_6_FIRE) fire.seed(seed);   // plamen od nuly, pokaždé jiný
+  clipPlayer.stop();
   isOn = (s != SHOW_OFF);
+  power.outputOff = !isOn;
+  power.resend();        // pásek se tu kreslí mimo loop(), další krok pošli vždy
   stepIndex = 0;
   lastStepMs = millis(); // Reset timing to start immediately
   
-  Serial.println("Setting show to: " + String(s) + " (isOn: " + String(isOn) + ")");
+  MYLOG_I("Setting show to: %d (isOn: %d)", (int)s, isOn);
   
   if (!isOn) {
-    Serial.println("Turning off LEDs");
+    MYLOG_I("Turning off LEDs");
     clearStrip();
-    strip.show();
+    showFrame();
   } else {
-    Serial.println("Starting LED animation...");
+    MYLOG_D("Starting LED animation...");
     // Force immediate update when switching shows
     switch (currentShow) {
-      case SHOW_1_RAINBOW:   advanceRainbow();   Serial.println("Rainbow started"); break;
-      case SHOW_2_THEATER:   advanceTheater();   Serial.println("Theater started"); break;
-      case SHOW_3_COLOR_WIPE:advanceColorWipe(); Serial.println("Color Wipe started"); break;
-      case SHOW_4_BREATH:    advanceBreath();    Serial.println("Breath started"); break;
-      case SHOW_5_SPARKLE:   advanceSparkle();   Serial.println("Sparkle started"); break;
-      case SHOW_6_FIRE:      advanceFire();      Serial.println("Fire started"); break;
-      case SHOW_7_WAVE:      advanceWave();      Serial.println("Wave started"); break;
-      case SHOW_8_PULSE:     advancePulse();     Serial.println("Pulse started"); break;
-      case SHOW_9_CHASE:     advanceChase();     Serial.println("Chase started"); break;
-      case SHOW_10_STROBE:   advanceStrobe();    Serial.println("Strobe started"); break;
+      case SHOW_1_RAINBOW:   advanceRainbow();   MYLOG_I("Rainbow started"); break;
+      case SHOW_2_THEATER:   advanceTheater();   MYLOG_I("Theater started"); break;
+      case SHOW_3_COLOR_WIPE:advanceColorWipe(); MYLOG_I("Color Wipe started"); break;
+      case SHOW_4_BREATH:    advanceBreath();    MYLOG_I("Breath started"); break;
+      case SHOW_5_SPARKLE:   advanceSparkle();   MYLOG_I("Sparkle started"); break;
+      case SHOW_6_FIRE:      advanceFire();      MYLOG_I("Fire started"); break;
+      case SHOW_7_WAVE:      advanceWave();      MYLOG_I("Wave started"); break;
+      case SHOW_8_PULSE:     advancePulse();     MYLOG_I("Pulse started"); break;
+      case SHOW_9_CHASE:     advanceChase();     MYLOG_I("Chase started"); break;
+      case SHOW_10_STROBE:   advanceStrobe();    MYLOG_I("Strobe started"); break;
+      case SHOW_11_CUSTOM:   memset(frame, 0, sizeof(frame));
+                             advanceCustom();    MYLOG_I("Custom started"); break;
+      case SHOW_12_CLIP1: case SHOW_13_CLIP2:
+      case SHOW_14_CLIP3: case SHOW_15_CLIP4:
+        clearStrip();      // LED za koncem kratšího klipu zůstanou zhasnuté
+        if (const Clip::Info* c = clipFor(s)) {
+          clipPlayer.start(c);
+          MYLOG_I("Clip %s started", c->name);
+        } else {
+          MYLOG_W("Clip %d: not in the clips partition", s - SHOW_12_CLIP1 + 1);
+        }
+        advanceClip();
+        break;
       default: break;
     }
-    strip.show();
-    Serial.println("LED strip updated");
+    showFrame();
+    MYLOG_D("LED strip updated");
+  }
+}
+
+// ---------- Uložené nastavení ----------
+void settingsChanged() {
+  settingsDirty = true;
+  settingsChangedMs = millis();
+}
+
+// ---------- Víc kontrolérů (MySync) ----------
+// Aktuální show jako sdílený stav. Nový seed = show začala znovu (setShow):
+// epoch = teď; jinak jen jiná rychlost bez skoku v krocích.
+MySync::State syncState(uint64_t shared) {
+  MySync::State s = syncNode.state();
+  if (s.seed != showSeed || s.show != currentShow) {
+    s.epochUs = shared;
+    s.seed = showSeed;
+    s.stepMs = speedMs;
+  } else if (s.stepMs != speedMs) {
+    MySync::rebase(s, speedMs, shared);
+  }
+  s.show = currentShow;
+  s.brightness = globalBrightness;
+  s.rgb[0] = baseR; s.rgb[1] = baseG; s.rgb[2] = baseB;
+  s.param[0] = showPalette[currentShow];
+  s.param[1] = paletteBlend;
+  s.param[2] = paletteAmount;
+  return s;
+}
+
+// Změna odsud (web): rozeslat ostatním
+void syncPublish() {
+  uint64_t t = esp_timer_get_time();
+  syncNode.publish(syncState(syncNode.now(t)), t);
+}
+
+// Změna od skupiny: převzít (bez rozesílání); stepIndex dopočítá loop()
+void applySync(const MySync::State& s) {
+  ShowType show = s.show < SHOW_COUNT ? (ShowType)s.show : SHOW_OFF;
+  globalBrightness = s.brightness;
+  output.brightness(globalBrightness);
+  if (s.stepMs >= 5 && s.stepMs <= 1000) speedMs = s.stepMs;
+  baseR = s.rgb[0]; baseG = s.rgb[1]; baseB = s.rgb[2];
+  if (showPalette[show] != NO_PALETTE && s.param[0] < MyShows::PALETTE_COUNT) showPalette[show] = s.param[0];
+  if (s.param[1] < MyShows::BLEND_COUNT) paletteBlend = s.param[1];
+  paletteAmount = s.param[2];
+  power.activity(millis());
+  if (show != currentShow || s.seed != showSeed) setShow(show, s.seed);
+  else { rebuildPalette(); power.resend(); }
+  settingsChanged();
+}
+
+// Zprávy skupiny: příchozí stav převzít, beacony a příkazy poslat
+void syncService() {
+  if (!syncId) return;
+  MySync::Packet p;
+  uint64_t at;
+  while (radio.read(p, at))
+    if (syncNode.receive(p, at)) applySync(syncNode.state());
+  uint64_t t = esp_timer_get_time();
+  while (syncNode.poll(t, p)) radio.send(p);
+}
+
+// Role OFF / MASTER / FOLLOWER; Wi-Fi (AP) už musí běžet
+void syncStart(MySync::Role role, uint8_t group) {
+  if (role != MySync::OFF && !syncId) {
+    syncId = radio.begin(WIFI_IF_AP);
+    if (!syncId) { MYLOG_E("Sync: ESP-NOW failed"); role = MySync::OFF; }
   }
+  syncNode.begin(role, group, syncId);
+  // běžící show pokračuje: epoch tak, aby stepIndex seděl na teď
+  uint64_t t = esp_timer_get_time();
+  MySync::State s = syncState(t);
+  s.epochUs = t - (uint64_t)stepIndex * speedMs * 1000;
+  syncNode.restore(s);
+  static const char* const ROLES[] = { "off", "master", "follower" };
+  MYLOG_I("Sync: %s, group %u, id %08lX", ROLES[role], group, syncId);
+}
+
+// Z loop(): zapíše až po 2 s klidu (NVS přepisuje jen změněné hodnoty)
+void saveSettingsWhenIdle(uint32_t now) {
+  if (!settingsDirty || now - settingsChangedMs < 2000) return;
+  settingsDirty = false;
+  uint8_t rgb[3] = { baseR, baseG, baseB };
+  prefs.putUChar("show", (uint8_t)currentShow);
+  prefs.putUChar("bright", globalBrightness);
+  prefs.putUChar("gamma", (uint8_t)lroundf(output.gamma() * 10));
+  prefs.putUShort("kelvin", output.temperature());
+  prefs.putUShort("budget", current.budgetMa);
+  prefs.putUShort("speed", speedMs);
+  prefs.putUShort("leds", NUM_LEDS);
+  prefs.putBytes("rgb", rgb, sizeof(rgb));
+  MYLOG_D("Settings saved");
+}
+
+// Show, která běžela před resetem (výchozí Rainbow)
+ShowType loadSettings() {
+  prefs.begin("lightshow", false);
+  uint8_t s = prefs.getUChar("show", SHOW_1_RAINBOW);
+  if (s >= SHOW_COUNT) s = SHOW_1_RAINBOW;
+  globalBrightness = prefs.getUChar("bright", globalBrightness);
+  output.brightness(globalBrightness);
+  uint8_t gamma10 = prefs.getUChar("gamma", 10);
+  if (gamma10 >= 10 && gamma10 <= 30) output.gamma(gamma10 / 10.0f);
+  output.temperature(prefs.getUShort("kelvin", 0));
+  current.budgetMa = prefs.getUShort("budget", CURRENT_BUDGET_MA);
+  uint16_t ms = prefs.getUShort("speed", speedMs);
+  if (ms >= 5 && ms <= 1000) speedMs = ms;
+  uint16_t leds = prefs.getUShort("leds", NUM_LEDS);
+  if (leds >= 1 && leds <= MAX_LEDS) NUM_LEDS = leds;
+  uint8_t rgb[3];
+  if (prefs.getBytes("rgb", rgb, sizeof(rgb)) == sizeof(rgb)) { baseR = rgb[0]; baseG = rgb[1]; baseB = rgb[2]; }
+  return (ShowType)s;
 }
 
 void handleRoot() {
@@ -913,17 +1507,44 @@ void handleRoot() {
 void handleCmd() {
   if (!server.hasArg("show")) { server.send(400, "text/plain", "Missing ?show="); return; }
   int s = server.arg("show").toInt();
-  if (s < 0 || s > 10) s = 0; // Updated to support shows 0-10
+  if (s < 0 || s >= SHOW_COUNT) s = 0;
+  // klip má vlastní tempo (posuvník Speed ho pak může změnit)
+  const Clip::Info* clip = clipFor((ShowType)s);
+  if (clip && clip->frameMs >= 5 && clip->frameMs <= 1000) speedMs = clip->frameMs;
   setShow((ShowType)s);
+  settingsChanged();
+  syncPublish();
   server.send(200, "text/plain", "Show set to: " + String(s));
 }
 
+// Jas, gama a teplota bílé mění jen výstup: show běží dál se stejnými
+// barvami a nové tabulky se spočítají v příštím kroku
 void handleSet() {
   if (server.hasArg("brightness")) {
     int b = server.arg("brightness").toInt();
     if (b < 0) b = 0; if (b > 255) b = 255;
     globalBrightness = (uint8_t)b;
-    strip.setBrightness(globalBrightness);
+    output.brightness(globalBrightness);
+    settingsChanged();
+    syncPublish();
+  }
+  if (server.hasArg("gamma")) {            // v desetinách: 10 = vypnuto, 22 = typická LED
+    int g = server.arg("gamma").toInt();
+    if (g < 10) g = 10; if (g > 30) g = 30;
+    output.gamma(g / 10.0f);
+    settingsChanged();
+  }
+  if (server.hasArg("kelvin")) {           // 0 = bez korekce, jinak 1000..12000
+    int k = server.arg("kelvin").toInt();
+    if (k < 0) k = 0; if (k > 12000) k = 12000;
+    output.temperature((uint16_t)k);
+    settingsChanged();
+  }
+  if (server.hasArg("budget")) {           // mA pro pásek; 0 = jen měřit
+    int ma = server.arg("budget").toInt();
+    if (ma < 0) ma = 0; if (ma > 60000) ma = 60000;
+    current.budgetMa = (uint16_t)ma;
+    settingsChanged();
   }
   server.send(200, "text/plain", "OK");
 }
@@ -933,13 +1554,34 @@ void handleSpeed() {
   int ms = server.arg("ms").toInt();
   if (ms < 5) ms = 5; if (ms > 1000) ms = 1000;
   speedMs = (uint16_t)ms;
+  settingsChanged();
+  syncPublish();
   server.send(200, "text/plain", "OK");
 }
 
+// /sync?role=0|1|2&group=1..255 – off / master / follower (uloží se)
+void handleSync() {
+  MySync::Role role = syncNode.role();
+  uint8_t group = prefs.getUChar("syncgroup", 1);
+  if (server.hasArg("role")) {
+    int r = server.arg("role").toInt();
+    if (r < MySync::OFF || r > MySync::FOLLOWER) { server.send(400, "text/plain", "Bad role"); return; }
+    role = (MySync::Role)r;
+  }
+  if (server.hasArg("group")) {
+    int g = server.arg("group").toInt();
+    if (g < 1 || g > 255) { server.send(400, "text/plain", "Bad group"); return; }
+    group = (uint8_t)g;
+  }
+  prefs.putUChar("syncrole", role);
+  prefs.putUChar("syncgroup", group);
+  syncStart(role, group);
+  server.send(200, "text/plain", "Sync role " + String(role) + ", group " + String(group));
+}
+
 void handleTest() {
-  Serial.println("Manual LED test requested via web");
-  testLEDStrip();
-  server.send(200, "text/plain", "LED test completed - check Serial monitor");
+  startLEDTest();
+  server.send(200, "text/plain", "LED test running - check Serial monitor");
 }
 
 void handleStatus() {
@@ -949,8 +1591,68 @@ void handleStatus() {
   status += "LEDs: " + String(NUM_LEDS) + "\n";
   status += "Show: " + String(currentShow) + "\n";
   status += "Brightness: " + String(globalBrightness) + "\n";
+  MyShows::Rgb w = output.whitePoint();
+  status += "Output: gamma " + String(output.gamma(), 1) + ", white " +
+            (output.temperature() ? String(output.temperature()) + " K" : String("off")) +
+            " (R" + String(w.r) + " G" + String(w.g) + " B" + String(w.b) + ")\n";
+  status += "Current: " + String(current.lastMa() / 1000.0f, 2) + " A estimated, budget ";
+  if (current.budgetMa)
+    status += String(current.budgetMa) + " mA, headroom " + String(current.headroomMa()) + " mA (min " +
+              String(current.minHeadroomMa()) + "), limit " + String(current.limit()) + ", " +
+              String(current.events()) + " limit events, " + String(current.clamps()) + " frames redone\n";
+  else
+    status += "off\n";
   status += "Speed: " + String(speedMs) + "ms\n";
+  status += "Sync: ";
+  uint64_t t = esp_timer_get_time();
+  if (syncNode.role() == MySync::OFF) status += "off\n";
+  else if (syncNode.role() == MySync::MASTER)
+    status += "master, id " + String(syncId, HEX) + ", " + String(syncNode.commandCount()) + " commands in, " +
+              String(syncNode.conflictCount()) + " beacons from another master\n";
+  else
+    status += String(syncNode.ready() ? "follower, locked" : "follower, waiting") + ", offset " +
+              String((long)(int64_t)(syncNode.now(t) - t)) + " us, drift " +
+              String(syncNode.clock.driftPpb() / 1000.0f, 1) + " ppm, jitter " +
+              String(syncNode.clock.lastErrorUs()) + " us, beacons " + String(syncNode.beaconCount()) +
+              " (missed " + String(syncNode.missedBeacons()) + ", last " + String(syncNode.beaconAgeMs(t)) +
+              " ms ago), " + String(syncNode.repairCount()) + " repairs\n";
+  status += "Clips: ";
+  if (!clipMapKB) status += "no partition\n";
+  else {
+    status += String(clips.count()) + " in " + String(clipMapKB) + " kB partition";
+    for (uint8_t i = 0; i < clips.count(); i++) {
+      const Clip::Info& c = clips.clip(i);
+      status += String(i ? "; " : ": ") + String(i + 1) + " " + c.name + " " + String(c.frames) + "x" +
+                String(c.leds) + " " + String(c.size / c.frames) + " B/frame";
+    }
+    if (const Clip::Info* c = clipPlayer.playing())
+      status += ", playing " + String(c->name) + " frame " + String(clipPlayer.frame()) + ", " +
+                String(clipPlayer.records) + " records for " + String(clipPlayer.frames) + " frames";
+    status += "\n";
+  }
   status += "Base Color: R" + String(baseR) + " G" + String(baseG) + " B" + String(baseB) + "\n";
+  status += "Palette: ";
+  if (showPalette[currentShow] == NO_PALETTE) status += "-\n";
+  else status += String(MyShows::Palette::name(showPalette[currentShow])) + ", blend " + String(paletteBlend) +
+                 ", mix " + String(paletteAmount) + "\n";
+  uint8_t viewers = 0;
+  for (uint8_t n = 0; n < PREVIEW_CLIENTS; n++) viewers += previewClients[n].connected;
+  status += "Preview clients: " + String(viewers) + "\n";
+  status += "Preview B/s by show:";
+  for (uint8_t s = 0; s < SHOW_COUNT; s++) {
+    if (previewMsByShow[s] < 1000) continue;   // not watched long enough
+    status += " " + String(s) + "=" + String((uint32_t)((uint64_t)previewBytesByShow[s] * 1000 / previewMsByShow[s]));
+  }
+  status += "\n";
+  status += "Boot (" + String(MyBoot::resetReason()) + " reset):";
+  for (uint8_t i = 0; i < boot.count(); i++)
+    status += " " + String(boot.name(i)) + " " + String(boot.at(i) / 1000) + " ms;";
+  status += "\n";
+  uint32_t now = millis();
+  status += "Power: " + String(MyPower::name(power.state())) + " at " + String(getCpuFrequencyMhz()) + " MHz;";
+  for (uint8_t s = 0; s < MyPower::STATE_COUNT; s++)
+    status += " " + String(MyPower::name((MyPower::State)s)) + " " + String(power.ms((MyPower::State)s, now) / 1000) + " s";
+  status += "\n";
   server.send(200, "text/plain", status);
 }
 
@@ -961,12 +1663,13 @@ void handleLEDCount() {
   if (count > 60) count = 60; // Updated to support up to 60 LEDs
   
   NUM_LEDS = (uint16_t)count;
-  Serial.println("LED count set to: " + String(NUM_LEDS));
+  MYLOG_I("LED count set to: %u", NUM_LEDS);
   
-  // Clear and restart current show with new LED count
+  // Clear and restart current show with new LED count (same seed: the group keeps its show)
   clearStrip();
-  strip.show();
-  setShow(currentShow);
+  showFrame();
+  setShow(currentShow, showSeed);
+  settingsChanged();
   
   server.send(200, "text/plain", "LED count set to: " + String(NUM_LEDS));
 }
@@ -987,68 +1690,146 @@ void handleColor() {
     if (b < 0) b = 0; if (b > 255) b = 255;
     baseB = (uint8_t)b;
   }
+  // /color?palette=0..6&blend=0..3&amount=0..255 – paleta aktuální show a míchání se základní barvou
+  if (server.hasArg("palette")) {
+    int p = server.arg("palette").toInt();
+    if (showPalette[currentShow] == NO_PALETTE) { server.send(400, "text/plain", "This show has no palette"); return; }
+    if (p < 0 || p >= MyShows::PALETTE_COUNT) { server.send(400, "text/plain", "Bad palette"); return; }
+    showPalette[currentShow] = (uint8_t)p;
+  }
+  if (server.hasArg("blend")) {
+    int m = server.arg("blend").toInt();
+    if (m < 0 || m >= MyShows::BLEND_COUNT) { server.send(400, "text/plain", "Bad blend"); return; }
+    paletteBlend = (uint8_t)m;
+  }
+  if (server.hasArg("amount")) {
+    int a = server.arg("amount").toInt();
+    if (a < 0) a = 0; if (a > 255) a = 255;
+    paletteAmount = (uint8_t)a;
+  }
   
-  Serial.println("Base color set to: R" + String(baseR) + " G" + String(baseG) + " B" + String(baseB));
+  MYLOG_I("Base color set to: R%u G%u B%u", baseR, baseG, baseB);
+  settingsChanged();
   
   // Update current show with new color
   if (isOn) {
     setShow(currentShow);
   }
+  syncPublish();
   
   server.send(200, "text/plain", "Color set to: R" + String(baseR) + " G" + String(baseG) + " B" + String(baseB));
 }
 
+// /vm               -> source of the stored custom effect
+// /vm?code=HEX&src=  -> verify, store in flash and run as show 11
+void handleVM() {
+  if (!server.hasArg("code")) { server.send(200, "text/plain", prefs.getString("vmsrc", "")); return; }
+
+  String hex = server.arg("code");
+  uint16_t len = hex.length() / 2;
+  if (hex.length() % 2 || len > PixelVM::PROG_MAX) { server.send(400, "text/plain", "Bad code length"); return; }
+  uint8_t code[PixelVM::PROG_MAX];
+  for (uint16_t k = 0; k < len; k++) {
+    char pair[3] = { hex[k * 2], hex[k * 2 + 1], 0 };
+    char* endp;
+    code[k] = (uint8_t)strtoul(pair, &endp, 16);
+    if (*endp) { server.send(400, "text/plain", "Bad hex"); return; }
+  }
+  PixelVM::Error err = PixelVM::verify(code, len);
+  if (err != PixelVM::OK) { server.send(400, "text/plain", String("Rejected: ") + PixelVM::errorText(err)); return; }
+
+  memcpy(vmCode, code, len);
+  vmLen = len;
+  prefs.putBytes("vm1", vmCode, vmLen);
+  prefs.putString("vmsrc", server.arg("src").substring(0, 240));
+  setShow(SHOW_11_CUSTOM);
+  syncPublish();          // program sám se neposílá – na ostatních musí být nahraný stejný
+  server.send(200, "text/plain", "Custom effect running (" + String(vmLen) + " bytes)");
+}
+
+// Loads the stored custom effect; flash contents are verified like an upload
+void loadCustomEffect() {
+  uint8_t code[PixelVM::PROG_MAX];
+  size_t len = prefs.getBytesLength("vm1");
+  if (len == 0 || len > sizeof(code)) return;
+  prefs.getBytes("vm1", code, len);
+  if (PixelVM::verify(code, len) != PixelVM::OK) { MYLOG_W("Stored custom effect rejected"); return; }
+  memcpy(vmCode, code, len);
+  vmLen = len;
+  MYLOG_I("Custom effect loaded (%u bytes)", vmLen);
+}
+
+// Časová osa startu do Serialu (čas od startu čipu a trvání fáze)
+void logBootTimeline() {
+  MYLOG_I("Boot timeline (%s reset):", MyBoot::resetReason());
+  for (uint8_t i = 0; i < boot.count(); i++) {
+    uint32_t at = boot.at(i), took = boot.took(i);
+    MYLOG_I("  %4lu.%03lu ms  +%lu.%03lu  %s", at / 1000, at % 1000, took / 1000, took % 1000, boot.name(i));
+  }
+  if (boot.late())
+    MYLOG_W("First frame after %lu ms (target %lu ms)", boot.firstFrameUs() / 1000, boot.targetUs / 1000);
+}
+
 void setup() {
-  // Initialize Serial for debugging
+  // Nejdřív pásek: obnovená show svítí do ~100 ms od resetu, Wi-Fi,
+  // web a test až potom (časy fází: boot, výpis níže a v /status)
   Serial.begin(115200);
-  Serial.println("ESP32 NeoPixel Lightshow Starting...");
+  MyLog::begin(Serial);   // od teď do Serialu píše jen úloha MyLog
+  MYLOG_I("ESP32 NeoPixel Lightshow Starting...");
+  boot.mark("serial + log");
+  
+  ShowType show = loadSettings();
+  loadCustomEffect();     // před setShow: show 11 potřebuje program
+  boot.mark("settings");
+  mountClips();           // také před setShow (show 12–15); klipy se kontrolují až při prvním puštění
+  boot.mark("clips");
+  
+  // PRIORITY 1: the restored show, straight away
+  strip.begin();
+  randomSeed(esp_random());   // Random seed pro efekty
+  power.begin(millis());
+  for (uint8_t ch = 0; ch < 3; ch++) current.channelMa[ch] = CURRENT_CHANNEL_MA;
+  setShow(show);
+  boot.firstFrame();
   
-  // PRIORITY 1: Start WiFi AP IMMEDIATELY for fastest connection
-  Serial.println("Setting up WiFi Access Point (PRIORITY)...");
+  // PRIORITY 2: WiFi AP (its own task brings the radio up from here on)
+  MYLOG_I("Setting up WiFi Access Point...");
   WiFi.mode(WIFI_AP);
   
   // Optimize WiFi AP settings for faster connection
   WiFi.softAPConfig(local_IP, gateway, subnet);
   WiFi.softAP(AP_SSID, AP_PASS, 1, 0, 4); // Channel 1, no hidden, max 4 clients
+  boot.mark("wifi ap");
   
-  // Start web server IMMEDIATELY after WiFi
-  server.on("/", handleRoot);
-  server.on("/cmd", handleCmd);     // /cmd?show=0..10
-  server.on("/set", handleSet);     // /set?brightness=0..255
-  server.on("/speed", handleSpeed); // /speed?ms=5..1000
-  server.on("/test", handleTest);   // /test - manual LED test
-  server.on("/status", handleStatus); // /status - system status
-  server.on("/leds", handleLEDCount); // /leds?count=1..50
-  server.on("/color", handleColor);   // /color?r=0..255&g=0..255&b=0..255
+  // PRIORITY 3: web server right after WiFi
+  server.on("/", withActivity<handleRoot>);
+  server.on("/cmd", withActivity<handleCmd>);     // /cmd?show=0..15
+  server.on("/set", withActivity<handleSet>);     // /set?brightness=0..255&gamma=10..30&kelvin=0|1000..12000&budget=mA
+  server.on("/speed", withActivity<handleSpeed>); // /speed?ms=5..1000
+  server.on("/test", withActivity<handleTest>);   // /test - manual LED test
+  server.on("/status", withActivity<handleStatus>); // /status - system status
+  server.on("/leds", withActivity<handleLEDCount>); // /leds?count=1..50
+  server.on("/color", withActivity<handleColor>);   // /color?r=0..255&g=0..255&b=0..255&palette=0..6&blend=0..3&amount=0..255
+  server.on("/vm", withActivity<handleVM>);         // /vm?code=HEX&src=... - custom effect (show 11)
+  server.on("/sync", withActivity<handleSync>);     // /sync?role=0|1|2&group=1..255 - off / master / follower
   server.begin();
+  previewWs.begin();
+  previewWs.onEvent(previewEvent);
   
-  Serial.println("WiFi AP started! SSID: " + String(AP_SSID));
-  Serial.println("IP: " + WiFi.softAPIP().toString());
-  Serial.println("Web server ready - page available immediately!");
-  
-  // PRIORITY 2: Initialize LED strip (after web server is ready)
-  Serial.println("Initializing LED strip...");
-  strip.begin();
-  delay(50); // Reduced delay
-  
-  strip.setBrightness(globalBrightness);
-  Serial.println("LED strip initialized with brightness: " + String(globalBrightness));
-  
-  // Clear strip and show initial state
-  clearStrip();
-  strip.show();
-  delay(50); // Reduced delay
-  
-  // PRIORITY 3: Quick LED test (non-blocking)
-  quickLEDTest();
-  
-  // PRIORITY 4: Start Show 1 (Rainbow) automatically
-  Serial.println("Starting Show 1 (Rainbow) automatically...");
-  setShow(SHOW_1_RAINBOW);
-
-  // Random seed pro efekty
-  randomSeed(esp_random());
-  Serial.println("Setup complete! Web page ready, Rainbow show running.");
+  IPAddress ip = WiFi.softAPIP();
+  MYLOG_I("WiFi AP started! SSID: %s", AP_SSID);
+  MYLOG_I("IP: %u.%u.%u.%u", ip[0], ip[1], ip[2], ip[3]);
+  MYLOG_I("Web server ready - page available immediately!");
+  MYLOG_I("Live preview: ws://%u.%u.%u.%u:81/", ip[0], ip[1], ip[2], ip[3]);
+  boot.mark("web server");
+  syncStart((MySync::Role)prefs.getUChar("syncrole", MySync::OFF), prefs.getUChar("syncgroup", 1));
+
+#if BOOT_LED_TEST
+  startLEDTest();         // runs from loop(), over the show
+#endif
+  MYLOG_I("Setup complete! Web page ready, show %d running.", (int)show);
+  boot.mark("setup done");
+  logBootTimeline();
 }
 
 void loop() {
@@ -1061,30 +1842,57 @@ void loop() {
     }
   }
 
-  // LED animation timing (less frequent to give web server priority)
+  syncService();
+
+  // LED animation timing (less frequent to give web server priority);
+  // when the output stands still, only an occasional probe step
   uint32_t now = millis();
-  if (now - lastStepMs >= speedMs) {
+  bool testing = serviceLEDTest(now);
+  bool due = now - lastStepMs >= power.frameInterval(speedMs);
+  // Ve skupině: krok ze sdíleného času, začátek kroku přesně (na ostatních páscích ve stejnou chvíli)
+  bool synced = isOn && !testing && syncNode.ready();
+  uint32_t target = 0;
+  if (synced) {
+    uint64_t shared = syncNode.now(esp_timer_get_time());
+    uint64_t next = MySync::stepStart(syncNode.state(), stepIndex);
+    if (next > shared && next - shared < SYNC_WAIT_US) {
+      delayMicroseconds(next - shared);
+      shared = syncNode.now(esp_timer_get_time());
+    }
+    target = MySync::stepAt(syncNode.state(), shared);
+    due = (target >= stepIndex || target + 1 < stepIndex) && (power.state() == MyPower::ACTIVE || due);
+  }
+  if (!testing && due) {
     lastStepMs = now;
 
     if (isOn) {
-      switch (currentShow) {
-        case SHOW_1_RAINBOW:   advanceRainbow();   break;
-        case SHOW_2_THEATER:   advanceTheater();   break;
-        case SHOW_3_COLOR_WIPE:advanceColorWipe(); break;
-        case SHOW_4_BREATH:    advanceBreath();    break;
-        case SHOW_5_SPARKLE:   advanceSparkle();   break;
-        case SHOW_6_FIRE:      advanceFire();      break;
-        case SHOW_7_WAVE:      advanceWave();      break;
-        case SHOW_8_PULSE:     advancePulse();     break;
-        case SHOW_9_CHASE:     advanceChase();     break;
-        case SHOW_10_STROBE:   advanceStrobe();    break;
-        default: break;
+      if (synced) {
+        // Daleko od cíle (připojení k běžící show, epoch posunutý dozadu):
+        // skok kousek před cíl, oheň na stejný čas šumu
+        if (target > stepIndex + SYNC_CATCHUP || target + 1 < stepIndex) {
+          stepIndex = target > SYNC_CATCHUP ? target - SYNC_CATCHUP : 0;
+          if (stepIndex == 0) fire.seed(showSeed);
+          else fire.seek(stepIndex);
+        }
+        // Zameškané kroky bez výstupu (oheň, jiskry a custom navazují na minulý snímek)
+        for (; stepIndex < target; stepIndex++) advanceShow();
       }
-      strip.show();
+      advanceShow();
+      // Brightness, gamma, white point, GRB, current limit; same frame as last time: nothing to send
+      writeFrame();
+      if (power.frame(MyPower::digest(strip.getPixels(), NUM_LEDS * 3), now)) strip.show();
       stepIndex++;
     }
   }
   
-  // Small delay to prevent overwhelming the system
-  delay(1);
+  // Live preview after the frame is out (never blocks: see PreviewCodec.h)
+  previewWs.loop();
+  previewService(now);
+  saveSettingsWhenIdle(now);
+
+  // Small delay to prevent overwhelming the system; longer and at 80 MHz
+  // while nothing moves (requests still get served within ~10 ms)
+  MyPower::State state = power.update(now);
+  governor.apply(state);
+  delay(state == MyPower::ACTIVE ? 1 : 10);
 }
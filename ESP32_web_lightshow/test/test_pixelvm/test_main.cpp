@@ -0,0 +1,220 @@
+/*
+test_pixelvm — include/PixelVM.h: what verify() lets through and what run() computes
+- verify() returns each of its errors for the smallest program that has
+  it, and accepts the limits themselves (PROG_MAX bytes, STACK_MAX deep).
+- run(): operand order of ?: (OP_SEL) and of - / < > (first pushed is the
+  left side), mod of negative numbers is never negative, / and % by zero
+  give 0, sin at the quadrant edges, overflow wraps, and every output is
+  cut to an integer and clamped to 0..255.
+- Both dispatch loops must agree: pio test runs the computed goto one,
+  PIXELVM_SWITCH_DISPATCH in build_flags runs the switch.
+
+Run (from the project folder):
+  pio test -e native -f test_pixelvm
+*/
+
+#include <unity.h>
+#include <PixelVM.h>
+#include <math.h>
+
+using namespace PixelVM;
+
+void setUp(void) {}
+void tearDown(void) {}
+
+// Bytecode the way the page's vmCompile() writes it
+struct Prog {
+  uint8_t code[128];
+  uint8_t len = 0;
+
+  Prog& op(uint8_t o) { code[len++] = o; return *this; }
+  Prog& raw(int32_t q) {                                 // Q8 raw value
+    if (q >= -32768 && q <= 32767) { op(OP_PUSH16); op((uint8_t)q); op((uint8_t)(q >> 8)); }
+    else { op(OP_PUSH32); for (uint8_t k = 0; k < 4; k++) op((uint8_t)((uint32_t)q >> (8 * k))); }
+    return *this;
+  }
+  Prog& num(double v) { return raw((int32_t)lround(v * ONE)); }
+};
+
+static Pixel pixel(uint16_t i = 0, uint16_t n = 60, uint32_t t = 0, uint8_t r = 0, uint8_t g = 0, uint8_t b = 0) {
+  Pixel px;
+  px.i = i; px.n = n; px.t = t; px.r = r; px.g = g; px.b = b;
+  return px;
+}
+
+// Runs p (which must verify) and returns the first channel; the other two are 0
+static uint8_t red(Prog p, const Pixel& px = pixel()) {
+  p.num(0).num(0);
+  TEST_ASSERT_EQUAL_UINT8(OK, verify(p.code, p.len));
+  uint8_t out[3] = { 1, 1, 1 };
+  run(p.code, p.len, px, out);
+  TEST_ASSERT_EQUAL_UINT8(0, out[1]);
+  TEST_ASSERT_EQUAL_UINT8(0, out[2]);
+  return out[0];
+}
+
+// ---------- verify() ----------
+
+void test_verify_rejects(void) {
+  Prog p;
+  TEST_ASSERT_EQUAL_UINT8(ERR_EMPTY, verify(p.code, 0));
+
+  Prog longer;
+  for (uint8_t k = 0; k < PROG_MAX + 1; k++) longer.op(k < 3 ? OP_I : OP_NEG);
+  TEST_ASSERT_EQUAL_UINT8(ERR_TOO_LONG, verify(longer.code, longer.len));
+  TEST_ASSERT_EQUAL_UINT8(OK, verify(longer.code, PROG_MAX));   // PROG_MAX itself is fine
+
+  Prog bad; bad.op(OP_I).op(OP_G).op(OP_COUNT);
+  TEST_ASSERT_EQUAL_UINT8(ERR_BAD_OP, verify(bad.code, bad.len));
+  Prog bad2; bad2.op(OP_I).op(OP_G).op(OP_B).op(0xFF);
+  TEST_ASSERT_EQUAL_UINT8(ERR_BAD_OP, verify(bad2.code, bad2.len));
+
+  Prog t16; t16.op(OP_I).op(OP_G).op(OP_PUSH16).op(0x12);
+  TEST_ASSERT_EQUAL_UINT8(ERR_TRUNCATED, verify(t16.code, t16.len));
+  Prog t32; t32.op(OP_I).op(OP_G).op(OP_PUSH32).op(1).op(2).op(3);
+  TEST_ASSERT_EQUAL_UINT8(ERR_TRUNCATED, verify(t32.code, t32.len));
+
+  Prog under; under.op(OP_I).op(OP_ADD);
+  TEST_ASSERT_EQUAL_UINT8(ERR_UNDERFLOW, verify(under.code, under.len));
+  Prog under1; under1.op(OP_NEG);
+  TEST_ASSERT_EQUAL_UINT8(ERR_UNDERFLOW, verify(under1.code, under1.len));
+  Prog under3; under3.op(OP_I).op(OP_I).op(OP_SEL);
+  TEST_ASSERT_EQUAL_UINT8(ERR_UNDERFLOW, verify(under3.code, under3.len));
+
+  Prog deep;
+  for (uint8_t k = 0; k < STACK_MAX + 1; k++) deep.op(OP_I);
+  TEST_ASSERT_EQUAL_UINT8(ERR_OVERFLOW, verify(deep.code, deep.len));
+
+  Prog two; two.op(OP_R).op(OP_G);
+  TEST_ASSERT_EQUAL_UINT8(ERR_NOT_RGB, verify(two.code, two.len));
+  Prog four; four.op(OP_R).op(OP_G).op(OP_B).op(OP_T);
+  TEST_ASSERT_EQUAL_UINT8(ERR_NOT_RGB, verify(four.code, four.len));
+
+  for (uint8_t e = OK; e <= ERR_NOT_RGB; e++) TEST_ASSERT_NOT_NULL(errorText((Error)e));
+}
+
+void test_full_stack_runs(void) {
+  Prog p;                                                // STACK_MAX values, then added down to 3
+  for (uint8_t k = 0; k < STACK_MAX; k++) p.num(k + 1);
+  for (uint8_t k = 0; k < STACK_MAX - 3; k++) p.op(OP_ADD);
+  TEST_ASSERT_EQUAL_UINT8(OK, verify(p.code, p.len));
+  uint8_t out[3];
+  run(p.code, p.len, pixel(), out);
+  TEST_ASSERT_EQUAL_UINT8(1, out[0]);
+  TEST_ASSERT_EQUAL_UINT8(2, out[1]);
+  TEST_ASSERT_EQUAL_UINT8(133, out[2]);                  // 3 + 4 + ... + 16
+}
+
+// ---------- run() ----------
+
+void test_inputs(void) {
+  Prog p; p.op(OP_I).op(OP_N).op(OP_T);
+  uint8_t out[3];
+  run(p.code, p.len, pixel(7, 60, 200), out);
+  TEST_ASSERT_EQUAL_UINT8(7, out[0]);
+  TEST_ASSERT_EQUAL_UINT8(60, out[1]);
+  TEST_ASSERT_EQUAL_UINT8(200, out[2]);
+  Prog c; c.op(OP_R).op(OP_G).op(OP_B);
+  run(c.code, c.len, pixel(0, 60, 0, 10, 20, 30), out);
+  TEST_ASSERT_EQUAL_UINT8(10, out[0]);
+  TEST_ASSERT_EQUAL_UINT8(20, out[1]);
+  TEST_ASSERT_EQUAL_UINT8(30, out[2]);
+  TEST_ASSERT_EQUAL_UINT8(200, red(Prog().op(OP_X).num(400).op(OP_MUL), pixel(30, 60)));   // x = 0.5
+}
+
+void test_sel_operand_order(void) {
+  // c ? a : b is pushed as c, a, b
+  TEST_ASSERT_EQUAL_UINT8(10, red(Prog().num(1).num(10).num(20).op(OP_SEL)));
+  TEST_ASSERT_EQUAL_UINT8(20, red(Prog().num(0).num(10).num(20).op(OP_SEL)));
+  TEST_ASSERT_EQUAL_UINT8(10, red(Prog().num(-0.5).num(10).num(20).op(OP_SEL)));   // any non-zero is true
+  TEST_ASSERT_EQUAL_UINT8(10, red(Prog().raw(1).num(10).num(20).op(OP_SEL)));      // even 1/256
+  // the first pushed is the left side for the other two-value ops too
+  TEST_ASSERT_EQUAL_UINT8(7, red(Prog().num(10).num(3).op(OP_SUB)));
+  TEST_ASSERT_EQUAL_UINT8(5, red(Prog().num(10).num(2).op(OP_DIV)));
+  TEST_ASSERT_EQUAL_UINT8(1, red(Prog().num(2).num(3).op(OP_LT)));
+  TEST_ASSERT_EQUAL_UINT8(0, red(Prog().num(2).num(3).op(OP_GT)));
+  TEST_ASSERT_EQUAL_UINT8(2, red(Prog().num(2).num(3).op(OP_MIN)));
+  TEST_ASSERT_EQUAL_UINT8(3, red(Prog().num(2).num(3).op(OP_MAX)));
+}
+
+void test_mod_and_div(void) {
+  TEST_ASSERT_EQUAL_INT32(1 * ONE, detail::mod(-5 * ONE, 3 * ONE));
+  TEST_ASSERT_EQUAL_INT32(1 * ONE, detail::mod(-5 * ONE, -3 * ONE));
+  TEST_ASSERT_EQUAL_INT32(2 * ONE, detail::mod(5 * ONE, -3 * ONE));
+  TEST_ASSERT_EQUAL_INT32(0, detail::mod(-6 * ONE, 3 * ONE));
+  TEST_ASSERT_EQUAL_INT32(0, detail::mod(INT32_MIN, -1));             // no INT_MIN % -1 trap
+  TEST_ASSERT_EQUAL_INT32(0, detail::mod(7 * ONE, 0));
+  // (i - 5) % 3 through run(): i = 0 → -5 % 3 = 1
+  TEST_ASSERT_EQUAL_UINT8(1, red(Prog().op(OP_I).num(5).op(OP_SUB).num(3).op(OP_MOD), pixel(0)));
+  TEST_ASSERT_EQUAL_UINT8(0, red(Prog().num(200).num(0).op(OP_MOD)));
+  TEST_ASSERT_EQUAL_UINT8(0, red(Prog().num(200).num(0).op(OP_DIV)));
+  TEST_ASSERT_EQUAL_UINT8(0, red(Prog().num(200).raw(0).op(OP_DIV)));
+  TEST_ASSERT_EQUAL_UINT8(2, red(Prog().num(10).num(4).op(OP_DIV)));   // 2.5 is cut to 2
+  TEST_ASSERT_EQUAL_UINT8(255, red(Prog().num(100).raw(1).op(OP_DIV)));   // 100 / (1/256) = 25600 → 255
+}
+
+void test_sin_quadrant_edges(void) {
+  TEST_ASSERT_EQUAL_INT32(0, detail::sinTurns(0));
+  TEST_ASSERT_EQUAL_INT32(ONE, detail::sinTurns(64));         // a quarter turn
+  TEST_ASSERT_EQUAL_INT32(0, detail::sinTurns(128));
+  TEST_ASSERT_EQUAL_INT32(-ONE, detail::sinTurns(192));
+  TEST_ASSERT_EQUAL_INT32(0, detail::sinTurns(256));          // a whole turn is 0 again
+  TEST_ASSERT_EQUAL_INT32(-ONE, detail::sinTurns(-64));
+  for (int32_t a = 0; a < 256; a++) {
+    TEST_ASSERT_EQUAL_INT32(-detail::sinTurns(a), detail::sinTurns(a + 128));   // odd around half a turn
+    TEST_ASSERT_EQUAL_INT32(detail::sinTurns(64 - (a & 63)), detail::sinTurns(64 + (a & 63)));   // mirror at the top
+    TEST_ASSERT_INT32_WITHIN(2, (int32_t)lround(sin(a * 2 * M_PI / 256) * ONE), detail::sinTurns(a));
+  }
+  for (int32_t a = 1; a <= 64; a++) TEST_ASSERT_TRUE(detail::sinTurns(a) >= detail::sinTurns(a - 1));   // rises to the top
+  // sin(0.25) * 100 + 128 through run(), and the same a whole turn later
+  TEST_ASSERT_EQUAL_UINT8(228, red(Prog().num(0.25).op(OP_SIN).num(100).op(OP_MUL).num(128).op(OP_ADD)));
+  TEST_ASSERT_EQUAL_UINT8(28, red(Prog().num(1.75).op(OP_SIN).num(100).op(OP_MUL).num(128).op(OP_ADD)));
+  TEST_ASSERT_EQUAL_INT32(ONE, detail::triTurns(128));
+  TEST_ASSERT_EQUAL_INT32(0, detail::triTurns(0));
+}
+
+void test_channel_clamps(void) {
+  TEST_ASSERT_EQUAL_UINT8(0, detail::channel(-1));            // -1/256 → 0, not 255
+  TEST_ASSERT_EQUAL_UINT8(0, detail::channel(INT32_MIN));
+  TEST_ASSERT_EQUAL_UINT8(0, detail::channel(255));           // 0.996 is cut to 0
+  TEST_ASSERT_EQUAL_UINT8(1, detail::channel(511));
+  TEST_ASSERT_EQUAL_UINT8(255, detail::channel(255 * ONE + 255));
+  TEST_ASSERT_EQUAL_UINT8(255, detail::channel(256 * ONE));
+  TEST_ASSERT_EQUAL_UINT8(255, detail::channel(INT32_MAX));
+  Prog p; p.num(-5).num(300).num(128.5);
+  uint8_t out[3];
+  run(p.code, p.len, pixel(), out);
+  TEST_ASSERT_EQUAL_UINT8(0, out[0]);
+  TEST_ASSERT_EQUAL_UINT8(255, out[1]);
+  TEST_ASSERT_EQUAL_UINT8(128, out[2]);
+}
+
+void test_overflow_wraps(void) {
+  // INT32_MAX + 1/256 wraps to the most negative value → clamped to 0
+  TEST_ASSERT_EQUAL_UINT8(0, red(Prog().raw(INT32_MAX).raw(1).op(OP_ADD)));
+  TEST_ASSERT_EQUAL_UINT8(0, red(Prog().raw(INT32_MIN).op(OP_NEG)));   // -INT32_MIN and |INT32_MIN|
+  TEST_ASSERT_EQUAL_UINT8(0, red(Prog().raw(INT32_MIN).op(OP_ABS)));   // stay negative
+  TEST_ASSERT_EQUAL_UINT8(5, red(Prog().raw(0x40000000).num(4).op(OP_MUL).num(5).op(OP_ADD)));   // 2^22 * 4 = 2^32 → 0
+}
+
+void test_rnd_is_a_hash(void) {
+  for (int32_t v = -1000; v < 1000; v += 7) {
+    TEST_ASSERT_EQUAL_INT32(detail::rnd(v), detail::rnd(v));
+    TEST_ASSERT_TRUE(detail::rnd(v) >= 0 && detail::rnd(v) < ONE);
+  }
+  TEST_ASSERT_NOT_EQUAL(detail::rnd(1), detail::rnd(2));
+}
+
+int main(int, char**) {
+  UNITY_BEGIN();
+  RUN_TEST(test_verify_rejects);
+  RUN_TEST(test_full_stack_runs);
+  RUN_TEST(test_inputs);
+  RUN_TEST(test_sel_operand_order);
+  RUN_TEST(test_mod_and_div);
+  RUN_TEST(test_sin_quadrant_edges);
+  RUN_TEST(test_channel_clamps);
+  RUN_TEST(test_overflow_wraps);
+  RUN_TEST(test_rnd_is_a_hash);
+  return UNITY_END();
+}
@@ -0,0 +1,282 @@
+/*
+test_preview_codec — include/PreviewCodec.h: the live preview messages and pacing
+- encode() / encodeKey() → decode() gives the client the same frame as the
+  strip, for random frames from "nothing changed" to "everything changed";
+  runs longer than RUN_MAX split into several tokens, and a delta that would
+  not be smaller than a keyframe goes out as a keyframe.
+- decode() rejects what it cannot apply: short header, unknown type, LED
+  count mismatch, truncated keyframe / run, runs past the last LED.
+- Pacer: backs off while two frames are unacked (up to INTERVAL_MAX_MS),
+  shrinks 1/8 per ack that empties the pipe, ignores stale and bogus acks,
+  and keeps counting across the 8-bit seq wraparound.
+
+Run (from the project folder):
+  pio test -e native -f test_preview_codec
+*/
+
+#include <unity.h>
+#include <PreviewCodec.h>
+
+using namespace Preview;
+
+void setUp(void) {}
+void tearDown(void) {}
+
+static const uint8_t LEDS = 200;
+
+static uint32_t rng = 2463534242u;
+static uint32_t next() { rng ^= rng << 13; rng ^= rng >> 17; rng ^= rng << 5; return rng; }
+
+static uint8_t msg[maxMessage(255)];
+
+// ---------- codec ----------
+
+void test_round_trip(void) {
+  static uint8_t strip[255 * 3], prev[255 * 3], client[255 * 3];
+  uint8_t clientCount = 0;
+  for (uint16_t k = 0; k < 3000; k++) {
+    uint8_t count = (k % 50 == 0) ? (uint8_t)(1 + next() % 255) : (clientCount ? clientCount : 60);
+    bool key = (count != clientCount);
+    if (key) for (uint16_t b = 0; b < count * 3; b++) strip[b] = (uint8_t)next();
+    uint8_t changed = (uint8_t)(next() % 101);           // % of LEDs that change
+    for (uint8_t i = 0; i < count; i++)
+      if (next() % 100 < changed) strip[i * 3 + next() % 3] ^= (uint8_t)(1 + next() % 255);
+    uint8_t seq = (uint8_t)k;
+    uint16_t len = key ? encodeKey(msg, seq, strip, count) : encode(msg, seq, strip, prev, count);
+    TEST_ASSERT_TRUE(len <= maxMessage(count));
+    if (len == 0) {                                      // nothing changed: nothing sent
+      TEST_ASSERT_EQUAL_UINT8_ARRAY(prev, strip, count * 3);
+      continue;
+    }
+    TEST_ASSERT_EQUAL_UINT8(seq, msg[1]);
+    TEST_ASSERT_EQUAL_UINT8(count, msg[2]);
+    if (msg[0] == TYPE_DELTA) TEST_ASSERT_TRUE(len < HEADER + count * 3);
+    TEST_ASSERT_TRUE(decode(client, 255, clientCount, msg, len));
+    TEST_ASSERT_EQUAL_UINT8(count, clientCount);
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(strip, client, count * 3);
+    memcpy(prev, strip, count * 3);
+  }
+}
+
+void test_unchanged_is_empty(void) {
+  static uint8_t a[LEDS * 3];
+  for (uint16_t b = 0; b < sizeof(a); b++) a[b] = (uint8_t)b;
+  TEST_ASSERT_EQUAL_UINT16(0, encode(msg, 1, a, a, LEDS));
+}
+
+void test_skip_run_at_run_max(void) {
+  static uint8_t prev[LEDS * 3], rgb[LEDS * 3];
+  memset(prev, 0, sizeof(prev));
+  memcpy(rgb, prev, sizeof(rgb));
+  rgb[130 * 3] = 7;                                      // 130 unchanged, 1 changed, rest unchanged
+  uint16_t len = encode(msg, 9, rgb, prev, LEDS);
+  TEST_ASSERT_EQUAL_UINT16(HEADER + 1 + 1 + 1 + 3, len);
+  TEST_ASSERT_EQUAL_UINT8(TYPE_DELTA, msg[0]);
+  TEST_ASSERT_EQUAL_UINT8(RUN_MAX - 1, msg[3]);          // skip 128
+  TEST_ASSERT_EQUAL_UINT8(1, msg[4]);                    // skip 2
+  TEST_ASSERT_EQUAL_UINT8(0x80, msg[5]);                 // 1 literal
+  TEST_ASSERT_EQUAL_UINT8(7, msg[6]);
+
+  memcpy(rgb, prev, sizeof(rgb));
+  rgb[2] = 9;                                            // LED 0, then 199 unchanged: no skip tokens
+  TEST_ASSERT_EQUAL_UINT16(HEADER + 1 + 3, encode(msg, 10, rgb, prev, LEDS));
+}
+
+void test_literal_run_at_run_max(void) {
+  static uint8_t prev[LEDS * 3], rgb[LEDS * 3];
+  memset(prev, 0, sizeof(prev));
+  memcpy(rgb, prev, sizeof(rgb));
+  for (uint8_t i = 0; i < 130; i++) rgb[i * 3 + 1] = (uint8_t)(i + 1);
+  uint16_t len = encode(msg, 9, rgb, prev, LEDS);
+  TEST_ASSERT_EQUAL_UINT16(HEADER + 1 + RUN_MAX * 3 + 1 + 2 * 3, len);
+  TEST_ASSERT_EQUAL_UINT8(TYPE_DELTA, msg[0]);
+  TEST_ASSERT_EQUAL_UINT8(0x7F + RUN_MAX, msg[3]);       // 128 literals
+  TEST_ASSERT_EQUAL_UINT8(0x81, msg[HEADER + 1 + RUN_MAX * 3]);   // then 2 more
+  TEST_ASSERT_EQUAL_UINT8(130, msg[len - 2]);            // green of LED 129
+}
+
+void test_keyframe_when_delta_is_not_smaller(void) {
+  static uint8_t prev[LEDS * 3], rgb[LEDS * 3];
+  memset(prev, 0, sizeof(prev));
+  memset(rgb, 1, sizeof(rgb));                           // everything changed
+  uint16_t len = encode(msg, 3, rgb, prev, LEDS);
+  TEST_ASSERT_EQUAL_UINT8(TYPE_KEY, msg[0]);
+  TEST_ASSERT_EQUAL_UINT16(maxMessage(LEDS), len);
+
+  // 3 LEDs, first and last changed: the delta is 1+3 + 1 + 1+3 = 9 bytes,
+  // exactly as large as the keyframe's 9 → keyframe
+  uint8_t p3[9] = { 0 }, c3[9] = { 5, 5, 5, 0, 0, 0, 6, 6, 6 };
+  len = encode(msg, 4, c3, p3, 3);
+  TEST_ASSERT_EQUAL_UINT8(TYPE_KEY, msg[0]);
+  TEST_ASSERT_EQUAL_UINT16(HEADER + 9, len);
+  // 4 LEDs with the same two changes: 9 < 12, stays a delta
+  uint8_t p4[12] = { 0 }, c4[12] = { 5, 5, 5, 0, 0, 0, 6, 6, 6, 0, 0, 0 };
+  len = encode(msg, 5, c4, p4, 4);
+  TEST_ASSERT_EQUAL_UINT8(TYPE_DELTA, msg[0]);
+  TEST_ASSERT_EQUAL_UINT16(HEADER + 9, len);
+}
+
+void test_decode_rejects(void) {
+  static uint8_t frame[LEDS * 3];
+  uint8_t count = 4;
+
+  const uint8_t shortHeader[] = { TYPE_KEY, 0 };
+  TEST_ASSERT_FALSE(decode(frame, LEDS, count, shortHeader, sizeof(shortHeader)));
+  const uint8_t badType[] = { 'X', 0, 4 };
+  TEST_ASSERT_FALSE(decode(frame, LEDS, count, badType, sizeof(badType)));
+
+  // keyframe larger than the client's buffer, or shorter / longer than its count
+  uint8_t key[HEADER + 5 * 3] = { TYPE_KEY, 1, 5 };
+  TEST_ASSERT_FALSE(decode(frame, 4, count, key, sizeof(key)));
+  TEST_ASSERT_FALSE(decode(frame, LEDS, count, key, sizeof(key) - 1));
+  key[2] = 4;
+  TEST_ASSERT_FALSE(decode(frame, LEDS, count, key, sizeof(key)));
+  TEST_ASSERT_EQUAL_UINT8(4, count);                     // count is only set by a good keyframe
+
+  // delta for another LED count than the client has
+  const uint8_t mismatch[] = { TYPE_DELTA, 2, 5, 0x80, 1, 2, 3 };
+  TEST_ASSERT_FALSE(decode(frame, LEDS, count, mismatch, sizeof(mismatch)));
+
+  // literal run that promises 2 LEDs and brings 1
+  const uint8_t truncated[] = { TYPE_DELTA, 3, 4, 0x81, 1, 2, 3 };
+  TEST_ASSERT_FALSE(decode(frame, LEDS, count, truncated, sizeof(truncated)));
+
+  // runs past the last LED: literals, and skips
+  const uint8_t longLiteral[] = { TYPE_DELTA, 4, 4, 0x02, 0x81, 1, 2, 3, 4, 5, 6 };
+  TEST_ASSERT_FALSE(decode(frame, LEDS, count, longLiteral, sizeof(longLiteral)));
+  const uint8_t longSkip[] = { TYPE_DELTA, 5, 4, 0x04 };
+  TEST_ASSERT_FALSE(decode(frame, LEDS, count, longSkip, sizeof(longSkip)));
+
+  // and the same shapes that do fit are fine
+  const uint8_t lastLed[] = { TYPE_DELTA, 6, 4, 0x02, 0x80, 1, 2, 3 };
+  TEST_ASSERT_TRUE(decode(frame, LEDS, count, lastLed, sizeof(lastLed)));
+  TEST_ASSERT_EQUAL_UINT8(3, frame[3 * 3 + 2]);
+}
+
+// ---------- pacing ----------
+
+void test_pacer_interval(void) {
+  Pacer p;
+  p.reset(1000);
+  TEST_ASSERT_TRUE(p.ready(1000));                       // first frame right away
+  p.sent(1000);
+  TEST_ASSERT_FALSE(p.ready(1000 + INTERVAL_MIN_MS - 1));
+  TEST_ASSERT_TRUE(p.ready(1000 + INTERVAL_MIN_MS));
+  p.unchanged(1050);                                     // nothing to send: wait a full interval again
+  TEST_ASSERT_FALSE(p.ready(1099));
+  TEST_ASSERT_TRUE(p.ready(1100));
+}
+
+void test_pacer_backs_off_to_max(void) {
+  Pacer p;
+  uint32_t now = 0;
+  p.reset(now);
+  p.sent(now);
+  now += INTERVAL_MIN_MS;
+  TEST_ASSERT_TRUE(p.ready(now));
+  p.sent(now);
+  TEST_ASSERT_EQUAL_UINT8(MAX_IN_FLIGHT, p.inFlight());
+  uint16_t expect = INTERVAL_MIN_MS;
+  for (uint8_t k = 0; k < 10; k++) {                     // the client never acks
+    now += p.intervalMs;
+    TEST_ASSERT_FALSE(p.ready(now));
+    expect = (expect * 2 > INTERVAL_MAX_MS) ? INTERVAL_MAX_MS : expect * 2;
+    TEST_ASSERT_EQUAL_UINT16(expect, p.intervalMs);
+    TEST_ASSERT_FALSE(p.ready(now + p.intervalMs - 1));  // nothing in between either
+  }
+  TEST_ASSERT_EQUAL_UINT16(INTERVAL_MAX_MS, p.intervalMs);
+}
+
+void test_pacer_shrinks_on_ack(void) {
+  Pacer p;
+  p.reset(0);
+  p.intervalMs = INTERVAL_MAX_MS;
+  uint8_t a = p.sent(0);
+  uint8_t b = p.sent(1);
+  p.acked(a);                                            // one still in flight: no change
+  TEST_ASSERT_EQUAL_UINT16(INTERVAL_MAX_MS, p.intervalMs);
+  p.acked(b);
+  TEST_ASSERT_EQUAL_UINT8(0, p.inFlight());
+  TEST_ASSERT_EQUAL_UINT16(INTERVAL_MAX_MS - (INTERVAL_MAX_MS - INTERVAL_MIN_MS + 7) / 8, p.intervalMs);
+  uint16_t last = p.intervalMs;
+  uint8_t acks = 1;
+  while (p.intervalMs > INTERVAL_MIN_MS) {
+    p.acked(p.sent(0));
+    TEST_ASSERT_TRUE(p.intervalMs < last);
+    last = p.intervalMs;
+    TEST_ASSERT_TRUE(++acks < 60);                       // 1/8 per ack: ~35 acks from 2 s
+  }
+  TEST_ASSERT_EQUAL_UINT16(INTERVAL_MIN_MS, p.intervalMs);
+  p.acked(p.sent(0));
+  TEST_ASSERT_EQUAL_UINT16(INTERVAL_MIN_MS, p.intervalMs);
+}
+
+void test_pacer_ignores_stale_acks(void) {
+  Pacer p;
+  p.reset(0);
+  for (uint8_t k = 0; k < 3; k++) p.acked(p.sent(0));   // seq 1..3 acked
+  p.intervalMs = 400;
+  uint8_t s4 = p.sent(0), s5 = p.sent(0);
+  (void)s5;
+  TEST_ASSERT_EQUAL_UINT8(2, p.inFlight());
+  p.acked(3);                                            // already acked
+  p.acked(1);                                            // older still
+  p.acked((uint8_t)(s5 + 1));                            // never sent
+  p.acked((uint8_t)(s5 + 100));
+  TEST_ASSERT_EQUAL_UINT8(2, p.inFlight());
+  TEST_ASSERT_EQUAL_UINT16(400, p.intervalMs);
+  p.acked(s4);
+  TEST_ASSERT_EQUAL_UINT8(1, p.inFlight());
+  p.acked(s4);                                           // twice
+  TEST_ASSERT_EQUAL_UINT8(1, p.inFlight());
+  p.acked(s5);
+  TEST_ASSERT_EQUAL_UINT8(0, p.inFlight());
+  TEST_ASSERT_TRUE(p.intervalMs < 400);
+}
+
+void test_pacer_seq_wraps(void) {
+  Pacer p;
+  uint32_t now = 0;
+  p.reset(now);
+  uint8_t last = 0;
+  for (uint16_t k = 0; k < 700; k++) {                   // past 255 twice
+    TEST_ASSERT_TRUE(p.ready(now));
+    TEST_ASSERT_EQUAL_UINT8((uint8_t)(last + 1), p.nextSeq());
+    uint8_t seq = p.sent(now);
+    TEST_ASSERT_EQUAL_UINT8((uint8_t)(last + 1), seq);
+    if (k % 2 == 0) p.acked(seq);                        // every other frame stays in flight a while
+    TEST_ASSERT_TRUE(p.inFlight() <= 1);
+    last = seq;
+    now += p.intervalMs;
+  }
+  p.acked(last);
+  TEST_ASSERT_EQUAL_UINT8(0, p.inFlight());
+
+  // two in flight across the wrap: 255 and 0
+  p.sentSeq = 254; p.ackedSeq = 254;
+  TEST_ASSERT_EQUAL_UINT8(255, p.sent(now));
+  TEST_ASSERT_EQUAL_UINT8(0, p.sent(now));
+  TEST_ASSERT_EQUAL_UINT8(2, p.inFlight());
+  p.acked(254);                                          // stale, from before the wrap
+  TEST_ASSERT_EQUAL_UINT8(2, p.inFlight());
+  p.acked(255);
+  TEST_ASSERT_EQUAL_UINT8(1, p.inFlight());
+  p.acked(0);
+  TEST_ASSERT_EQUAL_UINT8(0, p.inFlight());
+}
+
+int main(int, char**) {
+  UNITY_BEGIN();
+  RUN_TEST(test_round_trip);
+  RUN_TEST(test_unchanged_is_empty);
+  RUN_TEST(test_skip_run_at_run_max);
+  RUN_TEST(test_literal_run_at_run_max);
+  RUN_TEST(test_keyframe_when_delta_is_not_smaller);
+  RUN_TEST(test_decode_rejects);
+  RUN_TEST(test_pacer_interval);
+  RUN_TEST(test_pacer_backs_off_to_max);
+  RUN_TEST(test_pacer_shrinks_on_ack);
+  RUN_TEST(test_pacer_ignores_stale_acks);
+  RUN_TEST(test_pacer_seq_wraps);
+  return UNITY_END();
+}
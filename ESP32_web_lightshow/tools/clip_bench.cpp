@@ -0,0 +1,124 @@
+/*
+clip_bench.cpp — decode time of include/ClipCodec.h on the PC
+- Without arguments it encodes a few typical clips in memory (a rainbow,
+  a logo reveal on black, noise that changes every LED every frame) at 60
+  and 300 LEDs; with a file it times the clips of that image
+  (tools/clip_encode.cpp).
+- Prints bytes per frame and ns per frame played in order (one record) and
+  after jumps to random frames (keyframe + deltas, as after a sync jump).
+  The ESP32 reads from flash through the cache, so expect it several times
+  slower; the ratio between clips is what this is for.
+
+Build and run (from this folder):
+  g++ -O2 -std=c++11 -I../include clip_bench.cpp -o clip_bench
+  ./clip_bench              built-in clips
+  ./clip_bench clips.bin    clips of an image
+*/
+
+#include "ClipCodec.h"
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <vector>
+
+static volatile uint32_t sink;   // keeps the decoded frames alive for the optimizer
+
+static double nowNs() {
+  timespec t;
+  clock_gettime(CLOCK_MONOTONIC, &t);
+  return t.tv_sec * 1e9 + t.tv_nsec;
+}
+
+// One clip as frame offsets + records (the same layout as in the image)
+static std::vector<uint8_t> encode(const std::vector<std::vector<uint8_t> >& frames, uint16_t leds, uint16_t keyEvery) {
+  std::vector<uint8_t> out(frames.size() * 4), key(Clip::maxFrame(leds)), delta(Clip::maxFrame(leds));
+  for (size_t f = 0; f < frames.size(); f++) {
+    Clip::put32(&out[f * 4], (uint32_t)out.size());
+    uint32_t k = Clip::encodeKey(key.data(), frames[f].data(), leds);
+    uint32_t d = (f % keyEvery) ? Clip::encodeDelta(delta.data(), frames[f].data(), frames[f - 1].data(), leds) : k;
+    if (f % keyEvery && d < k) out.insert(out.end(), delta.begin(), delta.begin() + d);
+    else out.insert(out.end(), key.begin(), key.begin() + k);
+  }
+  return out;
+}
+
+static void bench(const Clip::Info& c) {
+  if (!Clip::check(c)) { printf("%-16s damaged\n", c.name); return; }
+  std::vector<uint8_t> buf(c.leds * 3);
+  Clip::Player p;
+  p.start(&c);
+  uint32_t loops = 2000000 / c.frames / (c.leds / 60 + 1) + 1;
+  uint32_t sum = 0;
+  double t0 = nowNs();
+  for (uint32_t step = 0; step < loops * c.frames; step++) { p.show(step, buf.data()); sum += buf[step % buf.size()]; }
+  double seq = (nowNs() - t0) / (loops * c.frames);
+
+  uint32_t jumps = loops * c.frames / 8 + 1;
+  std::vector<uint32_t> steps(jumps);
+  srand(7);
+  for (uint32_t i = 0; i < jumps; i++) steps[i] = (uint32_t)rand();
+  uint32_t records = p.records;
+  t0 = nowNs();
+  for (uint32_t i = 0; i < jumps; i++) { p.invalidate(); p.show(steps[i], buf.data()); sum += buf[0]; }
+  double jump = (nowNs() - t0) / jumps;
+  double perJump = (double)(p.records - records) / jumps;
+  printf("%-16s %4u LEDs %5u frames %7.1f B/frame (raw %u)  in order %7.1f ns/frame  jump %8.1f ns (%.1f records)\n",
+         c.name, c.leds, c.frames, (double)c.size / c.frames, c.leds * 3, seq, jump, perJump);
+  sink = sum;
+}
+
+static Clip::Info info(const char* name, const std::vector<uint8_t>& data, uint16_t leds, uint16_t frames) {
+  Clip::Info c = {};
+  snprintf(c.name, sizeof(c.name), "%s", name);
+  c.leds = leds; c.frames = frames; c.frameMs = 40;
+  c.size = (uint32_t)data.size();
+  c.data = data.data();
+  return c;
+}
+
+int main(int argc, char** argv) {
+  if (argc > 1) {
+    FILE* f = fopen(argv[1], "rb");
+    if (!f) { fprintf(stderr, "%s: cannot open\n", argv[1]); return 1; }
+    std::vector<uint8_t> image;
+    uint8_t b[4096];
+    size_t n;
+    while ((n = fread(b, 1, sizeof(b), f)) > 0) image.insert(image.end(), b, b + n);
+    fclose(f);
+    Clip::Library lib;
+    if (!lib.open(image.data(), (uint32_t)image.size())) { fprintf(stderr, "%s: not a clip image\n", argv[1]); return 1; }
+    for (uint8_t i = 0; i < lib.count(); i++) bench(lib.clip(i));
+    return 0;
+  }
+
+  const uint16_t SIZES[] = { 60, 300 };
+  for (uint16_t leds : SIZES) {
+    const uint16_t N = 240;
+    std::vector<std::vector<uint8_t> > rainbow(N), logo(N), noise(N);
+    uint32_t rng = 12345;
+    for (uint16_t f = 0; f < N; f++) {
+      rainbow[f].resize(leds * 3);
+      logo[f].assign(leds * 3, 0);
+      noise[f].resize(leds * 3);
+      for (uint16_t i = 0; i < leds; i++) {
+        float h = (i * 256.0f / leds + f) / 256.0f * 6.2832f;
+        rainbow[f][i * 3] = (uint8_t)(127 + 127 * sinf(h));
+        rainbow[f][i * 3 + 1] = (uint8_t)(127 + 127 * sinf(h + 2.094f));
+        rainbow[f][i * 3 + 2] = (uint8_t)(127 + 127 * sinf(h + 4.189f));
+        // logo: a white bar grows from the middle, then a colored letter band fades in
+        uint16_t half = (uint16_t)((uint32_t)f * leds / N / 2);
+        if (i + half >= leds / 2 && i < leds / 2 + half) {
+          uint8_t v = (i / 5) % 2 ? 255 : (uint8_t)(f > N / 2 ? (f - N / 2) * 255 / (N / 2) : 0);
+          logo[f][i * 3] = v; logo[f][i * 3 + 1] = v; logo[f][i * 3 + 2] = 255;
+        }
+        for (uint8_t c = 0; c < 3; c++) { rng ^= rng << 13; rng ^= rng >> 17; rng ^= rng << 5; noise[f][i * 3 + c] = (uint8_t)rng; }
+      }
+    }
+    std::vector<uint8_t> r = encode(rainbow, leds, 32), l = encode(logo, leds, 32), z = encode(noise, leds, 32);
+    bench(info("rainbow", r, leds, N));
+    bench(info("logo reveal", l, leds, N));
+    bench(info("noise", z, leds, N));
+  }
+  return 0;
+}
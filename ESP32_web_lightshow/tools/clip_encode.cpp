@@ -0,0 +1,195 @@
+/*
+clip_encode.cpp — builds the "clips" partition image (include/ClipCodec.h) from pictures
+- A clip is a list of binary PPM pictures (P6, 8 bit; e.g. ImageMagick:
+  magick logo_*.png logo_%03d.ppm). One picture = one frame, its pixels in
+  reading order (row by row) are LEDs 0, 1, 2, ...
+- -sheet: one picture is a whole clip, each row is a frame (width = LEDs);
+  handy for strips drawn in a paint program.
+- Keyframe every -key frames (default 32), otherwise a delta when it is
+  smaller. The image is decoded again at the end and compared with the
+  pictures, so a clip that does not play back exactly is never written.
+
+Build and run (from this folder):
+  g++ -O2 -std=c++11 -I../include clip_encode.cpp -o clip_encode
+  ./clip_encode clips.bin -name logo -ms 40 logo_*.ppm -name wave -ms 25 -sheet wave.ppm
+Flash it (offset of "clips" in ../partitions.csv); clips are shows 12..15:
+  esptool.py --chip esp32 write_flash 0x1F0000 clips.bin
+*/
+
+#include "ClipCodec.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <vector>
+
+struct Source {
+  std::string name;
+  uint16_t ms = 40, key = 32, leds = 0;
+  std::vector<std::vector<uint8_t> > frames;   // RGB per LED
+};
+
+// Binary PPM into w, h and RGB, or false with a message
+static bool loadPpm(const char* path, int& w, int& h, std::vector<uint8_t>& rgb) {
+  FILE* f = fopen(path, "rb");
+  if (!f) { fprintf(stderr, "%s: cannot open\n", path); return false; }
+  int maxval = 0;
+  char magic[3] = {};
+  bool ok = fscanf(f, "%2s", magic) == 1 && strcmp(magic, "P6") == 0;
+  // header fields, each may be preceded by # comments
+  int* fields[] = { &w, &h, &maxval };
+  for (int i = 0; ok && i < 3; i++) {
+    int c;
+    while ((c = fgetc(f)) == '#' || c == ' ' || c == '\t' || c == '\r' || c == '\n')
+      if (c == '#') while ((c = fgetc(f)) != '\n' && c != EOF) {}
+    ungetc(c, f);
+    ok = fscanf(f, "%d", fields[i]) == 1;
+  }
+  ok = ok && fgetc(f) != EOF && maxval == 255 && w > 0 && h > 0;
+  if (ok) {
+    rgb.resize((size_t)w * h * 3);
+    ok = fread(rgb.data(), 1, rgb.size(), f) == rgb.size();
+  }
+  fclose(f);
+  if (!ok) fprintf(stderr, "%s: not a binary 8-bit PPM (P6, maxval 255)\n", path);
+  return ok;
+}
+
+static bool addFrame(Source& s, const char* path, const uint8_t* rgb, int leds) {
+  if (s.frames.empty()) s.leds = (uint16_t)leds;
+  if (leds != s.leds || leds > 0xFFFF) {
+    fprintf(stderr, "%s: %d LEDs, clip '%s' has %u\n", path, leds, s.name.c_str(), s.leds);
+    return false;
+  }
+  if (s.frames.size() == 0xFFFF) { fprintf(stderr, "clip '%s': too many frames\n", s.name.c_str()); return false; }
+  s.frames.push_back(std::vector<uint8_t>(rgb, rgb + leds * 3));
+  return true;
+}
+
+// Frame offsets, then the records: keyframe on frame 0 and every s.key frames,
+// otherwise the smaller of delta and keyframe
+static std::vector<uint8_t> encodeClip(const Source& s, uint32_t& keys) {
+  uint32_t n = (uint32_t)s.frames.size();
+  std::vector<uint8_t> out(n * 4);
+  std::vector<uint8_t> key(Clip::maxFrame(s.leds)), delta(Clip::maxFrame(s.leds));
+  keys = 0;
+  for (uint32_t f = 0; f < n; f++) {
+    Clip::put32(&out[f * 4], (uint32_t)out.size());
+    uint32_t k = Clip::encodeKey(key.data(), s.frames[f].data(), s.leds);
+    uint32_t d = (f % s.key) ? Clip::encodeDelta(delta.data(), s.frames[f].data(), s.frames[f - 1].data(), s.leds) : k;
+    if (f % s.key && d < k) {
+      out.insert(out.end(), delta.begin(), delta.begin() + d);
+    } else {
+      out.insert(out.end(), key.begin(), key.begin() + k);
+      keys++;
+    }
+  }
+  return out;
+}
+
+// Plays the image back (in order and in jumps) and compares every frame
+static bool verify(const std::vector<uint8_t>& image, const std::vector<Source>& srcs) {
+  Clip::Library lib;
+  if (!lib.open(image.data(), (uint32_t)image.size()) || lib.count() != srcs.size()) return false;
+  for (uint8_t c = 0; c < lib.count(); c++) {
+    if (!lib.playable(c)) return false;
+    const Source& s = srcs[c];
+    std::vector<uint8_t> buf(s.leds * 3);
+    Clip::Player player;
+    player.start(&lib.clip(c));
+    uint32_t n = (uint32_t)s.frames.size();
+    for (uint32_t step = 0; step < 2 * n; step++) {
+      player.show(step, buf.data());
+      if (memcmp(buf.data(), s.frames[step % n].data(), buf.size())) return false;
+    }
+    srand(c + 1);
+    for (uint32_t i = 0; i < n; i++) {
+      uint32_t step = (uint32_t)rand() % n;
+      player.show(step, buf.data());
+      if (memcmp(buf.data(), s.frames[step].data(), buf.size())) return false;
+    }
+  }
+  return true;
+}
+
+static void usage() {
+  fprintf(stderr, "usage: clip_encode out.bin [-name NAME] [-ms FRAME_MS] [-key N] [-sheet] pictures.ppm ...\n"
+                  "       options apply to the pictures after them; -name starts a new clip\n");
+}
+
+int main(int argc, char** argv) {
+  if (argc < 3) { usage(); return 1; }
+  std::vector<Source> srcs;
+  Source cur;
+  bool sheet = false;
+  for (int a = 2; a < argc; a++) {
+    const char* arg = argv[a];
+    bool hasValue = a + 1 < argc;
+    if (!strcmp(arg, "-name") && hasValue) {
+      if (!cur.frames.empty()) srcs.push_back(cur);
+      uint16_t ms = cur.ms, key = cur.key;
+      cur = Source();
+      cur.ms = ms; cur.key = key;
+      cur.name = argv[++a];
+      sheet = false;
+    } else if (!strcmp(arg, "-ms") && hasValue) {
+      cur.ms = (uint16_t)atoi(argv[++a]);
+    } else if (!strcmp(arg, "-key") && hasValue) {
+      int k = atoi(argv[++a]);
+      cur.key = (uint16_t)(k < 1 ? 1 : k > 0xFFFF ? 0xFFFF : k);
+    } else if (!strcmp(arg, "-sheet")) {
+      sheet = true;
+    } else if (arg[0] == '-') {
+      usage();
+      return 1;
+    } else {
+      int w, h;
+      std::vector<uint8_t> rgb;
+      if (!loadPpm(arg, w, h, rgb)) return 1;
+      if (cur.name.empty()) cur.name = "clip" + std::to_string(srcs.size() + 1);
+      if (sheet) {
+        for (int y = 0; y < h; y++)
+          if (!addFrame(cur, arg, &rgb[(size_t)y * w * 3], w)) return 1;
+      } else if (!addFrame(cur, arg, rgb.data(), w * h)) {
+        return 1;
+      }
+    }
+  }
+  if (!cur.frames.empty()) srcs.push_back(cur);
+  if (srcs.empty() || srcs.size() > Clip::MAX_CLIPS) {
+    fprintf(stderr, "need 1..%u clips\n", Clip::MAX_CLIPS);
+    return 1;
+  }
+
+  std::vector<uint8_t> image(Clip::HEADER + srcs.size() * Clip::ENTRY);
+  memcpy(&image[0], "CLIP", 4);
+  image[4] = Clip::VERSION;
+  image[5] = (uint8_t)srcs.size();
+  for (size_t c = 0; c < srcs.size(); c++) {
+    const Source& s = srcs[c];
+    uint32_t keys;
+    std::vector<uint8_t> data = encodeClip(s, keys);
+    while (image.size() % 4) image.push_back(0);
+    uint8_t* e = &image[Clip::HEADER + c * Clip::ENTRY];
+    strncpy((char*)e, s.name.c_str(), Clip::NAME_MAX - 1);
+    Clip::put32(e + Clip::NAME_MAX, (uint32_t)image.size());
+    Clip::put32(e + Clip::NAME_MAX + 4, (uint32_t)data.size());
+    Clip::put16(e + Clip::NAME_MAX + 8, s.leds);
+    Clip::put16(e + Clip::NAME_MAX + 10, (uint16_t)s.frames.size());
+    Clip::put16(e + Clip::NAME_MAX + 12, s.ms);
+    image.insert(image.end(), data.begin(), data.end());
+    uint32_t raw = (uint32_t)s.frames.size() * s.leds * 3;
+    printf("%-15s %5u frames x %3u LEDs, %u ms: %7u B (raw %u B, %.1f%%), %u keyframes\n", s.name.c_str(),
+           (unsigned)s.frames.size(), s.leds, s.ms, (unsigned)data.size(), raw, 100.0 * data.size() / raw, keys);
+  }
+  if (!verify(image, srcs)) { fprintf(stderr, "decoded image does not match the pictures\n"); return 1; }
+
+  FILE* f = fopen(argv[1], "wb");
+  if (!f || fwrite(image.data(), 1, image.size(), f) != image.size()) {
+    fprintf(stderr, "%s: cannot write\n", argv[1]);
+    return 1;
+  }
+  fclose(f);
+  printf("%s: %u bytes, %u clips (partition: 2 MB)\n", argv[1], (unsigned)image.size(), (unsigned)srcs.size());
+  return 0;
+}
@@ -0,0 +1,234 @@
+/*
+pixelvm_bench.cpp — ns per pixel of include/PixelVM.h against the native shows
+- native   advanceRainbow/Theater/Breath/Wave() from src/main.cpp (copies
+           below; keep them in step), writing the same frame[]
+- vm       the page's presets (Plasma, Rainbow, Embers, Sparkle, Theater),
+           compiled by compile() below – the page's vmCompile() in C++ –
+           and run per LED like advanceCustom()
+- A program given on the command line is compiled, verified and timed too.
+- Build it twice to compare the dispatch loops: computed goto (the default
+  with g++) and a plain switch (-DPIXELVM_SWITCH_DISPATCH).
+  The ESP32 is several times slower per pixel; the ratios are what this is for.
+
+Build and run (from this folder):
+  g++ -O2 -std=c++11 -I../include -I../../Arduino_custom_library_demo_IR_remote/MyShows pixelvm_bench.cpp -o pixelvm_bench
+  g++ -O2 -std=c++11 -DPIXELVM_SWITCH_DISPATCH -I../include -I../../Arduino_custom_library_demo_IR_remote/MyShows pixelvm_bench.cpp -o pixelvm_bench_switch
+  ./pixelvm_bench
+  ./pixelvm_bench "sin(x + t/64) * 255, 0, 0"
+*/
+
+#include "PixelVM.h"
+#include <MyPalette.h>
+#include <ctype.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <time.h>
+#include <vector>
+
+static volatile uint32_t sink;   // keeps the frames alive for the optimizer
+
+static double nowNs() {
+  timespec t;
+  clock_gettime(CLOCK_MONOTONIC, &t);
+  return t.tv_sec * 1e9 + t.tv_nsec;
+}
+
+// ---- compile(): the page's vmCompile() ----
+
+struct Compiler {
+  std::vector<std::string> tok;
+  size_t p = 0;
+  std::vector<uint8_t> out;
+  std::string error;
+
+  bool is(const char* a, const char* b = "", const char* c = "") const {
+    if (p >= tok.size()) return false;
+    return tok[p] == a || tok[p] == b || tok[p] == c;
+  }
+  std::string take(const char* want = nullptr) {
+    std::string t = p < tok.size() ? tok[p] : "";
+    p++;
+    if (want && t != want && error.empty()) error = std::string("expected '") + want + "' but found '" + (t.empty() ? "end" : t) + "'";
+    return t;
+  }
+  void num(double v) {
+    long q = lround(v * 256);                                   // Q8
+    if (q >= -32768 && q <= 32767) { out.push_back(PixelVM::OP_PUSH16); out.push_back(q & 255); out.push_back((q >> 8) & 255); }
+    else { out.push_back(PixelVM::OP_PUSH32); for (int k = 0; k < 4; k++) out.push_back((uint8_t)((uint32_t)q >> (8 * k))); }
+  }
+  static int op(const std::string& t) {
+    static const char* const NAMES[] = { "i", "n", "t", "x", "r", "g", "b", "+", "-", "*", "/", "%",
+                                         "min", "max", "<", ">", "neg", "abs", "sin", "tri", "rnd", "sel" };
+    for (int k = 0; k < 22; k++) if (t == NAMES[k]) return PixelVM::OP_I + k;
+    return -1;
+  }
+  static int args(const std::string& t) {
+    if (t == "min" || t == "max") return 2;
+    if (t == "abs" || t == "sin" || t == "tri" || t == "rnd") return 1;
+    return 0;
+  }
+  void primary() {
+    std::string t = take();
+    if (t.empty()) { if (error.empty()) error = "unexpected end"; return; }
+    if (isdigit((unsigned char)t[0]) || t[0] == '.') return num(atof(t.c_str()));
+    if (t == "(") { expr(); take(")"); return; }
+    if (t.size() == 1 && strchr("intxrgb", t[0])) { out.push_back((uint8_t)op(t)); return; }
+    if (!isalpha((unsigned char)t[0])) { if (error.empty()) error = "unexpected '" + t + "'"; return; }
+    if (!args(t)) { if (error.empty()) error = "unknown name '" + t + "'"; return; }
+    take("("); expr();
+    if (args(t) == 2) { take(","); expr(); }
+    take(")"); out.push_back((uint8_t)op(t));
+  }
+  void unary() { if (is("-")) { take(); unary(); out.push_back(PixelVM::OP_NEG); } else primary(); }
+  void mul() { unary(); while (error.empty() && is("*", "/", "%")) { std::string o = take(); unary(); out.push_back((uint8_t)op(o)); } }
+  void add() { mul(); while (error.empty() && is("+", "-")) { std::string o = take(); mul(); out.push_back((uint8_t)op(o)); } }
+  void cmp() { add(); if (is("<", ">")) { std::string o = take(); add(); out.push_back((uint8_t)op(o)); } }
+  void expr() {
+    if (error.empty()) cmp();
+    if (error.empty() && is("?")) { take(); expr(); take(":"); expr(); out.push_back(PixelVM::OP_SEL); }
+  }
+
+  bool compile(const char* src) {
+    for (const char* s = src; *s; ) {                           // \d+\.?\d*|\.\d+|[a-z]+|\S
+      if (isspace((unsigned char)*s)) { s++; continue; }
+      const char* b = s;
+      if (isdigit((unsigned char)*s)) { while (isdigit((unsigned char)*s)) s++; if (*s == '.') { s++; while (isdigit((unsigned char)*s)) s++; } }
+      else if (*s == '.' && isdigit((unsigned char)s[1])) { s++; while (isdigit((unsigned char)*s)) s++; }
+      else if (isalpha((unsigned char)*s)) { while (isalpha((unsigned char)*s)) s++; }
+      else s++;
+      std::string t(b, s);
+      for (char& c : t) c = (char)tolower((unsigned char)c);
+      tok.push_back(t);
+    }
+    expr(); take(","); expr(); take(","); expr();
+    if (error.empty() && p < tok.size()) error = "unexpected '" + tok[p] + "'";
+    if (error.empty() && out.size() > PixelVM::PROG_MAX) error = "too long: " + std::to_string(out.size()) + " bytes";
+    return error.empty();
+  }
+};
+
+// ---- the sketch's frame and native shows (src/main.cpp) ----
+
+static const uint16_t NUM_LEDS = 60;
+static uint32_t stepIndex = 0;
+static uint8_t  frame[NUM_LEDS * 3];
+static uint8_t  baseR = 255, baseG = 60, baseB = 0;
+static uint8_t  waveR = 0, waveG = 150, waveB = 255;
+static MyShows::Palette palette;
+
+static uint32_t Color(uint8_t r, uint8_t g, uint8_t b) { return (uint32_t)r << 16 | (uint32_t)g << 8 | b; }
+static void setPixel(uint16_t i, uint8_t r, uint8_t g, uint8_t b) {
+  if (i >= NUM_LEDS) return;
+  uint8_t* p = frame + i * 3;
+  p[0] = r; p[1] = g; p[2] = b;
+}
+static void setPixel(uint16_t i, uint32_t c) { setPixel(i, c >> 16, c >> 8, c); }
+
+static void advanceRainbow() {
+  for (uint16_t i = 0; i < NUM_LEDS; i++) {
+    const uint8_t* c = palette.rgb((i * 256 / NUM_LEDS + stepIndex) & 255);
+    setPixel(i, c[0], c[1], c[2]);
+  }
+}
+
+static void advanceTheater() {
+  for (uint16_t i = 0; i < NUM_LEDS; i++) {
+    if ((i + stepIndex) % 3 == 0) setPixel(i, Color(baseR, baseG, baseB));
+    else setPixel(i, 0);
+  }
+}
+
+static void advanceBreath() {
+  float phase = (stepIndex % 256) / 255.0f;
+  float breath = 0.1f + 0.9f * (0.5f - 0.5f * cos(phase * 2 * 3.14159f));
+  uint8_t r = (uint8_t)(baseR * breath), g = (uint8_t)(baseG * breath), b = (uint8_t)(baseB * breath);
+  for (uint16_t i = 0; i < NUM_LEDS; i++) setPixel(i, Color(r, g, b));
+}
+
+static void advanceWave() {
+  for (uint16_t i = 0; i < NUM_LEDS; i++) {
+    float wave = sin((i * 2 * 3.14159 / NUM_LEDS) + (stepIndex * 0.1));
+    float intensity = (wave + 1.0) / 2.0;
+    setPixel(i, Color((uint8_t)(waveR * intensity), (uint8_t)(waveG * intensity), (uint8_t)(waveB * intensity)));
+  }
+}
+
+// ---- show 11 ----
+
+static uint8_t vmCode[PixelVM::PROG_MAX];
+static uint8_t vmLen = 0;
+
+static void advanceCustom() {
+  PixelVM::Pixel px;
+  px.n = NUM_LEDS;
+  px.t = stepIndex;
+  uint8_t* p = frame;
+  for (uint16_t i = 0; i < NUM_LEDS; i++, p += 3) {
+    px.i = i; px.r = p[0]; px.g = p[1]; px.b = p[2];
+    PixelVM::run(vmCode, vmLen, px, p);
+  }
+}
+
+// ---- timing ----
+
+// best of 7 runs of `frames` steps, in ns per pixel
+static double perPixel(void (*advance)()) {
+  const uint32_t frames = 20000;
+  double best = 1e18;
+  for (int r = 0; r < 7; r++) {
+    memset(frame, 0, sizeof(frame));
+    stepIndex = 0;
+    double t0 = nowNs();
+    for (uint32_t f = 0; f < frames; f++) { advance(); stepIndex++; }
+    double t = (nowNs() - t0) / frames / NUM_LEDS;
+    sink += frame[stepIndex % sizeof(frame)];
+    if (t < best) best = t;
+  }
+  return best;
+}
+
+static bool load(const char* src) {
+  Compiler c;
+  if (!c.compile(src)) { fprintf(stderr, "%s\n  %s\n", src, c.error.c_str()); return false; }
+  PixelVM::Error e = PixelVM::verify(c.out.data(), (uint16_t)c.out.size());
+  if (e != PixelVM::OK) { fprintf(stderr, "%s\n  rejected: %s\n", src, PixelVM::errorText(e)); return false; }
+  memcpy(vmCode, c.out.data(), c.out.size());
+  vmLen = (uint8_t)c.out.size();
+  return true;
+}
+
+int main(int argc, char** argv) {
+  struct Preset { const char* name; const char* src; };
+  static const Preset PRESETS[] = {       // VM_PRESETS in src/main.cpp
+    { "Plasma",  "sin(x + t/64) * 120 + 120, sin(2*x - t/50) * 120 + 120, sin(3*x + t/80) * 120 + 120" },
+    { "Rainbow", "sin(x + t/256) * 127 + 128, sin(x + t/256 + 0.333) * 127 + 128, sin(x + t/256 + 0.667) * 127 + 128" },
+    { "Embers",  "max(r * 0.9, rnd(i + t*n) * 255), g * 0.7, 0" },
+    { "Sparkle", "rnd(i + t*n) > 0.97 ? 255 : r * 0.85, rnd(i + t*n) > 0.97 ? 255 : g * 0.85, rnd(i + t*n) > 0.97 ? 255 : b * 0.85" },
+    { "Theater", "(i + t) % 3 < 1 ? 255 : 0, (i + t) % 3 < 1 ? 120 : 0, 0" },
+  };
+  palette.load(MyShows::PAL_RAINBOW);
+
+#if defined(__GNUC__) && !defined(PIXELVM_SWITCH_DISPATCH)
+  const char* dispatch = "computed goto";
+#else
+  const char* dispatch = "switch";
+#endif
+  printf("%u LEDs, best of 7 x 20000 frames, PixelVM dispatch: %s\n", NUM_LEDS, dispatch);
+  printf("%-22s %6s %10s\n", "show", "bytes", "ns/pixel");
+  printf("%-22s %6s %10.2f\n", "native rainbow", "", perPixel(advanceRainbow));
+  printf("%-22s %6s %10.2f\n", "native theater", "", perPixel(advanceTheater));
+  printf("%-22s %6s %10.2f\n", "native breath", "", perPixel(advanceBreath));
+  printf("%-22s %6s %10.2f\n", "native wave (float)", "", perPixel(advanceWave));
+  for (const Preset& p : PRESETS) {
+    if (!load(p.src)) return 1;
+    printf("vm %-19s %6u %10.2f\n", p.name, vmLen, perPixel(advanceCustom));
+  }
+  for (int a = 1; a < argc; a++) {
+    if (!load(argv[a])) return 1;
+    printf("vm %-19s %6u %10.2f\n", "(command line)", vmLen, perPixel(advanceCustom));
+  }
+  return 0;
+}
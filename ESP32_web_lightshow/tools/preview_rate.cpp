@@ -0,0 +1,238 @@
+/*
+preview_rate.cpp — live preview bytes per second for each show (include/PreviewCodec.h)
+- Draws shows 1–10 like src/main.cpp, one step every speedMs (the
+  advance...() functions below are copies of the sketch's; keep them in
+  step when a show changes there). Custom and clip shows depend on what
+  was uploaded / flashed and are left out.
+- Every 1 ms it does what previewService() does for three page clients:
+    fast    acks 5 ms after each message (a PC on the AP)
+    slow    acks 400 ms after each message (a busy phone)
+    hidden  never acks (a background tab)
+  Each client decodes every message it gets; its frame must equal the
+  strip, or the tool stops with an error.
+- Prints B/s per client and messages/s and keyframe share for the fast one.
+  Only the preview payload counts; WebSocket framing adds 2–4 B per message.
+
+Build and run (from this folder):
+  g++ -O2 -std=c++11 -I../include -I../../Arduino_custom_library_demo_IR_remote/MyShows preview_rate.cpp -o preview_rate
+  ./preview_rate            60 LEDs, 80 ms per step (the page's default speed)
+  ./preview_rate 12 30      12 LEDs, 30 ms per step
+*/
+
+#include "PreviewCodec.h"
+#include <MyPalette.h>
+#include <MyNoise.h>
+#include <algorithm>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+static const uint16_t MAX_LEDS = 255;            // the preview's uint8_t LED count
+static const uint32_t RUN_MS = 60000;            // simulated time per show
+
+// ---- the sketch's state and shows (src/main.cpp) ----
+
+static uint16_t NUM_LEDS = 60;
+static uint32_t stepIndex = 0;
+static uint32_t showSeed = 0x5EED1234;
+static uint8_t  frame[MAX_LEDS * 3];
+static uint8_t  baseR = 255, baseG = 60, baseB = 0;
+static uint8_t  waveR = 0, waveG = 150, waveB = 255;
+static MyShows::Palette palette;
+static MyShows::NoiseFire<MAX_LEDS> fire;
+
+static uint32_t Color(uint8_t r, uint8_t g, uint8_t b) { return (uint32_t)r << 16 | (uint32_t)g << 8 | b; }
+
+static void setPixel(uint16_t i, uint8_t r, uint8_t g, uint8_t b) {
+  if (i >= MAX_LEDS) return;
+  uint8_t* p = frame + i * 3;
+  p[0] = r; p[1] = g; p[2] = b;
+}
+static void setPixel(uint16_t i, uint32_t c) { setPixel(i, c >> 16, c >> 8, c); }
+static uint32_t getPixel(uint16_t i) {
+  const uint8_t* p = frame + i * 3;
+  return (uint32_t)p[0] << 16 | (uint32_t)p[1] << 8 | p[2];
+}
+
+static void advanceRainbow() {
+  for (uint16_t i = 0; i < NUM_LEDS; i++) {
+    const uint8_t* c = palette.rgb((i * 256 / NUM_LEDS + stepIndex) & 255);
+    setPixel(i, c[0], c[1], c[2]);
+  }
+}
+
+static void advanceTheater() {
+  for (uint16_t i = 0; i < NUM_LEDS; i++) {
+    if ((i + stepIndex) % 3 == 0) setPixel(i, Color(baseR, baseG, baseB));
+    else setPixel(i, 0);
+  }
+}
+
+static void advanceColorWipe() {
+  uint16_t idx = stepIndex % (NUM_LEDS + 1);
+  for (uint16_t i = 0; i < NUM_LEDS; i++) setPixel(i, (i < idx) ? Color(0, 120, 255) : 0);
+}
+
+static void advanceBreath() {
+  float phase = (stepIndex % 256) / 255.0f;
+  float breath = 0.1f + 0.9f * (0.5f - 0.5f * cos(phase * 2 * 3.14159f));
+  uint8_t r = (uint8_t)(baseR * breath), g = (uint8_t)(baseG * breath), b = (uint8_t)(baseB * breath);
+  for (uint16_t i = 0; i < NUM_LEDS; i++) setPixel(i, Color(r, g, b));
+}
+
+static void advanceSparkle() {
+  for (uint16_t i = 0; i < NUM_LEDS; i++) {
+    uint32_t c = getPixel(i);
+    uint8_t r = (c >> 16) & 0xFF, g = (c >> 8) & 0xFF, b = c & 0xFF;
+    r = (r > 8) ? r - 8 : 0; g = (g > 8) ? g - 8 : 0; b = (b > 8) ? b - 8 : 0;
+    setPixel(i, Color(r, g, b));
+  }
+  uint32_t x = (showSeed ^ (stepIndex * 2654435761UL)) | 1;
+  for (uint8_t k = 0; k < 2; k++) {
+    x ^= x << 13; x ^= x >> 17; x ^= x << 5;
+    setPixel(x % NUM_LEDS, Color(255, 255, 255));
+  }
+}
+
+static void advanceFire() {
+  fire.step(NUM_LEDS);
+  for (uint16_t i = 0; i < NUM_LEDS; i++) {
+    const uint8_t* c = palette.rgb(fire.heat[i]);
+    setPixel(i, c[0], c[1], c[2]);
+  }
+}
+
+static void advanceWave() {
+  for (uint16_t i = 0; i < NUM_LEDS; i++) {
+    float wave = sin((i * 2 * 3.14159 / NUM_LEDS) + (stepIndex * 0.1));
+    float intensity = (wave + 1.0) / 2.0;
+    setPixel(i, Color((uint8_t)(waveR * intensity), (uint8_t)(waveG * intensity), (uint8_t)(waveB * intensity)));
+  }
+}
+
+static void advancePulse() {
+  uint16_t center = NUM_LEDS / 2;
+  float pulse = sin(stepIndex * 0.2) * 0.5 + 0.5;
+  for (uint16_t i = 0; i < NUM_LEDS; i++) {
+    float distance = abs(i - center);
+    float intensity = std::max(0.0, 1.0 - (distance / (NUM_LEDS * pulse * 0.3)));
+    setPixel(i, Color((uint8_t)(baseR * intensity), (uint8_t)(baseG * intensity), (uint8_t)(baseB * intensity)));
+  }
+}
+
+static void advanceChase() {
+  uint8_t numDots = 3;
+  uint16_t spacing = NUM_LEDS / numDots;
+  for (uint16_t i = 0; i < NUM_LEDS; i++) setPixel(i, 0);
+  for (uint8_t d = 0; d < numDots; d++) setPixel((stepIndex + d * spacing) % NUM_LEDS, Color(baseR, baseG, baseB));
+}
+
+static void advanceStrobe() {
+  bool strobeOn = (stepIndex % 4) < 2;
+  for (uint16_t i = 0; i < NUM_LEDS; i++) setPixel(i, strobeOn ? Color(baseR, baseG, baseB) : 0);
+}
+
+struct Show { const char* name; void (*advance)(); uint8_t palette; };
+static const uint8_t NO_PALETTE = 0xFF;
+static const Show SHOWS[] = {
+  { "rainbow",  advanceRainbow,   MyShows::PAL_RAINBOW },
+  { "theater",  advanceTheater,   NO_PALETTE },
+  { "wipe",     advanceColorWipe, NO_PALETTE },
+  { "breath",   advanceBreath,    NO_PALETTE },
+  { "sparkle",  advanceSparkle,   NO_PALETTE },
+  { "fire",     advanceFire,      MyShows::PAL_HEAT },
+  { "wave",     advanceWave,      NO_PALETTE },
+  { "pulse",    advancePulse,     NO_PALETTE },
+  { "chase",    advanceChase,     NO_PALETTE },
+  { "strobe",   advanceStrobe,    NO_PALETTE },
+};
+
+// ---- one page client (previewService() + the page's ack) ----
+
+struct Client {
+  const char* name;
+  int32_t  ackMs;                     // < 0 = never acks
+  Preview::Pacer pacer;
+  uint8_t  count = 0;                 // what the sketch thinks the client has
+  uint8_t  last[MAX_LEDS * 3];
+  uint8_t  shown[MAX_LEDS * 3];       // what the client decoded
+  uint8_t  shownCount = 0;
+  uint32_t ackAt[Preview::MAX_IN_FLIGHT];   // acks on the way back, oldest first
+  uint8_t  ackSeq[Preview::MAX_IN_FLIGHT];
+  uint8_t  acks = 0;
+  uint32_t bytes = 0, messages = 0, keys = 0;
+
+  Client(const char* n, int32_t ack) : name(n), ackMs(ack) {}
+
+  void start(uint32_t now) {
+    pacer.reset(now);
+    count = shownCount = 0;
+    acks = 0;
+    bytes = messages = keys = 0;
+  }
+
+  void service(uint32_t now, uint8_t leds) {
+    static uint8_t msg[Preview::maxMessage(MAX_LEDS)];
+    while (acks && now >= ackAt[0]) {
+      pacer.acked(ackSeq[0]);
+      acks--;
+      memmove(ackAt, ackAt + 1, acks * sizeof(ackAt[0]));
+      memmove(ackSeq, ackSeq + 1, acks);
+    }
+    if (!pacer.ready(now)) return;
+    uint8_t seq = pacer.nextSeq();
+    uint16_t len = (count == leds) ? Preview::encode(msg, seq, frame, last, leds)
+                                   : Preview::encodeKey(msg, seq, frame, leds);
+    if (len == 0) { pacer.unchanged(now); return; }
+    pacer.sent(now);
+    memcpy(last, frame, leds * 3);
+    count = leds;
+    bytes += len; messages++;
+    if (msg[0] == Preview::TYPE_KEY) keys++;
+
+    if (!Preview::decode(shown, MAX_LEDS, shownCount, msg, len) || shownCount != leds ||
+        memcmp(shown, frame, leds * 3) != 0) {
+      fprintf(stderr, "%s client: decoded frame differs from the strip at %u ms\n", name, (unsigned)now);
+      exit(1);
+    }
+    if (ackMs >= 0 && acks < Preview::MAX_IN_FLIGHT) { ackAt[acks] = now + ackMs; ackSeq[acks++] = seq; }
+  }
+};
+
+int main(int argc, char** argv) {
+  uint16_t speedMs = 80;
+  if (argc > 1) NUM_LEDS = (uint16_t)atoi(argv[1]);
+  if (argc > 2) speedMs = (uint16_t)atoi(argv[2]);
+  if (NUM_LEDS < 4 || NUM_LEDS > MAX_LEDS || speedMs == 0) {
+    fprintf(stderr, "usage: preview_rate [leds 4..%u] [ms per step]\n", MAX_LEDS);
+    return 1;
+  }
+
+  Client clients[] = { { "fast", 5 }, { "slow", 400 }, { "hidden", -1 } };
+  printf("%u LEDs, %u ms per step, %u s per show; raw frame %u B\n",
+         NUM_LEDS, speedMs, (unsigned)(RUN_MS / 1000), NUM_LEDS * 3);
+  printf("%-9s %9s %9s %9s %12s %6s\n", "show", "fast B/s", "slow B/s", "hidden", "fast msg/s", "key %");
+
+  for (const Show& s : SHOWS) {
+    if (s.palette != NO_PALETTE) {
+      palette.load(s.palette);
+      palette.tint({ baseR, baseG, baseB }, MyShows::BLEND_LERP, 0);
+    }
+    fire.seed(showSeed);
+    memset(frame, 0, sizeof(frame));
+    stepIndex = 0;
+    for (Client& c : clients) c.start(0);
+    uint32_t lastStepMs = 0;
+    s.advance();
+    for (uint32_t now = 0; now < RUN_MS; now++) {
+      if (now - lastStepMs >= speedMs) { lastStepMs = now; s.advance(); stepIndex++; }
+      for (Client& c : clients) c.service(now, (uint8_t)NUM_LEDS);
+    }
+    const Client& f = clients[0];
+    printf("%-9s %9.0f %9.0f %9.0f %12.1f %6.1f\n", s.name,
+           clients[0].bytes * 1000.0 / RUN_MS, clients[1].bytes * 1000.0 / RUN_MS, clients[2].bytes * 1000.0 / RUN_MS,
+           f.messages * 1000.0 / RUN_MS, f.messages ? 100.0 * f.keys / f.messages : 0.0);
+  }
+  return 0;
+}
@@ -2,7 +2,23 @@
 ESP32(-CAM) 2WD Car — Simple Throttle Joystick (forward/back only)
 - SoftAP at 192.168.4.50
 - Minimal vertical joystick: up = forward, down = reverse, release = stop
-- Software PWM on ENA=2 / ENB=12 (works on any ESP32 core)
+- Hardware LEDC PWM on ENA=2 / ENB=12 (timer-ISR fallback), see MotorDriver.h
+- Throttle changes are ramped, so the motors never jump 0 -> 255
+- Control channel: WebSocket on port 81 (binary frames, newest wins,
+  dead-man stop). The old GET /th?y=.. still works.
+
+WebSocket frame (binary, 3 bytes):
+  [0] seq       uint8, wraps; echoed back as a 1-byte ack once applied
+  [1] throttle  int8  -127..127 (up = forward)
+  [2] steer     int8  -127..127 (right = positive, mixed into L/R)
+  No frame for DEADMAN_MS -> motors coast to stop.
+
+Command-to-motor latency, WebSocket vs. GET /th:
+  From a Linux PC on the car's Wi-Fi run tools/drive_latency.cpp (build line
+  in its header). It alternates both paths and prints p50/p99 of the round
+  trip to setDrive()/setThrottle(). The page also shows the mean ack "rtt".
+  No car was in reach when the tool was written, so there are no numbers
+  yet: note p50/p99 of both paths here after the first run.
 
 WiFi:
   SSID: ESP2WDcar1
@@ -21,6 +37,8 @@ L298N wiring (unchanged):
 #include <Arduino.h>
 #include <WiFi.h>
 #include <WebServer.h>
+#include <WebSocketsServer.h>   // "WebSockets" by Markus Sattler (links2004)
+#include "MotorDriver.h"
 
 // -------- Pins (unchanged) --------
 #define ENA 2
@@ -37,35 +55,23 @@ IPAddress localIP(192,168,4,50), gateway(192,168,4,1), subnet(255,255,255,0);
 
 // -------- Web --------
 WebServer server(80);
+WebSocketsServer ws(81);
 
-// -------- Software PWM (no LEDC) --------
-const uint32_t PWM_FREQ_SOFT = 1200;                  // Hz
-const uint32_t PWM_PERIOD_US = 1000000UL / PWM_FREQ_SOFT;
-volatile uint8_t dutyL = 0, dutyR = 0;                // 0..255
-uint32_t phaseStart = 0;
-
-inline void pwmInit() {
-  pinMode(ENA, OUTPUT);
-  pinMode(ENB, OUTPUT);
-  digitalWrite(ENA, LOW);
-  digitalWrite(ENB, LOW);
-  phaseStart = micros();
-}
-inline void pwmWriteLeft(uint8_t d)  { dutyL = d; }
-inline void pwmWriteRight(uint8_t d) { dutyR = d; }
-
-inline void pwmService() {
-  uint32_t now = micros();
-  uint32_t elapsed = now - phaseStart;
-  if (elapsed >= PWM_PERIOD_US) {
-    phaseStart += PWM_PERIOD_US * (elapsed / PWM_PERIOD_US);
-    elapsed = now - phaseStart;
-  }
-  uint32_t onL = ((uint32_t)dutyL * PWM_PERIOD_US) / 255;
-  uint32_t onR = ((uint32_t)dutyR * PWM_PERIOD_US) / 255;
-  digitalWrite(ENA, (elapsed < onL) ? HIGH : LOW);
-  digitalWrite(ENB, (elapsed < onR) ? HIGH : LOW);
-}
+// -------- WebSocket drive channel --------
+const uint32_t DEADMAN_MS = 250;        // page refreshes at least every 100 ms
+
+struct DriveFrame { uint8_t seq; int8_t throttle; int8_t steer; };
+DriveFrame pendingFrame;
+bool     framePending = false;
+int8_t   frameClient  = -1;             // who gets the ack
+uint32_t lastFrameMs  = 0;
+bool     wsDriving    = false;          // dead-man armed
+
+// -------- Motors (LEDC PWM on EN, ramped) --------
+// LEDC channels 0/1 share the timer the camera uses for XCLK, so start at 2
+const uint16_t RAMP_PER_SEC = 1020;                   // 0 -> full in 250 ms
+Motor motorL(ENA, gpLf, gpLb, 2);
+Motor motorR(ENB, gpRf, gpRb, 3);
 
 // -------- Helpers --------
 static inline float clampf(float v, float lo, float hi){
@@ -73,28 +79,53 @@ static inline float clampf(float v, float lo, float hi){
 }
 
 // Set both wheels the same based on throttle t ∈ [-1..1]
+// 0 ramps down and then coasts (direction pins LOW)
 void setThrottle(float t) {
-  // Direction pins (both sides same)
-  if (t > 0) { // forward
-    digitalWrite(gpLf, HIGH); digitalWrite(gpLb, LOW);
-    digitalWrite(gpRf, HIGH); digitalWrite(gpRb, LOW);
-  } else if (t < 0) { // backward
-    digitalWrite(gpLf, LOW);  digitalWrite(gpLb, HIGH);
-    digitalWrite(gpRf, LOW);  digitalWrite(gpRb, HIGH);
-  } else { // stop (coast)
-    digitalWrite(gpLf, LOW);  digitalWrite(gpLb, LOW);
-    digitalWrite(gpRf, LOW);  digitalWrite(gpRb, LOW);
-  }
+  int16_t speed = MotorMath::speedFromThrottle(clampf(t, -1, 1));
+  motorL.setTarget(speed);
+  motorR.setTarget(speed);
+}
 
-  uint8_t pwm = (uint8_t)(clampf(fabs(t), 0, 1) * 255);
-  pwmWriteLeft(pwm);
-  pwmWriteRight(pwm);
+// Throttle + steer from a WebSocket frame (both -127..127), arcade mix
+void setDrive(int8_t throttle, int8_t steer) {
+  int32_t y = (int32_t)throttle * MotorMath::SPEED_MAX / 127;
+  int32_t x = (int32_t)steer    * MotorMath::SPEED_MAX / 127;
+  motorL.setTarget(MotorMath::clampSpeed(y + x));
+  motorR.setTarget(MotorMath::clampSpeed(y - x));
 }
 
 void motorStop(){
-  digitalWrite(gpLf, LOW); digitalWrite(gpLb, LOW);
-  digitalWrite(gpRf, LOW); digitalWrite(gpRb, LOW);
-  pwmWriteLeft(0); pwmWriteRight(0);
+  motorL.coast();
+  motorR.coast();
+}
+
+// Runs inside ws.loop(); only keeps the newest frame, loop() applies it
+void onWsEvent(uint8_t client, WStype_t type, uint8_t* payload, size_t len) {
+  if (type == WStype_BIN && len == 3) {
+    pendingFrame.seq      = payload[0];
+    pendingFrame.throttle = (int8_t)payload[1];
+    pendingFrame.steer    = (int8_t)payload[2];
+    framePending = true;
+    frameClient  = client;
+    lastFrameMs  = millis();
+  } else if (type == WStype_DISCONNECTED && client == frameClient) {
+    wsDriving = false;
+    frameClient = -1;
+    setThrottle(0);
+  }
+}
+
+void serviceDriveChannel(uint32_t now) {
+  if (framePending) {
+    framePending = false;
+    setDrive(pendingFrame.throttle, pendingFrame.steer);
+    wsDriving = (pendingFrame.throttle != 0 || pendingFrame.steer != 0);
+    if (frameClient >= 0) ws.sendBIN(frameClient, &pendingFrame.seq, 1);
+  } else if (wsDriving && now - lastFrameMs > DEADMAN_MS) {
+    wsDriving = false;
+    setThrottle(0);
+    Serial.println("Dead-man: no drive frames, stopping");
+  }
 }
 
 // -------- HTTP: /th?y=.. (y in -1..1) --------
@@ -142,17 +173,17 @@ const char* PAGE = R"HTML(<!doctype html>
 </style>
 <div class="wrap">
   <div id="pad"><div id="knob"></div></div>
-  <div class="read">throttle: <span id="yv">0.00</span></div>
+  <div class="read">throttle: <span id="yv">0.00</span> &middot; rtt: <span id="rt">-</span> ms</div>
 </div>
 <script>
 (() => {
   const pad  = document.getElementById('pad');
   const knob = document.getElementById('knob');
   const yv   = document.getElementById('yv');
+  const rt   = document.getElementById('rt');
 
   let rect, cy, radius, kh;
   let dragging = false;
-  const rateHz = 30; let last = 0;
 
   function measure() {
     rect   = pad.getBoundingClientRect();
@@ -177,12 +208,47 @@ const char* PAGE = R"HTML(<!doctype html>
     const ny = clamp((-dy * s) / lim);   // up positive
     place(ny);
     yv.textContent = ny.toFixed(2);
+    target = ny;
+  }
+
+  // -------- WebSocket drive channel (see frame layout in the .ino header) --------
+  let ws = null, seq = 0, target = 0, sentAt = 0, lastSentY = null;
+  const pendingSeq = new Map();
+  let rttSum = 0, rttN = 0;
+
+  function connect() {
+    ws = new WebSocket(`ws://${location.hostname}:81/`);
+    ws.binaryType = 'arraybuffer';
+    ws.onmessage = ev => {
+      const s = new Uint8Array(ev.data)[0];
+      const t0 = pendingSeq.get(s);
+      if (t0 === undefined) return;
+      pendingSeq.delete(s);
+      rttSum += performance.now() - t0; rttN++;
+      if (rttN === 20) { rt.textContent = (rttSum / rttN).toFixed(1); rttSum = 0; rttN = 0; }
+    };
+    ws.onclose = () => { ws = null; setTimeout(connect, 500); };
+  }
 
-    const now = performance.now();
-    if (now - last > 1000/rateHz) {
-      last = now;
-      fetch(`/th?y=${ny.toFixed(3)}`).catch(()=>{});
+  function sendFrame(y) {
+    if (ws && ws.readyState === 1 && ws.bufferedAmount === 0) {
+      seq = (seq + 1) & 0xFF;
+      pendingSeq.set(seq, performance.now());
+      if (pendingSeq.size > 32) pendingSeq.delete(pendingSeq.keys().next().value);
+      ws.send(new Int8Array([seq, Math.round(y * 127), 0]).buffer);
+    } else if (!ws) {
+      fetch(`/th?y=${y.toFixed(3)}`).catch(()=>{});     // fallback while reconnecting
+    } else {
+      return;                                            // busy: retry next frame
     }
+    lastSentY = y; sentAt = performance.now();
+  }
+
+  // At most one frame per animation frame; resend every 100 ms while driving
+  // so the car's dead-man timer stays fed
+  function tick(now) {
+    if (target !== lastSentY || (target !== 0 && now - sentAt > 100)) sendFrame(target);
+    requestAnimationFrame(tick);
   }
 
   pad.addEventListener('pointerdown', e => {
@@ -203,13 +269,15 @@ const char* PAGE = R"HTML(<!doctype html>
     dragging = false;
     place(0);
     yv.textContent = '0.00';
-    fetch('/th?y=0').catch(()=>{});
+    target = 0;
     e.preventDefault();
   });
 
   window.addEventListener('resize', measure);
   window.addEventListener('orientationchange', measure);
   requestAnimationFrame(measure);
+  connect();
+  requestAnimationFrame(tick);
 })();
 </script>)HTML";
 
@@ -219,21 +287,12 @@ void setup() {
   Serial.begin(115200);
   delay(100);
 
-  // Direction pins
-  pinMode(gpLb, OUTPUT);
-  pinMode(gpLf, OUTPUT);
-  pinMode(gpRb, OUTPUT);
-  pinMode(gpRf, OUTPUT);
-
-  // Ensure stop
-  digitalWrite(gpLb, LOW);
-  digitalWrite(gpLf, LOW);
-  digitalWrite(gpRb, LOW);
-  digitalWrite(gpRf, LOW);
-
-  // PWM and stop
-  pwmInit();
+  // Motors: direction pins + PWM, start stopped
+  bool hwL = motorL.begin(RAMP_PER_SEC);
+  bool hwR = motorR.begin(RAMP_PER_SEC);
   motorStop();
+  Serial.printf("Motor PWM: left %s, right %s\n",
+                hwL ? "LEDC" : "timer ISR", hwR ? "LEDC" : "timer ISR");
 
   // Wi-Fi
   WiFi.mode(WIFI_AP);
@@ -245,10 +304,17 @@ void setup() {
   server.on("/", handleRoot);
   server.on("/th", HTTP_GET, handleThrottle);
   server.begin();
-  Serial.println("Web server started");
+  ws.begin();
+  ws.onEvent(onWsEvent);
+  Serial.println("Web server started (WebSocket drive on :81)");
 }
 
 void loop() {
+  ws.loop();
   server.handleClient();
-  pwmService();
+  uint32_t now = millis();
+  serviceDriveChannel(now);
+  motorL.update(now);
+  motorR.update(now);
+  delay(1);   // PWM runs in hardware now, so let the idle task run
 }
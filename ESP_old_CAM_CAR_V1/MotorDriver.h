@@ -0,0 +1,219 @@
+/*
+MotorDriver.h — L298N motor channel for ESP32 (ENx + two direction pins)
+- PWM on ENx comes from a hardware LEDC channel, so it keeps running no matter
+  how long server.handleClient() takes.
+- If the pin/channel cannot be used by LEDC (input-only pin, channel taken by
+  the camera, chip with fewer channels), the motor falls back to SoftPwm:
+  a hardware-timer ISR that fires only on the PWM edges (max. 5x per period).
+- Direction pins, brake vs. coast and a rate-limited ramp toward the target.
+
+Usage:
+  Motor left(ENA, gpLf, gpLb, 2);   // LEDC channel 2 (or MOTOR_NO_LEDC)
+  left.begin(1020);                 // ramp: 1020 steps/s = 0..255 in 250 ms
+  left.setTarget(-128);             // half speed backward
+  left.update(millis());            // call often from loop()
+*/
+
+#ifndef MOTOR_DRIVER_H
+#define MOTOR_DRIVER_H
+
+#include <Arduino.h>
+#include "MotorMath.h"
+
+#if __has_include(<esp_arduino_version.h>)
+#include <esp_arduino_version.h>
+#endif
+#ifndef ESP_ARDUINO_VERSION_MAJOR
+#define ESP_ARDUINO_VERSION_MAJOR 2
+#endif
+
+constexpr uint32_t MOTOR_PWM_FREQ  = 1200;   // Hz (same as the old software PWM)
+constexpr uint8_t  MOTOR_PWM_BITS  = 8;
+constexpr uint8_t  MOTOR_NO_LEDC   = 0xFF;   // force the timer-ISR fallback
+
+// -------- Timer-ISR software PWM (fallback) --------
+namespace SoftPwm {
+
+  constexpr uint16_t PERIOD_US = 1000000UL / MOTOR_PWM_FREQ;
+  constexpr uint8_t  TIMER_NUM = 1;          // timer 0 is left for other users
+
+  static hw_timer_t*       timer = nullptr;
+  static uint8_t           pins[MotorMath::SOFT_PWM_MAX_CH];
+  static volatile uint16_t onUs[MotorMath::SOFT_PWM_MAX_CH];
+  static uint8_t           count = 0;
+
+  // ISR state
+  static MotorMath::SoftPwmFrame frame;
+  static uint8_t  edgeIdx = 0;
+  static uint64_t periodStart = 0;
+
+  static inline void IRAM_ATTR armAt(uint64_t t) {
+#if ESP_ARDUINO_VERSION_MAJOR >= 3
+    timerAlarm(timer, t, false, 0);
+#else
+    timerAlarmWrite(timer, t, false);
+    timerAlarmEnable(timer);
+#endif
+  }
+
+  static inline void IRAM_ATTR writeMask(uint8_t mask, uint8_t level) {
+    for (uint8_t c = 0; c < count; c++) {
+      if (mask & (1 << c)) digitalWrite(pins[c], level);
+    }
+  }
+
+  // Fires at the period start and at each falling edge. Duty changes are
+  // latched only at the period start, so a period is never cut short.
+  static void IRAM_ATTR onTimer() {
+    uint64_t now = timerRead(timer);
+    uint64_t next;
+    do {
+      if (edgeIdx >= frame.edges) {
+        periodStart += PERIOD_US;
+        uint16_t snap[MotorMath::SOFT_PWM_MAX_CH];
+        for (uint8_t c = 0; c < count; c++) snap[c] = onUs[c];
+        frame.build(snap, count, PERIOD_US);
+        writeMask(frame.startMask, HIGH);
+        writeMask((uint8_t)~frame.startMask, LOW);
+        edgeIdx = 0;
+      } else {
+        writeMask(frame.edgeMask[edgeIdx], LOW);
+        edgeIdx++;
+      }
+      next = periodStart + ((edgeIdx < frame.edges) ? frame.edgeUs[edgeIdx] : PERIOD_US);
+    } while (next <= now + 2);               // already late: handle it right away
+    armAt(next);
+  }
+
+  // Returns the slot index, or 0xFF when all slots are used
+  inline uint8_t attach(uint8_t pin) {
+    if (count >= MotorMath::SOFT_PWM_MAX_CH) return 0xFF;
+    uint8_t slot = count;
+    pins[slot] = pin;
+    onUs[slot] = 0;
+    pinMode(pin, OUTPUT);
+    digitalWrite(pin, LOW);
+    count++;
+
+    if (!timer) {
+#if ESP_ARDUINO_VERSION_MAJOR >= 3
+      timer = timerBegin(1000000);                    // 1 tick = 1 µs
+      timerAttachInterrupt(timer, &onTimer);
+#else
+      timer = timerBegin(TIMER_NUM, 80, true);        // 80 MHz / 80 = 1 µs
+      timerAttachInterrupt(timer, &onTimer, true);
+#endif
+      uint64_t start = timerRead(timer) + 50;
+      periodStart = start - PERIOD_US;
+      frame.edges = 0;
+      edgeIdx = 0;
+      armAt(start);
+    }
+    return slot;
+  }
+
+  inline void write(uint8_t slot, uint8_t duty) {
+    onUs[slot] = MotorMath::onTimeUs(duty, PERIOD_US);
+  }
+
+} // namespace SoftPwm
+
+// -------- One motor channel --------
+enum class StopMode : uint8_t { COAST, BRAKE };
+
+class Motor {
+public:
+  Motor(uint8_t enPin, uint8_t fwdPin, uint8_t revPin, uint8_t ledcChannel)
+    : en(enPin), fwd(fwdPin), rev(revPin), channel(ledcChannel),
+      softSlot(0xFF), useLedc(false), stopMode(StopMode::COAST),
+      dir(0), lastDuty(0), lastMs(0) {}
+
+  // Returns true when hardware LEDC drives EN, false for the SoftPwm fallback
+  bool begin(uint16_t rampPerSec) {
+    pinMode(fwd, OUTPUT);
+    pinMode(rev, OUTPUT);
+    digitalWrite(fwd, LOW);
+    digitalWrite(rev, LOW);
+
+    useLedc = false;
+    if (channel != MOTOR_NO_LEDC && GPIO_IS_VALID_OUTPUT_GPIO(en)) {
+#if ESP_ARDUINO_VERSION_MAJOR >= 3
+      useLedc = ledcAttachChannel(en, MOTOR_PWM_FREQ, MOTOR_PWM_BITS, channel);
+#else
+      if (ledcSetup(channel, MOTOR_PWM_FREQ, MOTOR_PWM_BITS) != 0) {   // 0 = bad channel
+        ledcAttachPin(en, channel);
+        useLedc = true;
+      }
+#endif
+    }
+    if (!useLedc) softSlot = SoftPwm::attach(en);
+
+    ramp.ratePerSec = rampPerSec;
+    ramp.jump(0);
+    lastMs = millis();
+    dir = 0;
+    lastDuty = 1;             // force the first write
+    apply();
+    return useLedc;
+  }
+
+  // Signed speed -255..255, reached through the ramp. 'atZero' decides what
+  // happens once the motor arrives at 0.
+  void setTarget(int16_t speed, StopMode atZero = StopMode::COAST) {
+    ramp.target = MotorMath::clampSpeed(speed);
+    stopMode = atZero;
+    if (ramp.value == 0 && ramp.target == 0) apply();   // stop mode changed only
+  }
+
+  // Immediate stops (skip the ramp)
+  void brake() { stopMode = StopMode::BRAKE; ramp.jump(0); apply(); }
+  void coast() { stopMode = StopMode::COAST; ramp.jump(0); apply(); }
+
+  void update(uint32_t nowMs) {
+    uint32_t elapsed = nowMs - lastMs;
+    lastMs = nowMs;
+    if (ramp.step(elapsed)) apply();
+  }
+
+  int16_t speed() const { return ramp.value; }
+  bool hardwarePwm() const { return useLedc; }
+
+private:
+  void writeDuty(uint8_t duty) {
+    if (duty == lastDuty) return;
+    lastDuty = duty;
+    if (useLedc) {
+#if ESP_ARDUINO_VERSION_MAJOR >= 3
+      ledcWrite(en, MotorMath::ledcDuty(duty, MOTOR_PWM_BITS));
+#else
+      ledcWrite(channel, MotorMath::ledcDuty(duty, MOTOR_PWM_BITS));
+#endif
+    } else if (softSlot != 0xFF) {
+      SoftPwm::write(softSlot, duty);
+    }
+  }
+
+  // L298N: IN1/IN2 = H/L forward, L/H backward, H/H brake (EN high), L/L coast
+  void apply() {
+    int16_t s = ramp.value;
+    int8_t d = (s > 0) ? 1 : (s < 0) ? -1 : (stopMode == StopMode::BRAKE ? 2 : 0);
+    if (d != dir) {
+      writeDuty(0);           // never switch direction with EN high
+      dir = d;
+      digitalWrite(fwd, (d == 1 || d == 2) ? HIGH : LOW);
+      digitalWrite(rev, (d == -1 || d == 2) ? HIGH : LOW);
+    }
+    writeDuty(d == 2 ? 255 : MotorMath::dutyOf(s));
+  }
+
+  uint8_t en, fwd, rev, channel;
+  uint8_t softSlot;
+  bool useLedc;
+  StopMode stopMode;
+  int8_t dir;                 // 1 fwd, -1 back, 0 coast, 2 brake
+  uint8_t lastDuty;
+  uint32_t lastMs;
+  MotorMath::Ramp ramp;
+};
+
+#endif // MOTOR_DRIVER_H
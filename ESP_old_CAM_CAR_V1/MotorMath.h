@@ -0,0 +1,108 @@
+/*
+MotorMath.h — pure duty / ramp / soft-PWM edge math for MotorDriver.h
+- No Arduino dependencies, so it also compiles on a PC (g++) for checking.
+- Speed is signed: -255 (full reverse) .. 0 (stop) .. +255 (full forward).
+*/
+
+#ifndef MOTOR_MATH_H
+#define MOTOR_MATH_H
+
+#include <stdint.h>
+
+namespace MotorMath {
+
+  constexpr int16_t SPEED_MAX = 255;
+
+  inline int16_t clampSpeed(int32_t s) {
+    return (s < -SPEED_MAX) ? -SPEED_MAX : (s > SPEED_MAX) ? SPEED_MAX : (int16_t)s;
+  }
+
+  // Throttle t ∈ [-1..1] -> signed speed, rounded to nearest step
+  inline int16_t speedFromThrottle(float t) {
+    if (!(t == t)) return 0;                     // NaN from a bad query string
+    float s = t * SPEED_MAX;
+    return clampSpeed((int32_t)(s + (s >= 0 ? 0.5f : -0.5f)));
+  }
+
+  inline uint8_t dutyOf(int16_t speed) {
+    return (uint8_t)(speed < 0 ? -speed : speed);
+  }
+
+  // 8-bit duty -> LEDC duty for a timer with 'bits' resolution (bits >= 8).
+  // 255 maps to 1 << bits, which LEDC treats as "always on" (plain 255 would
+  // leave a one-count gap every period).
+  inline uint32_t ledcDuty(uint8_t duty, uint8_t bits) {
+    if (duty == 255) return 1UL << bits;
+    return (uint32_t)duty << (bits - 8);
+  }
+
+  // 8-bit duty -> on-time in µs for one soft-PWM period
+  inline uint16_t onTimeUs(uint8_t duty, uint16_t periodUs) {
+    return (uint16_t)(((uint32_t)duty * periodUs + 127) / 255);
+  }
+
+  // Rate-limited approach to a target. Rate is in speed steps per second;
+  // the remainder is carried between calls so irregular update() intervals
+  // still give the same average slope.
+  struct Ramp {
+    int16_t  value;
+    int16_t  target;
+    uint16_t ratePerSec;     // 0 = jump immediately
+    uint32_t carry;          // leftover rate*ms below one step (x1000)
+
+    Ramp() : value(0), target(0), ratePerSec(0), carry(0) {}
+
+    void jump(int16_t v) { value = target = v; carry = 0; }
+
+    // Returns true when value changed
+    bool step(uint32_t elapsedMs) {
+      if (value == target) { carry = 0; return false; }
+      int32_t delta = (int32_t)target - value;
+      int32_t dist  = delta < 0 ? -delta : delta;
+      int32_t move  = dist;
+      if (ratePerSec) {
+        carry += (uint32_t)ratePerSec * elapsedMs;
+        uint32_t whole = carry / 1000;
+        carry %= 1000;
+        if ((int32_t)whole < dist) move = (int32_t)whole;
+      }
+      if (move == 0) return false;
+      value = (int16_t)(value + (delta < 0 ? -move : move));
+      if (value == target) carry = 0;
+      return true;
+    }
+  };
+
+  // One soft-PWM period: all channels with duty > 0 go HIGH at t = 0, then each
+  // goes LOW at its own edge. Channels with equal on-times share one edge, so
+  // the ISR fires at most (channels + 1) times per period.
+  constexpr uint8_t SOFT_PWM_MAX_CH = 4;
+
+  struct SoftPwmFrame {
+    uint8_t  startMask;                  // channels driven HIGH at t = 0
+    uint8_t  edges;                      // number of falling edges below
+    uint16_t edgeUs[SOFT_PWM_MAX_CH];    // ascending
+    uint8_t  edgeMask[SOFT_PWM_MAX_CH];  // channels going LOW at edgeUs[i]
+
+    void build(const uint16_t* onUs, uint8_t n, uint16_t periodUs) {
+      startMask = 0;
+      edges = 0;
+      for (uint8_t c = 0; c < n && c < SOFT_PWM_MAX_CH; c++) {
+        uint16_t t = onUs[c];
+        if (t == 0) continue;                 // never on
+        startMask |= (uint8_t)(1 << c);
+        if (t >= periodUs) continue;          // always on, no falling edge
+        uint8_t i = 0;
+        while (i < edges && edgeUs[i] < t) i++;
+        if (i < edges && edgeUs[i] == t) { edgeMask[i] |= (uint8_t)(1 << c); continue; }
+        for (uint8_t j = edges; j > i; j--) { edgeUs[j] = edgeUs[j - 1]; edgeMask[j] = edgeMask[j - 1]; }
+        edgeUs[i] = t;
+        edgeMask[i] = (uint8_t)(1 << c);
+        edges++;
+      }
+    }
+  };
+
+} // namespace MotorMath
+
+#endif // MOTOR_MATH_H
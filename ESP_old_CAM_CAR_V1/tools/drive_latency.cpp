@@ -0,0 +1,237 @@
+/*
+drive_latency.cpp — command-to-motor latency of the CAM car: WebSocket vs. GET /th
+- Run on a Linux PC joined to the car's Wi-Fi (ESP2WDcar1). Alternates the
+  two control paths, one command each per round, so both see the same radio
+  conditions:
+    WebSocket: one persistent connection to :81, a 3-byte drive frame; the
+               time until the car's 1-byte ack with the same seq. The car
+               sends the ack right after setDrive(), so this is the round
+               trip to the motor targets.
+    GET /th  : what the page did before — a new TCP connection per command
+               (WebServer closes it after each reply), the time until the
+               "204" status line. handleThrottle() replies after setThrottle().
+- Sends throttle 0 by default, so the wheels stay still while measuring.
+- Prints p50 / p99 / max / mean per path and how many commands got no reply
+  within 1 s.
+
+Build and run (from this folder):
+  g++ -O2 -std=c++11 drive_latency.cpp -o drive_latency
+  ./drive_latency                       500 rounds against 192.168.4.50
+  ./drive_latency -n 2000 -gap 16       more rounds, one command per 16 ms (60 fps page)
+  ./drive_latency -y 0.3 10.0.0.7       wheels turning (car on a stand!), other address
+  ./drive_latency -csv > run.csv        one line per round: ws_us, get_us (-1 = lost)
+*/
+
+#include <arpa/inet.h>
+#include <errno.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <time.h>
+#include <unistd.h>
+#include <algorithm>
+#include <string>
+#include <vector>
+
+static const int TIMEOUT_MS = 1000;
+
+static int64_t nowUs() {
+  timespec t;
+  clock_gettime(CLOCK_MONOTONIC, &t);
+  return (int64_t)t.tv_sec * 1000000 + t.tv_nsec / 1000;
+}
+
+static void sleepMs(int ms) {
+  timespec t = { ms / 1000, (ms % 1000) * 1000000L };
+  nanosleep(&t, NULL);
+}
+
+// TCP connection with a receive timeout, -1 on failure
+static int connectTo(const char* host, int port) {
+  addrinfo hints, *res = NULL;
+  memset(&hints, 0, sizeof(hints));
+  hints.ai_family = AF_INET;
+  hints.ai_socktype = SOCK_STREAM;
+  char portStr[8];
+  snprintf(portStr, sizeof(portStr), "%d", port);
+  if (getaddrinfo(host, portStr, &hints, &res) != 0 || !res) return -1;
+  int s = socket(res->ai_family, res->ai_socktype, res->ai_protocol);
+  if (s >= 0) {
+    timeval tv = { TIMEOUT_MS / 1000, (TIMEOUT_MS % 1000) * 1000 };
+    setsockopt(s, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+    setsockopt(s, SOL_SOCKET, SO_SNDTIMEO, &tv, sizeof(tv));
+    int one = 1;
+    setsockopt(s, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+    if (connect(s, res->ai_addr, res->ai_addrlen) != 0) { close(s); s = -1; }
+  }
+  freeaddrinfo(res);
+  return s;
+}
+
+static bool sendAll(int s, const void* p, size_t n) {
+  const char* c = (const char*)p;
+  while (n) {
+    ssize_t k = send(s, c, n, MSG_NOSIGNAL);
+    if (k <= 0) return false;
+    c += k;
+    n -= (size_t)k;
+  }
+  return true;
+}
+
+static bool recvAll(int s, void* p, size_t n) {
+  char* c = (char*)p;
+  while (n) {
+    ssize_t k = recv(s, c, n, 0);
+    if (k <= 0) return false;
+    c += k;
+    n -= (size_t)k;
+  }
+  return true;
+}
+
+// -------- WebSocket client (RFC 6455, just what the car needs) --------
+
+static int wsOpen(const char* host) {
+  int s = connectTo(host, 81);
+  if (s < 0) return -1;
+  std::string req = std::string("GET / HTTP/1.1\r\nHost: ") + host + ":81\r\n"
+                    "Upgrade: websocket\r\nConnection: Upgrade\r\n"
+                    "Sec-WebSocket-Key: ZHJpdmVsYXRlbmN5dG9vbA==\r\n"
+                    "Sec-WebSocket-Version: 13\r\n\r\n";
+  if (!sendAll(s, req.data(), req.size())) { close(s); return -1; }
+  std::string head;
+  char c;
+  while (head.size() < 4096 && head.find("\r\n\r\n") == std::string::npos) {
+    if (recv(s, &c, 1, 0) != 1) { close(s); return -1; }
+    head += c;
+  }
+  if (head.compare(0, 12, "HTTP/1.1 101") != 0) { close(s); return -1; }
+  return s;
+}
+
+// Client frames must be masked; the mask is fixed, nothing here is secret
+static bool wsSend(int s, uint8_t opcode, const uint8_t* p, uint8_t n) {
+  static const uint8_t MASK[4] = { 0x37, 0xfa, 0x21, 0x3d };
+  uint8_t f[6 + 125];
+  f[0] = (uint8_t)(0x80 | opcode);
+  f[1] = (uint8_t)(0x80 | n);
+  memcpy(f + 2, MASK, 4);
+  for (uint8_t i = 0; i < n; i++) f[6 + i] = p[i] ^ MASK[i & 3];
+  return sendAll(s, f, 6 + n);
+}
+
+// Next binary frame's first byte; pings are answered, other frames skipped
+static int wsReadAck(int s) {
+  for (;;) {
+    uint8_t h[2];
+    if (!recvAll(s, h, 2)) return -1;
+    uint64_t len = h[1] & 0x7f;
+    if (len == 126) { uint8_t e[2]; if (!recvAll(s, e, 2)) return -1; len = (e[0] << 8) | e[1]; }
+    else if (len == 127) { uint8_t e[8]; if (!recvAll(s, e, 8)) return -1; len = 0; for (int i = 0; i < 8; i++) len = (len << 8) | e[i]; }
+    if (len > 1024) return -1;
+    uint8_t p[1024];
+    if (len && !recvAll(s, p, (size_t)len)) return -1;
+    uint8_t op = h[0] & 0x0f;
+    if (op == 0x9) { if (!wsSend(s, 0xA, p, (uint8_t)std::min<uint64_t>(len, 125))) return -1; continue; }
+    if (op == 0x8) return -1;
+    if (op == 0x2 && len >= 1) return p[0];
+  }
+}
+
+// One drive frame -> its ack, in us; -1 = lost (the connection is dropped)
+static int64_t wsRound(int& s, const char* host, uint8_t seq, int8_t throttle) {
+  if (s < 0 && (s = wsOpen(host)) < 0) return -1;
+  uint8_t frame[3] = { seq, (uint8_t)throttle, 0 };
+  int64_t t0 = nowUs();
+  if (!wsSend(s, 0x2, frame, 3)) { close(s); s = -1; return -1; }
+  for (;;) {
+    int ack = wsReadAck(s);
+    if (ack < 0) { close(s); s = -1; return -1; }
+    if (ack == seq) return nowUs() - t0;   // older acks (after a timeout) are skipped
+  }
+}
+
+// -------- GET /th?y=.. as the page used to send it --------
+
+static int64_t getRound(const char* host, float y) {
+  int64_t t0 = nowUs();
+  int s = connectTo(host, 80);
+  if (s < 0) return -1;
+  char req[160];
+  int n = snprintf(req, sizeof(req), "GET /th?y=%.3f HTTP/1.1\r\nHost: %s\r\nConnection: close\r\n\r\n", y, host);
+  int64_t us = -1;
+  if (sendAll(s, req, (size_t)n)) {
+    std::string line;
+    char c;
+    while (line.size() < 64 && recv(s, &c, 1, 0) == 1 && c != '\n') line += c;
+    if (line.compare(0, 12, "HTTP/1.1 204") == 0 || line.compare(0, 12, "HTTP/1.0 204") == 0) us = nowUs() - t0;
+    char drain[512];
+    while (recv(s, drain, sizeof(drain), 0) > 0) {}
+  }
+  close(s);
+  return us;
+}
+
+// -------- statistics --------
+
+static void report(const char* name, std::vector<int64_t> v, size_t sent) {
+  if (v.empty()) { printf("%-10s no replies (%zu sent)\n", name, sent); return; }
+  std::sort(v.begin(), v.end());
+  double sum = 0;
+  for (size_t i = 0; i < v.size(); i++) sum += (double)v[i];
+  size_t n = v.size();
+  printf("%-10s p50 %6.2f ms  p99 %6.2f ms  max %7.2f ms  mean %6.2f ms  lost %zu/%zu\n", name,
+         v[n / 2] / 1000.0, v[std::min(n - 1, n * 99 / 100)] / 1000.0, v[n - 1] / 1000.0,
+         sum / n / 1000.0, sent - n, sent);
+}
+
+int main(int argc, char** argv) {
+  const char* host = "192.168.4.50";
+  int rounds = 500, gapMs = 20;
+  float y = 0;
+  bool csv = false;
+  for (int i = 1; i < argc; i++) {
+    if (!strcmp(argv[i], "-n") && i + 1 < argc) rounds = atoi(argv[++i]);
+    else if (!strcmp(argv[i], "-gap") && i + 1 < argc) gapMs = atoi(argv[++i]);
+    else if (!strcmp(argv[i], "-y") && i + 1 < argc) y = (float)atof(argv[++i]);
+    else if (!strcmp(argv[i], "-csv")) csv = true;
+    else if (argv[i][0] != '-') host = argv[i];
+    else { fprintf(stderr, "usage: %s [-n rounds] [-gap ms] [-y throttle] [-csv] [host]\n", argv[0]); return 2; }
+  }
+  if (y < -1) y = -1;
+  if (y > 1) y = 1;
+  int8_t throttle = (int8_t)(y * 127 + (y >= 0 ? 0.5f : -0.5f));
+
+  int ws = wsOpen(host);
+  if (ws < 0) { fprintf(stderr, "%s: no WebSocket on port 81\n", host); return 1; }
+
+  std::vector<int64_t> wsUs, getUs;
+  if (csv) printf("ws_us,get_us\n");
+  for (int r = 0; r < rounds; r++) {
+    int64_t a = wsRound(ws, host, (uint8_t)r, throttle);
+    sleepMs(gapMs);
+    int64_t b = getRound(host, y);
+    sleepMs(gapMs);
+    if (a >= 0) wsUs.push_back(a);
+    if (b >= 0) getUs.push_back(b);
+    if (csv) printf("%lld,%lld\n", (long long)a, (long long)b);
+  }
+
+  // leave the car stopped whatever -y was
+  wsRound(ws, host, (uint8_t)rounds, 0);
+  getRound(host, 0);
+  if (ws >= 0) close(ws);
+
+  if (!csv) {
+    printf("%s, %d rounds, %d ms between commands, throttle %d\n", host, rounds, gapMs, throttle);
+    report("WebSocket", wsUs, (size_t)rounds);
+    report("GET /th", getUs, (size_t)rounds);
+  }
+  return 0;
+}
@@ -28,6 +28,8 @@
   - U enkodéru používám D7/D8 (ať se neplete s I2C na D2/D3). Jsou to běžné piny – dekódujeme softwarově.
   - Pokud má enkodér modul s pinem „+“, připoj jej na 5V (napájí jeho pull-up/LED).
   - Všechny země MUSÍ být společné.
+  - LCD se kreslí do paměti (knihovna MyLcd) a na displej jdou jen změněné znaky,
+    pár v každém průchodu loop() – enkodér ani LED kvůli LCD nečekají.
 
   ==================================================
   UI chování:
@@ -44,6 +46,7 @@
   #include <Adafruit_NeoPixel.h>
   #include <LiquidCrystal_I2C.h>
   #include <Bounce2.h>
+  #include <MyLcd.h>   // knihovna MyLcd: stínová kopie LCD, posílá jen změny
 
   // -------------------- HW KONFIG --------------------
   #define LED_PIN    6
@@ -54,6 +57,7 @@
   #define LCD_ADDR   0x27
   #define LCD_COLS   20
   #define LCD_ROWS   4
+  #define LCD_SLICE  4   // max. zápisů na LCD za jeden průchod loop() (~5 ms)
 
   // Enkodér piny (A/B/Tlačítko)
   const uint8_t PIN_CLK = 7;  // A / CLK
@@ -66,7 +70,8 @@
 
   // -------------------- GLOBÁLY --------------------
   Adafruit_NeoPixel strip(LED_COUNT, LED_PIN, NEO_GRB + NEO_KHZ800);
-  LiquidCrystal_I2C lcd(LCD_ADDR, LCD_COLS, LCD_ROWS);
+  LiquidCrystal_I2C lcdHw(LCD_ADDR, LCD_COLS, LCD_ROWS);
+  MyLcd::Shadow<LiquidCrystal_I2C, LCD_COLS, LCD_ROWS> lcd(lcdHw);   // sketch kreslí sem
   Bounce btn = Bounce();
 
   unsigned long tNow;
@@ -159,16 +164,18 @@
   }
 
   void setupDisplay() {
-    lcd.init();
-    lcd.backlight();
-    lcd.clear();
+    lcdHw.init();
+    lcdHw.backlight();
+    lcd.begin();
     centerPrint(0, "NeoPixel Demo 1-9");
     centerPrint(1, "Otaceni = vyber");
     centerPrint(2, "Stisk = detail");
     centerPrint(3, " ");
+    lcd.flushAll();   // úvodní obrazovka musí být vidět hned
     delay(800);
   }
 
+  // Celé menu znovu – do paměti to nic nestojí, na LCD jdou jen rozdíly
   void renderMenu() {
     lcd.clear();
     // 3x3 grid (řádky 0..2; sloupec zhruba uprostřed tří zón)
@@ -190,35 +197,15 @@
     lcd.setCursor(0,3);
     lcd.print("Vyber: ");
     lcd.print(selIndex+1);
-    lcd.print("  (stisk=detail)");
+    lcd.print("  [Stisk] OK");   // 20 znaků – delší text by se na LCD ořízl
     lastSel = selIndex;
   }
 
+  // Změna výběru: stačí překreslit menu, zápisy na LCD budou jen u starého a nového rámečku
   void renderSelection() {
     if (ui != UI_MENU) return;
     if (lastSel == selIndex) return;
-    const uint8_t rows[3] = {0,1,2};
-    const uint8_t cols[3] = {3, 10, 17};
-
-    // starý přepiš bez rámečku
-    uint8_t old = lastSel;
-    uint8_t orow = rows[old/3];
-    uint8_t ocol = cols[old%3];
-    lcd.setCursor(ocol-1, orow);
-    lcd.print(' '); lcd.print((int)old+1); lcd.print(' ');
-
-    // nový s rámečkem
-    uint8_t nr = rows[selIndex/3];
-    uint8_t nc = cols[selIndex%3];
-    lcd.setCursor(nc-1, nr);
-    lcd.print('['); lcd.print((int)selIndex+1); lcd.print(']');
-
-    lcd.setCursor(7,3);
-    lcd.print("   "); // vymaž staré číslo
-    lcd.setCursor(7,3);
-    lcd.print(selIndex+1);
-
-    lastSel = selIndex;
+    renderMenu();
   }
 
   void renderDetail(uint8_t idx) {
@@ -230,8 +217,8 @@
     lcd.print("Nazev: ");
     lcd.print(NAMES[idx]);
     lcd.setCursor(0,3);
-    lcd.print("[Stisk] Zpet  Rezim:");
-    lcd.print(idx+1);
+    lcd.print("[Stisk] Zpet Rezim:");
+    lcd.print(idx+1);            // 20. sloupec
   }
 
   void enterMenu()  { ui = UI_MENU;  renderMenu(); }
@@ -246,9 +233,7 @@
     Serial.print(F("[MODE] Now: ")); Serial.println(currentMode);
     // status na LCD v detailu
     if (ui == UI_DETAIL) {
-      lcd.setCursor(16,3);
-      lcd.print("   ");
-      lcd.setCursor(16,3);
+      lcd.setCursor(19,3);
       lcd.print((int)currentMode);
     }
   }
@@ -567,4 +552,7 @@
 
     // Efekty běží pořád (aktuální currentMode)
     stepEffect();
+
+    // LCD: pár změněných znaků za průchod
+    lcd.flush(LCD_SLICE);
   }
@@ -1,59 +1,74 @@
 #include <Wire.h>
 #include <LiquidCrystal_I2C.h>
+#include <MySonar.h>   // library MySonar: several HC-SR04 without pulseIn()
+#include <MyLcd.h>     // library MyLcd: LCD shadow buffer, sends only changed characters
 
 // LCD setup (20x4, I2C address 0x27 or 0x3F)
-LiquidCrystal_I2C lcd(0x27, 20, 4);
+LiquidCrystal_I2C lcdHw(0x27, 20, 4);
+MyLcd::Shadow<LiquidCrystal_I2C, 20, 4> lcd(lcdHw);   // the sketch draws here
+#define LCD_SLICE 8    // LCD writes per 16 ms slot (~1.3 ms each over I2C)
 
-// Ultrasonic pins
-#define TRIG_PIN 9
-#define ECHO_PIN 10
+// Ultrasonic pins, one row per sensor (sensor 1 is wired as before).
+// ECHO pins need a pin-change interrupt: Uno 8-13, Leonardo 8-11
+// (on Leonardo move sensor 4's ECHO to 14 = MISO on the ICSP header).
+// Fewer sensors? Lower SENSOR_COUNT; an unplugged one just shows "No echo".
+#define SENSOR_COUNT 4
+const uint8_t TRIG_PINS[SENSOR_COUNT] = { 9, 5, 6, 7 };
+const uint8_t ECHO_PINS[SENSOR_COUNT] = { 10, 11, 8, 12 };
+
+// Air temperature in 0.1 C (speed of sound changes ~0.18 % per degree)
+#define AIR_TEMP_C10 200
+
+MySonar::PinIO sonarPins(TRIG_PINS, ECHO_PINS, SENSOR_COUNT);
+MySonar::Ranger<MySonar::PinIO, SENSOR_COUNT> sonar(sonarPins);
+
+// Echo edges are timestamped here; loop() never waits for an echo
+#if defined(__AVR__)
+ISR(PCINT0_vect) { sonar.onEdge(micros()); }
+#else
+void IRAM_ATTR onEcho() { sonar.onEdge(micros()); }
+#endif
 
 void setup() {
   // LCD init
-  lcd.init();
-  lcd.backlight();
-  lcd.clear();
+  lcdHw.init();
+  lcdHw.backlight();
+  lcd.begin();
   lcd.setCursor(0,0);
   lcd.print("Ultrasonic Demo");
+  lcd.flushAll();
 
-  // Ultrasonic pins
-  pinMode(TRIG_PIN, OUTPUT);
-  pinMode(ECHO_PIN, INPUT);
+  // Ultrasonic pins and interrupts
+  sonar.setTemperature(AIR_TEMP_C10);
+  sonar.begin(micros());
+#if !defined(__AVR__)
+  for (uint8_t i = 0; i < SENSOR_COUNT; i++) attachInterrupt(digitalPinToInterrupt(ECHO_PINS[i]), onEcho, CHANGE);
+#endif
 
   delay(1000);
   lcd.clear();
+  for (uint8_t i = 0; i < SENSOR_COUNT; i++) {
+    lcd.setCursor(0, i);
+    lcd.print("S"); lcd.print(i + 1); lcd.print(" Distance:");
+  }
 }
 
-long readDistanceCM() {
-  // trigger pulse
-  digitalWrite(TRIG_PIN, LOW);
-  delayMicroseconds(2);
-  digitalWrite(TRIG_PIN, HIGH);
-  delayMicroseconds(10);
-  digitalWrite(TRIG_PIN, LOW);
-
-  // measure echo pulse length
-  long duration = pulseIn(ECHO_PIN, HIGH, 30000UL); // timeout 30ms (~5m)
-  if (duration == 0) return -1; // no echo
-
-  // convert to cm (speed of sound = 343 m/s)
-  long distance = duration / 58; // common formula
-  return distance;
+// "123.4 cm" or "No echo ", always 8 characters
+void formatDistance(uint8_t i, char* out) {
+  if (!sonar.valid(i)) { strcpy(out, "No echo "); return; }
+  uint16_t mm = sonar.distanceMm(i);
+  snprintf(out, 9, "%3u.%u cm", mm / 10, mm % 10);
 }
 
 void loop() {
-  long d = readDistanceCM();
-
-  lcd.setCursor(0,0);
-  lcd.print("Distance:        "); // clear line
-  lcd.setCursor(10,0);
-
-  if (d < 0) {
-    lcd.print("No echo");
-  } else {
-    lcd.print(d);
-    lcd.print(" cm");
-  }
+  // true once per 16 ms slot: the previous sensor's result is in and the next one is pinging
+  if (!sonar.poll(micros())) return;
 
-  delay(200);
+  // Redraw into memory, then send at most LCD_SLICE changed characters (~10 ms, less than a slot)
+  uint8_t i = sonar.lastSensor();
+  char text[9];
+  formatDistance(i, text);
+  lcd.setCursor(12, i);
+  lcd.print(text);
+  lcd.flush(LCD_SLICE);
 }